@@ -25,6 +25,7 @@ var descriptorDefinitions = {
     DEVICE_INFO_CHAR_FW_REV       : "8EDF0105-67E5-DB83-F85B-A1E2AB1C9E7A",
     DEVICE_INFO_CHAR_DEVICE_NAME  : "8EDF0106-67E5-DB83-F85B-A1E2AB1C9E7A",
     DEVICE_INFO_CHAR_SAVE_VALUES  : "8EDF0107-67E5-DB83-F85B-A1E2AB1C9E7A",
+    DEVICE_INFO_CHAR_SNAPSHOT     : "8EDF0109-67E5-DB83-F85B-A1E2AB1C9E7A",
 
     LSM330_SERVICE           : "8EDF0200-67E5-DB83-F85B-A1E2AB1C9E7A",
     LSM330_CHAR_ACC_EN       : "8EDF0201-67E5-DB83-F85B-A1E2AB1C9E7A",
@@ -36,14 +37,145 @@ var descriptorDefinitions = {
     LSM330_CHAR_GYRO_ODR     : "8EDF0207-67E5-DB83-F85B-A1E2AB1C9E7A",
     LSM330_CHAR_TRIGGER_VAL  : "8EDF0208-67E5-DB83-F85B-A1E2AB1C9E7A",
     LSM330_CHAR_TRIGGER_AXIS : "8EDF0209-67E5-DB83-F85B-A1E2AB1C9E7A",
+    LSM330_CHAR_AUTO_START   : "8EDF020A-67E5-DB83-F85B-A1E2AB1C9E7A",
+    LSM330_CHAR_STREAM_MODE  : "8EDF020B-67E5-DB83-F85B-A1E2AB1C9E7A",
 
     MEASURE_SERVICE         : "8EDF0300-67E5-DB83-F85B-A1E2AB1C9E7A",
     MEASURE_CHAR_START      : "8EDF0301-67E5-DB83-F85B-A1E2AB1C9E7A",
     MEASURE_CHAR_STOP       : "8EDF0302-67E5-DB83-F85B-A1E2AB1C9E7A",
     MEASURE_CHAR_DURATION   : "8EDF0303-67E5-DB83-F85B-A1E2AB1C9E7A",
-    MEASURE_CHAR_DATASTREAM : "8EDF0304-67E5-DB83-F85B-A1E2AB1C9E7A"
+    MEASURE_CHAR_DATASTREAM : "8EDF0304-67E5-DB83-F85B-A1E2AB1C9E7A",
+    MEASURE_CHAR_ADC        : "8EDF0305-67E5-DB83-F85B-A1E2AB1C9E7A",
+    MEASURE_CHAR_DIAGNOSTICS: "8EDF0306-67E5-DB83-F85B-A1E2AB1C9E7A",
+    MEASURE_CHAR_CONTROL    : "8EDF0307-67E5-DB83-F85B-A1E2AB1C9E7A"
     };
 
+
+/* control point of the measurement service, see app/control.h of the firmware */
+var controlOpcodes = {
+    CONFIGURE : 0x01,
+    START     : 0x02,
+    STOP      : 0x03,
+    ACK       : 0x04,
+    SYNC      : 0x05,
+    TIME      : 0x06
+    };
+
+var controlTypes = {
+    ACC         : 0x01,
+    GYRO        : 0x02,
+    STREAM_MODE : 0x03,
+    DURATION    : 0x04,
+    RELIABLE    : 0x05
+    };
+
+var controlStatus = ['success', 'unknown opcode', 'malformed', 'unknown type', 'invalid length', 'invalid value'];
+
+var controlMaxLength = 20;          // bytes of one write
+var clockSyncInterval = 60 * 1000;  // ms between two clock exchanges
+var clockSyncJitter = 0.1;          // part of the interval an exchange starts late at random, so its phase to the tick of the device varies
+
+/* reliable mode, the device keeps a window of twice the largest interval */
+var ackMaxMissing = controlMaxLength - 2;   // missing packets listed in one acknowledgement
+var ackWindowSize = 32;                     // packets kept behind a gap
+var ackTimeout = 100;                       // ms without progress until the acknowledgement is repeated
+
+/* profile of the start command, a field that is null keeps the setting of the device,
+   acc and gyro are taken from the snapshot then with all axes enabled */
+var measureConfig = {
+    acc         : null,                     // e.g. [0x07, 0x05, 0x00, 0x00]: axes XYZ, 50Hz, 2g, watermark tuned by the device
+    gyro        : null,                     // e.g. [0x07, 0x00, 0x00, 0x00]: axes XYZ, 95Hz, 250dps, watermark tuned by the device
+    streamMode  : null,                     // 0 throughput, 1 low latency
+    duration    : 0,                        // s, 0 for unlimited
+    ackInterval : 0                         // packets, 0 turns the reliable mode off, e.g. 8 turns it on
+    };
+
+/* builds the writes of a command, fields that do not fit are sent ahead with CONFIGURE */
+var getControlCommands = function(opcode, config) {
+
+    var fields = [];
+    var addField = function(type, value) {
+        fields.push([type, value.length].concat(value));
+    };
+
+    if(config.acc) addField(controlTypes.ACC, config.acc);
+    if(config.gyro) addField(controlTypes.GYRO, config.gyro);
+    if(config.streamMode !== null) addField(controlTypes.STREAM_MODE, [config.streamMode]);
+    if(config.duration !== null) addField(controlTypes.DURATION, [config.duration & 0xFF, (config.duration >> 8) & 0xFF]);
+    if(config.ackInterval !== null) addField(controlTypes.RELIABLE, [config.ackInterval]);
+
+    var commands = [];
+    var bytes = [opcode];
+    for(var i = fields.length - 1; i >= 0; i--) {
+        if(bytes.length + fields[i].length > controlMaxLength) {
+            commands.unshift(new Buffer(bytes));
+            bytes = [controlOpcodes.CONFIGURE];
+        }
+        bytes = [bytes[0]].concat(fields[i], bytes.slice(1));
+    }
+    commands.unshift(new Buffer(bytes));
+
+    return commands;
+};
+
+/* snapshot of the DIS service, see app/device_info.h of the firmware */
+var snapshotVersion = 1;
+var snapshotFixedLength = 13;
+var snapshotFlags = {
+    AUTO_START          : 0x01,
+    POWER_SAVE_DISABLED : 0x02
+    };
+
+// the strings of the snapshot in their order, the last one is the build id
+var snapshotStrings = ['DEVICE_INFO_CHAR_MANUFACTURER', 'DEVICE_INFO_CHAR_MODEL', 'DEVICE_INFO_CHAR_SERIAL',
+    'DEVICE_INFO_CHAR_HW_REV', 'DEVICE_INFO_CHAR_FW_REV', 'DEVICE_INFO_CHAR_DEVICE_NAME', null];
+
+// characteristics that need no read when the snapshot is available
+var snapshotCovers = snapshotStrings.concat(['DEVICE_INFO_CHAR_SNAPSHOT',
+    'LSM330_CHAR_ACC_EN', 'LSM330_CHAR_GYRO_EN', 'LSM330_CHAR_ACC_FSCALE', 'LSM330_CHAR_GYRO_FSCALE',
+    'LSM330_CHAR_ACC_ODR', 'LSM330_CHAR_GYRO_ODR', 'LSM330_CHAR_AUTO_START', 'LSM330_CHAR_STREAM_MODE']);
+
+var decodeSnapshot = function(buffer) {
+
+    if(!Buffer.isBuffer(buffer) || buffer.length < snapshotFixedLength || buffer.readUInt8(0) != snapshotVersion) {
+        return null;
+    }
+
+    var snapshot = {
+        capabilities : buffer.readUInt16LE(1),
+        acc          : [buffer[3], buffer[4], buffer[5], buffer[6]],
+        gyro         : [buffer[7], buffer[8], buffer[9], buffer[10]],
+        streamMode   : buffer[11],
+        autoStart    : (buffer[12] & snapshotFlags.AUTO_START) != 0,
+        powerSaveDisabled : (buffer[12] & snapshotFlags.POWER_SAVE_DISABLED) != 0,
+        strings      : []
+    };
+
+    // unknown trailing data of a later version is skipped
+    var offset = snapshotFixedLength;
+    for(var i = 0; i < snapshotStrings.length; i++) {
+
+        if(offset >= buffer.length || offset + 1 + buffer[offset] > buffer.length) {
+            return null;
+        }
+        snapshot.strings.push(buffer.slice(offset + 1, offset + 1 + buffer[offset]));
+        offset += 1 + buffer[offset];
+    }
+    snapshot.buildId = snapshot.strings[snapshotStrings.length - 1].toString();
+
+    return snapshot;
+};
+
+/* settings of a sensor from the snapshot for the start command, a disabled sensor gets all axes */
+var getSensorConfig = function(config) {
+    return [config[0] ? config[0] : 0x07, config[1], config[2], config[3]];
+};
+
+/* gateway clock in ms as used by the clock exchange, wraps at 32 bit */
+var getGatewayTime = function() {
+    return Date.now() >>> 0;
+};
+
 var getUUIDBuffer = function(UUID) {
     var uuidHex = S(UUID).replaceAll('-','').toLowerCase();
 
@@ -91,6 +223,18 @@ var setDescriptorHandle = function(list, uuid, handle) {
     return null;
 };
 
+var getDescriptorByHandle = function(list, handle) {
+
+    for(var i = 0;  i < list.length; i++) {
+
+        if(list[i].handle == handle) {
+            return list[i];
+        }
+    }
+
+    return null;
+};
+
 var setDescriptorValueByHandle = function(list, handle, value) {
 
     for(var i = 0;  i < list.length; i++) {
@@ -253,45 +397,49 @@ require('getmac').getMac(function(err,macAddress){
 
                         case bgClass.AttributeClient:
 
-                            if(packet.response.atthandle && gateway.MEASURE_CHAR_DATASTREAM_HANDLE && packet.response.atthandle == gateway.MEASURE_CHAR_DATASTREAM_HANDLE) {
-
-
-                                if(packet.response && Buffer.isBuffer(packet.response.value)) {
+                            if(gateway.longRead) {
 
-                                    var buffer = packet.response.value;
-                                    var controllByte = buffer.readInt8(0);
-                                    var numberOfSamples = controllByte & 0x0F;
-                                    var validAxis = (controllByte >> 4) & 0x07;
-                                    var accOrGyro = (controllByte >> 7) & 0x01;
-                                    var sequenceNumber = buffer.readInt8(1);
-
-                                    console.log("Measure Event ", buffer, numberOfSamples, validAxis, accOrGyro);
+                                // attribute value of the read and of each read blob
+                                if(packet.packet.cID == 5 && packet.response.atthandle == gateway.longRead.handle) {
+                                    gateway.longRead.chunks.push(packet.response.value);
+                                    return;
+                                }
 
-                                    var samples = [];
+                                // procedure completed
+                                if(packet.packet.cID == 1 && packet.response.chrhandle == gateway.longRead.handle) {
+                                    gateway.finishLongRead(gateway.longRead, packet.response.result ? ('ATT error ' + packet.response.result) : null);
+                                    return;
+                                }
+                            }
 
-                                    // Decode data points.
-                                    for (var j = 0; j < numberOfSamples; j++) {
+                            if(packet.response.atthandle && gateway.MEASURE_CHAR_DATASTREAM_HANDLE && packet.response.atthandle == gateway.MEASURE_CHAR_DATASTREAM_HANDLE) {
 
-                                        var index = 2 + j*6;
 
-                                        var sample = { sequenceNumber: sequenceNumber,
-                                            point: [  buffer.readInt16LE(index), // X-Achse
-                                                buffer.readInt16LE(index + 2),    // Y-Achse
-                                                buffer.readInt16LE(index + 4) ],   // Z-Achse
-                                            accOrGyro: accOrGyro
-                                        };
+                                if(packet.response && Buffer.isBuffer(packet.response.value)) {
 
-                                        client.publish('/sming/measurement', JSON.stringify(sample));
-                                        samples.push(sample);
+                                    if(gateway.reliable) {
+                                        gateway.receiveReliable(packet.response.connection, packet.response.value);
+                                    }
+                                    else {
+                                        gateway.publishPacket(packet.response.value);
                                     }
 
-                                    console.log("samples: ", samples);
+                                    // a write right after a packet does not wait long for the next connection event
+                                    if(gateway.isClockSyncDue) {
+                                        gateway.synchronizeClock(packet.response.connection);
+                                    }
 
                                 }
                                 else {
                                     console.log("Measure Event: ", (result.message ? result.message : result))
                                 }
                             }
+                            else if(packet.response.atthandle && gateway.MEASURE_CHAR_CONTROL_HANDLE && packet.response.atthandle == gateway.MEASURE_CHAR_CONTROL_HANDLE) {
+
+                                if(Buffer.isBuffer(packet.response.value)) {
+                                    gateway.onControlNotification(packet.response.connection, packet.response.value);
+                                }
+                            }
                             else {
                                 console.log("Attribute: ", packet);
                             }
@@ -313,6 +461,8 @@ require('getmac').getMac(function(err,macAddress){
             gateway = setGatewayByName(gwID, newValue);
 
             gateway.foundSming = false;
+            gateway.controlPending = [];
+            gateway.longRead = null;
 
             gateway.commandQueue.addCommand(new bgCommand.bgCommand(bg.api.systemHello, null), 10000, function(err, command, result) {
 
@@ -325,6 +475,15 @@ require('getmac').getMac(function(err,macAddress){
 
 
             gateway.disconnect = function() {
+                clearTimeout(gateway.clockTimer);
+                gateway.clockTimer = null;
+                clearInterval(gateway.ackTimer);
+                gateway.ackTimer = null;
+                gateway.reliable = null;
+                gateway.isClockSyncDue = false;
+                gateway.clockSync = null;
+                gateway.controlPending = [];
+
                 // disconnect if we are connected already
                 gateway.commandQueue.addCommand(new bgCommand.bgCommand(bg.api.connectionDisconnect, [0]), 10000, function (err, command, result) {
 
@@ -448,23 +607,41 @@ require('getmac').getMac(function(err,macAddress){
                                         var HandleList = [];
                                         var descriptorList = getDescriptors();
                                         var ccidUuid = new Buffer([0x02, 0x29]);
+                                        var lastDescriptor = null;
+
+                                        gateway.ccidHandle = 0;
+                                        gateway.MEASURE_CHAR_CONTROL_HANDLE = 0;
 
                                         for(var j = 0; j < result.resultList.length; j++) {
 
 
-                                            if(result.resultList[j].uuid.equals(ccidUuid)) {
-                                                console.log("CCID Handle gefunden:", result.resultList[j].chrhandle);
-                                                gateway.ccidHandle = result.resultList[j].chrhandle;
+                                            // the CCCD follows the value of its characteristic
+                                            if(result.resultList[j].uuid.equals(ccidUuid) && lastDescriptor !== null) {
+                                                console.log("CCID Handle gefunden:", lastDescriptor.name, result.resultList[j].chrhandle);
+                                                lastDescriptor.cccdHandle = result.resultList[j].chrhandle;
+
+                                                if(lastDescriptor.name == "MEASURE_CHAR_DATASTREAM") {
+                                                    gateway.ccidHandle = result.resultList[j].chrhandle;
+                                                }
                                             }
 
                                             var foundDescriptor = setDescriptorHandle(descriptorList, result.resultList[j].uuid, result.resultList[j].chrhandle);
                                             if( foundDescriptor !== null) {
-                                                HandleList.push(result.resultList[j].chrhandle)
+                                                lastDescriptor = foundDescriptor;
 
                                                 if(foundDescriptor.name == "MEASURE_CHAR_DATASTREAM") {
                                                     gateway.MEASURE_CHAR_DATASTREAM_HANDLE = foundDescriptor.handle;
                                                     console.log("MEASURE_CHAR_DATASTREAM Handle gefunden:", result.resultList[j].chrhandle);
                                                 }
+
+                                                if(foundDescriptor.name == "MEASURE_CHAR_CONTROL") {
+                                                    // write only, it is not read
+                                                    gateway.MEASURE_CHAR_CONTROL_HANDLE = foundDescriptor.handle;
+                                                    console.log("MEASURE_CHAR_CONTROL Handle gefunden:", result.resultList[j].chrhandle);
+                                                }
+                                                else if(foundDescriptor.name != "DEVICE_INFO_CHAR_SNAPSHOT") {
+                                                    HandleList.push(result.resultList[j].chrhandle)
+                                                }
                                             }
                                         }
 
@@ -472,49 +649,63 @@ require('getmac').getMac(function(err,macAddress){
                                         console.log("attClientFindInformation result -> list of handles of interest: ", HandleList);
 
 
-                                        for(var l = 0; l < HandleList.length; l++) {
-
-                                            var theCommand = new bgCommand.bgCommand(bg.api.attClientReadByHandle, [connectionHandle, HandleList[l]]);
+                                        var finished = function() {
 
-                                            theCommand.isLastCommand = (l + 1 >= HandleList.length);
+                                            console.log("finished: ", descriptorList);
 
-                                            gateway.commandQueue.addCommand(theCommand, 10000, function (err, command, result) {
 
-                                                if (err) {
-                                                    return console.error("attClientReadByHandle error", err);
-                                                }
-                                                console.log("attClientReadByHandle result", command.duration, ( result.readData && result.readData.value ? result.readData.value.toString() : (result.message ? result.message : result)));
+                                            gateway.startMeasuring(connectionHandle, descriptorList, function(err) {
 
 
-                                                if(result.readData && result.readData.value) {
-                                                    setDescriptorValueByHandle(descriptorList, result.readData.atthandle, result.readData.value);
-                                                }
+                                                /*
+                                                for(var o = 0; o < 29; o++) {
 
-                                                if(command.command.isLastCommand) {
+                                                    gateway.readAttribut(connectionHandle, descriptorList, "MEASURE_CHAR_DATASTREAM", function (err, command, result) {
 
-                                                    console.log("finished: ", descriptorList);
 
+                                                    });
 
-                                                    gateway.startMeasuring(connectionHandle, descriptorList, function(err) {
-
+                                                }
+                                                */
 
-                                                        /*
-                                                        for(var o = 0; o < 29; o++) {
+                                            })
+                                        };
 
-                                                            gateway.readAttribut(connectionHandle, descriptorList, "MEASURE_CHAR_DATASTREAM", function (err, command, result) {
+                                        // one long read of the snapshot instead of a read per characteristic
+                                        var snapshotDescriptor = getDescriptorByKey(descriptorList, 'DEVICE_INFO_CHAR_SNAPSHOT');
+                                        gateway.snapshot = null;
 
+                                        if(!(snapshotDescriptor.handle > 0)) {
+                                            return gateway.readHandles(connectionHandle, descriptorList, HandleList, finished);
+                                        }
 
-                                                            });
+                                        gateway.readLong(connectionHandle, snapshotDescriptor.handle, function(err, value) {
 
-                                                        }
-                                                        */
+                                            var snapshot = err ? null : decodeSnapshot(value);
 
-                                                    })
+                                            if(snapshot === null) {
+                                                console.log("snapshot not available, read the characteristics one by one:", err ? err : value);
+                                                return gateway.readHandles(connectionHandle, descriptorList, HandleList, finished);
+                                            }
 
+                                            console.log("snapshot", snapshot);
+                                            gateway.snapshot = snapshot;
+                                            snapshotDescriptor.value = value;
 
+                                            for(var k = 0; k < snapshotStrings.length; k++) {
+                                                var stringDescriptor = snapshotStrings[k] ? getDescriptorByKey(descriptorList, snapshotStrings[k]) : null;
+                                                if(stringDescriptor) {
+                                                    stringDescriptor.value = snapshot.strings[k];
                                                 }
+                                            }
+
+                                            var remainingHandles = HandleList.filter(function(handle) {
+                                                var descriptor = getDescriptorByHandle(descriptorList, handle);
+                                                return snapshotCovers.indexOf(descriptor.name) < 0;
                                             });
-                                        }
+
+                                            gateway.readHandles(connectionHandle, descriptorList, remainingHandles, finished);
+                                        });
                                     });
 
   /*                                  //break;
@@ -553,6 +744,7 @@ require('getmac').getMac(function(err,macAddress){
                 setTimeout(function() {
 
                     client.publish('/sming/stop', 'stop sming measuring, wait 60s before scanning');
+                    gateway.stopMeasuring(0);
                     gateway.disconnect();
 
                     setTimeout(gateway.startScanning, 60000) }, 2 * 60 * 1000);
@@ -569,6 +761,12 @@ require('getmac').getMac(function(err,macAddress){
                     return callback("no ccidHandle available!");
                 }
 
+                var control = getDescriptorByKey(descriptorList, 'MEASURE_CHAR_CONTROL');
+                if(control && control.handle > 0 && control.cccdHandle) {
+                    return gateway.startMeasuringWithControl(connectionHandle, control, callback);
+                }
+
+                // firmware without control point: enable both sensors and start with a write each
                 gateway.writeAttribut(connectionHandle, descriptorList, 'LSM330_CHAR_GYRO_EN', new Buffer([1]), function(err, command, result) {
 
                     if(err) {
@@ -616,6 +814,356 @@ require('getmac').getMac(function(err,macAddress){
 
 
 
+            };
+
+            /* reads the handles one after the other */
+            gateway.readHandles = function(connectionHandle, descriptorList, handles, callback) {
+
+                if(handles.length == 0) {
+                    return callback();
+                }
+
+                gateway.commandQueue.addCommand(new bgCommand.bgCommand(bg.api.attClientReadByHandle, [connectionHandle, handles[0]]), 10000, function (err, command, result) {
+
+                    if (err) {
+                        return console.error("attClientReadByHandle error", err);
+                    }
+                    console.log("attClientReadByHandle result", command.duration, ( result.readData && result.readData.value ? result.readData.value.toString() : (result.message ? result.message : result)));
+
+
+                    if(result.readData && result.readData.value) {
+                        setDescriptorValueByHandle(descriptorList, result.readData.atthandle, result.readData.value);
+                    }
+
+                    gateway.readHandles(connectionHandle, descriptorList, handles.slice(1), callback);
+                });
+            };
+
+            /* reads a value longer than one response with read blobs, the parts arrive as events */
+            gateway.readLong = function(connectionHandle, handle, callback) {
+
+                var longRead = { handle: handle, chunks: [], callback: callback };
+
+                longRead.timer = setTimeout(function() { gateway.finishLongRead(longRead, 'timeout'); }, 10000);
+                gateway.longRead = longRead;
+
+                gateway.commandQueue.addCommand(new bgCommand.bgCommand(bg.api.attClientReadLong, [connectionHandle, handle]), 10000, function(err, command, result) {
+
+                    if(err) {
+                        gateway.finishLongRead(longRead, err);
+                    }
+                });
+            };
+
+            gateway.finishLongRead = function(longRead, err) {
+
+                if(gateway.longRead !== longRead) {
+                    return;
+                }
+
+                clearTimeout(longRead.timer);
+                gateway.longRead = null;
+                longRead.callback(err, err ? null : Buffer.concat(longRead.chunks));
+            };
+
+            /* decodes a packet of the data stream and publishes its samples */
+            gateway.publishPacket = function(buffer) {
+
+                var controllByte = buffer.readInt8(0);
+                var numberOfSamples = controllByte & 0x0F;
+                var validAxis = (controllByte >> 4) & 0x07;
+                var accOrGyro = (controllByte >> 7) & 0x01;
+                var sequenceNumber = buffer.readUInt8(1);
+
+                console.log("Measure Event ", buffer, numberOfSamples, validAxis, accOrGyro);
+
+                var samples = [];
+
+                // Decode data points.
+                for (var j = 0; j < numberOfSamples; j++) {
+
+                    var index = 2 + j*6;
+
+                    var sample = { sequenceNumber: sequenceNumber,
+                        point: [  buffer.readInt16LE(index), // X-Achse
+                            buffer.readInt16LE(index + 2),    // Y-Achse
+                            buffer.readInt16LE(index + 4) ],   // Z-Achse
+                        accOrGyro: accOrGyro
+                    };
+
+                    client.publish('/sming/measurement', JSON.stringify(sample));
+                    samples.push(sample);
+                }
+
+                console.log("samples: ", samples);
+            };
+
+            /* reliable mode: keeps the packets behind a gap and publishes them in order */
+            gateway.receiveReliable = function(connectionHandle, buffer) {
+
+                var reliable = gateway.reliable;
+                var sequenceNumber = buffer.readUInt8(1);
+                var offset = (sequenceNumber - reliable.next) & 0xFF;
+
+                if(offset >= ackWindowSize || reliable.reorder[sequenceNumber]) {
+                    return console.log("reliable mode: duplicate packet", sequenceNumber);
+                }
+                delete reliable.requested[sequenceNumber];
+
+                if(offset > 0) {
+                    reliable.reorder[sequenceNumber] = buffer;
+
+                    // a new gap is acknowledged right away
+                    for(var number = reliable.next; number != sequenceNumber; number = (number + 1) & 0xFF) {
+                        if(!reliable.reorder[number] && !reliable.requested[number]) {
+                            return gateway.acknowledge(connectionHandle, false);
+                        }
+                    }
+                    return;
+                }
+
+                gateway.publishPacket(buffer);
+                reliable.next = (reliable.next + 1) & 0xFF;
+                reliable.unacked++;
+                while(reliable.reorder[reliable.next]) {
+                    gateway.publishPacket(reliable.reorder[reliable.next]);
+                    delete reliable.reorder[reliable.next];
+                    reliable.next = (reliable.next + 1) & 0xFF;
+                    reliable.unacked++;
+                }
+
+                reliable.lastProgress = Date.now();
+                if(reliable.unacked >= reliable.ackInterval) {
+                    gateway.acknowledge(connectionHandle, false);
+                }
+            };
+
+            /* writes an acknowledgement, see app/control.h of the firmware: the next packet in order
+               and the missing ones before the last packet kept, a repeat lists all of them again */
+            gateway.acknowledge = function(connectionHandle, isRepeat) {
+
+                var reliable = gateway.reliable;
+                var bytes = [controlOpcodes.ACK, reliable.next];
+                var last = 0;
+
+                for(var offset = 0; offset < ackWindowSize; offset++) {
+                    if(reliable.reorder[(reliable.next + offset) & 0xFF]) {
+                        last = offset;
+                    }
+                }
+
+                for(var offset = 0; (offset < last || (isRepeat && offset == 0)) && bytes.length < 2 + ackMaxMissing; offset++) {
+                    var number = (reliable.next + offset) & 0xFF;
+                    if(!reliable.reorder[number] && (isRepeat || !reliable.requested[number])) {
+                        bytes.push(number);
+                        reliable.requested[number] = true;
+                    }
+                }
+
+                reliable.unacked = 0;
+                reliable.lastProgress = Date.now();
+
+                gateway.commandQueue.addCommand(new bgCommand.bgCommand(bg.api.attClientWriteCommand, [connectionHandle, gateway.MEASURE_CHAR_CONTROL_HANDLE, new Buffer(bytes)]), 30000, function(err, command, result) {
+
+                    if(err) {
+                        return console.error("write acknowledgement error", err);
+                    }
+                });
+            };
+
+            gateway.startMeasuringWithControl = function(connectionHandle, control, callback) {
+
+                var config = {
+                    acc         : measureConfig.acc,
+                    gyro        : measureConfig.gyro,
+                    streamMode  : measureConfig.streamMode,
+                    duration    : measureConfig.duration,
+                    ackInterval : measureConfig.ackInterval
+                };
+
+                if(gateway.snapshot) {
+                    config.acc = config.acc || getSensorConfig(gateway.snapshot.acc);
+                    config.gyro = config.gyro || getSensorConfig(gateway.snapshot.gyro);
+                }
+
+                gateway.commandQueue.addCommand(new bgCommand.bgCommand(bg.api.attClientAttributeWrite, [connectionHandle, control.cccdHandle, new Buffer([0x01, 0x00])]), 30000, function(err, command, result) {
+
+                    if(err) {
+                        return console.error("write control ccidHandle error", err);
+                    }
+
+                    gateway.commandQueue.addCommand(new bgCommand.bgCommand(bg.api.attClientAttributeWrite, [connectionHandle, gateway.ccidHandle, new Buffer([0x01, 0x00])]), 30000, function(err, command, result) {
+
+                        if(err) {
+                            return console.error("write ccidHandle error", err);
+                        }
+
+                        gateway.sendControlCommands(connectionHandle, getControlCommands(controlOpcodes.START, config), function(err) {
+
+                            if(err) {
+                                console.error("control point START error", err);
+                                return callback(err);
+                            }
+
+                            // the device starts the sequence numbers at 0
+                            clearInterval(gateway.ackTimer);
+                            gateway.ackTimer = null;
+                            gateway.reliable = null;
+                            if(config.ackInterval) {
+                                gateway.reliable = { ackInterval: config.ackInterval, next: 0, unacked: 0,
+                                    reorder: {}, requested: {}, lastProgress: Date.now() };
+
+                                // repeats the acknowledgement when a retransmission or the last packets got lost
+                                gateway.ackTimer = setInterval(function() {
+                                    var reliable = gateway.reliable;
+                                    if(reliable && (reliable.unacked > 0 || Object.keys(reliable.reorder).length > 0) &&
+                                        Date.now() - reliable.lastProgress >= ackTimeout) {
+                                        gateway.acknowledge(connectionHandle, true);
+                                    }
+                                }, ackTimeout);
+                            }
+
+                            // synchronize the clock now and then regularly
+                            gateway.synchronizeClock(connectionHandle);
+                            clearTimeout(gateway.clockTimer);
+                            (function scheduleClockSync() {
+                                gateway.clockTimer = setTimeout(function() {
+                                    gateway.isClockSyncDue = true;
+                                    scheduleClockSync();
+                                }, clockSyncInterval * (1 + clockSyncJitter * Math.random()));
+                            })();
+
+                            callback(null, true);
+                        });
+                    });
+                });
+            };
+
+            gateway.stopMeasuring = function(connectionHandle) {
+
+                if(!gateway.MEASURE_CHAR_CONTROL_HANDLE) {
+                    return;
+                }
+
+                gateway.sendControlCommands(connectionHandle, [new Buffer([controlOpcodes.STOP])], function(err) {
+
+                    if(err) {
+                        return console.error("control point STOP error", err);
+                    }
+                    console.log("control point STOP done");
+                });
+            };
+
+            /* writes the commands one after the other, each waits for its status */
+            gateway.sendControlCommands = function(connectionHandle, commands, callback) {
+
+                if(commands.length == 0) {
+                    return callback(null);
+                }
+
+                var pending = { opcode: commands[0][0], callback: function(err) {
+
+                    if(err) {
+                        return callback(err);
+                    }
+                    gateway.sendControlCommands(connectionHandle, commands.slice(1), callback);
+                }};
+                gateway.controlPending.push(pending);
+
+                gateway.commandQueue.addCommand(new bgCommand.bgCommand(bg.api.attClientAttributeWrite, [connectionHandle, gateway.MEASURE_CHAR_CONTROL_HANDLE, commands[0]]), 30000, function(err, command, result) {
+
+                    if(err) {
+                        // no status will come
+                        var index = gateway.controlPending.indexOf(pending);
+                        if(index >= 0) {
+                            gateway.controlPending.splice(index, 1);
+                        }
+                        return callback(err);
+                    }
+                });
+            };
+
+            /* status of a command or answer of a clock exchange */
+            gateway.onControlNotification = function(connectionHandle, value) {
+
+                var opcode = value.readUInt8(0);
+
+                if(opcode == controlOpcodes.SYNC && value.length == 9) {
+                    return gateway.onClockSyncAnswer(connectionHandle, value.readUInt32LE(1), value.readUInt32LE(5));
+                }
+
+                if(value.length < 3) {
+                    return console.log("control point: unknown notification", value);
+                }
+
+                var status = value.readUInt8(1);
+                var err = null;
+                if(status != 0) {
+                    err = (controlStatus[status] || ('status ' + status)) + ' (field type ' + value.readUInt8(2) + ')';
+                }
+
+                for(var i = 0; i < gateway.controlPending.length; i++) {
+
+                    if(gateway.controlPending[i].opcode == opcode) {
+                        var pending = gateway.controlPending.splice(i, 1)[0];
+                        return pending.callback(err);
+                    }
+                }
+
+                console.log("control point: status of opcode", opcode, ":", err ? err : controlStatus[0]);
+            };
+
+            /* starts a clock exchange, see app/clock.h of the firmware */
+            gateway.synchronizeClock = function(connectionHandle) {
+
+                if(!gateway.MEASURE_CHAR_CONTROL_HANDLE) {
+                    return;
+                }
+
+                var command = new Buffer(5);
+                var gatewayTime = getGatewayTime();
+
+                gateway.isClockSyncDue = false;
+                gateway.clockSync = { gatewayTime: gatewayTime, sent: Date.now() };
+
+                command.writeUInt8(controlOpcodes.SYNC, 0);
+                command.writeUInt32LE(gatewayTime, 1);
+
+                gateway.commandQueue.addCommand(new bgCommand.bgCommand(bg.api.attClientAttributeWrite, [connectionHandle, gateway.MEASURE_CHAR_CONTROL_HANDLE, command]), 30000, function(err, command, result) {
+
+                    if(err) {
+                        return console.error("write clock exchange error", err);
+                    }
+                });
+            };
+
+            /* takes the middle of the round trip as gateway time at the device time of the answer */
+            gateway.onClockSyncAnswer = function(connectionHandle, gatewayTime, deviceTime) {
+
+                if(!gateway.clockSync || gateway.clockSync.gatewayTime != gatewayTime) {
+                    return console.log("clock exchange: stale answer", gatewayTime);
+                }
+
+                var roundTrip = Date.now() - gateway.clockSync.sent;
+                gateway.clockSync = null;
+
+                if(roundTrip > 0xFFFF) {
+                    return console.log("clock exchange: round trip too long", roundTrip);
+                }
+
+                var command = new Buffer(11);
+                command.writeUInt8(controlOpcodes.TIME, 0);
+                command.writeUInt32LE(deviceTime, 1);
+                command.writeUInt32LE((gatewayTime + Math.round(roundTrip / 2)) >>> 0, 5);
+                command.writeUInt16LE(roundTrip, 9);
+
+                gateway.sendControlCommands(connectionHandle, [command], function(err) {
+
+                    if(err) {
+                        return console.log("clock exchange rejected:", err);
+                    }
+                    console.log("clock exchange: device time", deviceTime, "round trip", roundTrip, "ms");
+                });
             };
 
             gateway.writeAttribut = function(connection, descriptorList, key, newValueBuffer, callback) {
@@ -7,8 +7,7 @@ var S = require('string'),
     commandQueue = libCommandQueue.commandQueue,
     SerialPort = require("serialport").SerialPort,
     events = require('events'),
-    VError = require('verror'),
-    AdafruitTMP006 = require('./adafruit_tmp006');
+    VError = require('verror');
 
 var sPort = "/dev/ttyACM0";
 
@@ -58,11 +57,15 @@ var descriptorDefinitions = {
     MEASURE_CHAR_DURATION   : "8EDF0303-67E5-DB83-F85B-A1E2AB1C9E7A",
     MEASURE_CHAR_DATASTREAM : "8EDF0304-67E5-DB83-F85B-A1E2AB1C9E7A",
 
+    TEMP_CONTACTLESS_SERVICE          : "8EDF0400-67E5-DB83-F85B-A1E2AB1C9E7A",
+    TEMP_CONTACTLESS_CHAR_TEMP_SAMPLE : "8EDF0401-67E5-DB83-F85B-A1E2AB1C9E7A",
+
     I2C_SERVICE             : "8EDF0500-67E5-DB83-F85B-A1E2AB1C9E7A",
     I2C_CHAR_DEVICE_ADDRESS : "8EDF0501-67E5-DB83-F85B-A1E2AB1C9E7A",
     I2C_CHAR_DEVICE_REGISTER: "8EDF0502-67E5-DB83-F85B-A1E2AB1C9E7A",
     I2C_CHAR_READ_LENGTH    : "8EDF0503-67E5-DB83-F85B-A1E2AB1C9E7A",
-    I2C_CHAR_VALUE          : "8EDF0504-67E5-DB83-F85B-A1E2AB1C9E7A"
+    I2C_CHAR_VALUE          : "8EDF0504-67E5-DB83-F85B-A1E2AB1C9E7A",
+    I2C_CHAR_SCRIPT         : "8EDF0505-67E5-DB83-F85B-A1E2AB1C9E7A"
     };
 
 var getUUIDBuffer = function(UUID) {
@@ -885,106 +888,26 @@ function decorateSmingFunctionality(gateway) {
                 var theRemoteDevice = newRemoteDevice;
 
 
-                theRemoteDevice.tmp006 = new AdafruitTMP006.Adafruit_TMP006(null, null);
-
-                theRemoteDevice.tmp006.on('writeI2C', function(i2cAddr, register, writeSize, value, callback) {
-
-                    console.log('writeI2C', i2cAddr, register, writeSize, value)
-,
-                    theRemoteDevice.writeGATTAttribute('I2C_CHAR_DEVICE_ADDRESS', new Buffer([i2cAddr]), function(err, command, result) {
-
-                        if (err) {
-                            return callback(new VError(err, "btRemoteDevice %s write I2C_CHAR_DEVICE_ADDRESS error", theRemoteDevice.mac));
-                        }
-
-                        theRemoteDevice.writeGATTAttribute('I2C_CHAR_DEVICE_REGISTER', new Buffer([register]), function(err, command, result) {
-
-                            if (err) {
-                                return callback(new VError(err, "btRemoteDevice %s write I2C_CHAR_DEVICE_REGISTER error", theRemoteDevice.mac));
-                            }
-
-                            theRemoteDevice.writeGATTAttribute('I2C_CHAR_READ_LENGTH', new Buffer([writeSize]), function(err, command, result) {
-
-                                if (err) {
-                                    return callback(new VError(err, "btRemoteDevice %s write I2C_CHAR_READ_LENGTH error", theRemoteDevice.mac));
-                                }
-
-                                theRemoteDevice.writeGATTAttribute('I2C_CHAR_VALUE', new Buffer([value]), function(err, command, result) {
-
-                                    if (err) {
-                                        return callback(new VError(err, "btRemoteDevice %s write I2C_CHAR_VALUE error", theRemoteDevice.mac));
-                                    }
-
-                                    console.log('writeI2C success');
-                                    callback(null);
-                                });
-                            });
-                        });
-                    });
-                });
+                console.log('Device ', theRemoteDevice.mac , ' is starting up sming measuring.... ');
 
-                theRemoteDevice.tmp006.on('readI2C', function(i2cAddr, register, readSize, callback) {
+                mqttClient.publish('/sming/' + theRemoteDevice.mac + '/start', 'start measuring');
 
-                    console.log('readI2C', i2cAddr, register, readSize);
+                // the device converts the TMP006 values itself, one read per sample
+                theRemoteDevice.setPollingInterval(setInterval(function () {
 
-                    theRemoteDevice.writeGATTAttribute('I2C_CHAR_DEVICE_ADDRESS', new Buffer([i2cAddr]), function(err, command, result) {
+                    theRemoteDevice.readGATTAttribut('TEMP_CONTACTLESS_CHAR_TEMP_SAMPLE', function (err, command, result) {
 
                         if (err) {
-                            return callback(new VError(err, "btRemoteDevice %s write I2C_CHAR_DEVICE_ADDRESS error", theRemoteDevice.mac));
+                            return console.error(theRemoteDevice.mac, 'Error reading infrared temperature: ', err);
                         }
 
-                        theRemoteDevice.writeGATTAttribute('I2C_CHAR_DEVICE_REGISTER', new Buffer([register]), function(err, command, result) {
-
-                            if (err) {
-                                return callback(new VError(err, "btRemoteDevice %s write I2C_CHAR_DEVICE_REGISTER error", theRemoteDevice.mac));
-                            }
-
-                            theRemoteDevice.writeGATTAttribute('I2C_CHAR_READ_LENGTH', new Buffer([readSize]), function(err, command, result) {
-
-                                if (err) {
-                                    return callback(new VError(err, "btRemoteDevice %s write I2C_CHAR_READ_LENGTH error", theRemoteDevice.mac));
-                                }
-
-                                theRemoteDevice.readGATTAttribut('I2C_CHAR_VALUE', function(err, command, result) {
-
-                                    if (err) {
-                                        return callback(new VError(err, "btRemoteDevice %s write I2C_CHAR_VALUE error", theRemoteDevice.mac));
-                                    }
-
-                                    callback(null, result.readData.value);
-                                });
-                            });
-                        });
+                        // object temperature in 0.01 degC
+                        var tempC = result.readData.value.readInt16LE(0) / 100;
+                        console.log('Device', theRemoteDevice.mac, 'read infrared temp: ', tempC);
                     });
-                });
-
-
-                console.log('Device ', theRemoteDevice.mac , ' is starting up sming measuring.... ');
-
-                mqttClient.publish('/sming/' + theRemoteDevice.mac + '/start', 'start measuring');
+                }, 5000));
 
-                theRemoteDevice.tmp006.initTMP006(function(err) {
-
-                    if (err) {
-                        return callback(new VError(err, "btRemoteDevice %s initTMP006", theRemoteDevice.mac));
-                    }
-
-                    theRemoteDevice.setPollingInterval(setInterval(function () {
-
-                        theRemoteDevice.tmp006.readObjTempC(function (err, tempC) {
-
-                            if (err) {
-                                return console.error(theRemoteDevice.mac, 'Error reading infrared temperature: ', err);
-                            }
-
-                            console.log('Device', theRemoteDevice.mac, 'read infrared temp: ', tempC);
-
-                        })
-                    }, 5000));
-
-                    callback(null, true);
-
-                });
+                callback(null, true);
 
 
 
@@ -34,6 +34,7 @@ static volatile uint8_t m_queue_start_index;    /**< Index of queue entry at the
 static volatile uint8_t m_queue_end_index;      /**< Index of queue entry at the end of the queue. */
 static uint16_t         m_queue_event_size;     /**< Maximum event size in queue. */
 static uint16_t         m_queue_size;           /**< Number of queue entries. */
+static uint16_t         m_max_queue_utilization;    /**< Maximum number of entries observed in the queue. */
 
 /**@brief Macro for checking if a queue is full. */
 #define APP_SCHED_QUEUE_FULL() (next_index(m_queue_end_index) == m_queue_start_index)
@@ -54,6 +55,30 @@ static __INLINE uint8_t next_index(uint8_t index)
 }
 
 
+/**@brief Function for updating the maximum observed queue utilization.
+ *
+ * @note Has to be called from within the critical region of app_sched_event_put().
+ */
+static __INLINE void queue_utilization_check(void)
+{
+    uint16_t start = m_queue_start_index;
+    uint16_t end   = m_queue_end_index;
+    uint16_t queue_utilization = (end >= start) ? (end - start) :
+                                                  (m_queue_size + 1 - start + end);
+
+    if (queue_utilization > m_max_queue_utilization)
+    {
+        m_max_queue_utilization = queue_utilization;
+    }
+}
+
+
+uint16_t app_sched_queue_utilization_get(void)
+{
+    return m_max_queue_utilization;
+}
+
+
 uint32_t app_sched_init(uint16_t event_size, uint16_t queue_size, void * p_event_buffer)
 {
     uint16_t data_start_index = (queue_size + 1) * sizeof(event_header_t);
@@ -71,6 +96,7 @@ uint32_t app_sched_init(uint16_t event_size, uint16_t queue_size, void * p_event
     m_queue_start_index   = 0;
     m_queue_event_size    = event_size;
     m_queue_size          = queue_size;
+    m_max_queue_utilization = 0;
 
     return NRF_SUCCESS;
 }
@@ -92,6 +118,7 @@ uint32_t app_sched_event_put(void                    * p_event_data,
         {
             event_index       = m_queue_end_index;
             m_queue_end_index = next_index(m_queue_end_index);
+            queue_utilization_check();
         }
 
         CRITICAL_REGION_EXIT();
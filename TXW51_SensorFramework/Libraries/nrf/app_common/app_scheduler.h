@@ -129,6 +129,12 @@ uint32_t app_sched_event_put(void *                    p_event_data,
                              uint16_t                  event_size,
                              app_sched_event_handler_t handler);
 
+/**@brief Function for getting the maximum observed queue utilization.
+ *
+ * @return Maximum number of events in the queue since the initialization.
+ */
+uint16_t app_sched_queue_utilization_get(void);
+
 #endif // APP_SCHEDULER_H__
 
 /** @} */
@@ -37,7 +37,8 @@ typedef enum
     DFU_STATE_RX_INIT_PKT,                                                          /**< State for: receiving initialization packet. */
     DFU_STATE_RX_DATA_PKT,                                                          /**< State for: receiving data packet. */
     DFU_STATE_VALIDATE,                                                             /**< State for: validate. */
-    DFU_STATE_WAIT_4_ACTIVATE                                                       /**< State for: waiting for dfu_image_activate(). */
+    DFU_STATE_WAIT_4_ACTIVATE,                                                      /**< State for: waiting for dfu_image_activate(). */
+    DFU_STATE_PATCHING                                                              /**< State for: building the application from a delta image. */
 } dfu_state_t;
 
 #define APP_TIMER_PRESCALER         0                                               /**< Value of the RTC1 PRESCALER register. */
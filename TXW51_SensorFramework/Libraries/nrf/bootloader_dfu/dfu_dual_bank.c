@@ -33,6 +33,10 @@
 #include "pstorage.h"
 #include "nrf_gpio.h"
 #include "nrf_mbr.h"
+#include "txw51_framework/utils/delta.h"
+#include "txw51_framework/utils/txw51_errors.h"
+
+#define DFU_DELTA_BLOCK_SIZE                256                         /**< Size of the blocks the application is built in from a delta image (multiple of a word). */
 
 static dfu_state_t                  m_dfu_state;                /**< Current DFU state. */
 static uint32_t                     m_image_size;               /**< Size of the image that will be transmitted. */
@@ -52,6 +56,14 @@ static pstorage_handle_t          * mp_storage_handle_active;   /**< Pointer to
 static dfu_callback_t               m_data_pkt_cb;              /**< Callback from DFU Bank module for notification of asynchronous operation such as flash prepare. */
 static dfu_bank_func_t              m_functions;                /**< Structure holding operations for the selected update process. */
 
+static bool                         m_is_delta;                 /**< The received application image is a delta to the application in bank 0. */
+static struct TXW51_DELTA_Patch     m_delta;                    /**< State of the delta image in bank 1. */
+static uint32_t                     m_delta_target_offset;      /**< Offset of the application built from the delta in bank 1, the first page behind the delta. */
+static uint32_t                     m_delta_written;            /**< Number of bytes of the built application that have been stored. */
+static uint32_t                     m_delta_block[DFU_DELTA_BLOCK_SIZE / sizeof(uint32_t)];    /**< Block of the built application that is being stored. */
+
+static void dfu_delta_store_next(void);
+
 
 /**@brief Function for handling callbacks from pstorage module.
  *
@@ -64,6 +76,14 @@ static void pstorage_callback_handler(pstorage_handle_t * p_handle,
                                       uint8_t           * p_data,
                                       uint32_t            data_len)
 {
+    if ((m_dfu_state == DFU_STATE_PATCHING) &&
+        (op_code == PSTORAGE_STORE_OP_CODE) &&
+        (result == NRF_SUCCESS))
+    {
+        // The previous block of the application built from a delta has been stored.
+        dfu_delta_store_next();
+    }
+
     if (m_data_pkt_cb != NULL)
     {
         switch (op_code)
@@ -227,14 +247,13 @@ static uint32_t dfu_activate_sd(void)
 }
 
 
-/**@brief Function for activating received Application image.
+/**@brief Function for copying an application image to the application area (bank 0).
  *
- *  @details This function will move the received application image fram swap (bank 1) to
- *           application area (bank 0).
+ * @param[in] p_src  Address of the image in bank 1, the size is taken from the start packet.
  *
  * @return NRF_SUCCESS on success. Error code otherwise.
  */
-static uint32_t dfu_activate_app(void)
+static uint32_t dfu_app_copy(uint8_t * p_src)
 {
     uint32_t err_code;
 
@@ -243,7 +262,7 @@ static uint32_t dfu_activate_app(void)
     APP_ERROR_CHECK(err_code);
 
     err_code = pstorage_raw_store(&m_storage_handle_app,
-                                  (uint8_t *)m_storage_handle_swap.block_id,
+                                  p_src,
                                   m_start_packet.app_image_size,
                                   0);
 
@@ -262,6 +281,126 @@ static uint32_t dfu_activate_app(void)
 }
 
 
+/**@brief Function for checking if the received image is a delta image and if it can be applied.
+ *
+ * @details A delta image is sent like an application image and recognized by its header. It has
+ *          to be made for the application in bank 0 and the built application has to fit into
+ *          bank 1 behind the delta.
+ *
+ * @return NRF_SUCCESS for a full image or a delta image that can be applied.
+ *         NRF_ERROR_INVALID_DATA if the delta image has been made for another application.
+ *         NRF_ERROR_DATA_SIZE if the built application does not fit into bank 1.
+ */
+static uint32_t dfu_delta_check(void)
+{
+    bootloader_settings_t bootloader_settings;
+    uint8_t             * p_delta = (uint8_t *)m_storage_handle_swap.block_id;
+
+    m_is_delta = false;
+
+    if (!IS_UPDATING_APP(m_start_packet) ||
+        (TXW51_DELTA_ReadHeader(p_delta, m_image_size, &m_delta.Header) != ERR_NONE))
+    {
+        // A full image.
+        return NRF_SUCCESS;
+    }
+
+    bootloader_settings_get(&bootloader_settings);
+    if ((bootloader_settings.bank_0 != BANK_VALID_APP) ||
+        (TXW51_DELTA_Init(&m_delta,
+                          (uint8_t *)DFU_BANK_0_REGION_START,
+                          bootloader_settings.bank_0_size,
+                          p_delta,
+                          m_image_size) != ERR_NONE))
+    {
+        return NRF_ERROR_INVALID_DATA;
+    }
+
+    m_delta_target_offset = (m_image_size + CODE_PAGE_SIZE - 1) & ~(CODE_PAGE_SIZE - 1);
+    if (!IS_WORD_SIZED(m_delta.Header.TargetSize) ||
+        (m_delta.Header.TargetSize > (DFU_IMAGE_MAX_SIZE_BANKED - m_delta_target_offset)))
+    {
+        return NRF_ERROR_DATA_SIZE;
+    }
+
+    m_delta_written = 0;
+    m_is_delta      = true;
+
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for storing the next block of the application built from a delta image.
+ *
+ * @details Called for the first block and then whenever the previous block has been stored, so
+ *          only one block is in RAM. When the application is complete, it is checked in the flash
+ *          with its CRC and copied to bank 0. If anything fails, the update is aborted and the
+ *          application in bank 0 stays untouched.
+ */
+static void dfu_delta_store_next(void)
+{
+    uint32_t err_code;
+    uint32_t length;
+
+    if (TXW51_DELTA_IsComplete(&m_delta))
+    {
+        uint8_t * p_target = (uint8_t *)(m_storage_handle_swap.block_id + m_delta_target_offset);
+
+        m_image_crc = crc16_compute(p_target, m_delta.Header.TargetSize, NULL);
+        if (m_image_crc != m_delta.Header.TargetCrc)
+        {
+            dfu_reset();
+            return;
+        }
+
+        m_dfu_state                   = DFU_STATE_WAIT_4_ACTIVATE;
+        m_start_packet.app_image_size = m_delta.Header.TargetSize;
+
+        err_code = dfu_app_copy(p_target);
+        APP_ERROR_CHECK(err_code);
+        return;
+    }
+
+    if (TXW51_DELTA_Apply(&m_delta,
+                          (uint8_t *)m_delta_block,
+                          DFU_DELTA_BLOCK_SIZE,
+                          &length) != ERR_NONE)
+    {
+        dfu_reset();
+        return;
+    }
+
+    err_code = pstorage_raw_store(&m_storage_handle_swap,
+                                  (uint8_t *)m_delta_block,
+                                  length,
+                                  m_delta_target_offset + m_delta_written);
+    APP_ERROR_CHECK(err_code);
+
+    m_delta_written += length;
+}
+
+
+/**@brief Function for activating received Application image.
+ *
+ *  @details This function will move the received application image fram swap (bank 1) to
+ *           application area (bank 0). A delta image is first applied to the application in
+ *           bank 0, the result is moved when it is complete.
+ *
+ * @return NRF_SUCCESS on success. Error code otherwise.
+ */
+static uint32_t dfu_activate_app(void)
+{
+    if (m_is_delta)
+    {
+        m_dfu_state = DFU_STATE_PATCHING;
+        dfu_delta_store_next();
+        return NRF_SUCCESS;
+    }
+
+    return dfu_app_copy((uint8_t *)m_storage_handle_swap.block_id);
+}
+
+
 /**@brief Function for activating received Bootloader image.
  *
  *  @note This function will not move the bootloader image.
@@ -590,6 +729,12 @@ uint32_t dfu_image_validate()
                         return NRF_ERROR_INVALID_DATA;
                     }
 
+                    err_code = dfu_delta_check();
+                    if (err_code != NRF_SUCCESS)
+                    {
+                        return err_code;
+                    }
+
                     m_dfu_state = DFU_STATE_WAIT_4_ACTIVATE;
                 }
             }
@@ -0,0 +1,42 @@
+/***************************************************************************//**
+ * @brief   Host replacement of the CMSIS core function header.
+ *
+ * The simulation has no interrupt nesting, so the PRIMASK is only kept as a
+ * value for the code that reads it back.
+ *
+ * @file    core_cmFunc.h
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+#ifndef __CORE_CMFUNC_H
+#define __CORE_CMFUNC_H
+
+/*----- Header-Files ---------------------------------------------------------*/
+#include <stdint.h>
+
+/*----- Macros ---------------------------------------------------------------*/
+
+/*----- Data types -----------------------------------------------------------*/
+
+/*----- Function prototypes --------------------------------------------------*/
+
+/*----- Data -----------------------------------------------------------------*/
+extern uint32_t gSimPrimask;    /**< Value of the PRIMASK register. */
+
+/*----- Implementation -------------------------------------------------------*/
+
+static inline void     __enable_irq(void)             { gSimPrimask = 0; }
+static inline void     __disable_irq(void)            { gSimPrimask = 1; }
+static inline uint32_t __get_PRIMASK(void)            { return gSimPrimask; }
+static inline void     __set_PRIMASK(uint32_t mask)   { gSimPrimask = mask; }
+static inline uint32_t __get_CONTROL(void)            { return 0; }
+static inline uint32_t __get_IPSR(void)               { return 0; }
+static inline uint32_t __get_APSR(void)               { return 0; }
+static inline uint32_t __get_xPSR(void)               { return 0; }
+
+#endif /* __CORE_CMFUNC_H */
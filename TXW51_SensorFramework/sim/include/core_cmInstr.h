@@ -0,0 +1,56 @@
+/***************************************************************************//**
+ * @brief   Host replacement of the CMSIS core instruction header.
+ *
+ * The CMSIS core_cm0.h is used as is by the simulation, only the intrinsics
+ * with inline assembler are replaced. This directory is searched before
+ * Libraries/CMSIS, so this header shadows the original one.
+ *
+ * @file    core_cmInstr.h
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+#ifndef __CORE_CMINSTR_H
+#define __CORE_CMINSTR_H
+
+/*----- Header-Files ---------------------------------------------------------*/
+#include <stdint.h>
+
+/*----- Macros ---------------------------------------------------------------*/
+
+/*----- Data types -----------------------------------------------------------*/
+
+/*----- Function prototypes --------------------------------------------------*/
+
+/***************************************************************************//**
+ * @brief Completes a system reset, if one has been requested in SCB->AIRCR.
+ *
+ * NVIC_SystemReset() writes SYSRESETREQ and executes a DSB afterwards, so
+ * __DSB() is the place where the request gets noticed.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+extern void SIM_CheckSystemReset(void);
+
+/*----- Data -----------------------------------------------------------------*/
+
+/*----- Implementation -------------------------------------------------------*/
+
+static inline void __NOP(void) { }
+static inline void __WFI(void) { }
+static inline void __WFE(void) { }
+static inline void __SEV(void) { }
+static inline void __ISB(void) { }
+static inline void __DMB(void) { }
+static inline void __DSB(void) { SIM_CheckSystemReset(); }
+
+static inline uint32_t __REV(uint32_t value)      { return __builtin_bswap32(value); }
+static inline uint32_t __REV16(uint32_t value)    { return ((value & 0xFF00FF00UL) >> 8) | ((value & 0x00FF00FFUL) << 8); }
+static inline int32_t  __REVSH(int32_t value)     { return (int16_t)__builtin_bswap16((uint16_t)value); }
+static inline uint32_t __ROR(uint32_t op1, uint32_t op2) { op2 &= 31; return (op2 == 0) ? op1 : ((op1 >> op2) | (op1 << (32 - op2))); }
+
+#endif /* __CORE_CMINSTR_H */
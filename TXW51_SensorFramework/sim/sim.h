@@ -0,0 +1,165 @@
+/***************************************************************************//**
+ * @brief   Common definitions of the host simulation.
+ *
+ * The simulation runs the application code unmodified on the host. The time
+ * is virtual and only advances in sd_app_evt_wait() (to the next event of a
+ * model) and with the modelled duration of the SPI transfers.
+ *
+ * @file    sim.h
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+#ifndef TXW51_SIM_SIM_H_
+#define TXW51_SIM_SIM_H_
+
+/*----- Header-Files ---------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/*----- Macros ---------------------------------------------------------------*/
+#define SIM_NS_PER_US       ( 1000ULL )         /**< Nanoseconds per microsecond. */
+#define SIM_NS_PER_MS       ( 1000000ULL )      /**< Nanoseconds per millisecond. */
+#define SIM_NS_PER_S        ( 1000000000ULL )   /**< Nanoseconds per second. */
+#define SIM_TIME_NEVER      ( UINT64_MAX )      /**< Time of an event that is not scheduled. */
+
+#define SIM_MAX_MOTIONS     ( 8 )               /**< Maximum number of motion bursts. */
+
+/*----- Data types -----------------------------------------------------------*/
+/**
+ * @brief A period of strong motion of the simulated device.
+ */
+struct SIM_Motion {
+    uint64_t Start;         /**< Start of the motion in ns. */
+    uint64_t Duration;      /**< Duration of the motion in ns. */
+};
+
+/**
+ * @brief Configuration of a simulation run, set from the command line.
+ */
+struct SIM_Config {
+    uint64_t Duration;          /**< Simulated time in ns. */
+    uint8_t  AccOdr;            /**< ODR of the accelerometer written by the gateway (enum TXW51_LSM330_ACC_Odr). */
+    bool     GyroEnable;        /**< The gateway enables the gyroscope. */
+    uint8_t  GyroOdr;           /**< ODR of the gyroscope written by the gateway (enum TXW51_LSM330_GYRO_Odr). */
+    uint64_t ConnInterval;      /**< Connection interval in ns. */
+    uint32_t PacketsPerEvent;   /**< Maximum number of packets of the slave per connection event. */
+    uint8_t  TxBuffers;         /**< Number of application TX buffers of the SoftDevice. */
+    bool     LowLatency;        /**< The gateway selects the low-latency stream mode. */
+    bool     ControlPoint;      /**< The gateway configures and starts the measurement with one command to the control point. */
+    uint8_t  AckInterval;       /**< Ack interval of the reliable mode selected with the control point, 0 for off. */
+    uint32_t LossInterval;      /**< The gateway loses every n-th data packet, 0 for none. */
+    uint64_t SyncInterval;      /**< Time between two clock exchanges of the gateway in ns, 0 for none. */
+    double   ClockDrift;        /**< Drift of RTC1 against the gateway clock in ppm, positive if it runs fast. */
+    uint32_t SpiMaxFrequency;   /**< Fastest SPI clock in Hz at which the LSM330 returns correct data. */
+    uint64_t ConnectAt;         /**< Time of the connection after the advertising started in ns, SIM_TIME_NEVER for none. */
+    struct SIM_Motion Motion[SIM_MAX_MOTIONS];  /**< Motion bursts. */
+    uint32_t NumberOfMotions;   /**< Number of entries in Motion. */
+    bool     Verbose;           /**< Print the log of the firmware to stderr. */
+    FILE    *Bgapi;             /**< Output of the BGAPI events for a gateway, NULL for none. */
+};
+
+/**
+ * @brief Counters of a simulation run.
+ */
+struct SIM_Stats {
+    uint64_t SamplesAcc;        /**< Samples generated by the accelerometer. */
+    uint64_t SamplesGyro;       /**< Samples generated by the gyroscope. */
+    uint64_t OverrunsAcc;       /**< Samples lost in the FIFO of the accelerometer. */
+    uint64_t OverrunsGyro;      /**< Samples lost in the FIFO of the gyroscope. */
+    uint64_t Interrupts;        /**< GPIOTE interrupts of the sensor. */
+    uint64_t Tmp006Samples;     /**< Samples signaled by the TMP006. */
+    uint64_t SpiTransfers;      /**< SPI transfers. */
+    uint64_t SpiBytes;          /**< Bytes on the SPI bus. */
+    uint64_t SpiTime;           /**< Time spent on the SPI bus in ns. */
+    uint32_t SpiFrequency;      /**< SPI clock configured by the firmware in Hz. */
+    uint64_t FifoPutSamples[2]; /**< Samples put into the application FIFOs (ACC, GYRO). */
+    uint64_t FifoDropped[2];    /**< Samples dropped by APPL_FIFO_Put() and APPL_FIFO_Drop() because the application FIFOs were full. */
+    uint64_t FifoSum[2];        /**< Sum of the used slots at every connection event. */
+    uint64_t SchedOverflows;    /**< Events rejected by the full scheduler queue. */
+    uint32_t SchedMax;          /**< Maximum number of queued scheduler events. */
+    uint64_t Notifications;     /**< Notifications transmitted over the air. */
+    uint64_t NotifiedSamples;   /**< Samples in the transmitted notifications. */
+    uint64_t NotifiedSamplesAcc;    /**< Accelerometer samples in the notifications. */
+    uint64_t NotifiedSamplesGyro;   /**< Gyroscope samples in the notifications. */
+    uint64_t SequenceGaps;      /**< Packets missing in the sequence numbers. */
+    uint64_t Discontinuities[2];    /**< Discontinuity markers in the notifications (ACC, GYRO). */
+    uint64_t NotifiedSamplesDrivers;    /**< Samples of the registered sensor drivers in the notifications. */
+    uint64_t ControlStatuses;   /**< Status notifications of the control point. */
+    uint8_t  ControlStatus;     /**< Status code of the last status notification (enum APPL_CONTROL_Status). */
+    uint64_t LostPackets;       /**< Data packets lost by the gateway. */
+    uint64_t DiscardedPackets;  /**< Data packets discarded by the gateway in the reliable mode as duplicates. */
+    uint64_t RequestedPackets;  /**< Missing data packets listed in the acknowledgements of the reliable mode. */
+    uint64_t Acks;              /**< Acknowledgements written by the gateway. */
+    uint64_t SyncExchanges;     /**< Clock exchanges answered by the device. */
+    uint64_t SyncAccepted;      /**< Results of clock exchanges accepted by the device. */
+    uint64_t SyncRejected;      /**< Results of clock exchanges rejected by the device. */
+    uint64_t ClockChecks;       /**< Connection events at which the mapping of the device time has been checked. */
+    double   ClockErrorSum;     /**< Sum of the absolute errors of the mapped device time in ms. */
+    double   ClockErrorMax;     /**< Largest absolute error of the mapped device time in ms. */
+    uint64_t HvxNoBuffers;      /**< sd_ble_gatts_hvx() calls rejected without TX buffer. */
+    uint64_t HvxOtherErrors;    /**< sd_ble_gatts_hvx() calls rejected for other reasons. */
+    uint64_t ConnectionEvents;  /**< Connection events. */
+    uint64_t FullEvents;        /**< Connection events that used all packets. */
+    uint64_t EmptyEvents;       /**< Connection events without a notification. */
+    uint64_t Wakeups;           /**< Returns from sd_app_evt_wait(). */
+    uint64_t FlashWrites;       /**< Flash write operations. */
+    uint64_t FlashErases;       /**< Flash page erase operations. */
+    uint64_t AdvDataUpdates;    /**< Updates of the advertising data. */
+    uint32_t AttrTableUsed;     /**< Bytes of the attribute table used by the services. */
+    uint32_t AttrTableSize;     /**< Size of the attribute table of the stack. */
+    uint32_t Attributes;        /**< Attributes registered by the services. */
+    uint32_t SnapshotReads;     /**< Reads of the gateway to get the snapshot, see app/device_info.h. */
+    uint32_t SnapshotLength;    /**< Length of the snapshot read by the gateway. */
+    bool     IsSnapshotValid;   /**< The snapshot has the known version and its strings fill it exactly. */
+    uint64_t LatencySum[2];     /**< Sum of the time from the sample to its notification in ns (ACC, GYRO). */
+    uint64_t LatencyMax[2];     /**< Longest time from a sample to its notification in ns. */
+    uint64_t LatencySamples[2]; /**< Samples in LatencySum. */
+    uint64_t StreamStart;       /**< Time of the first notification in ns. */
+    uint64_t StreamEnd;         /**< Time of the last notification in ns. */
+};
+
+/*----- Function prototypes --------------------------------------------------*/
+
+/* sim_main.c */
+extern void SIM_Wakeup(void);
+extern void SIM_Spin(void);
+extern void SIM_Consume(uint64_t duration);
+extern void SIM_Exit(const char *reason, int status);
+extern void SIM_SampleFifos(void);
+
+/* sim_softdevice.c */
+extern void     SIM_SD_Init(void);
+extern uint64_t SIM_SD_NextEvent(void);
+extern void     SIM_SD_Process(uint64_t now);
+
+/* sim_lsm330.c */
+extern void     SIM_LSM330_Init(void);
+extern uint64_t SIM_LSM330_NextEvent(void);
+extern void     SIM_LSM330_Process(uint64_t now);
+extern void     SIM_LSM330_Deliver(uint32_t sensor, uint32_t count);
+extern void     SIM_LSM330_Discard(uint32_t sensor, uint32_t count);
+
+/* sim_stubs.c */
+extern uint64_t SIM_TMP006_NextEvent(void);
+extern void     SIM_TMP006_Process(uint64_t now);
+
+/* sim_scheduler.c */
+extern uint32_t SIM_SCHED_Count(void);
+
+/* sim_timer.c */
+extern uint64_t SIM_TIMER_NextEvent(void);
+extern double   SIM_TIMER_TickCenter(void);
+extern void     SIM_TIMER_Process(uint64_t now);
+
+/*----- Data -----------------------------------------------------------------*/
+extern uint64_t gSimNow;                /**< Current simulated time in ns. */
+extern struct SIM_Config gSimConfig;    /**< Configuration of the run. */
+extern struct SIM_Stats gSimStats;      /**< Counters of the run. */
+
+#endif /* TXW51_SIM_SIM_H_ */
@@ -0,0 +1,858 @@
+/***************************************************************************//**
+ * @brief   Model of the LSM330 with the SPI master and the GPIOs.
+ *
+ * The accelerometer and the gyroscope are modelled at the register level as
+ * far as the driver uses them: ODR, full-scale, the FIFO with its modes,
+ * watermark and overrun, the interrupt pins and the motion state machine of
+ * the accelerometer (only as "motion or no motion", see SIM_Config). The
+ * samples are generated lazily up to the current time whenever the sensor is
+ * accessed or an interrupt pin has to be evaluated.
+ *
+ * The time of every sample read from a FIFO is kept until the gateway
+ * receives it, to measure the latency of the data stream. The samples are
+ * assumed to be delivered in order, so the latency is only meaningful if no
+ * sample is lost on the way.
+ *
+ * The SDK SPI master is replaced, so spi.c runs unmodified. A transfer costs
+ * the time it takes on the bus with the clock configured by the firmware.
+ * Above the SPI clock the bus carries (SIM_Config), every byte read from the
+ * sensor gets its lowest bit flipped.
+ *
+ * The GPIO module is replaced as well, because the SET/CLR registers of the
+ * nRF51 can not be modelled with plain memory. The GPIOTE events and the
+ * PORT event are raised in the mapped NRF_GPIOTE registers and the real
+ * GPIOTE_IRQHandler() is called for them. Interrupts are delivered when the
+ * sensor is accessed or while the application sleeps, but never while the
+ * PRIMASK is set.
+ *
+ * @file    sim_lsm330.c
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+/*----- Header-Files ---------------------------------------------------------*/
+#include "sim.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "nrf/nrf.h"
+#include "nrf/s110/nrf_error.h"
+#include "nrf/spi_master.h"
+
+#include "txw51_framework/hw/gpio.h"
+#include "txw51_framework/hw/lsm330.h"
+#include "txw51_framework/hw/lsm330_registers.h"
+
+/*----- Macros ---------------------------------------------------------------*/
+#define LSM_FIFO_SIZE       ( 32 )      /**< Samples in the FIFO of each sensor. */
+#define LSM_REGISTERS       ( 0x40 )    /**< Size of the register map of each sensor. */
+#define LSM_SPI_OVERHEAD    ( 4000 )    /**< Time of the driver around a transfer in ns. */
+#define LSM_GPIO_PINS       ( 32 )      /**< Number of GPIO pins. */
+#define LSM_PENDING_SIZE    ( 1024 )    /**< Samples that can be on the way from the FIFO to the gateway. */
+
+#define LSM_FIFO_CTRL       ( 0x2E )    /**< FIFO_CTRL_REG of both sensors. */
+#define LSM_FIFO_SRC        ( 0x2F )    /**< FIFO_SRC_REG of both sensors. */
+#define LSM_OUT_X_L         ( 0x28 )    /**< First output register of both sensors. */
+#define LSM_OUT_Z_H         ( 0x2D )    /**< Last output register of both sensors. */
+
+/*----- Data types -----------------------------------------------------------*/
+/**
+ * @brief FIFO modes, the same values for both sensors.
+ */
+enum LSM_FifoMode {
+    LSM_FIFO_BYPASS           = 0,
+    LSM_FIFO_FIFO             = 1,
+    LSM_FIFO_STREAM           = 2,
+    LSM_FIFO_STREAM_TO_FIFO   = 3,
+    LSM_FIFO_BYPASS_TO_STREAM = 4
+};
+
+/**
+ * @brief State of one of the two sensors.
+ */
+struct LSM_Chip {
+    uint8_t  Reg[LSM_REGISTERS];        /**< Register map. */
+    int16_t  Fifo[LSM_FIFO_SIZE][3];    /**< FIFO content. */
+    uint64_t Times[LSM_FIFO_SIZE];      /**< Time of the samples in the FIFO. */
+    uint64_t Pending[LSM_PENDING_SIZE]; /**< Time of the samples read from the FIFO but not delivered yet. */
+    uint32_t PendingHead;               /**< Index of the oldest entry in Pending. */
+    uint32_t PendingCount;              /**< Number of entries in Pending. */
+    uint32_t Head;                      /**< Index of the oldest sample. */
+    uint32_t Level;                     /**< Number of samples in the FIFO. */
+    bool     IsOverrun;                 /**< A sample has been lost since the FIFO was full. */
+    bool     IsTriggered;               /**< The trigger of the stream-to-FIFO or bypass-to-stream mode occurred. */
+    bool     IsDataReady;               /**< A new sample is available, cleared by reading it. */
+    int16_t  Latest[3];                 /**< The latest sample, read in bypass mode. */
+    int16_t  Output[3];                 /**< Sample that is currently read from the output registers. */
+    uint64_t NextSample;                /**< Time of the next sample, SIM_TIME_NEVER if powered down. */
+    uint64_t Period;                    /**< Time between two samples. */
+    uint64_t *Samples;                  /**< Counter of the generated samples. */
+    uint64_t *Overruns;                 /**< Counter of the lost samples. */
+};
+
+/*----- Function prototypes --------------------------------------------------*/
+static bool     LSM_IsMotion(uint64_t time);
+static enum LSM_FifoMode LSM_GetMode(struct LSM_Chip *chip);
+static void     LSM_UpdatePeriod(struct LSM_Chip *chip);
+static void     LSM_GenerateSample(struct LSM_Chip *chip, uint64_t time);
+static void     LSM_UpdateChip(struct LSM_Chip *chip, uint64_t now);
+static void     LSM_Update(uint64_t now);
+static void     LSM_UpdateMotion(uint64_t now);
+static bool     LSM_GetInt1Acc(void);
+static bool     LSM_GetInt2Acc(void);
+static bool     LSM_GetInt2Gyro(void);
+static void     LSM_UpdatePins(void);
+static uint8_t  LSM_ReadRegister(struct LSM_Chip *chip, uint8_t addr);
+static void     LSM_WriteRegister(struct LSM_Chip *chip, uint8_t addr, uint8_t value);
+static void     LSM_Reset(struct LSM_Chip *chip);
+static void     LSM_TrackSample(struct LSM_Chip *chip, uint64_t time);
+
+extern void GPIOTE_IRQHandler(void);
+
+/*----- Data -----------------------------------------------------------------*/
+static struct LSM_Chip acc;                 /**< The accelerometer. */
+static struct LSM_Chip gyro;                /**< The gyroscope. */
+static bool isMotionLatched = false;        /**< The state machine detected a motion and holds its interrupt. */
+
+static uint32_t gpioOut = 0;                        /**< Output levels of the GPIO pins. */
+static uint32_t gpioIn = 0;                         /**< Levels driven by the sensor. */
+static bool     gpioSense[LSM_GPIO_PINS];           /**< Pins with the sense mechanism enabled. */
+static bool     isPortInterruptEnabled = false;     /**< The PORT event generates an interrupt. */
+static bool     isInterruptPending = false;         /**< An edge occurred while the PRIMASK was set. */
+
+static uint32_t spiFrequency = 0;                   /**< SPI clock in Hz, 0 if closed. */
+static spi_master_event_handler_t spiHandler = NULL;    /**< Event handler of spi.c. */
+
+/*----- Implementation -------------------------------------------------------*/
+
+void SIM_LSM330_Init(void)
+{
+    acc.Samples  = &gSimStats.SamplesAcc;
+    acc.Overruns = &gSimStats.OverrunsAcc;
+    gyro.Samples  = &gSimStats.SamplesGyro;
+    gyro.Overruns = &gSimStats.OverrunsGyro;
+
+    LSM_Reset(&acc);
+    LSM_Reset(&gyro);
+}
+
+
+uint64_t SIM_LSM330_NextEvent(void)
+{
+    uint64_t next = (acc.NextSample < gyro.NextSample) ? acc.NextSample : gyro.NextSample;
+
+    /* The state machine reacts at the start of a motion. */
+    for (uint32_t i = 0; i < gSimConfig.NumberOfMotions; i++) {
+        uint64_t start = gSimConfig.Motion[i].Start;
+        if ((start > gSimNow) && (start < next)) {
+            next = start;
+        }
+    }
+    return next;
+}
+
+
+void SIM_LSM330_Process(uint64_t now)
+{
+    LSM_Update(now);
+}
+
+
+void SIM_LSM330_Deliver(uint32_t sensor, uint32_t count)
+{
+    struct LSM_Chip *chip = (sensor == 0) ? &acc : &gyro;
+
+    while ((count > 0) && (chip->PendingCount > 0)) {
+        uint64_t latency = gSimNow - chip->Pending[chip->PendingHead];
+
+        gSimStats.LatencySum[sensor] += latency;
+        gSimStats.LatencySamples[sensor]++;
+        if (latency > gSimStats.LatencyMax[sensor]) {
+            gSimStats.LatencyMax[sensor] = latency;
+        }
+        chip->PendingHead = (chip->PendingHead + 1) % LSM_PENDING_SIZE;
+        chip->PendingCount--;
+        count--;
+    }
+}
+
+
+void SIM_LSM330_Discard(uint32_t sensor, uint32_t count)
+{
+    struct LSM_Chip *chip = (sensor == 0) ? &acc : &gyro;
+
+    chip->PendingCount = (count < chip->PendingCount) ? chip->PendingCount - count : 0;
+}
+
+
+/***************************************************************************//**
+ * @brief Remembers the time of a sample that the firmware read from the FIFO.
+ *
+ * The oldest time gets lost if the samples are not delivered.
+ *
+ * @param[in] chip The sensor.
+ * @param[in] time Time of the sample.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void LSM_TrackSample(struct LSM_Chip *chip, uint64_t time)
+{
+    if (chip->PendingCount == LSM_PENDING_SIZE) {
+        chip->PendingHead = (chip->PendingHead + 1) % LSM_PENDING_SIZE;
+        chip->PendingCount--;
+    }
+    chip->Pending[(chip->PendingHead + chip->PendingCount) % LSM_PENDING_SIZE] = time;
+    chip->PendingCount++;
+}
+
+
+/***************************************************************************//**
+ * @brief Checks if the device is moved at a given time.
+ *
+ * @param[in] time The time to check.
+ *
+ * @return true during one of the configured motions.
+ ******************************************************************************/
+static bool LSM_IsMotion(uint64_t time)
+{
+    for (uint32_t i = 0; i < gSimConfig.NumberOfMotions; i++) {
+        if ((time >= gSimConfig.Motion[i].Start) &&
+            (time < gSimConfig.Motion[i].Start + gSimConfig.Motion[i].Duration)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/***************************************************************************//**
+ * @brief Gets the effective FIFO mode of a sensor.
+ *
+ * @param[in] chip The sensor.
+ *
+ * @return The mode in which the FIFO currently works.
+ ******************************************************************************/
+static enum LSM_FifoMode LSM_GetMode(struct LSM_Chip *chip)
+{
+    bool isEnabled = (chip == &acc) ?
+            (acc.Reg[TXW51_LSM330_REG_CTRL_REG7_A] & TXW51_LSM330_REG_CTRL_REG7_A_FIFO_EN) :
+            (gyro.Reg[TXW51_LSM330_REG_CTRL_REG5_G] & TXW51_LSM330_REG_CTRL_REG5_G_FIFO_EN);
+    enum LSM_FifoMode mode = chip->Reg[LSM_FIFO_CTRL] >> 5;
+
+    if (!isEnabled) {
+        return LSM_FIFO_BYPASS;
+    }
+    switch (mode) {
+        case LSM_FIFO_STREAM_TO_FIFO:
+            return chip->IsTriggered ? LSM_FIFO_FIFO : LSM_FIFO_STREAM;
+
+        case LSM_FIFO_BYPASS_TO_STREAM:
+            return chip->IsTriggered ? LSM_FIFO_STREAM : LSM_FIFO_BYPASS;
+
+        default:
+            return mode;
+    }
+}
+
+
+/***************************************************************************//**
+ * @brief Sets the sample period from the ODR and power registers.
+ *
+ * @param[in] chip The sensor.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void LSM_UpdatePeriod(struct LSM_Chip *chip)
+{
+    static const double accOdrs[]  = { 0, 3.125, 6.25, 12.5, 25, 50, 100, 400, 800, 1600 };
+    static const double gyroOdrs[] = { 95, 190, 380, 760 };
+    double odr = 0;
+
+    if (chip == &acc) {
+        uint8_t code = acc.Reg[TXW51_LSM330_REG_CTRL_REG5_A] >> TXW51_LSM330_REG_CTRL_REG5_A_ODR_Pos;
+        if (code < sizeof(accOdrs) / sizeof(accOdrs[0])) {
+            odr = accOdrs[code];
+        }
+    } else if (gyro.Reg[TXW51_LSM330_REG_CTRL_REG1_G] & TXW51_LSM330_REG_CTRL_REG1_G_PD) {
+        odr = gyroOdrs[gyro.Reg[TXW51_LSM330_REG_CTRL_REG1_G] >> TXW51_LSM330_REG_CTRL_REG1_G_DR_Pos];
+    }
+
+    if (odr == 0) {
+        chip->Period = 0;
+        chip->NextSample = SIM_TIME_NEVER;
+    } else if ((uint64_t)(SIM_NS_PER_S / odr) != chip->Period) {
+        chip->Period = (uint64_t)(SIM_NS_PER_S / odr);
+        chip->NextSample = gSimNow + chip->Period;
+    }
+}
+
+
+/***************************************************************************//**
+ * @brief Generates a sample and stores it according to the FIFO mode.
+ *
+ * The values are 1g on Z with a small vibration, the motions add a large
+ * oscillation on all axes.
+ *
+ * @param[in] chip The sensor.
+ * @param[in] time Time of the sample.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void LSM_GenerateSample(struct LSM_Chip *chip, uint64_t time)
+{
+    static const double accRanges[]  = { 2, 4, 6, 8, 16, 16, 16, 16 };
+    static const double gyroRanges[] = { 250, 500, 2000, 2000 };
+    double t = (double)time / SIM_NS_PER_S;
+    double value[3];
+    double range;
+
+    if (chip == &acc) {
+        range = accRanges[(acc.Reg[TXW51_LSM330_REG_CTRL_REG6_A] >> TXW51_LSM330_REG_CTRL_REG6_A_FSCALE_Pos) & 0x07];
+        value[0] = 0.05 * sin(2 * M_PI * 1.3 * t);
+        value[1] = 0.05 * cos(2 * M_PI * 1.3 * t);
+        value[2] = 1.0;
+        if (LSM_IsMotion(time)) {
+            for (int i = 0; i < 3; i++) {
+                value[i] += 2.0 * sin(2 * M_PI * 7.0 * t + i);
+            }
+        }
+    } else {
+        range = gyroRanges[(gyro.Reg[TXW51_LSM330_REG_CTRL_REG4_G] >> TXW51_LSM330_REG_CTRL_REG4_G_FS_Pos) & 0x03];
+        for (int i = 0; i < 3; i++) {
+            value[i] = 5.0 * sin(2 * M_PI * 0.7 * t + i);
+            if (LSM_IsMotion(time)) {
+                value[i] += 300.0 * sin(2 * M_PI * 3.0 * t + i);
+            }
+        }
+    }
+
+    for (int i = 0; i < 3; i++) {
+        double raw = value[i] / range * 32768.0;
+        chip->Latest[i] = (raw > INT16_MAX) ? INT16_MAX : (raw < INT16_MIN) ? INT16_MIN : (int16_t)raw;
+    }
+    chip->IsDataReady = true;
+    (*chip->Samples)++;
+
+    switch (LSM_GetMode(chip)) {
+        case LSM_FIFO_FIFO:
+            if (chip->Level == LSM_FIFO_SIZE) {
+                chip->IsOverrun = true;
+                (*chip->Overruns)++;
+                return;
+            }
+            break;
+
+        case LSM_FIFO_STREAM:
+            if (chip->Level == LSM_FIFO_SIZE) {
+                chip->Head = (chip->Head + 1) % LSM_FIFO_SIZE;
+                chip->Level--;
+                chip->IsOverrun = true;
+                /* Losing the old samples before the trigger is the purpose of
+                 * the stream-to-FIFO mode. */
+                if ((chip->Reg[LSM_FIFO_CTRL] >> 5) != LSM_FIFO_STREAM_TO_FIFO) {
+                    (*chip->Overruns)++;
+                }
+            }
+            break;
+
+        default:
+            return;
+    }
+
+    memcpy(chip->Fifo[(chip->Head + chip->Level) % LSM_FIFO_SIZE], chip->Latest, sizeof(chip->Latest));
+    chip->Times[(chip->Head + chip->Level) % LSM_FIFO_SIZE] = time;
+    chip->Level++;
+}
+
+
+/***************************************************************************//**
+ * @brief Generates all samples of a sensor up to a point in time.
+ *
+ * @param[in] chip The sensor.
+ * @param[in] now  The current time.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void LSM_UpdateChip(struct LSM_Chip *chip, uint64_t now)
+{
+    while (chip->NextSample <= now) {
+        LSM_GenerateSample(chip, chip->NextSample);
+        chip->NextSample += chip->Period;
+    }
+}
+
+
+/***************************************************************************//**
+ * @brief Brings the sensor up to a point in time and raises the interrupts.
+ *
+ * The samples of both sensors are generated in the order of their time, so
+ * that the interrupt pins change in the right order.
+ *
+ * @param[in] now The current time.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void LSM_Update(uint64_t now)
+{
+    uint64_t next;
+
+    for (;;) {
+        next = (acc.NextSample < gyro.NextSample) ? acc.NextSample : gyro.NextSample;
+        if (next > now) {
+            break;
+        }
+        LSM_UpdateMotion(next);
+        LSM_UpdateChip(&acc, next);
+        LSM_UpdateChip(&gyro, next);
+        LSM_UpdatePins();
+    }
+    LSM_UpdateMotion(now);
+    LSM_UpdatePins();
+}
+
+
+/***************************************************************************//**
+ * @brief Lets the state machine of the accelerometer detect a motion.
+ *
+ * @param[in] now The current time.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void LSM_UpdateMotion(uint64_t now)
+{
+    if (!isMotionLatched &&
+        (acc.Reg[TXW51_LSM330_REG_CTRL_REG2_A] & TXW51_LSM330_REG_CTRL_REG2_A_SM1_EN) &&
+        (acc.Period != 0) && LSM_IsMotion(now)) {
+        isMotionLatched = true;
+        /* The interrupt of the state machine is the trigger of the FIFO. */
+        acc.IsTriggered = true;
+    }
+}
+
+
+/***************************************************************************//**
+ * @brief Gets the level of the INT1_A pin.
+ *
+ * @return true if the pin is high.
+ ******************************************************************************/
+static bool LSM_GetInt1Acc(void)
+{
+    uint8_t reg4 = acc.Reg[TXW51_LSM330_REG_CTRL_REG4_A];
+    uint8_t reg7 = acc.Reg[TXW51_LSM330_REG_CTRL_REG7_A];
+    uint8_t watermark = acc.Reg[LSM_FIFO_CTRL] & 0x1F;
+    bool isMotionOnInt1 = !(acc.Reg[TXW51_LSM330_REG_CTRL_REG2_A] & TXW51_LSM330_REG_CTRL_REG2_A_SM1_PIN);
+
+    if ((reg4 & TXW51_LSM330_REG_CTRL_REG4_A_DR_EN) && acc.IsDataReady) {
+        return true;
+    }
+    if (!(reg4 & TXW51_LSM330_REG_CTRL_REG4_A_INT1_EN)) {
+        return false;
+    }
+    return ((reg7 & TXW51_LSM330_REG_CTRL_REG7_A_P1_WTM) && (watermark > 0) && (acc.Level >= watermark)) ||
+           ((reg7 & TXW51_LSM330_REG_CTRL_REG7_A_P1_OVERRUN) && (acc.Level == LSM_FIFO_SIZE)) ||
+           ((reg7 & TXW51_LSM330_REG_CTRL_REG7_A_P1_EMPTY) && (acc.Level == 0)) ||
+           (isMotionOnInt1 && isMotionLatched);
+}
+
+
+/***************************************************************************//**
+ * @brief Gets the level of the INT2_A pin.
+ *
+ * @return true if the pin is high.
+ ******************************************************************************/
+static bool LSM_GetInt2Acc(void)
+{
+    return (acc.Reg[TXW51_LSM330_REG_CTRL_REG4_A] & TXW51_LSM330_REG_CTRL_REG4_A_INT2_EN) &&
+           (acc.Reg[TXW51_LSM330_REG_CTRL_REG2_A] & TXW51_LSM330_REG_CTRL_REG2_A_SM1_PIN) &&
+           isMotionLatched;
+}
+
+
+/***************************************************************************//**
+ * @brief Gets the level of the INT2_G pin.
+ *
+ * @return true if the pin is high.
+ ******************************************************************************/
+static bool LSM_GetInt2Gyro(void)
+{
+    uint8_t reg3 = gyro.Reg[TXW51_LSM330_REG_CTRL_REG3_G];
+    uint8_t watermark = gyro.Reg[LSM_FIFO_CTRL] & 0x1F;
+
+    return ((reg3 & TXW51_LSM330_REG_CTRL_REG3_G_I2_DRDY) && gyro.IsDataReady) ||
+           ((reg3 & TXW51_LSM330_REG_CTRL_REG3_G_I2_WTM) && (watermark > 0) && (gyro.Level >= watermark)) ||
+           ((reg3 & TXW51_LSM330_REG_CTRL_REG3_G_I2_ORUN) && (gyro.Level == LSM_FIFO_SIZE)) ||
+           ((reg3 & TXW51_LSM330_REG_CTRL_REG3_G_I2_EMPTY) && (gyro.Level == 0));
+}
+
+
+/***************************************************************************//**
+ * @brief Sets the pins driven by the sensor and raises the GPIOTE events of
+ *        the edges.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void LSM_UpdatePins(void)
+{
+    uint32_t old = gpioIn;
+    uint32_t rising;
+    bool isEvent = false;
+
+    gpioIn = (LSM_GetInt1Acc()   ? (1UL << TXW51_GPIO_PIN_INT1_A) : 0) |
+             (LSM_GetInt2Acc()   ? (1UL << TXW51_GPIO_PIN_INT2_A) : 0) |
+             (LSM_GetInt2Gyro()  ? (1UL << TXW51_GPIO_PIN_INT2_G) : 0);
+    rising = gpioIn & ~old;
+
+    for (uint32_t ch = 0; ch < 4; ch++) {
+        uint32_t config = NRF_GPIOTE->CONFIG[ch];
+        uint32_t pin = (config & GPIOTE_CONFIG_PSEL_Msk) >> GPIOTE_CONFIG_PSEL_Pos;
+        uint32_t polarity = (config & GPIOTE_CONFIG_POLARITY_Msk) >> GPIOTE_CONFIG_POLARITY_Pos;
+        uint32_t mask = 1UL << pin;
+
+        if (((config & GPIOTE_CONFIG_MODE_Msk) >> GPIOTE_CONFIG_MODE_Pos) != GPIOTE_CONFIG_MODE_Event) {
+            continue;
+        }
+        if (((polarity == GPIOTE_CONFIG_POLARITY_LoToHi) && (rising & mask)) ||
+            ((polarity == GPIOTE_CONFIG_POLARITY_HiToLo) && (old & ~gpioIn & mask)) ||
+            ((polarity == GPIOTE_CONFIG_POLARITY_Toggle) && ((old ^ gpioIn) & mask))) {
+            NRF_GPIOTE->EVENTS_IN[ch] = 1;
+            isEvent = true;
+        }
+    }
+
+    for (uint32_t pin = 0; pin < LSM_GPIO_PINS; pin++) {
+        if (gpioSense[pin] && (rising & (1UL << pin)) && isPortInterruptEnabled) {
+            NRF_GPIOTE->EVENTS_PORT = 1;
+            isEvent = true;
+        }
+    }
+
+    if (isEvent || isInterruptPending) {
+        if (gSimPrimask) {
+            isInterruptPending = true;
+            return;
+        }
+        isInterruptPending = false;
+        gSimStats.Interrupts++;
+        GPIOTE_IRQHandler();
+        SIM_Wakeup();
+    }
+}
+
+
+/***************************************************************************//**
+ * @brief Resets the registers and the FIFO of a sensor.
+ *
+ * @param[in] chip The sensor.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void LSM_Reset(struct LSM_Chip *chip)
+{
+    memset(chip->Reg, 0, sizeof(chip->Reg));
+    if (chip == &acc) {
+        acc.Reg[TXW51_LSM330_REG_WHO_AM_I_A] = TXW51_LSM330_REG_WHO_AM_I_A_DEFAULT;
+        acc.Reg[TXW51_LSM330_REG_CTRL_REG5_A] = 0x07;
+        acc.Reg[TXW51_LSM330_REG_CTRL_REG7_A] = TXW51_LSM330_REG_CTRL_REG7_A_ADD_INC;
+        isMotionLatched = false;
+    } else {
+        gyro.Reg[TXW51_LSM330_REG_WHO_AM_I_G] = TXW51_LSM330_REG_WHO_AM_I_G_DEFAULT;
+        gyro.Reg[TXW51_LSM330_REG_CTRL_REG1_G] = 0x07;
+    }
+    chip->Head = 0;
+    chip->Level = 0;
+    chip->IsOverrun = false;
+    chip->IsTriggered = false;
+    chip->IsDataReady = false;
+    chip->PendingCount = 0;
+    chip->Period = 0;
+    chip->NextSample = SIM_TIME_NEVER;
+    memset(chip->Latest, 0, sizeof(chip->Latest));
+}
+
+
+/***************************************************************************//**
+ * @brief Reads a register of a sensor.
+ *
+ * Reading the output registers in FIFO mode removes a sample from the FIFO
+ * with the first byte.
+ *
+ * @param[in] chip The sensor.
+ * @param[in] addr The address of the register.
+ *
+ * @return The value of the register.
+ ******************************************************************************/
+static uint8_t LSM_ReadRegister(struct LSM_Chip *chip, uint8_t addr)
+{
+    uint8_t value;
+
+    if ((addr >= LSM_OUT_X_L) && (addr <= LSM_OUT_Z_H)) {
+        uint32_t index = addr - LSM_OUT_X_L;
+        if (index == 0) {
+            if ((LSM_GetMode(chip) != LSM_FIFO_BYPASS) && (chip->Level > 0)) {
+                memcpy(chip->Output, chip->Fifo[chip->Head], sizeof(chip->Output));
+                LSM_TrackSample(chip, chip->Times[chip->Head]);
+                chip->Head = (chip->Head + 1) % LSM_FIFO_SIZE;
+                chip->Level--;
+                chip->IsOverrun = false;
+            } else {
+                memcpy(chip->Output, chip->Latest, sizeof(chip->Output));
+            }
+            chip->IsDataReady = false;
+        }
+        value = (uint16_t)chip->Output[index / 2] >> ((index % 2) * 8);
+        return value;
+    }
+
+    if (addr == LSM_FIFO_SRC) {
+        uint8_t watermark = chip->Reg[LSM_FIFO_CTRL] & 0x1F;
+        value = (chip->Level & 0x1F) |
+                ((chip->Level == 0) ? (1U << 5) : 0) |
+                ((chip->Level == LSM_FIFO_SIZE) ? (1U << 6) : 0) |
+                ((chip->Level >= watermark) ? (1U << 7) : 0);
+        return value;
+    }
+
+    if ((chip == &gyro) && (addr == TXW51_LSM330_REG_OUT_TEMP_G)) {
+        return 15;
+    }
+
+    return (addr < LSM_REGISTERS) ? chip->Reg[addr] : 0;
+}
+
+
+/***************************************************************************//**
+ * @brief Writes a register of a sensor.
+ *
+ * @param[in] chip  The sensor.
+ * @param[in] addr  The address of the register.
+ * @param[in] value The new value.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void LSM_WriteRegister(struct LSM_Chip *chip, uint8_t addr, uint8_t value)
+{
+    if (addr >= LSM_REGISTERS) {
+        return;
+    }
+
+    if ((chip == &acc) && (addr == TXW51_LSM330_REG_CTRL_REG4_A) &&
+        (value & TXW51_LSM330_REG_CTRL_REG4_A_STRT)) {
+        /* Soft reset, the bit clears itself. */
+        LSM_Reset(&acc);
+        return;
+    }
+
+    chip->Reg[addr] = value;
+
+    if (addr == LSM_FIFO_CTRL) {
+        chip->IsTriggered = false;
+        if ((value >> 5) == LSM_FIFO_BYPASS) {
+            chip->Head = 0;
+            chip->Level = 0;
+            chip->IsOverrun = false;
+        }
+    }
+
+    if ((chip == &acc) && (addr == TXW51_LSM330_REG_CTRL_REG2_A) &&
+        !(value & TXW51_LSM330_REG_CTRL_REG2_A_SM1_EN)) {
+        isMotionLatched = false;
+    }
+
+    LSM_UpdatePeriod(chip);
+}
+
+
+uint32_t spi_master_open(const spi_master_hw_instance_t spi_master_hw_instance,
+                         spi_master_config_t const * const p_spi_master_config)
+{
+    /* SPI_FREQUENCY_FREQUENCY_K125 is 0x02000000, every higher setting doubles it. */
+    spiFrequency = (p_spi_master_config->SPI_Freq / 0x02000000UL) * 125000UL;
+    gSimStats.SpiFrequency = spiFrequency;
+    return (spiFrequency > 0) ? NRF_SUCCESS : NRF_ERROR_INVALID_PARAM;
+}
+
+
+void spi_master_close(const spi_master_hw_instance_t spi_master_hw_instance)
+{
+    spiFrequency = 0;
+}
+
+
+void spi_master_evt_handler_reg(const spi_master_hw_instance_t spi_master_hw_instance,
+                                spi_master_event_handler_t event_handler)
+{
+    spiHandler = event_handler;
+}
+
+
+spi_master_state_t spi_master_get_state(const spi_master_hw_instance_t spi_master_hw_instance)
+{
+    return (spiFrequency > 0) ? SPI_MASTER_STATE_IDLE : SPI_MASTER_STATE_DISABLED;
+}
+
+
+uint32_t spi_master_send_recv(const spi_master_hw_instance_t spi_master_hw_instance,
+                              uint8_t * const p_tx_buf, const uint16_t tx_buf_len,
+                              uint8_t * const p_rx_buf, const uint16_t rx_buf_len)
+{
+    struct LSM_Chip *chip = NULL;
+    uint16_t length = (tx_buf_len > rx_buf_len) ? tx_buf_len : rx_buf_len;
+    uint64_t duration;
+    uint8_t addr;
+    bool isRead;
+    bool isIncrement;
+
+    if (spiFrequency == 0) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    if ((tx_buf_len == 0) || (p_tx_buf == NULL)) {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    if (!(gpioOut & (1UL << TXW51_GPIO_PIN_SPI0_SS_A))) {
+        chip = &acc;
+    } else if (!(gpioOut & (1UL << TXW51_GPIO_PIN_SPI0_SS_G))) {
+        chip = &gyro;
+    }
+
+    /* The samples must be up to date when the transfer starts. */
+    LSM_Update(gSimNow);
+
+    addr = p_tx_buf[0] & 0x3F;
+    isRead = (p_tx_buf[0] & TXW51_LSM330_FLAG_READ) != 0;
+    /* The accelerometer increments with ADD_INC, the gyroscope with the MS bit. */
+    isIncrement = (chip == &acc) ?
+            ((acc.Reg[TXW51_LSM330_REG_CTRL_REG7_A] & TXW51_LSM330_REG_CTRL_REG7_A_ADD_INC) != 0) :
+            ((p_tx_buf[0] & TXW51_LSM330_FLAG_MULTI_RW) != 0);
+
+    for (uint16_t i = 1; i < length; i++) {
+        uint8_t value = 0xFF;
+        if (chip != NULL) {
+            if (isRead) {
+                value = LSM_ReadRegister(chip, addr);
+            } else if (i < tx_buf_len) {
+                LSM_WriteRegister(chip, addr, p_tx_buf[i]);
+            }
+        }
+        if (isRead && (spiFrequency > gSimConfig.SpiMaxFrequency)) {
+            value ^= 0x01;
+        }
+        if ((p_rx_buf != NULL) && (i < rx_buf_len)) {
+            p_rx_buf[i] = value;
+        }
+        if (isIncrement) {
+            addr++;
+            /* The output registers wrap around while the FIFO is read. */
+            if ((addr == LSM_OUT_Z_H + 1) && (chip != NULL) &&
+                (LSM_GetMode(chip) != LSM_FIFO_BYPASS)) {
+                addr = LSM_OUT_X_L;
+            }
+        }
+    }
+    if ((p_rx_buf != NULL) && (rx_buf_len > 0)) {
+        p_rx_buf[0] = 0xFF;
+    }
+
+    duration = (uint64_t)length * 8 * SIM_NS_PER_S / spiFrequency + LSM_SPI_OVERHEAD;
+    gSimStats.SpiTransfers++;
+    gSimStats.SpiBytes += length;
+    gSimStats.SpiTime += duration;
+    SIM_Consume(duration);
+
+    if (spiHandler != NULL) {
+        spi_master_evt_t event = {
+            .evt_type   = SPI_MASTER_EVT_TRANSFER_COMPLETED,
+            .data_count = length
+        };
+        spiHandler(event);
+    }
+
+    /* Reading the FIFO lowers the watermark interrupt. */
+    LSM_Update(gSimNow);
+    return NRF_SUCCESS;
+}
+
+
+void TXW51_GPIO_InitLed(void)
+{
+    TXW51_GPIO_ClearGpio(TXW51_GPIO_PIN_LED0);
+    TXW51_GPIO_ClearGpio(TXW51_GPIO_PIN_LED1);
+    TXW51_GPIO_ClearGpio(TXW51_GPIO_PIN_LED2);
+}
+
+
+void TXW51_GPIO_DeinitLed(void)
+{
+}
+
+
+void TXW51_GPIO_SetGpio(enum TXW51_GPIO_Pin pinNumber)
+{
+    gpioOut |= (1UL << pinNumber);
+}
+
+
+void TXW51_GPIO_ClearGpio(enum TXW51_GPIO_Pin pinNumber)
+{
+    gpioOut &= ~(1UL << pinNumber);
+}
+
+
+void TXW51_GPIO_ToggleGpio(enum TXW51_GPIO_Pin pinNumber)
+{
+    gpioOut ^= (1UL << pinNumber);
+}
+
+
+void TXW51_GPIO_ConfigGpioAsOutput(enum TXW51_GPIO_Pin pinNumber)
+{
+}
+
+
+void TXW51_GPIO_ConfigGpioAsInput(enum TXW51_GPIO_Pin pinNumber,
+                                  nrf_gpio_pin_pull_t pullConfig)
+{
+    gpioSense[pinNumber] = false;
+}
+
+
+void TXW51_GPIO_ConfigGpioAsDisconnected(enum TXW51_GPIO_Pin pinNumber)
+{
+    gpioSense[pinNumber] = false;
+}
+
+
+void TXW51_GPIOTE_SetInterrupt(uint32_t channel,
+                               enum TXW51_GPIO_Pin pinNumber,
+                               nrf_gpiote_polarity_t polarity)
+{
+    NRF_GPIOTE->CONFIG[channel] = (GPIOTE_CONFIG_MODE_Event << GPIOTE_CONFIG_MODE_Pos) |
+                                  ((uint32_t)pinNumber << GPIOTE_CONFIG_PSEL_Pos) |
+                                  ((uint32_t)polarity << GPIOTE_CONFIG_POLARITY_Pos);
+}
+
+
+void TXW51_GPIO_SetSenseInterrupt(enum TXW51_GPIO_Pin pinNumber,
+                                  nrf_gpio_pin_pull_t pullConfig)
+{
+    gpioSense[pinNumber] = true;
+}
+
+
+void TXW51_GPIOTE_SetPortInterrupt(void)
+{
+    NRF_GPIOTE->EVENTS_PORT = 0;
+    isPortInterruptEnabled = true;
+}
+
+
+void TXW51_GPIOTE_ClearPortInterrupt(void)
+{
+    isPortInterruptEnabled = false;
+    NRF_GPIOTE->EVENTS_PORT = 0;
+}
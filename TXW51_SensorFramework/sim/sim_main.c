@@ -0,0 +1,645 @@
+/***************************************************************************//**
+ * @brief   Starting point and report of the host simulation.
+ *
+ * Runs the firmware application on the host with a modelled LSM330, SPI bus,
+ * SoftDevice and a gateway that connects, configures the sensor and starts
+ * the measurement like the BLED112 agent. At the end, the throughput, the
+ * occupancy of the FIFOs, the high-water marks of the stack and the scheduler
+ * and the dropped samples are reported. With the clock
+ * exchange, the run fails if the device time mapped to the gateway clock is
+ * off by more than MAIN_CLOCK_MAX_ERROR or has never been checked.
+ *
+ * Usage: txw51_sim [options]
+ *   -t <s>       Simulated time (default 10).
+ *   -a <Hz>      ODR of the accelerometer: 3.125 ... 1600 (default 100).
+ *   -g <Hz>      Enable the gyroscope with the ODR: 95, 190, 380, 760.
+ *   -i <ms>      Connection interval, multiple of 1.25 (default 7.5).
+ *   -p <n>       Packets per connection event (default 4).
+ *   -b <n>       TX buffers of the SoftDevice (default 7).
+ *   -s <MHz>     Fastest SPI clock with correct data (default 10).
+ *   -l           Stream in the low-latency mode (data-ready interrupts).
+ *   -k           Configure and start with one command to the control point.
+ *   -y <s>       Synchronize the device time every s seconds, with -k.
+ *   -d <ppm>     Drift of the device clock, positive if it runs fast.
+ *   -c <s>       Connect after the advertising started, -1 for never (default 1).
+ *   -m <s>[:<s>] Motion at a time, with an optional duration (default 1).
+ *   -o <file>    Write the BGAPI events of the gateway to a file, "-" for stdout.
+ *   -v           Print the log of the firmware to stderr.
+ *
+ * @file    sim_main.c
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+/*----- Header-Files ---------------------------------------------------------*/
+#include "sim.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "nrf/nrf.h"
+#include "nrf/s110/nrf_soc.h"
+
+#include "app/appl.h"
+#include "app/clock.h"
+#include "app/control.h"
+#include "app/fifo.h"
+#include "txw51_framework/hw/lsm330.h"
+#include "txw51_framework/utils/stack.h"
+#include "txw51_framework/utils/txw51_errors.h"
+
+/*----- Macros ---------------------------------------------------------------*/
+#define MAIN_FLASH_PAGE_SIZE    ( 1024 )    /**< Flash page size of the nRF51822. */
+#define MAIN_FLASH_PAGES        ( 256 )     /**< Flash pages of the nRF51822 QFAA. */
+#define MAIN_HOST_PAGE_SIZE     ( 0x1000 )  /**< Smallest address that can be mapped on the host. */
+#define MAIN_SPIN_LIMIT         ( 100 )     /**< Idle polls after which the time advances to the next event. */
+#define MAIN_MAX_DRIFT          ( 1000 )    /**< Largest drift of the device clock in ppm. */
+#define MAIN_CLOCK_MAX_ERROR    ( 5.4 )     /**< Largest error of the mapped device time in ms that passes, half a tick of RTC1 and 1.5 ms of the gateway, see clock.h. */
+
+/*----- Data types -----------------------------------------------------------*/
+
+/*----- Function prototypes --------------------------------------------------*/
+static void MAIN_Usage(const char *name);
+static void MAIN_ParseArguments(int argc, char *argv[]);
+static void MAIN_MapRegion(uintptr_t address, size_t size, uint8_t fill);
+static void MAIN_InitMemory(void);
+static void MAIN_ProcessUntil(uint64_t now);
+static uint64_t MAIN_NextEvent(void);
+static void MAIN_PrintReport(const char *reason);
+
+extern void     __real_APPL_FIFO_Commit(enum appl_fifo_type bufferType, uint32_t numberOfSamples);
+extern uint32_t __real_APPL_FIFO_Put(enum appl_fifo_type bufferType, const uint8_t *buffer, uint32_t numberOfSamples);
+extern uint32_t __real_APPL_FIFO_Drop(enum appl_fifo_type bufferType, uint32_t numberOfSamples);
+
+/*----- Data -----------------------------------------------------------------*/
+uint64_t gSimNow = 0;
+uint32_t gSimPrimask = 0;
+struct SIM_Stats gSimStats;
+
+struct SIM_Config gSimConfig = {
+    .Duration        = 10 * SIM_NS_PER_S,
+    .AccOdr          = TXW51_LSM330_ACC_ODR_100,
+    .GyroEnable      = false,
+    .GyroOdr         = TXW51_LSM330_GYRO_ODR_95,
+    .ConnInterval    = 7500 * SIM_NS_PER_US,
+    .PacketsPerEvent = 4,
+    .TxBuffers       = 7,
+    .SpiMaxFrequency = 10000000,
+    .LowLatency      = false,
+    .ConnectAt       = 1 * SIM_NS_PER_S,
+    .NumberOfMotions = 0,
+    .Verbose         = false,
+    .Bgapi           = NULL
+};
+
+static uint32_t idleSpins = 0;                  /**< Calls of SIM_Spin() since the last sd_app_evt_wait(). */
+static bool isWakeupPending = false;            /**< An interrupt occurred since the last sd_app_evt_wait(). */
+
+static const double accOdrs[]  = { 0, 3.125, 6.25, 12.5, 25, 50, 100, 400, 800, 1600 };  /**< ODRs of enum TXW51_LSM330_ACC_Odr in Hz. */
+static const double gyroOdrs[] = { 95, 190, 380, 760 };  /**< ODRs of enum TXW51_LSM330_GYRO_Odr in Hz. */
+
+/*----- Implementation -------------------------------------------------------*/
+
+int main(int argc, char *argv[])
+{
+    MAIN_ParseArguments(argc, argv);
+    MAIN_InitMemory();
+
+    SIM_LSM330_Init();
+    SIM_SD_Init();
+
+    /* Does not return, the simulation ends in sd_app_evt_wait(). */
+    APPL_Start();
+    return 0;
+}
+
+
+/***************************************************************************//**
+ * @brief Prints the command line options.
+ *
+ * @param[in] name Name of the program.
+ *
+ * @return Does not return.
+ ******************************************************************************/
+static void MAIN_Usage(const char *name)
+{
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  -t <s>       Simulated time (default 10).\n"
+            "  -a <Hz>      ODR of the accelerometer: 3.125 ... 1600 (default 100).\n"
+            "  -g <Hz>      Enable the gyroscope with the ODR: 95, 190, 380, 760.\n"
+            "  -i <ms>      Connection interval, multiple of 1.25 (default 7.5).\n"
+            "  -p <n>       Packets per connection event (default 4).\n"
+            "  -b <n>       TX buffers of the SoftDevice (default 7).\n"
+            "  -s <MHz>     Fastest SPI clock with correct data (default 10).\n"
+            "  -l           Stream in the low-latency mode (data-ready interrupts).\n"
+            "  -k           Configure and start with one command to the control point.\n"
+            "  -r <n>       Acknowledge every n packets in the reliable mode, with -k.\n"
+            "  -x <n>       The gateway loses every n-th data packet.\n"
+            "  -y <s>       Synchronize the device time every s seconds, with -k.\n"
+            "  -d <ppm>     Drift of the device clock, positive if it runs fast.\n"
+            "  -c <s>       Connect after the advertising started, -1 for never (default 1).\n"
+            "  -m <s>[:<s>] Motion at a time, with an optional duration (default 1).\n"
+            "  -o <file>    Write the BGAPI events of the gateway to a file, \"-\" for stdout.\n"
+            "  -v           Print the log of the firmware to stderr.\n",
+            name);
+    exit(2);
+}
+
+
+/***************************************************************************//**
+ * @brief Sets the configuration from the command line.
+ *
+ * @param[in] argc Number of arguments.
+ * @param[in] argv The arguments.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void MAIN_ParseArguments(int argc, char *argv[])
+{
+    int option;
+    double value;
+    char *end;
+    bool isValid;
+
+    while ((option = getopt(argc, argv, "t:a:g:i:p:b:s:lkr:x:y:d:c:m:o:v")) != -1) {
+        isValid = true;
+        value = (optarg != NULL) ? strtod(optarg, &end) : 0;
+
+        switch (option) {
+            case 't':
+                isValid = (value > 0);
+                gSimConfig.Duration = (uint64_t)(value * SIM_NS_PER_S);
+                break;
+
+            case 'a':
+                isValid = false;
+                for (uint32_t i = 1; i < sizeof(accOdrs) / sizeof(accOdrs[0]); i++) {
+                    if (fabs(accOdrs[i] - value) < 0.001) {
+                        gSimConfig.AccOdr = i;
+                        isValid = true;
+                    }
+                }
+                break;
+
+            case 'g':
+                isValid = false;
+                for (uint32_t i = 0; i < sizeof(gyroOdrs) / sizeof(gyroOdrs[0]); i++) {
+                    if (fabs(gyroOdrs[i] - value) < 0.001) {
+                        gSimConfig.GyroOdr = i;
+                        gSimConfig.GyroEnable = true;
+                        isValid = true;
+                    }
+                }
+                break;
+
+            case 'i':
+                /* 7.5ms to 4s in steps of 1.25ms. */
+                isValid = (value >= 7.5) && (value <= 4000) &&
+                          (fabs(value / 1.25 - round(value / 1.25)) < 0.001);
+                gSimConfig.ConnInterval = (uint64_t)(value * SIM_NS_PER_MS);
+                break;
+
+            case 'p':
+                isValid = (value >= 1) && (value <= 6);
+                gSimConfig.PacketsPerEvent = (uint32_t)value;
+                break;
+
+            case 'b':
+                isValid = (value >= 1) && (value <= 7);
+                gSimConfig.TxBuffers = (uint8_t)value;
+                break;
+
+            case 's':
+                isValid = (value > 0);
+                gSimConfig.SpiMaxFrequency = (uint32_t)(value * 1000000);
+                break;
+
+            case 'l':
+                gSimConfig.LowLatency = true;
+                break;
+
+            case 'k':
+                gSimConfig.ControlPoint = true;
+                break;
+
+            case 'r':
+                isValid = (value >= 1) && (value <= APPL_CONTROL_MAX_ACK_INTERVAL);
+                gSimConfig.AckInterval = (uint8_t)value;
+                break;
+
+            case 'x':
+                isValid = (value >= 2);
+                gSimConfig.LossInterval = (uint32_t)value;
+                break;
+
+            case 'y':
+                isValid = (value > 0);
+                gSimConfig.SyncInterval = (uint64_t)(value * SIM_NS_PER_S);
+                break;
+
+            case 'd':
+                isValid = (fabs(value) <= MAIN_MAX_DRIFT);
+                gSimConfig.ClockDrift = value;
+                break;
+
+            case 'c':
+                gSimConfig.ConnectAt = (value < 0) ? SIM_TIME_NEVER :
+                                       (uint64_t)(value * SIM_NS_PER_S);
+                break;
+
+            case 'm':
+                isValid = (value >= 0) && (gSimConfig.NumberOfMotions < SIM_MAX_MOTIONS);
+                if (isValid) {
+                    struct SIM_Motion *motion = &gSimConfig.Motion[gSimConfig.NumberOfMotions++];
+                    motion->Start = (uint64_t)(value * SIM_NS_PER_S);
+                    motion->Duration = SIM_NS_PER_S;
+                    if (*end == ':') {
+                        motion->Duration = (uint64_t)(strtod(end + 1, NULL) * SIM_NS_PER_S);
+                    }
+                }
+                break;
+
+            case 'o':
+                gSimConfig.Bgapi = (strcmp(optarg, "-") == 0) ? stdout : fopen(optarg, "wb");
+                isValid = (gSimConfig.Bgapi != NULL);
+                break;
+
+            case 'v':
+                gSimConfig.Verbose = true;
+                break;
+
+            default:
+                isValid = false;
+                break;
+        }
+
+        if (!isValid) {
+            MAIN_Usage(argv[0]);
+        }
+    }
+
+    /* The reliable mode and the clock exchange need the control point. */
+    if (((gSimConfig.AckInterval > 0) || (gSimConfig.SyncInterval > 0)) &&
+        !gSimConfig.ControlPoint) {
+        MAIN_Usage(argv[0]);
+    }
+}
+
+
+/***************************************************************************//**
+ * @brief Maps memory at a fixed address of the nRF51 memory map.
+ *
+ * @param[in] address Start of the region.
+ * @param[in] size    Size of the region in bytes.
+ * @param[in] fill    Initial value of every byte.
+ *
+ * @return Nothing. Exits if the region can not be mapped.
+ ******************************************************************************/
+static void MAIN_MapRegion(uintptr_t address, size_t size, uint8_t fill)
+{
+    void *region = mmap((void *)address, size, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    if (region != (void *)address) {
+        fprintf(stderr, "Could not map 0x%08lX on the host.\n", (unsigned long)address);
+        exit(2);
+    }
+    memset(region, fill, size);
+}
+
+
+/***************************************************************************//**
+ * @brief Maps the flash, the FICR, the UICR and the peripherals.
+ *
+ * The firmware accesses the peripherals and the flash with absolute
+ * addresses, so they get mapped at the same addresses as on the nRF51. Only
+ * the flash page at address 0 can not be mapped, but it holds the vector
+ * table of the SoftDevice.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void MAIN_InitMemory(void)
+{
+    MAIN_MapRegion(MAIN_HOST_PAGE_SIZE,
+                   MAIN_FLASH_PAGES * MAIN_FLASH_PAGE_SIZE - MAIN_HOST_PAGE_SIZE, 0xFF);
+    MAIN_MapRegion(NRF_FICR_BASE, 2 * MAIN_HOST_PAGE_SIZE, 0xFF);
+    MAIN_MapRegion(NRF_POWER_BASE, 0x30000, 0x00);
+    MAIN_MapRegion(NRF_GPIO_BASE, MAIN_HOST_PAGE_SIZE, 0x00);
+    MAIN_MapRegion(SCS_BASE, MAIN_HOST_PAGE_SIZE, 0x00);
+
+    *(volatile uint32_t *)&NRF_FICR->CODEPAGESIZE = MAIN_FLASH_PAGE_SIZE;
+    *(volatile uint32_t *)&NRF_FICR->CODESIZE     = MAIN_FLASH_PAGES;
+    *(volatile uint32_t *)&NRF_FICR->DEVICEID[0]  = 0x5158BE51;
+    *(volatile uint32_t *)&NRF_FICR->DEVICEID[1]  = 0x00007A51;
+    *(volatile uint32_t *)&NRF_FICR->DEVICEADDR[0] = 0x12345678;
+    *(volatile uint32_t *)&NRF_FICR->DEVICEADDR[1] = 0x0000C0DE;
+}
+
+
+/***************************************************************************//**
+ * @brief Lets all models handle their events until a point in time.
+ *
+ * @param[in] now The current time.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void MAIN_ProcessUntil(uint64_t now)
+{
+    SIM_LSM330_Process(now);
+    SIM_TMP006_Process(now);
+    SIM_TIMER_Process(now);
+    SIM_SD_Process(now);
+}
+
+
+/***************************************************************************//**
+ * @brief Returns the time of the next event of the simulated hardware.
+ *
+ * @return The time in ns. Ends the simulation if it is after its duration.
+ ******************************************************************************/
+static uint64_t MAIN_NextEvent(void)
+{
+    uint64_t next = SIM_LSM330_NextEvent();
+
+    if (SIM_TMP006_NextEvent() < next) {
+        next = SIM_TMP006_NextEvent();
+    }
+    if (SIM_TIMER_NextEvent() < next) {
+        next = SIM_TIMER_NextEvent();
+    }
+    if (SIM_SD_NextEvent() < next) {
+        next = SIM_SD_NextEvent();
+    }
+
+    if (next > gSimConfig.Duration) {
+        gSimNow = gSimConfig.Duration;
+        SIM_Exit("end of simulation", 0);
+    }
+    return next;
+}
+
+
+uint32_t sd_app_evt_wait(void)
+{
+    /* Events during the execution of the application code. */
+    MAIN_ProcessUntil(gSimNow);
+    idleSpins = 0;
+
+    while (!isWakeupPending) {
+        gSimNow = MAIN_NextEvent();
+        MAIN_ProcessUntil(gSimNow);
+    }
+
+    isWakeupPending = false;
+    gSimStats.Wakeups++;
+    return NRF_SUCCESS;
+}
+
+
+void SIM_Spin(void)
+{
+    /* The CPU polls without sleeping, so the time passes until the next event. */
+    idleSpins++;
+    if (idleSpins >= MAIN_SPIN_LIMIT) {
+        idleSpins = 0;
+        gSimNow = MAIN_NextEvent();
+        MAIN_ProcessUntil(gSimNow);
+    }
+}
+
+
+void SIM_Wakeup(void)
+{
+    isWakeupPending = true;
+}
+
+
+void SIM_Consume(uint64_t duration)
+{
+    gSimNow += duration;
+
+    /* Only the SPI self-test uses TIMER2 (1MHz, 16 bit). It captures right
+     * before and after its SPI transfers, so the capture registers follow the
+     * consumed time. */
+    NRF_TIMER2->CC[0] = (uint16_t)(gSimNow / SIM_NS_PER_US);
+    NRF_TIMER2->CC[1] = NRF_TIMER2->CC[0];
+}
+
+
+void SIM_CheckSystemReset(void)
+{
+    if (SCB->AIRCR & SCB_AIRCR_SYSRESETREQ_Msk) {
+        SIM_Exit("system reset", 0);
+    }
+}
+
+
+void app_error_handler(uint32_t errorCode,
+                       uint32_t lineNumber,
+                       const uint8_t *fileName)
+{
+    fprintf(stderr, "Error 0x%08lX in %s:%lu\n", (unsigned long)errorCode,
+            (fileName != NULL) ? (const char *)fileName : "?",
+            (unsigned long)lineNumber);
+    SIM_Exit("error handler", 1);
+}
+
+
+void assert_nrf_callback(uint16_t lineNumber, const uint8_t *fileName)
+{
+    app_error_handler(0xDEADBEEF, lineNumber, fileName);
+}
+
+
+void SIM_Exit(const char *reason, int status)
+{
+    MAIN_PrintReport(reason);
+    if ((status == 0) && (gSimStats.ClockErrorMax > MAIN_CLOCK_MAX_ERROR)) {
+        fprintf(stderr, "The mapped device time exceeds the error of %.1f ms.\n", MAIN_CLOCK_MAX_ERROR);
+        status = 1;
+    }
+    if ((status == 0) && (gSimConfig.SyncInterval > 0) && (gSimStats.ClockChecks == 0)) {
+        fprintf(stderr, "The mapped device time has not been checked, the run is too short.\n");
+        status = 1;
+    }
+    if ((status == 0) && (gSimStats.SnapshotReads > 0) && !gSimStats.IsSnapshotValid) {
+        fprintf(stderr, "The snapshot read by the gateway is invalid.\n");
+        status = 1;
+    }
+    if ((gSimConfig.Bgapi != NULL) && (gSimConfig.Bgapi != stdout)) {
+        fclose(gSimConfig.Bgapi);
+    }
+    exit(status);
+}
+
+
+void __wrap_APPL_FIFO_Commit(enum appl_fifo_type bufferType, uint32_t numberOfSamples)
+{
+    __real_APPL_FIFO_Commit(bufferType, numberOfSamples);
+
+    if (bufferType < 2) {
+        gSimStats.FifoPutSamples[bufferType] += numberOfSamples;
+    }
+}
+
+
+uint32_t __wrap_APPL_FIFO_Put(enum appl_fifo_type bufferType, const uint8_t *buffer, uint32_t numberOfSamples)
+{
+    uint32_t err = __real_APPL_FIFO_Put(bufferType, buffer, numberOfSamples);
+
+    /* The calls inside fifo.c are not wrapped. */
+    if ((err == ERR_NONE) && (bufferType < 2)) {
+        gSimStats.FifoPutSamples[bufferType] += numberOfSamples;
+    } else if (bufferType < 2) {
+        gSimStats.FifoDropped[bufferType] += numberOfSamples;
+        SIM_LSM330_Discard(bufferType, numberOfSamples);
+    }
+    return err;
+}
+
+
+uint32_t __wrap_APPL_FIFO_Drop(enum appl_fifo_type bufferType, uint32_t numberOfSamples)
+{
+    if (bufferType < 2) {
+        gSimStats.FifoDropped[bufferType] += numberOfSamples;
+        SIM_LSM330_Discard(bufferType, numberOfSamples);
+    }
+    return __real_APPL_FIFO_Drop(bufferType, numberOfSamples);
+}
+
+
+void SIM_SampleFifos(void)
+{
+    for (int i = 0; i < 2; i++) {
+        gSimStats.FifoSum[i] += APPL_FIFO_GetLength(i);
+    }
+}
+
+
+/***************************************************************************//**
+ * @brief Prints the configuration and the results of the run to stdout.
+ *
+ * @param[in] reason Why the simulation ended.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void MAIN_PrintReport(const char *reason)
+{
+    FILE *out = (gSimConfig.Bgapi == stdout) ? stderr : stdout;
+    double seconds = (double)gSimNow / SIM_NS_PER_S;
+    double streaming = (double)(gSimNow - gSimStats.StreamStart) / SIM_NS_PER_S;
+    uint64_t events = (gSimStats.ConnectionEvents > 0) ? gSimStats.ConnectionEvents : 1;
+    static const char *names[2] = { "acc ", "gyro" };
+    double latency[2];
+
+    if (gSimStats.Notifications == 0) {
+        streaming = 0;
+    }
+
+    fprintf(out, "\nTXW51 simulation (%s after %.3f s)\n", reason, seconds);
+    fprintf(out, "  Accelerometer        %g Hz\n", accOdrs[gSimConfig.AccOdr]);
+    if (gSimConfig.GyroEnable) {
+        fprintf(out, "  Gyroscope            %g Hz\n", gyroOdrs[gSimConfig.GyroOdr]);
+    } else {
+        fprintf(out, "  Gyroscope            off\n");
+    }
+    fprintf(out, "  Connection           %.2f ms interval, %lu packets per event, %u TX buffers\n",
+            (double)gSimConfig.ConnInterval / SIM_NS_PER_MS,
+            (unsigned long)gSimConfig.PacketsPerEvent, gSimConfig.TxBuffers);
+    fprintf(out, "  Stream mode          %s\n", gSimConfig.LowLatency ? "low latency" : "throughput");
+
+    fprintf(out, "Sensor\n");
+    fprintf(out, "  Samples              %llu acc, %llu gyro\n",
+            (unsigned long long)gSimStats.SamplesAcc, (unsigned long long)gSimStats.SamplesGyro);
+    fprintf(out, "  FIFO overruns        %llu acc, %llu gyro\n",
+            (unsigned long long)gSimStats.OverrunsAcc, (unsigned long long)gSimStats.OverrunsGyro);
+    fprintf(out, "  Interrupts           %llu\n", (unsigned long long)gSimStats.Interrupts);
+    fprintf(out, "  TMP006 samples       %llu\n", (unsigned long long)gSimStats.Tmp006Samples);
+    fprintf(out, "  SPI transfers        %llu (%llu bytes, %.1f ms on the bus at %lu kHz)\n",
+            (unsigned long long)gSimStats.SpiTransfers, (unsigned long long)gSimStats.SpiBytes,
+            (double)gSimStats.SpiTime / SIM_NS_PER_MS,
+            (unsigned long)gSimStats.SpiFrequency / 1000);
+
+    fprintf(out, "Application\n");
+    for (int i = 0; i < 2; i++) {
+        fprintf(out, "  FIFO %s            max %lu/%lu slots, avg %.1f slots, %llu put, %llu dropped samples\n",
+                names[i],
+                (unsigned long)(APPL_FIFO_GetPeak(i) / sizeof(struct TXW51_SERV_MEASURE_DataPacket)),
+                (unsigned long)APPL_FIFO_GetSize(i),
+                (double)gSimStats.FifoSum[i] / events,
+                (unsigned long long)gSimStats.FifoPutSamples[i],
+                (unsigned long long)gSimStats.FifoDropped[i]);
+    }
+    fprintf(out, "  Stack                max %lu bytes in host frames (%lu bytes on the target)\n",
+            (unsigned long)TXW51_STACK_GetMaxUsage(), (unsigned long)TXW51_STACK_GetSize());
+    fprintf(out, "  Scheduler            max %lu queued, %llu overflows\n",
+            (unsigned long)gSimStats.SchedMax, (unsigned long long)gSimStats.SchedOverflows);
+    fprintf(out, "  Wake-ups             %llu\n", (unsigned long long)gSimStats.Wakeups);
+    fprintf(out, "  Flash                %llu writes, %llu erases\n",
+            (unsigned long long)gSimStats.FlashWrites, (unsigned long long)gSimStats.FlashErases);
+    fprintf(out, "  Advertising data     %llu updates\n", (unsigned long long)gSimStats.AdvDataUpdates);
+    fprintf(out, "  Attribute table      %lu/%lu bytes, %lu attributes\n",
+            (unsigned long)gSimStats.AttrTableUsed, (unsigned long)gSimStats.AttrTableSize,
+            (unsigned long)gSimStats.Attributes);
+
+    fprintf(out, "Link\n");
+    fprintf(out, "  Connection events    %llu (%llu full, %llu without data)\n",
+            (unsigned long long)gSimStats.ConnectionEvents,
+            (unsigned long long)gSimStats.FullEvents,
+            (unsigned long long)gSimStats.EmptyEvents);
+    fprintf(out, "  Notifications        %llu (%.1f packets/s)\n",
+            (unsigned long long)gSimStats.Notifications,
+            (streaming > 0) ? gSimStats.Notifications / streaming : 0.0);
+    fprintf(out, "  Samples delivered    %llu acc, %llu gyro (%.1f samples/s)\n",
+            (unsigned long long)gSimStats.NotifiedSamplesAcc,
+            (unsigned long long)gSimStats.NotifiedSamplesGyro,
+            (streaming > 0) ? gSimStats.NotifiedSamples / streaming : 0.0);
+    for (int i = 0; i < 2; i++) {
+        latency[i] = (gSimStats.LatencySamples[i] > 0) ?
+                     (double)gSimStats.LatencySum[i] / gSimStats.LatencySamples[i] / SIM_NS_PER_MS : 0.0;
+    }
+    fprintf(out, "  Latency              avg %.1f ms acc, %.1f ms gyro\n", latency[0], latency[1]);
+    fprintf(out, "                       max %.1f ms acc, %.1f ms gyro\n",
+            (double)gSimStats.LatencyMax[0] / SIM_NS_PER_MS,
+            (double)gSimStats.LatencyMax[1] / SIM_NS_PER_MS);
+    fprintf(out, "  Driver samples       %llu\n", (unsigned long long)gSimStats.NotifiedSamplesDrivers);
+    fprintf(out, "  Sequence gaps        %llu\n", (unsigned long long)gSimStats.SequenceGaps);
+    fprintf(out, "  Snapshot             %lu bytes in %lu reads, %s\n",
+            (unsigned long)gSimStats.SnapshotLength, (unsigned long)gSimStats.SnapshotReads,
+            gSimStats.IsSnapshotValid ? "valid" : "invalid");
+    fprintf(out, "  Discontinuities      %llu acc, %llu gyro\n",
+            (unsigned long long)gSimStats.Discontinuities[0],
+            (unsigned long long)gSimStats.Discontinuities[1]);
+    if (gSimConfig.LossInterval > 0) {
+        fprintf(out, "  Lost by the gateway  %llu packets\n", (unsigned long long)gSimStats.LostPackets);
+    }
+    if (gSimConfig.AckInterval > 0) {
+        fprintf(out, "  Reliable mode        %llu acknowledgements, %llu packets requested, %llu duplicates discarded\n",
+                (unsigned long long)gSimStats.Acks, (unsigned long long)gSimStats.RequestedPackets,
+                (unsigned long long)gSimStats.DiscardedPackets);
+    }
+    if (gSimConfig.SyncInterval > 0) {
+        fprintf(out, "  Clock exchanges      %llu (%llu accepted, %llu rejected)\n",
+                (unsigned long long)gSimStats.SyncExchanges,
+                (unsigned long long)gSimStats.SyncAccepted,
+                (unsigned long long)gSimStats.SyncRejected);
+        fprintf(out, "  Clock drift          %.3f ppm estimated, %.3f ppm simulated\n",
+                APPL_CLOCK_GetDrift() / 1000.0, gSimConfig.ClockDrift);
+        fprintf(out, "  Clock error          avg %.3f ms, max %.3f ms (%llu checks)\n",
+                (gSimStats.ClockChecks > 0) ? gSimStats.ClockErrorSum / gSimStats.ClockChecks : 0.0,
+                gSimStats.ClockErrorMax, (unsigned long long)gSimStats.ClockChecks);
+    }
+    if (gSimConfig.ControlPoint) {
+        fprintf(out, "  Control point        %llu status notifications, last status %u\n",
+                (unsigned long long)gSimStats.ControlStatuses, gSimStats.ControlStatus);
+    }
+    fprintf(out, "  hvx rejected         %llu without TX buffer, %llu other\n",
+            (unsigned long long)gSimStats.HvxNoBuffers, (unsigned long long)gSimStats.HvxOtherErrors);
+}
@@ -0,0 +1,127 @@
+/***************************************************************************//**
+ * @brief   Host replacement of the SDK event scheduler.
+ *
+ * app_scheduler.c checks the size of its event header against 32-bit
+ * pointers, so it can not be built for the host. This replacement keeps the
+ * same interface and queue semantics and additionally counts the maximum
+ * number of queued events and the events lost because of a full queue.
+ *
+ * @file    sim_scheduler.c
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+/*----- Header-Files ---------------------------------------------------------*/
+#include "sim.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "nrf/app_common/app_scheduler.h"
+
+/*----- Macros ---------------------------------------------------------------*/
+
+/*----- Data types -----------------------------------------------------------*/
+/**
+ * @brief An entry of the queue.
+ */
+struct SCHED_Event {
+    app_sched_event_handler_t Handler;  /**< Handler of the event. */
+    uint16_t Size;                      /**< Size of the event data. */
+    uint8_t *Data;                      /**< Copy of the event data. */
+};
+
+/*----- Function prototypes --------------------------------------------------*/
+
+/*----- Data -----------------------------------------------------------------*/
+static struct SCHED_Event *queue = NULL;    /**< The queue. */
+static uint16_t queueSize = 0;              /**< Number of entries in the queue. */
+static uint16_t maxEventSize = 0;           /**< Maximum size of the event data. */
+static uint16_t head = 0;                   /**< Index of the next event to execute. */
+static uint16_t count = 0;                  /**< Number of queued events. */
+static uint16_t maxCount = 0;               /**< Maximum number of queued events since the initialization. */
+
+/*----- Implementation -------------------------------------------------------*/
+
+uint32_t app_sched_init(uint16_t max_event_size, uint16_t queue_size, void *p_evt_buffer)
+{
+    /* The buffer of APP_SCHED_INIT() is sized for the target, so it is not used. */
+    free(queue);
+    queue = calloc(queue_size, sizeof(struct SCHED_Event));
+    for (uint16_t i = 0; i < queue_size; i++) {
+        queue[i].Data = malloc(max_event_size > 0 ? max_event_size : 1);
+    }
+
+    queueSize = queue_size;
+    maxEventSize = max_event_size;
+    head = 0;
+    count = 0;
+    maxCount = 0;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_sched_event_put(void *p_event_data,
+                             uint16_t event_size,
+                             app_sched_event_handler_t handler)
+{
+    struct SCHED_Event *event;
+
+    if (event_size > maxEventSize) {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+    if (count >= queueSize) {
+        gSimStats.SchedOverflows++;
+        return NRF_ERROR_NO_MEM;
+    }
+
+    event = &queue[(head + count) % queueSize];
+    event->Handler = handler;
+    event->Size = event_size;
+    if ((p_event_data != NULL) && (event_size > 0)) {
+        memcpy(event->Data, p_event_data, event_size);
+    }
+
+    count++;
+    if (count > maxCount) {
+        maxCount = count;
+    }
+    if (count > gSimStats.SchedMax) {
+        gSimStats.SchedMax = count;
+    }
+    return NRF_SUCCESS;
+}
+
+
+void app_sched_execute(void)
+{
+    if (count == 0) {
+        /* Polling loops like APPL_Sleep() wait for events in here. */
+        SIM_Spin();
+    }
+
+    while (count > 0) {
+        struct SCHED_Event *event = &queue[head];
+
+        event->Handler((event->Size > 0) ? event->Data : NULL, event->Size);
+
+        head = (head + 1) % queueSize;
+        count--;
+    }
+}
+
+
+uint16_t app_sched_queue_utilization_get(void)
+{
+    return maxCount;
+}
+
+
+uint32_t SIM_SCHED_Count(void)
+{
+    return count;
+}
@@ -0,0 +1,1736 @@
+/***************************************************************************//**
+ * @brief   Model of the S110 SoftDevice and of the gateway.
+ *
+ * Implements the SoftDevice calls of the application with the behaviour that
+ * matters for the data stream:
+ *  - The GATT table assigns the handles like the stack and keeps the CCCDs.
+ *  - sd_ble_gatts_hvx() fails without a connection, without the CCCD being
+ *    set or without a free TX buffer.
+ *  - At every connection event up to PacketsPerEvent buffered packets are
+ *    transmitted and reported with BLE_EVT_TX_COMPLETE. An indication takes
+ *    one connection event and is confirmed in the next one.
+ *  - Flash operations take the time of the nRF51 and report their end with a
+ *    SoC event.
+ *  - If the radio notification is configured, SWI1 signals the start and the
+ *    end of every connection event. The event takes no time, so both happen
+ *    at its anchor point.
+ *
+ * The gateway connects after the advertising started, configures the sensor
+ * and starts the measurement with one write request per connection event
+ * like the BLED112 agent, or with a single command to the control point.
+ * In the reliable mode, it acknowledges the data stream with write commands
+ * to the control point: every ack interval packets, at the first packet
+ * after a gap and when nothing arrived in order for SD_ACK_TIMEOUT_EVENTS
+ * connection events although packets are unacknowledged or missing. Every
+ * n-th data packet can be lost in the gateway to exercise the retransmission.
+ * The gateway synchronizes the device time with the clock exchange of the
+ * control point, right after the previous connection event like the agent.
+ * Like the timer of the agent, it starts them up to SD_SYNC_JITTER of the
+ * interval late at random, so the receipts do not keep their phase to the
+ * RTC1 tick.
+ * Its clock is the simulated time in ms from SD_GATEWAY_EPOCH_MS, so it wraps
+ * during the run. After SD_SYNC_SETTLE accepted exchanges over at least
+ * SD_SYNC_SETTLE_TIME, when the drift has been fitted over half a minute, the
+ * device time mapped to the gateway clock is checked at every connection
+ * event against the true time of the RTC1 tick.
+ * Optionally, its BGAPI events are written to a file
+ * so they can be replayed into the gateway.
+ *
+ * The events are delivered through the real SWI2_IRQHandler() of the
+ * softdevice_handler.c.
+ *
+ * @file    sim_softdevice.c
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+/*----- Header-Files ---------------------------------------------------------*/
+#include "sim.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "nrf/nrf.h"
+#include "nrf/s110/ble.h"
+#include "nrf/s110/ble_hci.h"
+#include "nrf/s110/nrf_sdm.h"
+#include "nrf/s110/nrf_soc.h"
+#include "nrf/sd_common/ble_stack_handler_types.h"
+
+#include "txw51_framework/ble/service_dis.h"
+#include "txw51_framework/config/config_services.h"
+#include "txw51_framework/hw/lsm330.h"
+
+#include "app/clock.h"
+#include "app/control.h"
+#include "app/device_info.h"
+#include "app/sensor.h"
+
+/*----- Macros ---------------------------------------------------------------*/
+#define SD_FIRST_HANDLE         ( 0x000C )  /**< First handle after the GAP and GATT services of the stack. */
+#define SD_MAX_ATTRIBUTES       ( 128 )     /**< Maximum number of entries in the GATT table. */
+#define SD_MAX_VALUE            ( 32 )      /**< Maximum length of an attribute value. */
+#define SD_ATTR_TAB_SIZE        ( 0x600 )   /**< Attribute table of the S110 7.x, fixed by the stack. */
+#define SD_ATTR_ENTRY_SIZE      ( 8 )      /**< Assumed cost of an attribute without its value, the stack does not document it. */
+#define SD_BLE_QUEUE_SIZE       ( 32 )      /**< Number of BLE events the stack can hold. */
+#define SD_SOC_QUEUE_SIZE       ( 8 )       /**< Number of SoC events the stack can hold. */
+#define SD_EVT_SIZE             ( BLE_STACK_EVT_MSG_BUF_SIZE )  /**< Size of a BLE event. */
+#define SD_MAX_TX_BUFFERS       ( 7 )       /**< Maximum number of application TX buffers. */
+#define SD_PACKET_SIZE          ( 20 )      /**< Maximum length of a notification. */
+#define SD_READ_SIZE            ( 22 )      /**< Maximum length of a read response, ATT_MTU 23. */
+#define SD_SNAPSHOT_STRINGS     ( APPL_DEVINFO_NUM_OF_ENTRIES + 1 ) /**< Strings of the snapshot, the entries and the build id. */
+#define SD_MAX_GATEWAY_WRITES   ( 8 )       /**< Maximum number of writes of the gateway. */
+#define SD_ACK_TIMEOUT_EVENTS   ( 8 )       /**< Connection events without progress until the gateway acknowledges again. */
+#define SD_REORDER_SIZE         ( 2 * APPL_CONTROL_MAX_ACK_INTERVAL )   /**< Packets the gateway keeps behind a gap, the window of the device. */
+#define SD_REORDER_BIT(number)  ( 1UL << ((uint8_t)(number) % SD_REORDER_SIZE) )  /**< Bit of a sequence number in reorderMask and requestedMask. */
+#define SD_FLASH_WORD_TIME      ( 46 * SIM_NS_PER_US )      /**< Time to write a word to the flash. */
+#define SD_FLASH_ERASE_TIME     ( 22 * SIM_NS_PER_MS )      /**< Time to erase a flash page. */
+#define SD_CONN_HANDLE          ( 0 )       /**< Handle of the simulated connection. */
+#define SD_DIE_TEMP             ( 100 )     /**< Temperature of the die in 0.25 degC (25 degC). */
+#define SD_GATEWAY_EPOCH_MS     ( 0xFFFFF000UL )    /**< Gateway clock at the start of the simulation in ms. */
+#define SD_SYNC_SETTLE          ( 4 )       /**< Accepted clock exchanges before the mapped device time gets checked. */
+#define SD_SYNC_SETTLE_TIME     ( 30 * SIM_NS_PER_S )   /**< Time since the first accepted clock exchange before the mapped device time gets checked. */
+#define SD_SYNC_JITTER          ( 10 )      /**< The clock exchanges start up to 1/SD_SYNC_JITTER of the interval late. */
+
+/*----- Data types -----------------------------------------------------------*/
+/**
+ * @brief Entry of the GATT table for a characteristic value or a descriptor.
+ */
+struct SD_Attribute {
+    uint16_t Handle;                /**< Attribute handle. */
+    uint16_t Uuid;                  /**< 16 bit UUID of the characteristic. */
+    uint8_t  Type;                  /**< BLE_GATTS_ATTR_TYPE_CHAR_VAL or BLE_GATTS_ATTR_TYPE_DESC. */
+    uint16_t ServiceHandle;         /**< Handle of the service. */
+    uint16_t ValueHandle;           /**< Handle of the characteristic value. */
+    uint16_t CccdHandle;            /**< Handle of the CCCD, BLE_GATT_HANDLE_INVALID if none. */
+    uint8_t  Value[SD_MAX_VALUE];   /**< Current value. */
+    uint16_t Length;                /**< Length of the current value. */
+    uint16_t MaxLength;             /**< Maximum length of the value. */
+    uint8_t *UserValue;             /**< Value kept by the application (BLE_GATTS_VLOC_USER), NULL if in Value. */
+};
+
+/**
+ * @brief A write request of the gateway.
+ */
+struct SD_GatewayWrite {
+    uint16_t Uuid;      /**< Characteristic to write to. */
+    bool     IsCccd;    /**< Write to the CCCD of the characteristic. */
+    uint8_t  Op;        /**< BLE_GATTS_OP_WRITE_REQ or BLE_GATTS_OP_WRITE_CMD. */
+    uint8_t  Value[SD_PACKET_SIZE]; /**< Value to write. */
+    uint8_t  Length;    /**< Length of the value. */
+};
+
+/**
+ * @brief A flash operation of the stack.
+ */
+struct SD_FlashOperation {
+    bool      IsPending;    /**< An operation is running. */
+    bool      IsErase;      /**< Page erase, otherwise write. */
+    uint32_t *Destination;  /**< Destination of a write or the erased page. */
+    const uint32_t *Source; /**< Data to write, read when the operation completes. */
+    uint32_t  Size;         /**< Number of words to write. */
+    uint64_t  End;          /**< Time when the operation completes. */
+};
+
+/*----- Function prototypes --------------------------------------------------*/
+static void     SD_PushBleEvent(ble_evt_t *event, uint16_t length);
+static void     SD_PushSocEvent(uint32_t evtId);
+static struct SD_Attribute *SD_FindAttribute(uint16_t handle);
+static struct SD_Attribute *SD_FindCharacteristic(uint16_t uuid);
+static void     SD_Connect(void);
+static void     SD_Disconnect(uint8_t reason);
+static void     SD_ConnectionEvent(void);
+static void     SD_AddGatewayWrite(uint16_t uuid, bool isCccd, uint8_t op, const uint8_t *value, uint8_t length);
+static void     SD_AddControlCommand(void);
+static void     SD_GatewayStep(void);
+static void     SD_GatewayReadSnapshot(void);
+static bool     SD_CheckSnapshot(const uint8_t *snapshot, uint16_t length);
+static void     SD_GatewayAck(bool isRepeat);
+static void     SD_BuildAck(void);
+static void     SD_GatewaySync(const uint8_t *data);
+static void     SD_CheckClock(void);
+static uint32_t SD_GatewayTime(uint64_t time);
+static uint64_t SD_GetSyncTime(void);
+static void     SD_ReceiveReliable(const uint8_t *data);
+static void     SD_DeliverPacket(const uint8_t *data);
+static void     SD_CountPacket(const uint8_t *data, uint16_t length);
+static void     SD_WriteBgapi(uint8_t class, uint8_t id, const uint8_t *payload, uint8_t length);
+static uint32_t SD_AllocateAttribute(uint16_t valueSize);
+
+extern void SWI1_IRQHandler(void);
+extern void SWI2_IRQHandler(void);
+
+/*----- Data -----------------------------------------------------------------*/
+static struct SD_Attribute attributes[SD_MAX_ATTRIBUTES];   /**< The GATT table. */
+static uint32_t numberOfAttributes = 0;     /**< Entries in the GATT table. */
+static uint16_t nextHandle = SD_FIRST_HANDLE;   /**< Next free attribute handle. */
+static uint8_t  numberOfVsUuids = 0;        /**< Registered vendor specific UUID bases. */
+static ble_uuid128_t vsUuids[BLE_UUID_VS_MAX_COUNT];    /**< The vendor specific UUID bases. */
+
+static uint8_t  bleQueue[SD_BLE_QUEUE_SIZE][SD_EVT_SIZE];   /**< Queued BLE events. */
+static uint16_t bleLength[SD_BLE_QUEUE_SIZE];   /**< Lengths of the queued BLE events. */
+static uint32_t bleHead = 0;                /**< Index of the next BLE event. */
+static uint32_t bleCount = 0;               /**< Number of queued BLE events. */
+static uint32_t socQueue[SD_SOC_QUEUE_SIZE];    /**< Queued SoC events. */
+static uint32_t socHead = 0;                /**< Index of the next SoC event. */
+static uint32_t socCount = 0;               /**< Number of queued SoC events. */
+
+static bool     isAdvertising = false;      /**< The device advertises. */
+static uint64_t connectTime = SIM_TIME_NEVER;   /**< Time when the gateway connects. */
+static uint64_t advTimeout = SIM_TIME_NEVER;    /**< Time when the advertising times out. */
+static bool     isConnected = false;        /**< A connection exists. */
+static uint64_t nextConnEvent = SIM_TIME_NEVER; /**< Time of the next connection event. */
+static bool     isDisconnectRequested = false;  /**< The application called sd_ble_gap_disconnect(). */
+static bool     isRadioNotification = false;    /**< The application configured the radio notification. */
+
+static uint8_t  txPackets[SD_MAX_TX_BUFFERS][SD_PACKET_SIZE];   /**< Buffered notifications. */
+static uint16_t txLength[SD_MAX_TX_BUFFERS];    /**< Lengths of the buffered notifications. */
+static uint16_t txHandle[SD_MAX_TX_BUFFERS];    /**< Attribute handles of the buffered notifications. */
+static uint32_t txHead = 0;                 /**< Index of the next notification to transmit. */
+static uint32_t txCount = 0;                /**< Number of buffered notifications. */
+
+static bool     isIndicationPending = false;    /**< An indication waits for its transmission. */
+static bool     isIndicationSent = false;   /**< An indication waits for its confirmation. */
+static uint16_t indicationHandle = 0;       /**< Handle of the pending indication. */
+
+static uint32_t gatewayStep = 0;            /**< Next write request of the gateway. */
+static struct SD_GatewayWrite gatewayWrites[SD_MAX_GATEWAY_WRITES];   /**< The writes to start the measurement. */
+static uint32_t numberOfGatewayWrites = 0;  /**< Number of entries in gatewayWrites. */
+static bool     isStreamEnabled = false;    /**< The gateway enabled the data stream. */
+static uint8_t  lastSequence = 0;           /**< Sequence number of the last received packet. */
+static bool     hasSequence = false;        /**< A packet has been received. */
+static uint32_t dataPackets = 0;            /**< Data packets that arrived at the gateway, including the lost ones. */
+static bool     isSnapshotRead = false;     /**< The gateway reads the snapshot before its writes. */
+static uint16_t snapshotOffset = 0;         /**< Bytes of the snapshot that the gateway has read. */
+static uint8_t  snapshot[TXW51_SERV_DIS_SNAPSHOT_MAX_LENGTH];   /**< The snapshot read by the gateway. */
+
+static struct SD_GatewayWrite ackWrite;     /**< Acknowledgement of the reliable mode waiting for the next connection event. */
+static bool     isAckPending = false;       /**< ackWrite waits to be sent. */
+static uint8_t  expectedSequence = 0;       /**< Sequence number of the next packet in order. */
+static uint32_t unackedPackets = 0;         /**< Packets received in order since the last acknowledgement. */
+static bool     isAckRepeat = false;        /**< The pending acknowledgement lists the missing packets that have been listed before. */
+static uint8_t  reorder[SD_REORDER_SIZE][SD_PACKET_SIZE];   /**< Packets received behind a gap, indexed by sequence number. */
+static uint32_t reorderMask = 0;            /**< Sequence numbers in reorder, see SD_REORDER_BIT(). */
+static uint32_t requestedMask = 0;          /**< Missing sequence numbers that have been listed in an acknowledgement. */
+static uint32_t ackAge = 0;                 /**< Connection events since the last progress or acknowledgement. */
+
+static struct SD_GatewayWrite syncWrite;    /**< Write of a clock exchange waiting for the next connection event. */
+static bool     isSyncPending = false;      /**< syncWrite waits to be sent. */
+static bool     isSyncRunning = false;      /**< A clock exchange has been started and is not finished. */
+static uint64_t nextSync = SIM_TIME_NEVER;  /**< Time when the gateway starts the next clock exchange. */
+static uint32_t syncRandom = 1;             /**< State of the random generator of the exchange times. */
+static uint64_t firstSync = SIM_TIME_NEVER; /**< Time of the first accepted clock exchange. */
+static uint64_t lastEventTime = 0;          /**< Time of the previous connection event. */
+
+static struct SD_FlashOperation flash;      /**< The running flash operation. */
+static uint32_t hfclkRequests = 0;          /**< The HFCLK has been requested. */
+
+/*----- Implementation -------------------------------------------------------*/
+
+void SIM_SD_Init(void)
+{
+    static const uint8_t enable[] = { 1 };
+    static const uint8_t notify[] = { BLE_GATT_HVX_NOTIFICATION, 0 };
+
+    numberOfGatewayWrites = 0;
+    if (gSimConfig.ControlPoint) {
+        SD_AddGatewayWrite(TXW51_SERV_MEASURE_UUID_CHAR_CONTROL, true, BLE_GATTS_OP_WRITE_REQ, notify, 2);
+        SD_AddGatewayWrite(TXW51_SERV_MEASURE_UUID_CHAR_DATASTRAM, true, BLE_GATTS_OP_WRITE_REQ, notify, 2);
+        SD_AddControlCommand();
+        return;
+    }
+
+    if (gSimConfig.LowLatency) {
+        SD_AddGatewayWrite(SERVICE_LSM330_UUID_CHAR_STREAM_MODE, false, BLE_GATTS_OP_WRITE_REQ,
+                           (const uint8_t[]) { APPL_SENSOR_MODE_LOW_LATENCY }, 1);
+    }
+    SD_AddGatewayWrite(SERVICE_LSM330_UUID_CHAR_ACC_ODR, false, BLE_GATTS_OP_WRITE_REQ,
+                       &gSimConfig.AccOdr, 1);
+    if (gSimConfig.GyroEnable) {
+        SD_AddGatewayWrite(SERVICE_LSM330_UUID_CHAR_GYRO_ODR, false, BLE_GATTS_OP_WRITE_REQ,
+                           &gSimConfig.GyroOdr, 1);
+        SD_AddGatewayWrite(SERVICE_LSM330_UUID_CHAR_GYRO_EN, false, BLE_GATTS_OP_WRITE_REQ, enable, 1);
+    }
+    SD_AddGatewayWrite(SERVICE_LSM330_UUID_CHAR_ACC_EN, false, BLE_GATTS_OP_WRITE_REQ, enable, 1);
+    SD_AddGatewayWrite(TXW51_SERV_MEASURE_UUID_CHAR_DATASTRAM, true, BLE_GATTS_OP_WRITE_REQ, notify, 2);
+    SD_AddGatewayWrite(TXW51_SERV_MEASURE_UUID_CHAR_START, false, BLE_GATTS_OP_WRITE_REQ, enable, 1);
+}
+
+
+/***************************************************************************//**
+ * @brief Appends a write to the writes of the gateway.
+ *
+ * @param[in] uuid   Characteristic to write to.
+ * @param[in] isCccd Write to the CCCD of the characteristic.
+ * @param[in] op     BLE_GATTS_OP_WRITE_REQ or BLE_GATTS_OP_WRITE_CMD.
+ * @param[in] value  Value to write.
+ * @param[in] length Length of the value.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void SD_AddGatewayWrite(uint16_t uuid, bool isCccd, uint8_t op, const uint8_t *value, uint8_t length)
+{
+    struct SD_GatewayWrite *write = &gatewayWrites[numberOfGatewayWrites++];
+
+    write->Uuid = uuid;
+    write->IsCccd = isCccd;
+    write->Op = op;
+    memcpy(write->Value, value, length);
+    write->Length = length;
+}
+
+
+/***************************************************************************//**
+ * @brief Appends the command that configures and starts the measurement
+ *        through the control point, see app/control.h.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void SD_AddControlCommand(void)
+{
+    uint8_t command[] = {
+        APPL_CONTROL_OP_START,
+        APPL_CONTROL_TYPE_ACC, sizeof(struct APPL_SENSOR_Config),
+        APPL_SENSOR_ALL_AXES, gSimConfig.AccOdr, TXW51_LSM330_ACC_FSCALE_2G, 0,
+        APPL_CONTROL_TYPE_GYRO, sizeof(struct APPL_SENSOR_Config),
+        gSimConfig.GyroEnable ? APPL_SENSOR_ALL_AXES : 0, gSimConfig.GyroOdr,
+        TXW51_LSM330_GYRO_FSCALE_250DPS, 0,
+        APPL_CONTROL_TYPE_STREAM_MODE, 1,
+        gSimConfig.LowLatency ? APPL_SENSOR_MODE_LOW_LATENCY : APPL_SENSOR_MODE_THROUGHPUT,
+        APPL_CONTROL_TYPE_RELIABLE, 1,
+        gSimConfig.AckInterval
+    };
+
+    SD_AddGatewayWrite(TXW51_SERV_MEASURE_UUID_CHAR_CONTROL, false, BLE_GATTS_OP_WRITE_CMD,
+                       command, sizeof(command));
+}
+
+
+uint64_t SIM_SD_NextEvent(void)
+{
+    uint64_t next = SIM_TIME_NEVER;
+
+    if (isDisconnectRequested) {
+        return gSimNow;
+    }
+    if (isAdvertising) {
+        next = (connectTime < advTimeout) ? connectTime : advTimeout;
+    }
+    if (nextConnEvent < next) {
+        next = nextConnEvent;
+    }
+    if (flash.IsPending && (flash.End < next)) {
+        next = flash.End;
+    }
+    return next;
+}
+
+
+void SIM_SD_Process(uint64_t now)
+{
+    if (flash.IsPending && (flash.End <= now)) {
+        flash.IsPending = false;
+        if (flash.IsErase) {
+            memset(flash.Destination, 0xFF, NRF_FICR->CODEPAGESIZE);
+            gSimStats.FlashErases++;
+        } else {
+            /* Programming can only clear bits. */
+            for (uint32_t i = 0; i < flash.Size; i++) {
+                flash.Destination[i] &= flash.Source[i];
+            }
+            gSimStats.FlashWrites++;
+        }
+        SD_PushSocEvent(NRF_EVT_FLASH_OPERATION_SUCCESS);
+    }
+
+    if (isDisconnectRequested) {
+        isDisconnectRequested = false;
+        SD_Disconnect(BLE_HCI_LOCAL_HOST_TERMINATED_CONNECTION);
+    }
+
+    if (isAdvertising && (advTimeout <= now) && (advTimeout <= connectTime)) {
+        ble_evt_t event;
+        memset(&event, 0, sizeof(event));
+        isAdvertising = false;
+        event.header.evt_id = BLE_GAP_EVT_TIMEOUT;
+        event.header.evt_len = sizeof(ble_gap_evt_t);
+        event.evt.gap_evt.conn_handle = BLE_CONN_HANDLE_INVALID;
+        event.evt.gap_evt.params.timeout.src = BLE_GAP_TIMEOUT_SRC_ADVERTISEMENT;
+        SD_PushBleEvent(&event, sizeof(ble_evt_hdr_t) + sizeof(ble_gap_evt_t));
+    }
+
+    if (isAdvertising && (connectTime <= now)) {
+        SD_Connect();
+    }
+
+    while (isConnected && (nextConnEvent <= now)) {
+        SD_ConnectionEvent();
+        nextConnEvent += gSimConfig.ConnInterval;
+    }
+}
+
+
+/***************************************************************************//**
+ * @brief Queues a BLE event and signals it with the SWI2 interrupt.
+ *
+ * @param[in] event  The event.
+ * @param[in] length Length of the event including the header.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void SD_PushBleEvent(ble_evt_t *event, uint16_t length)
+{
+    uint32_t index;
+
+    if (bleCount >= SD_BLE_QUEUE_SIZE) {
+        fprintf(stderr, "SoftDevice: BLE event queue overflow.\n");
+        return;
+    }
+
+    index = (bleHead + bleCount) % SD_BLE_QUEUE_SIZE;
+    memcpy(bleQueue[index], event, length);
+    bleLength[index] = length;
+    bleCount++;
+
+    SWI2_IRQHandler();
+    SIM_Wakeup();
+}
+
+
+/***************************************************************************//**
+ * @brief Queues a SoC event and signals it with the SWI2 interrupt.
+ *
+ * @param[in] evtId The event.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void SD_PushSocEvent(uint32_t evtId)
+{
+    if (socCount >= SD_SOC_QUEUE_SIZE) {
+        fprintf(stderr, "SoftDevice: SoC event queue overflow.\n");
+        return;
+    }
+
+    socQueue[(socHead + socCount) % SD_SOC_QUEUE_SIZE] = evtId;
+    socCount++;
+
+    SWI2_IRQHandler();
+    SIM_Wakeup();
+}
+
+
+/***************************************************************************//**
+ * @brief Finds a characteristic value or descriptor by its handle.
+ *
+ * @param[in] handle The attribute handle.
+ *
+ * @return The entry in the GATT table, NULL if not found.
+ ******************************************************************************/
+static struct SD_Attribute *SD_FindAttribute(uint16_t handle)
+{
+    for (uint32_t i = 0; i < numberOfAttributes; i++) {
+        if (attributes[i].Handle == handle) {
+            return &attributes[i];
+        }
+    }
+    return NULL;
+}
+
+
+/***************************************************************************//**
+ * @brief Finds a characteristic value by its 16 bit UUID.
+ *
+ * @param[in] uuid The UUID of the characteristic.
+ *
+ * @return The entry in the GATT table, NULL if not found.
+ ******************************************************************************/
+static struct SD_Attribute *SD_FindCharacteristic(uint16_t uuid)
+{
+    for (uint32_t i = 0; i < numberOfAttributes; i++) {
+        if ((attributes[i].Uuid == uuid) &&
+            (attributes[i].Type == BLE_GATTS_ATTR_TYPE_CHAR_VAL)) {
+            return &attributes[i];
+        }
+    }
+    return NULL;
+}
+
+
+/***************************************************************************//**
+ * @brief Establishes the connection of the gateway.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void SD_Connect(void)
+{
+    ble_evt_t event;
+    uint16_t interval = (uint16_t)(gSimConfig.ConnInterval / (1250 * SIM_NS_PER_US));
+    uint8_t status[16] = {
+        SD_CONN_HANDLE, 0x05,                           /* connected, completed */
+        0x51, 0xBE, 0x58, 0x51, 0x7A, 0x00, 0x00,       /* address, address type */
+        interval & 0xFF, interval >> 8,
+        0xC8, 0x00,                                     /* timeout 2s */
+        0x00, 0x00,                                     /* latency */
+        0xFF                                            /* no bonding */
+    };
+
+    isAdvertising = false;
+    isConnected = true;
+    nextConnEvent = gSimNow + gSimConfig.ConnInterval;
+    gatewayStep = 0;
+    isSnapshotRead = true;
+    snapshotOffset = 0;
+    txHead = 0;
+    txCount = 0;
+    isIndicationPending = false;
+    isIndicationSent = false;
+    hasSequence = false;
+    isSyncPending = false;
+    isSyncRunning = false;
+    nextSync = (gSimConfig.SyncInterval > 0) ? SD_GetSyncTime() : SIM_TIME_NEVER;
+    lastEventTime = gSimNow;
+
+    memset(&event, 0, sizeof(event));
+    event.header.evt_id = BLE_GAP_EVT_CONNECTED;
+    event.header.evt_len = sizeof(ble_gap_evt_t);
+    event.evt.gap_evt.conn_handle = SD_CONN_HANDLE;
+    event.evt.gap_evt.params.connected.conn_params.min_conn_interval = interval;
+    event.evt.gap_evt.params.connected.conn_params.max_conn_interval = interval;
+    event.evt.gap_evt.params.connected.conn_params.slave_latency = 0;
+    event.evt.gap_evt.params.connected.conn_params.conn_sup_timeout = 200;
+    SD_PushBleEvent(&event, sizeof(ble_evt_hdr_t) + sizeof(ble_gap_evt_t));
+
+    SD_WriteBgapi(3, 0, status, sizeof(status));
+}
+
+
+/***************************************************************************//**
+ * @brief Terminates the connection.
+ *
+ * @param[in] reason HCI reason of the disconnection.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void SD_Disconnect(uint8_t reason)
+{
+    ble_evt_t event;
+    uint8_t payload[3] = { SD_CONN_HANDLE, reason, 0x02 };
+
+    if (!isConnected) {
+        return;
+    }
+    isConnected = false;
+    nextConnEvent = SIM_TIME_NEVER;
+    txCount = 0;
+    isStreamEnabled = false;
+    for (uint32_t i = 0; i < numberOfAttributes; i++) {
+        if (attributes[i].Type == BLE_GATTS_ATTR_TYPE_DESC) {
+            memset(attributes[i].Value, 0, 2);
+        }
+    }
+
+    memset(&event, 0, sizeof(event));
+    event.header.evt_id = BLE_GAP_EVT_DISCONNECTED;
+    event.header.evt_len = sizeof(ble_gap_evt_t);
+    event.evt.gap_evt.conn_handle = SD_CONN_HANDLE;
+    event.evt.gap_evt.params.disconnected.reason = reason;
+    SD_PushBleEvent(&event, sizeof(ble_evt_hdr_t) + sizeof(ble_gap_evt_t));
+
+    SD_WriteBgapi(3, 4, payload, sizeof(payload));
+}
+
+
+/***************************************************************************//**
+ * @brief Transmits the buffered packets of a connection event.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void SD_ConnectionEvent(void)
+{
+    ble_evt_t event;
+    uint32_t sent = 0;
+
+    gSimStats.ConnectionEvents++;
+    SIM_SampleFifos();
+    if (isRadioNotification) {
+        SWI1_IRQHandler();
+    }
+
+    if (isIndicationSent) {
+        isIndicationSent = false;
+        memset(&event, 0, sizeof(event));
+        event.header.evt_id = BLE_GATTS_EVT_HVC;
+        event.header.evt_len = sizeof(ble_gatts_evt_t);
+        event.evt.gatts_evt.conn_handle = SD_CONN_HANDLE;
+        event.evt.gatts_evt.params.hvc.handle = indicationHandle;
+        SD_PushBleEvent(&event, sizeof(ble_evt_hdr_t) + sizeof(ble_gatts_evt_t));
+    }
+
+    if (isIndicationPending) {
+        isIndicationPending = false;
+        isIndicationSent = true;
+        sent++;
+    }
+
+    while ((txCount > 0) && (sent < gSimConfig.PacketsPerEvent)) {
+        uint8_t payload[4 + 1 + SD_PACKET_SIZE];
+        uint8_t length = txLength[txHead];
+
+        payload[0] = SD_CONN_HANDLE;
+        payload[1] = txHandle[txHead] & 0xFF;
+        payload[2] = txHandle[txHead] >> 8;
+        payload[3] = BLE_GATT_HVX_NOTIFICATION;
+        payload[4] = length;
+        memcpy(&payload[5], txPackets[txHead], length);
+        SD_WriteBgapi(4, 5, payload, 5 + length);
+
+        SD_CountPacket(txPackets[txHead], length);
+        txHead = (txHead + 1) % SD_MAX_TX_BUFFERS;
+        txCount--;
+        sent++;
+    }
+
+    if (sent == gSimConfig.PacketsPerEvent) {
+        gSimStats.FullEvents++;
+    } else if ((sent == 0) && isStreamEnabled) {
+        gSimStats.EmptyEvents++;
+    }
+
+    if ((sent > 0) && !isIndicationSent) {
+        memset(&event, 0, sizeof(event));
+        event.header.evt_id = BLE_EVT_TX_COMPLETE;
+        event.header.evt_len = sizeof(ble_common_evt_t);
+        event.evt.common_evt.conn_handle = SD_CONN_HANDLE;
+        event.evt.common_evt.params.tx_complete.count = sent;
+        SD_PushBleEvent(&event, sizeof(ble_evt_hdr_t) + sizeof(ble_common_evt_t));
+    }
+
+    if ((gSimConfig.AckInterval > 0) &&
+        ((unackedPackets > 0) || (reorderMask != 0)) &&
+        (++ackAge >= SD_ACK_TIMEOUT_EVENTS)) {
+        /* A retransmission or the packets after the last one received got lost. */
+        SD_GatewayAck(true);
+    }
+    if (isStreamEnabled && !isSyncRunning && (gSimNow >= nextSync)) {
+        SD_GatewaySync(NULL);
+    }
+    SD_GatewayStep();
+    SD_CheckClock();
+    lastEventTime = gSimNow;
+
+    if (isRadioNotification) {
+        SWI1_IRQHandler();
+        SIM_Wakeup();
+    }
+}
+
+
+/***************************************************************************//**
+ * @brief Sends the next write request of the gateway.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void SD_GatewayStep(void)
+{
+    struct SD_GatewayWrite *write;
+    struct SD_Attribute *attribute;
+    ble_evt_t *event;
+    uint8_t buffer[SD_EVT_SIZE];
+    uint16_t handle;
+
+    if (isSnapshotRead) {
+        SD_GatewayReadSnapshot();
+        return;
+    }
+
+    /* Skip the characteristics that do not exist. */
+    for (;;) {
+        if (gatewayStep < numberOfGatewayWrites) {
+            write = &gatewayWrites[gatewayStep++];
+        } else if (isAckPending) {
+            SD_BuildAck();
+            write = &ackWrite;
+            isAckPending = false;
+            gSimStats.Acks++;
+        } else if (isSyncPending) {
+            write = &syncWrite;
+            isSyncPending = false;
+            if (write->Value[0] == APPL_CONTROL_OP_SYNC) {
+                /* The gateway wrote its time right after the previous event. */
+                uint32_t time = SD_GatewayTime(lastEventTime);
+                memcpy(&write->Value[1], &time, sizeof(time));
+            }
+        } else {
+            return;
+        }
+        attribute = SD_FindCharacteristic(write->Uuid);
+        if ((attribute != NULL) &&
+            (!write->IsCccd || (attribute->CccdHandle != BLE_GATT_HANDLE_INVALID))) {
+            break;
+        }
+    }
+
+    handle = write->IsCccd ? attribute->CccdHandle : attribute->ValueHandle;
+    if (write->IsCccd) {
+        if (write->Uuid == TXW51_SERV_MEASURE_UUID_CHAR_DATASTRAM) {
+            isStreamEnabled = (write->Value[0] != 0);
+        }
+        attribute = SD_FindAttribute(handle);
+    }
+    memcpy(attribute->Value, write->Value, write->Length);
+    attribute->Length = write->Length;
+
+    memset(buffer, 0, sizeof(buffer));
+    event = (ble_evt_t *)buffer;
+    event->header.evt_id = BLE_GATTS_EVT_WRITE;
+    event->header.evt_len = sizeof(ble_gatts_evt_t) + write->Length;
+    event->evt.gatts_evt.conn_handle = SD_CONN_HANDLE;
+    event->evt.gatts_evt.params.write.handle = handle;
+    event->evt.gatts_evt.params.write.op = write->Op;
+    event->evt.gatts_evt.params.write.context.srvc_handle = attribute->ServiceHandle;
+    event->evt.gatts_evt.params.write.context.value_handle = attribute->ValueHandle;
+    event->evt.gatts_evt.params.write.context.type = attribute->Type;
+    event->evt.gatts_evt.params.write.context.char_uuid.uuid = write->Uuid;
+    event->evt.gatts_evt.params.write.len = write->Length;
+    memcpy(event->evt.gatts_evt.params.write.data, attribute->Value, write->Length);
+    SD_PushBleEvent(event, sizeof(ble_evt_hdr_t) + event->header.evt_len);
+}
+
+
+/***************************************************************************//**
+ * @brief Sends the next read of the snapshot, like the agent does with a long
+ *        read before it starts the measurement.
+ *
+ * The device authorizes every read, the response is taken in
+ * sd_ble_gatts_rw_authorize_reply().
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void SD_GatewayReadSnapshot(void)
+{
+    struct SD_Attribute *attribute = SD_FindCharacteristic(TXW51_SERV_DIS_UUID_CHAR_SNAPSHOT);
+    ble_gatts_evt_read_t *read;
+    ble_evt_t event;
+
+    if (attribute == NULL) {
+        isSnapshotRead = false;
+        SD_GatewayStep();
+        return;
+    }
+
+    memset(&event, 0, sizeof(event));
+    event.header.evt_id = BLE_GATTS_EVT_RW_AUTHORIZE_REQUEST;
+    event.header.evt_len = sizeof(ble_gatts_evt_t);
+    event.evt.gatts_evt.conn_handle = SD_CONN_HANDLE;
+    event.evt.gatts_evt.params.authorize_request.type = BLE_GATTS_AUTHORIZE_TYPE_READ;
+    read = &event.evt.gatts_evt.params.authorize_request.request.read;
+    read->handle = attribute->ValueHandle;
+    read->context.srvc_handle = attribute->ServiceHandle;
+    read->context.value_handle = attribute->ValueHandle;
+    read->context.type = attribute->Type;
+    read->context.char_uuid.uuid = attribute->Uuid;
+    read->offset = snapshotOffset;
+    SD_PushBleEvent(&event, sizeof(ble_evt_hdr_t) + sizeof(ble_gatts_evt_t));
+    gSimStats.SnapshotReads++;
+}
+
+
+/***************************************************************************//**
+ * @brief Checks the snapshot read by the gateway, see app/device_info.h.
+ *
+ * @param[in] snapshot The snapshot.
+ * @param[in] length   Length of the snapshot.
+ *
+ * @return True if the version is known and the strings end with the snapshot.
+ ******************************************************************************/
+static bool SD_CheckSnapshot(const uint8_t *snapshot, uint16_t length)
+{
+    uint16_t offset = 13;
+
+    if ((length < offset) || (snapshot[0] != APPL_DEVINFO_SNAPSHOT_VERSION)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < SD_SNAPSHOT_STRINGS; i++) {
+        if (offset >= length) {
+            return false;
+        }
+        offset += 1 + snapshot[offset];
+    }
+    return (offset == length);
+}
+
+
+/***************************************************************************//**
+ * @brief Queues an acknowledgement of the reliable mode for the next
+ *        connection event.
+ *
+ * It is built when it is sent, a pending acknowledgement is not repeated.
+ *
+ * @param[in] isRepeat List the missing packets again that have been listed
+ *                     before, and the next packet in order.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void SD_GatewayAck(bool isRepeat)
+{
+    isAckPending = true;
+    isAckRepeat = isAckRepeat || isRepeat;
+    unackedPackets = 0;
+    ackAge = 0;
+}
+
+
+/***************************************************************************//**
+ * @brief Builds the pending acknowledgement, see app/control.h.
+ *
+ * Next is the first packet that is missing. The missing packets before the
+ * last one received follow, a packet that has been listed before only in a
+ * repeat.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void SD_BuildAck(void)
+{
+    uint8_t last = 0;
+    uint8_t length = APPL_CONTROL_ACK_LENGTH;
+
+    for (uint8_t offset = 0; offset < SD_REORDER_SIZE; offset++) {
+        if (reorderMask & SD_REORDER_BIT(expectedSequence + offset)) {
+            last = offset;
+        }
+    }
+
+    ackWrite.Uuid = TXW51_SERV_MEASURE_UUID_CHAR_CONTROL;
+    ackWrite.IsCccd = false;
+    ackWrite.Op = BLE_GATTS_OP_WRITE_CMD;
+    ackWrite.Value[0] = APPL_CONTROL_OP_ACK;
+    ackWrite.Value[1] = expectedSequence;
+
+    for (uint8_t offset = 0; (offset < last) || (isAckRepeat && (offset == 0)); offset++) {
+        uint8_t number = expectedSequence + offset;
+        uint32_t bit = SD_REORDER_BIT(number);
+
+        if (length == APPL_CONTROL_ACK_LENGTH + APPL_CONTROL_MAX_MISSING) {
+            break;
+        }
+        if (!(reorderMask & bit) && (isAckRepeat || !(requestedMask & bit))) {
+            ackWrite.Value[length++] = number;
+            requestedMask |= bit;
+            gSimStats.RequestedPackets++;
+        }
+    }
+    ackWrite.Length = length;
+    isAckRepeat = false;
+}
+
+
+/***************************************************************************//**
+ * @brief Queues the next write of a clock exchange for the next connection
+ *        event.
+ *
+ * The gateway takes the middle of the round trip as its time at the device
+ * time of the answer, like the agent.
+ *
+ * @param[in] data The answer of the device to the previous write, NULL to
+ *                 start an exchange.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void SD_GatewaySync(const uint8_t *data)
+{
+    uint32_t now = SD_GatewayTime(gSimNow);
+    uint32_t sent;
+    uint16_t roundTrip;
+    uint32_t gatewayTime;
+
+    syncWrite.Uuid = TXW51_SERV_MEASURE_UUID_CHAR_CONTROL;
+    syncWrite.IsCccd = false;
+    syncWrite.Op = BLE_GATTS_OP_WRITE_CMD;
+    isSyncPending = true;
+
+    if (data == NULL) {
+        /* The time is set when the write is sent. */
+        syncWrite.Value[0] = APPL_CONTROL_OP_SYNC;
+        syncWrite.Length = APPL_CONTROL_SYNC_LENGTH;
+        isSyncRunning = true;
+        nextSync = SD_GetSyncTime();
+        return;
+    }
+
+    memcpy(&sent, &data[1], sizeof(sent));
+    roundTrip = (uint16_t)(now - sent);
+    gatewayTime = sent + roundTrip / 2;
+    gSimStats.SyncExchanges++;
+
+    syncWrite.Value[0] = APPL_CONTROL_OP_TIME;
+    memcpy(&syncWrite.Value[1], &data[5], 4);
+    memcpy(&syncWrite.Value[5], &gatewayTime, sizeof(gatewayTime));
+    memcpy(&syncWrite.Value[9], &roundTrip, sizeof(roundTrip));
+    syncWrite.Length = APPL_CONTROL_TIME_LENGTH;
+}
+
+
+/***************************************************************************//**
+ * @brief Computes the start of the next clock exchange.
+ *
+ * @return The simulated time in ns.
+ ******************************************************************************/
+static uint64_t SD_GetSyncTime(void)
+{
+    syncRandom = syncRandom * 1103515245 + 12345;
+
+    return gSimNow + gSimConfig.SyncInterval +
+           gSimConfig.SyncInterval / SD_SYNC_JITTER * ((syncRandom >> 8) % 1024) / 1024;
+}
+
+
+/***************************************************************************//**
+ * @brief Checks the device time mapped to the gateway clock against the true
+ *        time of the current RTC1 tick.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void SD_CheckClock(void)
+{
+    double time = SIM_TIMER_TickCenter() / SIM_NS_PER_MS;
+    uint32_t mapped;
+    double error;
+
+    if ((gSimStats.SyncAccepted < SD_SYNC_SETTLE) ||
+        (gSimNow < firstSync + SD_SYNC_SETTLE_TIME) ||
+        !APPL_CLOCK_ToGatewayTime(APPL_CLOCK_GetTime(), &mapped)) {
+        return;
+    }
+
+    error = fabs((int32_t)(mapped - (uint32_t)(SD_GATEWAY_EPOCH_MS + (uint64_t)time)) -
+                 (time - floor(time)));
+    gSimStats.ClockChecks++;
+    gSimStats.ClockErrorSum += error;
+    if (error > gSimStats.ClockErrorMax) {
+        gSimStats.ClockErrorMax = error;
+    }
+}
+
+
+/***************************************************************************//**
+ * @brief Returns the gateway clock.
+ *
+ * @param[in] time The simulated time in ns.
+ *
+ * @return The gateway clock in ms.
+ ******************************************************************************/
+static uint32_t SD_GatewayTime(uint64_t time)
+{
+    return (uint32_t)(SD_GATEWAY_EPOCH_MS + time / SIM_NS_PER_MS);
+}
+
+
+/***************************************************************************//**
+ * @brief Receives a data packet in the reliable mode.
+ *
+ * Packets behind a gap are kept and delivered in order when the gap has been
+ * filled. A new gap is acknowledged right away with its missing packets.
+ *
+ * @param[in] data The packet.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void SD_ReceiveReliable(const uint8_t *data)
+{
+    uint8_t sequence = data[1];
+    uint8_t offset = sequence - expectedSequence;
+    bool isNewGap = false;
+
+    if ((offset >= SD_REORDER_SIZE) || (reorderMask & SD_REORDER_BIT(sequence))) {
+        /* Delivered or kept already, a retransmission that was not needed. */
+        gSimStats.DiscardedPackets++;
+        return;
+    }
+    requestedMask &= ~SD_REORDER_BIT(sequence);
+
+    if (offset > 0) {
+        memcpy(reorder[sequence % SD_REORDER_SIZE], data, SD_PACKET_SIZE);
+        reorderMask |= SD_REORDER_BIT(sequence);
+        for (uint8_t number = expectedSequence; number != sequence; number++) {
+            if (!(reorderMask & SD_REORDER_BIT(number)) && !(requestedMask & SD_REORDER_BIT(number))) {
+                isNewGap = true;
+            }
+        }
+        if (isNewGap) {
+            SD_GatewayAck(false);
+        }
+        return;
+    }
+
+    SD_DeliverPacket(data);
+    expectedSequence++;
+    unackedPackets++;
+    while (reorderMask & SD_REORDER_BIT(expectedSequence)) {
+        reorderMask &= ~SD_REORDER_BIT(expectedSequence);
+        SD_DeliverPacket(reorder[expectedSequence % SD_REORDER_SIZE]);
+        expectedSequence++;
+        unackedPackets++;
+    }
+
+    ackAge = 0;
+    if (unackedPackets >= gSimConfig.AckInterval) {
+        SD_GatewayAck(false);
+    }
+}
+
+
+/***************************************************************************//**
+ * @brief Counts a received data stream packet like the gateway.
+ *
+ * @param[in] data   The packet.
+ * @param[in] length The length of the packet.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void SD_CountPacket(const uint8_t *data, uint16_t length)
+{
+    struct SD_Attribute *stream = SD_FindCharacteristic(TXW51_SERV_MEASURE_UUID_CHAR_DATASTRAM);
+    struct SD_Attribute *control = SD_FindCharacteristic(TXW51_SERV_MEASURE_UUID_CHAR_CONTROL);
+
+    if ((control != NULL) && (txHandle[txHead] == control->ValueHandle) &&
+        (length == APPL_CONTROL_SYNC_ANSWER_LENGTH)) {
+        SD_GatewaySync(data);
+        return;
+    }
+    if ((control != NULL) && (txHandle[txHead] == control->ValueHandle) &&
+        (length == APPL_CONTROL_STATUS_LENGTH) && (data[0] == APPL_CONTROL_OP_TIME)) {
+        if (data[1] == APPL_CONTROL_STATUS_SUCCESS) {
+            if (gSimStats.SyncAccepted == 0) {
+                firstSync = gSimNow;
+            }
+            gSimStats.SyncAccepted++;
+        } else {
+            gSimStats.SyncRejected++;
+        }
+        isSyncRunning = false;
+        return;
+    }
+    if ((control != NULL) && (txHandle[txHead] == control->ValueHandle) &&
+        (length == APPL_CONTROL_STATUS_LENGTH)) {
+        gSimStats.ControlStatuses++;
+        gSimStats.ControlStatus = data[1];
+        return;
+    }
+
+    gSimStats.Notifications++;
+    if (gSimStats.Notifications == 1) {
+        gSimStats.StreamStart = gSimNow;
+    }
+    gSimStats.StreamEnd = gSimNow;
+
+    if ((stream == NULL) || (txHandle[txHead] != stream->ValueHandle) || (length < 2)) {
+        return;
+    }
+
+    if ((gSimConfig.LossInterval > 0) && (++dataPackets % gSimConfig.LossInterval == 0)) {
+        gSimStats.LostPackets++;
+        return;
+    }
+    if (gSimConfig.AckInterval > 0) {
+        SD_ReceiveReliable(data);
+        return;
+    }
+    SD_DeliverPacket(data);
+}
+
+
+/***************************************************************************//**
+ * @brief Delivers a data stream packet of the gateway in order.
+ *
+ * @param[in] data The packet.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void SD_DeliverPacket(const uint8_t *data)
+{
+    uint8_t samples;
+
+    samples = data[0] & 0x0F;
+    if ((samples == 0) && ((data[0] & 0x70) != 0)) {
+        /* Samples of a registered sensor driver, see app/driver.h. */
+        gSimStats.NotifiedSamplesDrivers += data[2];
+    } else if (samples == 0) {
+        gSimStats.Discontinuities[(data[0] & 0x80) ? 1 : 0] += data[2];
+    }
+    gSimStats.NotifiedSamples += samples;
+    if (data[0] & 0x80) {
+        gSimStats.NotifiedSamplesGyro += samples;
+    } else {
+        gSimStats.NotifiedSamplesAcc += samples;
+    }
+    SIM_LSM330_Deliver((data[0] & 0x80) ? 1 : 0, samples);
+
+    if (hasSequence) {
+        gSimStats.SequenceGaps += (uint8_t)(data[1] - lastSequence - 1);
+    }
+    lastSequence = data[1];
+    hasSequence = true;
+}
+
+
+/***************************************************************************//**
+ * @brief Writes an event of the BLED112 to the BGAPI output.
+ *
+ * @param[in] class   Class of the event.
+ * @param[in] id      ID of the event.
+ * @param[in] payload Payload of the event.
+ * @param[in] length  Length of the payload.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void SD_WriteBgapi(uint8_t class, uint8_t id, const uint8_t *payload, uint8_t length)
+{
+    uint8_t header[4] = { 0x80, length, class, id };
+
+    if (gSimConfig.Bgapi == NULL) {
+        return;
+    }
+    fwrite(header, 1, sizeof(header), gSimConfig.Bgapi);
+    fwrite(payload, 1, length, gSimConfig.Bgapi);
+}
+
+
+uint32_t sd_softdevice_enable(nrf_clock_lfclksrc_t clock_source,
+                              softdevice_assertion_handler_t assertion_handler)
+{
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_softdevice_disable(void)
+{
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_softdevice_is_enabled(uint8_t *p_softdevice_enabled)
+{
+    *p_softdevice_enabled = 1;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_nvic_EnableIRQ(IRQn_Type IRQn)
+{
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_nvic_DisableIRQ(IRQn_Type IRQn)
+{
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_nvic_GetPendingIRQ(IRQn_Type IRQn, uint32_t *p_pending_irq)
+{
+    *p_pending_irq = 0;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_nvic_SetPendingIRQ(IRQn_Type IRQn)
+{
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_nvic_ClearPendingIRQ(IRQn_Type IRQn)
+{
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_nvic_SetPriority(IRQn_Type IRQn, nrf_app_irq_priority_t priority)
+{
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_nvic_GetPriority(IRQn_Type IRQn, nrf_app_irq_priority_t *p_priority)
+{
+    *p_priority = NRF_APP_PRIORITY_LOW;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_nvic_SystemReset(void)
+{
+    SIM_Exit("system reset", 0);
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_nvic_critical_region_enter(uint8_t *p_is_nested_critical_region)
+{
+    *p_is_nested_critical_region = (uint8_t)gSimPrimask;
+    gSimPrimask = 1;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_nvic_critical_region_exit(uint8_t is_nested_critical_region)
+{
+    gSimPrimask = is_nested_critical_region;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_radio_notification_cfg_set(nrf_radio_notification_type_t type,
+                                       nrf_radio_notification_distance_t distance)
+{
+    /* Both signals are needed, ble_radio_notification.c toggles its state. */
+    isRadioNotification = (type == NRF_RADIO_NOTIFICATION_TYPE_INT_ON_BOTH);
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_power_system_off(void)
+{
+    SIM_Exit("system off", 0);
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_clock_hfclk_request(void)
+{
+    hfclkRequests = 1;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_clock_hfclk_release(void)
+{
+    hfclkRequests = 0;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_clock_hfclk_is_running(uint32_t *p_is_running)
+{
+    *p_is_running = hfclkRequests;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_temp_get(int32_t *p_temp)
+{
+    *p_temp = SD_DIE_TEMP;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_evt_get(uint32_t *p_evt_id)
+{
+    if (socCount == 0) {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    *p_evt_id = socQueue[socHead];
+    socHead = (socHead + 1) % SD_SOC_QUEUE_SIZE;
+    socCount--;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_flash_write(uint32_t * const p_dst, uint32_t const * const p_src, uint32_t size)
+{
+    if (flash.IsPending) {
+        return NRF_ERROR_BUSY;
+    }
+    if ((((uintptr_t)p_dst | (uintptr_t)p_src) & 0x03) != 0) {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+    if ((size == 0) || (size > NRF_FICR->CODEPAGESIZE / 4)) {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+
+    flash.IsPending = true;
+    flash.IsErase = false;
+    flash.Destination = p_dst;
+    flash.Source = p_src;
+    flash.Size = size;
+    flash.End = gSimNow + size * SD_FLASH_WORD_TIME;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_flash_page_erase(uint32_t page_number)
+{
+    if (flash.IsPending) {
+        return NRF_ERROR_BUSY;
+    }
+    if ((page_number == 0) || (page_number >= NRF_FICR->CODESIZE)) {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    flash.IsPending = true;
+    flash.IsErase = true;
+    flash.Destination = (uint32_t *)(uintptr_t)(page_number * NRF_FICR->CODEPAGESIZE);
+    flash.End = gSimNow + SD_FLASH_ERASE_TIME;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_enable(ble_enable_params_t *p_ble_enable_params)
+{
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_evt_get(uint8_t *p_dest, uint16_t *p_len)
+{
+    if (bleCount == 0) {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    if (*p_len < bleLength[bleHead]) {
+        *p_len = bleLength[bleHead];
+        return NRF_ERROR_DATA_SIZE;
+    }
+
+    memcpy(p_dest, bleQueue[bleHead], bleLength[bleHead]);
+    *p_len = bleLength[bleHead];
+    bleHead = (bleHead + 1) % SD_BLE_QUEUE_SIZE;
+    bleCount--;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_tx_buffer_count_get(uint8_t *p_count)
+{
+    *p_count = gSimConfig.TxBuffers;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_uuid_vs_add(ble_uuid128_t const * const p_vs_uuid, uint8_t * const p_uuid_type)
+{
+    for (uint8_t i = 0; i < numberOfVsUuids; i++) {
+        if (memcmp(&vsUuids[i], p_vs_uuid, sizeof(*p_vs_uuid)) == 0) {
+            *p_uuid_type = BLE_UUID_TYPE_VENDOR_BEGIN + i;
+            return NRF_SUCCESS;
+        }
+    }
+    if (numberOfVsUuids >= BLE_UUID_VS_MAX_COUNT) {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    vsUuids[numberOfVsUuids] = *p_vs_uuid;
+    *p_uuid_type = BLE_UUID_TYPE_VENDOR_BEGIN + numberOfVsUuids;
+    numberOfVsUuids++;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_uuid_encode(ble_uuid_t const * const p_uuid,
+                            uint8_t * const p_uuid_le_len,
+                            uint8_t * const p_uuid_le)
+{
+    if (p_uuid->type == BLE_UUID_TYPE_BLE) {
+        *p_uuid_le_len = 2;
+        if (p_uuid_le != NULL) {
+            p_uuid_le[0] = p_uuid->uuid & 0xFF;
+            p_uuid_le[1] = p_uuid->uuid >> 8;
+        }
+        return NRF_SUCCESS;
+    }
+
+    if ((p_uuid->type < BLE_UUID_TYPE_VENDOR_BEGIN) ||
+        (p_uuid->type >= BLE_UUID_TYPE_VENDOR_BEGIN + numberOfVsUuids)) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    *p_uuid_le_len = 16;
+    if (p_uuid_le != NULL) {
+        memcpy(p_uuid_le, vsUuids[p_uuid->type - BLE_UUID_TYPE_VENDOR_BEGIN].uuid128, 16);
+        p_uuid_le[12] = p_uuid->uuid & 0xFF;
+        p_uuid_le[13] = p_uuid->uuid >> 8;
+    }
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gap_adv_data_set(uint8_t const * const p_data, uint8_t dlen,
+                                 uint8_t const * const p_sr_data, uint8_t srdlen)
+{
+    if ((dlen > BLE_GAP_ADV_MAX_SIZE) || (srdlen > BLE_GAP_ADV_MAX_SIZE)) {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+    gSimStats.AdvDataUpdates++;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gap_adv_start(ble_gap_adv_params_t const * const p_adv_params)
+{
+    if (isAdvertising || isConnected) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    isAdvertising = true;
+    connectTime = (gSimConfig.ConnectAt == SIM_TIME_NEVER) ?
+                  SIM_TIME_NEVER : gSimNow + gSimConfig.ConnectAt;
+    advTimeout = (p_adv_params->timeout == 0) ?
+                 SIM_TIME_NEVER : gSimNow + p_adv_params->timeout * SIM_NS_PER_S;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gap_adv_stop(void)
+{
+    if (!isAdvertising) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    isAdvertising = false;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gap_disconnect(uint16_t conn_handle, uint8_t hci_status_code)
+{
+    if (!isConnected || (conn_handle != SD_CONN_HANDLE)) {
+        return BLE_ERROR_INVALID_CONN_HANDLE;
+    }
+    isDisconnectRequested = true;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gap_appearance_set(uint16_t appearance)
+{
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gap_appearance_get(uint16_t * const p_appearance)
+{
+    *p_appearance = 0;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gap_ppcp_set(ble_gap_conn_params_t const * const p_conn_params)
+{
+    return NRF_SUCCESS;
+}
+
+
+static uint8_t deviceName[BLE_GAP_DEVNAME_MAX_LEN];    /**< Name set by the application. */
+static uint16_t deviceNameLength = 0;                   /**< Length of deviceName. */
+
+uint32_t sd_ble_gap_device_name_set(ble_gap_conn_sec_mode_t const * const p_write_perm,
+                                    uint8_t const * const p_dev_name, uint16_t len)
+{
+    if (len > BLE_GAP_DEVNAME_MAX_LEN) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    memcpy(deviceName, p_dev_name, len);
+    deviceNameLength = len;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gap_device_name_get(uint8_t * const p_dev_name, uint16_t * const p_len)
+{
+    if (*p_len < deviceNameLength) {
+        return NRF_ERROR_DATA_SIZE;
+    }
+    if (p_dev_name != NULL) {
+        memcpy(p_dev_name, deviceName, deviceNameLength);
+    }
+    *p_len = deviceNameLength;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gap_sec_params_reply(uint16_t conn_handle, uint8_t sec_status,
+                                     ble_gap_sec_params_t const * const p_sec_params)
+{
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gap_sec_info_reply(uint16_t conn_handle,
+                                   ble_gap_enc_info_t const * const p_enc_info,
+                                   ble_gap_sign_info_t const * const p_sign_info)
+{
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gatts_service_add(uint8_t type, ble_uuid_t const * const p_uuid,
+                                  uint16_t * const p_handle)
+{
+    uint32_t err = SD_AllocateAttribute(2);
+
+    if (err != NRF_SUCCESS) {
+        return err;
+    }
+    *p_handle = nextHandle++;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gatts_characteristic_add(uint16_t service_handle,
+                                         ble_gatts_char_md_t const * const p_char_md,
+                                         ble_gatts_attr_t const * const p_attr_char_value,
+                                         ble_gatts_char_handles_t * const p_handles)
+{
+    struct SD_Attribute *value;
+    bool hasCccd = p_char_md->char_props.notify || p_char_md->char_props.indicate;
+    const ble_gatts_attr_md_t *valueMetadata = p_attr_char_value->p_attr_md;
+    uint16_t valueSize = 0;
+    uint32_t used = gSimStats.AttrTableUsed;
+    uint32_t count = gSimStats.Attributes;
+    uint32_t err;
+
+    if (numberOfAttributes + 2 > SD_MAX_ATTRIBUTES) {
+        return NRF_ERROR_NO_MEM;
+    }
+    if (p_attr_char_value->max_len > BLE_GATTS_VAR_ATTR_LEN_MAX) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    /* Declaration with properties, value handle and UUID, then the value, which
+       takes its maximum length in the table if the stack holds it. */
+    if (valueMetadata->vloc == BLE_GATTS_VLOC_STACK) {
+        valueSize = p_attr_char_value->max_len + (valueMetadata->vlen ? 2 : 0);
+    }
+    err = SD_AllocateAttribute(5);
+    if (err == NRF_SUCCESS) {
+        err = SD_AllocateAttribute(valueSize);
+    }
+    if ((err == NRF_SUCCESS) && hasCccd) {
+        err = SD_AllocateAttribute(2);
+    }
+    if ((err == NRF_SUCCESS) && (p_char_md->p_char_user_desc != NULL)) {
+        err = SD_AllocateAttribute(p_char_md->char_user_desc_max_size);
+    }
+    if ((err == NRF_SUCCESS) && (p_char_md->p_char_pf != NULL)) {
+        err = SD_AllocateAttribute(7);
+    }
+    if (err != NRF_SUCCESS) {
+        /* A rejected characteristic takes nothing. */
+        gSimStats.AttrTableUsed = used;
+        gSimStats.Attributes = count;
+        return err;
+    }
+
+    /* Characteristic declaration. */
+    nextHandle++;
+
+    value = &attributes[numberOfAttributes++];
+    memset(value, 0, sizeof(*value));
+    value->Handle = nextHandle++;
+    value->Uuid = p_attr_char_value->p_uuid->uuid;
+    value->Type = BLE_GATTS_ATTR_TYPE_CHAR_VAL;
+    value->ServiceHandle = service_handle;
+    value->ValueHandle = value->Handle;
+    value->CccdHandle = BLE_GATT_HANDLE_INVALID;
+    value->MaxLength = p_attr_char_value->max_len;
+    if (valueMetadata->vloc == BLE_GATTS_VLOC_USER) {
+        value->UserValue = p_attr_char_value->p_value;
+        value->Length = p_attr_char_value->init_len;
+    } else {
+        value->Length = (p_attr_char_value->init_len < SD_MAX_VALUE) ? p_attr_char_value->init_len : SD_MAX_VALUE;
+        if (p_attr_char_value->p_value != NULL) {
+            memcpy(value->Value, p_attr_char_value->p_value, value->Length);
+        }
+    }
+
+    p_handles->value_handle = value->Handle;
+    p_handles->cccd_handle = BLE_GATT_HANDLE_INVALID;
+    p_handles->user_desc_handle = BLE_GATT_HANDLE_INVALID;
+    p_handles->sccd_handle = BLE_GATT_HANDLE_INVALID;
+
+    if (hasCccd) {
+        struct SD_Attribute *cccd = &attributes[numberOfAttributes++];
+        memset(cccd, 0, sizeof(*cccd));
+        cccd->Handle = nextHandle++;
+        cccd->Uuid = value->Uuid;
+        cccd->Type = BLE_GATTS_ATTR_TYPE_DESC;
+        cccd->ServiceHandle = service_handle;
+        cccd->ValueHandle = value->Handle;
+        cccd->CccdHandle = cccd->Handle;
+        cccd->Length = 2;
+        value->CccdHandle = cccd->Handle;
+        p_handles->cccd_handle = cccd->Handle;
+    }
+
+    if (p_char_md->p_char_user_desc != NULL) {
+        p_handles->user_desc_handle = nextHandle++;
+    }
+    if (p_char_md->p_char_pf != NULL) {
+        nextHandle++;
+    }
+    return NRF_SUCCESS;
+}
+
+
+/***************************************************************************//**
+ * @brief Takes an attribute from the attribute table of the stack.
+ *
+ * The S110 7.x has a table of fixed size for all attributes of the
+ * application. Every attribute takes an entry and its value, rounded up to
+ * words. UUIDs are kept as 16 bit value and the index of their base, like
+ * ble_uuid_t, so declarations take the same space for vendor specific UUIDs.
+ *
+ * @param[in] valueSize Bytes of the value held by the stack, 0 if none.
+ *
+ * @return NRF_SUCCESS or NRF_ERROR_NO_MEM if the table is full.
+ ******************************************************************************/
+static uint32_t SD_AllocateAttribute(uint16_t valueSize)
+{
+    uint32_t size = SD_ATTR_ENTRY_SIZE + ((valueSize + 3) & ~3U);
+
+    gSimStats.AttrTableSize = SD_ATTR_TAB_SIZE;
+    if (gSimStats.AttrTableUsed + size > SD_ATTR_TAB_SIZE) {
+        return NRF_ERROR_NO_MEM;
+    }
+    gSimStats.AttrTableUsed += size;
+    gSimStats.Attributes++;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gatts_value_set(uint16_t handle, uint16_t offset,
+                                uint16_t * const p_len, uint8_t const * const p_value)
+{
+    struct SD_Attribute *attribute = SD_FindAttribute(handle);
+
+    if (attribute == NULL) {
+        /* User descriptions and other attributes that are not modelled. */
+        return NRF_SUCCESS;
+    }
+    if (offset + *p_len > SD_MAX_VALUE) {
+        *p_len = (offset < SD_MAX_VALUE) ? SD_MAX_VALUE - offset : 0;
+    }
+    if (p_value != NULL) {
+        memcpy(&attribute->Value[offset], p_value, *p_len);
+    }
+    attribute->Length = offset + *p_len;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gatts_hvx(uint16_t conn_handle, ble_gatts_hvx_params_t const * const p_hvx_params)
+{
+    struct SD_Attribute *attribute;
+    struct SD_Attribute *cccd;
+    uint16_t length;
+
+    if (!isConnected || (conn_handle != SD_CONN_HANDLE)) {
+        gSimStats.HvxOtherErrors++;
+        return BLE_ERROR_INVALID_CONN_HANDLE;
+    }
+
+    attribute = SD_FindAttribute(p_hvx_params->handle);
+    if ((attribute == NULL) || (attribute->Type != BLE_GATTS_ATTR_TYPE_CHAR_VAL) ||
+        (attribute->CccdHandle == BLE_GATT_HANDLE_INVALID)) {
+        gSimStats.HvxOtherErrors++;
+        return BLE_ERROR_INVALID_ATTR_HANDLE;
+    }
+
+    cccd = SD_FindAttribute(attribute->CccdHandle);
+    if (!(cccd->Value[0] & p_hvx_params->type)) {
+        gSimStats.HvxOtherErrors++;
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    length = (p_hvx_params->p_len != NULL) ? *p_hvx_params->p_len : attribute->Length;
+    if (length > SD_PACKET_SIZE) {
+        length = SD_PACKET_SIZE;
+    }
+
+    if (p_hvx_params->type == BLE_GATT_HVX_INDICATION) {
+        if (isIndicationPending || isIndicationSent) {
+            gSimStats.HvxOtherErrors++;
+            return NRF_ERROR_BUSY;
+        }
+        isIndicationPending = true;
+        indicationHandle = p_hvx_params->handle;
+    } else {
+        uint32_t index;
+        if (txCount >= gSimConfig.TxBuffers) {
+            gSimStats.HvxNoBuffers++;
+            return BLE_ERROR_NO_TX_BUFFERS;
+        }
+        index = (txHead + txCount) % SD_MAX_TX_BUFFERS;
+        memcpy(txPackets[index],
+               (p_hvx_params->p_data != NULL) ? p_hvx_params->p_data : attribute->Value,
+               length);
+        txLength[index] = length;
+        txHandle[index] = p_hvx_params->handle;
+        txCount++;
+    }
+
+    if (p_hvx_params->p_data != NULL) {
+        memcpy(attribute->Value, p_hvx_params->p_data, length);
+        attribute->Length = length;
+    }
+    if (p_hvx_params->p_len != NULL) {
+        *p_hvx_params->p_len = length;
+    }
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gatts_rw_authorize_reply(uint16_t conn_handle,
+                                         ble_gatts_rw_authorize_reply_params_t const * const p_rw_authorize_reply_params)
+{
+    const ble_gatts_read_authorize_params_t *reply = &p_rw_authorize_reply_params->params.read;
+    struct SD_Attribute *attribute;
+    uint8_t *value;
+    uint16_t size;
+    uint16_t chunk;
+
+    if (!isConnected) {
+        return BLE_ERROR_INVALID_CONN_HANDLE;
+    }
+    if ((p_rw_authorize_reply_params->type != BLE_GATTS_AUTHORIZE_TYPE_READ) || !isSnapshotRead) {
+        /* The gateway reads nothing else. */
+        return NRF_SUCCESS;
+    }
+
+    attribute = SD_FindCharacteristic(TXW51_SERV_DIS_UUID_CHAR_SNAPSHOT);
+    value = (attribute->UserValue != NULL) ? attribute->UserValue : attribute->Value;
+    size = (attribute->UserValue != NULL) ? attribute->MaxLength : SD_MAX_VALUE;
+
+    if (reply->update) {
+        if ((reply->offset + reply->len > attribute->MaxLength) || (reply->offset + reply->len > size)) {
+            return NRF_ERROR_INVALID_PARAM;
+        }
+        memcpy(&value[reply->offset], reply->p_data, reply->len);
+        attribute->Length = reply->offset + reply->len;
+    }
+
+    /* The read response, a shorter one ends the long read. */
+    chunk = (attribute->Length > snapshotOffset) ? attribute->Length - snapshotOffset : 0;
+    if (chunk > SD_READ_SIZE) {
+        chunk = SD_READ_SIZE;
+    }
+    memcpy(&snapshot[snapshotOffset], &value[snapshotOffset], chunk);
+    snapshotOffset += chunk;
+
+    if (chunk < SD_READ_SIZE) {
+        isSnapshotRead = false;
+        gSimStats.SnapshotLength = snapshotOffset;
+        gSimStats.IsSnapshotValid = SD_CheckSnapshot(snapshot, snapshotOffset);
+    }
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gatts_sys_attr_set(uint16_t conn_handle, uint8_t const * const p_sys_attr_data,
+                                   uint16_t len)
+{
+    return NRF_SUCCESS;
+}
@@ -0,0 +1,299 @@
+/***************************************************************************//**
+ * @brief   Stand-ins for the peripherals that are not simulated.
+ *
+ * The log UART writes to stderr if the simulation is verbose. No I2C device
+ * is connected, so the I2C transactions fail like with an unpopulated bus.
+ * The TMP006 is modeled above the I2C level: it pulls DRDY low once per second
+ * while started and releases it when the constant sample is read. The connection parameter
+ * negotiation is not simulated, the gateway accepts the preferred parameters.
+ * The stack of the host is painted below the frame of TXW51_STACK_Paint()
+ * like the stack of the target, so the high-water mark covers the firmware
+ * and the simulated SoftDevice. It counts host frames, with 8-byte pointers
+ * and the alignment of x86-64, so it is an upper bound for the target.
+ *
+ * @file    sim_stubs.c
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+/*----- Header-Files ---------------------------------------------------------*/
+#include "sim.h"
+
+#include <string.h>
+
+#include "nrf/nrf.h"
+#include "nrf/ble/ble_conn_params.h"
+
+#include "txw51_framework/hw/i2c.h"
+#include "txw51_framework/hw/tmp006.h"
+#include "txw51_framework/hw/uart.h"
+#include "txw51_framework/utils/stack.h"
+#include "txw51_framework/utils/txw51_errors.h"
+
+/*----- Macros ---------------------------------------------------------------*/
+#define STUBS_TMP006_PERIOD         ( SIM_NS_PER_S )    /**< Time between two TMP006 samples. */
+#define STUBS_TMP006_OBJECT_TEMP    ( 2350 )            /**< Object temperature of the TMP006 in 0.01 degC. */
+#define STUBS_TMP006_DIE_TEMP       ( 2810 )            /**< Die temperature of the TMP006 in 0.01 degC. */
+#define STUBS_STACK_SIZE            ( 2048 )            /**< Stack size of gcc_startup_nrf51.s. */
+#define STUBS_STACK_PAINT_SIZE      ( 65536 )           /**< Bytes of the host stack that get painted. */
+
+/*----- Data types -----------------------------------------------------------*/
+
+/*----- Function prototypes --------------------------------------------------*/
+extern void GPIOTE_IRQHandler(void);
+static void STUBS_SetTmp006Drdy(bool isAsserted);
+static void __attribute__((noinline)) STUBS_PaintStack(void);
+
+/*----- Data -----------------------------------------------------------------*/
+static bool isLineStart = true;     /**< The next character of the log starts a line. */
+static uint64_t tmp006Drdy = SIM_TIME_NEVER;    /**< Time of the next DRDY of the TMP006. */
+static uintptr_t stackLimit = 0;    /**< Address of the lowest painted word of the host stack. */
+static uintptr_t stackTop = 0;      /**< Address of the stack at TXW51_STACK_Paint(). */
+
+/*----- Implementation -------------------------------------------------------*/
+
+void TXW51_UART_Init(struct TXW51_UART_Init *init)
+{
+}
+
+
+void TXW51_UART_Deinit(void)
+{
+}
+
+
+uint32_t TXW51_UART_Read(uint8_t *value)
+{
+    return ERR_UART_READ_FAILED;
+}
+
+
+uint32_t TXW51_UART_Write(uint8_t value)
+{
+    if (!gSimConfig.Verbose) {
+        return ERR_NONE;
+    }
+
+    if (isLineStart) {
+        fprintf(stderr, "[%10.6f] ", (double)gSimNow / SIM_NS_PER_S);
+        isLineStart = false;
+    }
+    if (value == '\n') {
+        isLineStart = true;
+    }
+    if (value != '\r') {
+        fputc(value, stderr);
+    }
+    return ERR_NONE;
+}
+
+
+uint32_t TXW51_UART_WriteString(const uint8_t *message)
+{
+    while (*message != '\0') {
+        TXW51_UART_Write(*message++);
+    }
+    return ERR_NONE;
+}
+
+
+uint32_t TXW51_I2C_Init(void)
+{
+    return ERR_NONE;
+}
+
+
+void TXW51_I2C_Deinit(void)
+{
+}
+
+
+uint32_t TXW51_I2C_ReadAsync(uint8_t addr,
+                             uint8_t reg,
+                             uint8_t len,
+                             TXW51_I2C_Callback_t callback,
+                             void *context)
+{
+    return ERR_I2C_READ_FAILED;
+}
+
+
+uint32_t TXW51_I2C_WriteAsync(uint8_t addr,
+                              uint8_t reg,
+                              const uint8_t *values,
+                              uint8_t len,
+                              TXW51_I2C_Callback_t callback,
+                              void *context)
+{
+    return ERR_I2C_WRITE_FAILED;
+}
+
+
+bool TXW51_I2C_IsIdle(void)
+{
+    return true;
+}
+
+
+void TXW51_I2C_HandleInterrupt(void)
+{
+}
+
+
+uint32_t TXW51_TMP006_Init(void)
+{
+    tmp006Drdy = SIM_TIME_NEVER;
+    STUBS_SetTmp006Drdy(false);
+    return ERR_NONE;
+}
+
+
+uint32_t TXW51_TMP006_Start(uint16_t sampleRate)
+{
+    tmp006Drdy = gSimNow + STUBS_TMP006_PERIOD;
+    return ERR_NONE;
+}
+
+
+uint32_t TXW51_TMP006_Stop(void)
+{
+    tmp006Drdy = SIM_TIME_NEVER;
+    return ERR_NONE;
+}
+
+
+uint32_t TXW51_TMP006_ReadSample(TXW51_TMP006_SampleCallback_t callback,
+                                 void *context)
+{
+    STUBS_SetTmp006Drdy(false);
+    callback(ERR_NONE, STUBS_TMP006_OBJECT_TEMP, STUBS_TMP006_DIE_TEMP, context);
+    return ERR_NONE;
+}
+
+
+uint64_t SIM_TMP006_NextEvent(void)
+{
+    return tmp006Drdy;
+}
+
+
+void SIM_TMP006_Process(uint64_t now)
+{
+    if ((tmp006Drdy > now) || gSimPrimask) {
+        return;
+    }
+
+    tmp006Drdy += STUBS_TMP006_PERIOD;
+    gSimStats.Tmp006Samples++;
+    STUBS_SetTmp006Drdy(true);
+    NRF_GPIOTE->EVENTS_IN[TXW51_TMP006_GPIO_DRDY_CHANNEL] = 1;
+    GPIOTE_IRQHandler();
+    SIM_Wakeup();
+}
+
+
+/***************************************************************************//**
+ * @brief Sets the level of the DRDY pin of the TMP006, which is active low.
+ *
+ * @param[in] isAsserted True if a sample is ready.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void STUBS_SetTmp006Drdy(bool isAsserted)
+{
+    volatile uint32_t *in = (volatile uint32_t *)&NRF_GPIO->IN;
+
+    if (isAsserted) {
+        *in &= ~(1UL << TXW51_TMP006_GPIO_DRDY);
+    } else {
+        *in |= (1UL << TXW51_TMP006_GPIO_DRDY);
+    }
+}
+
+
+/***************************************************************************//**
+ * @brief Paints the host stack below the frame of the caller.
+ *
+ * The painted words are a local array of this function, they stay on the
+ * stack after it returns until the firmware overwrites them.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void __attribute__((noinline)) STUBS_PaintStack(void)
+{
+    volatile uint32_t area[STUBS_STACK_PAINT_SIZE / sizeof(uint32_t)];
+
+    for (uint32_t i = 0; i < sizeof(area) / sizeof(area[0]); i++) {
+        area[i] = TXW51_STACK_PAINT_PATTERN;
+    }
+    stackLimit = (uintptr_t)area;
+}
+
+
+void TXW51_STACK_Paint(void)
+{
+    volatile uint32_t top;
+
+    stackTop = (uintptr_t)&top;
+    STUBS_PaintStack();
+}
+
+
+uint32_t TXW51_STACK_GetSize(void)
+{
+    return STUBS_STACK_SIZE;
+}
+
+
+uint32_t TXW51_STACK_GetMaxUsage(void)
+{
+    const volatile uint32_t *word = (const volatile uint32_t *)stackLimit;
+
+    if (stackLimit == 0) {
+        return 0;
+    }
+    while (((uintptr_t)word < stackTop) && (*word == TXW51_STACK_PAINT_PATTERN)) {
+        word++;
+    }
+    return stackTop - (uintptr_t)word;
+}
+
+
+uint32_t ble_conn_params_init(const ble_conn_params_init_t *p_init)
+{
+    return NRF_SUCCESS;
+}
+
+
+uint32_t ble_conn_params_stop(void)
+{
+    return NRF_SUCCESS;
+}
+
+
+uint32_t ble_conn_params_change_conn_params(ble_gap_conn_params_t *new_params)
+{
+    return NRF_SUCCESS;
+}
+
+
+void ble_conn_params_on_ble_evt(ble_evt_t *p_ble_evt)
+{
+}
+
+
+size_t strlcpy(char *dst, const char *src, size_t size)
+{
+    size_t length = strlen(src);
+
+    if (size > 0) {
+        size_t n = (length < size - 1) ? length : size - 1;
+        memcpy(dst, src, n);
+        dst[n] = '\0';
+    }
+    return length;
+}
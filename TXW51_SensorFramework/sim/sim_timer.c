@@ -0,0 +1,210 @@
+/***************************************************************************//**
+ * @brief   Host replacement of the SDK application timer.
+ *
+ * app_timer.c runs on RTC1 and the SWI0 interrupt and needs 32-bit pointers
+ * for its buffers. This replacement keeps the interface and expires the
+ * timers at their tick in the simulated time. RTC1 runs with the prescaler
+ * and the drift of the configuration, the simulated time is the gateway
+ * clock.
+ *
+ * @file    sim_timer.c
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+/*----- Header-Files ---------------------------------------------------------*/
+#include "sim.h"
+
+#include "nrf/app_common/app_timer.h"
+
+/*----- Macros ---------------------------------------------------------------*/
+#define TIMER_MAX_TIMERS    ( 16 )          /**< Number of timers that can be created. */
+#define TIMER_COUNTER_MASK  ( 0x00FFFFFF )  /**< RTC1 is a 24 bit counter. */
+
+/*----- Data types -----------------------------------------------------------*/
+/**
+ * @brief State of a timer.
+ */
+struct TIMER_Timer {
+    app_timer_mode_t Mode;                  /**< Single shot or repeated. */
+    app_timer_timeout_handler_t Handler;    /**< Timeout handler. */
+    void *Context;                          /**< Context given to app_timer_start(). */
+    uint64_t Interval;                      /**< Interval in ns. */
+    uint64_t Expiry;                        /**< Time of the next expiry, SIM_TIME_NEVER if stopped. */
+};
+
+/*----- Function prototypes --------------------------------------------------*/
+static uint64_t TIMER_TicksToTime(uint32_t ticks);
+static uint64_t TIMER_RtcTime(uint64_t time);
+
+/*----- Data -----------------------------------------------------------------*/
+static struct TIMER_Timer timers[TIMER_MAX_TIMERS];     /**< The created timers. */
+static uint32_t numberOfTimers = 0;                     /**< Number of created timers. */
+static uint8_t  maxTimers = 0;                          /**< Timers allowed by app_timer_init(). */
+static uint32_t prescaler = 0;                          /**< Prescaler of RTC1. */
+static app_timer_evt_schedule_func_t scheduleFunc = NULL;   /**< Puts the timeouts into the scheduler. */
+
+/*----- Implementation -------------------------------------------------------*/
+
+/***************************************************************************//**
+ * @brief Converts RTC1 ticks to the simulated time.
+ *
+ * @param[in] ticks Number of ticks.
+ *
+ * @return The duration in ns.
+ ******************************************************************************/
+static uint64_t TIMER_TicksToTime(uint32_t ticks)
+{
+    uint64_t duration = (uint64_t)ticks * (prescaler + 1) * SIM_NS_PER_S / APP_TIMER_CLOCK_FREQ;
+
+    return duration - (int64_t)((double)duration * gSimConfig.ClockDrift / (1e6 + gSimConfig.ClockDrift));
+}
+
+
+/***************************************************************************//**
+ * @brief Converts the simulated time to the time of RTC1 with its drift.
+ *
+ * @param[in] time The simulated time in ns.
+ *
+ * @return The time of RTC1 in ns.
+ ******************************************************************************/
+static uint64_t TIMER_RtcTime(uint64_t time)
+{
+    return time + (int64_t)((double)time * gSimConfig.ClockDrift / 1e6);
+}
+
+
+uint32_t app_timer_init(uint32_t prescaler_value,
+                        uint8_t max_timers,
+                        uint8_t op_queues_size,
+                        void *p_buffer,
+                        app_timer_evt_schedule_func_t evt_schedule_func)
+{
+    if (max_timers > TIMER_MAX_TIMERS) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    prescaler = prescaler_value;
+    maxTimers = max_timers;
+    scheduleFunc = evt_schedule_func;
+    numberOfTimers = 0;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_timer_create(app_timer_id_t *p_timer_id,
+                          app_timer_mode_t mode,
+                          app_timer_timeout_handler_t timeout_handler)
+{
+    if ((p_timer_id == NULL) || (timeout_handler == NULL)) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    if (numberOfTimers >= maxTimers) {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    timers[numberOfTimers].Mode = mode;
+    timers[numberOfTimers].Handler = timeout_handler;
+    timers[numberOfTimers].Expiry = SIM_TIME_NEVER;
+    *p_timer_id = numberOfTimers;
+    numberOfTimers++;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks, void *p_context)
+{
+    if ((timer_id >= numberOfTimers) || (timeout_ticks < APP_TIMER_MIN_TIMEOUT_TICKS)) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    timers[timer_id].Context = p_context;
+    timers[timer_id].Interval = TIMER_TicksToTime(timeout_ticks);
+    timers[timer_id].Expiry = gSimNow + timers[timer_id].Interval;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_timer_stop(app_timer_id_t timer_id)
+{
+    if (timer_id >= numberOfTimers) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    timers[timer_id].Expiry = SIM_TIME_NEVER;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_timer_stop_all(void)
+{
+    for (uint32_t i = 0; i < numberOfTimers; i++) {
+        timers[i].Expiry = SIM_TIME_NEVER;
+    }
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_timer_cnt_get(uint32_t *p_ticks)
+{
+    *p_ticks = (uint32_t)(TIMER_RtcTime(gSimNow) * APP_TIMER_CLOCK_FREQ /
+                          ((prescaler + 1) * SIM_NS_PER_S)) & TIMER_COUNTER_MASK;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_timer_cnt_diff_compute(uint32_t ticks_to,
+                                    uint32_t ticks_from,
+                                    uint32_t *p_ticks_diff)
+{
+    *p_ticks_diff = (ticks_to - ticks_from) & TIMER_COUNTER_MASK;
+    return NRF_SUCCESS;
+}
+
+
+double SIM_TIMER_TickCenter(void)
+{
+    double tick = (double)SIM_NS_PER_S * (prescaler + 1) / APP_TIMER_CLOCK_FREQ;
+    uint64_t ticks = TIMER_RtcTime(gSimNow) * APP_TIMER_CLOCK_FREQ / ((prescaler + 1) * SIM_NS_PER_S);
+
+    return (ticks + 0.5) * tick / (1 + gSimConfig.ClockDrift / 1e6);
+}
+
+
+uint64_t SIM_TIMER_NextEvent(void)
+{
+    uint64_t next = SIM_TIME_NEVER;
+
+    for (uint32_t i = 0; i < numberOfTimers; i++) {
+        if (timers[i].Expiry < next) {
+            next = timers[i].Expiry;
+        }
+    }
+    return next;
+}
+
+
+void SIM_TIMER_Process(uint64_t now)
+{
+    for (uint32_t i = 0; i < numberOfTimers; i++) {
+        struct TIMER_Timer *timer = &timers[i];
+
+        if (timer->Expiry > now) {
+            continue;
+        }
+
+        timer->Expiry = (timer->Mode == APP_TIMER_MODE_REPEATED) ?
+                        timer->Expiry + timer->Interval : SIM_TIME_NEVER;
+
+        if (scheduleFunc != NULL) {
+            scheduleFunc(timer->Handler, timer->Context);
+        } else {
+            timer->Handler(timer->Context);
+        }
+        SIM_Wakeup();
+    }
+}
@@ -1,8 +1,10 @@
 /***************************************************************************//**
  * @brief   Main module of the application.
  *
- * First, the hardware and the Bluetooth Smart stack get set up. Afterwards,
- * the main loop gets started.
+ * First, the Bluetooth Smart stack and the services get set up and the
+ * advertising is started. The modules that are only needed for a connection
+ * are initialized afterwards by the scheduler, while the device is already
+ * advertising. Then the main loop takes over.
  *
  * @file    appl.c
  * @version 1.0
@@ -17,19 +19,29 @@
 /*----- Header-Files ---------------------------------------------------------*/
 #include "appl.h"
 
+#include "nrf/ble/ble_radio_notification.h"
+#include "nrf/sd_common/app_util_platform.h"
+
 #include "txw51_framework/ble/btle.h"
 #include "txw51_framework/ble/cb.h"
 #include "txw51_framework/hw/gpio.h"
 #include "txw51_framework/hw/spi.h"
 #include "txw51_framework/hw/uart.h"
+#include "txw51_framework/utils/kvstore.h"
 #include "txw51_framework/utils/log.h"
 #include "txw51_framework/utils/setup.h"
+#include "txw51_framework/utils/stack.h"
 
+#include "app/boot.h"
+#include "app/broadcast.h"
+#include "app/clock.h"
 #include "app/device_info.h"
+#include "app/diagnostics.h"
 #include "app/error.h"
 #include "app/fifo.h"
 #include "app/measurement.h"
 #include "app/sensor.h"
+#include "app/spi_test.h"
 #include "app/timer.h"
 #include "app/contactless_temp.h"
 #include "app/i2cBridge.h"
@@ -41,18 +53,24 @@
 
 /*----- Function prototypes --------------------------------------------------*/
 static void APPL_Sleep(void);
+static void APPL_Standby(void);
+static void APPL_WakeUp(void);
 static void APPL_BleEventHandler(ble_evt_t *bleEvent);
+static uint16_t APPL_GetEventInterval(const ble_gap_conn_params_t *connParams);
 static void APPL_Init(void);
+static void APPL_InitDeferred(void *data, uint16_t size);
 
 /*----- Data -----------------------------------------------------------------*/
 bool gIsNewAccDataAvailable = false;
 bool gIsNewGyroDataAvailable = false;
+bool gIsNewDriverDataAvailable = false;
 bool gIsTimeout = false;
+bool gIsMotionDetected = false;
 
 static struct TXW51_SERV_DIS_Handle serviceHandleDis;           /**< Handle for the DIS Bluetooth service. */
 static struct TXW51_SERV_LSM330_Handle serviceHandleLsm330;     /**< Handle for the LSM330 Bluetooth service. */
 static struct TXW51_SERV_MEASURE_Handle serviceHandleMeasure;   /**< Handle for the Measurement Bluetooth service. */
-//static struct TXW51_SERV_TEMP_CONTACTLESS_Handle serviceHandleContactlessTemp;	/**< Handle for the contactless temperature Bluetooth service. */
+static struct TXW51_SERV_TEMP_CONTACTLESS_Handle serviceHandleContactlessTemp;	/**< Handle for the contactless temperature Bluetooth service. */
 static struct TXW51_SERV_I2C_Handle serviceHandleI2c;			/**< Handle for the I2C Bluetooth service */
 
 /*----- Implementation -------------------------------------------------------*/
@@ -69,7 +87,10 @@ static void APPL_Sleep(void)
     /* Configure the sensor to wake up the device when it gets moved. */
     APPL_SENSOR_SetupMotionWakeup();
 
-    while (APPL_DEVINFO_IsBusy()) { /* Wait for flash transactions to finish */ }
+    while (APPL_DEVINFO_IsBusy()) {
+        /* Wait for flash transactions to finish. */
+        app_sched_execute();
+    }
 
     /* Turn off function blocks and disconnect the GPIO pins. */
     TXW51_UART_Deinit();
@@ -83,6 +104,60 @@ static void APPL_Sleep(void)
 }
 
 
+/***************************************************************************//**
+ * @brief Puts the device into a low-power standby mode.
+ *
+ * Unlike APPL_Sleep(), the RAM and the Bluetooth Smart stack are kept, so the
+ * samples before and after a motion can be captured. If the sensor can not be
+ * set up, the device goes to sleep instead.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void APPL_Standby(void)
+{
+    gIsTimeout = false;
+
+    if (APPL_SENSOR_EnterStandby() != ERR_NONE) {
+        APPL_Sleep();
+    }
+
+    TXW51_LOG_INFO("Go to standby.");
+
+    APPL_BROADCAST_Stop();
+    TXW51_BLE_StopAdvertising();
+    TXW51_GPIO_ClearGpio(CONFIG_HW_LED_ADVERTISING);
+    TXW51_GPIO_ClearGpio(CONFIG_HW_LED_ON);
+
+    /* The UART receiver and the HFCLK are the largest consumers left. */
+    TXW51_UART_Deinit();
+    sd_clock_hfclk_release();
+}
+
+
+/***************************************************************************//**
+ * @brief Wakes the device up from the standby mode after a motion.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void APPL_WakeUp(void)
+{
+    gIsMotionDetected = false;
+
+    TXW51_SETUP_RequestHfClock();
+    TXW51_LOG_Init();
+    TXW51_LOG_INFO("Wake up.");
+    APPL_BROADCAST_CountEvent(APPL_BROADCAST_EVENT_WAKEUP);
+
+    APPL_SENSOR_LeaveStandby();
+
+    TXW51_GPIO_SetGpio(CONFIG_HW_LED_ON);
+    APPL_BROADCAST_Start();
+    TXW51_BLE_StartAdvertising();
+    TXW51_GPIO_SetGpio(CONFIG_HW_LED_ADVERTISING);
+    APPL_TIMER_Start();
+}
+
+
 /***************************************************************************//**
  * @brief Handles the events from the Bluetooth Smart module.
  *
@@ -96,18 +171,28 @@ static void APPL_BleEventHandler(ble_evt_t *bleEvent)
     TXW51_SERV_DIS_OnBleEvent(&serviceHandleDis, bleEvent);
     TXW51_SERV_LSM330_OnBleEvent(&serviceHandleLsm330, bleEvent);
     TXW51_SERV_MEASURE_OnBleEvent(&serviceHandleMeasure, bleEvent);
-    //TXW51_SERV_TEMP_CONTACTLESS_OnBleEvent(&serviceHandleContactlessTemp, bleEvent);
+    TXW51_SERV_TEMP_CONTACTLESS_OnBleEvent(&serviceHandleContactlessTemp, bleEvent);
     TXW51_SERV_I2C_OnBleEvent(&serviceHandleI2c, bleEvent);
 
     /* Local BLE event handling. */
     switch (bleEvent->header.evt_id) {
         case BLE_GAP_EVT_CONNECTED:
             APPL_TIMER_Stop();
+            APPL_BROADCAST_Stop();
+            APPL_BROADCAST_CountEvent(APPL_BROADCAST_EVENT_CONNECTION);
+            APPL_SENSOR_AlignDrains(APPL_GetEventInterval(&bleEvent->evt.gap_evt.params.connected.conn_params));
             TXW51_GPIO_ClearGpio(CONFIG_HW_LED_ADVERTISING);
             break;
 
+        case BLE_GAP_EVT_CONN_PARAM_UPDATE:
+            APPL_SENSOR_AlignDrains(APPL_GetEventInterval(&bleEvent->evt.gap_evt.params.conn_param_update.conn_params));
+            break;
+
         case BLE_GAP_EVT_DISCONNECTED:
+            APPL_SENSOR_AlignDrains(0);
+            APPL_DIAG_PrintValues();
             APPL_TIMER_Start();
+            APPL_BROADCAST_Start();
             TXW51_GPIO_SetGpio(CONFIG_HW_LED_ADVERTISING);
             break;
 
@@ -126,7 +211,31 @@ static void APPL_BleEventHandler(ble_evt_t *bleEvent)
 
 
 /***************************************************************************//**
- * @brief Initializes all the modules of the application.
+ * @brief Computes the longest time between two connection events the device
+ *        takes part in.
+ *
+ * With a slave latency, the SoftDevice skips up to that many connection
+ * events in a row while it has nothing to send.
+ *
+ * @param[in] connParams The parameters of the connection.
+ *
+ * @return The time in 1.25 ms units.
+ ******************************************************************************/
+static uint16_t APPL_GetEventInterval(const ble_gap_conn_params_t *connParams)
+{
+    uint32_t interval = (uint32_t)connParams->max_conn_interval * (1 + connParams->slave_latency);
+
+    /* The supervision timeout keeps it below 16 s, see BLE_GAP_CP_LIMITS. */
+    return (interval > UINT16_MAX) ? UINT16_MAX : (uint16_t)interval;
+}
+
+
+/***************************************************************************//**
+ * @brief Initializes the modules that are needed to advertise.
+ *
+ * The device information and the sensor profile are read from the key-value
+ * store, because the services are created with these values. Everything else
+ * is left to APPL_InitDeferred().
  *
  * @return Nothing.
  ******************************************************************************/
@@ -136,37 +245,79 @@ static void APPL_Init(void)
 
     TXW51_SETUP_InitSoftdevice();
     TXW51_SETUP_InitScheduler();
-    TXW51_SETUP_InitHfClock();
+    TXW51_SETUP_RequestHfClock();
     APPL_TIMER_Init();
+    APPL_CLOCK_Init();
+    APPL_BOOT_Mark(APPL_BOOT_STAGE_SOFTDEVICE);
 
     TXW51_GPIO_InitLed();
     TXW51_GPIO_SetGpio(CONFIG_HW_LED_ON);
-    TXW51_SPI_Init(TXW51_SPI_0);
-    APPL_SENSOR_Init();
 
-    APPL_I2C_BRIDGE_Init();
+    /* The flash events are dispatched after the BLE stack is enabled. */
+    TXW51_BLE_Init();
+    if (ble_radio_notification_init(CONFIG_RADIO_NOTIFICATION_IRQ_PRIORITY,
+                                    CONFIG_RADIO_NOTIFICATION_DISTANCE,
+                                    APPL_SENSOR_HandleRadioNotification) != NRF_SUCCESS) {
+        TXW51_LOG_WARNING("Radio notification not available, the sensor drains are not aligned.");
+    }
+    APPL_BOOT_Mark(APPL_BOOT_STAGE_STACK);
 
-    APPL_FIFO_Init();
+    /* Only scans the flash, pending writes are finished in the background. */
+    TXW51_KVSTORE_Init(CONFIG_KVSTORE_PAGE_ADDRESS, CONFIG_KVSTORE_PAGE_SIZE);
     APPL_DEVINFO_Init();
     APPL_DEVINFO_Load();
-    while (APPL_DEVINFO_IsBusy()) { /* Wait. */ }
+    APPL_SENSOR_LoadProfile();
+    APPL_BOOT_Mark(APPL_BOOT_STAGE_STORAGE);
 
-    TXW51_BLE_Init();
     APPL_DEVINFO_InitService(&serviceHandleDis);
     APPL_SENSOR_InitService(&serviceHandleLsm330);
     APPL_MEASUREMENT_InitService(&serviceHandleMeasure);
-    //APPL_CONTACTLESS_TEMP_InitService(&serviceHandleContactlessTemp);
+    APPL_CONTACTLESS_TEMP_InitService(&serviceHandleContactlessTemp);
     APPL_I2C_BRIDGE_InitService(&serviceHandleI2c);
     TXW51_BLE_InitAdvertising();
+    APPL_BROADCAST_Init();
+    APPL_BOOT_Mark(APPL_BOOT_STAGE_SERVICES);
+}
+
+
+/***************************************************************************//**
+ * @brief Initializes the modules that are only needed for a connection.
+ *
+ * This function is put into the scheduler before the advertising is started,
+ * so it runs before the first BLE event gets handled.
+ *
+ * @param[in] data Not used.
+ * @param[in] size Not used.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void APPL_InitDeferred(void *data, uint16_t size)
+{
+    APPL_SPI_TEST_Init();
+    APPL_SENSOR_Init();
+    if (!APPL_SPI_TEST_IsSelected()) {
+        APPL_SPI_TEST_Run();
+    }
+    APPL_BOOT_Mark(APPL_BOOT_STAGE_SENSOR);
+
+    APPL_I2C_BRIDGE_Init();
+    APPL_CONTACTLESS_TEMP_Init();
+    APPL_FIFO_Init();
 
     //APPL_ADC_EXMPL_Init();
     //APPL_ADC_EXMPL_Start();
+    APPL_BOOT_Mark(APPL_BOOT_STAGE_DEFERRED);
     TXW51_LOG_INFO("Initialization successful!");
+
+    APPL_DEVINFO_PrintValues();
+    APPL_BOOT_Finish();
 }
 
 
 void APPL_Start(void)
 {
+    TXW51_STACK_Paint();
+    APPL_BOOT_Start();
     TXW51_LOG_Init();
     TXW51_LOG_INFO("");
     TXW51_LOG_INFO("-------------");
@@ -182,9 +333,11 @@ void APPL_Start(void)
 //    APPL_DEVINFO_Save();
 
     /* Start execution. */
-    APPL_DEVINFO_PrintValues();
     TXW51_CB_RegisterBleCallback(APPL_BleEventHandler);
+    app_sched_event_put(NULL, 0, APPL_InitDeferred);
+    APPL_BROADCAST_Start();
     TXW51_BLE_StartAdvertising();
+    APPL_BOOT_Mark(APPL_BOOT_STAGE_ADVERTISING);
     TXW51_GPIO_SetGpio(CONFIG_HW_LED_ADVERTISING);
     APPL_TIMER_Start();
 
@@ -193,10 +346,14 @@ void APPL_Start(void)
         app_sched_execute();
 
         if (gIsTimeout) {
-            APPL_Sleep();
+            APPL_Standby();
+        }
+
+        if (gIsMotionDetected) {
+            APPL_WakeUp();
         }
 
-        if (gIsNewAccDataAvailable || gIsNewGyroDataAvailable) {
+        if (gIsNewAccDataAvailable || gIsNewGyroDataAvailable || gIsNewDriverDataAvailable) {
             APPL_MEASUREMENT_SendAllData(TXW51_SERV_MEASURE_TX_NOTIFICATION);
         }
 
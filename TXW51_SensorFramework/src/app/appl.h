@@ -36,6 +36,8 @@ extern void APPL_Start(void);
 /*----- Data -----------------------------------------------------------------*/
 extern bool gIsNewAccDataAvailable;     /**< Global flag that indicates if new accelerometer data is available. */
 extern bool gIsNewGyroDataAvailable;    /**< Global flag that indicates if new gyroscope data is available. */
+extern bool gIsNewDriverDataAvailable;  /**< Global flag that indicates if a registered sensor driver has new data. */
 extern bool gIsTimeout;                 /**< Global flag that indicates if the device should go into standby mode. */
+extern bool gIsMotionDetected;          /**< Global flag that indicates if a motion should wake up the device from standby mode. */
 
 #endif /* TXW51_APPLICATION_APPL_H_ */
@@ -0,0 +1,95 @@
+/***************************************************************************//**
+ * @brief   Module that records the duration of the boot stages.
+ *
+ * @file    boot.c
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+/*----- Header-Files ---------------------------------------------------------*/
+#include "boot.h"
+
+#include <stdio.h>
+
+#include "nrf/nrf.h"
+
+#include "txw51_framework/utils/log.h"
+
+/*----- Macros ---------------------------------------------------------------*/
+#define BOOT_OUTPUT_BUFFER_LENGTH   ( 48 )  /**< Length of a log line. */
+
+/*----- Data types -----------------------------------------------------------*/
+
+/*----- Function prototypes --------------------------------------------------*/
+
+/*----- Data -----------------------------------------------------------------*/
+static uint32_t timestamps[APPL_BOOT_NUM_OF_STAGES];   /**< Time of every stage in microseconds. */
+
+/**
+ * @brief Names of the boot stages for the log.
+ */
+static const char *names[APPL_BOOT_NUM_OF_STAGES] = {
+    "SoftDevice",
+    "BLE stack",
+    "Storage",
+    "Services",
+    "Advertising",
+    "Sensor",
+    "Deferred"
+};
+
+/*----- Implementation -------------------------------------------------------*/
+
+void APPL_BOOT_Start(void)
+{
+    for (int32_t i = 0; i < APPL_BOOT_NUM_OF_STAGES; i++) {
+        timestamps[i] = 0;
+    }
+
+    NRF_TIMER1->TASKS_STOP  = 1;
+    NRF_TIMER1->TASKS_CLEAR = 1;
+    NRF_TIMER1->MODE        = TIMER_MODE_MODE_Timer;
+    NRF_TIMER1->BITMODE     = TIMER_BITMODE_BITMODE_16Bit;
+    NRF_TIMER1->PRESCALER   = APPL_BOOT_TIMER_PRESCALER;
+    NRF_TIMER1->TASKS_START = 1;
+}
+
+
+void APPL_BOOT_Mark(enum appl_boot_stage stage)
+{
+    if (stage >= APPL_BOOT_NUM_OF_STAGES) {
+        return;
+    }
+
+    NRF_TIMER1->TASKS_CAPTURE[0] = 1;
+    timestamps[stage] = NRF_TIMER1->CC[0] * APPL_BOOT_TIMER_TICK_US;
+}
+
+
+uint32_t APPL_BOOT_GetTime(enum appl_boot_stage stage)
+{
+    if (stage >= APPL_BOOT_NUM_OF_STAGES) {
+        return 0;
+    }
+    return timestamps[stage];
+}
+
+
+void APPL_BOOT_Finish(void)
+{
+    char outputBuffer[BOOT_OUTPUT_BUFFER_LENGTH];
+
+    /* The timer draws current from the HFCLK, so it is only used at boot. */
+    NRF_TIMER1->TASKS_STOP     = 1;
+    NRF_TIMER1->TASKS_SHUTDOWN = 1;
+
+    for (int32_t i = 0; i < APPL_BOOT_NUM_OF_STAGES; i++) {
+        snprintf(outputBuffer, BOOT_OUTPUT_BUFFER_LENGTH, "[Boot] %-12s %6lu us",
+                 names[i], (unsigned long)timestamps[i]);
+        TXW51_LOG_INFO(outputBuffer);
+    }
+}
@@ -0,0 +1,83 @@
+/***************************************************************************//**
+ * @brief   Module that records the duration of the boot stages.
+ *
+ * The boot is split into a fast path, which starts the advertising as early
+ * as possible, and a deferred stage that initializes the modules which are
+ * only needed for a connection. The end of every stage gets a timestamp that
+ * is measured from APPL_BOOT_Start().
+ *
+ * TIMER1 is used as time base, because the RTC1 of the app_timer is stopped
+ * while no timer is running. On the nRF51 TIMER1 has only 16 bits, so it runs
+ * with the largest prescaler (32us resolution, about 2s range).
+ *
+ * @file    boot.h
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+#ifndef TXW51_APPLICATION_BOOT_H_
+#define TXW51_APPLICATION_BOOT_H_
+
+/*----- Header-Files ---------------------------------------------------------*/
+#include <stdint.h>
+
+/*----- Macros ---------------------------------------------------------------*/
+#define APPL_BOOT_TIMER_PRESCALER   ( 9 )   /**< TIMER1 runs at 16MHz / 2^9 = 31.25kHz. */
+#define APPL_BOOT_TIMER_TICK_US     ( 32 )  /**< Duration of one timer tick in microseconds. */
+
+/*----- Data types -----------------------------------------------------------*/
+/**
+ * @brief List of the boot stages in the order they finish.
+ */
+enum appl_boot_stage {
+    APPL_BOOT_STAGE_SOFTDEVICE = 0,     /**< SoftDevice, scheduler and timers are set up. */
+    APPL_BOOT_STAGE_STACK,              /**< The Bluetooth Smart stack is enabled. */
+    APPL_BOOT_STAGE_STORAGE,            /**< Device information and sensor profile are loaded. */
+    APPL_BOOT_STAGE_SERVICES,           /**< The Bluetooth Smart services are added. */
+    APPL_BOOT_STAGE_ADVERTISING,        /**< The advertising is started. */
+    APPL_BOOT_STAGE_SENSOR,             /**< The LSM330 sensor is configured (deferred). */
+    APPL_BOOT_STAGE_DEFERRED,           /**< All other modules are initialized (deferred). */
+    APPL_BOOT_NUM_OF_STAGES
+};
+
+/*----- Function prototypes --------------------------------------------------*/
+
+/***************************************************************************//**
+ * @brief Starts the time measurement of the boot.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+extern void APPL_BOOT_Start(void);
+
+/***************************************************************************//**
+ * @brief Records the end of a boot stage.
+ *
+ * @param[in] stage The boot stage that has been finished.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+extern void APPL_BOOT_Mark(enum appl_boot_stage stage);
+
+/***************************************************************************//**
+ * @brief Gets the time from the start of the boot until the end of a stage.
+ *
+ * @param[in] stage The boot stage.
+ *
+ * @return The time in microseconds, 0 if the stage has not been finished.
+ ******************************************************************************/
+extern uint32_t APPL_BOOT_GetTime(enum appl_boot_stage stage);
+
+/***************************************************************************//**
+ * @brief Stops the time measurement and writes the timestamps to the log.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+extern void APPL_BOOT_Finish(void);
+
+/*----- Data -----------------------------------------------------------------*/
+
+#endif /* TXW51_APPLICATION_BOOT_H_ */
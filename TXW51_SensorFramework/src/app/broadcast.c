@@ -0,0 +1,250 @@
+/***************************************************************************//**
+ * @brief   Connectionless telemetry in the advertising data.
+ *
+ * The S110 can only advertise without a connection, so the rotation runs
+ * between APPL_BROADCAST_Start() and APPL_BROADCAST_Stop() and is driven by
+ * a repeated application timer. The frames are built in the scheduler
+ * context of the timer handler.
+ *
+ * @file    broadcast.c
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+/*----- Header-Files ---------------------------------------------------------*/
+#include "broadcast.h"
+
+#include <stdbool.h>
+
+#include "nrf/s110/nrf_soc.h"
+#include "nrf/app_common/app_timer.h"
+
+#include "txw51_framework/ble/btle.h"
+#include "txw51_framework/config/config.h"
+#include "txw51_framework/utils/kvstore.h"
+#include "txw51_framework/utils/log.h"
+
+#include "app/error.h"
+#include "app/kvstore_keys.h"
+#include "app/measurement.h"
+#include "app/sensor.h"
+
+/*----- Macros ---------------------------------------------------------------*/
+#define BROADCAST_HEADER_SIZE       ( 2 )       /**< Frame type and sequence number. */
+#define BROADCAST_NO_VALUE          ( 0xFFFF )  /**< Value of a summary without samples. */
+
+/*----- Data types -----------------------------------------------------------*/
+
+/*----- Function prototypes --------------------------------------------------*/
+static void BROADCAST_TimerHandler(void *context);
+static void BROADCAST_SetFrame(void);
+static uint8_t BROADCAST_PutUint16(uint8_t *buffer, uint16_t value);
+static void BROADCAST_StartTimer(void);
+
+/*----- Data -----------------------------------------------------------------*/
+static app_timer_id_t timerHandle;                  /**< Handle of the rotation timer. */
+static uint16_t intervalMs = APPL_BROADCAST_DEFAULT_INTERVAL_MS;   /**< Time between two frames, 0 if disabled. */
+static bool isRunning = false;                      /**< The device advertises. */
+static uint8_t nextFrame = APPL_BROADCAST_FRAME_TEMP;   /**< Type of the next frame. */
+static uint8_t sequence = 0;                        /**< Sequence number of the next frame. */
+static uint16_t counters[APPL_BROADCAST_EVENT_COUNT];   /**< Counted events since the reset. */
+
+/*----- Implementation -------------------------------------------------------*/
+
+uint32_t APPL_BROADCAST_Init(void)
+{
+    uint16_t storedInterval;
+    uint8_t length = sizeof(storedInterval);
+    uint32_t err;
+
+    err = app_timer_create(&timerHandle,
+                           APP_TIMER_MODE_REPEATED,
+                           BROADCAST_TimerHandler);
+    if (err != NRF_SUCCESS) {
+        TXW51_LOG_ERROR("[Broadcast] Could not create timer.");
+        return ERR_BROADCAST_TIMER_FAILED;
+    }
+
+    err = TXW51_KVSTORE_Get(APPL_KVSTORE_KEY_BROADCAST,
+                            (uint8_t *)&storedInterval,
+                            &length);
+    if ((err == ERR_NONE) && (length == sizeof(storedInterval)) &&
+        ((storedInterval == 0) || (storedInterval >= APPL_BROADCAST_MIN_INTERVAL_MS))) {
+        intervalMs = storedInterval;
+    }
+
+    return ERR_NONE;
+}
+
+
+void APPL_BROADCAST_Start(void)
+{
+    isRunning = true;
+    BROADCAST_StartTimer();
+}
+
+
+void APPL_BROADCAST_Stop(void)
+{
+    isRunning = false;
+    app_timer_stop(timerHandle);
+    TXW51_BLE_SetManufacturerData(NULL, 0);
+}
+
+
+uint32_t APPL_BROADCAST_SetInterval(uint16_t interval)
+{
+    uint32_t err;
+
+    if ((interval != 0) && (interval < APPL_BROADCAST_MIN_INTERVAL_MS)) {
+        return ERR_BROADCAST_INVALID_INTERVAL;
+    }
+
+    intervalMs = interval;
+
+    err = TXW51_KVSTORE_Set(APPL_KVSTORE_KEY_BROADCAST,
+                            (uint8_t *)&intervalMs,
+                            sizeof(intervalMs));
+    if (err != ERR_NONE) {
+        TXW51_LOG_WARNING("[Broadcast] Could not save interval.");
+    }
+
+    if (isRunning) {
+        app_timer_stop(timerHandle);
+        BROADCAST_StartTimer();
+    }
+    return ERR_NONE;
+}
+
+
+uint16_t APPL_BROADCAST_GetInterval(void)
+{
+    return intervalMs;
+}
+
+
+void APPL_BROADCAST_CountEvent(enum appl_broadcast_event event)
+{
+    if ((event < APPL_BROADCAST_EVENT_COUNT) && (counters[event] < UINT16_MAX)) {
+        counters[event]++;
+    }
+}
+
+
+/***************************************************************************//**
+ * @brief Sets the first frame and starts the rotation timer.
+ *
+ * Without an interval, the frame is removed from the advertising data.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void BROADCAST_StartTimer(void)
+{
+    uint32_t err;
+
+    if (intervalMs == 0) {
+        TXW51_BLE_SetManufacturerData(NULL, 0);
+        return;
+    }
+
+    BROADCAST_SetFrame();
+
+    err = app_timer_start(timerHandle,
+                          APP_TIMER_TICKS(intervalMs, CONFIG_TIMERS_PRESCALER),
+                          NULL);
+    if (err != NRF_SUCCESS) {
+        TXW51_LOG_WARNING("[Broadcast] Could not start timer.");
+    }
+}
+
+
+/***************************************************************************//**
+ * @brief Callback handler of the rotation timer.
+ *
+ * @param[in] context Not used.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void BROADCAST_TimerHandler(void *context)
+{
+    if (isRunning) {
+        BROADCAST_SetFrame();
+    }
+}
+
+
+/***************************************************************************//**
+ * @brief Builds the next frame of the rotation and puts it into the
+ *        advertising data.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void BROADCAST_SetFrame(void)
+{
+    uint8_t frame[TXW51_BLE_MAX_MANUF_DATA];
+    uint8_t length = BROADCAST_HEADER_SIZE;
+    int32_t temp;
+    uint16_t rms;
+    uint16_t peak;
+
+    frame[0] = nextFrame;
+    frame[1] = sequence;
+
+    switch (nextFrame) {
+        case APPL_BROADCAST_FRAME_TEMP:
+            /* The temperature of the die is measured in steps of 0.25 degC. */
+            temp = (sd_temp_get(&temp) == NRF_SUCCESS) ? temp * 25 : INT16_MIN;
+            length += BROADCAST_PutUint16(&frame[length], (uint16_t)(int16_t)temp);
+            break;
+
+        case APPL_BROADCAST_FRAME_MOTION:
+            if (!APPL_SENSOR_TakeMotionSummary(&rms, &peak)) {
+                rms  = BROADCAST_NO_VALUE;
+                peak = BROADCAST_NO_VALUE;
+            }
+            length += BROADCAST_PutUint16(&frame[length], rms);
+            length += BROADCAST_PutUint16(&frame[length], peak);
+            break;
+
+        case APPL_BROADCAST_FRAME_BATTERY:
+            APPL_MEASUREMENT_ReadBattery(&frame[length]);
+            length += 1;
+            break;
+
+        case APPL_BROADCAST_FRAME_COUNTERS:
+            for (uint32_t i = 0; i < APPL_BROADCAST_EVENT_COUNT; i++) {
+                length += BROADCAST_PutUint16(&frame[length], counters[i]);
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    if (TXW51_BLE_SetManufacturerData(frame, length) != ERR_NONE) {
+        TXW51_LOG_WARNING("[Broadcast] Could not set advertising data.");
+    }
+
+    nextFrame = (nextFrame + 1) % APPL_BROADCAST_FRAME_COUNT;
+    sequence++;
+}
+
+
+/***************************************************************************//**
+ * @brief Writes a value little-endian into the frame.
+ *
+ * @param[out] buffer Position in the frame.
+ * @param[in]  value  The value.
+ *
+ * @return Number of written bytes.
+ ******************************************************************************/
+static uint8_t BROADCAST_PutUint16(uint8_t *buffer, uint16_t value)
+{
+    buffer[0] = value & 0xFF;
+    buffer[1] = value >> 8;
+    return 2;
+}
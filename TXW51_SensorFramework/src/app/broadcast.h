@@ -0,0 +1,121 @@
+/***************************************************************************//**
+ * @brief   Connectionless telemetry in the advertising data.
+ *
+ * While the device advertises, a timer rotates a short summary through the
+ * manufacturer specific data of the advertising packet, so a scanner gets
+ * the state of the device without connecting. Every frame starts with its
+ * type and a sequence number, followed by the little-endian payload:
+ *
+ *  - APPL_BROADCAST_FRAME_TEMP:     int16 die temperature in 0.01 degC
+ *                                   (INT16_MIN if not available).
+ *  - APPL_BROADCAST_FRAME_MOTION:   uint16 RMS and uint16 peak of the
+ *                                   acceleration in mg since the last frame
+ *                                   of this type (0xFFFF if no samples).
+ *  - APPL_BROADCAST_FRAME_BATTERY:  uint8 raw value of the battery ADC.
+ *  - APPL_BROADCAST_FRAME_COUNTERS: uint16 connections, motion wake-ups and
+ *                                   FIFO overruns since the reset.
+ *
+ * @file    broadcast.h
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+#ifndef TXW51_APPLICATION_BROADCAST_H_
+#define TXW51_APPLICATION_BROADCAST_H_
+
+/*----- Header-Files ---------------------------------------------------------*/
+#include <stdint.h>
+
+/*----- Macros ---------------------------------------------------------------*/
+#define APPL_BROADCAST_DEFAULT_INTERVAL_MS  ( 2000 )    /**< Time between two frames if no interval is stored. */
+#define APPL_BROADCAST_MIN_INTERVAL_MS      ( 500 )     /**< Shortest allowed time between two frames. */
+
+/*----- Data types -----------------------------------------------------------*/
+/**
+ * @brief Types of the broadcast frames, in the order of the rotation.
+ */
+enum appl_broadcast_frame {
+    APPL_BROADCAST_FRAME_TEMP     = 0,  /**< Temperature of the chip. */
+    APPL_BROADCAST_FRAME_MOTION   = 1,  /**< Acceleration summary. */
+    APPL_BROADCAST_FRAME_BATTERY  = 2,  /**< Battery voltage. */
+    APPL_BROADCAST_FRAME_COUNTERS = 3,  /**< Event counters. */
+    APPL_BROADCAST_FRAME_COUNT          /**< Number of frame types. */
+};
+
+/**
+ * @brief Events counted for the APPL_BROADCAST_FRAME_COUNTERS frame.
+ */
+enum appl_broadcast_event {
+    APPL_BROADCAST_EVENT_CONNECTION,    /**< A peer has connected. */
+    APPL_BROADCAST_EVENT_WAKEUP,        /**< A motion has woken the device up. */
+    APPL_BROADCAST_EVENT_OVERRUN,       /**< A FIFO of the LSM330 has overrun. */
+    APPL_BROADCAST_EVENT_COUNT          /**< Number of counted events. */
+};
+
+/*----- Function prototypes --------------------------------------------------*/
+
+/***************************************************************************//**
+ * @brief Initializes the broadcast module.
+ *
+ * Creates the rotation timer and loads the interval from the key-value
+ * store. The timer module, the key-value store and the ADC have to be
+ * initialized before.
+ *
+ * @return ERR_NONE if no error occurred.
+ *         ERR_BROADCAST_TIMER_FAILED if the timer could not be created.
+ ******************************************************************************/
+extern uint32_t APPL_BROADCAST_Init(void);
+
+/***************************************************************************//**
+ * @brief Starts to broadcast, should be called when the advertising starts.
+ *
+ * The first frame is set immediately.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+extern void APPL_BROADCAST_Start(void);
+
+/***************************************************************************//**
+ * @brief Stops to broadcast and removes the frame from the advertising data.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+extern void APPL_BROADCAST_Stop(void);
+
+/***************************************************************************//**
+ * @brief Sets the time between two frames and saves it to the key-value store.
+ *
+ * A running broadcast continues with the new interval.
+ *
+ * @param[in] interval Interval in ms, 0 to disable the broadcast.
+ *
+ * @return ERR_NONE if no error occurred.
+ *         ERR_BROADCAST_INVALID_INTERVAL if the interval is too short.
+ ******************************************************************************/
+extern uint32_t APPL_BROADCAST_SetInterval(uint16_t interval);
+
+/***************************************************************************//**
+ * @brief Gets the time between two frames.
+ *
+ * @return Interval in ms, 0 if the broadcast is disabled.
+ ******************************************************************************/
+extern uint16_t APPL_BROADCAST_GetInterval(void);
+
+/***************************************************************************//**
+ * @brief Counts an event for the APPL_BROADCAST_FRAME_COUNTERS frame.
+ *
+ * The counters saturate at 0xFFFF.
+ *
+ * @param[in] event The event that occurred.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+extern void APPL_BROADCAST_CountEvent(enum appl_broadcast_event event);
+
+/*----- Data -----------------------------------------------------------------*/
+
+#endif /* TXW51_APPLICATION_BROADCAST_H_ */
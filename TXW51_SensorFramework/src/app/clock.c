@@ -0,0 +1,421 @@
+/***************************************************************************//**
+ * @brief   Time base of the device synchronized to the clock of the gateway.
+ *
+ * RTC1 is shared with the application timer and read through it. A repeated
+ * timer reads it at least once per wrap-around of its 24 bits, so the
+ * extension to 32 bits does not miss one.
+ *
+ * The pairs are kept in the order of their device time. When all entries are
+ * used, the pair closest to its predecessor is dropped, so the pairs thin out
+ * towards the past and span up to CLOCK_MAX_SPAN even with frequent
+ * exchanges. The long span is what makes the drift exact to a few ppm.
+ *
+ * The fit runs in fixed point: the device time in ticks relative to the
+ * newest pair, the gateway time relative to the newest pair and to the
+ * nominal rate in us, the drift in ppb. The residuals are scaled by
+ * CLOCK_FREQUENCY * 1000, so a correction in ppb times a device time in ticks
+ * needs no division.
+ *
+ * @file    clock.c
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+/*----- Header-Files ---------------------------------------------------------*/
+#include "clock.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "nrf/s110/nrf_soc.h"
+#include "nrf/app_common/app_timer.h"
+#include "nrf/sd_common/app_util_platform.h"
+
+#include "txw51_framework/config/config.h"
+#include "txw51_framework/utils/log.h"
+
+#include "app/error.h"
+
+/*----- Macros ---------------------------------------------------------------*/
+#define CLOCK_FREQUENCY             ( (int32_t)(APP_TIMER_CLOCK_FREQ / (CONFIG_TIMERS_PRESCALER + 1)) )    /**< Ticks of RTC1 per second, signed for the fit. */
+#define CLOCK_COUNTER_BITS          ( 24 )          /**< Width of the counter of RTC1. */
+#define CLOCK_EXTEND_PERIOD_MS      ( 3600000UL )   /**< Time between two reads of RTC1 by the timer, below its wrap-around. */
+#define CLOCK_MAX_PAIRS             ( 32 )          /**< Exchanges kept for the fit. */
+#define CLOCK_MAX_SPAN              ( 600L * CLOCK_FREQUENCY )  /**< Oldest pair of the fit before the newest one in ticks. */
+#define CLOCK_MIN_DRIFT_SPAN        ( 10L * CLOCK_FREQUENCY )   /**< Shortest time the pairs of the fit span to estimate the drift in ticks. */
+#define CLOCK_MIN_DRIFT_PAIRS       ( 4 )           /**< Fewest fitted pairs to estimate the drift. */
+#define CLOCK_ROUND_TRIP_SLACK_MS   ( 4 )           /**< Pairs with a round trip up to this longer than the shortest one are fitted. */
+#define CLOCK_MAX_DRIFT_PPB         ( 1000000L )    /**< Largest drift the fit searches. */
+#define CLOCK_RESOLUTION_US         ( 1500 )        /**< Error of a gateway time from the resolution of 1 ms of the send time and the round trip. */
+#define CLOCK_TICK_SCALED           ( 1000000000LL )    /**< One tick in us scaled by CLOCK_FREQUENCY * 1000. */
+#define CLOCK_STEP_MS               ( 100 )         /**< Deviation from the mapping beyond the drift and the round trip that drops the older pairs. */
+
+/*----- Data types -----------------------------------------------------------*/
+/**
+ * @brief Result of an exchange with the gateway.
+ */
+struct CLOCK_Pair {
+    uint32_t DeviceTime;    /**< Device time of the receipt in ticks. */
+    uint32_t GatewayTime;   /**< Gateway time at the receipt in ms. */
+    uint16_t RoundTrip;     /**< Round trip of the exchange in ms. */
+};
+
+/*----- Function prototypes --------------------------------------------------*/
+static void CLOCK_TimerHandler(void *context);
+static void CLOCK_DropPair(void);
+static void CLOCK_Fit(void);
+static int64_t CLOCK_GetBand(uint32_t fitted, uint16_t minRoundTrip, int32_t correction,
+                             int64_t *low, int64_t *high);
+static int64_t CLOCK_RoundDiv(int64_t value, int64_t divisor);
+
+/*----- Data -----------------------------------------------------------------*/
+static app_timer_id_t timerHandle;          /**< Reads RTC1 before it wraps around twice. */
+static uint32_t lastCounter = 0;            /**< Counter of RTC1 at the last read. */
+static uint32_t wraps = 0;                  /**< Wrap-arounds of RTC1 since the reset. */
+
+static struct CLOCK_Pair pairs[CLOCK_MAX_PAIRS];    /**< The recent exchanges, the oldest first. */
+static uint8_t numberOfPairs = 0;           /**< Valid entries in pairs. */
+
+static bool isSynchronized = false;         /**< The mapping below is valid. */
+static uint32_t refDeviceTime = 0;          /**< Device time of the newest pair. */
+static uint32_t refGatewayTime = 0;         /**< Gateway time of the newest pair. */
+static int32_t offsetUs = 0;                /**< Fitted gateway time at refDeviceTime relative to refGatewayTime. */
+static int32_t correctionPpb = 0;           /**< Gateway time per device time minus 1, the negative drift. */
+
+/*----- Implementation -------------------------------------------------------*/
+
+uint32_t APPL_CLOCK_Init(void)
+{
+    uint32_t err;
+
+    err = app_timer_create(&timerHandle,
+                           APP_TIMER_MODE_REPEATED,
+                           CLOCK_TimerHandler);
+    if (err == NRF_SUCCESS) {
+        err = app_timer_start(timerHandle,
+                              APP_TIMER_TICKS(CLOCK_EXTEND_PERIOD_MS, CONFIG_TIMERS_PRESCALER),
+                              NULL);
+    }
+    if (err != NRF_SUCCESS) {
+        TXW51_LOG_ERROR("[Clock] Could not start timer.");
+        return ERR_CLOCK_TIMER_FAILED;
+    }
+
+    APPL_CLOCK_GetTime();
+    return ERR_NONE;
+}
+
+
+/***************************************************************************//**
+ * @brief Extends RTC1 periodically.
+ *
+ * @param[in] context Not used.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void CLOCK_TimerHandler(void *context)
+{
+    APPL_CLOCK_GetTime();
+}
+
+
+uint32_t APPL_CLOCK_GetTime(void)
+{
+    uint32_t counter;
+    uint32_t time;
+
+    CRITICAL_REGION_ENTER();
+    app_timer_cnt_get(&counter);
+    if (counter < lastCounter) {
+        wraps++;
+    }
+    lastCounter = counter;
+    time = (wraps << CLOCK_COUNTER_BITS) | counter;
+    CRITICAL_REGION_EXIT();
+
+    return time;
+}
+
+
+uint32_t APPL_CLOCK_Synchronize(uint32_t deviceTime,
+                                uint32_t gatewayTime,
+                                uint16_t roundTrip)
+{
+    int32_t elapsed = (int32_t)(deviceTime - refDeviceTime);
+    int32_t limit;
+    uint32_t mapped;
+
+    if ((roundTrip > APPL_CLOCK_MAX_ROUND_TRIP_MS) ||
+        ((int32_t)(APPL_CLOCK_GetTime() - deviceTime) < 0) ||
+        ((numberOfPairs > 0) && (elapsed <= 0))) {
+        return ERR_CLOCK_INVALID_PAIR;
+    }
+
+    if (isSynchronized) {
+        APPL_CLOCK_ToGatewayTime(deviceTime, &mapped);
+        limit = CLOCK_STEP_MS + roundTrip +
+                (int32_t)((int64_t)elapsed * 1000 / CLOCK_FREQUENCY * CLOCK_MAX_DRIFT_PPB / 1000000000L);
+        if (abs((int32_t)(gatewayTime - mapped)) > limit) {
+            TXW51_LOG_WARNING("[Clock] Gateway clock has changed.");
+            numberOfPairs = 0;
+        }
+    }
+
+    if (numberOfPairs == CLOCK_MAX_PAIRS) {
+        CLOCK_DropPair();
+    }
+    pairs[numberOfPairs].DeviceTime = deviceTime;
+    pairs[numberOfPairs].GatewayTime = gatewayTime;
+    pairs[numberOfPairs].RoundTrip = roundTrip;
+    numberOfPairs++;
+
+    CLOCK_Fit();
+    return ERR_NONE;
+}
+
+
+/***************************************************************************//**
+ * @brief Drops a pair to make room for a new one.
+ *
+ * A pair beyond CLOCK_MAX_SPAN goes first, then one with a round trip that
+ * keeps it out of the fit, otherwise the one closest to its predecessor. The
+ * oldest and the newest pair are kept.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void CLOCK_DropPair(void)
+{
+    const struct CLOCK_Pair *newest = &pairs[numberOfPairs - 1];
+    uint16_t minRoundTrip = UINT16_MAX;
+    uint32_t smallestGap = UINT32_MAX;
+    uint32_t gap;
+    uint8_t victim = 0;
+
+    if ((int32_t)(newest->DeviceTime - pairs[0].DeviceTime) <= CLOCK_MAX_SPAN) {
+        for (uint8_t i = 0; i < numberOfPairs; i++) {
+            if (pairs[i].RoundTrip < minRoundTrip) {
+                minRoundTrip = pairs[i].RoundTrip;
+            }
+        }
+        for (uint8_t i = 1; i < numberOfPairs - 1; i++) {
+            gap = pairs[i].DeviceTime - pairs[i - 1].DeviceTime;
+            if (pairs[i].RoundTrip > minRoundTrip + CLOCK_ROUND_TRIP_SLACK_MS) {
+                gap = 0;
+            }
+            if (gap < smallestGap) {
+                smallestGap = gap;
+                victim = i;
+            }
+        }
+    }
+
+    memmove(&pairs[victim], &pairs[victim + 1], (numberOfPairs - victim - 1) * sizeof(pairs[0]));
+    numberOfPairs--;
+}
+
+
+/***************************************************************************//**
+ * @brief Fits the mapping through the pairs.
+ *
+ * Only the pairs within CLOCK_MAX_SPAN before the newest one and with a round
+ * trip close to the shortest one are used. A receipt lies anywhere within its
+ * tick, so with the right drift the gateway times less the mapped start of
+ * their ticks fill a band of one tick. Each gateway time is widened by its
+ * own error, CLOCK_RESOLUTION_US plus half the excess of its round trip. The
+ * drift is the middle of the drifts for which the widened pairs still fit
+ * into one tick, or the one that makes the band the narrowest if none does.
+ * The mapping goes through the middle of the band and so to the middle of a
+ * tick.
+ *
+ * Least squares and the plain narrowest band are both misled by receipts that
+ * stay in the same part of their ticks for a while, as they do with exchanges
+ * at a fixed interval. The set of fitting drifts is not, it only stays wide
+ * until the phase of the receipts has walked through a tick.
+ *
+ * The width of the band is convex in the drift, its minimum is searched by
+ * trisection and the edges of the fitting drifts by bisection. Until the
+ * pairs span CLOCK_MIN_DRIFT_SPAN, the previous drift is kept and only the
+ * offset is fitted.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void CLOCK_Fit(void)
+{
+    const struct CLOCK_Pair *newest = &pairs[numberOfPairs - 1];
+    uint16_t minRoundTrip = UINT16_MAX;
+    uint32_t fitted = 0;
+    uint8_t n = 0;
+    int32_t span = 0;
+    int32_t x;
+    int32_t lower = -CLOCK_MAX_DRIFT_PPB;
+    int32_t upper = CLOCK_MAX_DRIFT_PPB;
+    int32_t third;
+    int32_t middle;
+    int32_t first;
+    int32_t best;
+    int64_t low;
+    int64_t high;
+
+    for (uint8_t i = 0; i < numberOfPairs; i++) {
+        if (((int32_t)(newest->DeviceTime - pairs[i].DeviceTime) <= CLOCK_MAX_SPAN) &&
+            (pairs[i].RoundTrip < minRoundTrip)) {
+            minRoundTrip = pairs[i].RoundTrip;
+        }
+    }
+
+    for (uint8_t i = 0; i < numberOfPairs; i++) {
+        x = (int32_t)(pairs[i].DeviceTime - newest->DeviceTime);
+        if ((-x > CLOCK_MAX_SPAN) ||
+            (pairs[i].RoundTrip > minRoundTrip + CLOCK_ROUND_TRIP_SLACK_MS)) {
+            continue;
+        }
+        fitted |= 1UL << i;
+        n++;
+        if (-x > span) {
+            span = -x;
+        }
+    }
+
+    if ((span >= CLOCK_MIN_DRIFT_SPAN) && (n >= CLOCK_MIN_DRIFT_PAIRS)) {
+        /* The narrowest band. */
+        while (upper - lower > 2) {
+            third = (upper - lower) / 3;
+            if (CLOCK_GetBand(fitted, minRoundTrip, lower + third, &low, &high) <=
+                CLOCK_GetBand(fitted, minRoundTrip, upper - third, &low, &high)) {
+                upper -= third;
+            } else {
+                lower += third;
+            }
+        }
+        best = lower;
+        for (int32_t correction = lower + 1; correction <= upper; correction++) {
+            if (CLOCK_GetBand(fitted, minRoundTrip, correction, &low, &high) <
+                CLOCK_GetBand(fitted, minRoundTrip, best, &low, &high)) {
+                best = correction;
+            }
+        }
+
+        /* The middle of the drifts that fit all pairs into one tick. */
+        if (CLOCK_GetBand(fitted, minRoundTrip, best, &low, &high) <= CLOCK_TICK_SCALED) {
+            lower = -CLOCK_MAX_DRIFT_PPB;
+            upper = best;
+            while (lower < upper) {
+                middle = lower + (upper - lower) / 2;
+                if (CLOCK_GetBand(fitted, minRoundTrip, middle, &low, &high) <= CLOCK_TICK_SCALED) {
+                    upper = middle;
+                } else {
+                    lower = middle + 1;
+                }
+            }
+            first = lower;
+            lower = best;
+            upper = CLOCK_MAX_DRIFT_PPB;
+            while (lower < upper) {
+                middle = upper - (upper - lower) / 2;
+                if (CLOCK_GetBand(fitted, minRoundTrip, middle, &low, &high) <= CLOCK_TICK_SCALED) {
+                    lower = middle;
+                } else {
+                    upper = middle - 1;
+                }
+            }
+            best = first + (upper - first) / 2;
+        }
+        correctionPpb = best;
+    }
+
+    CLOCK_GetBand(fitted, minRoundTrip, correctionPpb, &low, &high);
+    refDeviceTime = newest->DeviceTime;
+    refGatewayTime = newest->GatewayTime;
+    offsetUs = (int32_t)CLOCK_RoundDiv(low + high, 2L * CLOCK_FREQUENCY * 1000);
+    isSynchronized = true;
+}
+
+
+/***************************************************************************//**
+ * @brief Computes the band of the fitted pairs for a drift.
+ *
+ * Each gateway time less the mapped device time is an interval of its error
+ * around the residual. The band reaches from the lowest upper end to the
+ * highest lower end, the part that no pair can explain with its error alone.
+ *
+ * @param[in]  fitted       Bit i set if pairs[i] is fitted, at least one.
+ * @param[in]  minRoundTrip The shortest round trip of the fitted pairs in ms.
+ * @param[in]  correction   The negative drift in ppb.
+ * @param[out] low          The lowest upper end, in us scaled by
+ *                          CLOCK_FREQUENCY * 1000.
+ * @param[out] high         The highest lower end.
+ *
+ * @return The width of the band, high - low, negative if the errors of the
+ *         pairs overlap.
+ ******************************************************************************/
+static int64_t CLOCK_GetBand(uint32_t fitted, uint16_t minRoundTrip, int32_t correction,
+                             int64_t *low, int64_t *high)
+{
+    const struct CLOCK_Pair *newest = &pairs[numberOfPairs - 1];
+    int64_t residual;
+    int64_t error;
+    int32_t x;
+
+    *low = INT64_MAX;
+    *high = INT64_MIN;
+    for (uint8_t i = 0; i < numberOfPairs; i++) {
+        if (!(fitted & (1UL << i))) {
+            continue;
+        }
+        x = (int32_t)(pairs[i].DeviceTime - newest->DeviceTime);
+        /* Gateway time less nominal device time in us, scaled. */
+        residual = (int64_t)(int32_t)(pairs[i].GatewayTime - newest->GatewayTime) * CLOCK_FREQUENCY * 1000000 -
+                   (int64_t)x * 1000000000 -
+                   (int64_t)correction * x;
+        /* A longer round trip allows for a larger asymmetry. */
+        error = ((int64_t)CLOCK_RESOLUTION_US + (pairs[i].RoundTrip - minRoundTrip) * 500) * CLOCK_FREQUENCY * 1000;
+        if (residual + error < *low) {
+            *low = residual + error;
+        }
+        if (residual - error > *high) {
+            *high = residual - error;
+        }
+    }
+    return *high - *low;
+}
+
+
+bool APPL_CLOCK_ToGatewayTime(uint32_t deviceTime, uint32_t *gatewayTime)
+{
+    int32_t x = (int32_t)(deviceTime - refDeviceTime);
+    int64_t us;
+
+    if (!isSynchronized) {
+        return false;
+    }
+
+    us = (int64_t)x * 1000000 / CLOCK_FREQUENCY + offsetUs +
+         (int64_t)correctionPpb * x / (CLOCK_FREQUENCY * 1000);
+    *gatewayTime = refGatewayTime + (int32_t)CLOCK_RoundDiv(us, 1000);
+    return true;
+}
+
+
+int32_t APPL_CLOCK_GetDrift(void)
+{
+    return -correctionPpb;
+}
+
+
+/***************************************************************************//**
+ * @brief Divides and rounds to the nearest integer.
+ *
+ * @param[in] value   The dividend.
+ * @param[in] divisor The divisor, positive.
+ *
+ * @return The rounded quotient.
+ ******************************************************************************/
+static int64_t CLOCK_RoundDiv(int64_t value, int64_t divisor)
+{
+    return (value >= 0) ? (value + divisor / 2) / divisor :
+                          -((-value + divisor / 2) / divisor);
+}
@@ -0,0 +1,112 @@
+/***************************************************************************//**
+ * @brief   Time base of the device synchronized to the clock of the gateway.
+ *
+ * The device time is the counter of RTC1, extended to 32 bits. At 128 Hz, it
+ * wraps around after 388 days. The gateway treats it as an opaque value.
+ *
+ * The gateway synchronizes it with a two-way exchange over the control point
+ * (see control.h): it sends its time, the device echoes it together with its
+ * time of receipt. The gateway takes the middle of the round trip as its time
+ * at the receipt and sends the pair back. The device fits a line through the
+ * recent pairs with the shortest round trips. Its slope is the drift of the
+ * RTC against the gateway clock, so a device time can be mapped to the
+ * gateway time between and after the exchanges.
+ *
+ * The receipt can be anywhere within its tick. The fit finds the drift from
+ * how the receipts move through their ticks over the exchanges and maps a
+ * device time to the gateway time at the middle of its tick. This needs the
+ * exchanges at varying phases to the tick: a gateway that exchanges at a
+ * fixed interval should add a random delay of some ms, otherwise the drift
+ * stays uncertain by about a tick over the span of the pairs.
+ *
+ * The gateway time of a pair is off by up to 1.5 ms from the resolution of
+ * 1 ms of the send time and the round trip, and by half the difference of
+ * the delays in the two directions, which no exchange can see. An answer that
+ * waits behind the data stream has a longer round trip and is left out, so
+ * the mapping stays within half a tick plus 1.5 ms plus half that asymmetry
+ * as long as some answers get through in the first connection event. Until
+ * the pairs span about half a minute, the drift is too uncertain for this
+ * between the exchanges.
+ *
+ * @file    clock.h
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+#ifndef TXW51_APPLICATION_CLOCK_H_
+#define TXW51_APPLICATION_CLOCK_H_
+
+/*----- Header-Files ---------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+
+/*----- Macros ---------------------------------------------------------------*/
+#define APPL_CLOCK_MAX_ROUND_TRIP_MS    ( 1000 )    /**< Longest round trip of an exchange that is accepted. */
+
+/*----- Data types -----------------------------------------------------------*/
+
+/*----- Function prototypes --------------------------------------------------*/
+
+/***************************************************************************//**
+ * @brief Initializes the device time.
+ *
+ * Needs the application timer, see timer.h.
+ *
+ * @return ERR_NONE if no error occurred.
+ *         ERR_CLOCK_TIMER_FAILED if the timer that extends RTC1 could not be
+ *         started.
+ ******************************************************************************/
+extern uint32_t APPL_CLOCK_Init(void);
+
+/***************************************************************************//**
+ * @brief Returns the device time.
+ *
+ * @return The device time in ticks of RTC1.
+ ******************************************************************************/
+extern uint32_t APPL_CLOCK_GetTime(void);
+
+/***************************************************************************//**
+ * @brief Adds the result of an exchange with the gateway.
+ *
+ * A pair that does not match the current mapping by far more than the drift
+ * and the round trip explain means that the gateway clock has been set or
+ * another gateway synchronizes. The older pairs are dropped then.
+ *
+ * @param[in] deviceTime  Device time of the receipt of the gateway time.
+ * @param[in] gatewayTime Gateway time at the receipt in ms.
+ * @param[in] roundTrip   Round trip of the exchange in ms.
+ *
+ * @return ERR_NONE if the pair has been added.
+ *         ERR_CLOCK_INVALID_PAIR if the round trip is too long or the device
+ *         time is not after the previous pair and in the past.
+ ******************************************************************************/
+extern uint32_t APPL_CLOCK_Synchronize(uint32_t deviceTime,
+                                       uint32_t gatewayTime,
+                                       uint16_t roundTrip);
+
+/***************************************************************************//**
+ * @brief Maps a device time to the gateway time.
+ *
+ * @param[in]  deviceTime  The device time, see APPL_CLOCK_GetTime().
+ * @param[out] gatewayTime The gateway time in ms.
+ *
+ * @return True if the clock has been synchronized, false otherwise.
+ ******************************************************************************/
+extern bool APPL_CLOCK_ToGatewayTime(uint32_t deviceTime, uint32_t *gatewayTime);
+
+/***************************************************************************//**
+ * @brief Returns the drift of RTC1 against the gateway clock.
+ *
+ * @return The drift in ppb, positive if RTC1 runs fast. 0 until the pairs
+ *         span enough time to estimate it, uncertain by about a tick over
+ *         that span.
+ ******************************************************************************/
+extern int32_t APPL_CLOCK_GetDrift(void);
+
+/*----- Data -----------------------------------------------------------------*/
+
+#endif /* TXW51_APPLICATION_CLOCK_H_ */
@@ -19,38 +19,119 @@
 #include <string.h>
 #include <stdio.h>
 
+#include "nrf/nrf_gpio.h"
+#include "nrf/app_common/app_scheduler.h"
+#include "nrf/app_common/app_timer.h"
+
+#include "txw51_framework/config/config.h"
 #include "txw51_framework/hw/tmp006.h"
 #include "txw51_framework/utils/log.h"
 
 #include "app/appl.h"
+#include "app/driver.h"
 #include "app/error.h"
 #include "app/fifo.h"
 
 /*----- Macros ---------------------------------------------------------------*/
+#define CONTACTLESS_TEMP_SAMPLE_SIZE    ( 4 )       /**< Object and die temperature, 2 bytes each. */
+#define CONTACTLESS_TEMP_RETRY_MS       ( 10 )      /**< Delay until a skipped read is retried while DRDY is low. */
 
 /*----- Data types -----------------------------------------------------------*/
 
 /*----- Function prototypes --------------------------------------------------*/
 static void CONTACTLESS_TEMP_BleEventHandler(struct TXW51_SERV_TEMP_CONTACTLESS_Handle *handle,
                                    struct TXW51_SERV_TEMP_CONTACTLESS_Event *evt);
+static void CONTACTLESS_TEMP_ReadSample(void *data, uint16_t size);
+static void CONTACTLESS_TEMP_RetryIfReady(void);
+static void CONTACTLESS_TEMP_RetryHandler(void *context);
+static void CONTACTLESS_TEMP_SampleRead(uint32_t err,
+                                        int16_t objectTemp,
+                                        int16_t dieTemp,
+                                        void *context);
+static uint32_t CONTACTLESS_TEMP_DriverInit(void);
+static uint32_t CONTACTLESS_TEMP_DriverConfigure(bool enable);
+static uint32_t CONTACTLESS_TEMP_DriverDrain(uint8_t *buffer, uint32_t size, uint32_t *length);
 
-static void CONTACTLESS_TEMP_GetTemperature(uint8_t *value);
 /*----- Data -----------------------------------------------------------------*/
+static struct TXW51_SERV_TEMP_CONTACTLESS_Handle *contactlessServiceHandle = NULL;    /**< Handle of the service, set at initialization. */
+static bool isMeasuring = false;
+static app_timer_id_t retryTimer;       /**< Retries a skipped read while DRDY is still low. */
+
+static const struct APPL_DRIVER_Driver tmp006Driver = {
+    .Name      = "TMP006",
+    .Format    = {
+        .SampleSize = CONTACTLESS_TEMP_SAMPLE_SIZE,
+        .Channels   = 2,
+        .PeriodMs   = 1000
+    },
+    .Init      = CONTACTLESS_TEMP_DriverInit,
+    .Configure = CONTACTLESS_TEMP_DriverConfigure,
+    .Drain     = CONTACTLESS_TEMP_DriverDrain
+};                                      /**< Driver that feeds the samples into the measurement stream. */
+static uint8_t driverId = 0;            /**< ID of the registered driver. */
+static bool isStreamed = false;         /**< The measurement of the Measurement service is running. */
+static bool hasSample = false;          /**< A sample waits to be drained. */
+static uint8_t lastSample[CONTACTLESS_TEMP_SAMPLE_SIZE];   /**< The sample to drain, little-endian. */
 
 /*----- Implementation -------------------------------------------------------*/
 
 void APPL_CONTACTLESS_TEMP_Init(void)
 {
-	//TXW51_SERV_TEMP_CONTACTLESS_Init();
+    uint32_t err;
+
+    isMeasuring = false;
+
+    err = app_timer_create(&retryTimer,
+                           APP_TIMER_MODE_SINGLE_SHOT,
+                           CONTACTLESS_TEMP_RetryHandler);
+    if (err != NRF_SUCCESS) {
+        TXW51_LOG_ERROR("[CONTACTLESS_TEMP Sensor] Could not create retry timer.");
+    }
+
+    err = APPL_DRIVER_Register(&tmp006Driver, &driverId);
+    if (err != ERR_NONE) {
+        TXW51_LOG_ERROR("[CONTACTLESS_TEMP Sensor] Could not initialize TMP006.");
+    }
 }
 
 
+void APPL_CONTACTLESS_TEMP_StartToMeasure(void)
+{
+    if (TXW51_TMP006_Start(APPL_CONTACTLESS_TEMP_SAMPLE_RATE) != ERR_NONE) {
+        TXW51_LOG_ERROR("[CONTACTLESS_TEMP Sensor] Could not start TMP006.");
+        return;
+    }
+
+    isMeasuring = true;
+}
+
+
+void APPL_CONTACTLESS_TEMP_StopToMeasure(void)
+{
+    isMeasuring = false;
+    app_timer_stop(retryTimer);
+
+    if (TXW51_TMP006_Stop() != ERR_NONE) {
+        TXW51_LOG_ERROR("[CONTACTLESS_TEMP Sensor] Could not stop TMP006.");
+    }
+}
+
 
 void APPL_CONTACTLESS_TEMP_SetupMotionWakeup(void)
 {
     //TXW51_CONTACTLESS_TEMP_SetMotionWakeup();
 }
 
+
+void APPL_CONTACTLESS_TEMP_HandleInterrupt(int32_t channel)
+{
+    if (channel == TXW51_TMP006_GPIO_DRDY_CHANNEL) {
+        if (app_sched_event_put(NULL, 0, CONTACTLESS_TEMP_ReadSample) != NRF_SUCCESS) {
+            CONTACTLESS_TEMP_RetryIfReady();
+        }
+    }
+}
+
 /* -------------------------------------------------------------------------- */
 
 
@@ -58,6 +139,8 @@ uint32_t APPL_CONTACTLESS_TEMP_InitService(struct TXW51_SERV_TEMP_CONTACTLESS_Ha
 {
     uint32_t err = ERR_NONE;
 
+    contactlessServiceHandle = serviceHandle;
+
     struct TXW51_SERV_TEMP_CONTACTLESS_Init init;
     init.EventHandler = CONTACTLESS_TEMP_BleEventHandler;
 
@@ -84,8 +167,11 @@ static void CONTACTLESS_TEMP_BleEventHandler(struct TXW51_SERV_TEMP_CONTACTLESS_
                                    struct TXW51_SERV_TEMP_CONTACTLESS_Event *evt)
 {
     switch (evt->EventType) {
-        case TXW51_SERV_TEMP_CONTACTLESS_EVT_TEMP_SAMPLE:
-            CONTACTLESS_TEMP_GetTemperature(evt->Value);
+        case TXW51_SERV_TEMP_CONTACTLESS_EVT_CONNECTED:
+            APPL_CONTACTLESS_TEMP_StartToMeasure();
+            break;
+        case TXW51_SERV_TEMP_CONTACTLESS_EVT_DISCONNECTED:
+            APPL_CONTACTLESS_TEMP_StopToMeasure();
             break;
         default:
             break;
@@ -93,19 +179,149 @@ static void CONTACTLESS_TEMP_BleEventHandler(struct TXW51_SERV_TEMP_CONTACTLESS_
 }
 
 
+/***************************************************************************//**
+ * @brief Reads a sample from the TMP006 sensor.
+ *
+ * Gets called by the scheduler after a DRDY interrupt. If a read is still
+ * pending, it is skipped and the pending read checks DRDY when it finishes.
+ *
+ * @param[in] data Not used.
+ * @param[in] size Not used.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void CONTACTLESS_TEMP_ReadSample(void *data, uint16_t size)
+{
+    uint32_t err;
+
+    if (!isMeasuring) {
+        return;
+    }
+
+    err = TXW51_TMP006_ReadSample(CONTACTLESS_TEMP_SampleRead, NULL);
+    if ((err != ERR_NONE) && (err != ERR_TMP006_BUSY)) {
+        TXW51_LOG_WARNING("[CONTACTLESS_TEMP Sensor] Could not read sample.");
+        CONTACTLESS_TEMP_RetryIfReady();
+    }
+}
+
+
+/***************************************************************************//**
+ * @brief Retries the read later if the TMP006 still signals DRDY.
+ *
+ * DRDY is only cleared by reading the result registers, and the interrupt
+ * triggers on its falling edge. Without the retry, a skipped read would stop
+ * the samples for good.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void CONTACTLESS_TEMP_RetryIfReady(void)
+{
+    if (isMeasuring && (nrf_gpio_pin_read(TXW51_TMP006_GPIO_DRDY) == 0)) {
+        app_timer_start(retryTimer,
+                        APP_TIMER_TICKS(CONTACTLESS_TEMP_RETRY_MS, CONFIG_TIMERS_PRESCALER),
+                        NULL);
+    }
+}
+
+
+/***************************************************************************//**
+ * @brief Reads the sample if DRDY is still low after the retry delay.
+ *
+ * @param[in] context Not used.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void CONTACTLESS_TEMP_RetryHandler(void *context)
+{
+    if (nrf_gpio_pin_read(TXW51_TMP006_GPIO_DRDY) == 0) {
+        CONTACTLESS_TEMP_ReadSample(NULL, 0);
+    }
+}
+
 
 /***************************************************************************//**
- * @brief Reads the temperature sensor.
+ * @brief Sends a new sample to the service.
  *
- * @param[out] value The temperature value.
+ * @param[in] err        Result of the sample read.
+ * @param[in] objectTemp The object temperature in 0.01 degC.
+ * @param[in] dieTemp    The die temperature in 0.01 degC.
+ * @param[in] context    Not used.
  *
  * @return Nothing.
  ******************************************************************************/
-static void CONTACTLESS_TEMP_GetTemperature(uint8_t *value)
+static void CONTACTLESS_TEMP_SampleRead(uint32_t err,
+                                        int16_t objectTemp,
+                                        int16_t dieTemp,
+                                        void *context)
 {
-    TXW51_TMP006_GetTemperature(value);
-    /* Convert sensor value to real temperature. */
+    /* A new conversion may have finished during the read. */
+    CONTACTLESS_TEMP_RetryIfReady();
+
+    if ((err != ERR_NONE) || !isMeasuring || (contactlessServiceHandle == NULL)) {
+        return;
+    }
 
     TXW51_LOG_DEBUG("[CONTACTLESS_TEMP Sensor] Temperature read.");
+
+    TXW51_SERV_TEMP_CONTACTLESS_SendTempSample(contactlessServiceHandle, objectTemp);
+
+    if (isStreamed) {
+        lastSample[0] = (uint16_t)objectTemp & 0xFF;
+        lastSample[1] = (uint16_t)objectTemp >> 8;
+        lastSample[2] = (uint16_t)dieTemp & 0xFF;
+        lastSample[3] = (uint16_t)dieTemp >> 8;
+        hasSample = true;
+        APPL_DRIVER_Drain(driverId);
+    }
 }
 
+
+/***************************************************************************//**
+ * @brief Initializes the TMP006 for the driver registry.
+ *
+ * @return ERR_NONE if no error occurred, the error of the TMP006 otherwise.
+ ******************************************************************************/
+static uint32_t CONTACTLESS_TEMP_DriverInit(void)
+{
+    return TXW51_TMP006_Init();
+}
+
+
+/***************************************************************************//**
+ * @brief Routes the samples into the measurement stream or not.
+ *
+ * The TMP006 itself runs while a peer is connected, because the contactless
+ * temperature service needs it too.
+ *
+ * @param[in] enable True if the measurement starts, false if it stops.
+ *
+ * @return ERR_NONE.
+ ******************************************************************************/
+static uint32_t CONTACTLESS_TEMP_DriverConfigure(bool enable)
+{
+    isStreamed = enable;
+    hasSample = false;
+    return ERR_NONE;
+}
+
+
+/***************************************************************************//**
+ * @brief Copies the last sample into the buffer of the driver registry.
+ *
+ * @param[out] buffer The buffer for the sample.
+ * @param[in]  size   Size of the buffer.
+ * @param[out] length Number of bytes copied.
+ *
+ * @return ERR_NONE.
+ ******************************************************************************/
+static uint32_t CONTACTLESS_TEMP_DriverDrain(uint8_t *buffer, uint32_t size, uint32_t *length)
+{
+    *length = 0;
+    if (hasSample && (size >= CONTACTLESS_TEMP_SAMPLE_SIZE)) {
+        memcpy(buffer, lastSample, CONTACTLESS_TEMP_SAMPLE_SIZE);
+        *length = CONTACTLESS_TEMP_SAMPLE_SIZE;
+        hasSample = false;
+    }
+    return ERR_NONE;
+}
@@ -20,31 +20,38 @@
 #include <stdint.h>
 
 #include "txw51_framework/ble/service_tempContactless.h"
+#include "txw51_framework/hw/tmp006.h"
 
 /*----- Macros ---------------------------------------------------------------*/
 #define APPL_CONTACTLESS_TEMP_VALUES_PER_FIFO_BLOCK     ( 20 )    /**< The level of the sensor FIFO until a watermark interrupt gets generated. */
+#define APPL_CONTACTLESS_TEMP_SAMPLE_RATE               ( TMP006_CFG_4SAMPLE )  /**< Averaged conversions per sample (one sample per second). */
 
 /*----- Data types -----------------------------------------------------------*/
 
 /*----- Function prototypes --------------------------------------------------*/
 
 /***************************************************************************//**
- * @brief Initializes the TMP006 sensor module..
+ * @brief Initializes the TMP006 sensor module.
+ *
+ * The sensor stays in power-down mode until a peer connects. The I2C
+ * interface has to be initialized before.
  *
  * @return Nothing.
  ******************************************************************************/
 extern void APPL_CONTACTLESS_TEMP_Init(void);
 
 /***************************************************************************//**
- * @brief Puts the sensors into measurement mode that have been enabled by the
- * Bluetooth Smart contactless Temp service .
+ * @brief Starts the continuous conversions of the TMP006 sensor.
+ *
+ * Every finished conversion is read on the DRDY interrupt and sent to the
+ * Bluetooth Smart contactless temperature service.
  *
  * @return Nothing.
  ******************************************************************************/
 extern void APPL_CONTACTLESS_TEMP_StartToMeasure(void);
 
 /***************************************************************************//**
- * @brief Stops the measurement mode of all sensors.
+ * @brief Puts the TMP006 sensor into power-down mode.
  *
  * @return Nothing.
  ******************************************************************************/
@@ -68,7 +75,7 @@ extern void APPL_CONTACTLESS_TEMP_SetupMotionWakeup(void);
 extern void APPL_CONTACTLESS_TEMP_HandleInterrupt(int32_t channel);
 
 /***************************************************************************//**
- * @brief Initializes the Bluetooth Smart LSM330 service.
+ * @brief Initializes the Bluetooth Smart contactless temperature service.
  *
  * @param[out] serviceHandle The handle for the service.
  *
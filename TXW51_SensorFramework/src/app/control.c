@@ -0,0 +1,246 @@
+/***************************************************************************//**
+ * @brief   Commands of the control point of the Measurement service.
+ *
+ * @file    control.c
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+/*----- Header-Files ---------------------------------------------------------*/
+#include "control.h"
+
+#include <string.h>
+
+#include "txw51_framework/hw/lsm330.h"
+
+/*----- Macros ---------------------------------------------------------------*/
+
+/*----- Data types -----------------------------------------------------------*/
+
+/*----- Function prototypes --------------------------------------------------*/
+static uint8_t CONTROL_ParseFixed(const uint8_t *data,
+                                  uint16_t length,
+                                  struct APPL_CONTROL_Command *command);
+static uint32_t CONTROL_GetUint32(const uint8_t *value);
+static uint8_t CONTROL_ParseField(uint8_t type,
+                                  const uint8_t *value,
+                                  uint8_t length,
+                                  struct APPL_CONTROL_Command *command);
+static uint8_t CONTROL_ParseSensor(const uint8_t *value,
+                                   uint8_t length,
+                                   uint8_t maxOdr,
+                                   uint8_t maxFscale,
+                                   uint8_t fifoSize,
+                                   struct APPL_SENSOR_Config *config);
+
+/*----- Data -----------------------------------------------------------------*/
+
+/*----- Implementation -------------------------------------------------------*/
+
+uint8_t APPL_CONTROL_Parse(const uint8_t *data,
+                           uint16_t length,
+                           struct APPL_CONTROL_Command *command,
+                           uint8_t *status)
+{
+    uint16_t offset = 1;
+    uint8_t result = APPL_CONTROL_STATUS_SUCCESS;
+    uint8_t type = 0;
+
+    memset(command, 0, sizeof(*command));
+    command->Opcode = (length > 0) ? data[0] : 0;
+
+    if ((command->Opcode < APPL_CONTROL_OP_CONFIGURE) ||
+        (command->Opcode > APPL_CONTROL_OP_TIME)) {
+        result = APPL_CONTROL_STATUS_UNKNOWN_OPCODE;
+    } else if (command->Opcode >= APPL_CONTROL_OP_ACK) {
+        result = CONTROL_ParseFixed(data, length, command);
+        offset = length;
+    }
+
+    while ((result == APPL_CONTROL_STATUS_SUCCESS) && (offset < length)) {
+        type = data[offset];
+        if ((length - offset < 2) || (length - offset - 2 < data[offset + 1])) {
+            result = APPL_CONTROL_STATUS_MALFORMED;
+            break;
+        }
+
+        result = CONTROL_ParseField(type, &data[offset + 2], data[offset + 1], command);
+        offset += 2 + data[offset + 1];
+    }
+
+    status[0] = command->Opcode;
+    status[1] = result;
+    status[2] = (result == APPL_CONTROL_STATUS_SUCCESS) ? 0 : type;
+    return result;
+}
+
+
+/***************************************************************************//**
+ * @brief Parses a command with a fixed format and without fields.
+ *
+ * @param[in]  data    The command.
+ * @param[in]  length  Length of the command in bytes.
+ * @param[out] command The command to set the values in.
+ *
+ * @return APPL_CONTROL_STATUS_SUCCESS or APPL_CONTROL_STATUS_MALFORMED if the
+ *         length does not match the opcode.
+ ******************************************************************************/
+static uint8_t CONTROL_ParseFixed(const uint8_t *data,
+                                  uint16_t length,
+                                  struct APPL_CONTROL_Command *command)
+{
+    switch (command->Opcode) {
+        case APPL_CONTROL_OP_ACK:
+            if ((length < APPL_CONTROL_ACK_LENGTH) ||
+                (length > APPL_CONTROL_ACK_LENGTH + APPL_CONTROL_MAX_MISSING)) {
+                return APPL_CONTROL_STATUS_MALFORMED;
+            }
+            command->Next = data[1];
+            command->NumberOfMissing = length - APPL_CONTROL_ACK_LENGTH;
+            memcpy(command->Missing, &data[APPL_CONTROL_ACK_LENGTH], command->NumberOfMissing);
+            return APPL_CONTROL_STATUS_SUCCESS;
+
+        case APPL_CONTROL_OP_SYNC:
+            if (length != APPL_CONTROL_SYNC_LENGTH) {
+                return APPL_CONTROL_STATUS_MALFORMED;
+            }
+            command->GatewayTime = CONTROL_GetUint32(&data[1]);
+            return APPL_CONTROL_STATUS_SUCCESS;
+
+        default:
+            if (length != APPL_CONTROL_TIME_LENGTH) {
+                return APPL_CONTROL_STATUS_MALFORMED;
+            }
+            command->DeviceTime = CONTROL_GetUint32(&data[1]);
+            command->GatewayTime = CONTROL_GetUint32(&data[5]);
+            command->RoundTrip = data[9] | (data[10] << 8);
+            return APPL_CONTROL_STATUS_SUCCESS;
+    }
+}
+
+
+/***************************************************************************//**
+ * @brief Reads a little endian 32 bit value.
+ *
+ * @param[in] value The first byte of the value.
+ *
+ * @return The value.
+ ******************************************************************************/
+static uint32_t CONTROL_GetUint32(const uint8_t *value)
+{
+    return value[0] | (value[1] << 8) | (value[2] << 16) | ((uint32_t)value[3] << 24);
+}
+
+
+/***************************************************************************//**
+ * @brief Parses and checks a TLV field.
+ *
+ * @param[in]     type    Type of the field.
+ * @param[in]     value   Value of the field.
+ * @param[in]     length  Length of the value in bytes.
+ * @param[in,out] command The command to set the field in.
+ *
+ * @return APPL_CONTROL_STATUS_SUCCESS or the status code of the rejection.
+ ******************************************************************************/
+static uint8_t CONTROL_ParseField(uint8_t type,
+                                  const uint8_t *value,
+                                  uint8_t length,
+                                  struct APPL_CONTROL_Command *command)
+{
+    uint8_t result;
+
+    switch (type) {
+        case APPL_CONTROL_TYPE_ACC:
+            result = CONTROL_ParseSensor(value, length,
+                                         TXW51_LSM330_ACC_ODR_1600,
+                                         TXW51_LSM330_ACC_FSCALE_16G,
+                                         TXW51_LSM330_ACC_FIFO_SIZE,
+                                         &command->Acc);
+            command->Fields |= APPL_CONTROL_FIELD_ACC;
+            return result;
+
+        case APPL_CONTROL_TYPE_GYRO:
+            result = CONTROL_ParseSensor(value, length,
+                                         TXW51_LSM330_GYRO_ODR_760,
+                                         TXW51_LSM330_GYRO_FSCALE_2000DPS,
+                                         TXW51_LSM330_GYRO_FIFO_SIZE,
+                                         &command->Gyro);
+            command->Fields |= APPL_CONTROL_FIELD_GYRO;
+            return result;
+
+        case APPL_CONTROL_TYPE_STREAM_MODE:
+            if (length != 1) {
+                return APPL_CONTROL_STATUS_INVALID_LENGTH;
+            }
+            if (value[0] > APPL_SENSOR_MODE_LOW_LATENCY) {
+                return APPL_CONTROL_STATUS_INVALID_VALUE;
+            }
+            command->StreamMode = value[0];
+            command->Fields |= APPL_CONTROL_FIELD_STREAM_MODE;
+            return APPL_CONTROL_STATUS_SUCCESS;
+
+        case APPL_CONTROL_TYPE_DURATION:
+            if (length != 2) {
+                return APPL_CONTROL_STATUS_INVALID_LENGTH;
+            }
+            command->Duration = value[0] | (value[1] << 8);
+            command->Fields |= APPL_CONTROL_FIELD_DURATION;
+            return APPL_CONTROL_STATUS_SUCCESS;
+
+        case APPL_CONTROL_TYPE_RELIABLE:
+            if (length != 1) {
+                return APPL_CONTROL_STATUS_INVALID_LENGTH;
+            }
+            if (value[0] > APPL_CONTROL_MAX_ACK_INTERVAL) {
+                return APPL_CONTROL_STATUS_INVALID_VALUE;
+            }
+            command->AckInterval = value[0];
+            command->Fields |= APPL_CONTROL_FIELD_RELIABLE;
+            return APPL_CONTROL_STATUS_SUCCESS;
+
+        default:
+            return APPL_CONTROL_STATUS_UNKNOWN_TYPE;
+    }
+}
+
+
+/***************************************************************************//**
+ * @brief Parses and checks the settings of a sensor.
+ *
+ * @param[in]  value     Value of the field.
+ * @param[in]  length    Length of the value in bytes.
+ * @param[in]  maxOdr    Highest ODR of the sensor.
+ * @param[in]  maxFscale Highest full-scale of the sensor.
+ * @param[in]  fifoSize  Size of the FIFO of the sensor.
+ * @param[out] config    The settings.
+ *
+ * @return APPL_CONTROL_STATUS_SUCCESS or the status code of the rejection.
+ ******************************************************************************/
+static uint8_t CONTROL_ParseSensor(const uint8_t *value,
+                                   uint8_t length,
+                                   uint8_t maxOdr,
+                                   uint8_t maxFscale,
+                                   uint8_t fifoSize,
+                                   struct APPL_SENSOR_Config *config)
+{
+    if (length != sizeof(*config)) {
+        return APPL_CONTROL_STATUS_INVALID_LENGTH;
+    }
+
+    config->Axes      = value[0];
+    config->Odr       = value[1];
+    config->Fscale    = value[2];
+    config->Watermark = value[3];
+
+    if ((config->Axes > APPL_SENSOR_ALL_AXES) ||
+        (config->Odr > maxOdr) ||
+        (config->Fscale > maxFscale) ||
+        (config->Watermark >= fifoSize)) {
+        return APPL_CONTROL_STATUS_INVALID_VALUE;
+    }
+    return APPL_CONTROL_STATUS_SUCCESS;
+}
@@ -0,0 +1,163 @@
+/***************************************************************************//**
+ * @brief   Commands of the control point of the Measurement service.
+ *
+ * A command configures the whole sensor profile with one write, so a gateway
+ * does not need a write request per characteristic. It is the opcode
+ * followed by TLV (type, length, value) fields:
+ *
+ *     | Opcode | Type | Length | Value... | Type | Length | Value... | ...
+ *
+ * Fields that are missing keep their current setting. The command is checked
+ * completely before anything is applied, a rejected command changes nothing.
+ * Every command is answered with one status notification:
+ *
+ *     | Opcode | Status | Type |
+ *
+ * where Type is the field that has been rejected, 0 if none.
+ *
+ * A full command with both sensors, the stream mode and the duration fits
+ * into the 20 bytes of a write.
+ *
+ * With the reliable field, the data stream is acknowledged by the gateway.
+ * The notifications are kept in a window until the gateway acknowledges them
+ * with
+ *
+ *     | 0x04 | Next | Missing... |
+ *
+ * where Next is the sequence number of the first packet it is missing, all
+ * packets before it have arrived. Missing lists up to 18 sequence numbers
+ * from Next on that have not arrived (selective repeat), only these packets
+ * are sent again. The gateway keeps the packets behind a gap and delivers
+ * them in order when the gap is filled. It acknowledges at least every ack
+ * interval packets and as soon as it detects a gap. It lists a packet again,
+ * and Next itself, if its retransmission does not arrive. Acknowledgements
+ * are not answered.
+ *
+ * The device time (see clock.h) gets synchronized to the gateway clock with
+ * a two-way exchange. The gateway writes its time in ms
+ *
+ *     | 0x05 | GatewayTime (4) |
+ *
+ * and the device answers it instead of a status with its time of receipt:
+ *
+ *     | 0x05 | GatewayTime (4) | DeviceTime (4) |
+ *
+ * The gateway takes GatewayTime plus half of the round trip until the answer
+ * arrived as its time at DeviceTime and returns the pair:
+ *
+ *     | 0x06 | DeviceTime (4) | GatewayTime (4) | RoundTrip (2) |
+ *
+ * It gets a status, an implausible pair is rejected as invalid value. The
+ * values are little endian. The gateway should repeat the exchange regularly,
+ * at least every few minutes, and right after it received a packet, so the
+ * write does not wait long for the next connection event.
+ *
+ * @file    control.h
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+#ifndef TXW51_APPLICATION_CONTROL_H_
+#define TXW51_APPLICATION_CONTROL_H_
+
+/*----- Header-Files ---------------------------------------------------------*/
+#include <stdint.h>
+
+#include "app/sensor.h"
+
+/*----- Macros ---------------------------------------------------------------*/
+#define APPL_CONTROL_STATUS_LENGTH  ( 3 )   /**< Length of the status notification. */
+#define APPL_CONTROL_ACK_LENGTH     ( 2 )   /**< Length of an acknowledgement without missing packets. */
+#define APPL_CONTROL_MAX_MISSING    ( 18 )  /**< Missing packets an acknowledgement lists at most. */
+#define APPL_CONTROL_SYNC_LENGTH    ( 5 )   /**< Length of a clock exchange. */
+#define APPL_CONTROL_SYNC_ANSWER_LENGTH ( 9 )   /**< Length of the answer to a clock exchange. */
+#define APPL_CONTROL_TIME_LENGTH    ( 11 )  /**< Length of the result of a clock exchange. */
+#define APPL_CONTROL_MAX_ACK_INTERVAL   ( 16 )  /**< Largest ack interval of the reliable mode, half of the window. */
+
+#define APPL_CONTROL_FIELD_ACC          ( 0x01 )    /**< APPL_CONTROL_Command.Acc is set. */
+#define APPL_CONTROL_FIELD_GYRO         ( 0x02 )    /**< APPL_CONTROL_Command.Gyro is set. */
+#define APPL_CONTROL_FIELD_STREAM_MODE  ( 0x04 )    /**< APPL_CONTROL_Command.StreamMode is set. */
+#define APPL_CONTROL_FIELD_DURATION     ( 0x08 )    /**< APPL_CONTROL_Command.Duration is set. */
+#define APPL_CONTROL_FIELD_RELIABLE     ( 0x10 )    /**< APPL_CONTROL_Command.AckInterval is set. */
+
+/*----- Data types -----------------------------------------------------------*/
+/**
+ * @brief The opcodes of the commands.
+ */
+enum APPL_CONTROL_Opcode {
+    APPL_CONTROL_OP_CONFIGURE = 0x01,   /**< Apply the fields, a running measurement gets restarted with them. */
+    APPL_CONTROL_OP_START     = 0x02,   /**< Apply the fields and start the measurement. */
+    APPL_CONTROL_OP_STOP      = 0x03,   /**< Apply the fields and stop the measurement. */
+    APPL_CONTROL_OP_ACK       = 0x04,   /**< Acknowledge the data stream in the reliable mode, without fields. */
+    APPL_CONTROL_OP_SYNC      = 0x05,   /**< Echo the gateway time with the device time, without fields. */
+    APPL_CONTROL_OP_TIME      = 0x06    /**< Synchronize the device time with the result of an exchange, without fields. */
+};
+
+/**
+ * @brief The types of the TLV fields.
+ */
+enum APPL_CONTROL_Type {
+    APPL_CONTROL_TYPE_ACC         = 0x01,   /**< Accelerometer: axes, ODR, full-scale, watermark (4 bytes, see struct APPL_SENSOR_Config). */
+    APPL_CONTROL_TYPE_GYRO        = 0x02,   /**< Gyroscope: axes, ODR, full-scale, watermark (4 bytes). */
+    APPL_CONTROL_TYPE_STREAM_MODE = 0x03,   /**< Stream mode, see enum APPL_SENSOR_StreamMode (1 byte). */
+    APPL_CONTROL_TYPE_DURATION    = 0x04,   /**< Duration of the measurement in s, 0 for unlimited (2 bytes, little endian). */
+    APPL_CONTROL_TYPE_RELIABLE    = 0x05    /**< Ack interval of the reliable mode in packets, 0 for off (1 byte). */
+};
+
+/**
+ * @brief The status codes of the status notification.
+ */
+enum APPL_CONTROL_Status {
+    APPL_CONTROL_STATUS_SUCCESS        = 0x00,  /**< The command has been applied. */
+    APPL_CONTROL_STATUS_UNKNOWN_OPCODE = 0x01,  /**< The opcode is not known. */
+    APPL_CONTROL_STATUS_MALFORMED      = 0x02,  /**< A field exceeds the command. */
+    APPL_CONTROL_STATUS_UNKNOWN_TYPE   = 0x03,  /**< The type of a field is not known. */
+    APPL_CONTROL_STATUS_INVALID_LENGTH = 0x04,  /**< A field has the wrong length. */
+    APPL_CONTROL_STATUS_INVALID_VALUE  = 0x05   /**< A field has a value out of range. */
+};
+
+/**
+ * @brief A checked command.
+ */
+struct APPL_CONTROL_Command {
+    uint8_t  Opcode;                    /**< See enum APPL_CONTROL_Opcode. */
+    uint8_t  Fields;                    /**< APPL_CONTROL_FIELD_* of the members that are set. */
+    struct APPL_SENSOR_Config Acc;      /**< Settings of the accelerometer. */
+    struct APPL_SENSOR_Config Gyro;     /**< Settings of the gyroscope. */
+    uint8_t  StreamMode;                /**< See enum APPL_SENSOR_StreamMode. */
+    uint16_t Duration;                  /**< Duration of the measurement in s, 0 for unlimited. */
+    uint8_t  AckInterval;               /**< Ack interval of the reliable mode, 0 for off. */
+    uint8_t  Next;                      /**< Sequence number acknowledged by APPL_CONTROL_OP_ACK. */
+    uint8_t  Missing[APPL_CONTROL_MAX_MISSING]; /**< Packets from Next on to send again. */
+    uint8_t  NumberOfMissing;           /**< Entries in Missing. */
+    uint32_t GatewayTime;               /**< Gateway time in ms of APPL_CONTROL_OP_SYNC and APPL_CONTROL_OP_TIME. */
+    uint32_t DeviceTime;                /**< Device time of APPL_CONTROL_OP_TIME. */
+    uint16_t RoundTrip;                 /**< Round trip in ms of APPL_CONTROL_OP_TIME. */
+};
+
+/*----- Function prototypes --------------------------------------------------*/
+
+/***************************************************************************//**
+ * @brief Parses and checks a command.
+ *
+ * @param[in]  data    The written value of the control point.
+ * @param[in]  length  Length of the value in bytes.
+ * @param[out] command The command, valid if APPL_CONTROL_STATUS_SUCCESS is
+ *                     returned.
+ * @param[out] status  The status notification to send.
+ *
+ * @return APPL_CONTROL_STATUS_SUCCESS if the command can be applied,
+ *         the status code of the rejection otherwise.
+ ******************************************************************************/
+extern uint8_t APPL_CONTROL_Parse(const uint8_t *data,
+                                  uint16_t length,
+                                  struct APPL_CONTROL_Command *command,
+                                  uint8_t *status);
+
+/*----- Data -----------------------------------------------------------------*/
+
+#endif /* TXW51_APPLICATION_CONTROL_H_ */
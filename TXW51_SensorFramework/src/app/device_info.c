@@ -1,8 +1,8 @@
 /***************************************************************************//**
  * @brief   Module that handles the device information values.
  *
- * Loads and saves the device information from and to the flash. It has also
- * default values for new devices.
+ * Loads and saves the device information from and to the key-value store. It
+ * has also default values for new devices.
  *
  * @file    device_info.c
  * @version 1.0
@@ -18,14 +18,24 @@
 
 #include <string.h>
 
-#include "nrf/app_common/pstorage.h"
 #include "nrf/nordic_common.h"
+#include "nrf/nrf.h"
 
+#include "txw51_framework/config/config.h"
+#include "txw51_framework/config/pstorage_platform.h"
+#include "txw51_framework/utils/kvstore.h"
 #include "txw51_framework/utils/log.h"
+#include "txw51_framework/utils/txw51_errors.h"
 
 #include "app/error.h"
+#include "app/kvstore_keys.h"
+#include "app/sensor.h"
 
 /*----- Macros ---------------------------------------------------------------*/
+/**
+ * @brief Address of the block that was used before the key-value store.
+ */
+#define APPL_DEVINFO_LEGACY_ADDRESS         ( PSTORAGE_DATA_START_ADDR )
 
 /*----- Data types -----------------------------------------------------------*/
 /**
@@ -39,12 +49,19 @@
  */
 #define APPL_DEVINFO_OUTPUT_BUFFER_LENGTH   ( APPL_DEVINFO_ENTRY_LENGHT + 30 )
 
+/**
+ * @brief The features of this firmware in the snapshot.
+ */
+#define APPL_DEVINFO_CAPABILITIES           ( APPL_DEVINFO_CAP_AUTO_START    | \
+                                              APPL_DEVINFO_CAP_STREAM_MODE   | \
+                                              APPL_DEVINFO_CAP_CONTROL_POINT | \
+                                              APPL_DEVINFO_CAP_DIAGNOSTICS   | \
+                                              APPL_DEVINFO_CAP_I2C_SCRIPT    | \
+                                              APPL_DEVINFO_CAP_OBJECT_TEMP   | \
+                                              APPL_DEVINFO_CAP_BROADCAST )
+
 /*----- Function prototypes --------------------------------------------------*/
-static void DEVINFO_CallbackHandler(pstorage_handle_t *handle,
-                                    uint8_t opCode,
-                                    uint32_t result,
-                                    uint8_t *data,
-                                    uint32_t dataLength);
+static bool DEVINFO_ImportLegacyBlock(void);
 
 static void DEVINFO_BleEventHandler(struct TXW51_SERV_DIS_Handle *handle,
                                     struct TXW51_SERV_DIS_Event *evt);
@@ -53,10 +70,11 @@ static void DEVINFO_UpdateValue(enum appl_devinfo_value entry,
                                 uint8_t *value,
                                 int32_t len);
 
+static uint16_t DEVINFO_ReadSnapshot(uint8_t *buffer);
+static uint16_t DEVINFO_PutString(uint8_t *buffer, const char *string);
+
 /*----- Data -----------------------------------------------------------------*/
-static pstorage_handle_t storageHandle;     /**< Handle for the flash storage. */
 static bool isDataLoaded = false;           /**< Flag to indicate when the data is loaded from flash. */
-static bool isOperationPending = false;     /**< Flag to indicate when a flash operation is pending. */
 
 /**
  * @brief Buffer to hold the device information.
@@ -80,104 +98,80 @@ static const char const *names[APPL_DEVINFO_NUM_OF_ENTRIES] = {
 
 uint32_t APPL_DEVINFO_Init(void)
 {
-    uint32_t err;
-
     /* Clear device information buffer. */
     memset(deviceInfo, '\0', APPL_DEVINFO_INFO_BUFFER_LENGTH);
-
-    /* Initialize flash module. */
-    err = pstorage_init();
-    if (err != NRF_SUCCESS) {
-        TXW51_LOG_ERROR("[DevInfo] Initialization failed.");
-        return ERR_DEVINFO_FLASH_INIT_FAILED;
-    }
-
-    pstorage_module_param_t storageParams = {
-        .cb = DEVINFO_CallbackHandler,
-        .block_size = APPL_DEVINFO_INFO_BUFFER_LENGTH + APPL_DEVINFO_FLAG_LENGTH,	//Add Flag for Power Save Mode
-        .block_count = 1
-    };
-
-    err = pstorage_register(&storageParams, &storageHandle);
-    if (err != NRF_SUCCESS) {
-        TXW51_LOG_ERROR("[DevInfo] Initialization failed.");
-        return ERR_DEVINFO_FLASH_INIT_FAILED;
-    }
+    memset(Flags, 0, APPL_DEVINFO_FLAG_LENGTH);
 
     TXW51_LOG_DEBUG("[DevInfo] Initialization successful.");
     return ERR_NONE;
 }
 
 
-/***************************************************************************//**
- * @brief Handle the callbacks of the flash module.
- *
- * @param[in] handle     Handle of the callback.
- * @param[in] op_code    The code of what triggered the callback.
- * @param[in] result     Shows whether the operation was successful or not.
- * @param[in] data       Data to the opCode when available.
- * @param[in] dataLength The length of the data.
- *
- * @return Nothing.
- ******************************************************************************/
-static void DEVINFO_CallbackHandler(pstorage_handle_t *handle,
-                                    uint8_t opCode,
-                                    uint32_t result,
-                                    uint8_t *data,
-                                    uint32_t dataLength)
+uint32_t APPL_DEVINFO_Load(void)
 {
-    switch(opCode) {
-        case PSTORAGE_ERROR_OP_CODE:
-            TXW51_LOG_ERROR("[DevInfo] An unknown error occurred.");
-            break;
-
-        case PSTORAGE_STORE_OP_CODE:
-            break;
-
-        case PSTORAGE_LOAD_OP_CODE:
-            if (result == NRF_SUCCESS) {
-                isDataLoaded = true;
-                TXW51_LOG_DEBUG("[DevInfo] Device information loaded.");
-            } else {
-                isDataLoaded = false;
-                TXW51_LOG_ERROR("[DevInfo] Device information could not be loaded.");
-            }
-            break;
+    uint32_t err;
+    uint8_t length;
+    bool isAnyValueStored = false;
 
-        case PSTORAGE_CLEAR_OP_CODE:
-            break;
+    for (int32_t i = 0; i < APPL_DEVINFO_NUM_OF_ENTRIES; i++) {
+        /* Keep space for the terminating zero. */
+        memset(deviceInfo[i], '\0', APPL_DEVINFO_ENTRY_LENGHT);
+        length = APPL_DEVINFO_ENTRY_LENGHT - 1;
+        err = TXW51_KVSTORE_Get(APPL_KVSTORE_KEY_DEVINFO + i, deviceInfo[i], &length);
+        if (err == ERR_NONE) {
+            isAnyValueStored = true;
+        } else if (err != ERR_KVSTORE_NOT_FOUND) {
+            TXW51_LOG_ERROR("[DevInfo] Device information could not be loaded.");
+            return ERR_DEVINFO_FLASH_LOAD_FAILED;
+        }
+    }
 
-        case PSTORAGE_UPDATE_OP_CODE:
-            if (result == NRF_SUCCESS) {
-                TXW51_LOG_INFO("[DevInfo] Device information updated.");
+    memset(Flags, 0, APPL_DEVINFO_FLAG_LENGTH);
+    length = APPL_DEVINFO_FLAG_LENGTH;
+    err = TXW51_KVSTORE_Get(APPL_KVSTORE_KEY_DEVINFO_FLAGS, Flags, &length);
+    if (err == ERR_NONE) {
+        isAnyValueStored = true;
+    } else if (err != ERR_KVSTORE_NOT_FOUND) {
+        TXW51_LOG_ERROR("[DevInfo] Device information could not be loaded.");
+        return ERR_DEVINFO_FLASH_LOAD_FAILED;
+    }
 
-            } else {
-                TXW51_LOG_ERROR("[DevInfo] Device information could not be updated.");
-            }
-            break;
+    if (!isAnyValueStored && DEVINFO_ImportLegacyBlock()) {
+        TXW51_LOG_INFO("[DevInfo] Device information imported.");
+        APPL_DEVINFO_Save();
     }
 
-    isOperationPending = false;
+    isDataLoaded = true;
+    TXW51_LOG_DEBUG("[DevInfo] Device information loaded.");
+
+    return ERR_NONE;
 }
 
 
-uint32_t APPL_DEVINFO_Load(void)
+/***************************************************************************//**
+ * @brief Reads the device information block of older firmware versions.
+ *
+ * Older firmware versions stored the entries and the flags in one block. The
+ * block is only read, it gets overwritten as soon as the flash page is used
+ * otherwise.
+ *
+ * @return True if the block has been found.
+ ******************************************************************************/
+static bool DEVINFO_ImportLegacyBlock(void)
 {
-    uint32_t err;
-    if (isOperationPending) {
-        return ERR_DEVINFO_OPERATION_PENDING;
-    }
+    const uint8_t *block = (const uint8_t *)APPL_DEVINFO_LEGACY_ADDRESS;
 
+    if (*(const uint32_t *)block == 0xFFFFFFFF) {
+        return false;
+    }
 
-    isOperationPending = true;
-    err = pstorage_load(deviceInfo[0], &storageHandle, APPL_DEVINFO_INFO_BUFFER_LENGTH, 0);
-    err = pstorage_load(Flags, &storageHandle, APPL_DEVINFO_FLAG_LENGTH, APPL_DEVINFO_INFO_BUFFER_LENGTH );
-    if (err != NRF_SUCCESS) {
-        TXW51_LOG_ERROR("[DevInfo] Device information could not be loaded.");
-        return ERR_DEVINFO_FLASH_LOAD_FAILED;
+    memcpy(deviceInfo, block, APPL_DEVINFO_INFO_BUFFER_LENGTH);
+    memcpy(Flags, block + APPL_DEVINFO_INFO_BUFFER_LENGTH, APPL_DEVINFO_FLAG_LENGTH);
+    for (int32_t i = 0; i < APPL_DEVINFO_NUM_OF_ENTRIES; i++) {
+        deviceInfo[i][APPL_DEVINFO_ENTRY_LENGHT - 1] = '\0';
     }
 
-    return ERR_NONE;
+    return true;
 }
 
 
@@ -212,28 +206,39 @@ uint32_t APPL_DEVINFO_Save(void)
 {
     uint32_t err;
 
-    if (isOperationPending) {
-        return ERR_DEVINFO_OPERATION_PENDING;
+    /* Unchanged values are not written again. */
+    for (int32_t i = 0; i < APPL_DEVINFO_NUM_OF_ENTRIES; i++) {
+        uint8_t length = strnlen((char *)deviceInfo[i], APPL_DEVINFO_ENTRY_LENGHT - 1);
+
+        if (length == 0) {
+            err = TXW51_KVSTORE_Delete(APPL_KVSTORE_KEY_DEVINFO + i);
+        } else {
+            err = TXW51_KVSTORE_Set(APPL_KVSTORE_KEY_DEVINFO + i, deviceInfo[i], length);
+        }
+        if (err != ERR_NONE) {
+            break;
+        }
+    }
+
+    if (err == ERR_NONE) {
+        err = TXW51_KVSTORE_Set(APPL_KVSTORE_KEY_DEVINFO_FLAGS, Flags, APPL_DEVINFO_FLAG_LENGTH);
     }
 
-    isOperationPending = true;
-    err = pstorage_update(&storageHandle, deviceInfo[0], APPL_DEVINFO_INFO_BUFFER_LENGTH, 0);
-    err = pstorage_update(&storageHandle, Flags, APPL_DEVINFO_FLAG_LENGTH, APPL_DEVINFO_INFO_BUFFER_LENGTH);
-    if (err != NRF_SUCCESS) {
+    if (err == ERR_KVSTORE_QUEUE_FULL) {
+        TXW51_LOG_WARNING("[DevInfo] Previous save still pending.");
+        return ERR_DEVINFO_OPERATION_PENDING;
+    } else if (err != ERR_NONE) {
         TXW51_LOG_ERROR("[DevInfo] Device information could not be saved.");
         return ERR_DEVINFO_FLASH_SAVE_FAILED;
     }
 
+    TXW51_LOG_INFO("[DevInfo] Device information updated.");
     return ERR_NONE;
 }
 
 
 uint32_t APPL_DEVINFO_Set(enum appl_devinfo_value entry, char *value)
 {
-    if (isOperationPending) {
-        return ERR_DEVINFO_OPERATION_PENDING;
-    }
-
     strlcpy((char *)deviceInfo[entry], value, APPL_DEVINFO_ENTRY_LENGHT);
 
     return ERR_NONE;
@@ -248,15 +253,7 @@ void APPL_DEVINFO_Get(enum appl_devinfo_value entry, char *buffer)
 
 uint32_t APPL_DEVINFO_IsBusy(void)
 {
-    uint32_t err;
-    uint32_t count;
-
-    err = pstorage_access_status_get(&count);
-    if (err != NRF_SUCCESS) {
-        count = -1;
-    }
-
-    return count;
+    return TXW51_KVSTORE_IsBusy() ? 1 : 0;
 }
 
 bool APPL_DEVINFO_IsPowerSaveDisabled(void)
@@ -366,6 +363,9 @@ static void DEVINFO_BleEventHandler(struct TXW51_SERV_DIS_Handle *handle,
                 TXW51_LOG_INFO("Power Save Mode: ON");
             }
             break;
+        case TXW51_SERV_DIS_EVT_READ_SNAPSHOT:
+            evt->Length = DEVINFO_ReadSnapshot(evt->Value);
+            break;
         default:
             break;
     }
@@ -390,3 +390,75 @@ static void DEVINFO_UpdateValue(enum appl_devinfo_value entry,
     strlcpy((char *)deviceInfo[entry], (char *)value, numberOfChars);
 }
 
+
+/***************************************************************************//**
+ * @brief Takes the snapshot of the device information and the sensor
+ *        settings.
+ *
+ * See device_info.h for the format.
+ *
+ * @param[out] buffer Buffer for the snapshot, at least
+ *                    TXW51_SERV_DIS_SNAPSHOT_MAX_LENGTH bytes.
+ *
+ * @return Length of the snapshot in bytes.
+ ******************************************************************************/
+static uint16_t DEVINFO_ReadSnapshot(uint8_t *buffer)
+{
+    struct APPL_SENSOR_Config acc;
+    struct APPL_SENSOR_Config gyro;
+    uint16_t length = 0;
+    uint8_t flags = 0;
+
+    APPL_SENSOR_GetAccConfig(&acc);
+    APPL_SENSOR_GetGyroConfig(&gyro);
+
+    if (APPL_SENSOR_IsAutoStartEnabled()) {
+        flags |= APPL_DEVINFO_SNAPSHOT_FLAG_AUTO_START;
+    }
+    if (APPL_DEVINFO_IsPowerSaveDisabled()) {
+        flags |= APPL_DEVINFO_SNAPSHOT_FLAG_POWER_SAVE_DISABLED;
+    }
+
+    buffer[length++] = APPL_DEVINFO_SNAPSHOT_VERSION;
+    buffer[length++] = APPL_DEVINFO_CAPABILITIES & 0xFF;
+    buffer[length++] = APPL_DEVINFO_CAPABILITIES >> 8;
+    buffer[length++] = acc.Axes;
+    buffer[length++] = acc.Odr;
+    buffer[length++] = acc.Fscale;
+    buffer[length++] = acc.Watermark;
+    buffer[length++] = gyro.Axes;
+    buffer[length++] = gyro.Odr;
+    buffer[length++] = gyro.Fscale;
+    buffer[length++] = gyro.Watermark;
+    buffer[length++] = APPL_SENSOR_IsLowLatency() ? APPL_SENSOR_MODE_LOW_LATENCY :
+                                                    APPL_SENSOR_MODE_THROUGHPUT;
+    buffer[length++] = flags;
+
+    for (int32_t i = 0; i < APPL_DEVINFO_NUM_OF_ENTRIES; i++) {
+        length += DEVINFO_PutString(&buffer[length], (char *)deviceInfo[i]);
+    }
+    length += DEVINFO_PutString(&buffer[length], CONFIG_BUILD_ID);
+
+    return length;
+}
+
+
+/***************************************************************************//**
+ * @brief Puts a string with its length into the snapshot.
+ *
+ * The string is cut to the length of the DIS characteristics, so the
+ * snapshot never exceeds TXW51_SERV_DIS_SNAPSHOT_MAX_LENGTH.
+ *
+ * @param[out] buffer Where to put the string.
+ * @param[in]  string The string.
+ *
+ * @return Number of bytes put into the buffer.
+ ******************************************************************************/
+static uint16_t DEVINFO_PutString(uint8_t *buffer, const char *string)
+{
+    uint8_t length = strnlen(string, TXW51_SERV_DIS_VALUE_MAX_LENGTH);
+
+    buffer[0] = length;
+    memcpy(&buffer[1], string, length);
+    return 1 + length;
+}
@@ -1,8 +1,24 @@
 /***************************************************************************//**
  * @brief   Module that handles the device information values.
  *
- * Loads and saves the device information from and to the flash. It has also
- * default values for new devices.
+ * Loads and saves the device information from and to the key-value store. It
+ * has also default values for new devices.
+ *
+ * The Snapshot characteristic of the DIS service returns the device
+ * information together with the sensor settings, so a gateway fills its cache
+ * with one (long) read instead of one read per characteristic. The format is
+ * packed, multi-byte values are little endian:
+ *
+ *     | Version | Capabilities (2) | Acc (4) | Gyro (4) | Stream mode | Flags |
+ *     | Length | Manufacturer... | Length | Model... | ... | Length | Build id... |
+ *
+ * Acc and Gyro are the settings of struct APPL_SENSOR_Config (axes, ODR,
+ * full-scale, watermark) like in a command of the control point. The fixed
+ * part fits into the first read of 22 bytes. It is followed by the strings
+ * manufacturer, model, serial number, hardware revision, firmware revision,
+ * device name and CONFIG_BUILD_ID, each with its length and without the
+ * terminating zero. A gateway skips unknown trailing data, new fields are
+ * appended and increase the version.
  *
  * @file    device_info.h
  * @version 1.0
@@ -35,6 +51,19 @@
 
 #define APPL_DEVINFO_FLAG_POWER_SAVE_DIS	0x01			/**< Flag to disable Power Save Mode */
 
+#define APPL_DEVINFO_SNAPSHOT_VERSION       ( 1 )       /**< Version of the snapshot format. */
+
+#define APPL_DEVINFO_CAP_AUTO_START         ( 0x0001 )  /**< The LSM330 service has the Auto Start characteristic. */
+#define APPL_DEVINFO_CAP_STREAM_MODE        ( 0x0002 )  /**< The LSM330 service has the Stream Mode characteristic. */
+#define APPL_DEVINFO_CAP_CONTROL_POINT      ( 0x0004 )  /**< The Measurement service has the Control Point characteristic. */
+#define APPL_DEVINFO_CAP_DIAGNOSTICS        ( 0x0008 )  /**< The Measurement service has the Diagnostics characteristic. */
+#define APPL_DEVINFO_CAP_I2C_SCRIPT         ( 0x0010 )  /**< The I2C service has the Script and Poll characteristics. */
+#define APPL_DEVINFO_CAP_OBJECT_TEMP        ( 0x0020 )  /**< The contactless temperature service sends the object temperature. */
+#define APPL_DEVINFO_CAP_BROADCAST          ( 0x0040 )  /**< The advertising data contains the sensor summaries. */
+
+#define APPL_DEVINFO_SNAPSHOT_FLAG_AUTO_START           ( 0x01 )    /**< Flags of the snapshot: the auto start is enabled. */
+#define APPL_DEVINFO_SNAPSHOT_FLAG_POWER_SAVE_DISABLED  ( 0x02 )    /**< Flags of the snapshot: the power save mode is disabled. */
+
 /*----- Data types -----------------------------------------------------------*/
 /**
  * @brief List of the different device information entries.
@@ -52,19 +81,21 @@ enum appl_devinfo_value {
 /*----- Function prototypes --------------------------------------------------*/
 
 /***************************************************************************//**
- * @brief Initializes the device information module and the flash.
+ * @brief Initializes the device information module.
+ *
+ * TXW51_KVSTORE_Init() has to be called before.
  *
  * @return ERR_NONE if no error occurred.
- *         ERR_DEVINFO_FLASH_INIT_FAILED if initialization of the flash failed.
  ******************************************************************************/
 extern uint32_t APPL_DEVINFO_Init(void);
 
 /***************************************************************************//**
  * @brief Loads the device information from the flash.
  *
+ * If the store is empty, the block of older firmware versions is imported
+ * and saved to the store.
+ *
  * @return ERR_NONE if no error occurred.
- *         ERR_DEVINFO_OPERATION_PENDING if already another flash operation is
- *                                       pending.
  *         ERR_DEVINFO_FLASH_LOAD_FAILED if values could not be read from flash.
  ******************************************************************************/
 extern uint32_t APPL_DEVINFO_Load(void);
@@ -80,8 +111,11 @@ extern uint32_t APPL_DEVINFO_PrintValues(void);
 /***************************************************************************//**
  * @brief Saves the device information to the flash.
  *
+ * Only changed entries are written. The writes finish in the background,
+ * see APPL_DEVINFO_IsBusy().
+ *
  * @return ERR_NONE if no error occurred.
- *         ERR_DEVINFO_OPERATION_PENDING if already another flash operation is
+ *         ERR_DEVINFO_OPERATION_PENDING if the previous save is still
  *                                       pending.
  *         ERR_DEVINFO_FLASH_SAVE_FAILED if values could not be written to the
  *                                       flash.
@@ -95,7 +129,6 @@ extern uint32_t APPL_DEVINFO_Save(void);
  * @param[in] value The new information value.
  *
  * @return ERR_NONE if no error occurred.
- *         ERR_DEVINFO_OPERATION_PENDING if a flash operation is pending.
  ******************************************************************************/
 extern uint32_t APPL_DEVINFO_Set(enum appl_devinfo_value entry, char *value);
 
@@ -114,8 +147,10 @@ extern void APPL_DEVINFO_Get(enum appl_devinfo_value entry, char *buffer);
 /***************************************************************************//**
  * @brief Test if the device info module is busy with a flash operation.
  *
- * @return Number of pending flash operations if no error occurred.
- *         -1 if an error occurred.
+ * The flash events are processed by the scheduler, so app_sched_execute()
+ * has to be called while waiting.
+ *
+ * @return 1 if flash operations are pending, 0 otherwise.
  ******************************************************************************/
 extern uint32_t APPL_DEVINFO_IsBusy(void);
 
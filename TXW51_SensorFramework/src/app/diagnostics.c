@@ -0,0 +1,95 @@
+/***************************************************************************//**
+ * @brief   Reports the peak usage of the RAM buffers.
+ *
+ * @file    diagnostics.c
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+/*----- Header-Files ---------------------------------------------------------*/
+#include "diagnostics.h"
+
+#include <stdio.h>
+
+#include "nrf/app_common/app_scheduler.h"
+
+#include "txw51_framework/config/config.h"
+#include "txw51_framework/utils/log.h"
+#include "txw51_framework/utils/stack.h"
+
+/*----- Macros ---------------------------------------------------------------*/
+#define DIAG_OUTPUT_BUFFER_LENGTH   ( 48 )  /**< Length of a log line. */
+
+/*----- Data types -----------------------------------------------------------*/
+
+/*----- Function prototypes --------------------------------------------------*/
+static uint8_t DIAG_PutUint16(uint8_t *buffer, uint16_t value);
+
+/*----- Data -----------------------------------------------------------------*/
+/**
+ * @brief Names of the FIFOs for the log, indexed by enum appl_fifo_type.
+ */
+static const char *fifoNames[APPL_FIFO_BUFFER_COUNT] = {
+    "ACC",
+    "GYRO",
+    "AUX0",
+    "AUX1"
+};
+
+/*----- Implementation -------------------------------------------------------*/
+
+uint16_t APPL_DIAG_Read(uint8_t *buffer)
+{
+    uint16_t length = 0;
+
+    length += DIAG_PutUint16(&buffer[length], TXW51_STACK_GetMaxUsage());
+    length += DIAG_PutUint16(&buffer[length], TXW51_STACK_GetSize());
+    buffer[length++] = app_sched_queue_utilization_get();
+    buffer[length++] = CONFIG_SCHED_QUEUE_SIZE;
+
+    for (int32_t i = 0; i < APPL_FIFO_BUFFER_COUNT; i++) {
+        length += DIAG_PutUint16(&buffer[length], APPL_FIFO_GetPeak(i));
+    }
+
+    return length;
+}
+
+
+void APPL_DIAG_PrintValues(void)
+{
+    char outputBuffer[DIAG_OUTPUT_BUFFER_LENGTH];
+
+    snprintf(outputBuffer, DIAG_OUTPUT_BUFFER_LENGTH, "[Diag] Stack     %4lu / %4lu bytes",
+             (unsigned long)TXW51_STACK_GetMaxUsage(), (unsigned long)TXW51_STACK_GetSize());
+    TXW51_LOG_INFO(outputBuffer);
+
+    snprintf(outputBuffer, DIAG_OUTPUT_BUFFER_LENGTH, "[Diag] Scheduler %4u / %4u events",
+             app_sched_queue_utilization_get(), CONFIG_SCHED_QUEUE_SIZE);
+    TXW51_LOG_INFO(outputBuffer);
+
+    for (int32_t i = 0; i < APPL_FIFO_BUFFER_COUNT; i++) {
+        snprintf(outputBuffer, DIAG_OUTPUT_BUFFER_LENGTH, "[Diag] FIFO %-4s %4lu bytes peak",
+                 fifoNames[i], (unsigned long)APPL_FIFO_GetPeak(i));
+        TXW51_LOG_INFO(outputBuffer);
+    }
+}
+
+
+/***************************************************************************//**
+ * @brief Writes a value in little-endian byte order.
+ *
+ * @param[out] buffer Where to write the value.
+ * @param[in]  value  The value to write.
+ *
+ * @return The number of bytes written.
+ ******************************************************************************/
+static uint8_t DIAG_PutUint16(uint8_t *buffer, uint16_t value)
+{
+    buffer[0] = value & 0xFF;
+    buffer[1] = value >> 8;
+    return 2;
+}
@@ -0,0 +1,61 @@
+/***************************************************************************//**
+ * @brief   Reports the peak usage of the RAM buffers.
+ *
+ * Collects the high-water marks that are needed to size the buffers: the
+ * stack, the scheduler queue and the application FIFOs. The gateway reads
+ * them as one little-endian record from the Diagnostics characteristic of
+ * the Measurement service:
+ *
+ *  - uint16 peak stack usage in bytes
+ *  - uint16 size of the stack in bytes
+ *  - uint8  peak number of events in the scheduler queue
+ *  - uint8  size of the scheduler queue
+ *  - uint16 peak occupancy in bytes of every FIFO, in the order of
+ *           enum appl_fifo_type
+ *
+ * The values are also logged after every connection.
+ *
+ * @file    diagnostics.h
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+#ifndef TXW51_APPLICATION_DIAGNOSTICS_H_
+#define TXW51_APPLICATION_DIAGNOSTICS_H_
+
+/*----- Header-Files ---------------------------------------------------------*/
+#include <stdint.h>
+
+#include "app/fifo.h"
+
+/*----- Macros ---------------------------------------------------------------*/
+#define APPL_DIAG_RECORD_LENGTH     ( 6 + 2 * APPL_FIFO_BUFFER_COUNT )  /**< Length of the record in bytes. */
+
+/*----- Data types -----------------------------------------------------------*/
+
+/*----- Function prototypes --------------------------------------------------*/
+
+/***************************************************************************//**
+ * @brief Writes the current high-water marks into a record.
+ *
+ * @param[out] buffer Buffer for the record, at least APPL_DIAG_RECORD_LENGTH
+ *                    bytes long.
+ *
+ * @return The length of the record in bytes.
+ ******************************************************************************/
+extern uint16_t APPL_DIAG_Read(uint8_t *buffer);
+
+/***************************************************************************//**
+ * @brief Logs the current high-water marks.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+extern void APPL_DIAG_PrintValues(void);
+
+/*----- Data -----------------------------------------------------------------*/
+
+#endif /* TXW51_APPLICATION_DIAGNOSTICS_H_ */
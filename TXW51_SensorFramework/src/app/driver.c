@@ -0,0 +1,191 @@
+/***************************************************************************//**
+ * @brief   Registry of the sensor drivers that feed the measurement stream.
+ *
+ * @file    driver.c
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+/*----- Header-Files ---------------------------------------------------------*/
+#include "driver.h"
+
+#include <stddef.h>
+#include <stdio.h>
+
+#include "txw51_framework/utils/log.h"
+
+#include "app/appl.h"
+#include "app/error.h"
+#include "app/fifo.h"
+#include "app/stream.h"
+
+/*----- Macros ---------------------------------------------------------------*/
+
+/*----- Data types -----------------------------------------------------------*/
+/**
+ * @brief State of a registered driver.
+ */
+struct DRIVER_Slot {
+    const struct APPL_DRIVER_Driver *Driver;    /**< The driver, NULL if the slot is free. */
+    uint8_t Id;                                 /**< ID of the driver, index of the slot. */
+    enum appl_fifo_type Buffer;                 /**< FIFO buffer of the samples. */
+    bool IsEnabled;                             /**< The measurement is running. */
+    bool HasData;                               /**< The FIFO buffer may hold samples. */
+};
+
+/*----- Function prototypes --------------------------------------------------*/
+static struct TXW51_SERV_MEASURE_DataPacket *DRIVER_ReadPacket(void *context);
+static void DRIVER_UpdateDataFlag(void);
+
+/*----- Data -----------------------------------------------------------------*/
+static struct DRIVER_Slot slots[APPL_DRIVER_MAX_DRIVERS];  /**< The registered drivers. */
+static uint8_t numberOfDrivers = 0;                         /**< Number of registered drivers. */
+
+/*----- Implementation -------------------------------------------------------*/
+
+uint32_t APPL_DRIVER_Register(const struct APPL_DRIVER_Driver *driver,
+                              uint8_t *id)
+{
+    char outputBuffer[60];
+    struct DRIVER_Slot *slot;
+    uint32_t err;
+
+    if ((driver == NULL) || (id == NULL) ||
+        (driver->Init == NULL) || (driver->Configure == NULL) || (driver->Drain == NULL) ||
+        (driver->Format.SampleSize == 0) || (driver->Format.SampleSize > APPL_DRIVER_MAX_SAMPLE_SIZE)) {
+        return ERR_DRIVER_INVALID_PARAM;
+    }
+    if (numberOfDrivers >= APPL_DRIVER_MAX_DRIVERS) {
+        return ERR_DRIVER_NO_SLOT;
+    }
+
+    err = driver->Init();
+    if (err != ERR_NONE) {
+        return err;
+    }
+
+    slot = &slots[numberOfDrivers];
+    slot->Driver    = driver;
+    slot->Id        = numberOfDrivers;
+    slot->Buffer    = APPL_FIFO_BUFFER_AUX_0 + numberOfDrivers;
+    slot->IsEnabled = false;
+    slot->HasData   = false;
+
+    struct APPL_FIFO_Format format = {
+        .SampleSize = driver->Format.SampleSize,
+        .Axis       = slot->Id + 1,
+        .AccOrGyro  = 0,
+        .IsDriver   = true,
+        .Rate       = (driver->Format.PeriodMs > 0) ? (1000 + driver->Format.PeriodMs - 1) / driver->Format.PeriodMs : 1
+    };
+    APPL_FIFO_SetFormat(slot->Buffer, &format);
+
+    struct APPL_STREAM_Init streamInit = {
+        .Read       = DRIVER_ReadPacket,
+        .Context    = slot,
+        .Weight     = 1,
+        .DeadlineMs = APPL_DRIVER_DEADLINE_MS
+    };
+    err = APPL_STREAM_Register(APPL_STREAM_AUX_0 + numberOfDrivers, &streamInit);
+    if (err != ERR_NONE) {
+        slot->Driver = NULL;
+        return err;
+    }
+
+    *id = numberOfDrivers;
+    numberOfDrivers++;
+
+    snprintf(outputBuffer, sizeof(outputBuffer), "[Driver] Registered %s as %u.",
+             driver->Name, *id);
+    TXW51_LOG_INFO(outputBuffer);
+    return ERR_NONE;
+}
+
+
+void APPL_DRIVER_ConfigureAll(bool enable)
+{
+    for (uint32_t i = 0; i < numberOfDrivers; i++) {
+        struct DRIVER_Slot *slot = &slots[i];
+
+        if (slot->Driver->Configure(enable) != ERR_NONE) {
+            TXW51_LOG_WARNING("[Driver] Could not configure sensor.");
+            continue;
+        }
+        slot->IsEnabled = enable;
+    }
+}
+
+
+void APPL_DRIVER_Drain(uint8_t id)
+{
+    uint8_t buffer[APPL_DRIVER_DRAIN_SIZE];
+    uint32_t length = 0;
+    uint32_t err;
+
+    if ((id >= numberOfDrivers) || !slots[id].IsEnabled) {
+        return;
+    }
+
+    struct DRIVER_Slot *slot = &slots[id];
+    uint8_t sampleSize = slot->Driver->Format.SampleSize;
+
+    err = slot->Driver->Drain(buffer, sizeof(buffer) - (sizeof(buffer) % sampleSize), &length);
+    if (err != ERR_NONE) {
+        APPL_FIFO_PutDiscontinuity(slot->Buffer);
+    }
+
+    length -= length % sampleSize;
+    if (length > 0) {
+        APPL_FIFO_Put(slot->Buffer, buffer, length / sampleSize);
+    }
+
+    slot->HasData = true;
+    gIsNewDriverDataAvailable = true;
+}
+
+
+/***************************************************************************//**
+ * @brief Takes the next packet of a driver.
+ *
+ * This function gets called from the packet scheduler.
+ *
+ * @param[in] context The slot of the driver.
+ *
+ * @return The packet, NULL if there is no data.
+ ******************************************************************************/
+static struct TXW51_SERV_MEASURE_DataPacket *DRIVER_ReadPacket(void *context)
+{
+    struct DRIVER_Slot *slot = context;
+    struct TXW51_SERV_MEASURE_DataPacket *packet;
+
+    if (!slot->HasData) {
+        return NULL;
+    }
+
+    packet = APPL_FIFO_Take(slot->Buffer, true);
+    if (packet == NULL) {
+        slot->HasData = false;
+        DRIVER_UpdateDataFlag();
+    }
+    return packet;
+}
+
+
+/***************************************************************************//**
+ * @brief Clears the global data flag if no driver has data left.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void DRIVER_UpdateDataFlag(void)
+{
+    for (uint32_t i = 0; i < numberOfDrivers; i++) {
+        if (slots[i].HasData) {
+            return;
+        }
+    }
+    gIsNewDriverDataAvailable = false;
+}
@@ -0,0 +1,123 @@
+/***************************************************************************//**
+ * @brief   Registry of the sensor drivers that feed the measurement stream.
+ *
+ * A sensor gets streamed by registering a driver with its callbacks and the
+ * format of its samples. Every registered driver gets its own FIFO buffer
+ * and stream in the packet scheduler, so its samples get batched and sent
+ * with the notifications of the Measurement service like the LSM330 data.
+ *
+ * The samples of a driver are sent in packets without LSM330 samples:
+ * NumberOfSamples is 0, Axis holds the driver ID + 1, Data[0] the number of
+ * samples and Data[1..] the samples in the format of the driver. A packet
+ * with 0 samples marks a discontinuity, Data[1] holds its count.
+ *
+ * @file    driver.h
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+#ifndef TXW51_APPLICATION_DRIVER_H_
+#define TXW51_APPLICATION_DRIVER_H_
+
+/*----- Header-Files ---------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+
+/*----- Macros ---------------------------------------------------------------*/
+#define APPL_DRIVER_MAX_DRIVERS     ( 2 )       /**< Number of drivers that can be registered. */
+#define APPL_DRIVER_MAX_SAMPLE_SIZE ( 17 )      /**< Largest sample in bytes, one sample has to fit into a packet. */
+#define APPL_DRIVER_DRAIN_SIZE      ( 68 )      /**< Bytes a driver can deliver per drain. */
+#define APPL_DRIVER_DEADLINE_MS     ( 250 )     /**< Longest time the samples of a driver wait while the link is saturated. */
+
+/*----- Data types -----------------------------------------------------------*/
+/**
+ * @brief Format of the samples of a driver.
+ */
+struct APPL_DRIVER_Format {
+    uint8_t  SampleSize;    /**< Bytes per sample. */
+    uint8_t  Channels;      /**< Values per sample, little-endian and of equal size. */
+    uint16_t PeriodMs;      /**< Time between two samples in ms. */
+};
+
+/**
+ * @brief Callbacks and sample format of a sensor driver.
+ */
+struct APPL_DRIVER_Driver {
+    const char *Name;                   /**< Name of the sensor for the log. */
+    struct APPL_DRIVER_Format Format;   /**< Format of the samples. */
+
+    /**
+     * @brief Initializes the sensor.
+     *
+     * @return ERR_NONE if no error occurred, an error code otherwise.
+     */
+    uint32_t (*Init)(void);
+
+    /**
+     * @brief Enables or disables the sensor for the measurement.
+     *
+     * @param[in] enable True if the measurement starts, false if it stops.
+     *
+     * @return ERR_NONE if no error occurred, an error code otherwise.
+     */
+    uint32_t (*Configure)(bool enable);
+
+    /**
+     * @brief Copies the available samples of the sensor into a buffer.
+     *
+     * @param[out] buffer The buffer for the samples.
+     * @param[in]  size   Size of the buffer, a multiple of the sample size.
+     * @param[out] length Number of bytes copied, a multiple of the sample size.
+     *
+     * @return ERR_NONE if no error occurred, an error code if samples have
+     *         been lost.
+     */
+    uint32_t (*Drain)(uint8_t *buffer, uint32_t size, uint32_t *length);
+};
+
+/*----- Function prototypes --------------------------------------------------*/
+
+/***************************************************************************//**
+ * @brief Registers and initializes a sensor driver.
+ *
+ * The driver gets the next free FIFO buffer and stream. APPL_FIFO_Init() has
+ * to be called before the first drain.
+ *
+ * @param[in]  driver The driver, has to stay valid.
+ * @param[out] id     The ID of the driver.
+ *
+ * @return ERR_NONE if no error occurred.
+ *         ERR_DRIVER_INVALID_PARAM if the driver is invalid.
+ *         ERR_DRIVER_NO_SLOT if APPL_DRIVER_MAX_DRIVERS are registered.
+ *         The error of the Init callback if it failed.
+ ******************************************************************************/
+extern uint32_t APPL_DRIVER_Register(const struct APPL_DRIVER_Driver *driver,
+                                     uint8_t *id);
+
+/***************************************************************************//**
+ * @brief Enables or disables all registered drivers for the measurement.
+ *
+ * @param[in] enable True if the measurement starts, false if it stops.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+extern void APPL_DRIVER_ConfigureAll(bool enable);
+
+/***************************************************************************//**
+ * @brief Moves the available samples of a driver into its FIFO buffer.
+ *
+ * Should be called when the sensor has new samples, for example after a
+ * data ready interrupt. Does nothing while the driver is disabled.
+ *
+ * @param[in] id The ID of the driver.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+extern void APPL_DRIVER_Drain(uint8_t id);
+
+/*----- Data -----------------------------------------------------------------*/
+#endif /* TXW51_APPLICATION_DRIVER_H_ */
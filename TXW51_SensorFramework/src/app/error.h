@@ -45,6 +45,24 @@ enum appl_errors {
     ERR_FIFO_INIT_FAILED,                                   /**< The initialization of the FIFO failed. */
     ERR_FIFO_PUT_FAILED,                                    /**< Could not put values into the FIFO. */
     ERR_FIFO_GET_FAILED,                                    /**< Could not get values from the FIFO. */
+
+    ERR_STREAM_INVALID_PARAM,                               /**< The stream or its read callback is invalid. */
+
+    ERR_DRIVER_INVALID_PARAM,                               /**< The sensor driver is invalid. */
+    ERR_DRIVER_NO_SLOT,                                     /**< All sensor driver slots are used. */
+
+    ERR_I2C_POLL_INIT_FAILED,                               /**< The initialization of the I2C polling timer has failed. */
+    ERR_I2C_POLL_START_FAILED,                              /**< Could not start the I2C polling job. */
+
+    ERR_BROADCAST_TIMER_FAILED,                             /**< The broadcast timer could not be created. */
+    ERR_BROADCAST_INVALID_INTERVAL,                         /**< The broadcast interval is too short. */
+
+    ERR_MEASUREMENT_TIMER_FAILED,                           /**< The timer of the measurement duration could not be created. */
+
+    ERR_CLOCK_TIMER_FAILED,                                 /**< The timer that extends RTC1 could not be started. */
+    ERR_CLOCK_INVALID_PAIR,                                 /**< The result of a clock exchange is not plausible. */
+
+    ERR_SPI_TEST_FAILED,                                    /**< No SPI clock passed the self-test. */
 };
 
 /*----- Function prototypes --------------------------------------------------*/
@@ -13,7 +13,7 @@
 /*----- Header-Files ---------------------------------------------------------*/
 #include "fifo.h"
 
-#include "nrf/app_common/app_fifo.h"
+#include <string.h>
 
 #include "txw51_framework/utils/log.h"
 
@@ -22,85 +22,451 @@
 /*----- Macros ---------------------------------------------------------------*/
 
 /*----- Data types -----------------------------------------------------------*/
+/**
+ * @brief State of a FIFO.
+ *
+ * The slots follow each other from Tail on: the taken ones, the waiting
+ * ones and the open one that is being filled.
+ */
+struct FIFO_Buffer {
+    struct TXW51_SERV_MEASURE_DataPacket *Slots;    /**< Memory of the slots. */
+    uint8_t Size;               /**< Number of slots. */
+    uint8_t Tail;               /**< Index of the oldest slot that has not been released. */
+    uint8_t Taken;              /**< Slots taken and not released yet. */
+    uint8_t Waiting;            /**< Closed slots that have not been taken yet. */
+    uint8_t Fill;               /**< Samples in the open slot. */
+    uint8_t Lost;               /**< Discontinuities that wait for a free slot. */
+    uint8_t Markers;            /**< Waiting slots with a discontinuity. */
+    uint8_t LastMarker;         /**< Index of the newest of them, valid if Markers > 0. */
+    bool    IsDropping;         /**< Samples have been dropped since the last commit. */
+    uint8_t Peak;               /**< Highest number of used slots. */
+    struct APPL_FIFO_Format Format;     /**< Format of the packets. */
+};
 
 /*----- Function prototypes --------------------------------------------------*/
+static struct TXW51_SERV_MEASURE_DataPacket *FIFO_GetSlot(struct FIFO_Buffer *fifo,
+                                                          uint32_t position);
+static uint8_t FIFO_GetOffset(const struct FIFO_Buffer *fifo);
+static uint8_t FIFO_GetCapacity(const struct FIFO_Buffer *fifo);
+static uint32_t FIFO_GetFree(const struct FIFO_Buffer *fifo);
+static bool FIFO_IsMarker(const struct FIFO_Buffer *fifo,
+                          const struct TXW51_SERV_MEASURE_DataPacket *slot);
+static void FIFO_Close(struct FIFO_Buffer *fifo);
+static void FIFO_FlushLost(struct FIFO_Buffer *fifo);
+static void FIFO_UpdatePeak(struct FIFO_Buffer *fifo);
 
 /*----- Data -----------------------------------------------------------------*/
-static app_fifo_t fifoHandleAcc;    /**< Handle of the FIFO for the acceleration values. */
-static app_fifo_t fifoHandleGyro;   /**< Handle of the FIFO for the gyroscope values. */
-static uint8_t bufferAcc[APPL_FIFO_BUFFER_SIZE_ACC];    /**< Memory of the acceleration FIFO. */
-static uint8_t bufferGyro[APPL_FIFO_BUFFER_SIZE_GYRO];  /**< Memory of the gyroscope FIFO. */
+static struct TXW51_SERV_MEASURE_DataPacket slots[APPL_FIFO_SLOTS];  /**< Pool of the slots, shared by the FIFOs in their order. */
+static struct FIFO_Buffer fifos[APPL_FIFO_BUFFER_COUNT];            /**< The FIFOs, indexed by enum appl_fifo_type. */
 
 /*----- Implementation -------------------------------------------------------*/
 
 uint32_t APPL_FIFO_Init(void)
 {
-    uint32_t err;
+    APPL_FIFO_Reset();
+
+    TXW51_LOG_DEBUG("[FIFO] Initialization successful.");
+    return ERR_NONE;
+}
+
 
-    err = app_fifo_init(&fifoHandleAcc, bufferAcc, APPL_FIFO_BUFFER_SIZE_ACC);
-    if (err != NRF_SUCCESS) {
-        TXW51_LOG_ERROR("[FIFO] Initialization failed.");
-        return ERR_FIFO_INIT_FAILED;
+void APPL_FIFO_Reset(void)
+{
+    uint32_t rates[APPL_FIFO_BUFFER_COUNT];
+    uint32_t total = 0;
+    uint32_t shared = 0;
+    uint32_t numberUsed = 0;
+    uint32_t used = 0;
+    uint32_t first = 0;
+    uint32_t end;
+
+    /* Packets per 1000 s, the slots of the drivers hold fewer samples. */
+    for (uint32_t i = 0; i < APPL_FIFO_BUFFER_COUNT; i++) {
+        rates[i] = 0;
+        if ((fifos[i].Format.SampleSize > 0) && (fifos[i].Format.Rate > 0)) {
+            rates[i] = (uint32_t)fifos[i].Format.Rate * 1000 / FIFO_GetCapacity(&fifos[i]) + 1;
+            total += rates[i];
+            numberUsed++;
+        }
     }
 
-    err = app_fifo_init(&fifoHandleGyro, bufferGyro, APPL_FIFO_BUFFER_SIZE_GYRO);
-    if (err != NRF_SUCCESS) {
-        TXW51_LOG_ERROR("[FIFO] Initialization failed.");
-        return ERR_FIFO_INIT_FAILED;
+    for (uint32_t i = 0; i < APPL_FIFO_BUFFER_COUNT; i++) {
+        end = first;
+        if (rates[i] > 0) {
+            shared += rates[i];
+            used++;
+            end = used * APPL_FIFO_MIN_SLOTS +
+                  (APPL_FIFO_SLOTS - numberUsed * APPL_FIFO_MIN_SLOTS) * shared / total;
+        }
+
+        fifos[i].Slots      = &slots[first];
+        fifos[i].Size       = end - first;
+        fifos[i].Tail       = 0;
+        fifos[i].Taken      = 0;
+        fifos[i].Waiting    = 0;
+        fifos[i].Fill       = 0;
+        fifos[i].Lost       = 0;
+        fifos[i].Markers    = 0;
+        fifos[i].IsDropping = false;
+        fifos[i].Peak       = 0;
+        first = end;
     }
+}
 
-    TXW51_LOG_DEBUG("[FIFO] Initialization successful.");
-    return ERR_NONE;
+
+void APPL_FIFO_SetFormat(enum appl_fifo_type bufferType,
+                         const struct APPL_FIFO_Format *format)
+{
+    fifos[bufferType].Format = *format;
 }
 
 
-uint32_t APPL_FIFO_Put(enum appl_fifo_type bufferType,
-                       uint8_t *buffer,
-                       uint32_t numberOfBytes)
+uint8_t *APPL_FIFO_Reserve(enum appl_fifo_type bufferType,
+                           uint32_t *numberOfSamples)
 {
-    uint32_t err;
+    struct FIFO_Buffer *fifo = &fifos[bufferType];
+    struct TXW51_SERV_MEASURE_DataPacket *slot;
+
+    FIFO_FlushLost(fifo);
 
-    app_fifo_t *fifoHandle;
-    if (bufferType == APPL_FIFO_BUFFER_ACC) {
-        fifoHandle = &fifoHandleAcc;
+    *numberOfSamples = FIFO_GetFree(fifo);
+    if (*numberOfSamples == 0) {
+        return NULL;
+    }
+
+    slot = FIFO_GetSlot(fifo, fifo->Taken + fifo->Waiting);
+    if (fifo->Fill == 0) {
+        slot->Header.NumberOfSamples = 0;
+        slot->Header.Axis = fifo->Format.Axis;
+        slot->Header.AccOrGyro = fifo->Format.AccOrGyro;
+        if (fifo->Format.IsDriver) {
+            slot->Data[0] = 0;
+        }
+    }
+
+    *numberOfSamples = FIFO_GetCapacity(fifo) - fifo->Fill;
+    return &slot->Data[FIFO_GetOffset(fifo) + fifo->Fill * fifo->Format.SampleSize];
+}
+
+
+void APPL_FIFO_Commit(enum appl_fifo_type bufferType,
+                      uint32_t numberOfSamples)
+{
+    struct FIFO_Buffer *fifo = &fifos[bufferType];
+    struct TXW51_SERV_MEASURE_DataPacket *slot;
+
+    if (numberOfSamples == 0) {
+        return;
+    }
+
+    slot = FIFO_GetSlot(fifo, fifo->Taken + fifo->Waiting);
+    fifo->Fill += numberOfSamples;
+    fifo->IsDropping = false;
+    if (fifo->Format.IsDriver) {
+        slot->Data[0] = fifo->Fill;
     } else {
-        fifoHandle = &fifoHandleGyro;
+        slot->Header.NumberOfSamples = fifo->Fill;
+    }
+
+    FIFO_UpdatePeak(fifo);
+    if (fifo->Fill >= FIFO_GetCapacity(fifo)) {
+        FIFO_Close(fifo);
+    }
+}
+
+
+uint32_t APPL_FIFO_Put(enum appl_fifo_type bufferType,
+                       const uint8_t *buffer,
+                       uint32_t numberOfSamples)
+{
+    struct FIFO_Buffer *fifo = &fifos[bufferType];
+    uint8_t *samples;
+    uint32_t count;
+
+    FIFO_FlushLost(fifo);
+
+    if (numberOfSamples > FIFO_GetFree(fifo)) {
+        return APPL_FIFO_Drop(bufferType, numberOfSamples);
     }
 
-    for (int32_t i = 0; i < numberOfBytes; i++) {
-        err = app_fifo_put(fifoHandle, buffer[i]);
-        if (err != NRF_SUCCESS) {
-            TXW51_LOG_ERROR("[FIFO] Could not put all values into buffer.");
-            return ERR_FIFO_PUT_FAILED;
+    while (numberOfSamples > 0) {
+        samples = APPL_FIFO_Reserve(bufferType, &count);
+        if (count > numberOfSamples) {
+            count = numberOfSamples;
         }
+
+        memcpy(samples, buffer, count * fifo->Format.SampleSize);
+        APPL_FIFO_Commit(bufferType, count);
+        buffer += count * fifo->Format.SampleSize;
+        numberOfSamples -= count;
     }
 
     return ERR_NONE;
 }
 
 
-uint32_t APPL_FIFO_Get(enum appl_fifo_type bufferType,
-                       uint8_t *buffer,
-                       uint32_t numberOfBytes)
+uint32_t APPL_FIFO_Drop(enum appl_fifo_type bufferType,
+                        uint32_t numberOfSamples)
 {
-    uint32_t err;
-    uint32_t bytesRead = 0;
+    struct FIFO_Buffer *fifo = &fifos[bufferType];
 
-    app_fifo_t *fifoHandle;
-    if (bufferType == APPL_FIFO_BUFFER_ACC) {
-        fifoHandle = &fifoHandleAcc;
-    } else {
-        fifoHandle = &fifoHandleGyro;
+    if (!fifo->IsDropping) {
+        fifo->IsDropping = true;
+        APPL_FIFO_PutDiscontinuity(bufferType);
+    }
+    return ERR_FIFO_PUT_FAILED;
+}
+
+
+void APPL_FIFO_PutDiscontinuity(enum appl_fifo_type bufferType)
+{
+    struct FIFO_Buffer *fifo = &fifos[bufferType];
+
+    if (fifo->Lost < UINT8_MAX) {
+        fifo->Lost++;
+    }
+    FIFO_FlushLost(fifo);
+}
+
+
+struct TXW51_SERV_MEASURE_DataPacket *APPL_FIFO_Take(enum appl_fifo_type bufferType,
+                                                      bool isPartialAllowed)
+{
+    struct FIFO_Buffer *fifo = &fifos[bufferType];
+    struct TXW51_SERV_MEASURE_DataPacket *slot;
+
+    FIFO_FlushLost(fifo);
+
+    if ((fifo->Waiting == 0) && isPartialAllowed) {
+        FIFO_Close(fifo);
+    }
+    if (fifo->Waiting == 0) {
+        return NULL;
+    }
+
+    slot = FIFO_GetSlot(fifo, fifo->Taken);
+    fifo->Taken++;
+    fifo->Waiting--;
+    if ((fifo->Markers > 0) && FIFO_IsMarker(fifo, slot)) {
+        fifo->Markers--;
+    }
+    return slot;
+}
+
+
+void APPL_FIFO_Release(const struct TXW51_SERV_MEASURE_DataPacket *packet)
+{
+    for (uint32_t i = 0; i < APPL_FIFO_BUFFER_COUNT; i++) {
+        struct FIFO_Buffer *fifo = &fifos[i];
+
+        if ((packet >= fifo->Slots) && (packet < &fifo->Slots[fifo->Size])) {
+            if ((fifo->Taken == 0) || (packet != &fifo->Slots[fifo->Tail])) {
+                TXW51_LOG_ERROR("[FIFO] Packet released out of order.");
+                return;
+            }
+            fifo->Tail = (fifo->Tail + 1) % fifo->Size;
+            fifo->Taken--;
+            return;
+        }
+    }
+}
+
+
+bool APPL_FIFO_IsEmpty(enum appl_fifo_type bufferType)
+{
+    struct FIFO_Buffer *fifo = &fifos[bufferType];
+
+    return (fifo->Waiting == 0) && (fifo->Fill == 0) && (fifo->Lost == 0);
+}
+
+
+uint32_t APPL_FIFO_GetFree(enum appl_fifo_type bufferType)
+{
+    struct FIFO_Buffer *fifo = &fifos[bufferType];
+
+    FIFO_FlushLost(fifo);
+    return FIFO_GetFree(fifo);
+}
+
+
+uint32_t APPL_FIFO_GetPeak(enum appl_fifo_type bufferType)
+{
+    return fifos[bufferType].Peak * sizeof(struct TXW51_SERV_MEASURE_DataPacket);
+}
+
+
+uint32_t APPL_FIFO_GetSize(enum appl_fifo_type bufferType)
+{
+    return fifos[bufferType].Size;
+}
+
+
+uint32_t APPL_FIFO_GetLength(enum appl_fifo_type bufferType)
+{
+    struct FIFO_Buffer *fifo = &fifos[bufferType];
+
+    return fifo->Taken + fifo->Waiting + ((fifo->Fill > 0) ? 1 : 0);
+}
+
+
+/***************************************************************************//**
+ * @brief Returns a slot of a FIFO.
+ *
+ * @param[in] fifo     The FIFO.
+ * @param[in] position Position of the slot, counted from the oldest one.
+ *
+ * @return The slot.
+ ******************************************************************************/
+static struct TXW51_SERV_MEASURE_DataPacket *FIFO_GetSlot(struct FIFO_Buffer *fifo,
+                                                          uint32_t position)
+{
+    return &fifo->Slots[(fifo->Tail + position) % fifo->Size];
+}
+
+
+/***************************************************************************//**
+ * @brief Returns where the samples start in the data of a packet.
+ *
+ * @param[in] fifo The FIFO.
+ *
+ * @return 1 for a driver, its packets start with the number of samples.
+ ******************************************************************************/
+static uint8_t FIFO_GetOffset(const struct FIFO_Buffer *fifo)
+{
+    return fifo->Format.IsDriver ? 1 : 0;
+}
+
+
+/***************************************************************************//**
+ * @brief Returns the number of samples that fit into a slot.
+ *
+ * @param[in] fifo The FIFO.
+ *
+ * @return The number of samples per packet.
+ ******************************************************************************/
+static uint8_t FIFO_GetCapacity(const struct FIFO_Buffer *fifo)
+{
+    return (sizeof(((struct TXW51_SERV_MEASURE_DataPacket *)0)->Data) - FIFO_GetOffset(fifo)) /
+           fifo->Format.SampleSize;
+}
+
+
+/***************************************************************************//**
+ * @brief Returns the number of samples that can be added.
+ *
+ * Nothing can be added while a discontinuity waits for a free slot.
+ *
+ * @param[in] fifo The FIFO.
+ *
+ * @return The number of samples that fit into the open and the free slots.
+ ******************************************************************************/
+static uint32_t FIFO_GetFree(const struct FIFO_Buffer *fifo)
+{
+    uint32_t used = fifo->Taken + fifo->Waiting;
+
+    if ((fifo->Format.SampleSize == 0) || (fifo->Lost > 0) || (used >= fifo->Size)) {
+        return 0;
     }
+    return (fifo->Size - used) * FIFO_GetCapacity(fifo) - fifo->Fill;
+}
+
 
-    for (int32_t i = 0; i < numberOfBytes; i++) {
-        err = app_fifo_get(fifoHandle, &buffer[i]);
-        if (err != NRF_SUCCESS) {
-            break;
+/***************************************************************************//**
+ * @brief Checks if a closed slot holds a discontinuity.
+ *
+ * @param[in] fifo The FIFO.
+ * @param[in] slot The slot.
+ *
+ * @return True if the packet is a marker without samples.
+ ******************************************************************************/
+static bool FIFO_IsMarker(const struct FIFO_Buffer *fifo,
+                          const struct TXW51_SERV_MEASURE_DataPacket *slot)
+{
+    return fifo->Format.IsDriver ? (slot->Data[0] == 0) : (slot->Header.NumberOfSamples == 0);
+}
+
+
+/***************************************************************************//**
+ * @brief Closes the open slot if it holds samples.
+ *
+ * @param[in,out] fifo The FIFO.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void FIFO_Close(struct FIFO_Buffer *fifo)
+{
+    if (fifo->Fill > 0) {
+        fifo->Fill = 0;
+        fifo->Waiting++;
+    }
+}
+
+
+/***************************************************************************//**
+ * @brief Writes the discontinuities that wait into a marker packet.
+ *
+ * They get merged into the last marker if no samples are in between or if
+ * the FIFO holds APPL_FIFO_MAX_DISCONTINUITIES markers already, so a
+ * saturated link does not spend every other packet on a marker. If no slot
+ * is free, they keep waiting.
+ *
+ * @param[in,out] fifo The FIFO.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void FIFO_FlushLost(struct FIFO_Buffer *fifo)
+{
+    struct TXW51_SERV_MEASURE_DataPacket *slot;
+    uint8_t offset = FIFO_GetOffset(fifo);
+
+    if (fifo->Lost == 0) {
+        return;
+    }
+
+    if (fifo->Markers > 0) {
+        slot = &fifo->Slots[fifo->LastMarker];
+        if (((fifo->Fill == 0) && (slot == FIFO_GetSlot(fifo, fifo->Taken + fifo->Waiting - 1))) ||
+            (fifo->Markers >= APPL_FIFO_MAX_DISCONTINUITIES)) {
+            slot->Data[offset] = (slot->Data[offset] + fifo->Lost > UINT8_MAX) ?
+                                 UINT8_MAX : slot->Data[offset] + fifo->Lost;
+            fifo->Lost = 0;
+            return;
         }
-        bytesRead++;
     }
 
-    return bytesRead;
+    FIFO_Close(fifo);
+    if (fifo->Taken + fifo->Waiting >= fifo->Size) {
+        return;
+    }
+
+    slot = FIFO_GetSlot(fifo, fifo->Taken + fifo->Waiting);
+    memset(slot, 0, sizeof(*slot));
+    if (fifo->Format.IsDriver) {
+        slot->Header.Axis = fifo->Format.Axis;
+    } else {
+        slot->Header.AccOrGyro = fifo->Format.AccOrGyro;
+    }
+    slot->Data[offset] = fifo->Lost;
+    fifo->Lost = 0;
+    fifo->Markers++;
+    fifo->LastMarker = slot - fifo->Slots;
+    fifo->Waiting++;
+    FIFO_UpdatePeak(fifo);
 }
 
+
+/***************************************************************************//**
+ * @brief Updates the highest number of used slots.
+ *
+ * @param[in,out] fifo The FIFO.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void FIFO_UpdatePeak(struct FIFO_Buffer *fifo)
+{
+    uint8_t used = fifo->Taken + fifo->Waiting + ((fifo->Fill > 0) ? 1 : 0);
+
+    if (used > fifo->Peak) {
+        fifo->Peak = used;
+    }
+}
@@ -1,6 +1,24 @@
 /***************************************************************************//**
  * @brief   This module implements a FIFO to be used as a buffer.
  *
+ * The FIFOs hold the samples in slots that are formatted as the packets of
+ * the Measurement service, so the samples get read from the sensor straight
+ * into the packet that is notified later. A slot is filled at the write end
+ * (APPL_FIFO_Reserve(), APPL_FIFO_Commit()) and closed when it is full. The
+ * header and the number of samples are written in place with every commit.
+ *
+ * The read end hands out the slots themselves (APPL_FIFO_Take()). A taken
+ * slot stays in the FIFO until it is released (APPL_FIFO_Release()), so the
+ * packet can be sent again or kept until the gateway acknowledges it. A FIFO
+ * is a ring, only its oldest taken slot can be released.
+ *
+ * All FIFOs share one pool of APPL_FIFO_SLOTS slots. APPL_FIFO_Reset() gives
+ * each FIFO in use APPL_FIFO_MIN_SLOTS and shares the rest by the packet
+ * rates of their formats, so a single fast sensor gets nearly all of it.
+ *
+ * A discontinuity is a slot with a marker packet, see
+ * struct TXW51_SERV_MEASURE_DataPacket and app/driver.h.
+ *
  * @file    fifo.h
  * @version 1.0
  * @date    05.12.2014
@@ -14,19 +32,37 @@
 #define TXW51_APPLICATION_FIFO_H_
 
 /*----- Header-Files ---------------------------------------------------------*/
+#include <stdbool.h>
 #include <stdint.h>
 
+#include "txw51_framework/ble/service_measure.h"
+
 /*----- Macros ---------------------------------------------------------------*/
-#define APPL_FIFO_BUFFER_SIZE_ACC       ( 1024 )    /**< Size of the FIFO for the accelerometer (has to be a power of 2). */
-#define APPL_FIFO_BUFFER_SIZE_GYRO      ( 1024 )    /**< Size of the FIFO for the gyroscope (has to be a power of 2). */
+#define APPL_FIFO_SLOTS         ( 80 )      /**< Slots of the pool shared by the FIFOs, at most 255. */
+#define APPL_FIFO_MIN_SLOTS     ( 4 )       /**< Slots of each FIFO in use before the rest is shared by the rates. */
+#define APPL_FIFO_MAX_DISCONTINUITIES   ( 4 )   /**< Number of discontinuities each FIFO can hold, more get merged into the last one. */
 
 /*----- Data types -----------------------------------------------------------*/
 /**
  * List of the different FIFO buffers.
  */
 enum appl_fifo_type {
-    APPL_FIFO_BUFFER_ACC,   /**< FIFO for the accelerometer values. */
-    APPL_FIFO_BUFFER_GYRO   /**< FIFO for the gyroscope values. */
+    APPL_FIFO_BUFFER_ACC,       /**< FIFO for the accelerometer values. */
+    APPL_FIFO_BUFFER_GYRO,      /**< FIFO for the gyroscope values. */
+    APPL_FIFO_BUFFER_AUX_0,     /**< FIFO for the first registered sensor driver. */
+    APPL_FIFO_BUFFER_AUX_1,     /**< FIFO for the second registered sensor driver. */
+    APPL_FIFO_BUFFER_COUNT      /**< Number of FIFO buffers. */
+};
+
+/**
+ * @brief Format of the packets in a FIFO.
+ */
+struct APPL_FIFO_Format {
+    uint8_t SampleSize;     /**< Bytes per sample. */
+    uint8_t Axis;           /**< Axis field of the header, the driver ID + 1 for a driver. */
+    uint8_t AccOrGyro;      /**< AccOrGyro field of the header. */
+    bool    IsDriver;       /**< The packets have the format of app/driver.h instead of the LSM330 format. */
+    uint16_t Rate;          /**< Samples per second, 0 if the FIFO is not used. */
 };
 
 /*----- Function prototypes --------------------------------------------------*/
@@ -34,37 +70,181 @@ enum appl_fifo_type {
 /***************************************************************************//**
  * @brief Initializes the FIFO module.
  *
+ * Empties all FIFOs, see APPL_FIFO_Reset(). The formats are kept.
+ *
  * @return ERR_NONE if no error occurred.
- *         ERR_FIFO_INIT_FAILED if the initialization of the FIFO failed.
  ******************************************************************************/
 extern uint32_t APPL_FIFO_Init(void);
 
 /***************************************************************************//**
- * @brief Puts multiple bytes into the FIFO buffer.
+ * @brief Empties all FIFOs and shares the slots by their formats.
  *
- * @param[in] bufferType    Which FIFO buffer to use.
- * @param[in] buffer        Buffer with the values to add.
- * @param[in] numberOfBytes Number of bytes to put into the FIFO.
+ * Each FIFO with a rate gets APPL_FIFO_MIN_SLOTS, the remaining slots are
+ * shared in proportion to the packets per second. The taken packets become
+ * invalid, so it is called when a measurement starts.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+extern void APPL_FIFO_Reset(void);
+
+/***************************************************************************//**
+ * @brief Sets the format of the packets of a FIFO.
+ *
+ * Applies to the slots that are opened afterwards. The rate applies from
+ * the next APPL_FIFO_Reset().
+ *
+ * @param[in] bufferType Which FIFO buffer to use.
+ * @param[in] format     The format.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+extern void APPL_FIFO_SetFormat(enum appl_fifo_type bufferType,
+                                const struct APPL_FIFO_Format *format);
+
+/***************************************************************************//**
+ * @brief Gets the place for the next samples in the open slot.
+ *
+ * The samples get written there directly and are added with
+ * APPL_FIFO_Commit(). The byte in front of the place belongs to the packet,
+ * so it can be used by TXW51_SPI_ReadInPlace().
+ *
+ * @param[in]  bufferType      Which FIFO buffer to use.
+ * @param[out] numberOfSamples Number of samples that fit into the open slot.
+ *
+ * @return The place for the next sample, NULL if the FIFO is full.
+ ******************************************************************************/
+extern uint8_t *APPL_FIFO_Reserve(enum appl_fifo_type bufferType,
+                                  uint32_t *numberOfSamples);
+
+/***************************************************************************//**
+ * @brief Adds the samples written to the place from APPL_FIFO_Reserve().
+ *
+ * @param[in] bufferType      Which FIFO buffer to use.
+ * @param[in] numberOfSamples Number of samples written, at most the number
+ *                            returned by APPL_FIFO_Reserve().
+ *
+ * @return Nothing.
+ ******************************************************************************/
+extern void APPL_FIFO_Commit(enum appl_fifo_type bufferType,
+                             uint32_t numberOfSamples);
+
+/***************************************************************************//**
+ * @brief Copies samples into the FIFO buffer.
+ *
+ * Either all samples are put into the FIFO or none, so the FIFO never holds a
+ * partial sample. If the samples do not fit, a discontinuity is marked in
+ * their place.
+ *
+ * @param[in] bufferType      Which FIFO buffer to use.
+ * @param[in] buffer          Buffer with the samples to add.
+ * @param[in] numberOfSamples Number of samples to put into the FIFO.
  *
  * @return ERR_NONE if no error occurred.
- *         ERR_FIFO_PUT_FAILED if not all values could be put into the FIFO.
+ *         ERR_FIFO_PUT_FAILED if the samples do not fit into the FIFO.
  ******************************************************************************/
 extern uint32_t APPL_FIFO_Put(enum appl_fifo_type bufferType,
-                              uint8_t *buffer,
-                              uint32_t numberOfBytes);
+                              const uint8_t *buffer,
+                              uint32_t numberOfSamples);
+
+/***************************************************************************//**
+ * @brief Drops samples that do not fit into the FIFO buffer.
+ *
+ * A discontinuity is marked in their place. Samples dropped one block after
+ * the other share one discontinuity.
+ *
+ * @param[in] bufferType      Which FIFO buffer to use.
+ * @param[in] numberOfSamples Number of samples dropped.
+ *
+ * @return ERR_FIFO_PUT_FAILED.
+ ******************************************************************************/
+extern uint32_t APPL_FIFO_Drop(enum appl_fifo_type bufferType,
+                               uint32_t numberOfSamples);
+
+/***************************************************************************//**
+ * @brief Marks a discontinuity after the samples put into the FIFO so far.
+ *
+ * Used when values have been lost before they reached the FIFO, for example
+ * with an overrun of the sensor. If the FIFO is full, the marker waits for a
+ * free slot, no samples get added before it.
+ *
+ * @param[in] bufferType Which FIFO buffer to use.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+extern void APPL_FIFO_PutDiscontinuity(enum appl_fifo_type bufferType);
+
+/***************************************************************************//**
+ * @brief Takes the next packet from the FIFO.
+ *
+ * The packet stays valid until it gets released with APPL_FIFO_Release().
+ * Only the sequence number has to be set before it is sent.
+ *
+ * @param[in] bufferType       Which FIFO buffer to use.
+ * @param[in] isPartialAllowed Close the open slot if no full one is waiting.
+ *
+ * @return The packet, NULL if there is none.
+ ******************************************************************************/
+extern struct TXW51_SERV_MEASURE_DataPacket *APPL_FIFO_Take(enum appl_fifo_type bufferType,
+                                                             bool isPartialAllowed);
+
+/***************************************************************************//**
+ * @brief Releases a taken packet, its slot gets reused.
+ *
+ * The packets of a FIFO have to be released in the order they were taken,
+ * the packets of different FIFOs in any order. A packet that is not the
+ * oldest taken one of its FIFO is not released and an error is logged,
+ * freeing it would free the slot of an older packet that is still in use.
+ *
+ * @param[in] packet The packet from APPL_FIFO_Take().
+ *
+ * @return Nothing.
+ ******************************************************************************/
+extern void APPL_FIFO_Release(const struct TXW51_SERV_MEASURE_DataPacket *packet);
+
+/***************************************************************************//**
+ * @brief Checks if there is anything to take from the FIFO.
+ *
+ * @param[in] bufferType Which FIFO buffer to use.
+ *
+ * @return True if there are neither samples nor discontinuities to take.
+ ******************************************************************************/
+extern bool APPL_FIFO_IsEmpty(enum appl_fifo_type bufferType);
+
+/***************************************************************************//**
+ * @brief Returns the number of samples that can be added to the FIFO.
+ *
+ * @param[in] bufferType Which FIFO buffer to use.
+ *
+ * @return The number of samples that fit into the open and the free slots.
+ ******************************************************************************/
+extern uint32_t APPL_FIFO_GetFree(enum appl_fifo_type bufferType);
+
+/***************************************************************************//**
+ * @brief Returns the highest occupancy of the FIFO since the initialization.
+ *
+ * @param[in] bufferType Which FIFO buffer to use.
+ *
+ * @return The peak number of bytes in the used slots.
+ ******************************************************************************/
+extern uint32_t APPL_FIFO_GetPeak(enum appl_fifo_type bufferType);
+
+/***************************************************************************//**
+ * @brief Returns the number of slots of the FIFO.
+ *
+ * @param[in] bufferType Which FIFO buffer to use.
+ *
+ * @return The share of the pool since the last APPL_FIFO_Reset().
+ ******************************************************************************/
+extern uint32_t APPL_FIFO_GetSize(enum appl_fifo_type bufferType);
 
 /***************************************************************************//**
- * @brief Gets multiple bytes from the FIFO buffer.
+ * @brief Returns the number of used slots of the FIFO.
  *
- * @param[in] bufferType    Which FIFO buffer to use.
- * @param[in] buffer        Buffer to save the values.
- * @param[in] numberOfBytes Number of bytes to get from the FIFO.
+ * @param[in] bufferType Which FIFO buffer to use.
  *
- * @return Number of bytes read from the FIFO.
+ * @return The number of slots that are taken, waiting or being filled.
  ******************************************************************************/
-extern uint32_t APPL_FIFO_Get(enum appl_fifo_type bufferType,
-                              uint8_t *buffer,
-                              uint32_t numberOfBytes);
+extern uint32_t APPL_FIFO_GetLength(enum appl_fifo_type bufferType);
 
 /*----- Data -----------------------------------------------------------------*/
 
@@ -16,9 +16,13 @@
 /*----- Header-Files ---------------------------------------------------------*/
 #include "i2cBridge.h"
 
+#include <stdbool.h>
 #include <string.h>
 #include <stdio.h>
 
+#include "nrf/app_common/app_timer.h"
+
+#include "txw51_framework/config/config.h"
 #include "txw51_framework/hw/i2c.h"
 #include "txw51_framework/utils/log.h"
 
@@ -29,20 +33,111 @@
 /*----- Macros ---------------------------------------------------------------*/
 
 /*----- Data types -----------------------------------------------------------*/
+/**
+ * @brief Forward declaration of a script execution for the callback.
+ */
+struct I2C_BRIDGE_ScriptRun;
+
+/**
+ * @brief Callback that gets called when a script execution has finished.
+ */
+typedef void (*I2C_BRIDGE_ScriptDone_t) (struct I2C_BRIDGE_ScriptRun *run);
+
+/**
+ * @brief State of an asynchronous script execution.
+ *
+ * The operations are queued one after another, each from the completion
+ * callback of the previous one.
+ */
+struct I2C_BRIDGE_ScriptRun {
+    uint8_t  Script[TXW51_SERV_I2C_SCRIPT_MAX_LENGTH];          /**< The script that is executed. */
+    uint16_t ScriptLength;                                      /**< Length of the script in bytes. */
+    uint16_t Pos;                                               /**< Position of the next operation in the script. */
+    uint8_t  Result[TXW51_SERV_I2C_SCRIPT_MAX_LENGTH];          /**< The packed result. */
+    uint16_t ResultLength;                                      /**< Length of the result in bytes. */
+    uint8_t  Executed;                                          /**< Number of executed operations. */
+    bool     IsReadPending;                                     /**< Whether the queued operation is a read. */
+    bool     IsRunning;                                         /**< Whether the script is being executed. */
+    I2C_BRIDGE_ScriptDone_t Done;                               /**< Called when the execution has finished. */
+};
+
+/**
+ * @brief State of the periodic polling job.
+ */
+struct I2C_BRIDGE_PollJob {
+    uint8_t  Script[TXW51_SERV_I2C_SCRIPT_MAX_LENGTH];          /**< The script that is run every period. */
+    uint16_t ScriptLength;                                      /**< Length of the script in bytes. */
+    uint8_t  Flags;                                             /**< TXW51_SERV_I2C_POLL_FLAG_* of the job. */
+    uint8_t  LastResult[TXW51_SERV_I2C_SCRIPT_MAX_LENGTH];      /**< The result that was last notified. */
+    uint16_t LastResultLength;                                  /**< Length of the last result, 0 if none was sent yet. */
+    bool     IsRunning;                                         /**< Whether the polling timer is running. */
+};
 
 /*----- Function prototypes --------------------------------------------------*/
 static void APPL_I2C_BRIDGE_BleEventHandler(struct TXW51_SERV_I2C_Handle *handle,
 											struct TXW51_SERV_I2C_Event *evt);
+static void I2C_BRIDGE_ValueReadDone(uint32_t err,
+                                     uint8_t *data,
+                                     uint8_t length,
+                                     void *context);
+static bool I2C_BRIDGE_StartScript(struct I2C_BRIDGE_ScriptRun *run,
+                                   const uint8_t *script,
+                                   uint16_t scriptLength,
+                                   I2C_BRIDGE_ScriptDone_t done);
+static void I2C_BRIDGE_ContinueScript(struct I2C_BRIDGE_ScriptRun *run);
+static void I2C_BRIDGE_ScriptOpDone(uint32_t err,
+                                    uint8_t *data,
+                                    uint8_t length,
+                                    void *context);
+static void I2C_BRIDGE_FinishScript(struct I2C_BRIDGE_ScriptRun *run,
+                                    uint8_t status);
+static void I2C_BRIDGE_ScriptRunDone(struct I2C_BRIDGE_ScriptRun *run);
+static void I2C_BRIDGE_PollRunDone(struct I2C_BRIDGE_ScriptRun *run);
+static uint32_t I2C_BRIDGE_StartPolling(const uint8_t *job,
+                                        uint16_t length);
+static void I2C_BRIDGE_PollTimerHandler(void *context);
 
 /*----- Data -----------------------------------------------------------------*/
+static struct TXW51_SERV_I2C_Handle *bridgeServiceHandle;  /**< Handle of the I2C service. */
+static app_timer_id_t pollTimerHandle;      /**< Handle for the polling timer. */
+static struct I2C_BRIDGE_PollJob pollJob;   /**< The currently configured polling job. */
+static struct I2C_BRIDGE_ScriptRun scriptRun;   /**< Execution of the script characteristic. */
+static struct I2C_BRIDGE_ScriptRun pollRun;     /**< Execution of the polling job. */
 
 /*----- Implementation -------------------------------------------------------*/
 
 void APPL_I2C_BRIDGE_Init(void)
 {
-	TXW51_I2C_Init();
+	uint32_t err;
+
+	err = TXW51_I2C_Init();
+	if (err != ERR_NONE) {
+		TXW51_LOG_ERROR("[I2C Bridge] Could not initialize I2C.");
+	}
 
 	i2cLength = 1;
+
+	memset(&pollJob, 0, sizeof(pollJob));
+	memset(&scriptRun, 0, sizeof(scriptRun));
+	memset(&pollRun, 0, sizeof(pollRun));
+	err = app_timer_create(&pollTimerHandle,
+	                       APP_TIMER_MODE_REPEATED,
+	                       I2C_BRIDGE_PollTimerHandler);
+	if (err != NRF_SUCCESS) {
+		TXW51_LOG_ERROR("[I2C Bridge] Could not create polling timer.");
+	}
+}
+
+
+void APPL_I2C_BRIDGE_StopPolling(void)
+{
+	if (!pollJob.IsRunning) {
+		return;
+	}
+
+	app_timer_stop(pollTimerHandle);
+	pollJob.IsRunning = false;
+	TXW51_LOG_DEBUG("[I2C Bridge] Polling stopped.");
 }
 
 /* -------------------------------------------------------------------------- */
@@ -60,14 +155,16 @@ uint32_t APPL_I2C_BRIDGE_InitService(struct TXW51_SERV_I2C_Handle *serviceHandle
         return ERR_BLE_SERVICE_INIT_FAILED;
     }
 
+    bridgeServiceHandle = serviceHandle;
     return ERR_NONE;
 }
 
 
 /***************************************************************************//**
- * @brief Handles the BLE events from the CONTACTLESS_TEMP service.
+ * @brief Handles the BLE events from the I2C service.
  *
- * This function gets called from the BLE service as a callback.
+ * This function gets called from the BLE service as a callback. The I2C
+ * transactions are only queued, the results are sent from their callbacks.
  *
  * @param[in] handle The handle of the service.
  * @param[in] evt    The information to the event.
@@ -93,21 +190,324 @@ static void APPL_I2C_BRIDGE_BleEventHandler(struct TXW51_SERV_I2C_Handle *handle
             break;
         case TXW51_SERV_I2C_EVT_VALUE_LENGTH:
         	i2cLength = *evt->Value;
+        	if (i2cLength > TXW51_SERV_I2C_VALUE_MAX_LENGTH) {
+        		i2cLength = TXW51_SERV_I2C_VALUE_MAX_LENGTH;
+        	}
            	sprintf(debugOut, "%d", i2cLength);
            	TXW51_LOG_DEBUG("I2C Length set to:");
            	TXW51_LOG_DEBUG(debugOut);
             break;
         case TXW51_SERV_I2C_EVT_VALUE_READ:
-        	TXW51_I2C_Read(i2cAddress, i2cRegister, evt->Value, i2cLength);
-        	evt->Length = i2cLength;
-           	sprintf(debugOut, "I2C Read Length %d", evt->Length);
-           	TXW51_LOG_DEBUG(debugOut);
+        	if (TXW51_I2C_ReadAsync(i2cAddress, i2cRegister, i2cLength,
+        	                        I2C_BRIDGE_ValueReadDone, handle) != ERR_NONE) {
+        		I2C_BRIDGE_ValueReadDone(ERR_I2C_READ_FAILED, NULL, i2cLength, handle);
+        	}
         	break;
         case TXW51_SERV_I2C_EVT_VALUE_WRITE:
-        	TXW51_I2C_Write(i2cAddress, i2cRegister, evt->Value, evt->Length);
+        	TXW51_I2C_WriteAsync(i2cAddress, i2cRegister, evt->Value, evt->Length, NULL, NULL);
            	sprintf(debugOut, " I2C Write Length: %d", evt->Length);
            	TXW51_LOG_DEBUG(debugOut);
+           	break;
+        case TXW51_SERV_I2C_EVT_SCRIPT:
+            if (!I2C_BRIDGE_StartScript(&scriptRun, evt->Value, evt->Length, I2C_BRIDGE_ScriptRunDone)) {
+                uint8_t busy[TXW51_SERV_I2C_SCRIPT_RESULT_HEADER_LEN] = { TXW51_SERV_I2C_SCRIPT_STATUS_BUSY, 0 };
+                TXW51_SERV_I2C_SendScriptResult(handle, busy, sizeof(busy));
+            }
+            break;
+        case TXW51_SERV_I2C_EVT_POLL:
+            I2C_BRIDGE_StartPolling(evt->Value, evt->Length);
+            break;
+        case TXW51_SERV_I2C_EVT_DISCONNECTED:
+            APPL_I2C_BRIDGE_StopPolling();
+            break;
         default:
             break;
     }
 }
+
+
+/***************************************************************************//**
+ * @brief Answers the read request of the value characteristic.
+ *
+ * If the read failed, zeros are returned like before.
+ *
+ * @param[in] err     Result of the I2C transaction.
+ * @param[in] data    The read data.
+ * @param[in] length  Number of read bytes.
+ * @param[in] context The handle of the service.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void I2C_BRIDGE_ValueReadDone(uint32_t err,
+                                     uint8_t *data,
+                                     uint8_t length,
+                                     void *context)
+{
+    uint8_t value[TXW51_SERV_I2C_VALUE_MAX_LENGTH];
+
+    memset(value, 0, sizeof(value));
+    if (err == ERR_NONE) {
+        memcpy(value, data, length);
+    } else {
+        TXW51_LOG_WARNING("[I2C Bridge] Value read failed.");
+    }
+
+    TXW51_SERV_I2C_ReplyValueRead((struct TXW51_SERV_I2C_Handle *)context, value, length);
+}
+
+
+/***************************************************************************//**
+ * @brief Starts the asynchronous execution of a packed list of I2C operations.
+ *
+ * The format of the script and of the result is described in service_i2c.h.
+ * The execution stops at the first operation that fails or does not fit.
+ *
+ * @param[in,out] run          The execution state.
+ * @param[in]     script       The packed operations.
+ * @param[in]     scriptLength Length of the script in bytes.
+ * @param[in]     done         Called with the result when finished.
+ *
+ * @return False if the previous script of this execution is still running.
+ ******************************************************************************/
+static bool I2C_BRIDGE_StartScript(struct I2C_BRIDGE_ScriptRun *run,
+                                   const uint8_t *script,
+                                   uint16_t scriptLength,
+                                   I2C_BRIDGE_ScriptDone_t done)
+{
+    if (run->IsRunning) {
+        return false;
+    }
+
+    if (scriptLength > TXW51_SERV_I2C_SCRIPT_MAX_LENGTH) {
+        scriptLength = TXW51_SERV_I2C_SCRIPT_MAX_LENGTH;
+    }
+
+    memcpy(run->Script, script, scriptLength);
+    run->ScriptLength = scriptLength;
+    run->Pos          = 0;
+    run->ResultLength = TXW51_SERV_I2C_SCRIPT_RESULT_HEADER_LEN;
+    run->Executed     = 0;
+    run->Done         = done;
+    run->IsRunning    = true;
+
+    I2C_BRIDGE_ContinueScript(run);
+    return true;
+}
+
+
+/***************************************************************************//**
+ * @brief Parses and queues the next operation of a script.
+ *
+ * @param[in,out] run The execution state.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void I2C_BRIDGE_ContinueScript(struct I2C_BRIDGE_ScriptRun *run)
+{
+    if (run->Pos >= run->ScriptLength) {
+        I2C_BRIDGE_FinishScript(run, TXW51_SERV_I2C_SCRIPT_STATUS_OK);
+        return;
+    }
+
+    if ((run->ScriptLength - run->Pos) < TXW51_SERV_I2C_SCRIPT_OP_HEADER_LEN) {
+        I2C_BRIDGE_FinishScript(run, TXW51_SERV_I2C_SCRIPT_STATUS_MALFORMED);
+        return;
+    }
+
+    uint8_t *op    = &run->Script[run->Pos];
+    uint8_t addr   = op[0] & TXW51_SERV_I2C_SCRIPT_ADDR_Msk;
+    bool    isRead = (op[0] & TXW51_SERV_I2C_SCRIPT_OP_READ) != 0;
+    uint8_t reg    = op[1];
+    uint8_t len    = op[2];
+    run->Pos += TXW51_SERV_I2C_SCRIPT_OP_HEADER_LEN;
+
+    uint32_t err;
+    run->IsReadPending = isRead;
+    if (isRead) {
+        if ((run->ResultLength + len) > TXW51_SERV_I2C_SCRIPT_MAX_LENGTH) {
+            I2C_BRIDGE_FinishScript(run, TXW51_SERV_I2C_SCRIPT_STATUS_OVERFLOW);
+            return;
+        }
+        err = TXW51_I2C_ReadAsync(addr, reg, len, I2C_BRIDGE_ScriptOpDone, run);
+    } else {
+        if ((run->ScriptLength - run->Pos) < len) {
+            I2C_BRIDGE_FinishScript(run, TXW51_SERV_I2C_SCRIPT_STATUS_MALFORMED);
+            return;
+        }
+        err = TXW51_I2C_WriteAsync(addr, reg, &run->Script[run->Pos], len, I2C_BRIDGE_ScriptOpDone, run);
+        run->Pos += len;
+    }
+
+    if (err != ERR_NONE) {
+        I2C_BRIDGE_FinishScript(run, TXW51_SERV_I2C_SCRIPT_STATUS_I2C_ERROR);
+    }
+}
+
+
+/***************************************************************************//**
+ * @brief Completion callback of a script operation.
+ *
+ * Appends the read data to the result and continues with the next operation.
+ *
+ * @param[in] err     Result of the I2C transaction.
+ * @param[in] data    The read or written data.
+ * @param[in] length  Number of data bytes.
+ * @param[in] context The execution state.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void I2C_BRIDGE_ScriptOpDone(uint32_t err,
+                                    uint8_t *data,
+                                    uint8_t length,
+                                    void *context)
+{
+    struct I2C_BRIDGE_ScriptRun *run = (struct I2C_BRIDGE_ScriptRun *)context;
+
+    if (err != ERR_NONE) {
+        I2C_BRIDGE_FinishScript(run, TXW51_SERV_I2C_SCRIPT_STATUS_I2C_ERROR);
+        return;
+    }
+
+    /* Only reads contribute to the result. */
+    if (run->IsReadPending) {
+        memcpy(&run->Result[run->ResultLength], data, length);
+        run->ResultLength += length;
+    }
+
+    run->Executed++;
+    I2C_BRIDGE_ContinueScript(run);
+}
+
+
+/***************************************************************************//**
+ * @brief Fills in the result header and signals the end of the execution.
+ *
+ * @param[in,out] run    The execution state.
+ * @param[in]     status The TXW51_SERV_I2C_ScriptStatus of the execution.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void I2C_BRIDGE_FinishScript(struct I2C_BRIDGE_ScriptRun *run,
+                                    uint8_t status)
+{
+    run->Result[0] = status;
+    run->Result[1] = run->Executed;
+    run->IsRunning = false;
+
+    if (run->Done != NULL) {
+        run->Done(run);
+    }
+}
+
+
+/***************************************************************************//**
+ * @brief Publishes the result of the script characteristic.
+ *
+ * @param[in] run The finished execution.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void I2C_BRIDGE_ScriptRunDone(struct I2C_BRIDGE_ScriptRun *run)
+{
+    char debugOut[25];
+
+    TXW51_SERV_I2C_SendScriptResult(bridgeServiceHandle, run->Result, run->ResultLength);
+    sprintf(debugOut, "I2C Script status %d", run->Result[0]);
+    TXW51_LOG_DEBUG(debugOut);
+}
+
+
+/***************************************************************************//**
+ * @brief Configures and starts a periodic polling job.
+ *
+ * A running job is replaced. A period of 0 only stops the running job. The
+ * format of the job is described in service_i2c.h.
+ *
+ * @param[in] job    The packed polling job.
+ * @param[in] length Length of the job in bytes.
+ *
+ * @return ERR_NONE if no error occurred.
+ *         ERR_I2C_POLL_START_FAILED if the job is invalid or the timer could
+ *                                   not be started.
+ ******************************************************************************/
+static uint32_t I2C_BRIDGE_StartPolling(const uint8_t *job,
+                                        uint16_t length)
+{
+    uint32_t err;
+
+    APPL_I2C_BRIDGE_StopPolling();
+
+    if (length < TXW51_SERV_I2C_POLL_HEADER_LEN) {
+        TXW51_LOG_WARNING("[I2C Bridge] Polling job is too short.");
+        return ERR_I2C_POLL_START_FAILED;
+    }
+
+    uint16_t periodMs = (uint16_t)(job[0] | (job[1] << 8));
+    if (periodMs == 0) {
+        return ERR_NONE;
+    }
+    if (periodMs < APPL_I2C_BRIDGE_POLL_MIN_PERIOD_MS) {
+        periodMs = APPL_I2C_BRIDGE_POLL_MIN_PERIOD_MS;
+    }
+
+    pollJob.Flags            = job[2];
+    pollJob.ScriptLength     = length - TXW51_SERV_I2C_POLL_HEADER_LEN;
+    pollJob.LastResultLength = 0;
+    memcpy(pollJob.Script, &job[TXW51_SERV_I2C_POLL_HEADER_LEN], pollJob.ScriptLength);
+
+    err = app_timer_start(pollTimerHandle,
+                          APP_TIMER_TICKS(periodMs, CONFIG_TIMERS_PRESCALER),
+                          NULL);
+    if (err != NRF_SUCCESS) {
+        TXW51_LOG_WARNING("[I2C Bridge] Could not start polling timer.");
+        return ERR_I2C_POLL_START_FAILED;
+    }
+
+    pollJob.IsRunning = true;
+    TXW51_LOG_DEBUG("[I2C Bridge] Polling started.");
+    return ERR_NONE;
+}
+
+
+/***************************************************************************//**
+ * @brief Callback handler of the polling timer.
+ *
+ * Starts the script of the polling job. If the previous execution has not
+ * finished yet, this period is skipped.
+ *
+ * @param[in] context Not used.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void I2C_BRIDGE_PollTimerHandler(void *context)
+{
+    I2C_BRIDGE_StartScript(&pollRun, pollJob.Script, pollJob.ScriptLength, I2C_BRIDGE_PollRunDone);
+}
+
+
+/***************************************************************************//**
+ * @brief Notifies the result of the polling job.
+ *
+ * In on-change mode, a result equal to the last notified one is dropped.
+ *
+ * @param[in] run The finished execution.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void I2C_BRIDGE_PollRunDone(struct I2C_BRIDGE_ScriptRun *run)
+{
+    if (!pollJob.IsRunning) {
+        return;
+    }
+
+    if ((pollJob.Flags & TXW51_SERV_I2C_POLL_FLAG_ON_CHANGE) &&
+        (run->ResultLength == pollJob.LastResultLength) &&
+        (memcmp(run->Result, pollJob.LastResult, run->ResultLength) == 0)) {
+        return;
+    }
+
+    if (TXW51_SERV_I2C_SendPollResult(bridgeServiceHandle, run->Result, run->ResultLength) == ERR_NONE) {
+        memcpy(pollJob.LastResult, run->Result, run->ResultLength);
+        pollJob.LastResultLength = run->ResultLength;
+    }
+}
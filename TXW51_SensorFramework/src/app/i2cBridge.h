@@ -22,13 +22,14 @@
 #include "txw51_framework/ble/service_i2c.h"
 
 /*----- Macros ---------------------------------------------------------------*/
+#define APPL_I2C_BRIDGE_POLL_MIN_PERIOD_MS  ( 50 )      /**< Shortest accepted period of a polling job in milliseconds. */
 
 /*----- Data types -----------------------------------------------------------*/
 
 /*----- Function prototypes --------------------------------------------------*/
 
 /***************************************************************************//**
- * @brief Initializes the I2C Bus .
+ * @brief Initializes the I2C Bus and the timer of the polling job.
  *
  * @return Nothing.
  ******************************************************************************/
@@ -43,6 +44,13 @@ extern void APPL_I2C_BRIDGE_Init(void);
  ******************************************************************************/
 extern uint32_t APPL_I2C_BRIDGE_InitService(struct TXW51_SERV_I2C_Handle *serviceHandle);
 
+/***************************************************************************//**
+ * @brief Stops a running polling job.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+extern void APPL_I2C_BRIDGE_StopPolling(void);
+
 
 /*----- Data -----------------------------------------------------------------*/
 uint8_t i2cAddress;
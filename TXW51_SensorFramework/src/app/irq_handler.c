@@ -13,9 +13,12 @@
 /*----- Header-Files ---------------------------------------------------------*/
 #include "nrf/nrf.h"
 
+#include "txw51_framework/hw/i2c.h"
 #include "txw51_framework/hw/lsm330.h"
+#include "txw51_framework/hw/tmp006.h"
 
 #include "app/adc_example.h"
+#include "app/contactless_temp.h"
 #include "app/sensor.h"
 
 /*----- Macros ---------------------------------------------------------------*/
@@ -46,6 +49,18 @@ void GPIOTE_IRQHandler(void)
         /* Event causing the interrupt must be cleared. */
         NRF_GPIOTE->EVENTS_IN[TXW51_LSM330_GPIO_INT2_GYRO_CHANNEL] = 0;
     }
+
+    if (NRF_GPIOTE->EVENTS_IN[TXW51_TMP006_GPIO_DRDY_CHANNEL]) {
+        APPL_CONTACTLESS_TEMP_HandleInterrupt(TXW51_TMP006_GPIO_DRDY_CHANNEL);
+        /* Event causing the interrupt must be cleared. */
+        NRF_GPIOTE->EVENTS_IN[TXW51_TMP006_GPIO_DRDY_CHANNEL] = 0;
+    }
+
+    /* INT2_A is the only pin with sense enabled. */
+    if (NRF_GPIOTE->EVENTS_PORT) {
+        NRF_GPIOTE->EVENTS_PORT = 0;
+        APPL_SENSOR_HandleInterrupt(TXW51_LSM330_GPIO_INT2_ACC_CHANNEL);
+    }
 }
 
 
@@ -65,3 +80,15 @@ void ADC_IRQHandler(void)
     NRF_ADC->TASKS_STOP = 1;
 }
 
+
+/***************************************************************************//**
+ * @brief Handles the interrupt events from the TWI1 module.
+ *
+ * SPI1 is not used, so the shared interrupt belongs to the I2C module.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+void SPI1_TWI1_IRQHandler(void)
+{
+    TXW51_I2C_HandleInterrupt();
+}
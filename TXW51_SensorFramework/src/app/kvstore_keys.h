@@ -0,0 +1,39 @@
+/***************************************************************************//**
+ * @brief   Keys of the values in the key-value store.
+ *
+ * The keys are stored on the flash, so existing keys must not be renumbered.
+ * New keys have to be smaller than CONFIG_KVSTORE_MAX_KEYS.
+ *
+ * @file    kvstore_keys.h
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+#ifndef TXW51_APPLICATION_KVSTORE_KEYS_H_
+#define TXW51_APPLICATION_KVSTORE_KEYS_H_
+
+/*----- Header-Files ---------------------------------------------------------*/
+
+/*----- Macros ---------------------------------------------------------------*/
+
+/*----- Data types -----------------------------------------------------------*/
+/**
+ * @brief List of the keys in the key-value store.
+ */
+enum appl_kvstore_key {
+    APPL_KVSTORE_KEY_DEVINFO        = 0,    /**< First device information entry, followed by the others (see enum appl_devinfo_value). */
+    APPL_KVSTORE_KEY_DEVINFO_FLAGS  = 6,    /**< Flags of the device information. */
+    APPL_KVSTORE_KEY_SENSOR_PROFILE = 7,    /**< Settings of the LSM330 sensor and the measurement. */
+    APPL_KVSTORE_KEY_BROADCAST      = 8,    /**< Interval of the broadcast in the advertising data. */
+    APPL_KVSTORE_KEY_SPI_FREQUENCY  = 9     /**< SPI clock of the LSM330 selected by the self-test (enum TXW51_SPI_Frequency). */
+};
+
+/*----- Function prototypes --------------------------------------------------*/
+
+/*----- Data -----------------------------------------------------------------*/
+
+#endif /* TXW51_APPLICATION_KVSTORE_KEYS_H_ */
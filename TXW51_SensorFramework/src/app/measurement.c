@@ -16,15 +16,26 @@
 /*----- Header-Files ---------------------------------------------------------*/
 #include "measurement.h"
 
+#include "nrf/app_common/app_timer.h"
+
+#include "txw51_framework/config/config.h"
 #include "txw51_framework/utils/log.h"
 #include "txw51_framework/hw/adc.h"
 
 #include "app/appl.h"
+#include "app/clock.h"
+#include "app/control.h"
+#include "app/diagnostics.h"
+#include "app/driver.h"
 #include "app/error.h"
 #include "app/fifo.h"
 #include "app/sensor.h"
+#include "app/stream.h"
 
 /*----- Macros ---------------------------------------------------------------*/
+#define MEASUREMENT_RATE_PER_WEIGHT     ( 50 )      /**< Sample rate in Hz per packet of a stream in a scheduler round. */
+#define MEASUREMENT_WINDOW_SIZE         ( 2 * APPL_CONTROL_MAX_ACK_INTERVAL )   /**< Unacknowledged packets of the reliable mode, a power of two up to 32. */
+#define MEASUREMENT_WINDOW_BIT(number)  ( 1UL << ((number) % MEASUREMENT_WINDOW_SIZE) ) /**< Bit of a packet of the window in resendMask. */
 
 /*----- Data types -----------------------------------------------------------*/
 
@@ -32,7 +43,22 @@
 static void MEASUREMENT_BleEventHandler(struct TXW51_SERV_MEASURE_Handle *handle,
                                         struct TXW51_SERV_MEASURE_Event *evt);
 
+static bool MEASUREMENT_IsPartialAllowed(void);
+static struct TXW51_SERV_MEASURE_DataPacket *MEASUREMENT_ReadAcc(void *context);
+static struct TXW51_SERV_MEASURE_DataPacket *MEASUREMENT_ReadGyro(void *context);
+static uint8_t MEASUREMENT_GetWeight(uint16_t rate);
 static void MEASURMENT_Read_ADC(uint8_t* value);
+static void MEASUREMENT_Start(void);
+static void MEASUREMENT_Stop(void);
+static void MEASUREMENT_DurationHandler(void *context);
+static void MEASUREMENT_SetDuration(const uint8_t *value, uint16_t length);
+static void MEASUREMENT_Control(const uint8_t *data, uint16_t length);
+static void MEASUREMENT_SendControlStatus(void);
+static void MEASUREMENT_SynchronizeClock(const struct APPL_CONTROL_Command *command);
+static void MEASUREMENT_Acknowledge(const struct APPL_CONTROL_Command *command);
+static void MEASUREMENT_ResendWindow(void);
+static struct TXW51_SERV_MEASURE_DataPacket *MEASUREMENT_NextPacket(void);
+static struct TXW51_SERV_MEASURE_DataPacket *MEASUREMENT_NextWindowPacket(void);
 
 /*----- Data -----------------------------------------------------------------*/
 static struct TXW51_SERV_MEASURE_Handle *measurementServiceHandle = NULL;   /**< Reference to the handle for the Bluetooth Smart Measurement Service. */
@@ -40,6 +66,22 @@ static struct TXW51_SERV_MEASURE_Handle *measurementServiceHandle = NULL;   /**<
 static bool isIndicationBusy = false;           /**< Flag to wait until an indication has been successfully received. */
 static uint8_t sequenceNumber = 0;              /**< Sequence number of the packets to send. */
 static uint8_t notificationPacketCount = 0;     /**< Number of notifications that we can send at a given time. */
+static uint8_t txBufferCount = 0;               /**< Number of TX buffers of the SoftDevice. */
+static bool isStarted = false;                  /**< Flag to remember if measurement has been started. */
+static uint16_t duration = 0;                   /**< Duration of the measurement in s, 0 for unlimited. */
+static app_timer_id_t durationTimer;            /**< Stops the measurement after its duration. */
+
+static uint8_t controlStatus[APPL_CONTROL_SYNC_ANSWER_LENGTH];    /**< Answer to the last command of the control point. */
+static uint8_t controlStatusLength = APPL_CONTROL_STATUS_LENGTH;    /**< Length of controlStatus. */
+static bool isControlStatusPending = false;                /**< Flag to indicate that controlStatus waits for a TX buffer. */
+
+static struct TXW51_SERV_MEASURE_DataPacket *pendingPacket = NULL;  /**< Packet that has been taken from a stream but not sent yet, NULL if none. */
+
+static bool isReliable = false;                             /**< Flag to keep the packets until the gateway acknowledges them. */
+static struct TXW51_SERV_MEASURE_DataPacket *window[MEASUREMENT_WINDOW_SIZE];   /**< Sent packets of the reliable mode in their FIFO slots, indexed by sequence number. */
+static uint8_t windowBase = 0;                              /**< Sequence number of the oldest unacknowledged packet. */
+static uint8_t sendNumber = 0;                              /**< Sequence number of the next packet of the window that has never been sent. */
+static uint32_t resendMask = 0;                             /**< Packets of the window to send again, see MEASUREMENT_WINDOW_BIT(). */
 
 /*----- Implementation -------------------------------------------------------*/
 
@@ -48,6 +90,7 @@ uint32_t APPL_MEASUREMENT_InitService(struct TXW51_SERV_MEASURE_Handle *serviceH
     uint32_t err = ERR_NONE;
 
     sd_ble_tx_buffer_count_get(&notificationPacketCount);
+    txBufferCount = notificationPacketCount;
 
     struct TXW51_SERV_MEASURE_Init measureInit;
     measureInit.EventHandler = MEASUREMENT_BleEventHandler;
@@ -59,6 +102,29 @@ uint32_t APPL_MEASUREMENT_InitService(struct TXW51_SERV_MEASURE_Handle *serviceH
 
     measurementServiceHandle = serviceHandle;
 
+    err = app_timer_create(&durationTimer,
+                           APP_TIMER_MODE_SINGLE_SHOT,
+                           MEASUREMENT_DurationHandler);
+    if (err != NRF_SUCCESS) {
+        TXW51_LOG_ERROR("[Measure Service] Could not create duration timer.");
+        return ERR_MEASUREMENT_TIMER_FAILED;
+    }
+
+    struct APPL_STREAM_Init accStream = {
+        .Read       = MEASUREMENT_ReadAcc,
+        .Context    = NULL,
+        .Weight     = 1,
+        .DeadlineMs = 0
+    };
+    struct APPL_STREAM_Init gyroStream = {
+        .Read       = MEASUREMENT_ReadGyro,
+        .Context    = NULL,
+        .Weight     = 1,
+        .DeadlineMs = 0
+    };
+    APPL_STREAM_Register(APPL_STREAM_ACC, &accStream);
+    APPL_STREAM_Register(APPL_STREAM_GYRO, &gyroStream);
+
     struct TXW51_ADC_InitTab init = {
         .RefSelection   = ADC_CONFIG_REFSEL_SupplyOneThirdPrescaling,
         .InputSelection = ADC_CONFIG_INPSEL_AnalogInputOneThirdPrescaling,
@@ -83,37 +149,31 @@ uint32_t APPL_MEASUREMENT_InitService(struct TXW51_SERV_MEASURE_Handle *serviceH
 static void MEASUREMENT_BleEventHandler(struct TXW51_SERV_MEASURE_Handle *handle,
                                         struct TXW51_SERV_MEASURE_Event *evt)
 {
-    static bool isStarted = false;  /* Flag to remember if measurement has been started. */
-
     switch (evt->EventType) {
         case TXW51_SERV_MEASURE_EVT_START:
-            if (isStarted) {
-                TXW51_LOG_INFO("[Measure Service] Measurement already started!");
-                return;
-            }
-
-            isStarted = true;
-            sequenceNumber = 0;
-            TXW51_LOG_INFO("[Measure Service] Start measurement");
-            APPL_SENSOR_StartToMeasure();
+            MEASUREMENT_Start();
             break;
 
         case TXW51_SERV_MEASURE_EVT_STOP:
-            APPL_SENSOR_StopToMeasure();
-            isStarted = false;
-            TXW51_LOG_INFO("[Measure Service] Stop measurement");
+            MEASUREMENT_Stop();
             break;
 
         case TXW51_SERV_MEASURE_EVT_SET_DURATION:
-            TXW51_LOG_INFO("[Measure Service] Set measurement duration");
+            MEASUREMENT_SetDuration(evt->Value, evt->Length);
             break;
 
         case TXW51_SERV_MEASURE_EVT_ENABLE_DATASTREAM:
             TXW51_LOG_INFO("[Measure Service] Enable data stream");
+            if (APPL_SENSOR_IsAutoStartEnabled() && !isStarted) {
+                MEASUREMENT_Start();
+            }
             break;
 
         case TXW51_SERV_MEASURE_EVT_DISABLE_DATASTREAM:
             TXW51_LOG_INFO("[Measure Service] Disable data stream");
+            if (APPL_SENSOR_IsAutoStartEnabled() && isStarted) {
+                MEASUREMENT_Stop();
+            }
             break;
 
         case TXW51_SERV_MEASURE_EVT_INDICATION_RECEIVED:
@@ -122,63 +182,469 @@ static void MEASUREMENT_BleEventHandler(struct TXW51_SERV_MEASURE_Handle *handle
 
         case TXW51_SERV_MEASURE_EVT_NOTIFICATIONS_SENT:
             notificationPacketCount += *evt->Value;
+            MEASUREMENT_SendControlStatus();
+            /* A retransmission does not wait for new samples. */
+            if (isReliable && ((sendNumber != sequenceNumber) || (resendMask != 0))) {
+                APPL_MEASUREMENT_SendAllData(TXW51_SERV_MEASURE_TX_NOTIFICATION);
+            }
             break;
 
         case TWX51_SERV_MEASURE_EVT_ADC:
         	MEASURMENT_Read_ADC(evt->Value);
             break;
 
+        case TXW51_SERV_MEASURE_EVT_DIAGNOSTICS:
+            evt->Length = APPL_DIAG_Read(evt->Value);
+            break;
+
+        case TXW51_SERV_MEASURE_EVT_CONTROL:
+            MEASUREMENT_Control(evt->Value, evt->Length);
+            break;
+
+        case TXW51_SERV_MEASURE_EVT_DISCONNECTED:
+            /* The packets in flight are lost, the window is sent again to the next peer. */
+            MEASUREMENT_ResendWindow();
+            break;
+
         default:
             break;
     }
 }
 
 
-void APPL_MEASUREMENT_SendAllData(enum TXW51_SERV_MEASURE_TxType txType)
+/***************************************************************************//**
+ * @brief Starts the measurement with the current sensor profile.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void MEASUREMENT_Start(void)
 {
-    if (((txType == TXW51_SERV_MEASURE_TX_INDICATION)   && isIndicationBusy) ||
-        ((txType == TXW51_SERV_MEASURE_TX_NOTIFICATION) && (notificationPacketCount == 0))) {
+    if (isStarted) {
+        TXW51_LOG_INFO("[Measure Service] Measurement already started!");
         return;
     }
 
-    uint32_t bytesRead;
-    struct TXW51_SERV_MEASURE_DataPacket packet;
+    isStarted = true;
+    sequenceNumber = 0;
+    pendingPacket = NULL;
+    windowBase = 0;
+    sendNumber = 0;
+    resendMask = 0;
+    APPL_FIFO_Reset();
+
+    /* Both sensors lose the same share of their samples if the link saturates. */
+    APPL_STREAM_SetWeight(APPL_STREAM_ACC, MEASUREMENT_GetWeight(APPL_SENSOR_GetAccRate()));
+    APPL_STREAM_SetWeight(APPL_STREAM_GYRO, MEASUREMENT_GetWeight(APPL_SENSOR_GetGyroRate()));
+    APPL_STREAM_Reset();
+
+    TXW51_LOG_INFO("[Measure Service] Start measurement");
+    APPL_SENSOR_StartToMeasure();
+    APPL_DRIVER_ConfigureAll(true);
+
+    if ((duration > 0) &&
+        (app_timer_start(durationTimer,
+                         APP_TIMER_TICKS((uint32_t)duration * 1000, CONFIG_TIMERS_PRESCALER),
+                         NULL) != NRF_SUCCESS)) {
+        TXW51_LOG_WARNING("[Measure Service] Could not start duration timer.");
+    }
+}
+
+
+/***************************************************************************//**
+ * @brief Stops the measurement.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void MEASUREMENT_Stop(void)
+{
+    app_timer_stop(durationTimer);
+    APPL_SENSOR_StopToMeasure();
+    APPL_DRIVER_ConfigureAll(false);
+    isStarted = false;
+    TXW51_LOG_INFO("[Measure Service] Stop measurement");
+}
+
+
+/***************************************************************************//**
+ * @brief Stops the measurement when its duration has expired.
+ *
+ * @param[in] context Not used.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void MEASUREMENT_DurationHandler(void *context)
+{
+    TXW51_LOG_INFO("[Measure Service] Measurement duration expired");
+    MEASUREMENT_Stop();
+}
+
+
+/***************************************************************************//**
+ * @brief Sets the duration of the following measurements.
+ *
+ * @param[in] value  The duration in s (little endian), 0 for unlimited.
+ * @param[in] length Length of the value, 1 or 2 bytes.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void MEASUREMENT_SetDuration(const uint8_t *value, uint16_t length)
+{
+    duration = value[0];
+    if (length > 1) {
+        duration |= value[1] << 8;
+    }
+    TXW51_LOG_INFO("[Measure Service] Set measurement duration");
+}
+
+
+/***************************************************************************//**
+ * @brief Applies a command of the control point and answers it.
+ *
+ * The command is checked completely first, so it is applied as a whole or not
+ * at all. The sensors get reconfigured while they are stopped, a running
+ * measurement is started again unless the command stops it.
+ *
+ * @param[in] data   The command, see app/control.h.
+ * @param[in] length Length of the command in bytes.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void MEASUREMENT_Control(const uint8_t *data, uint16_t length)
+{
+    struct APPL_CONTROL_Command command;
+    bool wasStarted = isStarted;
 
-    if (gIsNewAccDataAvailable) {
-        bytesRead = APPL_FIFO_Get(APPL_FIFO_BUFFER_ACC, packet.Data, 3 * 6);
-        if (bytesRead == 0) {
-            gIsNewAccDataAvailable = false;
+    controlStatusLength = APPL_CONTROL_STATUS_LENGTH;
+    if (APPL_CONTROL_Parse(data, length, &command, controlStatus) == APPL_CONTROL_STATUS_SUCCESS) {
+        if (command.Opcode == APPL_CONTROL_OP_ACK) {
+            MEASUREMENT_Acknowledge(&command);
             return;
         }
-        packet.Header.AccOrGyro = TXW51_SERV_MEASURE_DATA_SENSOR_ACC;
+        if (command.Opcode >= APPL_CONTROL_OP_SYNC) {
+            MEASUREMENT_SynchronizeClock(&command);
+            isControlStatusPending = true;
+            MEASUREMENT_SendControlStatus();
+            return;
+        }
+
+        if (isStarted) {
+            MEASUREMENT_Stop();
+        }
+
+        if (command.Fields & APPL_CONTROL_FIELD_ACC) {
+            APPL_SENSOR_ConfigureAcc(&command.Acc);
+        }
+        if (command.Fields & APPL_CONTROL_FIELD_GYRO) {
+            APPL_SENSOR_ConfigureGyro(&command.Gyro);
+        }
+        if (command.Fields & APPL_CONTROL_FIELD_STREAM_MODE) {
+            APPL_SENSOR_SetStreamMode(command.StreamMode);
+        }
+        if (command.Fields & APPL_CONTROL_FIELD_DURATION) {
+            duration = command.Duration;
+        }
+        if (command.Fields & APPL_CONTROL_FIELD_RELIABLE) {
+            isReliable = (command.AckInterval > 0);
+        }
+
+        if ((command.Opcode == APPL_CONTROL_OP_START) ||
+            ((command.Opcode == APPL_CONTROL_OP_CONFIGURE) && wasStarted)) {
+            MEASUREMENT_Start();
+        }
+    } else {
+        TXW51_LOG_WARNING("[Measure Service] Control point command rejected.");
+    }
+
+    isControlStatusPending = true;
+    MEASUREMENT_SendControlStatus();
+}
+
+
+/***************************************************************************//**
+ * @brief Sends the answer to the last command of the control point.
+ *
+ * The answer takes a TX buffer like the data stream. Without a free buffer,
+ * it gets sent after the next TX complete event.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void MEASUREMENT_SendControlStatus(void)
+{
+    if (!isControlStatusPending || (notificationPacketCount == 0)) {
+        return;
+    }
+
+    /* With a free TX buffer, an error can not be resolved by retrying. */
+    isControlStatusPending = false;
+    if (TXW51_SERV_MEASURE_SendControlStatus(measurementServiceHandle,
+                                             controlStatus,
+                                             controlStatusLength) == ERR_NONE) {
+        notificationPacketCount--;
+    }
+}
+
+
+/***************************************************************************//**
+ * @brief Handles the clock exchange commands of the control point.
+ *
+ * A clock exchange is answered with the device time of its receipt instead
+ * of a status, the result of an exchange goes to the device time.
+ *
+ * @param[in] command The checked command.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void MEASUREMENT_SynchronizeClock(const struct APPL_CONTROL_Command *command)
+{
+    uint32_t deviceTime;
+
+    if (command->Opcode == APPL_CONTROL_OP_SYNC) {
+        deviceTime = APPL_CLOCK_GetTime();
+        controlStatus[1] = command->GatewayTime & 0xFF;
+        controlStatus[2] = (command->GatewayTime >> 8) & 0xFF;
+        controlStatus[3] = (command->GatewayTime >> 16) & 0xFF;
+        controlStatus[4] = command->GatewayTime >> 24;
+        controlStatus[5] = deviceTime & 0xFF;
+        controlStatus[6] = (deviceTime >> 8) & 0xFF;
+        controlStatus[7] = (deviceTime >> 16) & 0xFF;
+        controlStatus[8] = deviceTime >> 24;
+        controlStatusLength = APPL_CONTROL_SYNC_ANSWER_LENGTH;
+    } else if (APPL_CLOCK_Synchronize(command->DeviceTime,
+                                      command->GatewayTime,
+                                      command->RoundTrip) != ERR_NONE) {
+        TXW51_LOG_WARNING("[Measure Service] Clock exchange rejected.");
+        controlStatus[1] = APPL_CONTROL_STATUS_INVALID_VALUE;
+    }
+}
+
+
+/***************************************************************************//**
+ * @brief Moves the window of the reliable mode with an acknowledgement.
+ *
+ * The packets before Next are released. The missing packets the gateway
+ * lists are sent again (selective repeat), the packets it has received
+ * behind a gap are kept by the gateway and not sent again.
+ *
+ * @param[in] command The acknowledgement.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void MEASUREMENT_Acknowledge(const struct APPL_CONTROL_Command *command)
+{
+    uint8_t acked = command->Next - windowBase;
+    uint32_t oldMask = resendMask;
+
+    /* Stale or beyond the packets that have been sent. */
+    if (!isReliable || (acked > (uint8_t)(sendNumber - windowBase))) {
+        return;
+    }
+
+    /* The slots are released in the order they have been taken. */
+    for (; windowBase != command->Next; windowBase++) {
+        resendMask &= ~MEASUREMENT_WINDOW_BIT(windowBase);
+        APPL_FIFO_Release(window[windowBase % MEASUREMENT_WINDOW_SIZE]);
+    }
+
+    for (uint32_t i = 0; i < command->NumberOfMissing; i++) {
+        uint8_t missing = command->Missing[i];
+        if ((uint8_t)(missing - windowBase) < (uint8_t)(sendNumber - windowBase)) {
+            resendMask |= MEASUREMENT_WINDOW_BIT(missing);
+        }
+    }
+
+    if ((acked > 0) || (resendMask != oldMask)) {
+        APPL_MEASUREMENT_SendAllData(TXW51_SERV_MEASURE_TX_NOTIFICATION);
+    }
+}
+
+
+/***************************************************************************//**
+ * @brief Marks all sent packets of the window to be sent again.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void MEASUREMENT_ResendWindow(void)
+{
+    for (uint8_t number = windowBase; number != sendNumber; number++) {
+        resendMask |= MEASUREMENT_WINDOW_BIT(number);
+    }
+}
+
+
+/***************************************************************************//**
+ * @brief Checks if a partial packet of a sensor may be sent.
+ *
+ * In the low-latency mode, a partial packet is held back while the SoftDevice
+ * has notifications queued. The samples that arrive until the queue has been
+ * sent in the next connection event are coalesced instead of being sent one
+ * per packet, which would saturate the link.
+ *
+ * @return True if the open slot of a FIFO may be taken.
+ ******************************************************************************/
+static bool MEASUREMENT_IsPartialAllowed(void)
+{
+    return !(APPL_SENSOR_IsLowLatency() && (notificationPacketCount < txBufferCount));
+}
+
+
+/***************************************************************************//**
+ * @brief Takes the next packet of the accelerometer stream.
+ *
+ * @param[in] context Not used.
+ *
+ * @return The packet, NULL if there is no data or it is held back.
+ ******************************************************************************/
+static struct TXW51_SERV_MEASURE_DataPacket *MEASUREMENT_ReadAcc(void *context)
+{
+    struct TXW51_SERV_MEASURE_DataPacket *packet;
+
+    if (!gIsNewAccDataAvailable) {
+        return NULL;
+    }
+    packet = APPL_FIFO_Take(APPL_FIFO_BUFFER_ACC, MEASUREMENT_IsPartialAllowed());
+    if (packet == NULL) {
+        /* A held back packet is retried after the next TX complete. */
+        gIsNewAccDataAvailable = !APPL_FIFO_IsEmpty(APPL_FIFO_BUFFER_ACC);
+    }
+    return packet;
+}
+
+
+/***************************************************************************//**
+ * @brief Takes the next packet of the gyroscope stream.
+ *
+ * @param[in] context Not used.
+ *
+ * @return The packet, NULL if there is no data or it is held back.
+ ******************************************************************************/
+static struct TXW51_SERV_MEASURE_DataPacket *MEASUREMENT_ReadGyro(void *context)
+{
+    struct TXW51_SERV_MEASURE_DataPacket *packet;
+
+    if (!gIsNewGyroDataAvailable) {
+        return NULL;
+    }
+    packet = APPL_FIFO_Take(APPL_FIFO_BUFFER_GYRO, MEASUREMENT_IsPartialAllowed());
+    if (packet == NULL) {
+        /* A held back packet is retried after the next TX complete. */
+        gIsNewGyroDataAvailable = !APPL_FIFO_IsEmpty(APPL_FIFO_BUFFER_GYRO);
     }
+    return packet;
+}
+
+
+/***************************************************************************//**
+ * @brief Computes the scheduler weight of a sensor stream.
+ *
+ * The weight is proportional to the sample rate, because every packet holds
+ * the same number of samples.
+ *
+ * @param[in] rate The sample rate in Hz.
+ *
+ * @return The weight, at least 1.
+ ******************************************************************************/
+static uint8_t MEASUREMENT_GetWeight(uint16_t rate)
+{
+    return rate / MEASUREMENT_RATE_PER_WEIGHT + 1;
+}
+
 
-    if (gIsNewGyroDataAvailable) {
-        bytesRead = APPL_FIFO_Get(APPL_FIFO_BUFFER_GYRO, packet.Data, 3 * 6);
-        if (bytesRead == 0) {
-            gIsNewGyroDataAvailable = false;
+void APPL_MEASUREMENT_SendAllData(enum TXW51_SERV_MEASURE_TxType txType)
+{
+    /* Keep the data captured after a motion until a peer is connected. */
+    if (measurementServiceHandle->ServiceHandle.ConnHandle == BLE_CONN_HANDLE_INVALID) {
+        return;
+    }
+
+    /* Fill all TX buffers the SoftDevice offers. */
+    while (!((txType == TXW51_SERV_MEASURE_TX_INDICATION)   && isIndicationBusy) &&
+           !((txType == TXW51_SERV_MEASURE_TX_NOTIFICATION) && (notificationPacketCount == 0))) {
+        struct TXW51_SERV_MEASURE_DataPacket *packet =
+            isReliable ? MEASUREMENT_NextWindowPacket() : MEASUREMENT_NextPacket();
+        if (packet == NULL) {
             return;
         }
-        packet.Header.AccOrGyro = TXW51_SERV_MEASURE_DATA_SENSOR_GYRO;
+
+        /* Keep the packet to try again later. */
+        if (TXW51_SERV_MEASURE_SendData(txType,
+                                        measurementServiceHandle,
+                                        packet) != ERR_NONE) {
+            return;
+        }
+        if (isReliable) {
+            if (packet->Number == sendNumber) {
+                sendNumber++;
+            } else {
+                resendMask &= ~MEASUREMENT_WINDOW_BIT(packet->Number);
+            }
+        } else {
+            APPL_FIFO_Release(pendingPacket);
+            pendingPacket = NULL;
+        }
+
+        if (txType == TXW51_SERV_MEASURE_TX_INDICATION) {
+            isIndicationBusy = true;
+        } else {
+            notificationPacketCount--;
+        }
     }
+}
 
-    packet.Header.Axis = (TXW51_SERV_MEASURE_DATA_AXIS_X |
-                          TXW51_SERV_MEASURE_DATA_AXIS_Y |
-                          TXW51_SERV_MEASURE_DATA_AXIS_Z);
-    packet.Header.NumberOfSamples = bytesRead / 6;
-    packet.Number = sequenceNumber++;
 
-    if (txType == TXW51_SERV_MEASURE_TX_INDICATION) {
-        isIndicationBusy = true;
-    } else {
-        notificationPacketCount--;
+/***************************************************************************//**
+ * @brief Gets the next packet to send without the reliable mode.
+ *
+ * @return The packet, NULL if there is no data.
+ ******************************************************************************/
+static struct TXW51_SERV_MEASURE_DataPacket *MEASUREMENT_NextPacket(void)
+{
+    if (pendingPacket == NULL) {
+        pendingPacket = APPL_STREAM_Next();
+        if (pendingPacket == NULL) {
+            return NULL;
+        }
+        pendingPacket->Number = sequenceNumber++;
     }
-    TXW51_SERV_MEASURE_SendData(txType,
-                                measurementServiceHandle,
-                                &packet);
+    return pendingPacket;
 }
 
-void MEASURMENT_Read_ADC(uint8_t* value)
+
+/***************************************************************************//**
+ * @brief Gets the next packet to send in the reliable mode.
+ *
+ * The oldest retransmission comes first, the gateway delivers in order. New
+ * packets are taken from the streams into the window only while it has room,
+ * a full window waits for the next acknowledgement and leaves the samples in
+ * the FIFOs.
+ *
+ * @return The packet, NULL if there is no data or the window is full.
+ ******************************************************************************/
+static struct TXW51_SERV_MEASURE_DataPacket *MEASUREMENT_NextWindowPacket(void)
+{
+    if (resendMask != 0) {
+        for (uint8_t number = windowBase; number != sendNumber; number++) {
+            if (resendMask & MEASUREMENT_WINDOW_BIT(number)) {
+                return window[number % MEASUREMENT_WINDOW_SIZE];
+            }
+        }
+    }
+
+    if (sendNumber == sequenceNumber) {
+        if ((uint8_t)(sequenceNumber - windowBase) >= MEASUREMENT_WINDOW_SIZE) {
+            return NULL;
+        }
+        struct TXW51_SERV_MEASURE_DataPacket *packet = APPL_STREAM_Next();
+        if (packet == NULL) {
+            return NULL;
+        }
+        packet->Number = sequenceNumber;
+        window[sequenceNumber++ % MEASUREMENT_WINDOW_SIZE] = packet;
+    }
+    return window[sendNumber % MEASUREMENT_WINDOW_SIZE];
+}
+
+
+void APPL_MEASUREMENT_ReadBattery(uint8_t *value)
 {
 	NRF_ADC->TASKS_START = 1U;
 	while(NRF_ADC->BUSY);
@@ -187,11 +653,15 @@ void MEASURMENT_Read_ADC(uint8_t* value)
 	/* Use the STOP task to save current. Workaround for PAN_028 rev1.5 anomaly 1. */
 	NRF_ADC->TASKS_STOP = 1U;
 
-	uint8_t result = NRF_ADC->RESULT;
+	*value = NRF_ADC->RESULT;
+}
+
+
+void MEASURMENT_Read_ADC(uint8_t* value)
+{
+	APPL_MEASUREMENT_ReadBattery(value);
 
 	char outputBuffer[20];
-	snprintf(outputBuffer, 21, "%s %u", "Result:", result);
+	snprintf(outputBuffer, sizeof(outputBuffer), "%s %u", "Result:", *value);
 	TXW51_LOG_DEBUG(outputBuffer);
-
-	*value = result;
 }
@@ -34,13 +34,23 @@
  *
  * @return ERR_NONE if no error occurred.
  *         ERR_BLE_SERVICE_INIT_FAILED if service initialization failed.
+ *         ERR_MEASUREMENT_TIMER_FAILED if the duration timer could not be
+ *         created.
  ******************************************************************************/
 extern uint32_t APPL_MEASUREMENT_InitService(struct TXW51_SERV_MEASURE_Handle *serviceHandle);
 
 /***************************************************************************//**
  * @brief Sends as much data as possible over the Bluetooth link.
  *
- * Data can be sent via indications or notification.
+ * Data can be sent via indications or notification. The packets get taken
+ * from the streams by the packet scheduler (see stream.h) until all TX
+ * buffers are used or all streams are empty. In the reliable mode of the
+ * control point (see control.h), retransmissions go first and a full window
+ * of unacknowledged packets stops the sending as well.
+ *
+ * The packets are sent from their slots in the FIFO buffers (see fifo.h). A
+ * slot is released when its packet has been queued, or in the reliable mode
+ * when it has been acknowledged.
  *
  * @param[in] txType Set to send the data with indications or notifications.
  *
@@ -48,5 +58,17 @@ extern uint32_t APPL_MEASUREMENT_InitService(struct TXW51_SERV_MEASURE_Handle *s
  ******************************************************************************/
 extern void APPL_MEASUREMENT_SendAllData(enum TXW51_SERV_MEASURE_TxType txType);
 
+/***************************************************************************//**
+ * @brief Reads the battery voltage with the ADC.
+ *
+ * The ADC is initialized with the service.
+ *
+ * @param[out] value Raw 8-bit value, 1/3 of the input relative to 1/3 of the
+ *                   supply voltage.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+extern void APPL_MEASUREMENT_ReadBattery(uint8_t *value);
+
 /*----- Data -----------------------------------------------------------------*/
 #endif /* TXW51_APPLICATION_MEASUREMENT_H_ */
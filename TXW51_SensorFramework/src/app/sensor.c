@@ -16,27 +16,109 @@
 /*----- Header-Files ---------------------------------------------------------*/
 #include "sensor.h"
 
+#include <stddef.h>
 #include <string.h>
 #include <stdio.h>
 
+#include "nrf/s110/nrf_soc.h"
+#include "nrf/sd_common/app_util_platform.h"
+
+#include "txw51_framework/hw/gpio.h"
 #include "txw51_framework/hw/lsm330.h"
+#include "txw51_framework/utils/kvstore.h"
 #include "txw51_framework/utils/log.h"
+#include "txw51_framework/utils/txw51_errors.h"
 
 #include "app/appl.h"
+#include "app/broadcast.h"
 #include "app/error.h"
 #include "app/fifo.h"
+#include "app/kvstore_keys.h"
 
 /*----- Macros ---------------------------------------------------------------*/
+#define SENSOR_STANDBY_ODR  ( TXW51_LSM330_ACC_ODR_50 )     /**< ODR of the accelerometer in standby, the FIFO holds 32 samples (640ms) before a motion. */
+
+#define SENSOR_FIFO_SIZE            ( TXW51_LSM330_ACC_FIFO_SIZE )  /**< Size of the FIFOs of both sensors. */
+#define SENSOR_SAMPLE_SIZE          ( 6 )       /**< Bytes of a sample of both sensors, three axes of 16 bits. */
+#define SENSOR_MIN_WATERMARK        ( 4 )       /**< Lowest watermark, limits the interrupt rate if the drain is slow. */
+#define SENSOR_MAX_DRAIN_PERIOD_MS  ( 100 )     /**< Longest time the samples wait in the sensor FIFO at low ODRs. */
+#define SENSOR_LATENCY_MARGIN       ( 2 )       /**< Samples kept free in the sensor FIFO in addition to twice the drain latency. */
+#define SENSOR_LATENCY_DECAY        ( 8 )       /**< The peak drain latency decays by 1/SENSOR_LATENCY_DECAY per drain. */
+
+#define SENSOR_DRAIN_ACC            ( 0x01 )    /**< The accelerometer waits for the end of the connection event. */
+#define SENSOR_DRAIN_GYRO           ( 0x02 )    /**< The gyroscope waits for the end of the connection event. */
+#define SENSOR_CONN_INTERVALS_PER_S ( 800 )     /**< Connection interval units (1.25 ms) per second. */
 
 /*----- Data types -----------------------------------------------------------*/
+/**
+ * @brief Settings of the sensors that are restored after a reset.
+ *
+ * The structure is saved as is, so new members have to be appended.
+ */
+struct SENSOR_Profile {
+    uint8_t AccEnable;      /**< Accelerometer enabled. */
+    uint8_t GyroEnable;     /**< Gyroscope enabled. */
+    uint8_t AccFscale;      /**< Full-scale of the accelerometer. */
+    uint8_t GyroFscale;     /**< Full-scale of the gyroscope. */
+    uint8_t AccOdr;         /**< ODR of the accelerometer. */
+    uint8_t GyroOdr;        /**< ODR of the gyroscope. */
+    uint8_t AutoStart;      /**< Start the measurement when the data stream gets enabled. */
+    uint8_t StreamMode;     /**< How the samples are read, see enum APPL_SENSOR_StreamMode. */
+    uint8_t AccAxes;        /**< Axes of the accelerometer in the measurement. */
+    uint8_t GyroAxes;       /**< Axes of the gyroscope in the measurement. */
+    uint8_t AccWatermark;   /**< Fixed watermark of the accelerometer, 0 if it is tuned. */
+    uint8_t GyroWatermark;  /**< Fixed watermark of the gyroscope, 0 if it is tuned. */
+};
+
+/**
+ * @brief State of the FIFO drain of a sensor.
+ *
+ * The drain latency is measured in samples: the samples that arrived between
+ * the watermark interrupt and the drain, without the planned wait for the end
+ * of a radio event.
+ */
+struct SENSOR_Stream {
+    uint8_t  Watermark;     /**< Current watermark of the sensor FIFO. */
+    uint8_t  Latency;       /**< Decaying peak of the drain latency in samples. */
+    uint32_t Overruns;      /**< Number of drains that found the sensor FIFO full. */
+    bool     IsStarted;     /**< The sensor FIFO is in stream mode. */
+    bool     IsDataReady;   /**< The data-ready interrupt starts the drain instead of the watermark. */
+    bool     IsDeferred;    /**< The drain waits for the end of a connection event. */
+};
+
+/**
+ * @brief Summary of the acceleration magnitude since it was last taken.
+ */
+struct SENSOR_Motion {
+    uint64_t SumSquares;    /**< Sum of the squared magnitudes in raw units. */
+    uint32_t PeakSquare;    /**< Largest squared magnitude in raw units. */
+    uint32_t Samples;       /**< Number of summarized samples. */
+};
 
 /*----- Function prototypes --------------------------------------------------*/
 static void SENSOR_StartAcc(void);
 static void SENSOR_StopAcc(void);
 static void SENSOR_StartGyro(void);
 static void SENSOR_StopGyro(void);
+static void SENSOR_ConfigAccInterrupts(bool isDataReady);
+static void SENSOR_ConfigGyroInterrupts(bool isDataReady);
+static void SENSOR_ResetStream(struct SENSOR_Stream *stream);
+static struct TXW51_LSM330_Axis SENSOR_GetAxis(uint8_t axes);
+static uint8_t SENSOR_TuneWatermark(struct SENSOR_Stream *stream,
+                                    uint32_t count,
+                                    bool isOverrun,
+                                    uint16_t odr);
+static void SENSOR_SetFifoFormats(void);
+static void SENSOR_AccumulateMotion(const uint8_t *buffer, uint32_t count);
+static uint32_t SENSOR_ReadSamples(enum appl_fifo_type bufferType,
+                                   uint32_t count,
+                                   bool isMotionAccumulated);
+static uint32_t SENSOR_Sqrt(uint64_t value);
 static void SENSOR_ACC_ReadData(void *data, uint16_t size);
 static void SENSOR_GYRO_ReadData(void *data, uint16_t size);
+static void SENSOR_RequestDrain(uint8_t drain, struct SENSOR_Stream *stream, uint16_t odr);
+static void SENSOR_ScheduleDrains(uint8_t drains);
+static uint32_t SENSOR_GetConnIntervalSamples(uint16_t odr);
 static void SENSOR_ACC_DebugInterrupt(void *data, uint16_t size);
 static void SENSOR_GYRO_DebugInterrupt(void *data, uint16_t size);
 static void SENSOR_BleEventHandler(struct TXW51_SERV_LSM330_Handle *handle,
@@ -48,17 +130,48 @@ static void SENSOR_SetFullscaleAcc(uint8_t value);
 static void SENSOR_SetFullscaleGyro(uint8_t value);
 static void SENSOR_SetOdrAcc(uint8_t value);
 static void SENSOR_SetOdrGyro(uint8_t value);
+static void SENSOR_SetAutoStart(uint8_t enable);
+static void SENSOR_SaveProfile(void);
 
 /*----- Data -----------------------------------------------------------------*/
-static bool isAccEnabled = false;       /**< Flag to indicate if the accelerometer has been enabled. */
-static bool isGyroEnabled = false;      /**< Flag to indicate if the gyroscope has been enabled. */
+/**
+ * @brief The current sensor profile, initialized with the defaults.
+ */
+static struct SENSOR_Profile profile = {
+    .AccEnable  = false,
+    .GyroEnable = false,
+    .AccFscale  = TXW51_LSM330_ACC_FSCALE_2G,
+    .GyroFscale = TXW51_LSM330_GYRO_FSCALE_250DPS,
+    .AccOdr     = TXW51_LSM330_ACC_ODR_OFF,
+    .GyroOdr    = TXW51_LSM330_GYRO_ODR_95,
+    .AutoStart  = false,
+    .StreamMode = APPL_SENSOR_MODE_THROUGHPUT,
+    .AccAxes    = APPL_SENSOR_ALL_AXES,
+    .GyroAxes   = APPL_SENSOR_ALL_AXES,
+    .AccWatermark  = 0,
+    .GyroWatermark = 0
+};
+
+static struct SENSOR_Stream accStream;     /**< FIFO drain of the accelerometer. */
+static struct SENSOR_Stream gyroStream;    /**< FIFO drain of the gyroscope. */
+static struct SENSOR_Motion motion;        /**< Acceleration summary for the broadcast. */
+
+static const uint16_t accOdrs[]  = { 0, 4, 7, 13, 25, 50, 100, 400, 800, 1600 };  /**< ODRs of enum TXW51_LSM330_ACC_Odr in Hz, rounded up. */
+static const uint16_t gyroOdrs[] = { 95, 190, 380, 760 };                         /**< ODRs of enum TXW51_LSM330_GYRO_Odr in Hz. */
+static const uint8_t  accFscales[] = { 2, 4, 6, 8, 16 };                          /**< Full-scales of enum TXW51_LSM330_ACC_Fscale in g. */
+
+static bool isStandby = false;      /**< Flag to indicate that the sensor waits for a motion. */
+static bool isCapturing = false;    /**< Flag to indicate that the samples after a motion are captured with the standby ODR. */
+
+static volatile uint16_t connInterval = 0;  /**< Longest time between two connection events in 1.25 ms units while the drains are aligned, 0 otherwise. */
+static volatile uint8_t pendingDrains = 0;  /**< SENSOR_DRAIN_* of the drains that wait for the end of the connection event. */
 
 /*----- Implementation -------------------------------------------------------*/
 
 void APPL_SENSOR_Init(void)
 {
     TXW51_LSM330_Init();
-    TXW51_LSM330_EnableGyro(false);
+    TXW51_LSM330_EnableGyro(profile.GyroEnable);
 
     struct TXW51_LSM330_ACC_FifoInit accFifoConfig = {
         .FifoEnable      = true,
@@ -76,89 +189,426 @@ void APPL_SENSOR_Init(void)
     };
     TXW51_LSM330_GYRO_ConfigFifo(&gyroFifoConfig);
 
-    struct TXW51_LSM330_Axis accAxisConfig = {
-        .X_Enable = true,
-        .Y_Enable = true,
-        .Z_Enable = true
-    };
+    /* The motion wakeup needs all axes, the profile selects the axes of a
+     * measurement when it starts. */
+    struct TXW51_LSM330_Axis accAxisConfig = SENSOR_GetAxis(APPL_SENSOR_ALL_AXES);
     TXW51_LSM330_ACC_SetActiveAxis(&accAxisConfig);
 
-    struct TXW51_LSM330_Axis gyroAxisConfig = {
-        .X_Enable = true,
-        .Y_Enable = true,
-        .Z_Enable = true
-    };
+    struct TXW51_LSM330_Axis gyroAxisConfig = SENSOR_GetAxis(profile.GyroAxes);
     TXW51_LSM330_GYRO_SetActiveAxis(&gyroAxisConfig);
 
-    TXW51_LSM330_ACC_SetFullscale(TXW51_LSM330_ACC_FSCALE_2G);
-    TXW51_LSM330_GYRO_SetFullscale(TXW51_LSM330_GYRO_FSCALE_250DPS);
+    TXW51_LSM330_ACC_SetFullscale(profile.AccFscale);
+    TXW51_LSM330_GYRO_SetFullscale(profile.GyroFscale);
+
+    TXW51_LSM330_ACC_SetOdr(profile.AccOdr);
+    TXW51_LSM330_GYRO_SetOdr(profile.GyroOdr);
+
+    SENSOR_ConfigAccInterrupts(false);
+    SENSOR_ConfigGyroInterrupts(false);
+    SENSOR_SetFifoFormats();
+}
+
+
+void APPL_SENSOR_LoadProfile(void)
+{
+    /* Profiles saved before the stream mode existed are shorter, the
+     * appended members keep their defaults. */
+    struct SENSOR_Profile storedProfile = profile;
+    uint8_t length = sizeof(storedProfile);
+    uint32_t err;
+
+    err = TXW51_KVSTORE_Get(APPL_KVSTORE_KEY_SENSOR_PROFILE,
+                            (uint8_t *)&storedProfile,
+                            &length);
+    if ((err != ERR_NONE) || (length < offsetof(struct SENSOR_Profile, StreamMode))) {
+        TXW51_LOG_DEBUG("[LSM330 Sensor] No sensor profile stored.");
+        return;
+    }
+
+    if ((storedProfile.AccFscale > TXW51_LSM330_ACC_FSCALE_16G) ||
+        (storedProfile.GyroFscale > TXW51_LSM330_GYRO_FSCALE_2000DPS) ||
+        (storedProfile.AccOdr > TXW51_LSM330_ACC_ODR_1600) ||
+        (storedProfile.GyroOdr > TXW51_LSM330_GYRO_ODR_760) ||
+        (storedProfile.StreamMode > APPL_SENSOR_MODE_LOW_LATENCY) ||
+        (storedProfile.AccAxes == 0) || (storedProfile.AccAxes > APPL_SENSOR_ALL_AXES) ||
+        (storedProfile.GyroAxes == 0) || (storedProfile.GyroAxes > APPL_SENSOR_ALL_AXES) ||
+        (storedProfile.AccWatermark >= TXW51_LSM330_ACC_FIFO_SIZE) ||
+        (storedProfile.GyroWatermark >= TXW51_LSM330_GYRO_FIFO_SIZE)) {
+        TXW51_LOG_WARNING("[LSM330 Sensor] Stored sensor profile is invalid.");
+        return;
+    }
+
+    profile.AccEnable  = (storedProfile.AccEnable != 0);
+    profile.GyroEnable = (storedProfile.GyroEnable != 0);
+    profile.AccFscale  = storedProfile.AccFscale;
+    profile.GyroFscale = storedProfile.GyroFscale;
+    profile.AccOdr     = storedProfile.AccOdr;
+    profile.GyroOdr    = storedProfile.GyroOdr;
+    profile.AutoStart  = (storedProfile.AutoStart != 0);
+    profile.StreamMode = storedProfile.StreamMode;
+    profile.AccAxes    = storedProfile.AccAxes;
+    profile.GyroAxes   = storedProfile.GyroAxes;
+    profile.AccWatermark  = storedProfile.AccWatermark;
+    profile.GyroWatermark = storedProfile.GyroWatermark;
+
+    TXW51_LOG_INFO("[LSM330 Sensor] Sensor profile restored.");
+}
+
+
+void APPL_SENSOR_StartToMeasure(void)
+{
+    SENSOR_SaveProfile();
+
+    if (isCapturing) {
+        /* Return from the standby settings to the profile. */
+        isCapturing = false;
+        TXW51_LSM330_ACC_SetOdr(profile.AccOdr);
+        TXW51_LSM330_EnableGyro(profile.GyroEnable);
+    }
+
+    if (profile.AccEnable) {
+        SENSOR_StartAcc();
+    }
+    if (profile.GyroEnable) {
+        SENSOR_StartGyro();
+    }
+}
+
+
+bool APPL_SENSOR_IsAutoStartEnabled(void)
+{
+    return profile.AutoStart;
+}
+
+
+uint16_t APPL_SENSOR_GetAccRate(void)
+{
+    return profile.AccEnable ? accOdrs[profile.AccOdr] : 0;
+}
+
+
+uint16_t APPL_SENSOR_GetGyroRate(void)
+{
+    return profile.GyroEnable ? gyroOdrs[profile.GyroOdr] : 0;
+}
+
+
+bool APPL_SENSOR_IsLowLatency(void)
+{
+    return (profile.StreamMode == APPL_SENSOR_MODE_LOW_LATENCY);
+}
+
+
+uint8_t APPL_SENSOR_GetAccAxes(void)
+{
+    return profile.AccAxes;
+}
+
+
+uint8_t APPL_SENSOR_GetGyroAxes(void)
+{
+    return profile.GyroAxes;
+}
+
+
+void APPL_SENSOR_GetAccConfig(struct APPL_SENSOR_Config *config)
+{
+    config->Axes      = profile.AccEnable ? profile.AccAxes : 0;
+    config->Odr       = profile.AccOdr;
+    config->Fscale    = profile.AccFscale;
+    config->Watermark = profile.AccWatermark;
+}
+
+
+void APPL_SENSOR_GetGyroConfig(struct APPL_SENSOR_Config *config)
+{
+    config->Axes      = profile.GyroEnable ? profile.GyroAxes : 0;
+    config->Odr       = profile.GyroOdr;
+    config->Fscale    = profile.GyroFscale;
+    config->Watermark = profile.GyroWatermark;
+}
+
+
+void APPL_SENSOR_ConfigureAcc(const struct APPL_SENSOR_Config *config)
+{
+    SENSOR_EnableAcc(config->Axes != 0);
+    if (config->Axes != 0) {
+        profile.AccAxes = config->Axes;
+    }
+    profile.AccWatermark = config->Watermark;
+    SENSOR_SetOdrAcc(config->Odr);
+    SENSOR_SetFullscaleAcc(config->Fscale);
+    SENSOR_SetFifoFormats();
+}
+
+
+void APPL_SENSOR_ConfigureGyro(const struct APPL_SENSOR_Config *config)
+{
+    SENSOR_EnableGyro(config->Axes != 0);
+    if (config->Axes != 0) {
+        profile.GyroAxes = config->Axes;
+    }
+    profile.GyroWatermark = config->Watermark;
+    SENSOR_SetOdrGyro(config->Odr);
+    SENSOR_SetFullscaleGyro(config->Fscale);
+    SENSOR_SetFifoFormats();
+}
+
+
+bool APPL_SENSOR_TakeMotionSummary(uint16_t *rms, uint16_t *peak)
+{
+    uint32_t fullscale = accFscales[profile.AccFscale];
+    uint32_t value;
+
+    if (motion.Samples == 0) {
+        return false;
+    }
+
+    /* The raw values use the full 16 bits for the full-scale. */
+    value = SENSOR_Sqrt(motion.SumSquares / motion.Samples) * fullscale * 1000 >> 15;
+    *rms  = (value < UINT16_MAX) ? value : (UINT16_MAX - 1);
+    value = SENSOR_Sqrt(motion.PeakSquare) * fullscale * 1000 >> 15;
+    *peak = (value < UINT16_MAX) ? value : (UINT16_MAX - 1);
+
+    memset(&motion, 0, sizeof(motion));
+    return true;
+}
+
+
+/***************************************************************************//**
+ * @brief Saves the sensor profile to the key-value store.
+ *
+ * The store does not write an unchanged profile again.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void SENSOR_SaveProfile(void)
+{
+    uint32_t err;
+
+    err = TXW51_KVSTORE_Set(APPL_KVSTORE_KEY_SENSOR_PROFILE,
+                            (uint8_t *)&profile,
+                            sizeof(profile));
+    if (err != ERR_NONE) {
+        TXW51_LOG_WARNING("[LSM330 Sensor] Could not save sensor profile.");
+    }
+}
+
+
+void APPL_SENSOR_StopToMeasure(void)
+{
+    char outputBuffer[64];
+
+    SENSOR_StopAcc();
+    SENSOR_StopGyro();
+
+    if ((accStream.Overruns > 0) || (gyroStream.Overruns > 0)) {
+        snprintf(outputBuffer, sizeof(outputBuffer),
+                 "[LSM330 Sensor] FIFO overruns: acc %lu, gyro %lu",
+                 (unsigned long)accStream.Overruns,
+                 (unsigned long)gyroStream.Overruns);
+        TXW51_LOG_WARNING(outputBuffer);
+    }
+}
 
-    TXW51_LSM330_ACC_SetOdr(TXW51_LSM330_ACC_ODR_OFF);
-    TXW51_LSM330_GYRO_SetOdr(TXW51_LSM330_GYRO_ODR_95);
 
-    struct TXW51_LSM330_ACC_Interrupts accInterruptConfig = {
+/***************************************************************************//**
+ * @brief Selects the interrupt of the accelerometer that starts a drain.
+ *
+ * INT2_A always signals the motion of the standby.
+ *
+ * @param[in] isDataReady True to interrupt with every new sample, false to
+ *                        interrupt at the watermark of the FIFO.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void SENSOR_ConfigAccInterrupts(bool isDataReady)
+{
+    struct TXW51_LSM330_ACC_Interrupts interruptConfig = {
         .Int1A_Enable    = true,
-        .Int1A_DataReady = false,
+        .Int1A_DataReady = isDataReady,
         .Int1A_Empty     = false,
-        .Int1A_Watermark = true,
+        .Int1A_Watermark = !isDataReady,
         .Int1A_Overrun   = false,
         .Int2A_Enable    = true
     };
-    TXW51_LSM330_ACC_ConfigInterrupts(&accInterruptConfig);
+    TXW51_LSM330_ACC_ConfigInterrupts(&interruptConfig);
+    accStream.IsDataReady = isDataReady;
+}
+
 
-    struct TXW51_LSM330_GYRO_Interrupts gyroInterruptConfig = {
+/***************************************************************************//**
+ * @brief Selects the interrupt of the gyroscope that starts a drain.
+ *
+ * @param[in] isDataReady True to interrupt with every new sample, false to
+ *                        interrupt at the watermark of the FIFO.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void SENSOR_ConfigGyroInterrupts(bool isDataReady)
+{
+    struct TXW51_LSM330_GYRO_Interrupts interruptConfig = {
         .Int1G_Enable    = false,
         .Int2G_Enable    = true,
-        .Int2G_DataReady = false,
+        .Int2G_DataReady = isDataReady,
         .Int2G_Empty     = false,
-        .Int2G_Watermark = true,
+        .Int2G_Watermark = !isDataReady,
         .Int2G_Overrun   = false,
     };
-    TXW51_LSM330_GYRO_ConfigInterrupts(&gyroInterruptConfig);
+    TXW51_LSM330_GYRO_ConfigInterrupts(&interruptConfig);
+    gyroStream.IsDataReady = isDataReady;
 }
 
 
-void APPL_SENSOR_StartToMeasure(void)
+/***************************************************************************//**
+ * @brief Resets the FIFO drain of a sensor before its measurement starts.
+ *
+ * The latency starts at a value that results in the watermark
+ * APPL_SENSOR_VALUES_PER_FIFO_BLOCK.
+ *
+ * @param[out] stream The state of the drain.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void SENSOR_ResetStream(struct SENSOR_Stream *stream)
 {
-    if (isAccEnabled) {
-        SENSOR_StartAcc();
-    }
-    if (isGyroEnabled) {
-        SENSOR_StartGyro();
-    }
+    stream->Watermark = APPL_SENSOR_VALUES_PER_FIFO_BLOCK;
+    stream->Latency   = (SENSOR_FIFO_SIZE - SENSOR_LATENCY_MARGIN - APPL_SENSOR_VALUES_PER_FIFO_BLOCK) / 2;
+    stream->Overruns  = 0;
+    stream->IsDeferred = false;
 }
 
 
-void APPL_SENSOR_StopToMeasure(void)
+/***************************************************************************//**
+ * @brief Converts an axes mask of the profile for the LSM330 driver.
+ *
+ * @param[in] axes The axes (enum TXW51_SERV_MEASURE_DataPackageAxisType).
+ *
+ * @return The axis configuration.
+ ******************************************************************************/
+static struct TXW51_LSM330_Axis SENSOR_GetAxis(uint8_t axes)
 {
-    SENSOR_StopAcc();
-    SENSOR_StopGyro();
+    struct TXW51_LSM330_Axis axis = {
+        .X_Enable = (axes & 0x01) != 0,
+        .Y_Enable = (axes & 0x02) != 0,
+        .Z_Enable = (axes & 0x04) != 0
+    };
+    return axis;
+}
+
+
+/***************************************************************************//**
+ * @brief Updates the drain latency and computes the watermark for it.
+ *
+ * Twice the peak latency is kept free in the sensor FIFO, so an interrupt
+ * that waits longer than usual does not lead to an overrun. While the drains
+ * are aligned to the connection events, the samples of one more connection
+ * interval are kept free, so the drain can wait for the end of the next
+ * event. This wait is planned and not counted as latency. At low ODRs, the
+ * watermark is lowered so the samples do not wait longer than
+ * SENSOR_MAX_DRAIN_PERIOD_MS.
+ *
+ * @param[in,out] stream    The state of the drain.
+ * @param[in]     count     The number of samples found in the sensor FIFO.
+ * @param[in]     isOverrun True if the sensor FIFO was full.
+ * @param[in]     odr       The current ODR of the sensor in Hz.
+ *
+ * @return The new watermark.
+ ******************************************************************************/
+static uint8_t SENSOR_TuneWatermark(struct SENSOR_Stream *stream,
+                                    uint32_t count,
+                                    bool isOverrun,
+                                    uint16_t odr)
+{
+    uint32_t latency = 0;
+    uint32_t deferred = 0;
+    uint32_t reserved;
+    uint32_t watermark;
+
+    if (stream->IsDeferred) {
+        deferred = SENSOR_GetConnIntervalSamples(odr);
+        stream->IsDeferred = false;
+    }
+
+    if (isOverrun) {
+        latency = SENSOR_FIFO_SIZE;
+    } else if (count > stream->Watermark + deferred) {
+        latency = count - stream->Watermark - deferred;
+    }
+
+    if (latency >= stream->Latency) {
+        stream->Latency = latency;
+    } else {
+        stream->Latency -= (stream->Latency - latency + SENSOR_LATENCY_DECAY - 1) / SENSOR_LATENCY_DECAY;
+    }
+
+    reserved = 2 * stream->Latency + SENSOR_LATENCY_MARGIN + SENSOR_GetConnIntervalSamples(odr);
+    watermark = (reserved < SENSOR_FIFO_SIZE) ? SENSOR_FIFO_SIZE - reserved : 0;
+
+    if (watermark > (uint32_t)odr * SENSOR_MAX_DRAIN_PERIOD_MS / 1000) {
+        watermark = (uint32_t)odr * SENSOR_MAX_DRAIN_PERIOD_MS / 1000;
+    }
+    if (watermark < SENSOR_MIN_WATERMARK) {
+        watermark = SENSOR_MIN_WATERMARK;
+    }
+    if (watermark > SENSOR_FIFO_SIZE - 1) {
+        watermark = SENSOR_FIFO_SIZE - 1;
+    }
+    return watermark;
 }
 
 
 /***************************************************************************//**
  * @brief Puts the accelerometer into measurement mode.
  *
- * This sets the FIFO of the accelerometer on the LSM330 to stream mode.
+ * This sets the FIFO of the accelerometer on the LSM330 to stream mode. In the
+ * low-latency mode, the data-ready interrupt starts the drain instead of the
+ * watermark, except for a motion capture. A running measurement or capture
+ * gets drained first, so it can be restarted in the other mode.
  *
  * @return Nothing.
  ******************************************************************************/
 static void SENSOR_StartAcc(void)
 {
+    bool isDataReady = (profile.StreamMode == APPL_SENSOR_MODE_LOW_LATENCY) && !isCapturing;
+    struct TXW51_LSM330_Axis axis = SENSOR_GetAxis(isCapturing ? APPL_SENSOR_ALL_AXES : profile.AccAxes);
+    uint8_t sample[6];
+
+    if (accStream.IsStarted && (isDataReady || accStream.IsDataReady)) {
+        SENSOR_ACC_ReadData(NULL, 0);
+    }
+    SENSOR_ResetStream(&accStream);
+    if ((profile.AccWatermark != 0) && !isDataReady) {
+        accStream.Watermark = profile.AccWatermark;
+    }
+    TXW51_LSM330_ACC_SetActiveAxis(&axis);
+
+    if (isDataReady) {
+        SENSOR_StopAcc();
+        SENSOR_ConfigAccInterrupts(true);
+        /* A data-ready signal that is still pending would never show an edge
+         * again. Reading the output registers in bypass mode clears it. */
+        TXW51_LSM330_ACC_GetDataBlock(sample, 1);
+    } else if (accStream.IsDataReady) {
+        SENSOR_ConfigAccInterrupts(false);
+    }
+
     struct TXW51_LSM330_ACC_FifoInit fifoConfig = {
         .FifoEnable      = true,
         .Mode            = TXW51_LSM330_ACC_FIFO_MODE_STREAM,
-        .Watermark       = APPL_SENSOR_VALUES_PER_FIFO_BLOCK,
-        .WatermarkEnable = true
+        .Watermark       = accStream.Watermark,
+        .WatermarkEnable = !isDataReady
     };
     TXW51_LSM330_ACC_ConfigFifo(&fifoConfig);
+    accStream.IsStarted = true;
 }
 
 
 /***************************************************************************//**
  * @brief Puts the accelerometer into non-measurement mode.
  *
- * This sets the FIFO of the accelerometer on the LSM330 to bypass mode.
+ * This sets the FIFO of the accelerometer on the LSM330 to bypass mode and
+ * switches back to the watermark interrupt.
  *
  * @return Nothing.
  ******************************************************************************/
@@ -171,32 +621,61 @@ static void SENSOR_StopAcc(void)
         .WatermarkEnable = false
     };
     TXW51_LSM330_ACC_ConfigFifo(&fifoConfig);
+    accStream.IsStarted = false;
+
+    if (accStream.IsDataReady) {
+        SENSOR_ConfigAccInterrupts(false);
+    }
 }
 
 
 /***************************************************************************//**
  * @brief Puts the gyroscope into measurement mode.
  *
- * This sets the FIFO of the gyroscope on the LSM330 to stream mode.
+ * This sets the FIFO of the gyroscope on the LSM330 to stream mode. Works like
+ * SENSOR_StartAcc().
  *
  * @return Nothing.
  ******************************************************************************/
 static void SENSOR_StartGyro(void)
 {
+    bool isDataReady = (profile.StreamMode == APPL_SENSOR_MODE_LOW_LATENCY);
+    struct TXW51_LSM330_Axis axis = SENSOR_GetAxis(profile.GyroAxes);
+    uint8_t sample[6];
+
+    if (gyroStream.IsStarted && (isDataReady || gyroStream.IsDataReady)) {
+        SENSOR_GYRO_ReadData(NULL, 0);
+    }
+    SENSOR_ResetStream(&gyroStream);
+    if ((profile.GyroWatermark != 0) && !isDataReady) {
+        gyroStream.Watermark = profile.GyroWatermark;
+    }
+    TXW51_LSM330_GYRO_SetActiveAxis(&axis);
+
+    if (isDataReady) {
+        SENSOR_StopGyro();
+        SENSOR_ConfigGyroInterrupts(true);
+        TXW51_LSM330_GYRO_GetDataBlock(sample, 1);
+    } else if (gyroStream.IsDataReady) {
+        SENSOR_ConfigGyroInterrupts(false);
+    }
+
     struct TXW51_LSM330_GYRO_FifoInit gyroFifoConfig = {
         .FifoEnable      = true,
         .Mode            = TXW51_LSM330_GYRO_FIFO_MODE_STREAM,
-        .Watermark       = APPL_SENSOR_VALUES_PER_FIFO_BLOCK,
-        .WatermarkEnable = true
+        .Watermark       = gyroStream.Watermark,
+        .WatermarkEnable = !isDataReady
     };
     TXW51_LSM330_GYRO_ConfigFifo(&gyroFifoConfig);
+    gyroStream.IsStarted = true;
 }
 
 
 /***************************************************************************//**
  * @brief Puts the gyroscope into non-measurement mode.
  *
- * This sets the FIFO of the gyroscope on the LSM330 to bypass mode.
+ * This sets the FIFO of the gyroscope on the LSM330 to bypass mode and
+ * switches back to the watermark interrupt.
  *
  * @return Nothing.
  ******************************************************************************/
@@ -209,40 +688,377 @@ static void SENSOR_StopGyro(void)
         .WatermarkEnable = false
     };
     TXW51_LSM330_GYRO_ConfigFifo(&gyroFifoConfig);
+    gyroStream.IsStarted = false;
+
+    if (gyroStream.IsDataReady) {
+        SENSOR_ConfigGyroInterrupts(false);
+    }
 }
 
 
 void APPL_SENSOR_SetupMotionWakeup(void)
 {
+    struct TXW51_LSM330_Axis axis = SENSOR_GetAxis(APPL_SENSOR_ALL_AXES);
+
+    TXW51_LSM330_ACC_SetActiveAxis(&axis);
     TXW51_LSM330_ACC_SetOdr(TXW51_LSM330_ACC_ODR_3_125);
     TXW51_LSM330_EnableGyro(false);
     TXW51_LSM330_SetMotionWakeup();
 }
 
 
+uint32_t APPL_SENSOR_EnterStandby(void)
+{
+    uint32_t err;
+
+    struct TXW51_LSM330_ACC_FifoInit fifoConfig = {
+        .FifoEnable      = true,
+        .Mode            = TXW51_LSM330_ACC_FIFO_MODE_STREAM_TO_FIFO,
+        .Watermark       = 0,
+        .WatermarkEnable = false
+    };
+    struct TXW51_LSM330_Axis axis = SENSOR_GetAxis(APPL_SENSOR_ALL_AXES);
+
+    isCapturing = false;
+    if (accStream.IsStarted) {
+        SENSOR_StopAcc();
+    }
+    SENSOR_StopGyro();
+    TXW51_LSM330_EnableGyro(false);
+
+    /* The motion detection and the pre-roll use all axes. */
+    err = TXW51_LSM330_ACC_SetActiveAxis(&axis);
+    if (err != ERR_NONE) {
+        return err;
+    }
+
+    err = TXW51_LSM330_ACC_SetOdr(SENSOR_STANDBY_ODR);
+    if (err != ERR_NONE) {
+        return err;
+    }
+
+    /* The FIFO switches from stream to FIFO mode with the interrupt of the
+     * state machine and keeps the samples before the motion. */
+    err = TXW51_LSM330_ACC_ConfigFifo(&fifoConfig);
+    if (err != ERR_NONE) {
+        return err;
+    }
+
+    err = TXW51_LSM330_SetMotionWakeup();
+    if (err != ERR_NONE) {
+        return err;
+    }
+
+    isStandby = true;
+    TXW51_GPIOTE_SetPortInterrupt();
+
+    TXW51_LOG_DEBUG("[LSM330 Sensor] Standby entered.");
+    return ERR_NONE;
+}
+
+
+void APPL_SENSOR_LeaveStandby(void)
+{
+    union TXW51_LSM330_FIFO_SRC_REG_A status;
+    uint32_t count;
+
+    if (!isStandby) {
+        return;
+    }
+    isStandby = false;
+
+    TXW51_GPIOTE_ClearPortInterrupt();
+    TXW51_LSM330_ClearMotionWakeup();
+
+    if (TXW51_LSM330_ACC_GetFifoStatus(&status) == ERR_NONE) {
+        count = status.Bit.OVRN_FIFO ? TXW51_LSM330_ACC_FIFO_SIZE : status.Bit.FSS;
+        if (count > 0) {
+            SENSOR_ReadSamples(APPL_FIFO_BUFFER_ACC, count, false);
+            gIsNewAccDataAvailable = true;
+        }
+    }
+
+    /* The samples after the motion are read with the watermark interrupt,
+     * until the measurement gets started or the FIFO buffer is full. */
+    isCapturing = true;
+    SENSOR_StartAcc();
+
+    TXW51_LOG_INFO("[LSM330 Sensor] Motion detected. Pre-roll captured.");
+}
+
+
 void APPL_SENSOR_HandleInterrupt(int32_t channel)
 {
     switch (channel) {
         case TXW51_LSM330_GPIO_INT1_ACC_CHANNEL:
-            app_sched_event_put(NULL, 0, SENSOR_ACC_ReadData);
+            SENSOR_RequestDrain(SENSOR_DRAIN_ACC, &accStream, accOdrs[TXW51_LSM330_ACC_GetOdr()]);
+            break;
+
+        case TXW51_LSM330_GPIO_INT2_ACC_CHANNEL:
+            if (isStandby) {
+                gIsMotionDetected = true;
+            }
             break;
 
         case TXW51_LSM330_GPIO_INT2_GYRO_CHANNEL:
-            app_sched_event_put(NULL, 0, SENSOR_GYRO_ReadData);
+            SENSOR_RequestDrain(SENSOR_DRAIN_GYRO, &gyroStream, gyroOdrs[TXW51_LSM330_GYRO_GetOdr()]);
             break;
     }
 }
 
 
+void APPL_SENSOR_HandleRadioNotification(bool isRadioActive)
+{
+    uint8_t drains;
+
+    if (isRadioActive) {
+        return;
+    }
+
+    /* The watermark interrupt has a higher priority. */
+    CRITICAL_REGION_ENTER();
+    drains = pendingDrains;
+    pendingDrains = 0;
+    CRITICAL_REGION_EXIT();
+
+    SENSOR_ScheduleDrains(drains);
+}
+
+
+void APPL_SENSOR_AlignDrains(uint16_t interval)
+{
+    uint8_t drains;
+
+    CRITICAL_REGION_ENTER();
+    connInterval = interval;
+    drains = pendingDrains;
+    pendingDrains = 0;
+    CRITICAL_REGION_EXIT();
+
+    SENSOR_ScheduleDrains(drains);
+}
+
+
+/***************************************************************************//**
+ * @brief Requests the drain of a sensor FIFO after a watermark or data-ready
+ *        interrupt.
+ *
+ * While the drains are aligned, the drain waits for the end of the next
+ * connection event, so the SPI transfers and the packets are done before the
+ * following one. It runs immediately if the sensor FIFO could overrun until
+ * then and in the low-latency mode.
+ *
+ * @param[in]     drain  SENSOR_DRAIN_ACC or SENSOR_DRAIN_GYRO.
+ * @param[in,out] stream The state of the drain.
+ * @param[in]     odr    The current ODR of the sensor in Hz.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void SENSOR_RequestDrain(uint8_t drain, struct SENSOR_Stream *stream, uint16_t odr)
+{
+    /* Samples that still fit into the sensor FIFO above its margin. */
+    uint32_t headroom = (stream->Watermark < SENSOR_FIFO_SIZE - SENSOR_LATENCY_MARGIN) ?
+                        SENSOR_FIFO_SIZE - SENSOR_LATENCY_MARGIN - stream->Watermark : 0;
+
+    if ((connInterval > 0) && !stream->IsDataReady &&
+        (headroom >= SENSOR_GetConnIntervalSamples(odr))) {
+        stream->IsDeferred = true;
+        pendingDrains |= drain;
+        return;
+    }
+    SENSOR_ScheduleDrains(drain);
+}
+
+
+/***************************************************************************//**
+ * @brief Computes the samples a sensor generates between two connection
+ *        events.
+ *
+ * @param[in] odr The current ODR of the sensor in Hz.
+ *
+ * @return The samples rounded up, 0 if the drains are not aligned.
+ ******************************************************************************/
+static uint32_t SENSOR_GetConnIntervalSamples(uint16_t odr)
+{
+    if (connInterval == 0) {
+        return 0;
+    }
+    return (uint32_t)connInterval * odr / SENSOR_CONN_INTERVALS_PER_S + 1;
+}
+
+
+/***************************************************************************//**
+ * @brief Puts the drains of the sensor FIFOs into the scheduler.
+ *
+ * @param[in] drains SENSOR_DRAIN_* of the sensors to drain.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void SENSOR_ScheduleDrains(uint8_t drains)
+{
+    if (drains & SENSOR_DRAIN_ACC) {
+        app_sched_event_put(NULL, 0, SENSOR_ACC_ReadData);
+    }
+    if (drains & SENSOR_DRAIN_GYRO) {
+        app_sched_event_put(NULL, 0, SENSOR_GYRO_ReadData);
+    }
+}
+
+
+/***************************************************************************//**
+ * @brief Sets the packet formats of the FIFO buffers to the profile.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void SENSOR_SetFifoFormats(void)
+{
+    struct APPL_FIFO_Format format = {
+        .SampleSize = SENSOR_SAMPLE_SIZE,
+        .Axis       = profile.AccAxes,
+        .AccOrGyro  = TXW51_SERV_MEASURE_DATA_SENSOR_ACC,
+        .IsDriver   = false,
+        .Rate       = APPL_SENSOR_GetAccRate()
+    };
+    APPL_FIFO_SetFormat(APPL_FIFO_BUFFER_ACC, &format);
+
+    format.Axis      = profile.GyroAxes;
+    format.AccOrGyro = TXW51_SERV_MEASURE_DATA_SENSOR_GYRO;
+    format.Rate      = APPL_SENSOR_GetGyroRate();
+    APPL_FIFO_SetFormat(APPL_FIFO_BUFFER_GYRO, &format);
+}
+
+
+/***************************************************************************//**
+ * @brief Reads samples from the FIFO of a sensor straight into the FIFO
+ *        buffer.
+ *
+ * The samples are read with one transfer per packet straight into the slots
+ * of the FIFO buffer, so they are not copied on their way to the
+ * notification. If not all samples fit, they are read anyway to empty the
+ * sensor FIFO and dropped together, like with APPL_FIFO_Put().
+ *
+ * @param[in] bufferType          APPL_FIFO_BUFFER_ACC or APPL_FIFO_BUFFER_GYRO.
+ * @param[in] count               Number of samples to read.
+ * @param[in] isMotionAccumulated Add the samples to the motion summary.
+ *
+ * @return ERR_NONE if no error occurred.
+ *         ERR_LSM330_READ_FAILED if reading from the sensor failed, a
+ *         discontinuity has been marked.
+ *         ERR_FIFO_PUT_FAILED if samples have been dropped.
+ ******************************************************************************/
+static uint32_t SENSOR_ReadSamples(enum appl_fifo_type bufferType,
+                                   uint32_t count,
+                                   bool isMotionAccumulated)
+{
+    uint32_t (*readFifo)(uint8_t *buffer, uint32_t numberOfSamples) =
+        (bufferType == APPL_FIFO_BUFFER_ACC) ? TXW51_LSM330_ACC_ReadFifo : TXW51_LSM330_GYRO_ReadFifo;
+    uint8_t sample[1 + SENSOR_SAMPLE_SIZE];
+    uint8_t *samples;
+    uint32_t n;
+
+    if (count > APPL_FIFO_GetFree(bufferType)) {
+        /* The first byte of the sample is used by the transfer. */
+        for (n = 0; n < count; n++) {
+            if (readFifo(&sample[1], 1) != ERR_NONE) {
+                APPL_FIFO_PutDiscontinuity(bufferType);
+                return ERR_LSM330_READ_FAILED;
+            }
+            if (isMotionAccumulated) {
+                SENSOR_AccumulateMotion(&sample[1], 1);
+            }
+        }
+        return APPL_FIFO_Drop(bufferType, count);
+    }
+
+    while (count > 0) {
+        samples = APPL_FIFO_Reserve(bufferType, &n);
+        if (n > count) {
+            n = count;
+        }
+
+        if (readFifo(samples, n) != ERR_NONE) {
+            APPL_FIFO_PutDiscontinuity(bufferType);
+            return ERR_LSM330_READ_FAILED;
+        }
+        if (isMotionAccumulated) {
+            SENSOR_AccumulateMotion(samples, n);
+        }
+        APPL_FIFO_Commit(bufferType, n);
+        count -= n;
+    }
+    return ERR_NONE;
+}
+
+
+/***************************************************************************//**
+ * @brief Adds the magnitudes of the acceleration samples to the summary.
+ *
+ * @param[in] buffer The samples as read from the FIFO, 3 axes of 16 bits.
+ * @param[in] count  Number of samples.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void SENSOR_AccumulateMotion(const uint8_t *buffer, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t square = 0;
+
+        for (uint32_t axis = 0; axis < 3; axis++) {
+            int32_t value = (int16_t)(buffer[0] | (buffer[1] << 8));
+            square += value * value;
+            buffer += 2;
+        }
+
+        motion.SumSquares += square;
+        if (square > motion.PeakSquare) {
+            motion.PeakSquare = square;
+        }
+    }
+    motion.Samples += count;
+}
+
+
+/***************************************************************************//**
+ * @brief Calculates the integer square root.
+ *
+ * @param[in] value The radicand.
+ *
+ * @return The square root, rounded down.
+ ******************************************************************************/
+static uint32_t SENSOR_Sqrt(uint64_t value)
+{
+    uint64_t root = 0;
+    uint64_t bit = 1ULL << 62;
+
+    while (bit > value) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)root;
+}
+
+
 /***************************************************************************//**
  * @brief Reads all values from the LSM330 accelerometer and puts them into the
  *        FIFO buffer.
  *
- * Reads all values of all axes from the FIFO on the LSM330 sensor until the
- * configured watermark. It then saves the values into the application FIFO.
+ * Reads the fill level of the FIFO on the LSM330 sensor first and then all
+ * samples in it, including the ones that arrived since the watermark
+ * interrupt. A full FIFO is counted as an overrun and marked as a
+ * discontinuity in the FIFO buffer, because samples may have been lost.
+ * Afterwards, the watermark gets tuned to the drain latency, unless the
+ * data-ready interrupt starts the drain.
  *
- * This function should be called when the sensor generated a watermark
- * interrupt.
+ * This function should be called when the sensor generated a watermark or
+ * data-ready interrupt.
  *
  * @param[in] data Not used.
  * @param[in] size Not used.
@@ -251,12 +1067,52 @@ void APPL_SENSOR_HandleInterrupt(int32_t channel)
  ******************************************************************************/
 static void SENSOR_ACC_ReadData(void *data, uint16_t size)
 {
-    uint8_t buffer[APPL_SENSOR_VALUES_PER_FIFO_BLOCK * 6];
+    union TXW51_LSM330_FIFO_SRC_REG_A status;
+    uint32_t count;
+    uint8_t watermark;
+
+    uint32_t err;
+
+    err = TXW51_LSM330_ACC_GetFifoStatus(&status);
+    if (err != ERR_NONE) {
+        return;
+    }
+
+    count = status.Bit.OVRN_FIFO ? TXW51_LSM330_ACC_FIFO_SIZE : status.Bit.FSS;
+    if (count == 0) {
+        return;
+    }
 
-    TXW51_LSM330_ACC_GetDataBlock(buffer, APPL_SENSOR_VALUES_PER_FIFO_BLOCK);
-    APPL_FIFO_Put(APPL_FIFO_BUFFER_ACC, buffer,
-                  APPL_SENSOR_VALUES_PER_FIFO_BLOCK * 6);
+    if (status.Bit.OVRN_FIFO) {
+        accStream.Overruns++;
+        APPL_BROADCAST_CountEvent(APPL_BROADCAST_EVENT_OVERRUN);
+        APPL_FIFO_PutDiscontinuity(APPL_FIFO_BUFFER_ACC);
+    }
+
+    err = SENSOR_ReadSamples(APPL_FIFO_BUFFER_ACC, count, true);
     gIsNewAccDataAvailable = true;
+    if (err == ERR_LSM330_READ_FAILED) {
+        return;
+    }
+
+    if ((err != ERR_NONE) && isCapturing) {
+        /* Keep the start of the motion instead of overwriting it. */
+        SENSOR_StopAcc();
+        TXW51_LOG_INFO("[LSM330 Sensor] Motion capture stopped. FIFO buffer full.");
+        return;
+    }
+    if (accStream.IsDataReady || (profile.AccWatermark != 0)) {
+        return;
+    }
+
+    watermark = SENSOR_TuneWatermark(&accStream,
+                                     count,
+                                     status.Bit.OVRN_FIFO,
+                                     accOdrs[TXW51_LSM330_ACC_GetOdr()]);
+    if ((watermark != accStream.Watermark) &&
+        (TXW51_LSM330_ACC_SetWatermark(watermark) == ERR_NONE)) {
+        accStream.Watermark = watermark;
+    }
 }
 
 
@@ -264,11 +1120,10 @@ static void SENSOR_ACC_ReadData(void *data, uint16_t size)
  * @brief Reads all values from the LSM330 gyroscope and puts them into the
  *        FIFO buffer.
  *
- * Reads all values of all axes from the FIFO on the LSM330 sensor until the
- * configured watermark. It then saves the values into the application FIFO.
+ * Works like SENSOR_ACC_ReadData().
  *
- * This function should be called when the sensor generated a watermark
- * interrupt.
+ * This function should be called when the sensor generated a watermark or
+ * data-ready interrupt.
  *
  * @param[in] data Not used.
  * @param[in] size Not used.
@@ -277,12 +1132,43 @@ static void SENSOR_ACC_ReadData(void *data, uint16_t size)
  ******************************************************************************/
 static void SENSOR_GYRO_ReadData(void *data, uint16_t size)
 {
-    uint8_t buffer[APPL_SENSOR_VALUES_PER_FIFO_BLOCK * 6];
+    union TXW51_LSM330_FIFO_SRC_REG_G status;
+    uint32_t count;
+    uint8_t watermark;
+
+    uint32_t err;
+
+    err = TXW51_LSM330_GYRO_GetFifoStatus(&status);
+    if (err != ERR_NONE) {
+        return;
+    }
+
+    count = status.Bit.OVRN ? TXW51_LSM330_GYRO_FIFO_SIZE : status.Bit.FSS;
+    if (count == 0) {
+        return;
+    }
+
+    if (status.Bit.OVRN) {
+        gyroStream.Overruns++;
+        APPL_BROADCAST_CountEvent(APPL_BROADCAST_EVENT_OVERRUN);
+        APPL_FIFO_PutDiscontinuity(APPL_FIFO_BUFFER_GYRO);
+    }
 
-    TXW51_LSM330_GYRO_GetDataBlock(buffer, APPL_SENSOR_VALUES_PER_FIFO_BLOCK);
-    APPL_FIFO_Put(APPL_FIFO_BUFFER_GYRO, buffer,
-                  APPL_SENSOR_VALUES_PER_FIFO_BLOCK * 6);
+    err = SENSOR_ReadSamples(APPL_FIFO_BUFFER_GYRO, count, false);
     gIsNewGyroDataAvailable = true;
+    if ((err == ERR_LSM330_READ_FAILED) ||
+        gyroStream.IsDataReady || (profile.GyroWatermark != 0)) {
+        return;
+    }
+
+    watermark = SENSOR_TuneWatermark(&gyroStream,
+                                     count,
+                                     status.Bit.OVRN,
+                                     gyroOdrs[TXW51_LSM330_GYRO_GetOdr()]);
+    if ((watermark != gyroStream.Watermark) &&
+        (TXW51_LSM330_GYRO_SetWatermark(watermark) == ERR_NONE)) {
+        gyroStream.Watermark = watermark;
+    }
 }
 
 
@@ -405,6 +1291,14 @@ uint32_t APPL_SENSOR_InitService(struct TXW51_SERV_LSM330_Handle *serviceHandle)
 
     struct TXW51_SERV_LSM330_Init init;
     init.EventHandler = SENSOR_BleEventHandler;
+    init.AccEnable    = profile.AccEnable;
+    init.GyroEnable   = profile.GyroEnable;
+    init.AccFscale    = profile.AccFscale;
+    init.GyroFscale   = profile.GyroFscale;
+    init.AccOdr       = profile.AccOdr;
+    init.GyroOdr      = profile.GyroOdr;
+    init.AutoStart    = profile.AutoStart;
+    init.StreamMode   = profile.StreamMode;
 
     err = TXW51_SERV_LSM330_Init(serviceHandle, &init);
     if (err != ERR_NONE) {
@@ -430,9 +1324,11 @@ static void SENSOR_BleEventHandler(struct TXW51_SERV_LSM330_Handle *handle,
     switch (evt->EventType) {
         case TXW51_SERV_LSM330_EVT_ACC_EN:
             SENSOR_EnableAcc(*evt->Value);
+            SENSOR_SetFifoFormats();
             break;
         case TXW51_SERV_LSM330_EVT_GYRO_EN:
             SENSOR_EnableGyro(*evt->Value);
+            SENSOR_SetFifoFormats();
             break;
         case TXW51_SERV_LSM330_EVT_TEMP_SAMPLE:
             SENSOR_GetTemperature(evt->Value);
@@ -445,9 +1341,11 @@ static void SENSOR_BleEventHandler(struct TXW51_SERV_LSM330_Handle *handle,
             break;
         case TXW51_SERV_LSM330_EVT_ACC_ODR:
             SENSOR_SetOdrAcc(*evt->Value);
+            SENSOR_SetFifoFormats();
             break;
         case TXW51_SERV_LSM330_EVT_GYRO_ODR:
             SENSOR_SetOdrGyro(*evt->Value);
+            SENSOR_SetFifoFormats();
             break;
         case TXW51_SERV_LSM330_EVT_TRIGGER_VAL:
             TXW51_LOG_INFO("[LSM330 Sensor] Trigger value not yet implemented.");
@@ -455,6 +1353,12 @@ static void SENSOR_BleEventHandler(struct TXW51_SERV_LSM330_Handle *handle,
         case TXW51_SERV_LSM330_EVT_TRIGGER_AXIS:
             TXW51_LOG_INFO("[LSM330 Sensor] Trigger axis not yet implemented.");
             break;
+        case TXW51_SERV_LSM330_EVT_AUTO_START:
+            SENSOR_SetAutoStart(*evt->Value);
+            break;
+        case TXW51_SERV_LSM330_EVT_STREAM_MODE:
+            APPL_SENSOR_SetStreamMode(*evt->Value);
+            break;
         default:
             break;
     }
@@ -473,10 +1377,10 @@ static void SENSOR_BleEventHandler(struct TXW51_SERV_LSM330_Handle *handle,
 static void SENSOR_EnableAcc(uint8_t enable)
 {
     if (enable) {
-        isAccEnabled = true;
+        profile.AccEnable = true;
         TXW51_LOG_DEBUG("[LSM330 Sensor] Accelerometer enabled.");
     } else {
-        isAccEnabled = false;
+        profile.AccEnable = false;
         TXW51_LOG_DEBUG("[LSM330 Sensor] Accelerometer disabled.");
     }
 }
@@ -495,11 +1399,11 @@ static void SENSOR_EnableGyro(uint8_t enable)
 {
     if (enable) {
         TXW51_LSM330_EnableGyro(true);
-        isGyroEnabled = true;
+        profile.GyroEnable = true;
         TXW51_LOG_DEBUG("[LSM330 Sensor] Gyro enabled.");
     } else {
         TXW51_LSM330_EnableGyro(false);
-        isGyroEnabled = false;
+        profile.GyroEnable = false;
         TXW51_LOG_DEBUG("[LSM330 Sensor] Gyro disabled.");
     }
 }
@@ -538,6 +1442,7 @@ static void SENSOR_SetFullscaleAcc(uint8_t value)
     }
 
     TXW51_LSM330_ACC_SetFullscale(value);
+    profile.AccFscale = value;
     TXW51_LOG_DEBUG("[LSM330 Sensor] Acc: Full-scale set.");
 }
 
@@ -557,6 +1462,7 @@ static void SENSOR_SetFullscaleGyro(uint8_t value)
     }
 
     TXW51_LSM330_GYRO_SetFullscale(value);
+    profile.GyroFscale = value;
     TXW51_LOG_DEBUG("[LSM330 Sensor] Gyro: Full-scale set.");
 }
 
@@ -576,6 +1482,7 @@ static void SENSOR_SetOdrAcc(uint8_t value)
     }
 
     TXW51_LSM330_ACC_SetOdr(value);
+    profile.AccOdr = value;
     TXW51_LOG_DEBUG("[LSM330 Sensor] Acc: ODR set.");
 }
 
@@ -595,6 +1502,47 @@ static void SENSOR_SetOdrGyro(uint8_t value)
     }
 
     TXW51_LSM330_GYRO_SetOdr(value);
+    profile.GyroOdr = value;
     TXW51_LOG_DEBUG("[LSM330 Sensor] Gyro: ODR set.");
 }
 
+
+/***************************************************************************//**
+ * @brief Enables or disables the auto start of the measurement.
+ *
+ * The profile gets saved immediately, so the setting survives a reset
+ * without starting a measurement first.
+ *
+ * @param[in] enable If not 0 -> start the measurement with the data stream.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void SENSOR_SetAutoStart(uint8_t enable)
+{
+    profile.AutoStart = (enable != 0);
+    SENSOR_SaveProfile();
+
+    TXW51_LOG_DEBUG("[LSM330 Sensor] Auto start set.");
+}
+
+
+void APPL_SENSOR_SetStreamMode(uint8_t mode)
+{
+    if (mode > APPL_SENSOR_MODE_LOW_LATENCY) {
+        TXW51_LOG_WARNING("[LSM330 Sensor] Could not set stream mode. Wrong value.");
+        return;
+    }
+    if (mode == profile.StreamMode) {
+        return;
+    }
+
+    profile.StreamMode = mode;
+    if (accStream.IsStarted && !isCapturing) {
+        SENSOR_StartAcc();
+    }
+    if (gyroStream.IsStarted) {
+        SENSOR_StartGyro();
+    }
+
+    TXW51_LOG_DEBUG("[LSM330 Sensor] Stream mode set.");
+}
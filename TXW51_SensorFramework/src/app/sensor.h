@@ -17,32 +17,75 @@
 #define TXW51_APPLICATION_SENSOR_H_
 
 /*----- Header-Files ---------------------------------------------------------*/
+#include <stdbool.h>
 #include <stdint.h>
 
 #include "txw51_framework/ble/service_lsm330.h"
 
 /*----- Macros ---------------------------------------------------------------*/
-#define APPL_SENSOR_VALUES_PER_FIFO_BLOCK     ( 20 )    /**< The level of the sensor FIFO until a watermark interrupt gets generated. */
+#define APPL_SENSOR_VALUES_PER_FIFO_BLOCK     ( 20 )    /**< The initial level of the sensor FIFO for the watermark interrupt, it gets tuned while measuring. */
+#define APPL_SENSOR_ALL_AXES                  ( 0x07 )  /**< The X, Y and Z axes, see enum TXW51_SERV_MEASURE_DataPackageAxisType. */
 
 /*----- Data types -----------------------------------------------------------*/
+/**
+ * @brief Modes to read the samples from the LSM330 during a measurement.
+ */
+enum APPL_SENSOR_StreamMode {
+    APPL_SENSOR_MODE_THROUGHPUT  = 0,   /**< The FIFOs are drained at their watermark, with few interrupts and SPI transfers. */
+    APPL_SENSOR_MODE_LOW_LATENCY = 1    /**< Every sample is read at its data-ready interrupt and sent with the next connection event. */
+};
+
+/**
+ * @brief Settings of a sensor that are applied together.
+ */
+struct APPL_SENSOR_Config {
+    uint8_t Axes;       /**< Enabled axes (enum TXW51_SERV_MEASURE_DataPackageAxisType), 0 disables the sensor. */
+    uint8_t Odr;        /**< ODR of the sensor (enum TXW51_LSM330_ACC_Odr or TXW51_LSM330_GYRO_Odr). */
+    uint8_t Fscale;     /**< Full-scale of the sensor (enum TXW51_LSM330_ACC_Fscale or TXW51_LSM330_GYRO_Fscale). */
+    uint8_t Watermark;  /**< Fixed watermark of the sensor FIFO, 0 to tune it to the drain latency. */
+};
 
 /*----- Function prototypes --------------------------------------------------*/
 
 /***************************************************************************//**
  * @brief Initializes the LSM330 sensor module..
  *
+ * The sensor gets configured with the current sensor profile, see
+ * APPL_SENSOR_LoadProfile().
+ *
  * @return Nothing.
  ******************************************************************************/
 extern void APPL_SENSOR_Init(void);
 
+/***************************************************************************//**
+ * @brief Reads the sensor profile from the key-value store.
+ *
+ * The sensor itself is not accessed, so the profile can be loaded before
+ * APPL_SENSOR_Init() and APPL_SENSOR_InitService(). TXW51_KVSTORE_Init() has
+ * to be called before.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+extern void APPL_SENSOR_LoadProfile(void);
+
 /***************************************************************************//**
  * @brief Puts the sensors into measurement mode that have been enabled by the
  * Bluetooth Smart LSM330 service .
  *
+ * The current sensor profile gets saved, so it is restored after a reset.
+ *
  * @return Nothing.
  ******************************************************************************/
 extern void APPL_SENSOR_StartToMeasure(void);
 
+/***************************************************************************//**
+ * @brief Checks if the measurement starts as soon as the data stream gets
+ *        enabled.
+ *
+ * @return True if auto start is enabled in the sensor profile.
+ ******************************************************************************/
+extern bool APPL_SENSOR_IsAutoStartEnabled(void);
+
 /***************************************************************************//**
  * @brief Stops the measurement mode of all sensors.
  *
@@ -50,6 +93,109 @@ extern void APPL_SENSOR_StartToMeasure(void);
  ******************************************************************************/
 extern void APPL_SENSOR_StopToMeasure(void);
 
+/***************************************************************************//**
+ * @brief Gets the sample rate of the accelerometer in the sensor profile.
+ *
+ * @return The sample rate in Hz (rounded up), 0 if the accelerometer is
+ *         disabled.
+ ******************************************************************************/
+extern uint16_t APPL_SENSOR_GetAccRate(void);
+
+/***************************************************************************//**
+ * @brief Gets the sample rate of the gyroscope in the sensor profile.
+ *
+ * @return The sample rate in Hz, 0 if the gyroscope is disabled.
+ ******************************************************************************/
+extern uint16_t APPL_SENSOR_GetGyroRate(void);
+
+/***************************************************************************//**
+ * @brief Checks if the sensor profile selects the low-latency stream mode.
+ *
+ * @return True in APPL_SENSOR_MODE_LOW_LATENCY, false otherwise.
+ ******************************************************************************/
+extern bool APPL_SENSOR_IsLowLatency(void);
+
+/***************************************************************************//**
+ * @brief Gets the enabled axes of the accelerometer in the sensor profile.
+ *
+ * @return The axes (enum TXW51_SERV_MEASURE_DataPackageAxisType).
+ ******************************************************************************/
+extern uint8_t APPL_SENSOR_GetAccAxes(void);
+
+/***************************************************************************//**
+ * @brief Gets the enabled axes of the gyroscope in the sensor profile.
+ *
+ * @return The axes (enum TXW51_SERV_MEASURE_DataPackageAxisType).
+ ******************************************************************************/
+extern uint8_t APPL_SENSOR_GetGyroAxes(void);
+
+/***************************************************************************//**
+ * @brief Gets the settings of the accelerometer in the sensor profile.
+ *
+ * @param[out] config The settings, Axes is 0 if the accelerometer is
+ *                    disabled.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+extern void APPL_SENSOR_GetAccConfig(struct APPL_SENSOR_Config *config);
+
+/***************************************************************************//**
+ * @brief Gets the settings of the gyroscope in the sensor profile.
+ *
+ * @param[out] config The settings, Axes is 0 if the gyroscope is disabled.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+extern void APPL_SENSOR_GetGyroConfig(struct APPL_SENSOR_Config *config);
+
+/***************************************************************************//**
+ * @brief Applies the settings of the accelerometer to the sensor profile.
+ *
+ * The settings have to be checked by the caller. They are used by the next
+ * start of the measurement and saved with the profile then.
+ *
+ * @param[in] config The settings.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+extern void APPL_SENSOR_ConfigureAcc(const struct APPL_SENSOR_Config *config);
+
+/***************************************************************************//**
+ * @brief Applies the settings of the gyroscope to the sensor profile.
+ *
+ * Works like APPL_SENSOR_ConfigureAcc().
+ *
+ * @param[in] config The settings.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+extern void APPL_SENSOR_ConfigureGyro(const struct APPL_SENSOR_Config *config);
+
+/***************************************************************************//**
+ * @brief Selects how the samples are read from the sensor.
+ *
+ * A running measurement continues in the new mode without losing samples.
+ * The mode gets saved with the profile at the next start.
+ *
+ * @param[in] mode The new mode, see enum APPL_SENSOR_StreamMode.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+extern void APPL_SENSOR_SetStreamMode(uint8_t mode);
+
+/***************************************************************************//**
+ * @brief Takes the summary of the acceleration magnitude and starts a new one.
+ *
+ * The summary covers all samples read from the accelerometer since the last
+ * call, during a measurement or a motion capture.
+ *
+ * @param[out] rms  RMS of the magnitude in mg.
+ * @param[out] peak Largest magnitude in mg.
+ *
+ * @return true if samples were summarized, false otherwise.
+ ******************************************************************************/
+extern bool APPL_SENSOR_TakeMotionSummary(uint16_t *rms, uint16_t *peak);
+
 /***************************************************************************//**
  * @brief Reconfigures the LSM330 sensor to generate an interrupt when movement
  *        has been detected.
@@ -58,6 +204,31 @@ extern void APPL_SENSOR_StopToMeasure(void);
  ******************************************************************************/
 extern void APPL_SENSOR_SetupMotionWakeup(void);
 
+/***************************************************************************//**
+ * @brief Puts the sensor into standby, where a motion wakes up the device.
+ *
+ * The gyroscope is turned off and the accelerometer runs with a low ODR. Its
+ * FIFO runs in stream-to-FIFO mode and stops with the motion interrupt, so it
+ * holds the samples from before the motion. The motion sets
+ * gIsMotionDetected, then APPL_SENSOR_LeaveStandby() has to be called.
+ *
+ * @return ERR_NONE if no error occurred.
+ *         ERR_LSM330_READ_FAILED if reading from the sensor failed.
+ *         ERR_LSM330_WRITE_FAILED if writing to the sensor failed.
+ ******************************************************************************/
+extern uint32_t APPL_SENSOR_EnterStandby(void);
+
+/***************************************************************************//**
+ * @brief Leaves the standby after a motion.
+ *
+ * The samples from before the motion are put into the FIFO buffer, followed
+ * by the samples after the motion until the measurement is started by the
+ * peer device or the FIFO buffer is full.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+extern void APPL_SENSOR_LeaveStandby(void);
+
 /***************************************************************************//**
  * @brief Handles the GPIOTE interrupts of the LSM330 sensor.
  *
@@ -67,6 +238,38 @@ extern void APPL_SENSOR_SetupMotionWakeup(void);
  ******************************************************************************/
 extern void APPL_SENSOR_HandleInterrupt(int32_t channel);
 
+/***************************************************************************//**
+ * @brief Handles the radio notification of the SoftDevice.
+ *
+ * At the end of a radio event, the drains that wait for it are put into the
+ * scheduler, see APPL_SENSOR_AlignDrains(). Gets called from the SWI1
+ * interrupt, see ble_radio_notification.h.
+ *
+ * @param[in] isRadioActive True before the radio event, false after it.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+extern void APPL_SENSOR_HandleRadioNotification(bool isRadioActive);
+
+/***************************************************************************//**
+ * @brief Lets the drains of the sensor FIFOs wait for the end of the
+ *        connection events.
+ *
+ * The drains and the packets built from them are done between two connection
+ * events instead of colliding with one, so the TX buffers are full when the
+ * next one starts. A drain still runs immediately if the sensor FIFO could
+ * overrun before the next connection event ends. Disabling it puts the
+ * waiting drains into the scheduler.
+ *
+ * @param[in] interval The longest time between two connection events in
+ *                     1.25 ms units, the connection interval times one plus
+ *                     the slave latency. 0 to disable it without a
+ *                     connection.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+extern void APPL_SENSOR_AlignDrains(uint16_t interval);
+
 /***************************************************************************//**
  * @brief Initializes the Bluetooth Smart LSM330 service.
  *
@@ -0,0 +1,167 @@
+/***************************************************************************//**
+ * @brief   Self-test that selects the clock of the SPI bus to the LSM330.
+ *
+ * @file    spi_test.c
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+/*----- Header-Files ---------------------------------------------------------*/
+#include "spi_test.h"
+
+#include <stdio.h>
+
+#include "nrf/nrf.h"
+
+#include "txw51_framework/config/config.h"
+#include "txw51_framework/hw/lsm330.h"
+#include "txw51_framework/hw/spi.h"
+#include "txw51_framework/utils/kvstore.h"
+#include "txw51_framework/utils/log.h"
+#include "txw51_framework/utils/txw51_errors.h"
+
+#include "app/error.h"
+#include "app/kvstore_keys.h"
+
+/*----- Macros ---------------------------------------------------------------*/
+#define SPI_TEST_TIMER_PRESCALER    ( 4 )   /**< TIMER2 runs at 16MHz / 2^4 = 1MHz. */
+#define SPI_TEST_SAMPLE_SIZE        ( 6 )   /**< Bytes of a sample of the accelerometer. */
+#define SPI_TEST_OUTPUT_LENGTH      ( 60 )  /**< Length of a log line. */
+
+/*----- Data types -----------------------------------------------------------*/
+
+/*----- Function prototypes --------------------------------------------------*/
+static uint32_t SPI_TEST_Measure(uint8_t *buffer, uint16_t *errors);
+
+/*----- Data -----------------------------------------------------------------*/
+static bool isSelected = false;     /**< The SPI clock has been loaded from the key-value store. */
+
+/*----- Implementation -------------------------------------------------------*/
+
+uint32_t APPL_SPI_TEST_Init(void)
+{
+    uint8_t frequency = CONFIG_SPI_FREQUENCY;
+    uint8_t length = sizeof(frequency);
+    uint32_t err;
+
+    err = TXW51_KVSTORE_Get(APPL_KVSTORE_KEY_SPI_FREQUENCY, &frequency, &length);
+    isSelected = (err == ERR_NONE) && (length == sizeof(frequency)) &&
+                 (frequency < TXW51_SPI_NUM_OF_FREQUENCIES);
+    if (!isSelected) {
+        frequency = CONFIG_SPI_FREQUENCY;
+    }
+
+    return TXW51_SPI_Init(TXW51_SPI_0, frequency);
+}
+
+
+bool APPL_SPI_TEST_IsSelected(void)
+{
+    return isSelected;
+}
+
+
+uint32_t APPL_SPI_TEST_Run(void)
+{
+    uint8_t buffer[TXW51_LSM330_ACC_FIFO_SIZE * SPI_TEST_SAMPLE_SIZE];
+    char outputBuffer[SPI_TEST_OUTPUT_LENGTH];
+    enum TXW51_SPI_Frequency previous = TXW51_SPI_GetFrequency(TXW51_SPI_0);
+    enum TXW51_SPI_Frequency best = previous;
+    uint32_t bestThroughput = 0;
+    uint32_t throughput;
+    uint16_t errors;
+    uint8_t value;
+    bool hasPassed = false;
+
+    NRF_TIMER2->TASKS_STOP  = 1;
+    NRF_TIMER2->TASKS_CLEAR = 1;
+    NRF_TIMER2->MODE        = TIMER_MODE_MODE_Timer;
+    NRF_TIMER2->BITMODE     = TIMER_BITMODE_BITMODE_16Bit;
+    NRF_TIMER2->PRESCALER   = SPI_TEST_TIMER_PRESCALER;
+    NRF_TIMER2->TASKS_START = 1;
+
+    for (enum TXW51_SPI_Frequency frequency = TXW51_SPI_FREQ_1M;
+         frequency < TXW51_SPI_NUM_OF_FREQUENCIES;
+         frequency++) {
+        errors = APPL_SPI_TEST_BURSTS;
+        throughput = 0;
+        if (TXW51_SPI_SetFrequency(TXW51_SPI_0, frequency) == ERR_NONE) {
+            throughput = SPI_TEST_Measure(buffer, &errors);
+        }
+
+        snprintf(outputBuffer, SPI_TEST_OUTPUT_LENGTH, "[SPI Test] %4lu kHz: %7lu bytes/s, %u errors",
+                 TXW51_SPI_FREQUENCY_KHZ(frequency), (unsigned long)throughput, errors);
+        TXW51_LOG_INFO(outputBuffer);
+
+        /* Equal throughputs go to the faster clock, it holds the bus shorter. */
+        if ((errors == 0) && (throughput >= bestThroughput)) {
+            best = frequency;
+            bestThroughput = throughput;
+            hasPassed = true;
+        }
+    }
+
+    NRF_TIMER2->TASKS_STOP     = 1;
+    NRF_TIMER2->TASKS_SHUTDOWN = 1;
+
+    TXW51_SPI_SetFrequency(TXW51_SPI_0, best);
+    if (!hasPassed) {
+        TXW51_LOG_ERROR("[SPI Test] No SPI clock passed.");
+        return ERR_SPI_TEST_FAILED;
+    }
+
+    value = best;
+    if (TXW51_KVSTORE_Set(APPL_KVSTORE_KEY_SPI_FREQUENCY, &value, sizeof(value)) != ERR_NONE) {
+        TXW51_LOG_WARNING("[SPI Test] Could not save the SPI clock.");
+    }
+    isSelected = true;
+
+    snprintf(outputBuffer, SPI_TEST_OUTPUT_LENGTH, "[SPI Test] Selected %lu kHz.",
+             TXW51_SPI_FREQUENCY_KHZ(best));
+    TXW51_LOG_INFO(outputBuffer);
+    return ERR_NONE;
+}
+
+
+/***************************************************************************//**
+ * @brief Reads the FIFO of the accelerometer APPL_SPI_TEST_BURSTS times with
+ *        the current SPI clock.
+ *
+ * Only the sample reads are timed, the register checks are not.
+ *
+ * @param[out] buffer Buffer for a whole FIFO.
+ * @param[out] errors Number of bursts that failed or returned wrong
+ *                    registers.
+ *
+ * @return The throughput of the sample data in bytes/s.
+ ******************************************************************************/
+static uint32_t SPI_TEST_Measure(uint8_t *buffer, uint16_t *errors)
+{
+    uint32_t elapsed = 0;
+    uint16_t start;
+    uint32_t err;
+
+    *errors = 0;
+    for (uint32_t i = 0; i < APPL_SPI_TEST_BURSTS; i++) {
+        NRF_TIMER2->TASKS_CAPTURE[0] = 1;
+        start = NRF_TIMER2->CC[0];
+        err = TXW51_LSM330_ACC_GetDataBlock(buffer, TXW51_LSM330_ACC_FIFO_SIZE);
+        NRF_TIMER2->TASKS_CAPTURE[1] = 1;
+        /* A burst takes a few ms, the 16 bit timer wraps around after 65ms. */
+        elapsed += (uint16_t)(NRF_TIMER2->CC[1] - start);
+
+        if ((err != ERR_NONE) || (TXW51_LSM330_CheckRegisters() != ERR_NONE)) {
+            (*errors)++;
+        }
+    }
+
+    if (elapsed == 0) {
+        return 0;
+    }
+    return (uint32_t)((uint64_t)APPL_SPI_TEST_BURSTS * TXW51_LSM330_ACC_FIFO_SIZE *
+                      SPI_TEST_SAMPLE_SIZE * 1000000 / elapsed);
+}
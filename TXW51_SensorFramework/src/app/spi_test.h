@@ -0,0 +1,68 @@
+/***************************************************************************//**
+ * @brief   Self-test that selects the clock of the SPI bus to the LSM330.
+ *
+ * At every SPI clock, the test reads the whole FIFO of the accelerometer
+ * APPL_SPI_TEST_BURSTS times, sample by sample like the measurement, and
+ * compares the control registers of both sensors with the shadow copy after
+ * every burst. The throughput of the sample data and the failed bursts are
+ * written to the log. The fastest clock without errors is selected and saved
+ * in the key-value store, so the test only runs at the first start.
+ *
+ * TIMER2 measures the bursts with a resolution of 1us. It only runs during
+ * the test, because it draws current from the HFCLK.
+ *
+ * @file    spi_test.h
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+#ifndef TXW51_APPLICATION_SPI_TEST_H_
+#define TXW51_APPLICATION_SPI_TEST_H_
+
+/*----- Header-Files ---------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+
+/*----- Macros ---------------------------------------------------------------*/
+#define APPL_SPI_TEST_BURSTS    ( 16 )  /**< FIFO reads at every SPI clock. */
+
+/*----- Data types -----------------------------------------------------------*/
+
+/*----- Function prototypes --------------------------------------------------*/
+
+/***************************************************************************//**
+ * @brief Initializes SPI0 with the stored clock.
+ *
+ * Without a stored clock, CONFIG_SPI_FREQUENCY is used until the self-test
+ * has run.
+ *
+ * @return ERR_NONE if no error occurred.
+ *         ERR_SPI_INIT_FAILED if the initialization failed.
+ ******************************************************************************/
+extern uint32_t APPL_SPI_TEST_Init(void);
+
+/***************************************************************************//**
+ * @brief Checks if the SPI clock has been selected by the self-test.
+ *
+ * @return True if a clock is stored.
+ ******************************************************************************/
+extern bool APPL_SPI_TEST_IsSelected(void);
+
+/***************************************************************************//**
+ * @brief Runs the self-test and selects the SPI clock.
+ *
+ * Needs the initialized LSM330 without a running measurement, the FIFO
+ * reads would take samples from the stream.
+ *
+ * @return ERR_NONE if a clock has been selected.
+ *         ERR_SPI_TEST_FAILED if no clock passed, the previous one is kept.
+ ******************************************************************************/
+extern uint32_t APPL_SPI_TEST_Run(void);
+
+/*----- Data -----------------------------------------------------------------*/
+
+#endif /* TXW51_APPLICATION_SPI_TEST_H_ */
@@ -0,0 +1,203 @@
+/***************************************************************************//**
+ * @brief   Packet scheduler over the data streams of the measurement.
+ *
+ * @file    stream.c
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+/*----- Header-Files ---------------------------------------------------------*/
+#include "stream.h"
+
+#include <stddef.h>
+
+#include "nrf/app_common/app_timer.h"
+
+#include "txw51_framework/config/config.h"
+
+#include "app/error.h"
+
+/*----- Macros ---------------------------------------------------------------*/
+
+/*----- Data types -----------------------------------------------------------*/
+/**
+ * @brief State of a stream.
+ */
+struct STREAM_State {
+    APPL_STREAM_Read_t Read;    /**< Takes the next packet of the stream, NULL if not registered. */
+    void *Context;              /**< Given to the read callback. */
+    uint8_t  Weight;            /**< Packets per round. */
+    uint8_t  Credit;            /**< Packets left in the current round. */
+    uint32_t Deadline;          /**< Longest time between two packets in RTC ticks, 0 for none. */
+    uint32_t LastServed;        /**< RTC counter when the stream sent its last packet. */
+};
+
+/*----- Function prototypes --------------------------------------------------*/
+static void STREAM_Serve(struct STREAM_State *stream, uint32_t now);
+static struct TXW51_SERV_MEASURE_DataPacket *STREAM_NextOverdue(uint32_t now);
+static struct TXW51_SERV_MEASURE_DataPacket *STREAM_NextWeighted(uint32_t now);
+
+/*----- Data -----------------------------------------------------------------*/
+static struct STREAM_State streams[APPL_STREAM_COUNT];  /**< The registered streams. */
+static uint8_t current = 0;                             /**< The stream whose turn it is. */
+
+/*----- Implementation -------------------------------------------------------*/
+
+uint32_t APPL_STREAM_Register(enum appl_stream_id id,
+                              const struct APPL_STREAM_Init *init)
+{
+    if ((id >= APPL_STREAM_COUNT) || (init == NULL) || (init->Read == NULL)) {
+        return ERR_STREAM_INVALID_PARAM;
+    }
+
+    streams[id].Read     = init->Read;
+    streams[id].Context  = init->Context;
+    streams[id].Weight   = init->Weight;
+    streams[id].Credit   = init->Weight;
+    streams[id].Deadline = APP_TIMER_TICKS(init->DeadlineMs, CONFIG_TIMERS_PRESCALER);
+    app_timer_cnt_get(&streams[id].LastServed);
+
+    return ERR_NONE;
+}
+
+
+void APPL_STREAM_SetWeight(enum appl_stream_id id, uint8_t weight)
+{
+    if (id < APPL_STREAM_COUNT) {
+        streams[id].Weight = weight;
+    }
+}
+
+
+void APPL_STREAM_Reset(void)
+{
+    uint32_t now;
+
+    app_timer_cnt_get(&now);
+    for (uint32_t i = 0; i < APPL_STREAM_COUNT; i++) {
+        streams[i].Credit = streams[i].Weight;
+        streams[i].LastServed = now;
+    }
+    current = 0;
+}
+
+
+struct TXW51_SERV_MEASURE_DataPacket *APPL_STREAM_Next(void)
+{
+    struct TXW51_SERV_MEASURE_DataPacket *packet;
+    uint32_t now;
+
+    app_timer_cnt_get(&now);
+    packet = STREAM_NextOverdue(now);
+    if (packet != NULL) {
+        return packet;
+    }
+    return STREAM_NextWeighted(now);
+}
+
+
+/***************************************************************************//**
+ * @brief Accounts a packet that a stream has sent.
+ *
+ * Packets sent because of the deadline count against the share of the
+ * current round too.
+ *
+ * @param[in,out] stream The stream.
+ * @param[in]     now    The current RTC counter.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void STREAM_Serve(struct STREAM_State *stream, uint32_t now)
+{
+    if (stream->Credit > 0) {
+        stream->Credit--;
+    }
+    stream->LastServed = now;
+}
+
+
+/***************************************************************************//**
+ * @brief Gets the next packet of the streams that missed their deadline.
+ *
+ * The streams are tried in the order of how long they are overdue.
+ *
+ * @param[in] now The current RTC counter.
+ *
+ * @return The packet, NULL if no overdue stream has data.
+ ******************************************************************************/
+static struct TXW51_SERV_MEASURE_DataPacket *STREAM_NextOverdue(uint32_t now)
+{
+    struct TXW51_SERV_MEASURE_DataPacket *packet;
+    uint32_t tried = 0;
+
+    for (uint32_t n = 0; n < APPL_STREAM_COUNT; n++) {
+        struct STREAM_State *next = NULL;
+        uint32_t nextOverdue = 0;
+        uint32_t nextIndex = 0;
+
+        for (uint32_t i = 0; i < APPL_STREAM_COUNT; i++) {
+            struct STREAM_State *stream = &streams[i];
+            uint32_t age;
+
+            if ((stream->Read == NULL) || (stream->Deadline == 0) || (tried & (1UL << i))) {
+                continue;
+            }
+
+            app_timer_cnt_diff_compute(now, stream->LastServed, &age);
+            if ((age >= stream->Deadline) &&
+                ((next == NULL) || (age - stream->Deadline > nextOverdue))) {
+                next = stream;
+                nextOverdue = age - stream->Deadline;
+                nextIndex = i;
+            }
+        }
+
+        if (next == NULL) {
+            return NULL;
+        }
+        packet = next->Read(next->Context);
+        if (packet != NULL) {
+            STREAM_Serve(next, now);
+            return packet;
+        }
+        tried |= (1UL << nextIndex);
+    }
+    return NULL;
+}
+
+
+/***************************************************************************//**
+ * @brief Gets the next packet by weighted round-robin.
+ *
+ * The current stream sends until its credit is used up or it is empty, then
+ * the next stream gets its turn with a new credit.
+ *
+ * @param[in] now The current RTC counter.
+ *
+ * @return The packet, NULL if all streams are empty.
+ ******************************************************************************/
+static struct TXW51_SERV_MEASURE_DataPacket *STREAM_NextWeighted(uint32_t now)
+{
+    struct TXW51_SERV_MEASURE_DataPacket *packet;
+
+    /* One more turn than streams, to come back to the first with new credit. */
+    for (uint32_t i = 0; i <= APPL_STREAM_COUNT; i++) {
+        struct STREAM_State *stream = &streams[current];
+
+        if ((stream->Read != NULL) && (stream->Credit > 0)) {
+            packet = stream->Read(stream->Context);
+            if (packet != NULL) {
+                STREAM_Serve(stream, now);
+                return packet;
+            }
+        }
+
+        stream->Credit = stream->Weight;
+        current = (current + 1) % APPL_STREAM_COUNT;
+    }
+    return NULL;
+}
@@ -0,0 +1,109 @@
+/***************************************************************************//**
+ * @brief   Packet scheduler over the data streams of the measurement.
+ *
+ * Every stream provides its packets through a read callback. The streams
+ * share the link by weighted round-robin: per round, a stream may send as
+ * many packets as its weight. A stream that has nothing to send gives its
+ * share to the others, so a saturated link gets split between the streams
+ * in the ratio of their weights. Low-rate streams can have a deadline, they
+ * get served first when they have not sent a packet for this time.
+ *
+ * @file    stream.h
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+#ifndef TXW51_APPLICATION_STREAM_H_
+#define TXW51_APPLICATION_STREAM_H_
+
+/*----- Header-Files ---------------------------------------------------------*/
+#include <stdint.h>
+
+#include "txw51_framework/ble/service_measure.h"
+
+/*----- Macros ---------------------------------------------------------------*/
+
+/*----- Data types -----------------------------------------------------------*/
+/**
+ * List of the data streams.
+ */
+enum appl_stream_id {
+    APPL_STREAM_ACC,    /**< Samples of the accelerometer. */
+    APPL_STREAM_GYRO,   /**< Samples of the gyroscope. */
+    APPL_STREAM_AUX_0,  /**< Samples of the first registered sensor driver. */
+    APPL_STREAM_AUX_1,  /**< Samples of the second registered sensor driver. */
+    APPL_STREAM_COUNT   /**< Number of streams. */
+};
+
+/**
+ * @brief Takes the next packet of a stream.
+ *
+ * The packet stays in the FIFO buffer of the stream until the caller
+ * releases it, its sequence number gets set by the caller.
+ *
+ * @param[in] context The context given at the registration.
+ *
+ * @return The packet, NULL if the stream is empty.
+ */
+typedef struct TXW51_SERV_MEASURE_DataPacket *(*APPL_STREAM_Read_t)(void *context);
+
+/**
+ * @brief Structure with the initialization values of a stream.
+ */
+struct APPL_STREAM_Init {
+    APPL_STREAM_Read_t Read;    /**< Takes the next packet of the stream. */
+    void *Context;              /**< Given to the read callback. */
+    uint8_t  Weight;            /**< Packets per round, 0 to serve the stream only by its deadline. */
+    uint16_t DeadlineMs;        /**< Longest time between two packets of the stream in ms, 0 for none. */
+};
+
+/*----- Function prototypes --------------------------------------------------*/
+
+/***************************************************************************//**
+ * @brief Registers a stream at the scheduler.
+ *
+ * @param[in] id   The stream.
+ * @param[in] init The initialization values of the stream.
+ *
+ * @return ERR_NONE if no error occurred.
+ *         ERR_STREAM_INVALID_PARAM if the stream or its read callback is
+ *         invalid.
+ ******************************************************************************/
+extern uint32_t APPL_STREAM_Register(enum appl_stream_id id,
+                                     const struct APPL_STREAM_Init *init);
+
+/***************************************************************************//**
+ * @brief Changes the weight of a stream.
+ *
+ * The new weight applies from the next round.
+ *
+ * @param[in] id     The stream.
+ * @param[in] weight Packets per round.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+extern void APPL_STREAM_SetWeight(enum appl_stream_id id, uint8_t weight);
+
+/***************************************************************************//**
+ * @brief Starts a new round with all streams and restarts their deadlines.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+extern void APPL_STREAM_Reset(void);
+
+/***************************************************************************//**
+ * @brief Gets the next packet to send.
+ *
+ * The most overdue stream with a deadline is served first, otherwise the
+ * streams take turns by their weights.
+ *
+ * @return The packet, NULL if all streams are empty.
+ ******************************************************************************/
+extern struct TXW51_SERV_MEASURE_DataPacket *APPL_STREAM_Next(void);
+
+/*----- Data -----------------------------------------------------------------*/
+#endif /* TXW51_APPLICATION_STREAM_H_ */
@@ -0,0 +1,361 @@
+/***************************************************************************//**
+ * @brief   This module tests the clock synchronization on the host.
+ *
+ * Other than the remaining tests it runs on the host and is not part of the
+ * firmware build. The clock exchanges of a gateway are modelled with a fixed
+ * drift of RTC1 and fixed delays in both directions, the results are given to
+ * APPL_CLOCK_Synchronize() like the control point does. Compile and run it
+ * with:
+ *
+ *     gcc -std=gnu99 -DNRF51 -DSVCALL_AS_NORMAL_FUNCTION \
+ *         -Isim/include -Isrc -ILibraries -ILibraries/CMSIS -ILibraries/nrf \
+ *         -ILibraries/nrf/s110 -ILibraries/nrf/app_common \
+ *         -ILibraries/nrf/sd_common -Isrc/txw51_framework/config \
+ *         -Isrc/txw51_framework/hw -Isrc/txw51_framework/utils \
+ *         src/tests/test_clock.c src/app/clock.c -lm
+ *     ./a.out
+ *
+ * AddressSanitizer cannot be used, its shadow memory covers the SCB page.
+ *
+ * Each run starts with a fresh clock module in a child process. RTC1 starts
+ * shortly before the wrap-around of its 24 bits and the gateway clock
+ * shortly before the wrap-around of its 32 bits, so both extensions are
+ * exercised. Once the exchanges span half a minute, the device time mapped
+ * to the gateway clock is compared with the true time of the middle of its
+ * tick at every tick. The error may not exceed half a tick plus the
+ * resolution of the gateway time plus half the difference of the two delays,
+ * which the round trip cannot reveal. The drift estimate is checked at the
+ * end of each run.
+ *
+ * @file    test_clock.c
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+/*----- Header-Files ---------------------------------------------------------*/
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "nrf/s110/nrf_soc.h"
+#include "nrf/app_common/app_timer.h"
+
+#include "txw51_framework/config/config.h"
+#include "txw51_framework/utils/log.h"
+
+#include "app/clock.h"
+#include "app/error.h"
+
+/*----- Macros ---------------------------------------------------------------*/
+#define TEST_TICK_HZ        ( APP_TIMER_CLOCK_FREQ / (CONFIG_TIMERS_PRESCALER + 1) )   /**< Ticks of RTC1 per second. */
+#define TEST_TICK_MS        ( 1000.0 / TEST_TICK_HZ )   /**< Length of a tick in ms. */
+#define TEST_START_TICK     ( 0xFFFFFFUL - 20 * TEST_TICK_HZ )  /**< Counter of RTC1 at the start, it wraps after 20 s. */
+#define TEST_GATEWAY_EPOCH  ( 0xFFFFFFFFUL - 30000 )   /**< Gateway clock at the start in ms, it wraps after 30 s. */
+#define TEST_RESOLUTION_MS  ( 1.5 )     /**< Error of a gateway time from the resolution of its clock of 1 ms. */
+#define TEST_SETTLE         ( 4 )       /**< Accepted exchanges before the mapping gets checked. */
+#define TEST_SETTLE_MS      ( 30000.0 ) /**< Time the accepted exchanges span before the mapping gets checked. */
+#define TEST_SCB_PAGE       ( 0xE000E000UL )    /**< Page of the SCB, read by the critical region. */
+
+#define TEST_CHECK(cond)    TEST_Check((cond), #cond, __LINE__)
+
+/*----- Data types -----------------------------------------------------------*/
+/**
+ * @brief A run of clock exchanges.
+ */
+struct TEST_Run {
+    const char *Name;       /**< Printed with the result. */
+    double DriftPpm;        /**< Drift of RTC1, positive if it runs fast. */
+    double IntervalS;       /**< Time between two exchanges. */
+    double JitterS;         /**< Random extra time between two exchanges, up to this. */
+    double DurationS;       /**< Length of the run. */
+    double UplinkMs;        /**< Delay from the gateway time to the receipt in the device. */
+    double DownlinkMs;      /**< Delay from the receipt to the answer at the gateway. */
+    double MaxDriftErrorPpm;    /**< Largest error of the drift estimate at the end. */
+};
+
+/*----- Function prototypes --------------------------------------------------*/
+
+/*----- Data -----------------------------------------------------------------*/
+uint32_t gSimPrimask;                   /**< PRIMASK of the host replacement of the CMSIS header. */
+
+static uint32_t testRandom = 1;         /**< State of the random generator. */
+static uint32_t testErrors;             /**< Number of failed checks. */
+static double testNow;                  /**< True time in ms since the start. */
+static double testDriftPpm;             /**< Drift of RTC1 of the current run. */
+
+static const struct TEST_Run runs[] = {
+    /* name                 drift   interval jitter duration up     down   max drift error */
+    { "50 ppm, 2 s",          50.0,    2.0,  0.2,    60.0,   7.5,   7.5,   40.0 },
+    { "200 ppm, 2 s",        200.0,    2.0,  0.2,    60.0,   7.5,   7.5,   40.0 },
+    { "-500 ppm, 2 s",      -500.0,    2.0,  0.2,    60.0,   7.5,   7.5,   40.0 },
+    { "500 ppm, 2 s",        500.0,    2.0,  0.2,    60.0,   7.5,   7.5,   40.0 },
+    { "50 ppm, 2 s, 10 min",  50.0,    2.0,  0.2,   600.0,   7.5,   7.5,    5.0 },
+    { "30 ppm, 60 s",         30.0,   60.0,  6.0,  3600.0,   7.5,  15.0,    5.0 },
+    { "-120 ppm, asymmetric",-120.0,   5.0,  1.0,   900.0,   3.0,  15.0,    5.0 },
+    { "0 ppm, jitter",         0.0,    1.0,  1.0,   120.0,   7.5,   7.5,   20.0 },
+    /* Without jitter the drift is only known to a tick over the span. */
+    { "50 ppm, 2 s, fixed",   50.0,    2.0,  0.0,    60.0,   7.5,   7.5,  135.0 },
+};
+
+/*----- Implementation -------------------------------------------------------*/
+
+/***************************************************************************//**
+ * @brief Returns a pseudo random number.
+ ******************************************************************************/
+static uint32_t TEST_Random(void)
+{
+    testRandom = testRandom * 1103515245 + 12345;
+
+    return testRandom >> 8;
+}
+
+
+static void TEST_Check(bool cond, const char *text, int line)
+{
+    if (!cond) {
+        printf("FAIL line %d: %s\n", line, text);
+        testErrors++;
+    }
+}
+
+
+/***************************************************************************//**
+ * @brief Returns the ticks of RTC1 since its start at a true time.
+ *
+ * @param[in] time The true time in ms.
+ *
+ * @return The ticks, not limited to 24 bits.
+ ******************************************************************************/
+static uint32_t TEST_Ticks(double time)
+{
+    return TEST_START_TICK + (uint32_t)floor(time * (1 + testDriftPpm / 1e6) * TEST_TICK_HZ / 1000);
+}
+
+
+/***************************************************************************//**
+ * @brief Returns the gateway clock at a true time.
+ *
+ * @param[in] time The true time in ms.
+ *
+ * @return The gateway clock in ms.
+ ******************************************************************************/
+static uint32_t TEST_GatewayTime(double time)
+{
+    return (uint32_t)(TEST_GATEWAY_EPOCH + (uint64_t)floor(time));
+}
+
+
+/***************************************************************************//**
+ * @brief Checks the mapped device time at every tick until a true time.
+ *
+ * @param[in]     until    The true time in ms.
+ * @param[in]     maxError Largest error that passes in ms.
+ * @param[in,out] worst    The largest error so far in ms.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void TEST_CheckMapping(double until, double maxError, double *worst)
+{
+    uint32_t ticks = TEST_Ticks(testNow);
+    uint32_t last = TEST_Ticks(until);
+    uint32_t mapped;
+    double error;
+
+    for (; ticks != last; ticks++) {
+        /* The true time of the middle of the tick. */
+        testNow = (ticks - TEST_START_TICK + 0.5) * 1000 / TEST_TICK_HZ / (1 + testDriftPpm / 1e6);
+        if (!APPL_CLOCK_ToGatewayTime(APPL_CLOCK_GetTime(), &mapped)) {
+            continue;
+        }
+        error = fabs((int32_t)(mapped - TEST_GatewayTime(testNow)) - (testNow - floor(testNow)));
+        if (error > *worst) {
+            *worst = error;
+        }
+        if (error > maxError) {
+            printf("FAIL %.3f s: mapped time off by %.3f ms\n", testNow / 1000, error);
+            testErrors++;
+            return;
+        }
+    }
+    testNow = until;
+}
+
+
+/***************************************************************************//**
+ * @brief Runs clock exchanges and checks the mapping and the drift.
+ *
+ * @param[in] run The parameters of the run.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void TEST_Run(const struct TEST_Run *run)
+{
+    double maxError = TEST_TICK_MS / 2 + TEST_RESOLUTION_MS + fabs(run->UplinkMs - run->DownlinkMs) / 2;
+    double worst = 0;
+    double sent = 1000;
+    double first = sent;
+    uint32_t accepted = 0;
+    uint32_t err;
+
+    testDriftPpm = run->DriftPpm;
+    testNow = 0;
+
+    while (sent < run->DurationS * 1000) {
+        uint32_t gatewayTime = TEST_GatewayTime(sent);
+        uint32_t deviceTime = TEST_Ticks(sent + run->UplinkMs);
+        double answered = sent + run->UplinkMs + run->DownlinkMs;
+        uint16_t roundTrip = (uint16_t)(TEST_GatewayTime(answered) - gatewayTime);
+
+        /* The result arrives one connection event after the answer. */
+        if ((accepted >= TEST_SETTLE) && (sent - first >= TEST_SETTLE_MS)) {
+            TEST_CheckMapping(answered + 7.5, maxError, &worst);
+        }
+        testNow = answered + 7.5;
+        err = APPL_CLOCK_Synchronize(deviceTime, gatewayTime + roundTrip / 2, roundTrip);
+        TEST_CHECK(err == ERR_NONE);
+        accepted++;
+
+        sent += run->IntervalS * 1000 + run->JitterS * 1000 * (TEST_Random() % 1000) / 1000;
+    }
+    TEST_CheckMapping(sent, maxError, &worst);
+
+    printf("%-22s drift %9.3f ppm, error max %.3f ms of %.3f ms\n",
+           run->Name, APPL_CLOCK_GetDrift() / 1000.0, worst, maxError);
+    TEST_CHECK(fabs(APPL_CLOCK_GetDrift() / 1000.0 - run->DriftPpm) <= run->MaxDriftErrorPpm);
+}
+
+
+/***************************************************************************//**
+ * @brief Checks the pairs that are rejected and a change of the gateway
+ *        clock.
+ ******************************************************************************/
+static void TEST_Invalid(void)
+{
+    uint32_t deviceTime;
+    uint32_t mapped;
+
+    testDriftPpm = 0;
+    testNow = 10000;
+    deviceTime = TEST_Ticks(testNow - 10);
+
+    TEST_CHECK(APPL_CLOCK_Synchronize(deviceTime, 1000, APPL_CLOCK_MAX_ROUND_TRIP_MS + 1) == ERR_CLOCK_INVALID_PAIR);
+    TEST_CHECK(APPL_CLOCK_Synchronize(TEST_Ticks(testNow + 100), 1000, 10) == ERR_CLOCK_INVALID_PAIR);
+    TEST_CHECK(APPL_CLOCK_Synchronize(deviceTime, 1000, 10) == ERR_NONE);
+    TEST_CHECK(APPL_CLOCK_Synchronize(deviceTime, 1000, 10) == ERR_CLOCK_INVALID_PAIR);
+
+    /* The gateway clock jumps ahead, the old pair is dropped. */
+    testNow += 2000;
+    TEST_CHECK(APPL_CLOCK_Synchronize(TEST_Ticks(testNow - 10), 500000, 10) == ERR_NONE);
+    TEST_CHECK(APPL_CLOCK_ToGatewayTime(TEST_Ticks(testNow - 10), &mapped));
+    TEST_CHECK(abs((int32_t)(mapped - 500000)) <= 4);
+}
+
+
+/***************************************************************************//**
+ * @brief Runs a test in a child process, so it starts with the initial state
+ *        of the clock module.
+ *
+ * @param[in] run The run, NULL for the invalid pairs.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void TEST_Fork(const struct TEST_Run *run)
+{
+    pid_t pid;
+    int status;
+
+    fflush(stdout);
+    pid = fork();
+    if (pid == 0) {
+        testErrors = 0;
+        APPL_CLOCK_Init();
+        if (run != NULL) {
+            TEST_Run(run);
+        } else {
+            TEST_Invalid();
+        }
+        fflush(stdout);
+        _exit((testErrors > 0) ? EXIT_FAILURE : EXIT_SUCCESS);
+    }
+    TEST_CHECK(pid > 0);
+    TEST_CHECK((waitpid(pid, &status, 0) == pid) && WIFEXITED(status) && (WEXITSTATUS(status) == EXIT_SUCCESS));
+}
+
+
+uint32_t app_timer_create(app_timer_id_t *p_timer_id,
+                          app_timer_mode_t mode,
+                          app_timer_timeout_handler_t timeout_handler)
+{
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks, void *p_context)
+{
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_timer_cnt_get(uint32_t *p_ticks)
+{
+    *p_ticks = TEST_Ticks(testNow) & 0xFFFFFF;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_nvic_critical_region_enter(uint8_t *p_is_nested_critical_region)
+{
+    *p_is_nested_critical_region = 0;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_nvic_critical_region_exit(uint8_t is_nested_critical_region)
+{
+    return NRF_SUCCESS;
+}
+
+
+void app_error_handler(uint32_t error_code, uint32_t line_num, const uint8_t *p_file_name)
+{
+    printf("FAIL app_error_handler 0x%x at %s:%u\n", error_code, p_file_name, line_num);
+    exit(EXIT_FAILURE);
+}
+
+
+void TXW51_LOG_Print(const char *msg, enum TXW51_LOG_Level level)
+{
+}
+
+
+int main(void)
+{
+    /* The critical region reads the active interrupt from the SCB. */
+    if (mmap((void *)TEST_SCB_PAGE, 0x1000, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0) == MAP_FAILED) {
+        printf("Cannot map the SCB\n");
+        return EXIT_FAILURE;
+    }
+
+    for (uint32_t i = 0; i <= sizeof(runs) / sizeof(runs[0]); i++) {
+        TEST_Fork((i < sizeof(runs) / sizeof(runs[0])) ? &runs[i] : NULL);
+    }
+
+    if (testErrors > 0) {
+        printf("%u checks failed\n", testErrors);
+        return EXIT_FAILURE;
+    }
+
+    printf("All checks passed\n");
+    return EXIT_SUCCESS;
+}
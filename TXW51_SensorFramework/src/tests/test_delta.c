@@ -0,0 +1,391 @@
+/***************************************************************************//**
+ * @brief   This module tests the delta firmware update on the host.
+ *
+ * Other than the remaining tests it runs on the host and is not part of the
+ * firmware build. Deltas are created with the encoder of tools/delta and
+ * applied with the decoder of the bootloader in blocks of different sizes.
+ * Compile and run it with:
+ *
+ *     gcc -std=gnu99 -fsanitize=address -Isrc -ILibraries -Itools/delta \
+ *         src/tests/test_delta.c src/txw51_framework/utils/delta.c \
+ *         tools/delta/delta_encode.c Libraries/nrf/app_common/crc16.c
+ *     ./a.out [old.bin new.bin]...
+ *
+ * Without arguments, generated images with typical edits are used. Pairs of
+ * real images given as arguments are checked in addition.
+ *
+ * The corruption test changes every single byte of a delta and truncates it
+ * at every length, the decoder has to reject it without reading outside of
+ * the images.
+ *
+ * @file    test_delta.c
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+/*----- Header-Files ---------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "delta_encode.h"
+
+#include "txw51_framework/utils/delta.h"
+#include "txw51_framework/utils/txw51_errors.h"
+
+/*----- Macros ---------------------------------------------------------------*/
+#define TEST_IMAGE_SIZE     ( 40 * 1024 )   /**< Size of the generated images. */
+#define TEST_MAX_BLOCK      ( 256 )         /**< Largest block the target is built in. */
+
+#define TEST_CHECK(cond)    TEST_Check((cond), #cond, __LINE__)
+
+/*----- Data types -----------------------------------------------------------*/
+
+/*----- Function prototypes --------------------------------------------------*/
+
+/*----- Data -----------------------------------------------------------------*/
+static uint32_t testRandom = 1;                 /**< State of the random generator. */
+static uint32_t testErrors;                     /**< Number of failed checks. */
+
+static const uint32_t blockSizes[] = { 1, 3, 20, TEST_MAX_BLOCK };  /**< Block sizes of the decoder. */
+
+/*----- Implementation -------------------------------------------------------*/
+
+/***************************************************************************//**
+ * @brief Returns a pseudo random number.
+ ******************************************************************************/
+static uint32_t TEST_Random(void)
+{
+    testRandom = testRandom * 1103515245 + 12345;
+
+    return testRandom >> 8;
+}
+
+
+static void TEST_Check(bool cond, const char *text, int line)
+{
+    if (!cond) {
+        printf("FAIL line %d: %s\n", line, text);
+        testErrors++;
+    }
+}
+
+
+/***************************************************************************//**
+ * @brief Applies a delta.
+ *
+ * @param[in]  source     The source image.
+ * @param[in]  sourceSize Size of the source image.
+ * @param[in]  delta      The delta.
+ * @param[in]  deltaSize  Size of the delta.
+ * @param[in]  blockSize  Size of the blocks the target is built in.
+ * @param[out] target     Buffer for the target.
+ * @param[in]  maxSize    Size of the buffer.
+ * @param[out] targetSize Size of the target.
+ *
+ * @return The error of the decoder, ERR_NONE if the target is complete.
+ ******************************************************************************/
+static uint32_t TEST_Apply(const uint8_t *source, uint32_t sourceSize,
+                           const uint8_t *delta, uint32_t deltaSize,
+                           uint32_t blockSize,
+                           uint8_t *target, uint32_t maxSize, uint32_t *targetSize)
+{
+    struct TXW51_DELTA_Patch patch;
+    uint8_t block[TEST_MAX_BLOCK];
+    uint32_t err;
+
+    *targetSize = 0;
+
+    err = TXW51_DELTA_Init(&patch, source, sourceSize, delta, deltaSize);
+    if (err != ERR_NONE) {
+        return err;
+    }
+
+    while (!TXW51_DELTA_IsComplete(&patch)) {
+        uint32_t length;
+        err = TXW51_DELTA_Apply(&patch, block, blockSize, &length);
+        if (err != ERR_NONE) {
+            return err;
+        }
+        if ((length == 0) || (*targetSize + length > maxSize)) {
+            return ERR_DELTA_CORRUPT;
+        }
+        memcpy(&target[*targetSize], block, length);
+        *targetSize += length;
+    }
+    return ERR_NONE;
+}
+
+
+/***************************************************************************//**
+ * @brief Creates a delta and checks that it reproduces the target with all
+ *        block sizes.
+ *
+ * @param[in]  source     The source image.
+ * @param[in]  sourceSize Size of the source image.
+ * @param[in]  target     The target image.
+ * @param[in]  targetSize Size of the target image.
+ * @param[out] deltaSize  Size of the delta.
+ *
+ * @return The delta (to be released with free()).
+ ******************************************************************************/
+static uint8_t *TEST_RoundTrip(const uint8_t *source, uint32_t sourceSize,
+                               const uint8_t *target, uint32_t targetSize,
+                               uint32_t *deltaSize)
+{
+    uint8_t *delta = TXW51_DELTA_ENC_Create(source, sourceSize, target, targetSize, deltaSize);
+    TEST_CHECK(delta != NULL);
+    if (delta == NULL) {
+        return NULL;
+    }
+
+    uint8_t *result = malloc(targetSize + 1);
+    for (uint32_t i = 0; i < sizeof(blockSizes) / sizeof(blockSizes[0]); i++) {
+        uint32_t resultSize;
+        uint32_t err = TEST_Apply(source, sourceSize, delta, *deltaSize, blockSizes[i],
+                                  result, targetSize, &resultSize);
+        TEST_CHECK(err == ERR_NONE);
+        TEST_CHECK(resultSize == targetSize);
+        TEST_CHECK(memcmp(result, target, targetSize) == 0);
+    }
+    free(result);
+    return delta;
+}
+
+
+/***************************************************************************//**
+ * @brief Generates an image that looks like code: words with few distinct
+ *        upper bytes, some literal pools and an erased tail.
+ *
+ * @param[out] image The image.
+ * @param[in]  size  Size of the image.
+ ******************************************************************************/
+static void TEST_GenerateImage(uint8_t *image, uint32_t size)
+{
+    for (uint32_t i = 0; i < size; i += 2) {
+        uint32_t value = TEST_Random();
+        image[i] = value;
+        if (i + 1 < size) {
+            image[i + 1] = 0x40 + ((value >> 8) & 0x0F);
+        }
+    }
+    memset(&image[size - size / 16], 0xFF, size / 16);
+}
+
+
+/***************************************************************************//**
+ * @brief Checks that an unchanged image gives a tiny delta.
+ ******************************************************************************/
+static void TEST_Identical(void)
+{
+    static uint8_t image[TEST_IMAGE_SIZE];
+    uint32_t deltaSize;
+
+    TEST_GenerateImage(image, TEST_IMAGE_SIZE);
+    free(TEST_RoundTrip(image, TEST_IMAGE_SIZE, image, TEST_IMAGE_SIZE, &deltaSize));
+    TEST_CHECK(deltaSize <= TXW51_DELTA_HEADER_LENGTH + 8);
+
+    /* An empty target is complete from the start. */
+    free(TEST_RoundTrip(image, TEST_IMAGE_SIZE, image, 0, &deltaSize));
+    TEST_CHECK(deltaSize == TXW51_DELTA_HEADER_LENGTH);
+}
+
+
+/***************************************************************************//**
+ * @brief Checks typical changes of an image: patched bytes, a function that
+ *        is inserted and shifts the rest, a removed block and a longer image.
+ ******************************************************************************/
+static void TEST_Edits(void)
+{
+    static uint8_t source[TEST_IMAGE_SIZE];
+    static uint8_t target[TEST_IMAGE_SIZE + 1024];
+    uint32_t size = 0;
+    uint32_t deltaSize;
+
+    TEST_GenerateImage(source, TEST_IMAGE_SIZE);
+
+    memcpy(&target[size], &source[0], 4000);
+    size += 4000;
+    for (uint32_t i = 0; i < 600; i++) {
+        target[size++] = TEST_Random();
+    }
+    memcpy(&target[size], &source[4000], 16000);
+    size += 16000;
+    memcpy(&target[size], &source[20400], TEST_IMAGE_SIZE - 20400);
+    size += TEST_IMAGE_SIZE - 20400;
+    memcpy(&target[size], &source[100], 200);
+    size += 200;
+
+    /* Branches and pointers into the shifted code change. */
+    for (uint32_t i = 0; i < 40; i++) {
+        target[TEST_Random() % size] ^= 0x04;
+    }
+
+    free(TEST_RoundTrip(source, TEST_IMAGE_SIZE, target, size, &deltaSize));
+    printf("Edits: %u byte delta for %u byte image\n", deltaSize, size);
+    TEST_CHECK(deltaSize < size / 10);
+
+    /* A completely different image still works, with inserts only. */
+    TEST_GenerateImage(target, TEST_IMAGE_SIZE);
+    free(TEST_RoundTrip(source, TEST_IMAGE_SIZE, target, TEST_IMAGE_SIZE, &deltaSize));
+    TEST_CHECK(deltaSize < TEST_IMAGE_SIZE + 64);
+}
+
+
+/***************************************************************************//**
+ * @brief Checks that a delta is only applied to its source image.
+ ******************************************************************************/
+static void TEST_WrongSource(void)
+{
+    static uint8_t source[TEST_IMAGE_SIZE];
+    static uint8_t target[TEST_IMAGE_SIZE];
+    struct TXW51_DELTA_Patch patch;
+    uint32_t deltaSize;
+
+    TEST_GenerateImage(source, TEST_IMAGE_SIZE);
+    memcpy(target, source, TEST_IMAGE_SIZE);
+    target[1000] ^= 0xFF;
+
+    uint8_t *delta = TEST_RoundTrip(source, TEST_IMAGE_SIZE, target, TEST_IMAGE_SIZE, &deltaSize);
+
+    TEST_CHECK(TXW51_DELTA_Init(&patch, source, TEST_IMAGE_SIZE - 4, delta, deltaSize) == ERR_DELTA_WRONG_SOURCE);
+    source[5] ^= 0x01;
+    TEST_CHECK(TXW51_DELTA_Init(&patch, source, TEST_IMAGE_SIZE, delta, deltaSize) == ERR_DELTA_WRONG_SOURCE);
+    TEST_CHECK(TXW51_DELTA_Init(&patch, source, TEST_IMAGE_SIZE, source, TEST_IMAGE_SIZE) == ERR_DELTA_INVALID_HEADER);
+    TEST_CHECK(TXW51_DELTA_Init(&patch, source, TEST_IMAGE_SIZE, delta, TXW51_DELTA_HEADER_LENGTH - 1) == ERR_DELTA_INVALID_HEADER);
+    free(delta);
+}
+
+
+/***************************************************************************//**
+ * @brief Changes every byte of a delta and truncates it at every length.
+ ******************************************************************************/
+static void TEST_Corruption(void)
+{
+    static uint8_t source[4096];
+    static uint8_t target[4096];
+    static uint8_t result[4096];
+    uint32_t deltaSize;
+    uint32_t resultSize;
+    uint32_t rejected = 0;
+
+    TEST_GenerateImage(source, sizeof(source));
+    memcpy(target, source, sizeof(target));
+    memcpy(&target[100], &source[2000], 300);
+    for (uint32_t i = 0; i < 20; i++) {
+        target[TEST_Random() % sizeof(target)] ^= 0x80;
+    }
+
+    uint8_t *delta = TEST_RoundTrip(source, sizeof(source), target, sizeof(target), &deltaSize);
+
+    for (uint32_t i = 0; i < deltaSize; i++) {
+        /* Copy the delta, so the sanitizer catches reads beyond its end. */
+        uint8_t *changed = malloc(deltaSize);
+        memcpy(changed, delta, deltaSize);
+        changed[i] ^= 0x5A;
+
+        uint32_t err = TEST_Apply(source, sizeof(source), changed, deltaSize, TEST_MAX_BLOCK,
+                                  result, sizeof(result), &resultSize);
+        if (err != ERR_NONE) {
+            rejected++;
+        } else {
+            TEST_CHECK((resultSize == sizeof(target)) && (memcmp(result, target, resultSize) == 0));
+        }
+        free(changed);
+    }
+
+    for (uint32_t length = 0; length < deltaSize; length++) {
+        uint8_t *truncated = malloc(length + 1);
+        memcpy(truncated, delta, length);
+
+        uint32_t err = TEST_Apply(source, sizeof(source), truncated, length, TEST_MAX_BLOCK,
+                                  result, sizeof(result), &resultSize);
+        TEST_CHECK(err != ERR_NONE);
+        free(truncated);
+    }
+
+    printf("Corruption: %u of %u changed bytes rejected\n", rejected, deltaSize);
+    free(delta);
+}
+
+
+/***************************************************************************//**
+ * @brief Reads an image from a file.
+ *
+ * @param[in]  name Name of the file.
+ * @param[out] size Size of the image.
+ *
+ * @return The image (to be released with free()), NULL on error.
+ ******************************************************************************/
+static uint8_t *TEST_ReadFile(const char *name, uint32_t *size)
+{
+    FILE *file = fopen(name, "rb");
+    if (file == NULL) {
+        return NULL;
+    }
+
+    fseek(file, 0, SEEK_END);
+    *size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    uint8_t *data = malloc(*size + 1);
+    if (fread(data, 1, *size, file) != *size) {
+        free(data);
+        data = NULL;
+    }
+    fclose(file);
+    return data;
+}
+
+
+/***************************************************************************//**
+ * @brief Checks a pair of real images.
+ *
+ * @param[in] oldName The running image.
+ * @param[in] newName The new image.
+ ******************************************************************************/
+static void TEST_Files(const char *oldName, const char *newName)
+{
+    uint32_t oldSize;
+    uint32_t newSize;
+    uint32_t deltaSize;
+
+    uint8_t *oldImage = TEST_ReadFile(oldName, &oldSize);
+    uint8_t *newImage = TEST_ReadFile(newName, &newSize);
+    TEST_CHECK((oldImage != NULL) && (newImage != NULL));
+
+    if ((oldImage != NULL) && (newImage != NULL)) {
+        free(TEST_RoundTrip(oldImage, oldSize, newImage, newSize, &deltaSize));
+        printf("%s -> %s: %u byte delta for %u byte image\n",
+               oldName, newName, deltaSize, newSize);
+    }
+    free(oldImage);
+    free(newImage);
+}
+
+
+int main(int argc, char **argv)
+{
+    TEST_Identical();
+    TEST_Edits();
+    TEST_WrongSource();
+    TEST_Corruption();
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        TEST_Files(argv[i], argv[i + 1]);
+    }
+
+    if (testErrors > 0) {
+        printf("%u checks failed\n", testErrors);
+        return EXIT_FAILURE;
+    }
+
+    printf("All checks passed\n");
+    return EXIT_SUCCESS;
+}
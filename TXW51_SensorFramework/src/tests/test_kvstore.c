@@ -0,0 +1,479 @@
+/***************************************************************************//**
+ * @brief   This module tests the key-value store against a simulated flash.
+ *
+ * Other than the remaining tests it runs on the host and is not part of the
+ * firmware build. The simulated flash replaces the flash module: Writes can
+ * only clear bits, an erase sets all bits and operations finish when the test
+ * calls SIM_Run(), like the flash events of the Softdevice. Compile and run it
+ * with:
+ *
+ *     gcc -std=gnu99 -DNRF51 -Isrc -ILibraries -ILibraries/CMSIS \
+ *         -ILibraries/nrf -ILibraries/nrf/app_common -ILibraries/nrf/s110 \
+ *         src/tests/test_kvstore.c src/txw51_framework/utils/kvstore.c \
+ *         Libraries/nrf/app_common/crc16.c
+ *     ./a.out
+ *
+ * The power failure test interrupts a workload at every single flash word and
+ * checks after a restart that every key has either its old or its new value.
+ *
+ * @file    test_kvstore.c
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+/*----- Header-Files ---------------------------------------------------------*/
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "txw51_framework/config/config.h"
+#include "txw51_framework/hw/flash.h"
+#include "txw51_framework/utils/kvstore.h"
+#include "txw51_framework/utils/log.h"
+#include "txw51_framework/utils/txw51_errors.h"
+
+/*----- Macros ---------------------------------------------------------------*/
+#define SIM_PAGE_SIZE       ( 1024 )                    /**< Page size of the nRF51. */
+#define SIM_PAGE_WORDS      ( SIM_PAGE_SIZE / 4 )       /**< Words of a page. */
+#define SIM_UNLIMITED       ( -1 )                      /**< No power failure. */
+
+#define TEST_KEYS           ( 7 )                       /**< Keys used by the workload. */
+#define TEST_OPERATIONS     ( 150 )                     /**< Operations of the workload. */
+
+#define TEST_CHECK(cond)    TEST_Check((cond), #cond, __LINE__)
+
+/*----- Data types -----------------------------------------------------------*/
+/**
+ * @brief A pending operation of the simulated flash.
+ */
+struct SIM_Operation {
+    bool IsPending;             /**< An operation is pending. */
+    bool IsErase;               /**< Erase, otherwise write. */
+    uint32_t *Address;          /**< Destination. */
+    const uint32_t *Data;       /**< Source of a write. */
+    uint32_t Words;             /**< Words of a write. */
+};
+
+/**
+ * @brief Expected value of a key.
+ */
+struct TEST_Value {
+    bool    IsPresent;                                  /**< The key has a value. */
+    uint8_t Length;                                     /**< Length of the value. */
+    uint8_t Data[CONFIG_KVSTORE_MAX_VALUE_LENGTH];      /**< The value. */
+};
+
+/*----- Function prototypes --------------------------------------------------*/
+
+/*----- Data -----------------------------------------------------------------*/
+static uint32_t simFlash[2 * SIM_PAGE_WORDS];   /**< The two simulated pages. */
+static TXW51_FLASH_Callback_t simCallback;      /**< Callback of the store. */
+static struct SIM_Operation simOperation;       /**< The pending operation. */
+static int32_t  simBudget = SIM_UNLIMITED;      /**< Word writes and erases until the power fails. */
+static bool     simIsPowerLost;                 /**< The power has failed. */
+static uint32_t simFailures;                    /**< Number of operations to fail with an error. */
+static uint32_t simWordWrites;                  /**< Number of written words. */
+static uint32_t simErases[2];                   /**< Number of erases per page. */
+static uint32_t simRandom = 1;                  /**< State of the random generator. */
+
+static uint32_t testErrors;                     /**< Number of failed checks. */
+
+/*----- Implementation -------------------------------------------------------*/
+
+void TXW51_LOG_Print(const char *msg, enum TXW51_LOG_Level level)
+{
+}
+
+
+void TXW51_FLASH_Init(TXW51_FLASH_Callback_t callback)
+{
+    simCallback = callback;
+    simOperation.IsPending = false;
+}
+
+
+uint32_t TXW51_FLASH_Write(uint32_t *address, const uint32_t *data, uint32_t words)
+{
+    if (simOperation.IsPending) {
+        return ERR_FLASH_BUSY;
+    }
+
+    simOperation.IsPending = true;
+    simOperation.IsErase = false;
+    simOperation.Address = address;
+    simOperation.Data = data;
+    simOperation.Words = words;
+
+    return ERR_NONE;
+}
+
+
+uint32_t TXW51_FLASH_ErasePage(uint32_t *pageAddress)
+{
+    if (simOperation.IsPending) {
+        return ERR_FLASH_BUSY;
+    }
+
+    simOperation.IsPending = true;
+    simOperation.IsErase = true;
+    simOperation.Address = pageAddress;
+
+    return ERR_NONE;
+}
+
+
+bool TXW51_FLASH_IsBusy(void)
+{
+    return simOperation.IsPending;
+}
+
+
+void TXW51_FLASH_OnSysEvent(uint32_t sysEvent)
+{
+}
+
+
+/***************************************************************************//**
+ * @brief Returns a pseudo random number.
+ ******************************************************************************/
+static uint32_t SIM_Random(void)
+{
+    simRandom = simRandom * 1103515245 + 12345;
+
+    return simRandom;
+}
+
+
+/***************************************************************************//**
+ * @brief Consumes one unit of the power budget.
+ *
+ * @return True if the power fails now.
+ ******************************************************************************/
+static bool SIM_ConsumeBudget(void)
+{
+    if (simBudget == SIM_UNLIMITED) {
+        return false;
+    }
+
+    if (simBudget == 0) {
+        simIsPowerLost = true;
+        return true;
+    }
+
+    simBudget--;
+    return false;
+}
+
+
+static void TEST_Check(bool cond, const char *text, int line)
+{
+    if (!cond) {
+        printf("FAIL line %d: %s\n", line, text);
+        testErrors++;
+    }
+}
+
+
+/***************************************************************************//**
+ * @brief Executes the pending operations until the flash is idle.
+ *
+ * An interrupted write leaves the current word partially programmed, an
+ * interrupted erase leaves the page partially erased.
+ ******************************************************************************/
+static void SIM_Run(void)
+{
+    while (simOperation.IsPending && !simIsPowerLost) {
+        struct SIM_Operation op = simOperation;
+        uint32_t err = ERR_NONE;
+
+        if (simFailures > 0) {
+            simFailures--;
+            err = ERR_FLASH_OPERATION_FAILED;
+        } else if (op.IsErase) {
+            uint32_t page = (op.Address - simFlash) / SIM_PAGE_WORDS;
+
+            TEST_CHECK((op.Address - simFlash) % SIM_PAGE_WORDS == 0);
+            if (SIM_ConsumeBudget()) {
+                for (uint32_t i = 0; i < SIM_PAGE_WORDS; i++) {
+                    op.Address[i] |= SIM_Random();
+                }
+            } else {
+                memset(op.Address, 0xFF, SIM_PAGE_SIZE);
+                simErases[page]++;
+            }
+        } else {
+            for (uint32_t i = 0; (i < op.Words) && !simIsPowerLost; i++) {
+                /* The store must only write erased words. */
+                TEST_CHECK(op.Address[i] == 0xFFFFFFFF);
+                if (SIM_ConsumeBudget()) {
+                    op.Address[i] &= op.Data[i] | SIM_Random();
+                } else {
+                    op.Address[i] &= op.Data[i];
+                    simWordWrites++;
+                }
+            }
+        }
+
+        simOperation.IsPending = false;
+        if (!simIsPowerLost) {
+            simCallback(err);
+        }
+    }
+}
+
+
+/***************************************************************************//**
+ * @brief Erases the simulated flash and restarts the store.
+ ******************************************************************************/
+static void SIM_Format(void)
+{
+    memset(simFlash, 0xFF, sizeof(simFlash));
+    simBudget = SIM_UNLIMITED;
+    simIsPowerLost = false;
+    simFailures = 0;
+    simWordWrites = 0;
+    simErases[0] = 0;
+    simErases[1] = 0;
+    TEST_CHECK(TXW51_KVSTORE_Init(simFlash, SIM_PAGE_SIZE) == ERR_NONE);
+}
+
+
+/***************************************************************************//**
+ * @brief Simulates a restart of the device.
+ ******************************************************************************/
+static void SIM_Restart(void)
+{
+    simBudget = SIM_UNLIMITED;
+    simIsPowerLost = false;
+    simOperation.IsPending = false;
+    TEST_CHECK(TXW51_KVSTORE_Init(simFlash, SIM_PAGE_SIZE) == ERR_NONE);
+}
+
+
+/***************************************************************************//**
+ * @brief Checks if a key has the expected value.
+ ******************************************************************************/
+static bool TEST_HasValue(uint8_t key, const struct TEST_Value *expected)
+{
+    uint8_t buffer[CONFIG_KVSTORE_MAX_VALUE_LENGTH];
+    uint8_t length = sizeof(buffer);
+    uint32_t err = TXW51_KVSTORE_Get(key, buffer, &length);
+
+    if (!expected->IsPresent) {
+        return err == ERR_KVSTORE_NOT_FOUND;
+    }
+
+    return (err == ERR_NONE) &&
+           (length == expected->Length) &&
+           (memcmp(buffer, expected->Data, length) == 0);
+}
+
+
+/***************************************************************************//**
+ * @brief Returns operation i of the workload.
+ *
+ * Every eleventh operation deletes the key.
+ ******************************************************************************/
+static uint8_t TEST_Operation(uint32_t i, struct TEST_Value *value)
+{
+    value->IsPresent = (i % 11) != 10;
+    value->Length = value->IsPresent ? 1 + (i * 7) % CONFIG_KVSTORE_MAX_VALUE_LENGTH : 0;
+    for (uint32_t j = 0; j < value->Length; j++) {
+        value->Data[j] = (uint8_t)(i * 31 + j);
+    }
+
+    return (uint8_t)((i * 5) % TEST_KEYS);
+}
+
+
+static uint32_t TEST_Apply(uint8_t key, const struct TEST_Value *value)
+{
+    if (value->IsPresent) {
+        return TXW51_KVSTORE_Set(key, value->Data, value->Length);
+    }
+
+    return TXW51_KVSTORE_Delete(key);
+}
+
+
+static void TEST_Basic(void)
+{
+    uint8_t buffer[CONFIG_KVSTORE_MAX_VALUE_LENGTH];
+    uint8_t length;
+    uint32_t writes;
+
+    SIM_Format();
+
+    length = sizeof(buffer);
+    TEST_CHECK(TXW51_KVSTORE_Get(1, buffer, &length) == ERR_KVSTORE_NOT_FOUND);
+    TEST_CHECK(TXW51_KVSTORE_Set(CONFIG_KVSTORE_MAX_KEYS, (uint8_t *)"x", 1) == ERR_KVSTORE_INVALID_KEY);
+    TEST_CHECK(TXW51_KVSTORE_Set(1, (uint8_t *)"x", 0) == ERR_KVSTORE_INVALID_LENGTH);
+
+    /* Pending values are returned before they are written. */
+    TEST_CHECK(TXW51_KVSTORE_Set(1, (uint8_t *)"hello", 5) == ERR_NONE);
+    TEST_CHECK(TXW51_KVSTORE_IsBusy());
+    length = sizeof(buffer);
+    TEST_CHECK(TXW51_KVSTORE_Get(1, buffer, &length) == ERR_NONE);
+    TEST_CHECK((length == 5) && (memcmp(buffer, "hello", 5) == 0));
+    SIM_Run();
+    TEST_CHECK(!TXW51_KVSTORE_IsBusy());
+
+    length = 4;
+    TEST_CHECK(TXW51_KVSTORE_Get(1, buffer, &length) == ERR_KVSTORE_INVALID_LENGTH);
+
+    /* Unchanged values are not written. */
+    writes = simWordWrites;
+    TEST_CHECK(TXW51_KVSTORE_Set(1, (uint8_t *)"hello", 5) == ERR_NONE);
+    SIM_Run();
+    TEST_CHECK(simWordWrites == writes);
+
+    TEST_CHECK(TXW51_KVSTORE_Set(2, (uint8_t *)"world", 5) == ERR_NONE);
+    TEST_CHECK(TXW51_KVSTORE_Delete(1) == ERR_NONE);
+    SIM_Run();
+
+    SIM_Restart();
+    length = sizeof(buffer);
+    TEST_CHECK(TXW51_KVSTORE_Get(1, buffer, &length) == ERR_KVSTORE_NOT_FOUND);
+    length = sizeof(buffer);
+    TEST_CHECK(TXW51_KVSTORE_Get(2, buffer, &length) == ERR_NONE);
+    TEST_CHECK((length == 5) && (memcmp(buffer, "world", 5) == 0));
+}
+
+
+static void TEST_WearLeveling(void)
+{
+    uint32_t value;
+
+    SIM_Format();
+
+    for (value = 0; value < 2000; value++) {
+        TEST_CHECK(TXW51_KVSTORE_Set(3, (uint8_t *)&value, sizeof(value)) == ERR_NONE);
+        SIM_Run();
+    }
+
+    /* One erase per page of appended records, alternating between pages. */
+    printf("Wear leveling: %u word writes, erases %u / %u\n",
+           simWordWrites, simErases[0], simErases[1]);
+    TEST_CHECK(simErases[0] + simErases[1] <= 2000 * 2 / (SIM_PAGE_WORDS - 8) + 1);
+    TEST_CHECK(abs((int32_t)simErases[0] - (int32_t)simErases[1]) <= 1);
+
+    SIM_Restart();
+    value = 1999;
+    struct TEST_Value expected = { true, sizeof(value) };
+    memcpy(expected.Data, &value, sizeof(value));
+    TEST_CHECK(TEST_HasValue(3, &expected));
+}
+
+
+static void TEST_OperationFailed(void)
+{
+    struct TEST_Value expected = { true, 3, "abc" };
+
+    SIM_Format();
+
+    /* Failed operations are retried. */
+    TEST_CHECK(TXW51_KVSTORE_Set(4, (uint8_t *)"abc", 3) == ERR_NONE);
+    simFailures = CONFIG_KVSTORE_RETRIES;
+    SIM_Run();
+    TEST_CHECK(!TXW51_KVSTORE_IsBusy());
+    TEST_CHECK(TEST_HasValue(4, &expected));
+
+    /* The value is discarded after too many failures. */
+    TEST_CHECK(TXW51_KVSTORE_Set(4, (uint8_t *)"def", 3) == ERR_NONE);
+    simFailures = CONFIG_KVSTORE_RETRIES + 1;
+    SIM_Run();
+    TEST_CHECK(!TXW51_KVSTORE_IsBusy());
+    TEST_CHECK(TEST_HasValue(4, &expected));
+
+    SIM_Restart();
+    TEST_CHECK(TEST_HasValue(4, &expected));
+}
+
+
+static void TEST_PowerFailure(void)
+{
+    struct TEST_Value model[TEST_KEYS];
+    struct TEST_Value value;
+    uint32_t budget;
+    uint32_t runs = 0;
+
+    /* Measure the workload without power failure. */
+    SIM_Format();
+    for (uint32_t i = 0; i < TEST_OPERATIONS; i++) {
+        uint8_t key = TEST_Operation(i, &value);
+        TEST_CHECK(TEST_Apply(key, &value) == ERR_NONE);
+        SIM_Run();
+    }
+    budget = simWordWrites + simErases[0] + simErases[1];
+
+    for (uint32_t failAt = 0; failAt < budget; failAt++) {
+        memset(model, 0, sizeof(model));
+        SIM_Format();
+        simRandom = failAt + 1;
+        simBudget = failAt;
+
+        for (uint32_t i = 0; (i < TEST_OPERATIONS) && !simIsPowerLost; i++) {
+            uint8_t key = TEST_Operation(i, &value);
+            TEST_CHECK(TEST_Apply(key, &value) == ERR_NONE);
+            SIM_Run();
+
+            if (!simIsPowerLost) {
+                model[key] = value;
+                continue;
+            }
+
+            /* The interrupted key has its old or its new value. */
+            SIM_Restart();
+            runs++;
+            for (uint8_t k = 0; k < TEST_KEYS; k++) {
+                if (k != key) {
+                    TEST_CHECK(TEST_HasValue(k, &model[k]));
+                } else if (TEST_HasValue(k, &value)) {
+                    model[k] = value;
+                } else {
+                    TEST_CHECK(TEST_HasValue(k, &model[k]));
+                }
+            }
+
+            /* The store has to be writable after the restart. */
+            key = TEST_Operation(i + 1, &value);
+            TEST_CHECK(TEST_Apply(key, &value) == ERR_NONE);
+            SIM_Run();
+            model[key] = value;
+
+            SIM_Restart();
+            for (uint8_t k = 0; k < TEST_KEYS; k++) {
+                TEST_CHECK(TEST_HasValue(k, &model[k]));
+            }
+        }
+
+        if (testErrors > 0) {
+            printf("Power failure at flash operation %u\n", failAt);
+            return;
+        }
+    }
+
+    printf("Power failure: %u restarts checked\n", runs);
+}
+
+
+int main(void)
+{
+    TEST_Basic();
+    TEST_WearLeveling();
+    TEST_OperationFailed();
+    TEST_PowerFailure();
+
+    if (testErrors > 0) {
+        printf("%u checks failed\n", testErrors);
+        return EXIT_FAILURE;
+    }
+
+    printf("All checks passed\n");
+    return EXIT_SUCCESS;
+}
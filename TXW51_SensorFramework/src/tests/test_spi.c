@@ -40,7 +40,7 @@ int main(void)
 {
     TXW51_LOG_Init();
     SOFTDEVICE_HANDLER_INIT(CONFIG_CLOCK_LFCLK_SOURCE, false);
-    TXW51_SPI_Init(SPI_MASTER_0);
+    TXW51_SPI_Init(SPI_MASTER_0, TXW51_SPI_FREQ_1M);
     TXW51_LSM330_Init();
 
     TXW51_UART_WriteString((uint8_t *)"\r\n\r\n");
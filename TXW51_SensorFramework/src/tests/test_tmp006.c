@@ -0,0 +1,108 @@
+/***************************************************************************//**
+ * @brief   This module tests the fixed point TMP006 conversion against the
+ *          floating point reference of the gateway (adafruit_tmp006.js).
+ *
+ * Other than the remaining tests it runs on the host and is not part of the
+ * firmware build. Compile and run it with:
+ *
+ *     gcc -Isrc src/tests/test_tmp006.c src/txw51_framework/hw/tmp006_calc.c
+ *     ./a.out
+ *
+ * The reference values have been calculated with readObjTempC() of the
+ * gateway for the same raw register values.
+ *
+ * @file    test_tmp006.c
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+/*----- Header-Files ---------------------------------------------------------*/
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "txw51_framework/hw/tmp006_calc.h"
+
+/*----- Macros ---------------------------------------------------------------*/
+#define TEST_TOLERANCE      ( 2 )   /**< Allowed deviation in 0.01 degC. */
+
+/*----- Data types -----------------------------------------------------------*/
+/**
+ * @brief A raw sample with the expected object temperature.
+ */
+struct TEST_Vector {
+    int16_t RawVoltage;     /**< Content of the VOBJ register. */
+    int16_t RawDieTemp;     /**< Content of the TAMB register. */
+    double  Expected;       /**< Object temperature of the reference in degC. */
+};
+
+/*----- Function prototypes --------------------------------------------------*/
+
+/*----- Data -----------------------------------------------------------------*/
+static const struct TEST_Vector testVectors[] = {
+    {     0,  3200,  29.2434 },
+    {   -12,  3200,  28.9780 },
+    {   160,  3200,  32.7187 },
+    {  -160,  3200,  25.6464 },
+    {   640,  3200,  42.5024 },
+    {  1600,  3200,  59.7663 },
+    {  -640,  3200,  14.0117 },
+    {     0,     0,   2.4511 },
+    {   100,     0,   5.4852 },
+    {  -200,     0,  -3.9325 },
+    {     0, -5120, -51.0427 },
+    {   250, -5120, -35.6432 },
+    {     0,  6400,  54.4746 },
+    { -1000,  6400,  36.2252 },
+    {   500,  6400,  62.5851 },
+    {     0, 12800, 103.3011 },
+    { -2000, 12800,  79.0547 },
+    {  2560,  2816,  72.9323 },
+    {   -96,  2944,  24.9790 },
+    {    32,  4480,  40.0846 },
+};
+
+/*----- Implementation -------------------------------------------------------*/
+
+int main(void)
+{
+    unsigned int failed = 0;
+    unsigned int i;
+
+    printf("TMP006-Test\r\n");
+
+    for (i = 0; i < sizeof(testVectors) / sizeof(testVectors[0]); i++) {
+        const struct TEST_Vector *vector = &testVectors[i];
+        int16_t result = TXW51_TMP006_CalcObjectTemp(vector->RawVoltage, vector->RawDieTemp);
+        long expected = (long)(vector->Expected * 100.0 + ((vector->Expected < 0) ? -0.5 : 0.5));
+
+        if (labs((long)result - expected) > TEST_TOLERANCE) {
+            printf("FAIL: VOBJ=%d TAMB=%d: %d, expected %ld\r\n",
+                   vector->RawVoltage, vector->RawDieTemp, result, expected);
+            failed++;
+        }
+    }
+
+    /* Die temperature: 1/128 degC per LSB. */
+    if (TXW51_TMP006_CalcDieTemp(3200) != 2500)   { printf("FAIL: TAMB 25 degC\r\n");  failed++; }
+    if (TXW51_TMP006_CalcDieTemp(-5120) != -4000) { printf("FAIL: TAMB -40 degC\r\n"); failed++; }
+    if (TXW51_TMP006_CalcDieTemp(4) != 3)         { printf("FAIL: TAMB rounding\r\n"); failed++; }
+
+    /* Die temperatures outside of the model. */
+    if (TXW51_TMP006_CalcObjectTemp(0, INT16_MIN) != TXW51_TMP006_INVALID_TEMP) {
+        printf("FAIL: invalid die temperature\r\n");
+        failed++;
+    }
+
+    if (failed != 0) {
+        printf("%u test(s) failed.\r\n", failed);
+        return 1;
+    }
+
+    printf("All tests passed.\r\n");
+    return 0;
+}
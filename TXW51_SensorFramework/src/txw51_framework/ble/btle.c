@@ -29,6 +29,7 @@
 #include "txw51_framework/config/config_services.h"
 #include "txw51_framework/config/pstorage_platform.h"
 #include "txw51_framework/utils/log.h"
+#include "txw51_framework/utils/txw51_errors.h"
 
 /*----- Macros ---------------------------------------------------------------*/
 
@@ -39,6 +40,7 @@ static void BLE_InitStack(void);
 static void BLE_InitSecurityParams(void);
 static void BLE_InitConnectionParams(void);
 static void BLE_InitGapParams(void);
+static uint32_t BLE_SetAdvertisingData(ble_advdata_manuf_data_t *manufData);
 
 /*----- Data -----------------------------------------------------------------*/
 static ble_gap_sec_params_t  securityParams;   /**< Security requirements for this application. */
@@ -57,6 +59,44 @@ void TXW51_BLE_Init(void)
 void TXW51_BLE_InitAdvertising(void)
 {
     uint32_t err;
+
+    err = BLE_SetAdvertisingData(NULL);
+    APP_ERROR_CHECK(err);
+}
+
+
+uint32_t TXW51_BLE_SetManufacturerData(const uint8_t *data, uint8_t length)
+{
+    ble_advdata_manuf_data_t manufData;
+
+    if (data == NULL) {
+        return BLE_SetAdvertisingData(NULL);
+    }
+    if (length > TXW51_BLE_MAX_MANUF_DATA) {
+        return ERR_BLE_ADV_DATA_INVALID;
+    }
+
+    manufData.company_identifier = CONFIG_GAP_ADV_COMPANY_ID;
+    manufData.data.p_data        = (uint8_t *)data;
+    manufData.data.size          = length;
+
+    if (BLE_SetAdvertisingData(&manufData) != NRF_SUCCESS) {
+        return ERR_BLE_ADV_DATA_INVALID;
+    }
+    return ERR_NONE;
+}
+
+
+/***************************************************************************//**
+* @brief Encodes the advertising and scan response data and passes it to the
+*        stack.
+*
+* @param[in] manufData The manufacturer specific data, NULL for none.
+*
+* @return NRF_SUCCESS if no error occurred, the error of the stack otherwise.
+******************************************************************************/
+static uint32_t BLE_SetAdvertisingData(ble_advdata_manuf_data_t *manufData)
+{
     ble_advdata_t advData;
     ble_advdata_t scanResponseData;
     uint8_t flags = CONFIG_GAP_ADV_FLAGS;
@@ -72,13 +112,13 @@ void TXW51_BLE_InitAdvertising(void)
     advData.include_appearance = true;
     advData.flags.size         = sizeof(flags);
     advData.flags.p_data       = &flags;
+    advData.p_manuf_specific_data = manufData;
 
     memset(&scanResponseData, 0, sizeof(scanResponseData));
     scanResponseData.uuids_complete.uuid_cnt = sizeof(adv_uuids) / sizeof(adv_uuids[0]);
     scanResponseData.uuids_complete.p_uuids  = adv_uuids;
 
-    err = ble_advdata_set(&advData, &scanResponseData);
-    APP_ERROR_CHECK(err);
+    return ble_advdata_set(&advData, &scanResponseData);
 }
 
 
@@ -101,6 +141,17 @@ void TXW51_BLE_StartAdvertising(void)
 }
 
 
+void TXW51_BLE_StopAdvertising(void)
+{
+    uint32_t err;
+
+    err = sd_ble_gap_adv_stop();
+    if (err != NRF_ERROR_INVALID_STATE) {
+        APP_ERROR_CHECK(err);
+    }
+}
+
+
 const ble_gap_sec_params_t* TXW51_BLE_GetSecurityParams(void)
 {
 	return &securityParams;
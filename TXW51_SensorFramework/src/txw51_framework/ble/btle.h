@@ -20,6 +20,7 @@
 #include "nrf/s110/ble_gap.h"
 
 /*----- Macros ---------------------------------------------------------------*/
+#define TXW51_BLE_MAX_MANUF_DATA    ( 13 )  /**< Bytes of manufacturer specific data that fit next to the name, flags and appearance. */
 
 /*----- Data types -----------------------------------------------------------*/
 
@@ -44,6 +45,20 @@ extern void TXW51_BLE_Init(void);
 ******************************************************************************/
 extern void TXW51_BLE_InitAdvertising(void);
 
+/***************************************************************************//**
+* @brief Sets the manufacturer specific data of the advertising packet.
+*
+* The data follows the company identifier CONFIG_GAP_ADV_COMPANY_ID. The
+* advertising data gets updated immediately, also while advertising.
+*
+* @param[in] data   The data, NULL to remove the manufacturer specific data.
+* @param[in] length Length of the data, at most TXW51_BLE_MAX_MANUF_DATA.
+*
+* @return ERR_NONE if no error occurred.
+*         ERR_BLE_ADV_DATA_INVALID if the data does not fit into the packet.
+******************************************************************************/
+extern uint32_t TXW51_BLE_SetManufacturerData(const uint8_t *data, uint8_t length);
+
 /***************************************************************************//**
 * @brief Function for starting advertising.
 *
@@ -51,6 +66,15 @@ extern void TXW51_BLE_InitAdvertising(void);
 ******************************************************************************/
 extern void TXW51_BLE_StartAdvertising(void);
 
+/***************************************************************************//**
+* @brief Function for stopping advertising.
+*
+* Does nothing if the device is not advertising.
+*
+* @return Nothing.
+******************************************************************************/
+extern void TXW51_BLE_StopAdvertising(void);
+
 /***************************************************************************//**
 * @brief Get security parameters of this application.
 *
@@ -19,13 +19,13 @@
 #include <stdint.h>
 #include <string.h>
 
-#include "nrf/app_common/pstorage.h"
 #include "nrf/ble/ble_advdata.h"
 #include "nrf/s110/ble_hci.h"
 #include "nrf/sd_common/softdevice_handler.h"
 
 #include "txw51_framework/config/config.h"
 #include "txw51_framework/ble/btle.h"
+#include "txw51_framework/hw/flash.h"
 
 /*----- Macros ---------------------------------------------------------------*/
 
@@ -54,11 +54,7 @@ void TXW51_CB_DispatchBleEvent(ble_evt_t *bleEvent)
 
 void TXW51_CB_DispatchSysEvent(uint32_t sysEvent)
 {
-    /* if clause needed because of bug in pstorage.c. */
-    if ((sysEvent == NRF_EVT_FLASH_OPERATION_SUCCESS) ||
-        (sysEvent == NRF_EVT_FLASH_OPERATION_ERROR))  {
-        pstorage_sys_event_handler(sysEvent);
-    }
+    TXW51_FLASH_OnSysEvent(sysEvent);
 
     if (sysEventCallback != NULL) {
         sysEventCallback(sysEvent);
@@ -27,6 +27,11 @@
 /*----- Function prototypes --------------------------------------------------*/
 static void SERV_OnConnect(struct TXW51_SERV_Handle *handle, ble_evt_t *bleEvent);
 static void SERV_OnDisconnect(struct TXW51_SERV_Handle *handle, ble_evt_t *bleEvent);
+static const ble_gatts_char_handles_t *SERV_GetCharHandles(const struct TXW51_SERV_Handle *serviceHandle,
+                                                           const struct TXW51_SERV_CharDef *charDef);
+static const struct TXW51_SERV_CharDef *SERV_FindChar(const struct TXW51_SERV_Handle *serviceHandle,
+                                                      const struct TXW51_SERV_Table *table,
+                                                      uint16_t attrHandle);
 
 /*----- Data -----------------------------------------------------------------*/
 
@@ -39,6 +44,7 @@ uint32_t TXW51_SERV_Create(struct TXW51_SERV_ServiceInit *init,
 
     // Initialize service structure
     handle->ConnHandle = BLE_CONN_HANDLE_INVALID;
+    handle->LastHandle = 0;
 
     // Set UUID
     err = sd_ble_uuid_vs_add(&init->BaseUuid, &handle->UuidType);
@@ -69,7 +75,9 @@ void TXW51_SERV_InitChar(struct TXW51_SERV_Handle *serviceHandle,
                          uint16_t charUuid,
                          struct TXW51_SERV_CharInit *charac)
 {
-    uint8_t initialValue = 0;
+    /* The stack copies the value when the characteristic is added, but the
+     * pointer must not refer to this stack frame after the return. */
+    static const uint8_t initialValue = 0;
 
     /* TODO: memset is the nicer way to initialize, but we can't see what
              fields get initialized. */
@@ -116,7 +124,7 @@ void TXW51_SERV_InitChar(struct TXW51_SERV_Handle *serviceHandle,
     charac->Attribute.init_len  = sizeof(initialValue);
     charac->Attribute.init_offs = 0;
     charac->Attribute.max_len   = sizeof(initialValue);
-    charac->Attribute.p_value   = &initialValue;
+    charac->Attribute.p_value   = (uint8_t *)&initialValue;
 }
 
 
@@ -136,6 +144,222 @@ uint32_t TXW51_SERV_AddChar(struct TXW51_SERV_Handle *serviceHandle,
 }
 
 
+uint32_t TXW51_SERV_AddTable(struct TXW51_SERV_Handle *serviceHandle,
+                             const struct TXW51_SERV_Table *table,
+                             const void *init)
+{
+    uint32_t err;
+    ble_gatts_attr_md_t cccdMetadata;
+
+    memset(&cccdMetadata, 0, sizeof(cccdMetadata));
+    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&cccdMetadata.read_perm);
+    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&cccdMetadata.write_perm);
+    cccdMetadata.vloc = BLE_GATTS_VLOC_STACK;
+
+    serviceHandle->LastHandle = serviceHandle->ServiceHandle;
+
+    for (uint32_t i = 0; i < table->NumberOfChars; i++) {
+        const struct TXW51_SERV_CharDef *charDef = &table->Chars[i];
+        ble_gatts_char_handles_t *charHandles;
+        struct TXW51_SERV_CharInit charInit;
+        uint8_t value = charDef->InitValue;
+
+        charHandles = (ble_gatts_char_handles_t *)SERV_GetCharHandles(serviceHandle, charDef);
+
+        TXW51_SERV_InitChar(serviceHandle, charDef->Uuid, &charInit);
+
+        if (charDef->Flags & TXW51_SERV_CHAR_READ) {
+            charInit.Metadata.char_props.read = 1;
+            BLE_GAP_CONN_SEC_MODE_SET_OPEN(&charInit.AttrMetadata.read_perm);
+        }
+        if (charDef->Flags & TXW51_SERV_CHAR_WRITE) {
+            charInit.Metadata.char_props.write = 1;
+            BLE_GAP_CONN_SEC_MODE_SET_OPEN(&charInit.AttrMetadata.write_perm);
+        }
+        if (charDef->Flags & TXW51_SERV_CHAR_WRITE_CMD) {
+            charInit.Metadata.char_props.write_wo_resp = 1;
+            BLE_GAP_CONN_SEC_MODE_SET_OPEN(&charInit.AttrMetadata.write_perm);
+        }
+        if (charDef->Flags & (TXW51_SERV_CHAR_NOTIFY | TXW51_SERV_CHAR_INDICATE)) {
+            charInit.Metadata.char_props.notify   = (charDef->Flags & TXW51_SERV_CHAR_NOTIFY) ? 1 : 0;
+            charInit.Metadata.char_props.indicate = (charDef->Flags & TXW51_SERV_CHAR_INDICATE) ? 1 : 0;
+            charInit.Metadata.p_cccd_md           = &cccdMetadata;
+        }
+        charInit.AttrMetadata.rd_auth = (charDef->Flags & TXW51_SERV_CHAR_READ_AUTH) ? 1 : 0;
+        charInit.AttrMetadata.vlen    = (charDef->Flags & TXW51_SERV_CHAR_VLEN) ? 1 : 0;
+
+        charInit.Attribute.max_len  = charDef->MaxLength;
+        charInit.Attribute.init_len = charDef->InitLength;
+        charInit.Attribute.p_value  = &value;
+
+        if ((init != NULL) && (charDef->InitOffset != TXW51_SERV_NO_INIT)) {
+            const uint8_t *initValue = (const uint8_t *)init + charDef->InitOffset;
+
+            if (charDef->Flags & TXW51_SERV_CHAR_STRING) {
+                uint8_t *string = *(uint8_t * const *)initValue;
+                size_t length = strlen((char *)string);
+
+                charInit.Attribute.init_len = (length < charDef->MaxLength) ? length : charDef->MaxLength;
+                charInit.Attribute.p_value  = string;
+            } else {
+                value = *initValue;
+            }
+        }
+
+        if (charDef->UserValue != NULL) {
+            /* The stack keeps a reference, the value takes no space in its attribute table. */
+            charInit.AttrMetadata.vloc  = BLE_GATTS_VLOC_USER;
+            charInit.Attribute.init_len = 0;
+            charInit.Attribute.p_value  = charDef->UserValue;
+        }
+
+        err = TXW51_SERV_AddChar(serviceHandle, &charInit, charHandles);
+        if (err != ERR_NONE) {
+            return err;
+        }
+
+        /* The CCCD follows the value, the handle is 0 without a CCCD. */
+        serviceHandle->LastHandle = (charHandles->cccd_handle > charHandles->value_handle) ?
+                                    charHandles->cccd_handle : charHandles->value_handle;
+    }
+
+    return ERR_NONE;
+}
+
+
+uint8_t TXW51_SERV_FindWriteEvent(const struct TXW51_SERV_Handle *serviceHandle,
+                                  const struct TXW51_SERV_Table *table,
+                                  const ble_gatts_evt_write_t *write)
+{
+    const struct TXW51_SERV_CharDef *charDef;
+    const ble_gatts_char_handles_t *charHandles;
+
+    charDef = SERV_FindChar(serviceHandle, table, write->handle);
+    if (charDef == NULL) {
+        return TXW51_SERV_NO_EVENT;
+    }
+
+    charHandles = SERV_GetCharHandles(serviceHandle, charDef);
+    if (write->handle == charHandles->value_handle) {
+        return charDef->WriteEvent;
+    }
+    if (write->handle == charHandles->cccd_handle) {
+        return charDef->CccdEvent;
+    }
+    return TXW51_SERV_NO_EVENT;
+}
+
+
+uint8_t TXW51_SERV_FindReadEvent(const struct TXW51_SERV_Handle *serviceHandle,
+                                 const struct TXW51_SERV_Table *table,
+                                 const ble_gatts_evt_rw_authorize_request_t *request)
+{
+    const struct TXW51_SERV_CharDef *charDef;
+
+    if (request->type != BLE_GATTS_AUTHORIZE_TYPE_READ) {
+        return TXW51_SERV_NO_EVENT;
+    }
+
+    charDef = SERV_FindChar(serviceHandle, table, request->request.read.handle);
+    if ((charDef == NULL) ||
+        (request->request.read.handle != SERV_GetCharHandles(serviceHandle, charDef)->value_handle)) {
+        return TXW51_SERV_NO_EVENT;
+    }
+    return charDef->ReadEvent;
+}
+
+
+uint32_t TXW51_SERV_ReplyRead(uint16_t connHandle,
+                              uint8_t *value,
+                              uint16_t length)
+{
+    uint32_t err;
+    ble_gatts_rw_authorize_reply_params_t reply;
+
+    reply.type = BLE_GATTS_AUTHORIZE_TYPE_READ;
+    reply.params.read.gatt_status = BLE_GATT_STATUS_SUCCESS;
+    reply.params.read.p_data = value;
+    reply.params.read.len = length;
+    reply.params.read.update = 1;
+    reply.params.read.offset = 0;
+
+    err = sd_ble_gatts_rw_authorize_reply(connHandle, &reply);
+    if (err != NRF_SUCCESS) {
+        return ERR_BLE_SERVICE_READ_REPLY;
+    }
+    return ERR_NONE;
+}
+
+
+uint32_t TXW51_SERV_ReplyReadStored(uint16_t connHandle)
+{
+    uint32_t err;
+    ble_gatts_rw_authorize_reply_params_t reply;
+
+    memset(&reply, 0, sizeof(reply));
+    reply.type = BLE_GATTS_AUTHORIZE_TYPE_READ;
+    reply.params.read.gatt_status = BLE_GATT_STATUS_SUCCESS;
+    reply.params.read.update = 0;
+
+    err = sd_ble_gatts_rw_authorize_reply(connHandle, &reply);
+    if (err != NRF_SUCCESS) {
+        return ERR_BLE_SERVICE_READ_REPLY;
+    }
+    return ERR_NONE;
+}
+
+
+/***************************************************************************//**
+* @brief Gets the handles of a characteristic from the specific service handle.
+*
+* @param[in] serviceHandle The handle for the service.
+* @param[in] charDef       The characteristic.
+* @return The handles of the characteristic.
+******************************************************************************/
+static const ble_gatts_char_handles_t *SERV_GetCharHandles(const struct TXW51_SERV_Handle *serviceHandle,
+                                                           const struct TXW51_SERV_CharDef *charDef)
+{
+    return (const ble_gatts_char_handles_t *)((const uint8_t *)serviceHandle + charDef->HandleOffset);
+}
+
+
+/***************************************************************************//**
+* @brief Finds the characteristic that an attribute belongs to.
+*
+* Events of other services are rejected by the handle range of the service.
+* Inside of it, the value handles rise with the table index, so the
+* characteristic is the last one with a value handle up to the attribute.
+*
+* @param[in] serviceHandle The handle for the service.
+* @param[in] table         The characteristics of the service.
+* @param[in] attrHandle    Handle of the attribute.
+* @return The characteristic, NULL if the attribute is not in the service.
+******************************************************************************/
+static const struct TXW51_SERV_CharDef *SERV_FindChar(const struct TXW51_SERV_Handle *serviceHandle,
+                                                      const struct TXW51_SERV_Table *table,
+                                                      uint16_t attrHandle)
+{
+    uint32_t low = 0;
+    uint32_t high = table->NumberOfChars;
+
+    if ((attrHandle <= serviceHandle->ServiceHandle) ||
+        (attrHandle > serviceHandle->LastHandle)) {
+        return NULL;
+    }
+
+    while (high - low > 1) {
+        uint32_t middle = (low + high) / 2;
+
+        if (SERV_GetCharHandles(serviceHandle, &table->Chars[middle])->value_handle <= attrHandle) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+    return (high > low) ? &table->Chars[low] : NULL;
+}
+
+
 void TXW51_SERV_OnBleEvent(struct TXW51_SERV_Handle *handle,
                          ble_evt_t *bleEvent)
 {
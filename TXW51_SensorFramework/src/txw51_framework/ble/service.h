@@ -17,10 +17,28 @@
 #define TXW51_FRAMEWORK_BLE_SERVICE_H_
 
 /*----- Header-Files ---------------------------------------------------------*/
+#include <stddef.h>
+
 #include "nrf/s110/ble.h"
 #include "nrf/ble/ble_services/ble_srv_common.h"
 
 /*----- Macros ---------------------------------------------------------------*/
+#define TXW51_SERV_CHAR_READ        ( 0x01 )    /**< The value can be read without security. */
+#define TXW51_SERV_CHAR_WRITE       ( 0x02 )    /**< The value can be written without security. */
+#define TXW51_SERV_CHAR_NOTIFY      ( 0x04 )    /**< The value can be notified, adds a CCCD. */
+#define TXW51_SERV_CHAR_INDICATE    ( 0x08 )    /**< The value can be indicated, adds a CCCD. */
+#define TXW51_SERV_CHAR_READ_AUTH   ( 0x10 )    /**< Reads are forwarded to the service as ReadEvent. */
+#define TXW51_SERV_CHAR_VLEN        ( 0x20 )    /**< The value has a variable length. */
+#define TXW51_SERV_CHAR_STRING      ( 0x40 )    /**< The initial value is a pointer to a string. */
+#define TXW51_SERV_CHAR_WRITE_CMD   ( 0x80 )    /**< The value can be written without response and without security. */
+
+#define TXW51_SERV_NO_INIT          ( 0xFF )    /**< The initial value is not part of the init structure. */
+#define TXW51_SERV_NO_EVENT         ( 0 )       /**< No event, the value of all *_EVT_UNKNOWN. */
+
+/**
+ * @brief Defines a table from an array of characteristic definitions.
+ */
+#define TXW51_SERV_TABLE(chars)     { (chars), sizeof(chars) / sizeof((chars)[0]) }
 
 /*----- Data types -----------------------------------------------------------*/
 /**
@@ -44,11 +62,43 @@ struct TXW51_SERV_ServiceInit {
 
 /**
  * @brief Handle that defines a specific instance of a service.
+ *
+ * It has to be the first member of the handle of a specific service, the
+ * characteristic handles are found by their offset from it.
  */
 struct TXW51_SERV_Handle {
     uint16_t ServiceHandle; /**< Handle of the service. */
     uint8_t  UuidType;      /**< Type information of the UUID. */
     uint16_t ConnHandle;    /**< Handle of the current connection (is BLE_CONN_HANDLE_INVALID if not connected). */
+    uint16_t LastHandle;    /**< Last attribute handle of the service, set by TXW51_SERV_AddTable(). */
+};
+
+/**
+ * @brief Definition of a characteristic, kept in the flash.
+ *
+ * The offsets are taken with offsetof() from the handle and the init
+ * structure of the specific service.
+ */
+struct TXW51_SERV_CharDef {
+    uint16_t Uuid;          /**< UUID of the characteristic (16 bit). */
+    uint8_t  Flags;         /**< TXW51_SERV_CHAR_* flags. */
+    uint8_t  MaxLength;     /**< Maximum length of the value. */
+    uint8_t  HandleOffset;  /**< Offset of the ble_gatts_char_handles_t in the service handle. */
+    uint8_t  InitOffset;    /**< Offset of the initial value in the init structure, or TXW51_SERV_NO_INIT. */
+    uint8_t  InitLength;    /**< Length of the initial value if it is not a string (0 or 1). */
+    uint8_t  InitValue;     /**< Initial value if it is not in the init structure. */
+    uint8_t  WriteEvent;    /**< Event of a write to the value, or TXW51_SERV_NO_EVENT. */
+    uint8_t  CccdEvent;     /**< Event of a write to the CCCD, or TXW51_SERV_NO_EVENT. */
+    uint8_t  ReadEvent;     /**< Event of an authorized read, or TXW51_SERV_NO_EVENT. */
+    uint8_t *UserValue;     /**< Buffer of MaxLength bytes that holds the value instead of the stack, or NULL. */
+};
+
+/**
+ * @brief The characteristics of a service, in the order they are added.
+ */
+struct TXW51_SERV_Table {
+    const struct TXW51_SERV_CharDef *Chars; /**< The characteristics. */
+    uint8_t NumberOfChars;                  /**< Number of entries in Chars. */
 };
 
 
@@ -98,6 +148,76 @@ extern uint32_t TXW51_SERV_AddChar(struct TXW51_SERV_Handle *serviceHandle,
                                    struct TXW51_SERV_CharInit *charInit,
                                    ble_gatts_char_handles_t *charHandle);
 
+/***************************************************************************//**
+* @brief Adds all characteristics of a table to the service.
+*
+* The stack assigns the attribute handles in the order of the table, which
+* lets the events be mapped back to the table by a binary search.
+*
+* @param[in,out] serviceHandle The handle for the service, the first member of
+*                              the handle of the specific service.
+* @param[in]     table         The characteristics.
+* @param[in]     init          The init structure of the specific service,
+*                              NULL if it has no initial values.
+* @return ERR_NONE if no error occurred.
+*         ERR_BLE_SERVICE_ADD_CHARACTERISTIC if characteristic could not be
+*                                            added.
+******************************************************************************/
+extern uint32_t TXW51_SERV_AddTable(struct TXW51_SERV_Handle *serviceHandle,
+                                    const struct TXW51_SERV_Table *table,
+                                    const void *init);
+
+/***************************************************************************//**
+* @brief Maps a write to the event of the characteristic.
+*
+* @param[in] serviceHandle The handle for the service.
+* @param[in] table         The characteristics of the service.
+* @param[in] write         The write event of the stack.
+* @return WriteEvent or CccdEvent of the written characteristic,
+*         TXW51_SERV_NO_EVENT if the write is not for this service.
+******************************************************************************/
+extern uint8_t TXW51_SERV_FindWriteEvent(const struct TXW51_SERV_Handle *serviceHandle,
+                                         const struct TXW51_SERV_Table *table,
+                                         const ble_gatts_evt_write_t *write);
+
+/***************************************************************************//**
+* @brief Maps a read authorization request to the event of the characteristic.
+*
+* @param[in] serviceHandle The handle for the service.
+* @param[in] table         The characteristics of the service.
+* @param[in] request       The authorization request of the stack.
+* @return ReadEvent of the read characteristic, TXW51_SERV_NO_EVENT if the
+*         request is not a read of this service.
+******************************************************************************/
+extern uint8_t TXW51_SERV_FindReadEvent(const struct TXW51_SERV_Handle *serviceHandle,
+                                        const struct TXW51_SERV_Table *table,
+                                        const ble_gatts_evt_rw_authorize_request_t *request);
+
+/***************************************************************************//**
+* @brief Answers an authorized read with the value.
+*
+* @param[in] connHandle Handle of the connection.
+* @param[in] value      The value.
+* @param[in] length     Length of the value in bytes.
+* @return ERR_NONE if no error occurred.
+*         ERR_BLE_SERVICE_READ_REPLY if the stack rejected the reply.
+******************************************************************************/
+extern uint32_t TXW51_SERV_ReplyRead(uint16_t connHandle,
+                                     uint8_t *value,
+                                     uint16_t length);
+
+/***************************************************************************//**
+* @brief Answers an authorized read with the value stored in the stack.
+*
+* Used for the blob reads of a long read, so all parts are taken from the
+* value that has been set with TXW51_SERV_ReplyRead() at offset 0.
+*
+* @param[in] connHandle Handle of the connection.
+* @return ERR_NONE if no error occurred.
+*         ERR_BLE_SERVICE_READ_REPLY if the stack rejected the reply.
+******************************************************************************/
+extern uint32_t TXW51_SERV_ReplyReadStored(uint16_t connHandle);
+
 /***************************************************************************//**
 * @brief BLE event callback for all services.
 *
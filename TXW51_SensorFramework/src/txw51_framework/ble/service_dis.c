@@ -36,17 +36,88 @@ static void SERV_DIS_OnDisconnect(struct TXW51_SERV_DIS_Handle *handle,
                                   ble_evt_t *bleEvent);
 static void SERV_DIS_OnWrite(struct TXW51_SERV_DIS_Handle *handle,
                              ble_evt_t *bleEvent);
-static uint32_t SERV_DIS_AddAllChars(struct TXW51_SERV_DIS_Handle *serviceHandle,
-                                     const struct TXW51_SERV_DIS_Init *init);
-static uint32_t SERV_DIS_AddChar(struct TXW51_SERV_DIS_Handle *serviceHandle,
-                                 uint16_t uuid,
-                                 uint8_t *charValue,
-                                 char *description,
-                                 ble_gatts_char_handles_t *charHandle);
-static uint32_t SERV_DIS_AddChar_Timer(struct TXW51_SERV_DIS_Handle *serviceHandle);
-static uint32_t SERV_DIS_AddChar_SaveValues(struct TXW51_SERV_DIS_Handle *serviceHandle);
+static void SERV_DIS_OnRwAuthRequest(struct TXW51_SERV_DIS_Handle *handle,
+                                     ble_evt_t *bleEvent);
 
 /*----- Data -----------------------------------------------------------------*/
+static uint8_t snapshotValue[TXW51_SERV_DIS_SNAPSHOT_MAX_LENGTH];   /**< Value of the snapshot, the largest value of the attribute table otherwise. */
+
+/**
+ * @brief The characteristics of the service.
+ */
+static const struct TXW51_SERV_CharDef disChars[] = {
+    {
+        .Uuid         = TXW51_SERV_DIS_UUID_CHAR_MANUFACTURER,
+        .Flags        = TXW51_SERV_CHAR_READ | TXW51_SERV_CHAR_WRITE | TXW51_SERV_CHAR_STRING,
+        .MaxLength    = TXW51_SERV_DIS_VALUE_MAX_LENGTH,
+        .HandleOffset = offsetof(struct TXW51_SERV_DIS_Handle, CharHandle_Manufacturer),
+        .InitOffset   = offsetof(struct TXW51_SERV_DIS_Init, String_Manufacturer),
+        .WriteEvent   = TXW51_SERV_DIS_EVT_UPDATE_MANUFACTURER
+    }, {
+        .Uuid         = TXW51_SERV_DIS_UUID_CHAR_MODEL,
+        .Flags        = TXW51_SERV_CHAR_READ | TXW51_SERV_CHAR_WRITE | TXW51_SERV_CHAR_STRING,
+        .MaxLength    = TXW51_SERV_DIS_VALUE_MAX_LENGTH,
+        .HandleOffset = offsetof(struct TXW51_SERV_DIS_Handle, CharHandle_Model),
+        .InitOffset   = offsetof(struct TXW51_SERV_DIS_Init, String_Model),
+        .WriteEvent   = TXW51_SERV_DIS_EVT_UPDATE_MODEL
+    }, {
+        .Uuid         = TXW51_SERV_DIS_UUID_CHAR_SERIAL,
+        .Flags        = TXW51_SERV_CHAR_READ | TXW51_SERV_CHAR_WRITE | TXW51_SERV_CHAR_STRING,
+        .MaxLength    = TXW51_SERV_DIS_VALUE_MAX_LENGTH,
+        .HandleOffset = offsetof(struct TXW51_SERV_DIS_Handle, CharHandle_Serial),
+        .InitOffset   = offsetof(struct TXW51_SERV_DIS_Init, String_Serial),
+        .WriteEvent   = TXW51_SERV_DIS_EVT_UPDATE_SERIAL
+    }, {
+        .Uuid         = TXW51_SERV_DIS_UUID_CHAR_HW_REV,
+        .Flags        = TXW51_SERV_CHAR_READ | TXW51_SERV_CHAR_WRITE | TXW51_SERV_CHAR_STRING,
+        .MaxLength    = TXW51_SERV_DIS_VALUE_MAX_LENGTH,
+        .HandleOffset = offsetof(struct TXW51_SERV_DIS_Handle, CharHandle_HwRev),
+        .InitOffset   = offsetof(struct TXW51_SERV_DIS_Init, String_HwRev),
+        .WriteEvent   = TXW51_SERV_DIS_EVT_UPDATE_HW_REV
+    }, {
+        .Uuid         = TXW51_SERV_DIS_UUID_CHAR_FW_REV,
+        .Flags        = TXW51_SERV_CHAR_READ | TXW51_SERV_CHAR_WRITE | TXW51_SERV_CHAR_STRING,
+        .MaxLength    = TXW51_SERV_DIS_VALUE_MAX_LENGTH,
+        .HandleOffset = offsetof(struct TXW51_SERV_DIS_Handle, CharHandle_FwRev),
+        .InitOffset   = offsetof(struct TXW51_SERV_DIS_Init, String_FwRev),
+        .WriteEvent   = TXW51_SERV_DIS_EVT_UPDATE_FW_REV
+    }, {
+        .Uuid         = TXW51_SERV_DIS_UUID_CHAR_DEVICE_NAME,
+        .Flags        = TXW51_SERV_CHAR_READ | TXW51_SERV_CHAR_WRITE | TXW51_SERV_CHAR_STRING,
+        .MaxLength    = TXW51_SERV_DIS_VALUE_MAX_LENGTH,
+        .HandleOffset = offsetof(struct TXW51_SERV_DIS_Handle, CharHandle_DeviceName),
+        .InitOffset   = offsetof(struct TXW51_SERV_DIS_Init, String_DeviceName),
+        .WriteEvent   = TXW51_SERV_DIS_EVT_UPDATE_DEVICE_NAME
+    }, {
+        .Uuid         = TXW51_SERV_DIS_UUID_CHAR_SAVE_VALUES,
+        .Flags        = TXW51_SERV_CHAR_WRITE,
+        .MaxLength    = 1,
+        .HandleOffset = offsetof(struct TXW51_SERV_DIS_Handle, CharHandle_SaveValues),
+        .InitOffset   = TXW51_SERV_NO_INIT,
+        .InitLength   = 1,
+        .WriteEvent   = TXW51_SERV_DIS_EVT_SAVE_VALUES
+    }, {
+        .Uuid         = TXW51_SERV_DIS_UUID_CHAR_DISABLE_TIMER,
+        .Flags        = TXW51_SERV_CHAR_READ | TXW51_SERV_CHAR_WRITE,
+        .MaxLength    = 1,
+        .HandleOffset = offsetof(struct TXW51_SERV_DIS_Handle, CharHandle_DisableTimer),
+        .InitOffset   = TXW51_SERV_NO_INIT,
+        .InitLength   = 1,
+        .WriteEvent   = TXW51_SERV_DIS_EVT_DISABLE_TIMER
+    }, {
+        /* All of the above and the sensor settings in one value, see app/device_info.h. */
+        .Uuid         = TXW51_SERV_DIS_UUID_CHAR_SNAPSHOT,
+        .Flags        = TXW51_SERV_CHAR_READ | TXW51_SERV_CHAR_READ_AUTH | TXW51_SERV_CHAR_VLEN,
+        .MaxLength    = TXW51_SERV_DIS_SNAPSHOT_MAX_LENGTH,
+        .HandleOffset = offsetof(struct TXW51_SERV_DIS_Handle, CharHandle_Snapshot),
+        .InitOffset   = TXW51_SERV_NO_INIT,
+        .InitLength   = 0,
+        .ReadEvent    = TXW51_SERV_DIS_EVT_READ_SNAPSHOT,
+        .UserValue    = snapshotValue
+    }
+};
+
+static const struct TXW51_SERV_Table disTable = TXW51_SERV_TABLE(disChars);  /**< Table of the service. */
 
 /*----- Implementation -------------------------------------------------------*/
 
@@ -69,7 +140,7 @@ uint32_t TXW51_SERV_DIS_Init(struct TXW51_SERV_DIS_Handle *handle,
         return err;
     }
 
-    err = SERV_DIS_AddAllChars(handle, init);
+    err = TXW51_SERV_AddTable(&handle->ServiceHandle, &disTable, init);
     if (err != ERR_NONE) {
         TXW51_LOG_ERROR("[DIS Service] Could not create all characteristics.");
         return err;
@@ -98,6 +169,10 @@ void TXW51_SERV_DIS_OnBleEvent(struct TXW51_SERV_DIS_Handle *handle,
             SERV_DIS_OnWrite(handle, bleEvent);
             break;
 
+        case BLE_GATTS_EVT_RW_AUTHORIZE_REQUEST:
+            SERV_DIS_OnRwAuthRequest(handle, bleEvent);
+            break;
+
         default:
             // No implementation needed.
             break;
@@ -152,33 +227,7 @@ static void SERV_DIS_OnWrite(struct TXW51_SERV_DIS_Handle *handle,
     }
 
     struct TXW51_SERV_DIS_Event evt;
-    evt.EventType = TXW51_SERV_DIS_EVT_UNKNOWN;
-
-    if (writeEvt->handle == handle->CharHandle_Manufacturer.value_handle) {
-        evt.EventType = TXW51_SERV_DIS_EVT_UPDATE_MANUFACTURER;
-
-    } else if (writeEvt->handle == handle->CharHandle_Model.value_handle) {
-        evt.EventType = TXW51_SERV_DIS_EVT_UPDATE_MODEL;
-
-    } else if (writeEvt->handle == handle->CharHandle_Serial.value_handle) {
-        evt.EventType = TXW51_SERV_DIS_EVT_UPDATE_SERIAL;
-
-    } else if (writeEvt->handle == handle->CharHandle_HwRev.value_handle) {
-        evt.EventType = TXW51_SERV_DIS_EVT_UPDATE_HW_REV;
-
-    } else if (writeEvt->handle == handle->CharHandle_FwRev.value_handle) {
-        evt.EventType = TXW51_SERV_DIS_EVT_UPDATE_FW_REV;
-
-    } else if (writeEvt->handle == handle->CharHandle_DeviceName.value_handle) {
-        evt.EventType = TXW51_SERV_DIS_EVT_UPDATE_DEVICE_NAME;
-
-    } else if (writeEvt->handle == handle->CharHandle_SaveValues.value_handle) {
-        evt.EventType = TXW51_SERV_DIS_EVT_SAVE_VALUES;
-
-    }else if (writeEvt->handle == handle->CharHandle_DisableTimer.value_handle) {
-        evt.EventType = TXW51_SERV_DIS_EVT_DISABLE_TIMER;
-
-    }
+    evt.EventType = TXW51_SERV_FindWriteEvent(&handle->ServiceHandle, &disTable, writeEvt);
 
     if (evt.EventType != TXW51_SERV_DIS_EVT_UNKNOWN) {
         evt.Length = writeEvt->len + 1;
@@ -193,194 +242,46 @@ static void SERV_DIS_OnWrite(struct TXW51_SERV_DIS_Handle *handle,
 
 
 /***************************************************************************//**
-* @brief Adds all the different characteristics to the service.
+* @brief Handles the read authorization request of the snapshot.
 *
-* @param[in,out] serviceHandle The handle for the service.
-* @param[in]     init          Structure with the initialization values.
-* @return ERR_NONE if no error occurred.
-*         ERR_BLE_SERVICE_ADD_CHARACTERISTIC if characteristic could not be
-*                                            added.
+* The snapshot is taken by the application when the read starts at offset 0.
+* The blob reads of a long read get the stored value, so all parts belong to
+* the same snapshot.
+*
+* @param[in,out] handle   The handle for the service.
+* @param[in]     bleEvent The BLE event that occurred.
+* @return Nothing.
 ******************************************************************************/
-static uint32_t SERV_DIS_AddAllChars(struct TXW51_SERV_DIS_Handle *serviceHandle,
-                                     const struct TXW51_SERV_DIS_Init *init)
+static void SERV_DIS_OnRwAuthRequest(struct TXW51_SERV_DIS_Handle *handle,
+                                     ble_evt_t *bleEvent)
 {
+    ble_gatts_evt_rw_authorize_request_t *authRequest = &bleEvent->evt.gatts_evt.params.authorize_request;
+    uint16_t connHandle = bleEvent->evt.gatts_evt.conn_handle;
     uint32_t err;
 
-    err = SERV_DIS_AddChar(serviceHandle,
-                           TXW51_SERV_DIS_UUID_CHAR_MANUFACTURER,
-                           init->String_Manufacturer,
-                           TXW51_SERV_DIS_STRING_CHAR_MANUFACTURER,
-                           &serviceHandle->CharHandle_Manufacturer);
-    if (err != ERR_NONE) {
-        return err;
-    }
-
-    err = SERV_DIS_AddChar(serviceHandle,
-                           TXW51_SERV_DIS_UUID_CHAR_MODEL,
-                           init->String_Model,
-                           TXW51_SERV_DIS_STRING_CHAR_MODEL,
-                           &serviceHandle->CharHandle_Model);
-    if (err != ERR_NONE) {
-        return err;
-    }
-
-    err = SERV_DIS_AddChar(serviceHandle,
-                           TXW51_SERV_DIS_UUID_CHAR_SERIAL,
-                           init->String_Serial,
-                           TXW51_SERV_DIS_STRING_CHAR_SERIAL,
-                           &serviceHandle->CharHandle_Serial);
-    if (err != ERR_NONE) {
-        return err;
+    if (handle->EventHandler == NULL) {
+        return;
     }
 
-    err = SERV_DIS_AddChar(serviceHandle,
-                           TXW51_SERV_DIS_UUID_CHAR_HW_REV,
-                           init->String_HwRev,
-                           TXW51_SERV_DIS_STRING_CHAR_HW_REV,
-                           &serviceHandle->CharHandle_HwRev);
-    if (err != ERR_NONE) {
-        return err;
-    }
+    struct TXW51_SERV_DIS_Event evt;
+    evt.EventType = TXW51_SERV_FindReadEvent(&handle->ServiceHandle, &disTable, authRequest);
 
-    err = SERV_DIS_AddChar(serviceHandle,
-                           TXW51_SERV_DIS_UUID_CHAR_FW_REV,
-                           init->String_FwRev,
-                           TXW51_SERV_DIS_STRING_CHAR_FW_REV,
-                           &serviceHandle->CharHandle_FwRev);
-    if (err != ERR_NONE) {
-        return err;
+    if (evt.EventType != TXW51_SERV_DIS_EVT_READ_SNAPSHOT) {
+        return;
     }
 
-    err = SERV_DIS_AddChar(serviceHandle,
-                           TXW51_SERV_DIS_UUID_CHAR_DEVICE_NAME,
-                           init->String_DeviceName,
-                           TXW51_SERV_DIS_STRING_CHAR_DEVICE_NAME,
-                           &serviceHandle->CharHandle_DeviceName);
-    if (err != ERR_NONE) {
-        return err;
-    }
+    if (authRequest->request.read.offset == 0) {
+        uint8_t snapshot[TXW51_SERV_DIS_SNAPSHOT_MAX_LENGTH];
+        evt.Value = snapshot;
+        evt.Length = 0;
+        handle->EventHandler(handle, &evt);
 
-    err = SERV_DIS_AddChar_SaveValues(serviceHandle);
-    if (err != ERR_NONE) {
-        return err;
+        err = TXW51_SERV_ReplyRead(connHandle, snapshot, evt.Length);
+    } else {
+        err = TXW51_SERV_ReplyReadStored(connHandle);
     }
 
-
-    err = SERV_DIS_AddChar_Timer(serviceHandle);
     if (err != ERR_NONE) {
-        return err;
+        TXW51_LOG_WARNING("[DIS Service] Error Snapshot Read!");
     }
-
-    return ERR_NONE;
-}
-
-
-/***************************************************************************//**
-* @brief Adds a characteristic that contains a string to the service.
-*
-* @param[in,out] serviceHandle The handle for the service.
-* @param[in]     uuid          The two UUID bytes for the characteristic.
-* @param[in]     charValue     The initial string value.
-* @param[in]     description   The user description of the characteristic.
-* @param[out]    charHandle    The handle for the characteristic.
-* @return ERR_NONE if no error occurred.
-*         ERR_BLE_SERVICE_ADD_CHARACTERISTIC if characteristic could not be
-*                                            added.
-******************************************************************************/
-static uint32_t SERV_DIS_AddChar(struct TXW51_SERV_DIS_Handle *serviceHandle,
-                                 uint16_t uuid,
-                                 uint8_t *charValue,
-                                 char *description,
-                                 ble_gatts_char_handles_t *charHandle)
-{
-    struct TXW51_SERV_CharInit charInit;
-
-    /* Initialize characteristic. */
-    TXW51_SERV_InitChar(&serviceHandle->ServiceHandle, uuid, &charInit);
-
-    /* Set up characteristic. */
-    charInit.Metadata.char_props.read  = 1;
-    charInit.Metadata.char_props.write = 1;
-    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&charInit.AttrMetadata.read_perm);
-    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&charInit.AttrMetadata.write_perm);
-
-    /*add_desc_user_description(&charInit, (uint8_t *)description);*/
-
-    uint16_t length = MIN(strlen((char *)charValue), TXW51_SERV_DIS_VALUE_MAX_LENGTH);
-    charInit.Attribute.init_len = length;
-    charInit.Attribute.max_len  = TXW51_SERV_DIS_VALUE_MAX_LENGTH;
-    charInit.Attribute.p_value  = charValue;
-
-    /* Add characteristic. */
-    return TXW51_SERV_AddChar(&serviceHandle->ServiceHandle,
-                              &charInit,
-                              charHandle);
-}
-
-
-/***************************************************************************//**
-* @brief Adds the "Save Values" characteristic to the service.
-*
-* @param[in,out] serviceHandle The handle for the service.
-* @return ERR_NONE if no error occurred.
-*         ERR_BLE_SERVICE_ADD_CHARACTERISTIC if characteristic could not be
-*                                            added.
-******************************************************************************/
-static uint32_t SERV_DIS_AddChar_SaveValues(struct TXW51_SERV_DIS_Handle *serviceHandle)
-{
-    struct TXW51_SERV_CharInit charInit;
-
-    /* Initialize characteristic. */
-    TXW51_SERV_InitChar(&serviceHandle->ServiceHandle,
-                      TXW51_SERV_DIS_UUID_CHAR_SAVE_VALUES, &charInit);
-
-    /* Set up characteristic. */
-    charInit.Metadata.char_props.read  = 0;
-    charInit.Metadata.char_props.write = 1;
-    BLE_GAP_CONN_SEC_MODE_SET_NO_ACCESS(&charInit.AttrMetadata.read_perm);
-    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&charInit.AttrMetadata.write_perm);
-
-    /*add_desc_user_description(&charInit, (uint8_t *)TXW51_SERV_DIS_STRING_CHAR_SAVE_VALUES);*/
-
-    charInit.Attribute.init_len = 1;
-    charInit.Attribute.max_len  = 1;
-
-    /* Add characteristic. */
-    return TXW51_SERV_AddChar(&serviceHandle->ServiceHandle,
-                              &charInit,
-                              &serviceHandle->CharHandle_SaveValues);
-}
-
-/***************************************************************************//**
-* @brief Adds the "Disable Timer" characteristic to the service.
-*
-* @param[in,out] serviceHandle The handle for the service.
-* @return ERR_NONE if no error occurred.
-*         ERR_BLE_SERVICE_ADD_CHARACTERISTIC if characteristic could not be
-*                                            added.
-******************************************************************************/
-static uint32_t SERV_DIS_AddChar_Timer(struct TXW51_SERV_DIS_Handle *serviceHandle)
-{
-    struct TXW51_SERV_CharInit charInit;
-
-    /* Initialize characteristic. */
-    TXW51_SERV_InitChar(&serviceHandle->ServiceHandle,
-                      TXW51_SERV_DIS_UUID_CHAR_DISABLE_TIMER, &charInit);
-
-    /* Set up characteristic. */
-    charInit.Metadata.char_props.read  = 1;
-    charInit.Metadata.char_props.write = 1;
-    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&charInit.AttrMetadata.read_perm);
-    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&charInit.AttrMetadata.write_perm);
-
-    /*add_desc_user_description(&charInit, (uint8_t *)TXW51_SERV_DIS_STRING_CHAR_DISABLE_TIMER);*/
-
-    charInit.Attribute.init_len = 1;
-    charInit.Attribute.max_len  = 1;
-    charInit.Attribute.p_value = 0;
-
-    /* Add characteristic. */
-    return TXW51_SERV_AddChar(&serviceHandle->ServiceHandle,
-                              &charInit,
-                              &serviceHandle->CharHandle_DisableTimer);
 }
@@ -22,6 +22,7 @@
 /*----- Macros ---------------------------------------------------------------*/
 /* TODO: Set globally once. */
 #define TXW51_SERV_DIS_VALUE_MAX_LENGTH     ( 20 )      /**< Maximum length of a device information string. */
+#define TXW51_SERV_DIS_SNAPSHOT_MAX_LENGTH  ( 160 )     /**< Maximum length of the snapshot, see app/device_info.h. */
 
 /*----- Data types -----------------------------------------------------------*/
 /**
@@ -36,7 +37,8 @@ enum TXW51_SERV_DIS_EventType {
     TXW51_SERV_DIS_EVT_UPDATE_FW_REV,       /**< Firmware revision string has been changed. */
     TXW51_SERV_DIS_EVT_UPDATE_DEVICE_NAME,  /**< Device name string has been changed. */
     TXW51_SERV_DIS_EVT_SAVE_VALUES,         /**< User wants the currents string to be saved. */
-    TXW51_SERV_DIS_EVT_DISABLE_TIMER		/**< User deactivate power save mode. */
+    TXW51_SERV_DIS_EVT_DISABLE_TIMER,		/**< User deactivate power save mode. */
+    TXW51_SERV_DIS_EVT_READ_SNAPSHOT        /**< The snapshot is read, the application fills Value and sets Length. */
 };
 
 /**
@@ -88,6 +90,7 @@ struct TXW51_SERV_DIS_Handle {
     ble_gatts_char_handles_t      CharHandle_DeviceName;    /**< Handle of the Device name characteristic. */
     ble_gatts_char_handles_t      CharHandle_SaveValues;    /**< Handle of the Save values characteristic. */
     ble_gatts_char_handles_t	  CharHandle_DisableTimer;	/**< Handle of the Disable Timer characteristic. */
+    ble_gatts_char_handles_t      CharHandle_Snapshot;      /**< Handle of the Snapshot characteristic. */
     TXW51_SERV_DIS_EventHandler_t EventHandler;             /**< Callback to the application. */
 };
 
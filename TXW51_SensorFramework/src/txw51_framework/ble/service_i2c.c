@@ -36,15 +36,76 @@ static void SERV_I2C_OnDisconnect(struct TXW51_SERV_I2C_Handle *handle,
 static void SERV_I2C_OnWrite(struct TXW51_SERV_I2C_Handle *handle,
                                 ble_evt_t *bleEvent);
 static void SERV_I2C_OnRwAuthRequest(struct TXW51_SERV_I2C_Handle *handle,
-                                        ble_evt_t *bleEvent);
-static uint32_t SERV_I2C_AddAllChars(struct TXW51_SERV_I2C_Handle *serviceHandle);
-static uint32_t SERV_I2C_AddChar(struct TXW51_SERV_I2C_Handle *serviceHandle,
-                                    uint16_t uuid,
-                                    uint8_t charValue,
-                                    char *description,
-                                    ble_gatts_char_handles_t *charHandle);
-static uint32_t SERV_I2C_AddValueChar(struct TXW51_SERV_I2C_Handle *serviceHandle);
+                                     ble_evt_t *bleEvent);
+static uint32_t SERV_I2C_Notify(struct TXW51_SERV_I2C_Handle *handle,
+                                uint16_t valueHandle,
+                                uint8_t *data,
+                                uint16_t length);
+
+/*----- Data -----------------------------------------------------------------*/
+/**
+ * @brief The characteristics of the service.
+ */
+static const struct TXW51_SERV_CharDef i2cChars[] = {
+    {
+        .Uuid         = SERVICE_I2C_UUID_CHAR_ADDRESS,
+        .Flags        = TXW51_SERV_CHAR_READ | TXW51_SERV_CHAR_WRITE,
+        .MaxLength    = 1,
+        .HandleOffset = offsetof(struct TXW51_SERV_I2C_Handle, CharHandle_I2CAddress),
+        .InitOffset   = TXW51_SERV_NO_INIT,
+        .InitLength   = 1,
+        .WriteEvent   = TXW51_SERV_I2C_EVT_ADRESS
+    }, {
+        .Uuid         = SERVICE_I2C_UUID_CHAR_REGISTER,
+        .Flags        = TXW51_SERV_CHAR_READ | TXW51_SERV_CHAR_WRITE,
+        .MaxLength    = 1,
+        .HandleOffset = offsetof(struct TXW51_SERV_I2C_Handle, CharHandle_I2CRegister),
+        .InitOffset   = TXW51_SERV_NO_INIT,
+        .InitLength   = 1,
+        .WriteEvent   = TXW51_SERV_I2C_EVT_REGISTER
+    }, {
+        .Uuid         = SERVICE_I2C_UUID_CHAR_LENGTH,
+        .Flags        = TXW51_SERV_CHAR_READ | TXW51_SERV_CHAR_WRITE,
+        .MaxLength    = 1,
+        .HandleOffset = offsetof(struct TXW51_SERV_I2C_Handle, CharHandle_I2CLength),
+        .InitOffset   = TXW51_SERV_NO_INIT,
+        .InitLength   = 1,
+        .InitValue    = 1,
+        .WriteEvent   = TXW51_SERV_I2C_EVT_VALUE_LENGTH
+    }, {
+        .Uuid         = SERVICE_I2C_UUID_CHAR_REGISTER_VALUE,
+        .Flags        = TXW51_SERV_CHAR_READ | TXW51_SERV_CHAR_WRITE |
+                        TXW51_SERV_CHAR_READ_AUTH | TXW51_SERV_CHAR_VLEN,
+        .MaxLength    = TXW51_SERV_I2C_VALUE_MAX_LENGTH,
+        .HandleOffset = offsetof(struct TXW51_SERV_I2C_Handle, CharHandle_I2CValue),
+        .InitOffset   = TXW51_SERV_NO_INIT,
+        .InitLength   = 1,
+        .WriteEvent   = TXW51_SERV_I2C_EVT_VALUE_WRITE,
+        .ReadEvent    = TXW51_SERV_I2C_EVT_VALUE_READ
+    }, {
+        /* The result of the last script can be read or is notified. */
+        .Uuid         = SERVICE_I2C_UUID_CHAR_SCRIPT,
+        .Flags        = TXW51_SERV_CHAR_READ | TXW51_SERV_CHAR_WRITE |
+                        TXW51_SERV_CHAR_NOTIFY | TXW51_SERV_CHAR_VLEN,
+        .MaxLength    = TXW51_SERV_I2C_SCRIPT_MAX_LENGTH,
+        .HandleOffset = offsetof(struct TXW51_SERV_I2C_Handle, CharHandle_I2CScript),
+        .InitOffset   = TXW51_SERV_NO_INIT,
+        .InitLength   = 0,
+        .WriteEvent   = TXW51_SERV_I2C_EVT_SCRIPT
+    }, {
+        /* The results of the polling job are notified. */
+        .Uuid         = SERVICE_I2C_UUID_CHAR_POLL,
+        .Flags        = TXW51_SERV_CHAR_READ | TXW51_SERV_CHAR_WRITE |
+                        TXW51_SERV_CHAR_NOTIFY | TXW51_SERV_CHAR_VLEN,
+        .MaxLength    = TXW51_SERV_I2C_SCRIPT_MAX_LENGTH,
+        .HandleOffset = offsetof(struct TXW51_SERV_I2C_Handle, CharHandle_I2CPoll),
+        .InitOffset   = TXW51_SERV_NO_INIT,
+        .InitLength   = 0,
+        .WriteEvent   = TXW51_SERV_I2C_EVT_POLL
+    }
+};
 
+static const struct TXW51_SERV_Table i2cTable = TXW51_SERV_TABLE(i2cChars);  /**< Table of the service. */
 
 /*----- Implementation -------------------------------------------------------*/
 
@@ -66,7 +127,7 @@ uint32_t TXW51_SERV_I2C_Init(struct TXW51_SERV_I2C_Handle *handle,
         return err;
     }
 
-    err = SERV_I2C_AddAllChars(handle);
+    err = TXW51_SERV_AddTable(&handle->ServiceHandle, &i2cTable, NULL);
     if (err != ERR_NONE) {
         TXW51_LOG_ERROR("[I2C Service] Could not create all characteristics.");
         return err;
@@ -107,6 +168,93 @@ void TXW51_SERV_I2C_OnBleEvent(struct TXW51_SERV_I2C_Handle *handle,
 }
 
 
+uint32_t TXW51_SERV_I2C_SendScriptResult(struct TXW51_SERV_I2C_Handle *handle,
+                                         uint8_t *result,
+                                         uint16_t length)
+{
+    uint32_t err;
+    uint16_t valueLength = length;
+
+    err = sd_ble_gatts_value_set(handle->CharHandle_I2CScript.value_handle,
+                                 0,
+                                 &valueLength,
+                                 result);
+    if (err != NRF_SUCCESS) {
+        TXW51_LOG_WARNING("[I2C Service] Could not store script result.");
+        return ERR_SERVICE_I2C_HVX_COULD_NOT_SEND;
+    }
+
+    if (handle->ServiceHandle.ConnHandle == BLE_CONN_HANDLE_INVALID) {
+        return ERR_NONE;
+    }
+
+    err = SERV_I2C_Notify(handle,
+                          handle->CharHandle_I2CScript.value_handle,
+                          result,
+                          length);
+    if (err == ERR_SERVICE_I2C_CCCD_NOT_ENABLED) {
+        /* Notifications are disabled, the peer reads the result instead. */
+        return ERR_NONE;
+    }
+
+    return err;
+}
+
+
+uint32_t TXW51_SERV_I2C_SendPollResult(struct TXW51_SERV_I2C_Handle *handle,
+                                       uint8_t *result,
+                                       uint16_t length)
+{
+    if (handle->ServiceHandle.ConnHandle == BLE_CONN_HANDLE_INVALID) {
+        return ERR_BLE_SERVICE_NO_CONNECTION;
+    }
+
+    return SERV_I2C_Notify(handle,
+                           handle->CharHandle_I2CPoll.value_handle,
+                           result,
+                           length);
+}
+
+
+/***************************************************************************//**
+* @brief Sends a notification of a characteristic to the connected peer.
+*
+* @param[in] handle      The handle for the service.
+* @param[in] valueHandle The value handle of the characteristic.
+* @param[in] data        The data to send.
+* @param[in] length      Length of the data in bytes.
+* @return ERR_NONE if no error occurred.
+*         ERR_SERVICE_I2C_CCCD_NOT_ENABLED if the CCCD is not enabled.
+*         ERR_SERVICE_I2C_HVX_COULD_NOT_SEND if the notification failed.
+******************************************************************************/
+static uint32_t SERV_I2C_Notify(struct TXW51_SERV_I2C_Handle *handle,
+                                uint16_t valueHandle,
+                                uint8_t *data,
+                                uint16_t length)
+{
+    uint32_t err;
+
+    ble_gatts_hvx_params_t hvxParams;
+    memset(&hvxParams, 0, sizeof(hvxParams));
+
+    hvxParams.handle = valueHandle;
+    hvxParams.type   = BLE_GATT_HVX_NOTIFICATION;
+    hvxParams.offset = 0;
+    hvxParams.p_len  = &length;
+    hvxParams.p_data = data;
+
+    err = sd_ble_gatts_hvx(handle->ServiceHandle.ConnHandle, &hvxParams);
+    if (err == NRF_ERROR_INVALID_STATE) {
+        return ERR_SERVICE_I2C_CCCD_NOT_ENABLED;
+    } else if (err != NRF_SUCCESS) {
+        TXW51_LOG_WARNING("[I2C Service] Could not send notification.");
+        return ERR_SERVICE_I2C_HVX_COULD_NOT_SEND;
+    }
+
+    return ERR_NONE;
+}
+
+
 /***************************************************************************//**
 * @brief Handles the connection event.
 *
@@ -132,6 +280,14 @@ static void SERV_I2C_OnDisconnect(struct TXW51_SERV_I2C_Handle *handle,
                                      ble_evt_t *bleEvent)
 {
     TXW51_LOG_DEBUG("[I2C Service] Disconnected");
+
+    if (handle->EventHandler != NULL) {
+        struct TXW51_SERV_I2C_Event evt;
+        evt.EventType = TXW51_SERV_I2C_EVT_DISCONNECTED;
+        evt.Value     = NULL;
+        evt.Length    = 0;
+        handle->EventHandler(handle, &evt);
+    }
 }
 
 
@@ -151,21 +307,7 @@ static void SERV_I2C_OnWrite(struct TXW51_SERV_I2C_Handle *handle,
 
 	if (handle->EventHandler != NULL) {
 	    struct TXW51_SERV_I2C_Event evt;
-	    evt.EventType = TXW51_SERV_I2C_EVT_UNKNOWN;
-
-	    if (evtWrite->handle == handle->CharHandle_I2CValue.value_handle) {
-	        evt.EventType = TXW51_SERV_I2C_EVT_VALUE_WRITE;
-
-	    } else if (evtWrite->handle == handle->CharHandle_I2CAddress.value_handle) {
-            evt.EventType = TXW51_SERV_I2C_EVT_ADRESS;
-
-	    } else if (evtWrite->handle == handle->CharHandle_I2CRegister.value_handle) {
-            evt.EventType = TXW51_SERV_I2C_EVT_REGISTER;
-
-	    } else if (evtWrite->handle == handle->CharHandle_I2CLength.value_handle) {
-            evt.EventType = TXW51_SERV_I2C_EVT_VALUE_LENGTH;
-
-	    }
+	    evt.EventType = TXW51_SERV_FindWriteEvent(&handle->ServiceHandle, &i2cTable, evtWrite);
 
 	    TXW51_LOG_DEBUG("[I2C Service] On Write");
 
@@ -191,15 +333,16 @@ static void SERV_I2C_OnWrite(struct TXW51_SERV_I2C_Handle *handle,
 /***************************************************************************//**
 * @brief Handles the read/write authorization request.
 *
-* Detects which characteristic has been read, notifies the application and
-* allows the request. This can be used to act on characteristics reads.
+* Detects which characteristic has been read and notifies the application.
+* The application answers the request with TXW51_SERV_I2C_ReplyValueRead()
+* as soon as the value has been read from the I2C device.
 *
 * @param[in,out] handle   The handle for the service.
 * @param[in]     bleEvent The BLE event that occurred.
 * @return Nothing.
 ******************************************************************************/
-void SERV_I2C_OnRwAuthRequest(struct TXW51_SERV_I2C_Handle *handle,
-                                 ble_evt_t *bleEvent)
+static void SERV_I2C_OnRwAuthRequest(struct TXW51_SERV_I2C_Handle *handle,
+                                     ble_evt_t *bleEvent)
 {
     ble_gatts_evt_rw_authorize_request_t *authRequest = &bleEvent->evt.gatts_evt.params.authorize_request;
 
@@ -207,174 +350,35 @@ void SERV_I2C_OnRwAuthRequest(struct TXW51_SERV_I2C_Handle *handle,
 
     if (handle->EventHandler != NULL) {
         struct TXW51_SERV_I2C_Event evt;
+        evt.EventType = TXW51_SERV_FindReadEvent(&handle->ServiceHandle, &i2cTable, authRequest);
 
-        if ((authRequest->type = BLE_GATTS_AUTHORIZE_TYPE_READ) &&
-            (authRequest->request.read.handle == handle->CharHandle_I2CValue.value_handle)) {
-            uint32_t err;
-
-            /* Handle event. */
-            uint8_t tempValue [TXW51_SERV_I2C_VALUE_MAX_LENGTH];
-            uint8_t i;
-            for (i = 0; i < TXW51_SERV_I2C_VALUE_MAX_LENGTH; i++)
-            {
-            	tempValue[i] = 0;
-            }
-            evt.EventType = TXW51_SERV_I2C_EVT_VALUE_READ;
-            evt.Value = tempValue;
+        if (evt.EventType == TXW51_SERV_I2C_EVT_VALUE_READ) {
+            evt.Value = NULL;
+            evt.Length = 0;
             handle->EventHandler(handle, &evt);
 
-
             TXW51_LOG_DEBUG("[I2C Service] I2C Value Read Event");
-
-            /* Reply to peer. */
-            ble_gatts_rw_authorize_reply_params_t reply;
-            reply.type = BLE_GATTS_AUTHORIZE_TYPE_READ;
-            reply.params.read.gatt_status = BLE_GATT_STATUS_SUCCESS;
-            reply.params.read.p_data = tempValue;
-            reply.params.read.len = evt.Length;
-            reply.params.read.update = 1;
-            reply.params.read.offset = 0;
-
-            err = sd_ble_gatts_rw_authorize_reply(bleEvent->evt.gatts_evt.conn_handle, &reply);
-            if (err != NRF_SUCCESS) {
-                TXW51_LOG_WARNING("[I2C Service] Error I2C Value Read!");
-            }
         }
     }
 }
 
 
-/***************************************************************************//**
-* @brief Adds all the different characteristics to the service.
-*
-* @param[in,out] serviceHandle The handle for the service.
-* @return ERR_NONE if no error occurred.
-*         ERR_BLE_SERVICE_ADD_CHARACTERISTIC if characteristic could not be
-*                                            added.
-******************************************************************************/
-static uint32_t SERV_I2C_AddAllChars(struct TXW51_SERV_I2C_Handle *serviceHandle)
+uint32_t TXW51_SERV_I2C_ReplyValueRead(struct TXW51_SERV_I2C_Handle *handle,
+                                       uint8_t *value,
+                                       uint16_t length)
 {
     uint32_t err;
 
-    err = SERV_I2C_AddChar(serviceHandle,
-                              SERVICE_I2C_UUID_CHAR_ADDRESS,
-                              0,
-                              SERVICE_I2C_STRING_CHAR_ADDRESS,
-                              &serviceHandle->CharHandle_I2CAddress);
-    if (err != ERR_NONE) {
-        return err;
+    if (handle->ServiceHandle.ConnHandle == BLE_CONN_HANDLE_INVALID) {
+        return ERR_BLE_SERVICE_NO_CONNECTION;
     }
 
-	err = SERV_I2C_AddChar(serviceHandle,
-							  SERVICE_I2C_UUID_CHAR_REGISTER,
-							  0,
-							  SERVICE_I2C_STRING_CHAR_REGISTER,
-							  &serviceHandle->CharHandle_I2CRegister);
-	if (err != ERR_NONE) {
-		return err;
-	}
-
-
-	err = SERV_I2C_AddChar(serviceHandle,
-							  SERVICE_I2C_UUID_CHAR_LENGTH,
-							  1,
-							  SERVICE_I2C_STRING_CHAR_LENGTH,
-							  &serviceHandle->CharHandle_I2CLength);
-	if (err != ERR_NONE) {
-		return err;
-	}
-
-    err = SERV_I2C_AddValueChar(serviceHandle);
+    /* Reply to peer. */
+    err = TXW51_SERV_ReplyRead(handle->ServiceHandle.ConnHandle, value, length);
     if (err != ERR_NONE) {
-		return err;
+        TXW51_LOG_WARNING("[I2C Service] Error I2C Value Read!");
+        return ERR_I2C_READ_FAILED;
     }
 
     return ERR_NONE;
 }
-
-
-/***************************************************************************//**
-* @brief Adds a characteristic that contains a 1 byte value to the service.
-*
-* @param[in,out] serviceHandle The handle for the service.
-* @param[in]     uuid          The two UUID bytes for the characteristic.
-* @param[in]     charValue     The initial value.
-* @param[in]     description   The user description of the characteristic.
-* @param[out]    charHandle    The handle for the characteristic.
-* @return ERR_NONE if no error occurred.
-*         ERR_BLE_SERVICE_ADD_CHARACTERISTIC if characteristic could not be
-*                                            added.
-******************************************************************************/
-static uint32_t SERV_I2C_AddChar(struct TXW51_SERV_I2C_Handle *serviceHandle,
-                                    uint16_t uuid,
-                                    uint8_t charValue,
-                                    char *description,
-                                    ble_gatts_char_handles_t *charHandle)
-{
-    struct TXW51_SERV_CharInit charInit;
-
-    /* Initialize characteristic. */
-    TXW51_SERV_InitChar(&serviceHandle->ServiceHandle,
-    					uuid,
-                        &charInit);
-
-    /* Set up characteristic. */
-    charInit.Metadata.char_props.read  = 1;
-    charInit.Metadata.char_props.write = 1;
-    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&charInit.AttrMetadata.read_perm);
-    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&charInit.AttrMetadata.write_perm);
-
-    /*add_desc_user_description(&charInit, (uint8_t *)description);*/
-
-    charInit.Attribute.init_len = 1;
-    charInit.Attribute.max_len  = 1;
-    charInit.Attribute.p_value  = &charValue;
-
-    /* Add characteristic. */
-    return TXW51_SERV_AddChar(&serviceHandle->ServiceHandle,
-                              &charInit,
-                              charHandle);
-}
-
-
-/***************************************************************************//**
-* @brief Adds a characteristic that contains a 1 byte value to the service.
-*
-* @param[in,out] serviceHandle The handle for the service.
-* @param[in]     uuid          The two UUID bytes for the characteristic.
-* @param[in]     charValue     The initial value.
-* @param[in]     description   The user description of the characteristic.
-* @param[out]    charHandle    The handle for the characteristic.
-* @return ERR_NONE if no error occurred.
-*         ERR_BLE_SERVICE_ADD_CHARACTERISTIC if characteristic could not be
-*                                            added.
-******************************************************************************/
-static uint32_t SERV_I2C_AddValueChar(struct TXW51_SERV_I2C_Handle *serviceHandle)
-{
-    struct TXW51_SERV_CharInit charInit;
-
-    /* Initialize characteristic. */
-    TXW51_SERV_InitChar(&serviceHandle->ServiceHandle,
-    					SERVICE_I2C_UUID_CHAR_REGISTER_VALUE,
-                        &charInit);
-
-    /* Set up characteristic. */
-    charInit.Metadata.char_props.read  = 1;
-    charInit.Metadata.char_props.write = 1;
-    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&charInit.AttrMetadata.read_perm);
-    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&charInit.AttrMetadata.write_perm);
-
-    charInit.AttrMetadata.rd_auth = 1;
-
-    /*add_desc_user_description(&charInit, (uint8_t *)SERVICE_I2C_STRING_CHAR_REGISTER_VALUE);*/
-
-    charInit.Attribute.init_len = 1;
-    charInit.Attribute.max_len  = TXW51_SERV_I2C_VALUE_MAX_LENGTH;
-    charInit.Attribute.p_value  = 0;
-    charInit.AttrMetadata.vlen  = 1;
-
-    /* Add characteristic. */
-    return TXW51_SERV_AddChar(&serviceHandle->ServiceHandle,
-                              &charInit,
-                              &serviceHandle->CharHandle_I2CValue);
-}
@@ -21,6 +21,30 @@
 
 /*----- Macros ---------------------------------------------------------------*/
 #define TXW51_SERV_I2C_VALUE_MAX_LENGTH     ( 10 )      /**< Maximum length of a device I2C Value */
+#define TXW51_SERV_I2C_SCRIPT_MAX_LENGTH    ( 20 )      /**< Maximum length of a script and of its result (default ATT MTU payload). */
+
+/*
+ * A script is a packed list of operations. Each operation starts with a
+ * three byte header: [read flag | 7 bit address] [register] [length].
+ * Write operations are followed by <length> data bytes.
+ */
+#define TXW51_SERV_I2C_SCRIPT_OP_READ       ( 0x80 )    /**< Flag in the address byte that marks a read operation. */
+#define TXW51_SERV_I2C_SCRIPT_ADDR_Msk      ( 0x7F )    /**< Mask of the 7 bit device address in the address byte. */
+#define TXW51_SERV_I2C_SCRIPT_OP_HEADER_LEN ( 3 )       /**< Length of an operation header in bytes. */
+
+/*
+ * The result is [status] [number of executed operations] followed by the
+ * concatenated data of all read operations.
+ */
+#define TXW51_SERV_I2C_SCRIPT_RESULT_HEADER_LEN ( 2 )   /**< Length of the result header in bytes. */
+
+/*
+ * A polling job is [period LSB] [period MSB] [flags] followed by a script.
+ * The period is given in milliseconds, a period of 0 stops the job. The
+ * results are notified on the poll characteristic in the script result format.
+ */
+#define TXW51_SERV_I2C_POLL_HEADER_LEN      ( 3 )       /**< Length of the polling job header in bytes. */
+#define TXW51_SERV_I2C_POLL_FLAG_ON_CHANGE  ( 0x01 )    /**< Only notify a result if it differs from the previous one. */
 /*----- Data types -----------------------------------------------------------*/
 /**
  * @brief The different event types that the service signals to the application.
@@ -29,10 +53,24 @@ enum TXW51_SERV_I2C_EventType {
     TXW51_SERV_I2C_EVT_UNKNOWN,      			/**< The event isn't known. Maybe from a damaged package. */
     TXW51_SERV_I2C_EVT_ADRESS,   				/**< Set the address of the I2C device */
     TXW51_SERV_I2C_EVT_REGISTER,				/**< Set the register of the I2C device to write/read */
-    TXW51_SERV_I2C_EVT_VALUE_READ,				/**< Read the value from specified I2C device */
+    TXW51_SERV_I2C_EVT_VALUE_READ,				/**< Read the value from specified I2C device, answer with TXW51_SERV_I2C_ReplyValueRead() */
     TXW51_SERV_I2C_EVT_VALUE_WRITE,				/**< Write the value to specified I2C device */
-    TXW51_SERV_I2C_EVT_VALUE_LENGTH				/**< Number of Bytes for the value to read */
+    TXW51_SERV_I2C_EVT_VALUE_LENGTH,			/**< Number of Bytes for the value to read */
+    TXW51_SERV_I2C_EVT_SCRIPT,					/**< Execute a packed list of I2C operations */
+    TXW51_SERV_I2C_EVT_POLL,					/**< Start or stop a periodic polling job */
+    TXW51_SERV_I2C_EVT_DISCONNECTED				/**< The peer has disconnected */
+
+};
 
+/**
+ * @brief The status codes that are returned in the first byte of a script result.
+ */
+enum TXW51_SERV_I2C_ScriptStatus {
+    TXW51_SERV_I2C_SCRIPT_STATUS_OK,            /**< All operations have been executed. */
+    TXW51_SERV_I2C_SCRIPT_STATUS_I2C_ERROR,     /**< An operation failed on the bus. */
+    TXW51_SERV_I2C_SCRIPT_STATUS_MALFORMED,     /**< The script could not be parsed. */
+    TXW51_SERV_I2C_SCRIPT_STATUS_OVERFLOW,      /**< The read data does not fit into the result. */
+    TXW51_SERV_I2C_SCRIPT_STATUS_BUSY           /**< The previous script is still running. */
 };
 
 /**
@@ -73,6 +111,8 @@ struct TXW51_SERV_I2C_Handle {
     ble_gatts_char_handles_t    CharHandle_I2CAddress;	      	/**< Handle of the I2C characteristic. */
     ble_gatts_char_handles_t    CharHandle_I2CRegister;	      	/**< Handle of the I2C characteristic. */
     ble_gatts_char_handles_t    CharHandle_I2CLength;	      	/**< Handle of the I2C characteristic. */
+    ble_gatts_char_handles_t    CharHandle_I2CScript;	      	/**< Handle of the I2C script characteristic. */
+    ble_gatts_char_handles_t    CharHandle_I2CPoll;	      		/**< Handle of the I2C poll characteristic. */
     TXW51_SERV_I2C_EventHandler_t EventHandler;    				/**< Callback to the application. */
 };
 
@@ -105,6 +145,55 @@ extern uint32_t TXW51_SERV_I2C_Init(struct TXW51_SERV_I2C_Handle *handle,
 extern void TXW51_SERV_I2C_OnBleEvent(struct TXW51_SERV_I2C_Handle *handle,
                                          ble_evt_t *bleEvent);
 
+/***************************************************************************//**
+* @brief Answers the pending read request of the value characteristic.
+*
+* The read request is held by the stack until this function is called, so
+* the application can read the I2C device asynchronously.
+*
+* @param[in] handle The handle for the service.
+* @param[in] value  The read value.
+* @param[in] length Length of the value in bytes.
+* @return ERR_NONE if no error occurred.
+*         ERR_BLE_SERVICE_NO_CONNECTION if there is no connection.
+*         ERR_I2C_READ_FAILED if the reply could not be sent.
+******************************************************************************/
+extern uint32_t TXW51_SERV_I2C_ReplyValueRead(struct TXW51_SERV_I2C_Handle *handle,
+                                              uint8_t *value,
+                                              uint16_t length);
+
+/***************************************************************************//**
+* @brief Publishes the result of an I2C script.
+*
+* The result is stored as value of the script characteristic, so that it can
+* be read. If the peer has enabled notifications, it is sent as well.
+*
+* @param[in] handle The handle for the service.
+* @param[in] result The packed script result.
+* @param[in] length Length of the result in bytes.
+* @return ERR_NONE if no error occurred.
+*         ERR_SERVICE_I2C_HVX_COULD_NOT_SEND if the result could not be stored
+*                                            or sent.
+******************************************************************************/
+extern uint32_t TXW51_SERV_I2C_SendScriptResult(struct TXW51_SERV_I2C_Handle *handle,
+                                                uint8_t *result,
+                                                uint16_t length);
+
+/***************************************************************************//**
+* @brief Notifies the result of a polling job.
+*
+* @param[in] handle The handle for the service.
+* @param[in] result The packed script result.
+* @param[in] length Length of the result in bytes.
+* @return ERR_NONE if no error occurred.
+*         ERR_BLE_SERVICE_NO_CONNECTION if there is no connection.
+*         ERR_SERVICE_I2C_CCCD_NOT_ENABLED if notifications are disabled.
+*         ERR_SERVICE_I2C_HVX_COULD_NOT_SEND if the result could not be sent.
+******************************************************************************/
+extern uint32_t TXW51_SERV_I2C_SendPollResult(struct TXW51_SERV_I2C_Handle *handle,
+                                              uint8_t *result,
+                                              uint16_t length);
+
 /*----- Data -----------------------------------------------------------------*/
 
 #endif // TXW51_FRAMEWORK_BLE_SERVICE_I2C_H_
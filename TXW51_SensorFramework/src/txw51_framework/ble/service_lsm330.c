@@ -38,16 +38,104 @@ static void SERV_LSM330_OnWrite(struct TXW51_SERV_LSM330_Handle *handle,
                                 ble_evt_t *bleEvent);
 static void SERV_LSM330_OnRwAuthRequest(struct TXW51_SERV_LSM330_Handle *handle,
                                         ble_evt_t *bleEvent);
-static uint32_t SERV_LSM330_AddAllChars(struct TXW51_SERV_LSM330_Handle *serviceHandle);
-static uint32_t SERV_LSM330_AddChar(struct TXW51_SERV_LSM330_Handle *serviceHandle,
-                                    uint16_t uuid,
-                                    uint8_t charValue,
-                                    char *description,
-                                    ble_gatts_char_handles_t *charHandle);
-static uint32_t SERV_LSM330_AddChar_TempSample(struct TXW51_SERV_LSM330_Handle *serviceHandle);
-static uint32_t SERV_LSM330_AddChar_TriggerValue(struct TXW51_SERV_LSM330_Handle *serviceHandle);
 
 /*----- Data -----------------------------------------------------------------*/
+/**
+ * @brief The characteristics of the service.
+ */
+static const struct TXW51_SERV_CharDef lsm330Chars[] = {
+    {
+        .Uuid         = SERVICE_LSM330_UUID_CHAR_ACC_EN,
+        .Flags        = TXW51_SERV_CHAR_READ | TXW51_SERV_CHAR_WRITE,
+        .MaxLength    = 1,
+        .HandleOffset = offsetof(struct TXW51_SERV_LSM330_Handle, CharHandle_AccEnable),
+        .InitOffset   = offsetof(struct TXW51_SERV_LSM330_Init, AccEnable),
+        .InitLength   = 1,
+        .WriteEvent   = TXW51_SERV_LSM330_EVT_ACC_EN
+    }, {
+        .Uuid         = SERVICE_LSM330_UUID_CHAR_GYRO_EN,
+        .Flags        = TXW51_SERV_CHAR_READ | TXW51_SERV_CHAR_WRITE,
+        .MaxLength    = 1,
+        .HandleOffset = offsetof(struct TXW51_SERV_LSM330_Handle, CharHandle_GyroEnable),
+        .InitOffset   = offsetof(struct TXW51_SERV_LSM330_Init, GyroEnable),
+        .InitLength   = 1,
+        .WriteEvent   = TXW51_SERV_LSM330_EVT_GYRO_EN
+    }, {
+        .Uuid         = SERVICE_LSM330_UUID_CHAR_TEMP_SAMPLE,
+        .Flags        = TXW51_SERV_CHAR_READ | TXW51_SERV_CHAR_READ_AUTH,
+        .MaxLength    = 1,
+        .HandleOffset = offsetof(struct TXW51_SERV_LSM330_Handle, CharHandle_TempSample),
+        .InitOffset   = TXW51_SERV_NO_INIT,
+        .InitLength   = 1,
+        .ReadEvent    = TXW51_SERV_LSM330_EVT_TEMP_SAMPLE
+    }, {
+        .Uuid         = SERVICE_LSM330_UUID_CHAR_ACC_FSCALE,
+        .Flags        = TXW51_SERV_CHAR_READ | TXW51_SERV_CHAR_WRITE,
+        .MaxLength    = 1,
+        .HandleOffset = offsetof(struct TXW51_SERV_LSM330_Handle, CharHandle_AccFscale),
+        .InitOffset   = offsetof(struct TXW51_SERV_LSM330_Init, AccFscale),
+        .InitLength   = 1,
+        .WriteEvent   = TXW51_SERV_LSM330_EVT_ACC_FSCALE
+    }, {
+        .Uuid         = SERVICE_LSM330_UUID_CHAR_GYRO_FSCALE,
+        .Flags        = TXW51_SERV_CHAR_READ | TXW51_SERV_CHAR_WRITE,
+        .MaxLength    = 1,
+        .HandleOffset = offsetof(struct TXW51_SERV_LSM330_Handle, CharHandle_GyroFscale),
+        .InitOffset   = offsetof(struct TXW51_SERV_LSM330_Init, GyroFscale),
+        .InitLength   = 1,
+        .WriteEvent   = TXW51_SERV_LSM330_EVT_GYRO_FSCALE
+    }, {
+        .Uuid         = SERVICE_LSM330_UUID_CHAR_ACC_ODR,
+        .Flags        = TXW51_SERV_CHAR_READ | TXW51_SERV_CHAR_WRITE,
+        .MaxLength    = 1,
+        .HandleOffset = offsetof(struct TXW51_SERV_LSM330_Handle, CharHandle_AccOdr),
+        .InitOffset   = offsetof(struct TXW51_SERV_LSM330_Init, AccOdr),
+        .InitLength   = 1,
+        .WriteEvent   = TXW51_SERV_LSM330_EVT_ACC_ODR
+    }, {
+        .Uuid         = SERVICE_LSM330_UUID_CHAR_GYRO_ODR,
+        .Flags        = TXW51_SERV_CHAR_READ | TXW51_SERV_CHAR_WRITE,
+        .MaxLength    = 1,
+        .HandleOffset = offsetof(struct TXW51_SERV_LSM330_Handle, CharHandle_GyroOdr),
+        .InitOffset   = offsetof(struct TXW51_SERV_LSM330_Init, GyroOdr),
+        .InitLength   = 1,
+        .WriteEvent   = TXW51_SERV_LSM330_EVT_GYRO_ODR
+    }, {
+        .Uuid         = SERVICE_LSM330_UUID_CHAR_TRIGGER_VAL,
+        .Flags        = TXW51_SERV_CHAR_READ | TXW51_SERV_CHAR_WRITE,
+        .MaxLength    = 2,
+        .HandleOffset = offsetof(struct TXW51_SERV_LSM330_Handle, CharHandle_TriggerValue),
+        .InitOffset   = TXW51_SERV_NO_INIT,
+        .InitLength   = 1,
+        .WriteEvent   = TXW51_SERV_LSM330_EVT_TRIGGER_VAL
+    }, {
+        .Uuid         = SERVICE_LSM330_UUID_CHAR_TRIGGER_AXIS,
+        .Flags        = TXW51_SERV_CHAR_READ | TXW51_SERV_CHAR_WRITE,
+        .MaxLength    = 1,
+        .HandleOffset = offsetof(struct TXW51_SERV_LSM330_Handle, CharHandle_TriggerAxis),
+        .InitOffset   = TXW51_SERV_NO_INIT,
+        .InitLength   = 1,
+        .WriteEvent   = TXW51_SERV_LSM330_EVT_TRIGGER_AXIS
+    }, {
+        .Uuid         = SERVICE_LSM330_UUID_CHAR_AUTO_START,
+        .Flags        = TXW51_SERV_CHAR_READ | TXW51_SERV_CHAR_WRITE,
+        .MaxLength    = 1,
+        .HandleOffset = offsetof(struct TXW51_SERV_LSM330_Handle, CharHandle_AutoStart),
+        .InitOffset   = offsetof(struct TXW51_SERV_LSM330_Init, AutoStart),
+        .InitLength   = 1,
+        .WriteEvent   = TXW51_SERV_LSM330_EVT_AUTO_START
+    }, {
+        .Uuid         = SERVICE_LSM330_UUID_CHAR_STREAM_MODE,
+        .Flags        = TXW51_SERV_CHAR_READ | TXW51_SERV_CHAR_WRITE,
+        .MaxLength    = 1,
+        .HandleOffset = offsetof(struct TXW51_SERV_LSM330_Handle, CharHandle_StreamMode),
+        .InitOffset   = offsetof(struct TXW51_SERV_LSM330_Init, StreamMode),
+        .InitLength   = 1,
+        .WriteEvent   = TXW51_SERV_LSM330_EVT_STREAM_MODE
+    }
+};
+
+static const struct TXW51_SERV_Table lsm330Table = TXW51_SERV_TABLE(lsm330Chars);   /**< Table of the service. */
 
 /*----- Implementation -------------------------------------------------------*/
 
@@ -69,7 +157,7 @@ uint32_t TXW51_SERV_LSM330_Init(struct TXW51_SERV_LSM330_Handle *handle,
         return err;
     }
 
-    err = SERV_LSM330_AddAllChars(handle);
+    err = TXW51_SERV_AddTable(&handle->ServiceHandle, &lsm330Table, init);
     if (err != ERR_NONE) {
         TXW51_LOG_ERROR("[LSM330 Service] Could not create all characteristics.");
         return err;
@@ -150,44 +238,20 @@ static void SERV_LSM330_OnDisconnect(struct TXW51_SERV_LSM330_Handle *handle,
 static void SERV_LSM330_OnWrite(struct TXW51_SERV_LSM330_Handle *handle,
                                 ble_evt_t *bleEvent)
 {
-	ble_gatts_evt_write_t *evtWrite = &bleEvent->evt.gatts_evt.params.write;
-
-	if (handle->EventHandler != NULL) {
-	    struct TXW51_SERV_LSM330_Event evt;
-	    evt.EventType = TXW51_SERV_LSM330_EVT_UNKNOWN;
-
-	    if (evtWrite->handle == handle->CharHandle_AccEnable.value_handle) {
-	        evt.EventType = TXW51_SERV_LSM330_EVT_ACC_EN;
-
-	    } else if (evtWrite->handle == handle->CharHandle_GyroEnable.value_handle) {
-            evt.EventType = TXW51_SERV_LSM330_EVT_GYRO_EN;
-
-	    } else if (evtWrite->handle == handle->CharHandle_AccFscale.value_handle) {
-            evt.EventType = TXW51_SERV_LSM330_EVT_ACC_FSCALE;
+    ble_gatts_evt_write_t *evtWrite = &bleEvent->evt.gatts_evt.params.write;
 
-	    } else if (evtWrite->handle == handle->CharHandle_GyroFscale.value_handle) {
-            evt.EventType = TXW51_SERV_LSM330_EVT_GYRO_FSCALE;
-
-		} else if (evtWrite->handle == handle->CharHandle_AccOdr.value_handle) {
-            evt.EventType = TXW51_SERV_LSM330_EVT_ACC_ODR;
-
-        } else if (evtWrite->handle == handle->CharHandle_GyroOdr.value_handle) {
-            evt.EventType = TXW51_SERV_LSM330_EVT_GYRO_ODR;
-
-        } else if (evtWrite->handle == handle->CharHandle_TriggerAxis.value_handle) {
-            evt.EventType = TXW51_SERV_LSM330_EVT_TRIGGER_AXIS;
-
-        } else if (evtWrite->handle == handle->CharHandle_TriggerValue.value_handle) {
-            evt.EventType = TXW51_SERV_LSM330_EVT_TRIGGER_VAL;
+    if (handle->EventHandler == NULL) {
+        return;
+    }
 
-        }
+    struct TXW51_SERV_LSM330_Event evt;
+    evt.EventType = TXW51_SERV_FindWriteEvent(&handle->ServiceHandle, &lsm330Table, evtWrite);
 
-	    if (evt.EventType != TXW51_SERV_LSM330_EVT_UNKNOWN) {
-	        evt.Value = evtWrite->data;
-            evt.Length = evtWrite->len;
-            handle->EventHandler(handle, &evt);
-	    }
-	}
+    if (evt.EventType != TXW51_SERV_LSM330_EVT_UNKNOWN) {
+        evt.Value = evtWrite->data;
+        evt.Length = evtWrite->len;
+        handle->EventHandler(handle, &evt);
+    }
 }
 
 
@@ -201,238 +265,28 @@ static void SERV_LSM330_OnWrite(struct TXW51_SERV_LSM330_Handle *handle,
 * @param[in]     bleEvent The BLE event that occurred.
 * @return Nothing.
 ******************************************************************************/
-void SERV_LSM330_OnRwAuthRequest(struct TXW51_SERV_LSM330_Handle *handle,
-                                 ble_evt_t *bleEvent)
+static void SERV_LSM330_OnRwAuthRequest(struct TXW51_SERV_LSM330_Handle *handle,
+                                        ble_evt_t *bleEvent)
 {
     ble_gatts_evt_rw_authorize_request_t *authRequest = &bleEvent->evt.gatts_evt.params.authorize_request;
 
-    if (handle->EventHandler != NULL) {
-        struct TXW51_SERV_LSM330_Event evt;
-
-        if ((authRequest->type = BLE_GATTS_AUTHORIZE_TYPE_READ) &&
-            (authRequest->request.read.handle == handle->CharHandle_TempSample.value_handle)) {
-            uint32_t err;
-
-            /* Handle event. */
-            uint8_t tempValue = 0;
-            evt.EventType = TXW51_SERV_LSM330_EVT_TEMP_SAMPLE;
-            evt.Value = &tempValue;
-            handle->EventHandler(handle, &evt);
-
-            /* Reply to peer. */
-            ble_gatts_rw_authorize_reply_params_t reply;
-            reply.type = BLE_GATTS_AUTHORIZE_TYPE_READ;
-            reply.params.read.gatt_status = BLE_GATT_STATUS_SUCCESS;
-            reply.params.read.p_data = &tempValue;
-            reply.params.read.len = 1;
-            reply.params.read.update = 1;
-            reply.params.read.offset = 0;
-
-            err = sd_ble_gatts_rw_authorize_reply(bleEvent->evt.gatts_evt.conn_handle, &reply);
-            if (err != NRF_SUCCESS) {
-                TXW51_LOG_WARNING("[LSM330 Service] Temperature read failed!");
-            }
-        }
-    }
-}
-
-
-/***************************************************************************//**
-* @brief Adds all the different characteristics to the service.
-*
-* @param[in,out] serviceHandle The handle for the service.
-* @return ERR_NONE if no error occurred.
-*         ERR_BLE_SERVICE_ADD_CHARACTERISTIC if characteristic could not be
-*                                            added.
-******************************************************************************/
-static uint32_t SERV_LSM330_AddAllChars(struct TXW51_SERV_LSM330_Handle *serviceHandle)
-{
-    uint32_t err;
-
-    err = SERV_LSM330_AddChar(serviceHandle,
-                              SERVICE_LSM330_UUID_CHAR_ACC_EN,
-                              0,
-                              SERVICE_LSM330_STRING_CHAR_ACC_EN,
-                              &serviceHandle->CharHandle_AccEnable);
-    if (err != ERR_NONE) {
-        return err;
-    }
-
-    err = SERV_LSM330_AddChar(serviceHandle,
-                              SERVICE_LSM330_UUID_CHAR_GYRO_EN,
-                              0,
-                              SERVICE_LSM330_STRING_CHAR_GYRO_EN,
-                              &serviceHandle->CharHandle_GyroEnable);
-    if (err != ERR_NONE) {
-        return err;
-    }
-
-    err = SERV_LSM330_AddChar_TempSample(serviceHandle);
-    if (err != ERR_NONE) {
-        return err;
-    }
-
-    err = SERV_LSM330_AddChar(serviceHandle,
-                              SERVICE_LSM330_UUID_CHAR_ACC_FSCALE,
-                              0,
-                              SERVICE_LSM330_STRING_CHAR_ACC_FSCALE,
-                              &serviceHandle->CharHandle_AccFscale);
-    if (err != ERR_NONE) {
-        return err;
+    if (handle->EventHandler == NULL) {
+        return;
     }
 
-    err = SERV_LSM330_AddChar(serviceHandle,
-                              SERVICE_LSM330_UUID_CHAR_GYRO_FSCALE,
-                              0,
-                              SERVICE_LSM330_STRING_CHAR_GYRO_FSCALE,
-                              &serviceHandle->CharHandle_GyroFscale);
-    if (err != ERR_NONE) {
-        return err;
-    }
+    struct TXW51_SERV_LSM330_Event evt;
+    evt.EventType = TXW51_SERV_FindReadEvent(&handle->ServiceHandle, &lsm330Table, authRequest);
 
-    err = SERV_LSM330_AddChar(serviceHandle,
-                              SERVICE_LSM330_UUID_CHAR_ACC_ODR,
-                              0,
-                              SERVICE_LSM330_STRING_CHAR_ACC_ODR,
-                              &serviceHandle->CharHandle_AccOdr);
-    if (err != ERR_NONE) {
-        return err;
-    }
+    if (evt.EventType == TXW51_SERV_LSM330_EVT_TEMP_SAMPLE) {
+        /* Handle event. */
+        uint8_t tempValue = 0;
+        evt.Value = &tempValue;
+        evt.Length = 1;
+        handle->EventHandler(handle, &evt);
 
-    err = SERV_LSM330_AddChar(serviceHandle,
-                              SERVICE_LSM330_UUID_CHAR_GYRO_ODR,
-                              0,
-                              SERVICE_LSM330_STRING_CHAR_GYRO_ODR,
-                              &serviceHandle->CharHandle_GyroOdr);
-    if (err != ERR_NONE) {
-        return err;
-    }
-
-    err = SERV_LSM330_AddChar_TriggerValue(serviceHandle);
-    if (err != ERR_NONE) {
-        return err;
-    }
-
-    err = SERV_LSM330_AddChar(serviceHandle,
-                              SERVICE_LSM330_UUID_CHAR_TRIGGER_AXIS,
-                              0,
-                              SERVICE_LSM330_STRING_CHAR_TRIGGER_AXIS,
-                              &serviceHandle->CharHandle_TriggerAxis);
-    if (err != ERR_NONE) {
-        return err;
+        /* Reply to peer. */
+        if (TXW51_SERV_ReplyRead(bleEvent->evt.gatts_evt.conn_handle, &tempValue, 1) != ERR_NONE) {
+            TXW51_LOG_WARNING("[LSM330 Service] Temperature read failed!");
+        }
     }
-
-    return ERR_NONE;
-}
-
-
-/***************************************************************************//**
-* @brief Adds a characteristic that contains a 1 byte value to the service.
-*
-* @param[in,out] serviceHandle The handle for the service.
-* @param[in]     uuid          The two UUID bytes for the characteristic.
-* @param[in]     charValue     The initial value.
-* @param[in]     description   The user description of the characteristic.
-* @param[out]    charHandle    The handle for the characteristic.
-* @return ERR_NONE if no error occurred.
-*         ERR_BLE_SERVICE_ADD_CHARACTERISTIC if characteristic could not be
-*                                            added.
-******************************************************************************/
-static uint32_t SERV_LSM330_AddChar(struct TXW51_SERV_LSM330_Handle *serviceHandle,
-                                    uint16_t uuid,
-                                    uint8_t charValue,
-                                    char *description,
-                                    ble_gatts_char_handles_t *charHandle)
-{
-    struct TXW51_SERV_CharInit charInit;
-
-    /* Initialize characteristic. */
-    TXW51_SERV_InitChar(&serviceHandle->ServiceHandle,
-                        uuid,
-                        &charInit);
-
-    /* Set up characteristic. */
-    charInit.Metadata.char_props.read  = 1;
-    charInit.Metadata.char_props.write = 1;
-    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&charInit.AttrMetadata.read_perm);
-    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&charInit.AttrMetadata.write_perm);
-
-    /*add_desc_user_description(&charInit, (uint8_t *)description);*/
-
-    charInit.Attribute.init_len = 1;
-    charInit.Attribute.max_len  = 1;
-    charInit.Attribute.p_value  = &charValue;
-
-    /* Add characteristic. */
-    return TXW51_SERV_AddChar(&serviceHandle->ServiceHandle,
-                              &charInit,
-                              charHandle);
 }
-
-
-/***************************************************************************//**
-* @brief Adds the "Temperature Sample" characteristic to the service.
-*
-* @param[in,out] serviceHandle The handle for the service.
-* @return ERR_NONE if no error occurred.
-*         ERR_BLE_SERVICE_ADD_CHARACTERISTIC if characteristic could not be
-*                                            added.
-******************************************************************************/
-static uint32_t SERV_LSM330_AddChar_TempSample(struct TXW51_SERV_LSM330_Handle *serviceHandle)
-{
-    struct TXW51_SERV_CharInit charInit;
-
-    /* Initialize characteristic. */
-    TXW51_SERV_InitChar(&serviceHandle->ServiceHandle,
-                        SERVICE_LSM330_UUID_CHAR_TEMP_SAMPLE,
-                        &charInit);
-
-    /* Set up characteristic. */
-    charInit.Metadata.char_props.read = 1;
-    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&charInit.AttrMetadata.read_perm);
-    charInit.AttrMetadata.rd_auth = 1;
-
-    /*add_desc_user_description(&charInit, (uint8_t *)SERVICE_LSM330_STRING_CHAR_TEMP_SAMPLE);*/
-
-    charInit.Attribute.max_len = 1;
-
-    /* Add characteristic. */
-    return TXW51_SERV_AddChar(&serviceHandle->ServiceHandle,
-                              &charInit,
-                              &serviceHandle->CharHandle_TempSample);
-}
-
-
-/***************************************************************************//**
-* @brief Adds the "Trigger Value" characteristic to the service.
-*
-* @param[in,out] serviceHandle The handle for the service.
-* @return ERR_NONE if no error occurred.
-*         ERR_BLE_SERVICE_ADD_CHARACTERISTIC if characteristic could not be
-*                                            added.
-******************************************************************************/
-static uint32_t SERV_LSM330_AddChar_TriggerValue(struct TXW51_SERV_LSM330_Handle *serviceHandle)
-{
-    struct TXW51_SERV_CharInit charInit;
-
-    /* Initialize characteristic. */
-    TXW51_SERV_InitChar(&serviceHandle->ServiceHandle,
-                        SERVICE_LSM330_UUID_CHAR_TRIGGER_VAL,
-                        &charInit);
-
-    /* Set up characteristic. */
-    charInit.Metadata.char_props.read  = 1;
-    charInit.Metadata.char_props.write = 1;
-    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&charInit.AttrMetadata.read_perm);
-    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&charInit.AttrMetadata.write_perm);
-
-    /*add_desc_user_description(&charInit, (uint8_t *)SERVICE_LSM330_STRING_CHAR_TRIGGER_VAL);*/
-
-    charInit.Attribute.max_len = 2;
-
-    /* Add characteristic. */
-    return TXW51_SERV_AddChar(&serviceHandle->ServiceHandle,
-                              &charInit,
-                              &serviceHandle->CharHandle_TriggerValue);
-}
-
@@ -36,7 +36,9 @@ enum TXW51_SERV_LSM330_EventType {
     TXW51_SERV_LSM330_EVT_ACC_ODR,      /**< Change the ODR of the accelerometer. */
     TXW51_SERV_LSM330_EVT_GYRO_ODR,     /**< Change the ODR of the gyroscope. */
     TXW51_SERV_LSM330_EVT_TRIGGER_VAL,  /**< Set a value to trigger the sensor. */
-    TXW51_SERV_LSM330_EVT_TRIGGER_AXIS  /**< Set the axis to trigger the sensor. */
+    TXW51_SERV_LSM330_EVT_TRIGGER_AXIS, /**< Set the axis to trigger the sensor. */
+    TXW51_SERV_LSM330_EVT_AUTO_START,   /**< Enable/disable starting the measurement with the data stream. */
+    TXW51_SERV_LSM330_EVT_STREAM_MODE   /**< Select how the samples are read from the sensor. */
 };
 
 /**
@@ -66,6 +68,14 @@ typedef void (*TXW51_SERV_LSM330_EventHandler_t) (struct TXW51_SERV_LSM330_Handl
  */
 struct TXW51_SERV_LSM330_Init {
     TXW51_SERV_LSM330_EventHandler_t EventHandler;  /**< Callback to register. */
+    uint8_t AccEnable;                              /**< Initial value of the Acc Enable characteristic. */
+    uint8_t GyroEnable;                             /**< Initial value of the Gyro Enable characteristic. */
+    uint8_t AccFscale;                              /**< Initial value of the Acc Full Scale characteristic. */
+    uint8_t GyroFscale;                             /**< Initial value of the Gyro Full Scale characteristic. */
+    uint8_t AccOdr;                                 /**< Initial value of the Acc ODR characteristic. */
+    uint8_t GyroOdr;                                /**< Initial value of the Gyro ODR characteristic. */
+    uint8_t AutoStart;                              /**< Initial value of the Auto Start characteristic. */
+    uint8_t StreamMode;                             /**< Initial value of the Stream Mode characteristic. */
 };
 
 /**
@@ -82,6 +92,8 @@ struct TXW51_SERV_LSM330_Handle {
     ble_gatts_char_handles_t    CharHandle_GyroOdr;         /**< Handle of the Gyro ODR characteristic. */
     ble_gatts_char_handles_t    CharHandle_TriggerValue;    /**< Handle of the Trigger Value characteristic. */
     ble_gatts_char_handles_t    CharHandle_TriggerAxis;     /**< Handle of the Trigger Axis characteristic. */
+    ble_gatts_char_handles_t    CharHandle_AutoStart;       /**< Handle of the Auto Start characteristic. */
+    ble_gatts_char_handles_t    CharHandle_StreamMode;      /**< Handle of the Stream Mode characteristic. */
     TXW51_SERV_LSM330_EventHandler_t EventHandler;          /**< Callback to the application. */
 };
 
@@ -39,15 +39,80 @@ static void SERV_MEASURE_OnHvc(struct TXW51_SERV_MEASURE_Handle *handle,
 static void SERV_MEASURE_OnTxComplete(struct TXW51_SERV_MEASURE_Handle *handle,
                                       ble_evt_t *bleEvent);
 static void SERV_MEASURE_OnRwAuthRequest(struct TXW51_SERV_MEASURE_Handle *handle,
-										  ble_evt_t *bleEvent);
-static uint32_t SERV_MEASURE_AddAllChars(struct TXW51_SERV_MEASURE_Handle *serviceHandle);
-static uint32_t SERV_MEASURE_AddChar_Start(struct TXW51_SERV_MEASURE_Handle *serviceHandle);
-static uint32_t SERV_MEASURE_AddChar_Stop(struct TXW51_SERV_MEASURE_Handle *serviceHandle);
-static uint32_t SERV_MEASURE_AddChar_Duration(struct TXW51_SERV_MEASURE_Handle *serviceHandle);
-static uint32_t SERV_MEASURE_AddChar_DataStream(struct TXW51_SERV_MEASURE_Handle *serviceHandle);
-static uint32_t SERV_MEASURE_AddChar_ADC(struct TXW51_SERV_MEASURE_Handle *serviceHandle);
+                                         ble_evt_t *bleEvent);
+static uint32_t SERV_MEASURE_Send(struct TXW51_SERV_MEASURE_Handle *handle,
+                                  uint16_t valueHandle,
+                                  uint8_t type,
+                                  const uint8_t *data,
+                                  uint16_t length);
 
 /*----- Data -----------------------------------------------------------------*/
+/**
+ * @brief The characteristics of the service.
+ */
+static const struct TXW51_SERV_CharDef measureChars[] = {
+    {
+        .Uuid         = TXW51_SERV_MEASURE_UUID_CHAR_START,
+        .Flags        = TXW51_SERV_CHAR_WRITE,
+        .MaxLength    = 1,
+        .HandleOffset = offsetof(struct TXW51_SERV_MEASURE_Handle, CharHandle_Start),
+        .InitOffset   = TXW51_SERV_NO_INIT,
+        .InitLength   = 1,
+        .WriteEvent   = TXW51_SERV_MEASURE_EVT_START
+    }, {
+        .Uuid         = TXW51_SERV_MEASURE_UUID_CHAR_STOP,
+        .Flags        = TXW51_SERV_CHAR_WRITE,
+        .MaxLength    = 1,
+        .HandleOffset = offsetof(struct TXW51_SERV_MEASURE_Handle, CharHandle_Stop),
+        .InitOffset   = TXW51_SERV_NO_INIT,
+        .InitLength   = 1,
+        .WriteEvent   = TXW51_SERV_MEASURE_EVT_STOP
+    }, {
+        .Uuid         = TXW51_SERV_MEASURE_UUID_CHAR_DURATION,
+        .Flags        = TXW51_SERV_CHAR_READ | TXW51_SERV_CHAR_WRITE,
+        .MaxLength    = 2,
+        .HandleOffset = offsetof(struct TXW51_SERV_MEASURE_Handle, CharHandle_Duration),
+        .InitOffset   = TXW51_SERV_NO_INIT,
+        .InitLength   = 1,
+        .WriteEvent   = TXW51_SERV_MEASURE_EVT_SET_DURATION
+    }, {
+        /* Receives the data during a measurement, the peer has to set the CCCD. */
+        .Uuid         = TXW51_SERV_MEASURE_UUID_CHAR_DATASTRAM,
+        .Flags        = TXW51_SERV_CHAR_READ | TXW51_SERV_CHAR_NOTIFY | TXW51_SERV_CHAR_INDICATE,
+        .MaxLength    = 20,
+        .HandleOffset = offsetof(struct TXW51_SERV_MEASURE_Handle, CharHandle_DataStream),
+        .InitOffset   = TXW51_SERV_NO_INIT,
+        .InitLength   = 1,
+        .CccdEvent    = TXW51_SERV_MEASURE_EVT_ENABLE_DATASTREAM
+    }, {
+        .Uuid         = TXW51_SERV_MEASURE_UUID_CHAR_ADC,
+        .Flags        = TXW51_SERV_CHAR_READ | TXW51_SERV_CHAR_WRITE | TXW51_SERV_CHAR_READ_AUTH,
+        .MaxLength    = 1,
+        .HandleOffset = offsetof(struct TXW51_SERV_MEASURE_Handle, CharHandle_ADC),
+        .InitOffset   = TXW51_SERV_NO_INIT,
+        .InitLength   = 1,
+        .ReadEvent    = TWX51_SERV_MEASURE_EVT_ADC
+    }, {
+        .Uuid         = TXW51_SERV_MEASURE_UUID_CHAR_DIAGNOSTICS,
+        .Flags        = TXW51_SERV_CHAR_READ | TXW51_SERV_CHAR_READ_AUTH | TXW51_SERV_CHAR_VLEN,
+        .MaxLength    = TXW51_SERV_MEASURE_DIAG_MAX_LENGTH,
+        .HandleOffset = offsetof(struct TXW51_SERV_MEASURE_Handle, CharHandle_Diagnostics),
+        .InitOffset   = TXW51_SERV_NO_INIT,
+        .InitLength   = 0,
+        .ReadEvent    = TXW51_SERV_MEASURE_EVT_DIAGNOSTICS
+    }, {
+        /* Takes a command and answers with a notification, see app/control.h. */
+        .Uuid         = TXW51_SERV_MEASURE_UUID_CHAR_CONTROL,
+        .Flags        = TXW51_SERV_CHAR_WRITE | TXW51_SERV_CHAR_WRITE_CMD | TXW51_SERV_CHAR_NOTIFY | TXW51_SERV_CHAR_VLEN,
+        .MaxLength    = TXW51_SERV_MEASURE_CONTROL_MAX_LENGTH,
+        .HandleOffset = offsetof(struct TXW51_SERV_MEASURE_Handle, CharHandle_Control),
+        .InitOffset   = TXW51_SERV_NO_INIT,
+        .InitLength   = 0,
+        .WriteEvent   = TXW51_SERV_MEASURE_EVT_CONTROL
+    }
+};
+
+static const struct TXW51_SERV_Table measureTable = TXW51_SERV_TABLE(measureChars);  /**< Table of the service. */
 
 /*----- Implementation -------------------------------------------------------*/
 
@@ -70,7 +135,7 @@ uint32_t TXW51_SERV_MEASURE_Init(struct TXW51_SERV_MEASURE_Handle *handle,
         return err;
     }
 
-    err = SERV_MEASURE_AddAllChars(handle);
+    err = TXW51_SERV_AddTable(&handle->ServiceHandle, &measureTable, NULL);
     if (err != ERR_NONE) {
         TXW51_LOG_ERROR("[Measure Service] Could not create all characteristics.");
         return err;
@@ -143,6 +208,14 @@ static void SERV_MEASURE_OnDisconnect(struct TXW51_SERV_MEASURE_Handle *handle,
                                       ble_evt_t *bleEvent)
 {
     TXW51_LOG_DEBUG("[Measure Service] Disconnected");
+
+    if (handle->EventHandler != NULL) {
+        struct TXW51_SERV_MEASURE_Event evt;
+        evt.EventType = TXW51_SERV_MEASURE_EVT_DISCONNECTED;
+        evt.Value = NULL;
+        evt.Length = 0;
+        handle->EventHandler(handle, &evt);
+    }
 }
 
 
@@ -165,23 +238,11 @@ static void SERV_MEASURE_OnWrite(struct TXW51_SERV_MEASURE_Handle *handle,
     }
 
     struct TXW51_SERV_MEASURE_Event evt;
-    evt.EventType = TXW51_SERV_MEASURE_EVT_UNKNOWN;
-
-    if (writeEvt->handle == handle->CharHandle_Start.value_handle) {
-        evt.EventType = TXW51_SERV_MEASURE_EVT_START;
-
-    } else if (writeEvt->handle == handle->CharHandle_Stop.value_handle) {
-        evt.EventType = TXW51_SERV_MEASURE_EVT_STOP;
+    evt.EventType = TXW51_SERV_FindWriteEvent(&handle->ServiceHandle, &measureTable, writeEvt);
 
-    } else if (writeEvt->handle == handle->CharHandle_Duration.value_handle) {
-        evt.EventType = TXW51_SERV_MEASURE_EVT_SET_DURATION;
-
-    } else if (writeEvt->handle == handle->CharHandle_DataStream.cccd_handle) {
-        if (ble_srv_is_notification_enabled(writeEvt->data)) {
-            evt.EventType = TXW51_SERV_MEASURE_EVT_ENABLE_DATASTREAM;
-        } else {
-            evt.EventType = TXW51_SERV_MEASURE_EVT_DISABLE_DATASTREAM;
-        }
+    if ((evt.EventType == TXW51_SERV_MEASURE_EVT_ENABLE_DATASTREAM) &&
+        !ble_srv_is_notification_enabled(writeEvt->data)) {
+        evt.EventType = TXW51_SERV_MEASURE_EVT_DISABLE_DATASTREAM;
     }
 
     if (evt.EventType != TXW51_SERV_MEASURE_EVT_UNKNOWN) {
@@ -253,287 +314,99 @@ static void SERV_MEASURE_OnTxComplete(struct TXW51_SERV_MEASURE_Handle *handle,
 
 
 /***************************************************************************//**
-* @brief Adds all the different characteristics to the service.
+* @brief Handles the read/write authorization request.
 *
-* @param[in,out] serviceHandle The handle for the service.
-* @return ERR_NONE if no error occurred.
-*         ERR_BLE_SERVICE_ADD_CHARACTERISTIC if characteristic could not be
-*                                            added.
+* Detects which characteristic has been read, notifies the application and
+* allows the request. This can be used to act on characteristics reads.
+*
+* @param[in,out] handle   The handle for the service.
+* @param[in]     bleEvent The BLE event that occurred.
+* @return Nothing.
 ******************************************************************************/
-static uint32_t SERV_MEASURE_AddAllChars(struct TXW51_SERV_MEASURE_Handle *serviceHandle)
+static void SERV_MEASURE_OnRwAuthRequest(struct TXW51_SERV_MEASURE_Handle *handle,
+                                         ble_evt_t *bleEvent)
 {
-    uint32_t err;
+    ble_gatts_evt_rw_authorize_request_t *authRequest = &bleEvent->evt.gatts_evt.params.authorize_request;
 
-    err = SERV_MEASURE_AddChar_Start(serviceHandle);
-    if (err != ERR_NONE) {
-        return err;
+    if (handle->EventHandler == NULL) {
+        return;
     }
 
-    err = SERV_MEASURE_AddChar_Stop(serviceHandle);
-    if (err != ERR_NONE) {
-        return err;
-    }
+    struct TXW51_SERV_MEASURE_Event evt;
+    evt.EventType = TXW51_SERV_FindReadEvent(&handle->ServiceHandle, &measureTable, authRequest);
 
-    err = SERV_MEASURE_AddChar_Duration(serviceHandle);
-    if (err != ERR_NONE) {
-        return err;
-    }
+    if (evt.EventType == TWX51_SERV_MEASURE_EVT_ADC) {
+        /* Handle event. */
+        uint8_t tempValue = 0;
+        evt.Value = &tempValue;
+        evt.Length = 1;
+        handle->EventHandler(handle, &evt);
 
-    err = SERV_MEASURE_AddChar_DataStream(serviceHandle);
-    if (err != ERR_NONE) {
-        return err;
-    }
+        TXW51_LOG_DEBUG("[MEASURE Service] MEASURE Value Read Event");
 
-    err = SERV_MEASURE_AddChar_ADC(serviceHandle);
-    if (err != ERR_NONE) {
-        return err;
-    }
+        /* Reply to peer. */
+        if (TXW51_SERV_ReplyRead(bleEvent->evt.gatts_evt.conn_handle, &tempValue, 1) != ERR_NONE) {
+            TXW51_LOG_WARNING("[MEASURE Service] Error MEASURE Value Read!");
+        }
+    } else if (evt.EventType == TXW51_SERV_MEASURE_EVT_DIAGNOSTICS) {
+        uint8_t record[TXW51_SERV_MEASURE_DIAG_MAX_LENGTH];
+        evt.Value = record;
+        evt.Length = 0;
+        handle->EventHandler(handle, &evt);
 
-    return ERR_NONE;
+        if (TXW51_SERV_ReplyRead(bleEvent->evt.gatts_evt.conn_handle, record, evt.Length) != ERR_NONE) {
+            TXW51_LOG_WARNING("[MEASURE Service] Error Diagnostics Read!");
+        }
+    }
 }
 
 
-/***************************************************************************//**
-* @brief Adds the "Start Measurement" characteristic to the service.
-*
-* @param[in,out] serviceHandle The handle for the service.
-* @return ERR_NONE if no error occurred.
-*         ERR_BLE_SERVICE_ADD_CHARACTERISTIC if characteristic could not be
-*                                            added.
-******************************************************************************/
-static uint32_t SERV_MEASURE_AddChar_Start(struct TXW51_SERV_MEASURE_Handle *serviceHandle)
+uint32_t TXW51_SERV_MEASURE_SendData(enum TXW51_SERV_MEASURE_TxType txType,
+                                     struct TXW51_SERV_MEASURE_Handle *handle,
+                                     struct TXW51_SERV_MEASURE_DataPacket *data)
 {
-    struct TXW51_SERV_CharInit charInit;
-
-    /* Initialize characteristic. */
-    TXW51_SERV_InitChar(&serviceHandle->ServiceHandle,
-                        TXW51_SERV_MEASURE_UUID_CHAR_START,
-                        &charInit);
-
-    /* Set up characteristic. */
-    charInit.Metadata.char_props.read  = 0;
-    charInit.Metadata.char_props.write = 1;
-    BLE_GAP_CONN_SEC_MODE_SET_NO_ACCESS(&charInit.AttrMetadata.read_perm);
-    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&charInit.AttrMetadata.write_perm);
-
-    /*add_desc_user_description(&charInit, (uint8_t *)TXW51_SERV_MEASURE_STRING_CHAR_START);*/
-
-    charInit.Attribute.max_len = 1;
-
-    /* Add characteristic. */
-    return TXW51_SERV_AddChar(&serviceHandle->ServiceHandle,
-                              &charInit,
-                              &serviceHandle->CharHandle_Start);
+    return SERV_MEASURE_Send(handle,
+                             handle->CharHandle_DataStream.value_handle,
+                             txType,
+                             (const uint8_t *)data,
+                             sizeof(*data));
 }
 
 
-/***************************************************************************//**
-* @brief Adds the "Stop Measurement" characteristic to the service.
-*
-* @param[in,out] serviceHandle The handle for the service.
-* @return ERR_NONE if no error occurred.
-*         ERR_BLE_SERVICE_ADD_CHARACTERISTIC if characteristic could not be
-*                                            added.
-******************************************************************************/
-static uint32_t SERV_MEASURE_AddChar_Stop(struct TXW51_SERV_MEASURE_Handle *serviceHandle)
+uint32_t TXW51_SERV_MEASURE_SendControlStatus(struct TXW51_SERV_MEASURE_Handle *handle,
+                                              const uint8_t *status,
+                                              uint16_t length)
 {
-    struct TXW51_SERV_CharInit charInit;
-
-    /* Initialize characteristic. */
-    TXW51_SERV_InitChar(&serviceHandle->ServiceHandle,
-                        TXW51_SERV_MEASURE_UUID_CHAR_STOP,
-                        &charInit);
-
-    /* Set up characteristic. */
-    charInit.Metadata.char_props.read  = 0;
-    charInit.Metadata.char_props.write = 1;
-    BLE_GAP_CONN_SEC_MODE_SET_NO_ACCESS(&charInit.AttrMetadata.read_perm);
-    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&charInit.AttrMetadata.write_perm);
-
-    /*add_desc_user_description(&charInit, (uint8_t *)TXW51_SERV_MEASURE_STRING_CHAR_STOP);*/
-
-    charInit.Attribute.max_len = 1;
-
-    /* Add characteristic. */
-    return TXW51_SERV_AddChar(&serviceHandle->ServiceHandle,
-                              &charInit,
-                              &serviceHandle->CharHandle_Stop);
+    return SERV_MEASURE_Send(handle,
+                             handle->CharHandle_Control.value_handle,
+                             BLE_GATT_HVX_NOTIFICATION,
+                             status,
+                             length);
 }
 
 
 /***************************************************************************//**
-* @brief Adds the "Measurement Duration" characteristic to the service.
-*
-* @param[in,out] serviceHandle The handle for the service.
-* @return ERR_NONE if no error occurred.
-*         ERR_BLE_SERVICE_ADD_CHARACTERISTIC if characteristic could not be
-*                                            added.
-******************************************************************************/
-static uint32_t SERV_MEASURE_AddChar_Duration(struct TXW51_SERV_MEASURE_Handle *serviceHandle)
-{
-    struct TXW51_SERV_CharInit charInit;
-
-    /* Initialize characteristic. */
-    TXW51_SERV_InitChar(&serviceHandle->ServiceHandle,
-                        TXW51_SERV_MEASURE_UUID_CHAR_DURATION,
-                        &charInit);
-
-    /* Set up characteristic. */
-    charInit.Metadata.char_props.read  = 1;
-    charInit.Metadata.char_props.write = 1;
-    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&charInit.AttrMetadata.read_perm);
-    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&charInit.AttrMetadata.write_perm);
-
-    /*add_desc_user_description(&charInit, (uint8_t *)TXW51_SERV_MEASURE_STRING_CHAR_DURATION);*/
-
-    charInit.Attribute.max_len = 2;
-
-    /* Add characteristic. */
-    return TXW51_SERV_AddChar(&serviceHandle->ServiceHandle,
-                              &charInit,
-                              &serviceHandle->CharHandle_Duration);
-}
-
-
-/***************************************************************************//**
-* @brief Adds the "Data Stream" characteristic to the service.
-*
-* This characteristic receives the data during measurement. For this the CCCD
-* has to be set by the peer device.
-*
-* @param[in,out] serviceHandle The handle for the service.
-* @return ERR_NONE if no error occurred.
-*         ERR_BLE_SERVICE_ADD_CHARACTERISTIC if characteristic could not be
-*                                            added.
-******************************************************************************/
-static uint32_t SERV_MEASURE_AddChar_DataStream(struct TXW51_SERV_MEASURE_Handle *serviceHandle)
-{
-    struct TXW51_SERV_CharInit charInit;
-
-    /* Initialize characteristic. */
-    TXW51_SERV_InitChar(&serviceHandle->ServiceHandle,
-                        TXW51_SERV_MEASURE_UUID_CHAR_DATASTRAM,
-                        &charInit);
-
-    ble_gatts_attr_md_t cccd_md;
-    memset(&cccd_md, 0, sizeof(cccd_md));
-    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&cccd_md.read_perm);
-    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&cccd_md.write_perm);
-    cccd_md.vloc = BLE_GATTS_VLOC_STACK;
-
-    /* Set up characteristic. */
-    charInit.Metadata.char_props.read  = 1;
-    charInit.Metadata.char_props.write = 0;
-    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&charInit.AttrMetadata.read_perm);
-    BLE_GAP_CONN_SEC_MODE_SET_NO_ACCESS(&charInit.AttrMetadata.write_perm);
-
-    charInit.Metadata.char_props.notify   = 1;
-    charInit.Metadata.char_props.indicate = 1;
-    charInit.Metadata.p_cccd_md           = &cccd_md;
-
-    /*add_desc_user_description(&charInit, (uint8_t *)TXW51_SERV_MEASURE_STRING_CHAR_DATASTREAM);*/
-
-    charInit.Attribute.max_len = 20;
-
-    /* Add characteristic. */
-    return TXW51_SERV_AddChar(&serviceHandle->ServiceHandle,
-                              &charInit,
-                              &serviceHandle->CharHandle_DataStream);
-}
-
-/***************************************************************************//**
-* @brief Adds the "ADC" characteristic to the service.
+* @brief Sends a value via indication or notification to the peer device.
 *
-* @param[in,out] serviceHandle The handle for the service.
+* @param[in,out] handle      The handle for the service.
+* @param[in]     valueHandle Handle of the characteristic value.
+* @param[in]     type        BLE_GATT_HVX_NOTIFICATION or
+*                            BLE_GATT_HVX_INDICATION.
+* @param[in]     data        The value.
+* @param[in]     length      Length of the value in bytes.
 * @return ERR_NONE if no error occurred.
-*         ERR_BLE_SERVICE_ADD_CHARACTERISTIC if characteristic could not be
-*                                            added.
-******************************************************************************/
-static uint32_t SERV_MEASURE_AddChar_ADC(struct TXW51_SERV_MEASURE_Handle *serviceHandle)
-{
-    struct TXW51_SERV_CharInit charInit;
-
-    /* Initialize characteristic. */
-    TXW51_SERV_InitChar(&serviceHandle->ServiceHandle,
-						TXW51_SERV_MEASURE_UUID_CHAR_ADC,
-                        &charInit);
-
-    /* Set up characteristic. */
-    charInit.Metadata.char_props.read  = 1;
-    charInit.Metadata.char_props.write = 1;
-    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&charInit.AttrMetadata.read_perm);
-    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&charInit.AttrMetadata.write_perm);
-
-    charInit.AttrMetadata.rd_auth = 1;
-
-    /*add_desc_user_description(&charInit, (uint8_t *)SERVICE_I2C_STRING_CHAR_REGISTER_VALUE);*/
-
-    charInit.Attribute.init_len = 1;
-    charInit.Attribute.max_len  = 1;
-    charInit.Attribute.p_value  = 0;
-
-    /* Add characteristic. */
-    return TXW51_SERV_AddChar(&serviceHandle->ServiceHandle,
-                              &charInit,
-                              &serviceHandle->CharHandle_ADC);
-}
-
-/***************************************************************************//**
-* @brief Handles the read/write authorization request.
-*
-* Detects which characteristic has been read, notifies the application and
-* allows the request. This can be used to act on characteristics reads.
-*
-* @param[in,out] handle   The handle for the service.
-* @param[in]     bleEvent The BLE event that occurred.
-* @return Nothing.
+*         ERR_BLE_SERVICE_NO_CONNECTION if no peer is connected.
+*         ERR_SERVICE_MEASURE_HVC_COULD_NOT_SEND if notification or indication
+*                                                could not be sent.
+*         ERR_SERVICE_MEASURE_CCCD_NOT_ENABLED if CCCD is not enabled.
 ******************************************************************************/
-void SERV_MEASURE_OnRwAuthRequest(struct TXW51_SERV_MEASURE_Handle *handle,
-                                 ble_evt_t *bleEvent)
-{
-    ble_gatts_evt_rw_authorize_request_t *authRequest = &bleEvent->evt.gatts_evt.params.authorize_request;
-
-    TXW51_LOG_DEBUG("[MEASURE Service] SERV_MEASURE_OnRwAuthRequest");
-
-    if (handle->EventHandler != NULL) {
-        struct TXW51_SERV_MEASURE_Event evt;
-
-        if ((authRequest->type = BLE_GATTS_AUTHORIZE_TYPE_READ) &&
-            (authRequest->request.read.handle == handle->CharHandle_ADC.value_handle)) {
-            uint32_t err;
-
-            /* Handle event. */
-            uint8_t tempValue = 0;
-            evt.EventType = TWX51_SERV_MEASURE_EVT_ADC;
-            evt.Value = &tempValue;
-            handle->EventHandler(handle, &evt);
-
-
-            TXW51_LOG_DEBUG("[MEASURE Service] MEASURE Value Read Event");
-
-            /* Reply to peer. */
-            ble_gatts_rw_authorize_reply_params_t reply;
-            reply.type = BLE_GATTS_AUTHORIZE_TYPE_READ;
-            reply.params.read.gatt_status = BLE_GATT_STATUS_SUCCESS;
-            reply.params.read.p_data = &tempValue;
-            reply.params.read.len = 1;
-            reply.params.read.update = 1;
-            reply.params.read.offset = 0;
-
-            err = sd_ble_gatts_rw_authorize_reply(bleEvent->evt.gatts_evt.conn_handle, &reply);
-            if (err != NRF_SUCCESS) {
-                TXW51_LOG_WARNING("[MEASURE Service] Error MEASURE Value Read!");
-            }
-        }
-    }
-}
-
-uint32_t TXW51_SERV_MEASURE_SendData(enum TXW51_SERV_MEASURE_TxType txType,
-                                     struct TXW51_SERV_MEASURE_Handle *handle,
-                                     struct TXW51_SERV_MEASURE_DataPacket *data)
+static uint32_t SERV_MEASURE_Send(struct TXW51_SERV_MEASURE_Handle *handle,
+                                  uint16_t valueHandle,
+                                  uint8_t type,
+                                  const uint8_t *data,
+                                  uint16_t length)
 {
     uint32_t err;
-    uint16_t length = sizeof(*data);
 
     if (handle->ServiceHandle.ConnHandle == BLE_CONN_HANDLE_INVALID) {
         return ERR_BLE_SERVICE_NO_CONNECTION;
@@ -542,8 +415,8 @@ uint32_t TXW51_SERV_MEASURE_SendData(enum TXW51_SERV_MEASURE_TxType txType,
     ble_gatts_hvx_params_t hvxParams;
     memset(&hvxParams, 0, sizeof(hvxParams));
 
-    hvxParams.handle = handle->CharHandle_DataStream.value_handle;
-    hvxParams.type   = txType;
+    hvxParams.handle = valueHandle;
+    hvxParams.type   = type;
     hvxParams.offset = 0;
     hvxParams.p_len  = &length;
     hvxParams.p_data = (uint8_t *)data;
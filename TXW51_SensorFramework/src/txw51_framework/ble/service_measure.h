@@ -20,6 +20,8 @@
 #include "txw51_framework/ble/service.h"
 
 /*----- Macros ---------------------------------------------------------------*/
+#define TXW51_SERV_MEASURE_DIAG_MAX_LENGTH  ( 20 )  /**< Maximum length of the Diagnostics characteristic. */
+#define TXW51_SERV_MEASURE_CONTROL_MAX_LENGTH   ( 20 )  /**< Maximum length of a write to the Control Point characteristic. */
 
 /*----- Data types -----------------------------------------------------------*/
 /**
@@ -60,7 +62,10 @@ enum TXW51_SERV_MEASURE_EventType {
     TXW51_SERV_MEASURE_EVT_DISABLE_DATASTREAM,  /**< CCCD for data streaming has been unset. */
     TXW51_SERV_MEASURE_EVT_INDICATION_RECEIVED, /**< The indication has been received by the peer device. */
     TXW51_SERV_MEASURE_EVT_NOTIFICATIONS_SENT,  /**< The notification has been sent (no guarantee of receiving). */
-    TWX51_SERV_MEASURE_EVT_ADC					/**< Get Value from ADC */
+    TWX51_SERV_MEASURE_EVT_ADC,					/**< Get Value from ADC */
+    TXW51_SERV_MEASURE_EVT_DIAGNOSTICS,         /**< The Diagnostics characteristic is read, Value has TXW51_SERV_MEASURE_DIAG_MAX_LENGTH bytes for the record, set Length. */
+    TXW51_SERV_MEASURE_EVT_CONTROL,             /**< A command has been written to the Control Point characteristic. */
+    TXW51_SERV_MEASURE_EVT_DISCONNECTED         /**< The peer device has disconnected. */
 };
 
 /**
@@ -102,11 +107,20 @@ struct TXW51_SERV_MEASURE_Handle {
     ble_gatts_char_handles_t    CharHandle_Duration;    /**< Handle of the Duration characteristic. */
     ble_gatts_char_handles_t    CharHandle_DataStream;  /**< Handle of the Data Stream characteristic. */
     ble_gatts_char_handles_t    CharHandle_ADC;  		/**< Handle of the ADC characteristic. */
+    ble_gatts_char_handles_t    CharHandle_Diagnostics; /**< Handle of the Diagnostics characteristic. */
+    ble_gatts_char_handles_t    CharHandle_Control;     /**< Handle of the Control Point characteristic. */
     TXW51_SERV_MEASURE_EventHandler_t EventHandler;     /**< Callback to the application. */
 };
 
 /**
  * @brief Data packet that gets sent over the Bluetooth Smart link.
+ *
+ * A packet without samples and axes marks a discontinuity in the stream of
+ * the sensor: samples were lost before the next packet of this sensor.
+ * Data[0] holds the number of discontinuities it stands for.
+ *
+ * A packet without samples but with axes carries the samples of another
+ * sensor, see app/driver.h.
  */
 struct TXW51_SERV_MEASURE_DataPacket {
     struct {
@@ -166,6 +180,25 @@ extern uint32_t TXW51_SERV_MEASURE_SendData(enum TXW51_SERV_MEASURE_TxType txTyp
                                             struct TXW51_SERV_MEASURE_Handle *handle,
                                             struct TXW51_SERV_MEASURE_DataPacket *data);
 
+/***************************************************************************//**
+* @brief Answers a command of the Control Point characteristic.
+*
+* The answer is sent as notification of the Control Point characteristic, the
+* peer has to set its CCCD. It takes a TX buffer like the data stream.
+*
+* @param[in,out] handle The handle for the service.
+* @param[in]     status The answer.
+* @param[in]     length Length of the answer in bytes.
+* @return ERR_NONE if no error occurred.
+*         ERR_BLE_SERVICE_NO_CONNECTION if no peer is connected.
+*         ERR_SERVICE_MEASURE_HVC_COULD_NOT_SEND if the notification could not
+*                                                be sent.
+*         ERR_SERVICE_MEASURE_CCCD_NOT_ENABLED if CCCD is not enabled.
+******************************************************************************/
+extern uint32_t TXW51_SERV_MEASURE_SendControlStatus(struct TXW51_SERV_MEASURE_Handle *handle,
+                                                     const uint8_t *status,
+                                                     uint16_t length);
+
 /*----- Data -----------------------------------------------------------------*/
 
 #endif /* TXW51_FRAMEWORK_BLE_SERVICE_MEASURE_H_ */
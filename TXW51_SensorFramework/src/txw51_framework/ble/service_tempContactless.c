@@ -35,8 +35,6 @@ static void SERV_TEMP_CONTACTLESS_OnDisconnect(struct TXW51_SERV_TEMP_CONTACTLES
                                      ble_evt_t *bleEvent);
 static void SERV_TEMP_CONTACTLESS_OnWrite(struct TXW51_SERV_TEMP_CONTACTLESS_Handle *handle,
                                 ble_evt_t *bleEvent);
-static void SERV_TEMP_CONTACTLESS_OnRwAuthRequest(struct TXW51_SERV_TEMP_CONTACTLESS_Handle *handle,
-                                        ble_evt_t *bleEvent);
 static uint32_t SERV_TEMP_CONTACTLESS_AddAllChars(struct TXW51_SERV_TEMP_CONTACTLESS_Handle *serviceHandle);
 static uint32_t SERV_TEMP_CONTACTLESS_AddChar(struct TXW51_SERV_TEMP_CONTACTLESS_Handle *serviceHandle,
                                     uint16_t uuid,
@@ -98,10 +96,6 @@ void TXW51_SERV_TEMP_CONTACTLESS_OnBleEvent(struct TXW51_SERV_TEMP_CONTACTLESS_H
             SERV_TEMP_CONTACTLESS_OnWrite(handle, bleEvent);
             break;
 
-        case BLE_GATTS_EVT_RW_AUTHORIZE_REQUEST:
-            SERV_TEMP_CONTACTLESS_OnRwAuthRequest(handle, bleEvent);
-            break;
-
         default:
             // No implementation needed.
             break;
@@ -120,6 +114,14 @@ static void SERV_TEMP_CONTACTLESS_OnConnect(struct TXW51_SERV_TEMP_CONTACTLESS_H
                                   ble_evt_t *bleEvent)
 {
     TXW51_LOG_DEBUG("[TEMP_CONTACTLESS Service] Connected");
+
+    if (handle->EventHandler != NULL) {
+        struct TXW51_SERV_TEMP_CONTACTLESS_Event evt;
+        evt.EventType = TXW51_SERV_TEMP_CONTACTLESS_EVT_CONNECTED;
+        evt.Value = NULL;
+        evt.Length = 0;
+        handle->EventHandler(handle, &evt);
+    }
 }
 
 
@@ -134,6 +136,14 @@ static void SERV_TEMP_CONTACTLESS_OnDisconnect(struct TXW51_SERV_TEMP_CONTACTLES
                                      ble_evt_t *bleEvent)
 {
     TXW51_LOG_DEBUG("[TEMP_CONTACTLESS Service] Disconnected");
+
+    if (handle->EventHandler != NULL) {
+        struct TXW51_SERV_TEMP_CONTACTLESS_Event evt;
+        evt.EventType = TXW51_SERV_TEMP_CONTACTLESS_EVT_DISCONNECTED;
+        evt.Value = NULL;
+        evt.Length = 0;
+        handle->EventHandler(handle, &evt);
+    }
 }
 
 
@@ -165,51 +175,48 @@ static void SERV_TEMP_CONTACTLESS_OnWrite(struct TXW51_SERV_TEMP_CONTACTLESS_Han
 }
 
 
-/***************************************************************************//**
-* @brief Handles the read/write authorization request.
-*
-* Detects which characteristic has been read, notifies the application and
-* allows the request. This can be used to act on characteristics reads.
-*
-* @param[in,out] handle   The handle for the service.
-* @param[in]     bleEvent The BLE event that occurred.
-* @return Nothing.
-******************************************************************************/
-void SERV_TEMP_CONTACTLESS_OnRwAuthRequest(struct TXW51_SERV_TEMP_CONTACTLESS_Handle *handle,
-                                 ble_evt_t *bleEvent)
+uint32_t TXW51_SERV_TEMP_CONTACTLESS_SendTempSample(struct TXW51_SERV_TEMP_CONTACTLESS_Handle *handle,
+                                                    int16_t objectTemp)
 {
-    ble_gatts_evt_rw_authorize_request_t *authRequest = &bleEvent->evt.gatts_evt.params.authorize_request;
-
-    TXW51_LOG_DEBUG("SERV_TEMP_CONTACTLESS_OnRwAuthRequest");
-
-    if (handle->EventHandler != NULL) {
-        struct TXW51_SERV_TEMP_CONTACTLESS_Event evt;
-
-        if ((authRequest->type = BLE_GATTS_AUTHORIZE_TYPE_READ) &&
-            (authRequest->request.read.handle == handle->CharHandle_TempSample.value_handle)) {
-            uint32_t err;
+    uint32_t err;
+    uint8_t value[TXW51_SERV_TEMP_CONTACTLESS_SAMPLE_LENGTH];
+    uint16_t length = sizeof(value);
+
+    value[0] = (uint8_t)((uint16_t)objectTemp & 0xFF);
+    value[1] = (uint8_t)((uint16_t)objectTemp >> 8);
+
+    err = sd_ble_gatts_value_set(handle->CharHandle_TempSample.value_handle,
+                                 0,
+                                 &length,
+                                 value);
+    if (err != NRF_SUCCESS) {
+        TXW51_LOG_WARNING("[TEMP_CONTACTLESS Service] Could not store temperature sample.");
+        return ERR_SERVICE_TEMP_CONTACTLESS_HVX_COULD_NOT_SEND;
+    }
 
-            /* Handle event. */
-            uint8_t tempValue = 0;
-            evt.EventType = TXW51_SERV_TEMP_CONTACTLESS_EVT_TEMP_SAMPLE;
-            evt.Value = &tempValue;
-            handle->EventHandler(handle, &evt);
+    if (handle->ServiceHandle.ConnHandle == BLE_CONN_HANDLE_INVALID) {
+        return ERR_NONE;
+    }
 
-            /* Reply to peer. */
-            ble_gatts_rw_authorize_reply_params_t reply;
-            reply.type = BLE_GATTS_AUTHORIZE_TYPE_READ;
-            reply.params.read.gatt_status = BLE_GATT_STATUS_SUCCESS;
-            reply.params.read.p_data = &tempValue;
-            reply.params.read.len = 1;
-            reply.params.read.update = 1;
-            reply.params.read.offset = 0;
-
-            err = sd_ble_gatts_rw_authorize_reply(bleEvent->evt.gatts_evt.conn_handle, &reply);
-            if (err != NRF_SUCCESS) {
-                TXW51_LOG_WARNING("[TEMP_CONTACTLESS Service] Temperature read failed!");
-            }
-        }
+    ble_gatts_hvx_params_t hvxParams;
+    memset(&hvxParams, 0, sizeof(hvxParams));
+
+    hvxParams.handle = handle->CharHandle_TempSample.value_handle;
+    hvxParams.type   = BLE_GATT_HVX_NOTIFICATION;
+    hvxParams.offset = 0;
+    hvxParams.p_len  = &length;
+    hvxParams.p_data = value;
+
+    err = sd_ble_gatts_hvx(handle->ServiceHandle.ConnHandle, &hvxParams);
+    if (err == NRF_ERROR_INVALID_STATE) {
+        /* Notifications are disabled, the peer reads the sample instead. */
+        return ERR_NONE;
+    } else if (err != NRF_SUCCESS) {
+        TXW51_LOG_WARNING("[TEMP_CONTACTLESS Service] Could not send temperature sample.");
+        return ERR_SERVICE_TEMP_CONTACTLESS_HVX_COULD_NOT_SEND;
     }
+
+    return ERR_NONE;
 }
 
 
@@ -349,6 +356,9 @@ static uint32_t SERV_TEMP_CONTACTLESS_AddAllChars(struct TXW51_SERV_TEMP_CONTACT
 /***************************************************************************//**
 * @brief Adds the "Temperature Sample" characteristic to the service.
 *
+* Contains the latest object temperature. It is notified for every new
+* sample if the CCCD is enabled.
+*
 * @param[in,out] serviceHandle The handle for the service.
 * @return ERR_NONE if no error occurred.
 *         ERR_BLE_SERVICE_ADD_CHARACTERISTIC if characteristic could not be
@@ -357,20 +367,30 @@ static uint32_t SERV_TEMP_CONTACTLESS_AddAllChars(struct TXW51_SERV_TEMP_CONTACT
 static uint32_t SERV_TEMP_CONTACTLESS_AddChar_TempSample(struct TXW51_SERV_TEMP_CONTACTLESS_Handle *serviceHandle)
 {
     struct TXW51_SERV_CharInit charInit;
+    uint8_t initValue[TXW51_SERV_TEMP_CONTACTLESS_SAMPLE_LENGTH] = { 0 };
 
     /* Initialize characteristic. */
     TXW51_SERV_InitChar(&serviceHandle->ServiceHandle,
                         SERVICE_TEMP_CONTACTLESS_UUID_CHAR_TEMP_SAMPLE,
                         &charInit);
 
+    ble_gatts_attr_md_t cccd_md;
+    memset(&cccd_md, 0, sizeof(cccd_md));
+    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&cccd_md.read_perm);
+    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&cccd_md.write_perm);
+    cccd_md.vloc = BLE_GATTS_VLOC_STACK;
+
     /* Set up characteristic. */
-    charInit.Metadata.char_props.read = 1;
+    charInit.Metadata.char_props.read   = 1;
+    charInit.Metadata.char_props.notify = 1;
+    charInit.Metadata.p_cccd_md         = &cccd_md;
     BLE_GAP_CONN_SEC_MODE_SET_OPEN(&charInit.AttrMetadata.read_perm);
-    charInit.AttrMetadata.rd_auth = 1;
 
     /*add_desc_user_description(&charInit, (uint8_t *)SERVICE_TEMP_CONTACTLESS_STRING_CHAR_TEMP_SAMPLE);*/
 
-    charInit.Attribute.max_len = 1;
+    charInit.Attribute.init_len = sizeof(initValue);
+    charInit.Attribute.max_len  = sizeof(initValue);
+    charInit.Attribute.p_value  = initValue;
 
     /* Add characteristic. */
     return TXW51_SERV_AddChar(&serviceHandle->ServiceHandle,
@@ -20,6 +20,7 @@
 #include "txw51_framework/ble/service.h"
 
 /*----- Macros ---------------------------------------------------------------*/
+#define TXW51_SERV_TEMP_CONTACTLESS_SAMPLE_LENGTH   ( 2 )   /**< Object temperature in 0.01 degC (int16, little endian). */
 
 /*----- Data types -----------------------------------------------------------*/
 /**
@@ -27,7 +28,8 @@
  */
 enum TXW51_SERV_TEMP_CONTACTLESS_EventType {
     TXW51_SERV_TEMP_CONTACTLESS_EVT_UNKNOWN,      	/**< The event isn't known. Maybe from a damaged package. */
-    TXW51_SERV_TEMP_CONTACTLESS_EVT_TEMP_SAMPLE,   /**< Read the temperature from the sensor */
+    TXW51_SERV_TEMP_CONTACTLESS_EVT_CONNECTED,      /**< A peer has connected, start sampling. */
+    TXW51_SERV_TEMP_CONTACTLESS_EVT_DISCONNECTED,   /**< The peer has disconnected, stop sampling. */
 };
 
 /**
@@ -97,6 +99,21 @@ extern uint32_t TXW51_SERV_TEMP_CONTACTLESS_Init(struct TXW51_SERV_TEMP_CONTACTL
 extern void TXW51_SERV_TEMP_CONTACTLESS_OnBleEvent(struct TXW51_SERV_TEMP_CONTACTLESS_Handle *handle,
                                          ble_evt_t *bleEvent);
 
+/***************************************************************************//**
+* @brief Updates the temperature sample characteristic.
+*
+* The peer can read the latest sample. If it has enabled notifications, the
+* sample is sent as a notification as well.
+*
+* @param[in] handle     The handle for the service.
+* @param[in] objectTemp The object temperature in 0.01 degC.
+* @return ERR_NONE if no error occurred.
+*         ERR_SERVICE_TEMP_CONTACTLESS_HVX_COULD_NOT_SEND if the sample could
+*                                                         not be sent.
+******************************************************************************/
+extern uint32_t TXW51_SERV_TEMP_CONTACTLESS_SendTempSample(struct TXW51_SERV_TEMP_CONTACTLESS_Handle *handle,
+                                                           int16_t objectTemp);
+
 /*----- Data -----------------------------------------------------------------*/
 
 #endif // TXW51_FRAMEWORK_BLE_SERVICE_TEMP_CONTACTLESS_H_
@@ -18,6 +18,14 @@
 
 /*----- Macros ---------------------------------------------------------------*/
 
+/******************************************************************************/
+/* Firmware configuration.
+ ******************************************************************************/
+#ifndef CONFIG_BUILD_ID
+#define CONFIG_BUILD_ID             __DATE__ " " __TIME__   /**< Identifies the build in the DIS snapshot (at most 20 characters), the build can pass e.g. the commit hash with -D. */
+#endif
+
+
 /******************************************************************************/
 /* S110 configuration.
  ******************************************************************************/
@@ -34,7 +42,7 @@
 /* Scheduler configuration.
  ******************************************************************************/
 #define CONFIG_SCHED_MAX_EVENT_DATA_SIZE   sizeof(app_timer_event_t)    /**< Maximum size of scheduler events. Note that scheduler BLE stack events do not contain any data, as the events are being pulled from the stack in the event handler. */
-#define CONFIG_SCHED_QUEUE_SIZE            ( 10 )                       /**< Maximum number of events in the scheduler queue. */
+#define CONFIG_SCHED_QUEUE_SIZE            ( 16 )                       /**< Maximum number of events in the scheduler queue. */
 
 
 /******************************************************************************/
@@ -43,7 +51,7 @@
 #define LFCLK_FREQUENCY                 ( 32768UL )  /**< LFCLK frequency in Hertz, constant. */
 #define RTC_FREQUENCY                   ( 128UL )    /**< Required RTC working clock RTC_FREQUENCY Hertz. Changeable. */
 #define CONFIG_TIMERS_PRESCALER         ((LFCLK_FREQUENCY / RTC_FREQUENCY) - 1UL)   /**< Prescaler of the timers. f = LFCLK/(prescaler + 1) */
-#define CONFIG_TIMERS_MAX_TIMERS        ( 4 )  /**< Maximum number of simultaneously created timers. */
+#define CONFIG_TIMERS_MAX_TIMERS        ( 8 )  /**< Maximum number of simultaneously created timers. */
 #define CONFIG_TIMERS_OP_QUEUE_SIZE     ( 4 )  /**< Size of timer operation queues. */
 
 
@@ -67,6 +75,7 @@
 #define CONFIG_GAP_ADV_INTERVAL                     ( 64 )  /**< The advertising interval (in units of 0.625 ms. This value corresponds to 40 ms). */
 #define CONFIG_GAP_ADV_TIMEOUT_IN_SECONDS           ( 180 ) /**< The advertising timeout (in units of seconds). */
 #define CONFIG_GAP_ADV_FLAGS                        ( BLE_GAP_ADV_FLAGS_LE_ONLY_LIMITED_DISC_MODE ) /**< Flags that are set in the advertising packet. */
+#define CONFIG_GAP_ADV_COMPANY_ID                   ( 0xFFFF )  /**< Company identifier of the manufacturer specific advertising data (0xFFFF is reserved for tests and internal use). */
 
 #define CONFIG_GAP_MIN_CONN_INTERVAL                MSEC_TO_UNITS(7.5, UNIT_1_25_MS)    /**< Minimum acceptable connection interval. */
 #define CONFIG_GAP_MAX_CONN_INTERVAL                MSEC_TO_UNITS(7.5, UNIT_1_25_MS)    /**< Maximum acceptable connection interval. */
@@ -76,6 +85,9 @@
 #define CONFIG_GAP_NEXT_CONN_PARAMS_UPDATE_DELAY    APP_TIMER_TICKS(30000, CONFIG_TIMERS_PRESCALER) /**< Time between each call to sd_ble_gap_conn_param_update after the first call (30 seconds). */
 #define CONFIG_GAP_MAX_CONN_PARAMS_UPDATE_COUNT     ( 3 )                               /**< Number of attempts before giving up the connection parameter negotiation. */
 
+#define CONFIG_RADIO_NOTIFICATION_IRQ_PRIORITY      ( APP_IRQ_PRIORITY_LOW )                    /**< Interrupt priority of the radio notification, below the GPIOTE. */
+#define CONFIG_RADIO_NOTIFICATION_DISTANCE          ( NRF_RADIO_NOTIFICATION_DISTANCE_800US )   /**< Time from the active notification to the start of the radio event. */
+
 
 /******************************************************************************/
 /* GPIOTE configuration.
@@ -93,6 +105,35 @@
 #define TWI_MASTER_CONFIG_CLOCK_PIN_NUMBER (24U)
 #define TWI_MASTER_CONFIG_DATA_PIN_NUMBER (25U)
 
+
+/******************************************************************************/
+/* SPI configuration.
+ ******************************************************************************/
+#define CONFIG_SPI_FREQUENCY            ( TXW51_SPI_FREQ_1M )   /**< SPI clock until the self-test has selected one (enum TXW51_SPI_Frequency). */
+
+/******************************************************************************/
+/* I2C configuration.
+ ******************************************************************************/
+#define CONFIG_I2C_QUEUE_SIZE           ( 8 )                               /**< Maximum number of queued I2C transactions. */
+#define CONFIG_I2C_FREQUENCY            ( TWI_FREQUENCY_FREQUENCY_K100 )    /**< Bus frequency of the TWI master. */
+#define CONFIG_I2C_IRQ_PRIORITY         ( APP_IRQ_PRIORITY_LOW )            /**< Interrupt priority of the TWI master. */
+#define CONFIG_I2C_TIMEOUT_MS           ( 50 )                              /**< Longest time a transaction may take before the bus watchdog aborts it. */
+
+/******************************************************************************/
+/* Key-value store configuration.
+ ******************************************************************************/
+#define CONFIG_KVSTORE_PAGE_END                                     \
+        ((NRF_UICR->BOOTLOADERADDR != 0xFFFFFFFF)                   \
+        ? (NRF_UICR->BOOTLOADERADDR / NRF_FICR->CODEPAGESIZE)       \
+        : NRF_FICR->CODESIZE)                                       /**< First page above the store: the bootloader if there is one, the end of the flash otherwise. */
+#define CONFIG_KVSTORE_PAGE_ADDRESS     ( (uint32_t *)((CONFIG_KVSTORE_PAGE_END - 2) * NRF_FICR->CODEPAGESIZE) )    /**< First of the two flash pages of the store (the two pages below CONFIG_KVSTORE_PAGE_END, kept by DFU_APP_DATA_RESERVED). */
+#define CONFIG_KVSTORE_PAGE_SIZE        ( NRF_FICR->CODEPAGESIZE )  /**< Size of one flash page. */
+#define CONFIG_KVSTORE_MAX_KEYS         ( 16 )  /**< Number of keys. */
+#define CONFIG_KVSTORE_MAX_VALUE_LENGTH ( 32 )  /**< Maximum length of a value. */
+#define CONFIG_KVSTORE_QUEUE_SIZE       ( 8 )   /**< Maximum number of pending writes. */
+#define CONFIG_KVSTORE_RETRIES          ( 3 )   /**< Attempts of a failed flash operation before the value is discarded. */
+
+
 /******************************************************************************/
 /* Log configuration.
  ******************************************************************************/
@@ -41,6 +41,7 @@
 #define TXW51_SERV_DIS_UUID_CHAR_DEVICE_NAME    ( 0x0106 )  /**< UUID address of the device name characteristic. */
 #define TXW51_SERV_DIS_UUID_CHAR_SAVE_VALUES    ( 0x0107 )  /**< UUID address of the save values characteristic. */
 #define TXW51_SERV_DIS_UUID_CHAR_DISABLE_TIMER	( 0x0108 )  /**< UUID address of the disable Power Save Timer characteristic. */
+#define TXW51_SERV_DIS_UUID_CHAR_SNAPSHOT       ( 0x0109 )  /**< UUID address of the snapshot characteristic. */
 
 #define TXW51_SERV_DIS_STRING_CHAR_MANUFACTURER "Manufacturer"      /**< User description string for the manufacturer characteristic. */
 #define TXW51_SERV_DIS_STRING_CHAR_MODEL        "Model Name"        /**< User description string for the model name characteristic. */
@@ -50,6 +51,7 @@
 #define TXW51_SERV_DIS_STRING_CHAR_DEVICE_NAME  "Device Name"       /**< User description string for the device name characteristic. */
 #define TXW51_SERV_DIS_STRING_CHAR_SAVE_VALUES  "Save Values"       /**< User description string for the save values characteristic. */
 #define TXW51_SERV_DIS_STRING_CHAR_DISABLE_TIMER "Disable Timer"    /**< User description string for disable Power Save Timer characteristic. */
+#define TXW51_SERV_DIS_STRING_CHAR_SNAPSHOT     "Snapshot"          /**< User description string for the snapshot characteristic. */
 
 
 /******************************************************************************/
@@ -65,6 +67,8 @@
 #define SERVICE_LSM330_UUID_CHAR_GYRO_ODR       ( 0x0207 )  /**< UUID address of the gyro ODR characteristic. */
 #define SERVICE_LSM330_UUID_CHAR_TRIGGER_VAL    ( 0x0208 )  /**< UUID address of the trigger value characteristic. */
 #define SERVICE_LSM330_UUID_CHAR_TRIGGER_AXIS   ( 0x0209 )  /**< UUID address of the trigger axis characteristic. */
+#define SERVICE_LSM330_UUID_CHAR_AUTO_START     ( 0x020A )  /**< UUID address of the auto start characteristic. */
+#define SERVICE_LSM330_UUID_CHAR_STREAM_MODE    ( 0x020B )  /**< UUID address of the stream mode characteristic. */
 
 #define SERVICE_LSM330_STRING_CHAR_ACC_EN       "Turn on Accel"         /**< User description string for the acc enable characteristic. */
 #define SERVICE_LSM330_STRING_CHAR_GYRO_EN      "Turn on Gyro"          /**< User description string for the gyro enable characteristic. */
@@ -75,6 +79,8 @@
 #define SERVICE_LSM330_STRING_CHAR_GYRO_ODR     "Gyro ODR"              /**< User description string for the gyro ODR characteristic. */
 #define SERVICE_LSM330_STRING_CHAR_TRIGGER_VAL  "Trigger Value"         /**< User description string for the trigger value characteristic. */
 #define SERVICE_LSM330_STRING_CHAR_TRIGGER_AXIS "Trigger Axis"          /**< User description string for the trigger axis characteristic. */
+#define SERVICE_LSM330_STRING_CHAR_AUTO_START   "Auto Start"            /**< User description string for the auto start characteristic. */
+#define SERVICE_LSM330_STRING_CHAR_STREAM_MODE  "Stream Mode"           /**< User description string for the stream mode characteristic. */
 
 
 /******************************************************************************/
@@ -86,12 +92,15 @@
 #define TXW51_SERV_MEASURE_UUID_CHAR_DURATION   ( 0x0303 )  /**< UUID address of the duration characteristic. */
 #define TXW51_SERV_MEASURE_UUID_CHAR_DATASTRAM  ( 0x0304 )  /**< UUID address of the data stream characteristic. */
 #define TXW51_SERV_MEASURE_UUID_CHAR_ADC  		( 0x0305 )  /**< UUID address of the ADC characteristic. */
+#define TXW51_SERV_MEASURE_UUID_CHAR_DIAGNOSTICS ( 0x0306 )  /**< UUID address of the diagnostics characteristic. */
+#define TXW51_SERV_MEASURE_UUID_CHAR_CONTROL    ( 0x0307 )  /**< UUID address of the control point characteristic. */
 
 #define TXW51_SERV_MEASURE_STRING_CHAR_START        "Start Measurement"     /**< User description string for the start characteristic. */
 #define TXW51_SERV_MEASURE_STRING_CHAR_STOP         "Stop Measurement"      /**< User description string for the stop characteristic. */
 #define TXW51_SERV_MEASURE_STRING_CHAR_DURATION     "Set Measur. Duration"  /**< User description string for the duration characteristic. */
 #define TXW51_SERV_MEASURE_STRING_CHAR_DATASTREAM   "Read Data from Sensor" /**< User description string for the data stream characteristic. */
 #define TXW51_SERV_MEASURE_STRING_CHAR_ADC   		"Read ADC" 				/**< User description string for the ADC characteristic. */
+#define TXW51_SERV_MEASURE_STRING_CHAR_CONTROL      "Control Point"         /**< User description string for the control point characteristic. */
 
 /******************************************************************************/
 /* Definitions for the contactless temperature Service.
@@ -109,11 +118,15 @@
 #define SERVICE_I2C_UUID_CHAR_REGISTER			( 0x0502 )  /**< UUID address of the I2C Register characteristic. */
 #define SERVICE_I2C_UUID_CHAR_LENGTH			( 0x0503 )  /**< UUID address of the I2C Register characteristic. */
 #define SERVICE_I2C_UUID_CHAR_REGISTER_VALUE  	( 0x0504 )  /**< UUID address of the I2C Value characteristic. */
+#define SERVICE_I2C_UUID_CHAR_SCRIPT			( 0x0505 )  /**< UUID address of the I2C Script characteristic. */
+#define SERVICE_I2C_UUID_CHAR_POLL				( 0x0506 )  /**< UUID address of the I2C Poll characteristic. */
 
 #define SERVICE_I2C_STRING_CHAR_ADDRESS  		"address"    		/**< User description string for the I2C address characteristic. */
 #define SERVICE_I2C_STRING_CHAR_REGISTER  		"register"    		/**< User description string for the I2C register characteristic. */
 #define SERVICE_I2C_STRING_CHAR_LENGTH  		"length"    		/**< User description string for the I2C register characteristic. */
 #define SERVICE_I2C_STRING_CHAR_REGISTER_VALUE  "Register Value"    /**< User description string for the I2C Register Value characteristic. */
+#define SERVICE_I2C_STRING_CHAR_SCRIPT  		"Script"    		/**< User description string for the I2C Script characteristic. */
+#define SERVICE_I2C_STRING_CHAR_POLL  			"Poll"    			/**< User description string for the I2C Poll characteristic. */
 
 /*----- Data types -----------------------------------------------------------*/
 
@@ -0,0 +1,114 @@
+/***************************************************************************//**
+ * @brief   Module to write and erase the internal flash of the TXW51.
+ *
+ * @file    flash.c
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+/*----- Header-Files ---------------------------------------------------------*/
+#include "flash.h"
+
+#include <stddef.h>
+
+#include "nrf/nrf.h"
+#include "nrf/s110/nrf_soc.h"
+
+#include "txw51_framework/utils/txw51_errors.h"
+
+/*----- Macros ---------------------------------------------------------------*/
+
+/*----- Data types -----------------------------------------------------------*/
+
+/*----- Function prototypes --------------------------------------------------*/
+
+/*----- Data -----------------------------------------------------------------*/
+static TXW51_FLASH_Callback_t flashCallback = NULL;     /**< Callback of the user. */
+static volatile bool isOperationPending = false;        /**< Flag to indicate when an operation is pending. */
+
+/*----- Implementation -------------------------------------------------------*/
+
+void TXW51_FLASH_Init(TXW51_FLASH_Callback_t callback)
+{
+    flashCallback = callback;
+    isOperationPending = false;
+}
+
+
+uint32_t TXW51_FLASH_Write(uint32_t *address,
+                           const uint32_t *data,
+                           uint32_t words)
+{
+    uint32_t err;
+
+    if (isOperationPending) {
+        return ERR_FLASH_BUSY;
+    }
+
+    isOperationPending = true;
+    err = sd_flash_write(address, data, words);
+    if (err != NRF_SUCCESS) {
+        isOperationPending = false;
+        return (err == NRF_ERROR_BUSY) ? ERR_FLASH_BUSY : ERR_FLASH_OPERATION_FAILED;
+    }
+
+    return ERR_NONE;
+}
+
+
+uint32_t TXW51_FLASH_ErasePage(uint32_t *pageAddress)
+{
+    uint32_t err;
+
+    if (isOperationPending) {
+        return ERR_FLASH_BUSY;
+    }
+
+    isOperationPending = true;
+    err = sd_flash_page_erase((uint32_t)pageAddress / NRF_FICR->CODEPAGESIZE);
+    if (err != NRF_SUCCESS) {
+        isOperationPending = false;
+        return (err == NRF_ERROR_BUSY) ? ERR_FLASH_BUSY : ERR_FLASH_OPERATION_FAILED;
+    }
+
+    return ERR_NONE;
+}
+
+
+bool TXW51_FLASH_IsBusy(void)
+{
+    return isOperationPending;
+}
+
+
+void TXW51_FLASH_OnSysEvent(uint32_t sysEvent)
+{
+    uint32_t err;
+
+    switch (sysEvent) {
+        case NRF_EVT_FLASH_OPERATION_SUCCESS:
+            err = ERR_NONE;
+            break;
+
+        case NRF_EVT_FLASH_OPERATION_ERROR:
+            err = ERR_FLASH_OPERATION_FAILED;
+            break;
+
+        default:
+            return;
+    }
+
+    if (!isOperationPending) {
+        /* Not started by this module. */
+        return;
+    }
+    isOperationPending = false;
+
+    if (flashCallback != NULL) {
+        flashCallback(err);
+    }
+}
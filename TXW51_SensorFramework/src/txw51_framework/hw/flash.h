@@ -0,0 +1,95 @@
+/***************************************************************************//**
+ * @brief   Module to write and erase the internal flash of the TXW51.
+ *
+ * The operations are executed by the Softdevice between radio events. Only
+ * one operation can be pending at a time, its result is reported over the
+ * callback. Reading is done directly over the memory map.
+ *
+ * @file    flash.h
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+#ifndef TXW51_FRAMEWORK_HW_FLASH_H_
+#define TXW51_FRAMEWORK_HW_FLASH_H_
+
+/*----- Header-Files ---------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+
+/*----- Macros ---------------------------------------------------------------*/
+
+/*----- Data types -----------------------------------------------------------*/
+/**
+ * @brief Callback that gets called when a flash operation has finished.
+ *
+ * @param[in] err ERR_NONE if the operation succeeded,
+ *                ERR_FLASH_OPERATION_FAILED otherwise.
+ */
+typedef void (*TXW51_FLASH_Callback_t) (uint32_t err);
+
+/*----- Function prototypes --------------------------------------------------*/
+
+/***************************************************************************//**
+ * @brief Initializes the flash module.
+ *
+ * @param[in] callback Gets called when an operation has finished.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+extern void TXW51_FLASH_Init(TXW51_FLASH_Callback_t callback);
+
+/***************************************************************************//**
+ * @brief Starts writing words to the flash.
+ *
+ * The destination has to be erased. The data buffer has to stay valid until
+ * the callback has been called.
+ *
+ * @param[in] address Word aligned destination in the flash.
+ * @param[in] data    The words to write.
+ * @param[in] words   Number of words to write.
+ *
+ * @return ERR_NONE if the operation has been started.
+ *         ERR_FLASH_BUSY if another operation is pending.
+ *         ERR_FLASH_OPERATION_FAILED if the operation was not accepted.
+ ******************************************************************************/
+extern uint32_t TXW51_FLASH_Write(uint32_t *address,
+                                  const uint32_t *data,
+                                  uint32_t words);
+
+/***************************************************************************//**
+ * @brief Starts erasing a flash page.
+ *
+ * @param[in] pageAddress Address of the first word of the page.
+ *
+ * @return ERR_NONE if the operation has been started.
+ *         ERR_FLASH_BUSY if another operation is pending.
+ *         ERR_FLASH_OPERATION_FAILED if the operation was not accepted.
+ ******************************************************************************/
+extern uint32_t TXW51_FLASH_ErasePage(uint32_t *pageAddress);
+
+/***************************************************************************//**
+ * @brief Checks if a flash operation is pending.
+ *
+ * @return True if an operation is pending.
+ ******************************************************************************/
+extern bool TXW51_FLASH_IsBusy(void);
+
+/***************************************************************************//**
+ * @brief System event handler of the flash module.
+ *
+ * Has to be called with every system event of the Softdevice.
+ *
+ * @param[in] sysEvent The system event that occurred.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+extern void TXW51_FLASH_OnSysEvent(uint32_t sysEvent);
+
+/*----- Data -----------------------------------------------------------------*/
+
+#endif /* TXW51_FRAMEWORK_HW_FLASH_H_ */
@@ -131,6 +131,24 @@ void TXW51_GPIO_SetSenseInterrupt(enum TXW51_GPIO_Pin pinNumber,
 }
 
 
+void TXW51_GPIOTE_SetPortInterrupt(void)
+{
+    NRF_GPIOTE->EVENTS_PORT = 0;
+    NRF_GPIOTE->INTENSET = GPIOTE_INTENSET_PORT_Msk;
+
+    sd_nvic_ClearPendingIRQ(GPIOTE_IRQn);
+    sd_nvic_SetPriority(GPIOTE_IRQn, TXW51_GPIOTE_IRQ_PRIORITY);
+    sd_nvic_EnableIRQ(GPIOTE_IRQn);
+}
+
+
+void TXW51_GPIOTE_ClearPortInterrupt(void)
+{
+    NRF_GPIOTE->INTENCLR = GPIOTE_INTENCLR_PORT_Msk;
+    NRF_GPIOTE->EVENTS_PORT = 0;
+}
+
+
 /***************************************************************************//**
  * @brief Configures a GPIO pin as a LED output.
  *
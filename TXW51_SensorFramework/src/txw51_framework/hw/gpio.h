@@ -153,6 +153,24 @@ extern void TXW51_GPIOTE_SetInterrupt(uint32_t channel,
                                       enum TXW51_GPIO_Pin pinNumber,
                                       nrf_gpiote_polarity_t polarity);
 
+/***************************************************************************//**
+ * @brief Enables the interrupt of the GPIOTE PORT event.
+ *
+ * The PORT event is generated by the pins with the sense functionality (see
+ * TXW51_GPIO_SetSenseInterrupt()). Unlike a GPIOTE channel, it does not need
+ * the HFCLK and can be used while the device waits in System ON.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+extern void TXW51_GPIOTE_SetPortInterrupt(void);
+
+/***************************************************************************//**
+ * @brief Disables the interrupt of the GPIOTE PORT event.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+extern void TXW51_GPIOTE_ClearPortInterrupt(void);
+
 /*----- Data -----------------------------------------------------------------*/
 
 #endif /* TXW51_FRAMEWORK_HW_GPIO_H_ */
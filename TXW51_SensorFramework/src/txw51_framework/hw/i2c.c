@@ -1,7 +1,7 @@
 /***************************************************************************//**
  * @brief   Module to initialize and use an I2C interface on the TXW51.
  *
- * @file    i2c.h
+ * @file    i2c.c
  * @version 1.0
  * @date    24.04.2015
  * @author  Pascal Bohni
@@ -13,121 +13,538 @@
 /*----- Header-Files ---------------------------------------------------------*/
 #include "i2c.h"
 
+#include <string.h>
+
 #include "nrf/nrf.h"
+#include "nrf/nrf_delay.h"
+#include "nrf/nrf_gpio.h"
+#include "nrf/s110/nrf_soc.h"
+#include "nrf/app_common/app_scheduler.h"
+#include "nrf/app_common/app_timer.h"
 #include "nrf/sd_common/app_util_platform.h"
 
+#include "txw51_framework/config/config.h"
 #include "txw51_framework/hw/gpio.h"
 #include "txw51_framework/utils/log.h"
 #include "txw51_framework/utils/txw51_errors.h"
 
 /*----- Macros ---------------------------------------------------------------*/
+#define I2C_PIN_SCL                 ( TWI_MASTER_CONFIG_CLOCK_PIN_NUMBER )  /**< Clock pin of the bus. */
+#define I2C_PIN_SDA                 ( TWI_MASTER_CONFIG_DATA_PIN_NUMBER )   /**< Data pin of the bus. */
+#define I2C_CLEAR_BUS_PULSES        ( 18 )      /**< Maximum number of clock pulses to release a stuck slave. */
+#define I2C_CLEAR_BUS_DELAY_US      ( 4 )       /**< Half period of the clock pulses while clearing the bus. */
+#define I2C_TIMEOUT_TICKS           ( APP_TIMER_TICKS(CONFIG_I2C_TIMEOUT_MS, CONFIG_TIMERS_PRESCALER) )   /**< Timeout of a transaction in RTC ticks, also the period of the watchdog. */
+
+#define I2C_PIN_CONFIG  ((GPIO_PIN_CNF_SENSE_Disabled << GPIO_PIN_CNF_SENSE_Pos) | \
+                         (GPIO_PIN_CNF_DRIVE_S0D1     << GPIO_PIN_CNF_DRIVE_Pos) | \
+                         (GPIO_PIN_CNF_PULL_Pullup    << GPIO_PIN_CNF_PULL_Pos)  | \
+                         (GPIO_PIN_CNF_INPUT_Connect  << GPIO_PIN_CNF_INPUT_Pos))   /**< Open drain configuration of the bus pins without direction. */
 
 /*----- Data types -----------------------------------------------------------*/
+/**
+ * @brief The states of the TWI state machine.
+ */
+enum I2C_State {
+    I2C_STATE_IDLE,             /**< No transaction is running. */
+    I2C_STATE_TX_REGISTER,      /**< The register address is being sent. */
+    I2C_STATE_TX_DATA,          /**< The data bytes of a write are being sent. */
+    I2C_STATE_RX_DATA,          /**< The data bytes of a read are being received. */
+    I2C_STATE_STOPPING          /**< Waiting for the stop condition. */
+};
+
+/**
+ * @brief A queued I2C transaction.
+ */
+struct I2C_Transaction {
+    uint8_t  Address;                           /**< 7 bit address of the device. */
+    uint8_t  Register;                          /**< Register to read from or write to. */
+    bool     IsRead;                            /**< True for a read, false for a write. */
+    uint8_t  Length;                            /**< Number of data bytes. */
+    uint8_t  Data[TXW51_I2C_MAX_DATA_LENGTH];   /**< Data to write or read data. */
+    uint32_t Result;                            /**< Result of the transaction. */
+    TXW51_I2C_Callback_t Callback;              /**< Callback to the caller. */
+    void     *Context;                          /**< Context for the callback. */
+};
 
 /*----- Function prototypes --------------------------------------------------*/
-//static void I2C_EventHandler();
+static bool I2C_ClearBus(void);
+static void I2C_StartNext(void);
+static void I2C_Finish(void);
+static void I2C_ScheduleCompletion(void);
+static void I2C_CompletionHandler(void *eventData, uint16_t eventSize);
+static uint32_t I2C_Enqueue(struct I2C_Transaction *transaction);
+static void I2C_WatchdogHandler(void *context);
+static void I2C_Abort(void);
 
 /*----- Data -----------------------------------------------------------------*/
-
+static struct I2C_Transaction queue[CONFIG_I2C_QUEUE_SIZE];    /**< Ring buffer of the transactions. */
+static uint8_t queueWriteIdx;               /**< Slot for the next queued transaction. */
+static uint8_t queueActiveIdx;              /**< Slot of the running or next transaction. */
+static uint8_t queueReleaseIdx;             /**< Oldest finished slot that waits for its callback. */
+static volatile uint8_t queuePending;       /**< Number of transactions that have not finished yet. */
+static volatile uint8_t queueFinished;      /**< Number of finished transactions that wait for their callback. */
+static volatile uint8_t queueUsed;          /**< Number of occupied slots. */
+static volatile bool isCompletionScheduled; /**< Whether the completion handler is already in the scheduler. */
+
+static volatile enum I2C_State state = I2C_STATE_IDLE;   /**< State of the running transaction. */
+static uint8_t dataIdx;                     /**< Index of the next data byte of the running transaction. */
+static uint32_t activeStart;                /**< RTC counter when the running transaction has been started. */
+static app_timer_id_t watchdogTimer;        /**< Aborts a transaction that takes too long. */
 
 /*----- Implementation -------------------------------------------------------*/
 
+uint32_t TXW51_I2C_Init(void)
+{
+    uint32_t err;
+
+    NRF_TWI1->ENABLE = TWI_ENABLE_ENABLE_Disabled << TWI_ENABLE_ENABLE_Pos;
+
+    /* The pins keep a defined level even if the TWI is disabled. */
+    NRF_GPIO->PIN_CNF[I2C_PIN_SCL] = I2C_PIN_CONFIG | (GPIO_PIN_CNF_DIR_Input << GPIO_PIN_CNF_DIR_Pos);
+    NRF_GPIO->PIN_CNF[I2C_PIN_SDA] = I2C_PIN_CONFIG | (GPIO_PIN_CNF_DIR_Input << GPIO_PIN_CNF_DIR_Pos);
+
+    if (!I2C_ClearBus()) {
+        TXW51_LOG_WARNING("[I2C] Bus is stuck.");
+        return ERR_I2C_INIT_FAILED;
+    }
+
+    queueWriteIdx = 0;
+    queueActiveIdx = 0;
+    queueReleaseIdx = 0;
+    queuePending = 0;
+    queueFinished = 0;
+    queueUsed = 0;
+    isCompletionScheduled = false;
+    state = I2C_STATE_IDLE;
+
+    err = app_timer_create(&watchdogTimer,
+                           APP_TIMER_MODE_REPEATED,
+                           I2C_WatchdogHandler);
+    if (err != NRF_SUCCESS) {
+        TXW51_LOG_WARNING("[I2C] Could not create watchdog timer.");
+        return ERR_I2C_INIT_FAILED;
+    }
+
+    NRF_TWI1->PSELSCL   = I2C_PIN_SCL;
+    NRF_TWI1->PSELSDA   = I2C_PIN_SDA;
+    NRF_TWI1->FREQUENCY = CONFIG_I2C_FREQUENCY << TWI_FREQUENCY_FREQUENCY_Pos;
+    NRF_TWI1->SHORTS    = 0;
+
+    NRF_TWI1->EVENTS_STOPPED  = 0;
+    NRF_TWI1->EVENTS_RXDREADY = 0;
+    NRF_TWI1->EVENTS_TXDSENT  = 0;
+    NRF_TWI1->EVENTS_ERROR    = 0;
+    NRF_TWI1->INTENSET = TWI_INTENSET_STOPPED_Msk  |
+                         TWI_INTENSET_RXDREADY_Msk |
+                         TWI_INTENSET_TXDSENT_Msk  |
+                         TWI_INTENSET_ERROR_Msk;
+
+    err  = sd_nvic_ClearPendingIRQ(SPI1_TWI1_IRQn);
+    err |= sd_nvic_SetPriority(SPI1_TWI1_IRQn, CONFIG_I2C_IRQ_PRIORITY);
+    err |= sd_nvic_EnableIRQ(SPI1_TWI1_IRQn);
+    if (err != NRF_SUCCESS) {
+        TXW51_LOG_WARNING("[I2C] Could not enable interrupt.");
+        return ERR_I2C_INIT_FAILED;
+    }
+
+    NRF_TWI1->ENABLE = TWI_ENABLE_ENABLE_Enabled << TWI_ENABLE_ENABLE_Pos;
+
+    TXW51_LOG_DEBUG("[I2C] Initialization successful.");
+    return ERR_NONE;
+}
+
+
+void TXW51_I2C_Deinit(void)
+{
+    sd_nvic_DisableIRQ(SPI1_TWI1_IRQn);
+    app_timer_stop(watchdogTimer);
+
+    NRF_TWI1->INTENCLR = 0xFFFFFFFF;
+    NRF_TWI1->ENABLE   = TWI_ENABLE_ENABLE_Disabled << TWI_ENABLE_ENABLE_Pos;
+
+    queueWriteIdx = 0;
+    queueActiveIdx = 0;
+    queueReleaseIdx = 0;
+    queuePending = 0;
+    queueFinished = 0;
+    queueUsed = 0;
+    state = I2C_STATE_IDLE;
+
+    TXW51_LOG_DEBUG("[I2C] Deinitialized.");
+}
+
+
+uint32_t TXW51_I2C_ReadAsync(uint8_t addr,
+                             uint8_t reg,
+                             uint8_t len,
+                             TXW51_I2C_Callback_t callback,
+                             void *context)
+{
+    if ((len == 0) || (len > TXW51_I2C_MAX_DATA_LENGTH)) {
+        return ERR_I2C_INVALID_LENGTH;
+    }
+
+    struct I2C_Transaction transaction = {
+        .Address  = addr,
+        .Register = reg,
+        .IsRead   = true,
+        .Length   = len,
+        .Callback = callback,
+        .Context  = context
+    };
+
+    return I2C_Enqueue(&transaction);
+}
+
+
+uint32_t TXW51_I2C_WriteAsync(uint8_t addr,
+                              uint8_t reg,
+                              const uint8_t *values,
+                              uint8_t len,
+                              TXW51_I2C_Callback_t callback,
+                              void *context)
+{
+    if (len > TXW51_I2C_MAX_DATA_LENGTH) {
+        return ERR_I2C_INVALID_LENGTH;
+    }
+
+    struct I2C_Transaction transaction = {
+        .Address  = addr,
+        .Register = reg,
+        .IsRead   = false,
+        .Length   = len,
+        .Callback = callback,
+        .Context  = context
+    };
+    memcpy(transaction.Data, values, len);
+
+    return I2C_Enqueue(&transaction);
+}
+
+
+bool TXW51_I2C_IsIdle(void)
+{
+    return (queueUsed == 0);
+}
+
+
+void TXW51_I2C_HandleInterrupt(void)
+{
+    struct I2C_Transaction *active = &queue[queueActiveIdx];
+
+    if (NRF_TWI1->EVENTS_ERROR) {
+        NRF_TWI1->EVENTS_ERROR = 0;
+        NRF_TWI1->ERRORSRC = NRF_TWI1->ERRORSRC;
+
+        active->Result = active->IsRead ? ERR_I2C_READ_FAILED : ERR_I2C_WRITE_FAILED;
+        state = I2C_STATE_STOPPING;
+        NRF_TWI1->SHORTS = 0;
+        NRF_TWI1->TASKS_RESUME = 1;
+        NRF_TWI1->TASKS_STOP = 1;
+    }
+
+    if (NRF_TWI1->EVENTS_TXDSENT) {
+        NRF_TWI1->EVENTS_TXDSENT = 0;
+
+        if (state == I2C_STATE_TX_REGISTER) {
+            if (active->IsRead) {
+                /* Suspend after each byte, so the last one can be followed by a stop. */
+                state = I2C_STATE_RX_DATA;
+                dataIdx = 0;
+                NRF_TWI1->SHORTS = (active->Length == 1) ? TWI_SHORTS_BB_STOP_Msk :
+                                                           TWI_SHORTS_BB_SUSPEND_Msk;
+                NRF_TWI1->TASKS_STARTRX = 1;
+            } else if (active->Length == 0) {
+                state = I2C_STATE_STOPPING;
+                NRF_TWI1->TASKS_STOP = 1;
+            } else {
+                state = I2C_STATE_TX_DATA;
+                dataIdx = 0;
+                NRF_TWI1->TXD = active->Data[dataIdx++];
+            }
+        } else if (state == I2C_STATE_TX_DATA) {
+            if (dataIdx < active->Length) {
+                NRF_TWI1->TXD = active->Data[dataIdx++];
+            } else {
+                state = I2C_STATE_STOPPING;
+                NRF_TWI1->TASKS_STOP = 1;
+            }
+        }
+    }
+
+    if (NRF_TWI1->EVENTS_RXDREADY) {
+        NRF_TWI1->EVENTS_RXDREADY = 0;
+
+        if (state == I2C_STATE_RX_DATA) {
+            active->Data[dataIdx++] = NRF_TWI1->RXD;
+
+            if (dataIdx >= active->Length) {
+                /* The BB_STOP shortcut issues the stop condition. */
+                state = I2C_STATE_STOPPING;
+            } else {
+                if (dataIdx == (active->Length - 1)) {
+                    NRF_TWI1->SHORTS = TWI_SHORTS_BB_STOP_Msk;
+                }
+                NRF_TWI1->TASKS_RESUME = 1;
+            }
+        }
+    }
+
+    if (NRF_TWI1->EVENTS_STOPPED) {
+        NRF_TWI1->EVENTS_STOPPED = 0;
+        NRF_TWI1->SHORTS = 0;
+
+        if (state != I2C_STATE_IDLE) {
+            I2C_Finish();
+            I2C_StartNext();
+        }
+    }
+}
+
+
 /***************************************************************************//**
- * @brief Function that handles the events from the SPI0 interface.
+ * @brief Copies a transaction into the queue and starts it if the bus is idle.
  *
- * @param[in] event The event that was generated.
+ * @param[in] transaction The transaction to queue.
  *
- * @return Nothing.
+ * @return ERR_NONE if the transaction has been queued.
+ *         ERR_I2C_QUEUE_FULL if the queue is full.
  ******************************************************************************/
-//static void I2C_EventHandler()
-//{
-//
-//}
+static uint32_t I2C_Enqueue(struct I2C_Transaction *transaction)
+{
+    uint32_t err = ERR_NONE;
+    bool isStarted = false;
+
+    transaction->Result = ERR_NONE;
+
+    CRITICAL_REGION_ENTER();
+    /* Retry a completion event that did not fit into the scheduler. */
+    I2C_ScheduleCompletion();
+
+    if (queueUsed >= CONFIG_I2C_QUEUE_SIZE) {
+        err = ERR_I2C_QUEUE_FULL;
+    } else {
+        queue[queueWriteIdx] = *transaction;
+        queueWriteIdx = (queueWriteIdx + 1) % CONFIG_I2C_QUEUE_SIZE;
+        queueUsed++;
+        queuePending++;
+
+        if (state == I2C_STATE_IDLE) {
+            I2C_StartNext();
+            isStarted = true;
+        }
+    }
+    CRITICAL_REGION_EXIT();
+
+    if (err != ERR_NONE) {
+        TXW51_LOG_WARNING("[I2C] Queue is full.");
+    }
+    /* Runs while the bus is busy, a running watchdog ignores the start. */
+    if (isStarted) {
+        app_timer_start(watchdogTimer, I2C_TIMEOUT_TICKS, NULL);
+    }
+    return err;
+}
 
-uint32_t TXW51_I2C_Init()
+
+/***************************************************************************//**
+ * @brief Starts the next pending transaction by sending the register address.
+ *
+ * Must be called from the interrupt or inside a critical region.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void I2C_StartNext(void)
 {
+    I2C_ScheduleCompletion();
 
-    /* Configure I2C master. */
+    if (queuePending == 0) {
+        state = I2C_STATE_IDLE;
+        return;
+    }
 
-    TXW51_LOG_DEBUG("[TXW51_I2C] INIT");
+    struct I2C_Transaction *active = &queue[queueActiveIdx];
 
-    return ERR_NONE;
+    app_timer_cnt_get(&activeStart);
+    state = I2C_STATE_TX_REGISTER;
+    NRF_TWI1->SHORTS  = 0;
+    NRF_TWI1->ADDRESS = active->Address;
+    NRF_TWI1->TXD     = active->Register;
+    NRF_TWI1->TASKS_STARTTX = 1;
 }
 
 
-void TXW51_I2C_Deinit()
+/***************************************************************************//**
+ * @brief Marks the running transaction as finished.
+ *
+ * The callback is executed by the scheduler. Only one scheduler event is
+ * outstanding at a time, the handler processes all finished transactions.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void I2C_Finish(void)
 {
+    queueActiveIdx = (queueActiveIdx + 1) % CONFIG_I2C_QUEUE_SIZE;
+    queuePending--;
+    queueFinished++;
 
-    TXW51_LOG_DEBUG("TXW51_I2C_DEINIT");
+    I2C_ScheduleCompletion();
 }
 
 
-uint32_t TXW51_I2C_Read(uint8_t addr,
-						uint8_t reg,
-                        uint8_t *values,
-                        uint32_t len)
+/***************************************************************************//**
+ * @brief Puts the completion handler into the scheduler if it is needed.
+ *
+ * If the scheduler queue is full, the put is retried with the next
+ * transaction that is queued or started.
+ *
+ * Must be called from the interrupt or inside a critical region.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void I2C_ScheduleCompletion(void)
 {
-
-	// initialize values to zero so we don't return random values.
-	for (int i = 0; i < len; i++)
-	{
-		values[i] = 0;
-	}
-
-	if (!twi_master_init())
-	{
-		TXW51_LOG_WARNING("[TXW51_I2C Read]: twi master init failed!");
-		return ERR_I2C_INIT_FAILED;
-	}
-
-	// Write: register address we want to start reading from
-	if (twi_master_transfer((addr << 1), &reg, 1, TWI_DONT_ISSUE_STOP))
-	{
-		// Read: the number of bytes requested.
-		if (twi_master_transfer((addr << 1) | TWI_READ_BIT, values, len, TWI_ISSUE_STOP))
-		{
-			TXW51_LOG_DEBUG("[TXW51_I2C Read]: success");
-			// Read succeeded.
-			return ERR_NONE;
-		}
-	}
-
-	// read or write failed.
-	return ERR_I2C_READ_FAILED;
+    if ((queueFinished > 0) && !isCompletionScheduled) {
+        if (app_sched_event_put(NULL, 0, I2C_CompletionHandler) == NRF_SUCCESS) {
+            isCompletionScheduled = true;
+        }
+    }
 }
 
 
-uint32_t TXW51_I2C_Write(	uint8_t addr,
-							uint8_t reg,
-							uint8_t *values,
-	                        uint32_t len)
+/***************************************************************************//**
+ * @brief Calls the callbacks of all finished transactions.
+ *
+ * Runs in the main context. The slot is released after the callback, so the
+ * callback can queue the next transaction.
+ *
+ * @param[in] eventData Not used.
+ * @param[in] eventSize Not used.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void I2C_CompletionHandler(void *eventData, uint16_t eventSize)
 {
+    isCompletionScheduled = false;
 
+    while (queueFinished > 0) {
+        struct I2C_Transaction *done = &queue[queueReleaseIdx];
 
-	if (!twi_master_init())
-	{
-		TXW51_LOG_WARNING("[TXW51_I2C Write]: twi master init failed!");
-		return ERR_I2C_INIT_FAILED;
-	}
+        if (done->Callback != NULL) {
+            done->Callback(done->Result, done->Data, done->Length, done->Context);
+        }
 
-	uint8_t command[len+1];
-	uint8_t i;
+        CRITICAL_REGION_ENTER();
+        queueReleaseIdx = (queueReleaseIdx + 1) % CONFIG_I2C_QUEUE_SIZE;
+        queueFinished--;
+        queueUsed--;
+        CRITICAL_REGION_EXIT();
+    }
+}
 
-	command[0] = reg;
-	for (i=0; i < len; i++)
-	{
-		command[i+1] = values[i];
-	}
 
-	// Write: register address we want to start reading from
-	if (twi_master_transfer((addr << 1), command, len+1, TWI_DONT_ISSUE_STOP))
-	{
-		TXW51_LOG_DEBUG("[TXW51_I2C Write]: success");
-		// Write succeeded.
-		return ERR_NONE;
-	}
+/***************************************************************************//**
+ * @brief Aborts the running transaction if it takes too long.
+ *
+ * The timer runs while the bus is busy and stops itself when the bus is
+ * idle. A transaction gets at least CONFIG_I2C_TIMEOUT_MS.
+ *
+ * @param[in] context Not used.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void I2C_WatchdogHandler(void *context)
+{
+    uint32_t now;
+    uint32_t elapsed;
+    bool isIdle;
+    bool isAborted = false;
+
+    CRITICAL_REGION_ENTER();
+    isIdle = (state == I2C_STATE_IDLE);
+    if (!isIdle) {
+        app_timer_cnt_get(&now);
+        app_timer_cnt_diff_compute(now, activeStart, &elapsed);
+        if (elapsed >= I2C_TIMEOUT_TICKS) {
+            I2C_Abort();
+            isAborted = true;
+        }
+    }
+    CRITICAL_REGION_EXIT();
+
+    if (isIdle) {
+        app_timer_stop(watchdogTimer);
+    }
+    if (isAborted) {
+        TXW51_LOG_WARNING("[I2C] Transaction timed out.");
+    }
+}
 
 
-    return ERR_I2C_WRITE_FAILED;
+/***************************************************************************//**
+ * @brief Ends the running transaction with ERR_I2C_TIMEOUT and clears the bus.
+ *
+ * The TWI is disabled while the bus is cleared, this drops the transfer and
+ * its pending events. The next transaction is started afterwards.
+ *
+ * Must be called inside a critical region.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void I2C_Abort(void)
+{
+    NRF_TWI1->ENABLE = TWI_ENABLE_ENABLE_Disabled << TWI_ENABLE_ENABLE_Pos;
+    NRF_TWI1->SHORTS = 0;
+    NRF_TWI1->EVENTS_STOPPED  = 0;
+    NRF_TWI1->EVENTS_RXDREADY = 0;
+    NRF_TWI1->EVENTS_TXDSENT  = 0;
+    NRF_TWI1->EVENTS_ERROR    = 0;
+
+    queue[queueActiveIdx].Result = ERR_I2C_TIMEOUT;
+    I2C_ClearBus();
+
+    NRF_TWI1->ENABLE = TWI_ENABLE_ENABLE_Enabled << TWI_ENABLE_ENABLE_Pos;
+    I2C_Finish();
+    I2C_StartNext();
 }
 
+
+/***************************************************************************//**
+ * @brief Detects a stuck slave (SDA = 0 and SCL = 1) and tries to clear the bus.
+ *
+ * The TWI has to be disabled so that the pins can be controlled directly.
+ *
+ * @return True if the bus is clear.
+ ******************************************************************************/
+static bool I2C_ClearBus(void)
+{
+    bool isClear = false;
+
+    nrf_gpio_pin_set(I2C_PIN_SCL);
+    nrf_gpio_pin_set(I2C_PIN_SDA);
+    NRF_GPIO->PIN_CNF[I2C_PIN_SCL] = I2C_PIN_CONFIG | (GPIO_PIN_CNF_DIR_Output << GPIO_PIN_CNF_DIR_Pos);
+    NRF_GPIO->PIN_CNF[I2C_PIN_SDA] = I2C_PIN_CONFIG | (GPIO_PIN_CNF_DIR_Output << GPIO_PIN_CNF_DIR_Pos);
+    nrf_delay_us(I2C_CLEAR_BUS_DELAY_US);
+
+    if (nrf_gpio_pin_read(I2C_PIN_SDA) && nrf_gpio_pin_read(I2C_PIN_SCL)) {
+        isClear = true;
+    } else {
+        /* Clock until the slave releases the data line. */
+        for (int32_t i = 0; i < I2C_CLEAR_BUS_PULSES; i++) {
+            nrf_gpio_pin_clear(I2C_PIN_SCL);
+            nrf_delay_us(I2C_CLEAR_BUS_DELAY_US);
+            nrf_gpio_pin_set(I2C_PIN_SCL);
+            nrf_delay_us(I2C_CLEAR_BUS_DELAY_US);
+
+            if (nrf_gpio_pin_read(I2C_PIN_SDA)) {
+                isClear = true;
+                break;
+            }
+        }
+    }
+
+    NRF_GPIO->PIN_CNF[I2C_PIN_SCL] = I2C_PIN_CONFIG | (GPIO_PIN_CNF_DIR_Input << GPIO_PIN_CNF_DIR_Pos);
+    NRF_GPIO->PIN_CNF[I2C_PIN_SDA] = I2C_PIN_CONFIG | (GPIO_PIN_CNF_DIR_Input << GPIO_PIN_CNF_DIR_Pos);
+
+    return isClear;
+}
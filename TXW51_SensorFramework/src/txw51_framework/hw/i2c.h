@@ -1,6 +1,12 @@
 /***************************************************************************//**
  * @brief   Module to initialize and use an I2C interface on the TXW51.
  *
+ * The transactions are queued and executed interrupt driven on the TWI1
+ * peripheral. The caller gets notified over a callback that is executed by
+ * the scheduler when the transaction has finished. A transaction that takes
+ * longer than CONFIG_I2C_TIMEOUT_MS, for example because a slave stretches
+ * the clock forever, is aborted by a bus watchdog and the bus gets cleared.
+ *
  * @file    i2c.h
  * @version 1.0
  * @date    24.04.2015
@@ -14,65 +20,117 @@
 #define TXW51_FRAMEWORK_HW_I2C_H_
 
 /*----- Header-Files ---------------------------------------------------------*/
-#include "nrf/twi_master.h"
+#include <stdbool.h>
+#include <stdint.h>
 
 /*----- Macros ---------------------------------------------------------------*/
+#define TXW51_I2C_MAX_DATA_LENGTH   ( 20 )      /**< Maximum number of data bytes of a single transaction. */
 
 /*----- Data types -----------------------------------------------------------*/
+/**
+ * @brief Callback that gets called when a transaction has finished.
+ *
+ * It is executed in the main context by the scheduler. The data buffer is
+ * only valid during the callback.
+ *
+ * @param[in] err     ERR_NONE if the transaction succeeded,
+ *                    ERR_I2C_TIMEOUT if it has been aborted by the watchdog,
+ *                    ERR_I2C_READ_FAILED or ERR_I2C_WRITE_FAILED otherwise.
+ * @param[in] data    The read data, respectively the written data.
+ * @param[in] length  Number of data bytes.
+ * @param[in] context The context that was given when the transaction was queued.
+ */
+typedef void (*TXW51_I2C_Callback_t) (uint32_t err,
+                                      uint8_t *data,
+                                      uint8_t length,
+                                      void *context);
 
 /*----- Function prototypes --------------------------------------------------*/
 
 /***************************************************************************//**
  * @brief Initializes the I2C interface.
  *
+ * Configures the pins, clears a stuck bus, creates the bus watchdog timer and
+ * enables the TWI interrupt. This has to be called once, after the timer
+ * module, before any transaction is queued.
  *
  * @return ERR_NONE if no error occurred.
- *         ERR_SPI_INIT_FAILED if initialization failed.
+ *         ERR_I2C_INIT_FAILED if the bus could not be cleared or the timer
+ *         could not be created.
  ******************************************************************************/
-extern uint32_t TXW51_I2C_Init();
+extern uint32_t TXW51_I2C_Init(void);
 
 /***************************************************************************//**
  * @brief Deinitializes the I2C interface.
  *
- * This can be used to save energy on the GPIO pins.
+ * This can be used to save energy on the GPIO pins. Queued transactions are
+ * dropped without callback.
  *
  * @return Nothing.
  ******************************************************************************/
-extern void TXW51_I2C_Deinit();
+extern void TXW51_I2C_Deinit(void);
 
 /***************************************************************************//**
- * @brief Reads from the I2C interface.
+ * @brief Queues a read from the I2C interface.
  *
- * If multiple registers are read, reg is the starting address and we
- * increment afterwards.
- * @param[in] addr        Address of the i2c Device.
- * @param[in]  reg         Address of the register.
- * @param[out] values      Buffer to save the values.
- * @param[in]  n           How many bytes to read.
+ * The register address is written first and the data is read after a
+ * repeated start. If multiple registers are read, reg is the starting address
+ * and the device increments afterwards.
  *
- * @return ERR_NONE if no error occurred.
- *         ERR_SPI_READ_FAILED if the values could not be read.
+ * @param[in] addr     7 bit address of the i2c device.
+ * @param[in] reg      Address of the register.
+ * @param[in] len      How many bytes to read (1 to TXW51_I2C_MAX_DATA_LENGTH).
+ * @param[in] callback Gets called with the read data. Can be NULL.
+ * @param[in] context  Passed to the callback.
+ *
+ * @return ERR_NONE if the transaction has been queued.
+ *         ERR_I2C_INVALID_LENGTH if the length is not supported.
+ *         ERR_I2C_QUEUE_FULL if the queue is full.
  ******************************************************************************/
-extern uint32_t TXW51_I2C_Read(uint8_t addr,
-							   uint8_t reg,
-							   uint8_t *values,
-							   uint32_t len);
+extern uint32_t TXW51_I2C_ReadAsync(uint8_t addr,
+                                    uint8_t reg,
+                                    uint8_t len,
+                                    TXW51_I2C_Callback_t callback,
+                                    void *context);
 
 /***************************************************************************//**
- * @brief Writes to the I2C interface.
+ * @brief Queues a write to the I2C interface.
  *
- * @param[in] addr        Address of the i2c Device.
- * @param[in] reg         Address of the register.
- * @param[in] values      Buffer to write to the i2c.
- * @param[in] n          How many bytes to write.
+ * The values are copied, so the buffer can be released after the call.
  *
- * @return ERR_NONE if no error occurred.
- *         ERR_SPI_WRITE_FAILED if the values could not be written.
+ * @param[in] addr     7 bit address of the i2c device.
+ * @param[in] reg      Address of the register.
+ * @param[in] values   Buffer to write to the i2c.
+ * @param[in] len      How many bytes to write (0 to TXW51_I2C_MAX_DATA_LENGTH).
+ * @param[in] callback Gets called when the write has finished. Can be NULL.
+ * @param[in] context  Passed to the callback.
+ *
+ * @return ERR_NONE if the transaction has been queued.
+ *         ERR_I2C_INVALID_LENGTH if the length is not supported.
+ *         ERR_I2C_QUEUE_FULL if the queue is full.
+ ******************************************************************************/
+extern uint32_t TXW51_I2C_WriteAsync(uint8_t addr,
+                                     uint8_t reg,
+                                     const uint8_t *values,
+                                     uint8_t len,
+                                     TXW51_I2C_Callback_t callback,
+                                     void *context);
+
+/***************************************************************************//**
+ * @brief Checks if there is no queued or running transaction.
+ *
+ * @return True if the I2C module is idle.
+ ******************************************************************************/
+extern bool TXW51_I2C_IsIdle(void);
+
+/***************************************************************************//**
+ * @brief Handles the interrupt events from the TWI1 peripheral.
+ *
+ * Has to be called from the SPI1_TWI1 IRQ handler.
+ *
+ * @return Nothing.
  ******************************************************************************/
-extern uint32_t TXW51_I2C_Write(	uint8_t addr,
-									uint8_t reg,
-									uint8_t *values,
-									uint32_t len);
+extern void TXW51_I2C_HandleInterrupt(void);
 
 /*----- Data -----------------------------------------------------------------*/
 
@@ -25,6 +25,13 @@
 #include "txw51_framework/utils/txw51_errors.h"
 
 /*----- Macros ---------------------------------------------------------------*/
+#define LSM330_SHADOW_FIRST     ( 0x20 )    /**< Address of the first register in the shadow copy. */
+#define LSM330_SHADOW_SIZE      ( 0x0F )    /**< Registers 0x20..0x2E, the control registers and FIFO_CTRL_REG. */
+#define LSM330_SHADOW_CTRL_SIZE ( 0x07 )    /**< Number of control registers starting at LSM330_SHADOW_FIRST. */
+
+#define LSM330_IS_SHADOWED(addr)    ( ((addr) >= LSM330_SHADOW_FIRST) && \
+                                      ((addr) < LSM330_SHADOW_FIRST + LSM330_SHADOW_SIZE) )  /**< Checks if a register is in the shadow copy. */
+#define LSM330_SHADOW(sensor, addr) ( shadowRegisters[(sensor)][(addr) - LSM330_SHADOW_FIRST] )   /**< Shadow copy of a register. */
 
 /*----- Data types -----------------------------------------------------------*/
 /**
@@ -45,6 +52,12 @@ static uint32_t LSM330_ReadMultiSpi(enum LSM330_Sensor sensor,
                                     uint8_t addr,
                                     uint8_t *values,
                                     uint32_t n);
+static uint32_t LSM330_ReadFifoSpi(enum LSM330_Sensor sensor,
+                                   uint8_t addr,
+                                   uint8_t *values,
+                                   uint32_t numberOfSamples);
+static enum TXW51_GPIO_Pin LSM330_GetChipSelect(enum LSM330_Sensor sensor,
+                                                uint8_t *addr);
 static uint32_t LSM330_WriteSpi(enum LSM330_Sensor sensor,
                                 uint8_t addr,
                                 uint8_t value);
@@ -52,10 +65,12 @@ static uint32_t LSM330_UpdateRegister(enum LSM330_Sensor sensor,
                                       uint8_t addr,
                                       uint8_t mask,
                                       uint8_t newBits);
+static uint32_t LSM330_LoadShadow(enum LSM330_Sensor sensor);
 static uint32_t LSM330_ACC_ResetFifo(void);
 static uint32_t LSM330_GYRO_ResetFifo(void);
 
 /*----- Data -----------------------------------------------------------------*/
+static uint8_t shadowRegisters[2][LSM330_SHADOW_SIZE];  /**< Write-through copy of the control registers of both sensors. */
 
 /*----- Implementation -------------------------------------------------------*/
 
@@ -164,23 +179,42 @@ static uint32_t LSM330_ReadMultiSpi(enum LSM330_Sensor sensor,
                                     uint32_t n)
 {
     uint32_t err;
+    enum TXW51_GPIO_Pin gpio = LSM330_GetChipSelect(sensor, &addr);
 
-    enum TXW51_GPIO_Pin gpio;
-    switch (sensor) {
-        case TXW51_LSM330_ACC:
-            gpio = TXW51_LSM330_GPIO_SS_ACC;
-            break;
+    TXW51_GPIO_ClearGpio(gpio);
+    err = TXW51_SPI_Read(TXW51_SPI_0, addr, values, n);
+    TXW51_GPIO_SetGpio(gpio);
 
-        case TXW51_LSM330_GYRO:
-            gpio = TXW51_LSM330_GPIO_SS_GYRO;
-            addr |= TXW51_LSM330_FLAG_MULTI_RW;
-            break;
+    if (err != ERR_NONE) {
+        return ERR_LSM330_READ_FAILED;
     }
+    return ERR_NONE;
+}
 
-    addr |= TXW51_LSM330_FLAG_READ;
+
+/***************************************************************************//**
+ * @brief Reads samples from a FIFO with one transfer over the SPI interface.
+ *
+ * The samples land straight in values, see TXW51_SPI_ReadInPlace().
+ *
+ * @param[in]     sensor          Specifies from which sensor to read.
+ * @param[in]     addr            The first output register.
+ * @param[in,out] values          Buffer to save the samples.
+ * @param[in]     numberOfSamples The number of samples to read.
+ *
+ * @return ERR_NONE if no error occurred.
+ *         ERR_LSM330_READ_FAILED if reading from the sensor failed.
+ ******************************************************************************/
+static uint32_t LSM330_ReadFifoSpi(enum LSM330_Sensor sensor,
+                                   uint8_t addr,
+                                   uint8_t *values,
+                                   uint32_t numberOfSamples)
+{
+    uint32_t err;
+    enum TXW51_GPIO_Pin gpio = LSM330_GetChipSelect(sensor, &addr);
 
     TXW51_GPIO_ClearGpio(gpio);
-    err = TXW51_SPI_Read(TXW51_SPI_0, addr, values, n);
+    err = TXW51_SPI_ReadInPlace(TXW51_SPI_0, addr, values, numberOfSamples * 6);
     TXW51_GPIO_SetGpio(gpio);
 
     if (err != ERR_NONE) {
@@ -190,9 +224,45 @@ static uint32_t LSM330_ReadMultiSpi(enum LSM330_Sensor sensor,
 }
 
 
+/***************************************************************************//**
+ * @brief Gets the chip select of a sensor and completes the address of a
+ *        read.
+ *
+ * The gyroscope needs the flag to increment the address, the accelerometer
+ * increments by its configuration.
+ *
+ * @param[in]     sensor Specifies from which sensor to read.
+ * @param[in,out] addr   The register address, the flags get added.
+ *
+ * @return The chip select pin of the sensor.
+ ******************************************************************************/
+static enum TXW51_GPIO_Pin LSM330_GetChipSelect(enum LSM330_Sensor sensor,
+                                                uint8_t *addr)
+{
+    enum TXW51_GPIO_Pin gpio;
+    switch (sensor) {
+        case TXW51_LSM330_ACC:
+            gpio = TXW51_LSM330_GPIO_SS_ACC;
+            break;
+
+        case TXW51_LSM330_GYRO:
+        default:
+            gpio = TXW51_LSM330_GPIO_SS_GYRO;
+            *addr |= TXW51_LSM330_FLAG_MULTI_RW;
+            break;
+    }
+
+    *addr |= TXW51_LSM330_FLAG_READ;
+    return gpio;
+}
+
+
 /***************************************************************************//**
  * @brief Writes to the SPI interface.
  *
+ * The shadow copy of the control registers is updated with every successful
+ * write, so it always holds the last value written to the sensor.
+ *
  * @param[in] sensor Specifies to which sensor to write.
  * @param[in] addr   The register address of the value.
  * @param[in] value  The value to write.
@@ -224,6 +294,10 @@ static uint32_t LSM330_WriteSpi(enum LSM330_Sensor sensor,
     if (err != ERR_NONE) {
         return ERR_LSM330_WRITE_FAILED;
     }
+
+    if (LSM330_IS_SHADOWED(addr)) {
+        LSM330_SHADOW(sensor, addr) = value;
+    }
     return ERR_NONE;
 }
 
@@ -375,14 +449,10 @@ uint32_t TXW51_LSM330_GYRO_ConfigInterrupts(struct TXW51_LSM330_GYRO_Interrupts
     if (config->Int2G_Watermark) { reg |= TXW51_LSM330_REG_CTRL_REG3_G_I2_WTM;   }
     if (config->Int2G_Overrun)   { reg |= TXW51_LSM330_REG_CTRL_REG3_G_I2_ORUN;  }
 
-    /* We need to write 0 first. Or else it does not work. */
-    err = LSM330_WriteSpi(TXW51_LSM330_GYRO, TXW51_LSM330_REG_CTRL_REG3_G, 0x00);
-    if (err != ERR_NONE) {
-        TXW51_LOG_ERROR("[LSM330] Gyro: Could not configure interrupts.");
-        return err;
-    }
-
-    err = LSM330_WriteSpi(TXW51_LSM330_GYRO, TXW51_LSM330_REG_CTRL_REG3_G, reg);
+    err = LSM330_UpdateRegister(TXW51_LSM330_GYRO,
+                                TXW51_LSM330_REG_CTRL_REG3_G,
+                                0xFF,
+                                reg);
     if (err != ERR_NONE) {
         TXW51_LOG_ERROR("[LSM330] Gyro: Could not configure interrupts.");
         return err;
@@ -449,13 +519,7 @@ uint32_t TXW51_LSM330_GYRO_SetActiveAxis(struct TXW51_LSM330_Axis *axis)
 /* TODO: Maybe use unions instead of shift operations. */
 enum TXW51_LSM330_ACC_Fullscale TXW51_LSM330_ACC_GetFullscale(void)
 {
-    uint32_t err;
-    uint8_t value = 0;
-
-    err = LSM330_ReadSpi(TXW51_LSM330_ACC, TXW51_LSM330_REG_CTRL_REG6_A, &value);
-    if (err != ERR_NONE) {
-        return TXW51_LSM330_ACC_FSCALE_2G;
-    }
+    uint8_t value = LSM330_SHADOW(TXW51_LSM330_ACC, TXW51_LSM330_REG_CTRL_REG6_A);
 
     value &= TXW51_LSM330_REG_CTRL_REG6_A_FSCALE_Msk;
     value >>= TXW51_LSM330_REG_CTRL_REG6_A_FSCALE_Pos;
@@ -466,13 +530,7 @@ enum TXW51_LSM330_ACC_Fullscale TXW51_LSM330_ACC_GetFullscale(void)
 /* TODO: Maybe use unions instead of shift operations. */
 enum TXW51_LSM330_GYRO_Fullscale TXW51_LSM330_GYRO_GetFullscale(void)
 {
-    uint32_t err;
-    uint8_t value = 0;
-
-    err = LSM330_ReadSpi(TXW51_LSM330_GYRO, TXW51_LSM330_REG_CTRL_REG4_G, &value);
-    if (err != ERR_NONE) {
-        return TXW51_LSM330_GYRO_FSCALE_250DPS;
-    }
+    uint8_t value = LSM330_SHADOW(TXW51_LSM330_GYRO, TXW51_LSM330_REG_CTRL_REG4_G);
 
     value &= TXW51_LSM330_REG_CTRL_REG4_G_FS_Msk;
     value >>= TXW51_LSM330_REG_CTRL_REG4_G_FS_Pos;
@@ -521,13 +579,7 @@ uint32_t TXW51_LSM330_GYRO_SetFullscale(enum TXW51_LSM330_GYRO_Fullscale fullsca
 /* TODO: Maybe use unions instead of shift operations. */
 enum TXW51_LSM330_ACC_Odr TXW51_LSM330_ACC_GetOdr(void)
 {
-    uint32_t err;
-    uint8_t value = 0;
-
-    err = LSM330_ReadSpi(TXW51_LSM330_ACC, TXW51_LSM330_REG_CTRL_REG5_A, &value);
-    if (err != ERR_NONE) {
-        return TXW51_LSM330_ACC_ODR_OFF;
-    }
+    uint8_t value = LSM330_SHADOW(TXW51_LSM330_ACC, TXW51_LSM330_REG_CTRL_REG5_A);
 
     value &= TXW51_LSM330_REG_CTRL_REG5_A_ODR_Msk;
     value >>= TXW51_LSM330_REG_CTRL_REG5_A_ODR_Pos;
@@ -538,13 +590,7 @@ enum TXW51_LSM330_ACC_Odr TXW51_LSM330_ACC_GetOdr(void)
 /* TODO: Maybe use unions instead of shift operations. */
 enum TXW51_LSM330_GYRO_Odr TXW51_LSM330_GYRO_GetOdr(void)
 {
-    uint32_t err;
-    uint8_t value = 0;
-
-    err = LSM330_ReadSpi(TXW51_LSM330_GYRO, TXW51_LSM330_REG_CTRL_REG1_G, &value);
-    if (err != ERR_NONE) {
-        return TXW51_LSM330_GYRO_ODR_95;
-    }
+    uint8_t value = LSM330_SHADOW(TXW51_LSM330_GYRO, TXW51_LSM330_REG_CTRL_REG1_G);
 
     value &= TXW51_LSM330_REG_CTRL_REG1_G_DR_Msk;
     value >>= TXW51_LSM330_REG_CTRL_REG1_G_DR_Pos;
@@ -633,16 +679,16 @@ uint32_t TXW51_LSM330_EnableGyro(bool enable)
 * @brief Updates the value of a register.
 *
 * This function simplifies the process when only some bits need to change. It
-* reads the old value and changes only the specified bits. Then it writes the
-* new value to the register.
+* takes the old value from the shadow copy and changes only the specified
+* bits. Then it writes the new value to the register, unless it did not change.
+* Only registers in the shadow copy can be updated.
 *
-* @param[in] sensor  Specifies from which sensor to read.
+* @param[in] sensor  Specifies to which sensor to write.
 * @param[in] addr    The register address of the value.
 * @param[in] mask    Specifies which bits need to change.
 * @param[in] newBits Specifies the value of the bits that need to change.
 *
 * @return ERR_NONE if no error occurred.
-*         ERR_LSM330_READ_FAILED if reading from the sensor failed.
 *         ERR_LSM330_WRITE_FAILED if writing to the sensor failed.
 ******************************************************************************/
 static uint32_t LSM330_UpdateRegister(enum LSM330_Sensor sensor,
@@ -650,23 +696,46 @@ static uint32_t LSM330_UpdateRegister(enum LSM330_Sensor sensor,
                                       uint8_t mask,
                                       uint8_t newBits)
 {
-    uint32_t err;
-    uint8_t value = 0;
-
-    err = LSM330_ReadSpi(sensor, addr, &value);
-    if (err != ERR_NONE) {
-        return err;
-    }
+    uint8_t value = LSM330_SHADOW(sensor, addr);
 
     value &= ~mask;
     value |= (newBits & mask);
 
-    err = LSM330_WriteSpi(sensor, addr, value);
+    if (value == LSM330_SHADOW(sensor, addr)) {
+        return ERR_NONE;
+    }
+
+    return LSM330_WriteSpi(sensor, addr, value);
+}
+
+
+/***************************************************************************//**
+* @brief Loads the shadow copy of the control registers from a sensor.
+*
+* The control registers are read in one burst, the FIFO control register on
+* its own to not pop samples with the output registers in between.
+*
+* @param[in] sensor Specifies from which sensor to read.
+*
+* @return ERR_NONE if no error occurred.
+*         ERR_LSM330_READ_FAILED if reading from the sensor failed.
+******************************************************************************/
+static uint32_t LSM330_LoadShadow(enum LSM330_Sensor sensor)
+{
+    uint32_t err;
+
+    err = LSM330_ReadMultiSpi(sensor,
+                              LSM330_SHADOW_FIRST,
+                              &LSM330_SHADOW(sensor, LSM330_SHADOW_FIRST),
+                              LSM330_SHADOW_CTRL_SIZE);
     if (err != ERR_NONE) {
         return err;
     }
 
-    return ERR_NONE;
+    /* Both sensors have the FIFO control register at the same address. */
+    return LSM330_ReadSpi(sensor,
+                          TXW51_LSM330_REG_FIFO_CTRL_REG_A,
+                          &LSM330_SHADOW(sensor, TXW51_LSM330_REG_FIFO_CTRL_REG_A));
 }
 
 
@@ -681,11 +750,40 @@ uint32_t TXW51_LSM330_ResetDevice(void)
         return err;
     }
 
+    /* The gyroscope is not reset and keeps its registers over a reset of the
+     * nRF51, so both copies are read back from the sensor. */
+    err = LSM330_LoadShadow(TXW51_LSM330_ACC);
+    if (err == ERR_NONE) {
+        err = LSM330_LoadShadow(TXW51_LSM330_GYRO);
+    }
+    if (err != ERR_NONE) {
+        TXW51_LOG_WARNING("[LSM330] Could not read back the control registers.");
+        return err;
+    }
+
     TXW51_LOG_DEBUG("[LSM330] Device reset.");
     return ERR_NONE;
 }
 
 
+uint32_t TXW51_LSM330_CheckRegisters(void)
+{
+    uint8_t values[LSM330_SHADOW_CTRL_SIZE];
+    uint32_t err;
+
+    for (enum LSM330_Sensor sensor = TXW51_LSM330_ACC; sensor <= TXW51_LSM330_GYRO; sensor++) {
+        err = LSM330_ReadMultiSpi(sensor, LSM330_SHADOW_FIRST, values, sizeof(values));
+        if (err != ERR_NONE) {
+            return err;
+        }
+        if (memcmp(values, &LSM330_SHADOW(sensor, LSM330_SHADOW_FIRST), sizeof(values)) != 0) {
+            return ERR_LSM330_READ_FAILED;
+        }
+    }
+    return ERR_NONE;
+}
+
+
 uint32_t TXW51_LSM330_ACC_ConfigFifo(struct TXW51_LSM330_ACC_FifoInit *config)
 {
     uint32_t err = ERR_NONE;
@@ -729,6 +827,15 @@ uint32_t TXW51_LSM330_ACC_ConfigFifo(struct TXW51_LSM330_ACC_FifoInit *config)
 }
 
 
+uint32_t TXW51_LSM330_ACC_SetWatermark(uint8_t watermark)
+{
+    return LSM330_UpdateRegister(TXW51_LSM330_ACC,
+                                 TXW51_LSM330_REG_FIFO_CTRL_REG_A,
+                                 TXW51_LSM330_REG_FIFO_CTRL_REG_A_WTMP_Msk,
+                                 (watermark << TXW51_LSM330_REG_FIFO_CTRL_REG_A_WTMP_Pos));
+}
+
+
 /***************************************************************************//**
  * @brief Resets the FIFO of the accelerometer.
  *
@@ -736,7 +843,6 @@ uint32_t TXW51_LSM330_ACC_ConfigFifo(struct TXW51_LSM330_ACC_FifoInit *config)
  * setting it to bypass mode.
  *
  * @return ERR_NONE if no error occurred.
- *         ERR_LSM330_READ_FAILED if reading from the sensor failed.
  *         ERR_LSM330_WRITE_FAILED if writing to the sensor failed.
  ******************************************************************************/
 static uint32_t LSM330_ACC_ResetFifo(void)
@@ -808,6 +914,15 @@ uint32_t TXW51_LSM330_GYRO_ConfigFifo(struct TXW51_LSM330_GYRO_FifoInit *config)
 }
 
 
+uint32_t TXW51_LSM330_GYRO_SetWatermark(uint8_t watermark)
+{
+    return LSM330_UpdateRegister(TXW51_LSM330_GYRO,
+                                 TXW51_LSM330_REG_FIFO_CTRL_REG_G,
+                                 TXW51_LSM330_REG_FIFO_CTRL_REG_G_WTM_Msk,
+                                 (watermark << TXW51_LSM330_REG_FIFO_CTRL_REG_G_WTM_Pos));
+}
+
+
 /***************************************************************************//**
  * @brief Resets the FIFO of the gyroscope.
  *
@@ -815,7 +930,6 @@ uint32_t TXW51_LSM330_GYRO_ConfigFifo(struct TXW51_LSM330_GYRO_FifoInit *config)
  * setting it to bypass mode.
  *
  * @return ERR_NONE if no error occurred.
- *         ERR_LSM330_READ_FAILED if reading from the sensor failed.
  *         ERR_LSM330_WRITE_FAILED if writing to the sensor failed.
  ******************************************************************************/
 static uint32_t LSM330_GYRO_ResetFifo(void)
@@ -880,6 +994,24 @@ uint32_t TXW51_LSM330_GYRO_GetDataBlock(uint8_t *buffer, uint32_t numberOfBlocks
 }
 
 
+uint32_t TXW51_LSM330_ACC_ReadFifo(uint8_t *buffer, uint32_t numberOfSamples)
+{
+    return LSM330_ReadFifoSpi(TXW51_LSM330_ACC,
+                              TXW51_LSM330_REG_OUT_X_L_A,
+                              buffer,
+                              numberOfSamples);
+}
+
+
+uint32_t TXW51_LSM330_GYRO_ReadFifo(uint8_t *buffer, uint32_t numberOfSamples)
+{
+    return LSM330_ReadFifoSpi(TXW51_LSM330_GYRO,
+                              TXW51_LSM330_REG_OUT_X_L_G,
+                              buffer,
+                              numberOfSamples);
+}
+
+
 uint32_t TXW51_LSM330_ACC_GetFifoStatus(union TXW51_LSM330_FIFO_SRC_REG_A *value)
 {
     uint32_t err = LSM330_ReadSpi(TXW51_LSM330_ACC,
@@ -974,3 +1106,15 @@ uint32_t TXW51_LSM330_SetMotionWakeup(void)
     return err;
 }
 
+
+uint32_t TXW51_LSM330_ClearMotionWakeup(void)
+{
+    uint32_t err;
+
+    err = LSM330_WriteSpi(TXW51_LSM330_ACC, TXW51_LSM330_REG_CTRL_REG2_A, 0x00);
+    if (err != ERR_NONE) {
+        TXW51_LOG_WARNING("[LSM330] Could not disable state machine. Writing register failed.");
+    }
+
+    return err;
+}
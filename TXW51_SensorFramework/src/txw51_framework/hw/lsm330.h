@@ -55,6 +55,8 @@
 #define TWX51_LSM330_CONFIG_INTERRUPT_LATCH     ( TXW51_LSM330_REG_CTRL_REG4_A_IEL_Pulsed )     /**< LSM330 interrupt latched/pulsed. */
 
 #define TXW51_LSM330_SM1_THRESHOLD  ( 70 )      /**< Threshold for the Motion Wake-Up state machine. */
+#define TXW51_LSM330_ACC_FIFO_SIZE  ( 32 )      /**< Number of samples the FIFO of the accelerometer can hold. */
+#define TXW51_LSM330_GYRO_FIFO_SIZE ( 32 )      /**< Number of samples the FIFO of the gyroscope can hold. */
 
 /*----- Data types -----------------------------------------------------------*/
 /**
@@ -266,7 +268,6 @@ extern void TXW51_LSM330_Deinit(void);
 * @param[in] enable True to enable and false to disable the gyroscope.
 *
 * @return ERR_NONE if no error occurred.
-*         ERR_LSM330_READ_FAILED if reading from the sensor failed.
 *         ERR_LSM330_WRITE_FAILED if writing to the sensor failed.
 ******************************************************************************/
 extern uint32_t TXW51_LSM330_EnableGyro(bool enable);
@@ -274,11 +275,28 @@ extern uint32_t TXW51_LSM330_EnableGyro(bool enable);
 /***************************************************************************//**
 * @brief Resets the LSM330.
 *
+* Afterwards, the control registers of both sensors are read back into the
+* shadow copy that serves the register updates and the getters.
+*
 * @return ERR_NONE if no error occurred.
+*         ERR_LSM330_READ_FAILED if reading from the sensor failed.
 *         ERR_LSM330_WRITE_FAILED if writing to the sensor failed.
 ******************************************************************************/
 extern uint32_t TXW51_LSM330_ResetDevice(void);
 
+/***************************************************************************//**
+* @brief Reads the control registers of both sensors in one burst each and
+*        compares them with the shadow copy.
+*
+* Verifies the data on the SPI bus, for example after its clock has been
+* changed.
+*
+* @return ERR_NONE if the registers match.
+*         ERR_LSM330_READ_FAILED if reading from the sensor failed or a
+*         register differs.
+******************************************************************************/
+extern uint32_t TXW51_LSM330_CheckRegisters(void);
+
 /***************************************************************************//**
 * @brief Sets the state machine of the LSM330 to generate an interrupt when
 *        someone shakes the sensor.
@@ -288,13 +306,21 @@ extern uint32_t TXW51_LSM330_ResetDevice(void);
 ******************************************************************************/
 extern uint32_t TXW51_LSM330_SetMotionWakeup(void);
 
+/***************************************************************************//**
+* @brief Disables the state machine that has been set by
+*        TXW51_LSM330_SetMotionWakeup().
+*
+* @return ERR_NONE if no error occurred.
+*         ERR_LSM330_WRITE_FAILED if writing to the sensor failed.
+******************************************************************************/
+extern uint32_t TXW51_LSM330_ClearMotionWakeup(void);
+
 /***************************************************************************//**
  * @brief Configures the interrupts of the accelerometer.
  *
  * @param[in] config The configuration values for the interrupts.
  *
  * @return ERR_NONE if no error occurred.
- *         ERR_LSM330_READ_FAILED if reading from the sensor failed.
  *         ERR_LSM330_WRITE_FAILED if writing to the sensor failed.
  ******************************************************************************/
 extern uint32_t TXW51_LSM330_ACC_ConfigInterrupts(struct TXW51_LSM330_ACC_Interrupts *config);
@@ -305,20 +331,21 @@ extern uint32_t TXW51_LSM330_ACC_ConfigInterrupts(struct TXW51_LSM330_ACC_Interr
  * @param[in] axis The configuration for the axes.
  *
  * @return ERR_NONE if no error occurred.
- *         ERR_LSM330_READ_FAILED if reading from the sensor failed.
  *         ERR_LSM330_WRITE_FAILED if writing to the sensor failed.
  ******************************************************************************/
 extern uint32_t TXW51_LSM330_ACC_SetActiveAxis(struct TXW51_LSM330_Axis *axis);
 
 /***************************************************************************//**
- * @brief Reads the full-scale value of the accelerometer.
+ * @brief Returns the full-scale value of the accelerometer.
+ *
+ * The value is taken from the shadow copy of the registers, the sensor is not
+ * accessed.
  *
  * @return TXW51_LSM330_ACC_FSCALE_2G
  *         TXW51_LSM330_ACC_FSCALE_4G
  *         TXW51_LSM330_ACC_FSCALE_6G
  *         TXW51_LSM330_ACC_FSCALE_8G
  *         TXW51_LSM330_ACC_FSCALE_16G
- *         TXW51_LSM330_ACC_FSCALE_2G if an error occurred.
  ******************************************************************************/
 extern enum TXW51_LSM330_ACC_Fullscale TXW51_LSM330_ACC_GetFullscale(void);
 
@@ -328,13 +355,15 @@ extern enum TXW51_LSM330_ACC_Fullscale TXW51_LSM330_ACC_GetFullscale(void);
  * @param[in] fullscale The full-scale value to set.
  *
  * @return ERR_NONE if no error occurred.
- *         ERR_LSM330_READ_FAILED if reading from the sensor failed.
  *         ERR_LSM330_WRITE_FAILED if writing to the sensor failed.
  ******************************************************************************/
 extern uint32_t TXW51_LSM330_ACC_SetFullscale(enum TXW51_LSM330_ACC_Fullscale fullscale);
 
 /***************************************************************************//**
- * @brief Reads the ODR value of the accelerometer.
+ * @brief Returns the ODR value of the accelerometer.
+ *
+ * The value is taken from the shadow copy of the registers, the sensor is not
+ * accessed.
  *
  * @return TXW51_LSM330_ACC_ODR_OFF
  *         TXW51_LSM330_ACC_ODR_3_125
@@ -346,7 +375,6 @@ extern uint32_t TXW51_LSM330_ACC_SetFullscale(enum TXW51_LSM330_ACC_Fullscale fu
  *         TXW51_LSM330_ACC_ODR_400
  *         TXW51_LSM330_ACC_ODR_800
  *         TXW51_LSM330_ACC_ODR_1600
- *         TXW51_LSM330_ACC_ODR_OFF if an error occurred.
  ******************************************************************************/
 extern enum TXW51_LSM330_ACC_Odr TXW51_LSM330_ACC_GetOdr(void);
 
@@ -356,7 +384,6 @@ extern enum TXW51_LSM330_ACC_Odr TXW51_LSM330_ACC_GetOdr(void);
  * @param[in] odr The odr value to set.
  *
  * @return ERR_NONE if no error occurred.
- *         ERR_LSM330_READ_FAILED if reading from the sensor failed.
  *         ERR_LSM330_WRITE_FAILED if writing to the sensor failed.
  ******************************************************************************/
 extern uint32_t TXW51_LSM330_ACC_SetOdr(enum TXW51_LSM330_ACC_Odr odr);
@@ -367,11 +394,22 @@ extern uint32_t TXW51_LSM330_ACC_SetOdr(enum TXW51_LSM330_ACC_Odr odr);
  * @param[in] config The configuration values for the FIFO.
  *
  * @return ERR_NONE if no error occurred.
- *         ERR_LSM330_READ_FAILED if reading from the sensor failed.
  *         ERR_LSM330_WRITE_FAILED if writing to the sensor failed.
  ******************************************************************************/
 extern uint32_t TXW51_LSM330_ACC_ConfigFifo(struct TXW51_LSM330_ACC_FifoInit *config);
 
+/***************************************************************************//**
+ * @brief Changes the watermark of the FIFO of the accelerometer.
+ *
+ * Unlike TXW51_LSM330_ACC_ConfigFifo(), the FIFO keeps its mode and content.
+ *
+ * @param[in] watermark The FIFO level for the watermark interrupt (0..31).
+ *
+ * @return ERR_NONE if no error occurred.
+ *         ERR_LSM330_WRITE_FAILED if writing to the sensor failed.
+ ******************************************************************************/
+extern uint32_t TXW51_LSM330_ACC_SetWatermark(uint8_t watermark);
+
 /***************************************************************************//**
 * @brief Reads the current status of the FIFO for the accelerometer.
 *
@@ -393,13 +431,27 @@ extern uint32_t TXW51_LSM330_ACC_GetFifoStatus(union TXW51_LSM330_FIFO_SRC_REG_A
 ******************************************************************************/
 extern uint32_t TXW51_LSM330_ACC_GetDataBlock(uint8_t *buffer, uint32_t numberOfBlocks);
 
+/***************************************************************************//**
+* @brief Reads samples from the FIFO of the accelerometer in one burst.
+*
+* The output registers wrap around while the FIFO is not in bypass mode, so
+* one transfer reads several samples. They land straight in the buffer, see
+* TXW51_SPI_ReadInPlace(), so buffer[-1] has to be valid memory.
+*
+* @param[in,out] buffer          Buffer to save the samples, 6 bytes each.
+* @param[in]     numberOfSamples Number of samples to read.
+*
+* @return ERR_NONE if no error occurred.
+*         ERR_LSM330_READ_FAILED if reading from the sensor failed.
+******************************************************************************/
+extern uint32_t TXW51_LSM330_ACC_ReadFifo(uint8_t *buffer, uint32_t numberOfSamples);
+
 /***************************************************************************//**
  * @brief Configures the interrupts of the gyroscope.
  *
  * @param[in] config The configuration values for the interrupts.
  *
  * @return ERR_NONE if no error occurred.
- *         ERR_LSM330_READ_FAILED if reading from the sensor failed.
  *         ERR_LSM330_WRITE_FAILED if writing to the sensor failed.
  ******************************************************************************/
 extern uint32_t TXW51_LSM330_GYRO_ConfigInterrupts(struct TXW51_LSM330_GYRO_Interrupts *config);
@@ -410,18 +462,19 @@ extern uint32_t TXW51_LSM330_GYRO_ConfigInterrupts(struct TXW51_LSM330_GYRO_Inte
  * @param[in] axis The configuration for the axes.
  *
  * @return ERR_NONE if no error occurred.
- *         ERR_LSM330_READ_FAILED if reading from the sensor failed.
  *         ERR_LSM330_WRITE_FAILED if writing to the sensor failed.
  ******************************************************************************/
 extern uint32_t TXW51_LSM330_GYRO_SetActiveAxis(struct TXW51_LSM330_Axis *axis);
 
 /***************************************************************************//**
- * @brief Reads the full-scale value of the gyroscope.
+ * @brief Returns the full-scale value of the gyroscope.
+ *
+ * The value is taken from the shadow copy of the registers, the sensor is not
+ * accessed.
  *
  * @return TXW51_LSM330_GYRO_FSCALE_250DPS
  *         TXW51_LSM330_GYRO_FSCALE_500DPS
  *         TXW51_LSM330_GYRO_FSCALE_2000DPS
- *         TXW51_LSM330_GYRO_FSCALE_250DPS if an error occurred.
  ******************************************************************************/
 extern enum TXW51_LSM330_GYRO_Fullscale TXW51_LSM330_GYRO_GetFullscale(void);
 
@@ -431,19 +484,20 @@ extern enum TXW51_LSM330_GYRO_Fullscale TXW51_LSM330_GYRO_GetFullscale(void);
  * @param[in] fullscale The full-scale value to set.
  *
  * @return ERR_NONE if no error occurred.
- *         ERR_LSM330_READ_FAILED if reading from the sensor failed.
  *         ERR_LSM330_WRITE_FAILED if writing to the sensor failed.
  ******************************************************************************/
 extern uint32_t TXW51_LSM330_GYRO_SetFullscale(enum TXW51_LSM330_GYRO_Fullscale fullscale);
 
 /***************************************************************************//**
- * @brief Reads the ODR value of the gyroscope.
+ * @brief Returns the ODR value of the gyroscope.
+ *
+ * The value is taken from the shadow copy of the registers, the sensor is not
+ * accessed.
  *
  * @return TXW51_LSM330_GYRO_ODR_95
  *         TXW51_LSM330_GYRO_ODR_190
  *         TXW51_LSM330_GYRO_ODR_380
  *         TXW51_LSM330_GYRO_ODR_760
- *         TXW51_LSM330_GYRO_ODR_95 if an error occurred.
  ******************************************************************************/
 extern enum TXW51_LSM330_GYRO_Odr TXW51_LSM330_GYRO_GetOdr(void);
 
@@ -453,7 +507,6 @@ extern enum TXW51_LSM330_GYRO_Odr TXW51_LSM330_GYRO_GetOdr(void);
  * @param[in] odr The odr value to set.
  *
  * @return ERR_NONE if no error occurred.
- *         ERR_LSM330_READ_FAILED if reading from the sensor failed.
  *         ERR_LSM330_WRITE_FAILED if writing to the sensor failed.
  ******************************************************************************/
 extern uint32_t TXW51_LSM330_GYRO_SetOdr(enum TXW51_LSM330_GYRO_Odr odr);
@@ -464,11 +517,22 @@ extern uint32_t TXW51_LSM330_GYRO_SetOdr(enum TXW51_LSM330_GYRO_Odr odr);
  * @param[in] config The configuration values for the FIFO.
  *
  * @return ERR_NONE if no error occurred.
- *         ERR_LSM330_READ_FAILED if reading from the sensor failed.
  *         ERR_LSM330_WRITE_FAILED if writing to the sensor failed.
  ******************************************************************************/
 extern uint32_t TXW51_LSM330_GYRO_ConfigFifo(struct TXW51_LSM330_GYRO_FifoInit *config);
 
+/***************************************************************************//**
+ * @brief Changes the watermark of the FIFO of the gyroscope.
+ *
+ * Unlike TXW51_LSM330_GYRO_ConfigFifo(), the FIFO keeps its mode and content.
+ *
+ * @param[in] watermark The FIFO level for the watermark interrupt (0..31).
+ *
+ * @return ERR_NONE if no error occurred.
+ *         ERR_LSM330_WRITE_FAILED if writing to the sensor failed.
+ ******************************************************************************/
+extern uint32_t TXW51_LSM330_GYRO_SetWatermark(uint8_t watermark);
+
 /***************************************************************************//**
 * @brief Reads the current status of the FIFO for the gyroscope.
 *
@@ -490,6 +554,19 @@ extern uint32_t TXW51_LSM330_GYRO_GetFifoStatus(union TXW51_LSM330_FIFO_SRC_REG_
 ******************************************************************************/
 extern uint32_t TXW51_LSM330_GYRO_GetDataBlock(uint8_t *buffer, uint32_t numberOfBlocks);
 
+/***************************************************************************//**
+* @brief Reads samples from the FIFO of the gyroscope in one burst.
+*
+* Works like TXW51_LSM330_ACC_ReadFifo().
+*
+* @param[in,out] buffer          Buffer to save the samples, 6 bytes each.
+* @param[in]     numberOfSamples Number of samples to read.
+*
+* @return ERR_NONE if no error occurred.
+*         ERR_LSM330_READ_FAILED if reading from the sensor failed.
+******************************************************************************/
+extern uint32_t TXW51_LSM330_GYRO_ReadFifo(uint8_t *buffer, uint32_t numberOfSamples);
+
 /***************************************************************************//**
  * @brief Reads the temperature value.
  *
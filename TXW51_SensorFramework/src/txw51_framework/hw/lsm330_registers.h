@@ -230,7 +230,7 @@ operation register (r/w)) */
 #define TXW51_LSM330_REG_CTRL_REG3_G_I1_INT1    ( 1UL << 7 )
 
 /* CTRL_REG4_G (Angular rate sensor control register 4 (r/w)) */
-#define TXW51_LSM330_REG_CTRL_REG4_G            ( 0x22UL )
+#define TXW51_LSM330_REG_CTRL_REG4_G            ( 0x23UL )
 #define TXW51_LSM330_REG_CTRL_REG4_G_SIM        ( 1UL << 0 )
 #define TXW51_LSM330_REG_CTRL_REG4_G_FS_Pos     ( 4 )
 #define TXW51_LSM330_REG_CTRL_REG4_G_FS_Msk     ( 0x03UL << TXW51_LSM330_REG_CTRL_REG4_G_FS_Pos )
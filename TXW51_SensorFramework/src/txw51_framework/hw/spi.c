@@ -21,6 +21,7 @@
 #include "txw51_framework/utils/txw51_errors.h"
 
 /*----- Macros ---------------------------------------------------------------*/
+#define SPI_NUM_OF_INSTANCES    ( 2 )   /**< Number of SPI interfaces of the nRF51. */
 
 /*----- Data types -----------------------------------------------------------*/
 
@@ -33,6 +34,19 @@ static void SPI1_EventHandler(spi_master_evt_t event);
 static bool hasReceivedSpi0 = false;    /**< Flag to signal when a message has been received from SPI0. */
 static bool hasReceivedSpi1 = false;    /**< Flag to signal when a message has been received from SPI1. */
 
+static enum TXW51_SPI_Frequency frequencies[SPI_NUM_OF_INSTANCES];     /**< Clock of every SPI interface. */
+
+/**
+ * @brief FREQUENCY register values of the SPI clocks, see enum
+ *        TXW51_SPI_Frequency.
+ */
+static const uint32_t frequencyRegisters[TXW51_SPI_NUM_OF_FREQUENCIES] = {
+    SPI_FREQUENCY_FREQUENCY_M1,
+    SPI_FREQUENCY_FREQUENCY_M2,
+    SPI_FREQUENCY_FREQUENCY_M4,
+    SPI_FREQUENCY_FREQUENCY_M8
+};
+
 /*----- Implementation -------------------------------------------------------*/
 
 /***************************************************************************//**
@@ -65,12 +79,19 @@ static void SPI1_EventHandler(spi_master_evt_t event)
 }
 
 
-uint32_t TXW51_SPI_Init(enum TXW51_SPI_Instance spiInstance)
+uint32_t TXW51_SPI_Init(enum TXW51_SPI_Instance spiInstance,
+                        enum TXW51_SPI_Frequency frequency)
 {
     uint32_t err = NRF_SUCCESS;
 
+    if (frequency >= TXW51_SPI_NUM_OF_FREQUENCIES) {
+        TXW51_LOG_ERROR("[SPI] Invalid frequency.");
+        return ERR_SPI_INIT_FAILED;
+    }
+
     /* Configure SPI master. */
     spi_master_config_t spi_config = SPI_MASTER_INIT_DEFAULT;
+    spi_config.SPI_Freq            = frequencyRegisters[frequency];
     spi_config.SPI_Pin_SCK         = TXW51_GPIO_PIN_SPI0_SCLK;
     spi_config.SPI_Pin_MISO        = TXW51_GPIO_PIN_SPI0_MISO;
     spi_config.SPI_Pin_MOSI        = TXW51_GPIO_PIN_SPI0_MOSI;
@@ -91,10 +112,25 @@ uint32_t TXW51_SPI_Init(enum TXW51_SPI_Instance spiInstance)
         spi_master_evt_handler_reg(spiInstance, SPI1_EventHandler);
     }
 
+    frequencies[spiInstance] = frequency;
     return ERR_NONE;
 }
 
 
+uint32_t TXW51_SPI_SetFrequency(enum TXW51_SPI_Instance spiInstance,
+                                enum TXW51_SPI_Frequency frequency)
+{
+    spi_master_close(spiInstance);
+    return TXW51_SPI_Init(spiInstance, frequency);
+}
+
+
+enum TXW51_SPI_Frequency TXW51_SPI_GetFrequency(enum TXW51_SPI_Instance spiInstance)
+{
+    return frequencies[spiInstance];
+}
+
+
 void TXW51_SPI_Deinit(enum TXW51_SPI_Instance spiInstance)
 {
     spi_master_close(spiInstance);
@@ -143,6 +179,37 @@ uint32_t TXW51_SPI_Read(enum TXW51_SPI_Instance spiInstance,
 }
 
 
+uint32_t TXW51_SPI_ReadInPlace(enum TXW51_SPI_Instance spiInstance,
+                               uint8_t addr,
+                               uint8_t *values,
+                               uint32_t n)
+{
+    uint32_t err = ERR_NONE;
+    uint8_t txBuffer[1];
+    uint8_t saved = values[-1];
+
+    bool *hasReceived = (spiInstance == TXW51_SPI_0) ?
+            &hasReceivedSpi0 : &hasReceivedSpi1;
+
+    txBuffer[0] = addr | TXW51_SPI_FLAG_TX;
+    if (spi_master_send_recv(spiInstance, txBuffer, 1, &values[-1], n+1) != NRF_SUCCESS) {
+        TXW51_LOG_ERROR("[SPI] Could not read from SPI.");
+        return ERR_SPI_READ_FAILED;
+    }
+
+    for (int32_t i = 0; !(*hasReceived); i++) {
+        if (i >= TXW51_SPI_WAIT_TIMEOUT) {
+            err = ERR_SPI_READ_FAILED;
+            break;
+        }
+    }
+    *hasReceived = false;
+
+    values[-1] = saved;
+    return err;
+}
+
+
 uint32_t TXW51_SPI_Write(enum TXW51_SPI_Instance spiInstance,
                          uint8_t addr,
                          uint8_t value)
@@ -21,13 +21,29 @@
 #define TXW51_SPI_FLAG_TX           ( 0x01 << 7 )   /**< Write flag for the SPI communication. */
 #define TXW51_SPI_FLAG_RX           ( 0x00 << 7 )   /**< Read flag for the SPI communication. */
 
+#define TXW51_SPI_FREQUENCY_KHZ(frequency)  ( 1000UL << (frequency) )   /**< Clock of an enum TXW51_SPI_Frequency in kHz. */
+
 /*----- Data types -----------------------------------------------------------*/
 /**
  * List of the available SPI interfaces.
  */
 enum TXW51_SPI_Instance {
     TXW51_SPI_0 = SPI_MASTER_0,     /**< Use SPI0 interface. */
-    TXW51_SPI_1 = SPI_MASTER_1      /**< Use SPI1 interface. */
+#ifdef SPI_MASTER_1_ENABLE
+    TXW51_SPI_1 = SPI_MASTER_1      /**< Use SPI1 interface. The I2C module uses the shared TWI1 instead. */
+#endif
+
+};
+
+/**
+ * List of the available SPI clocks, each one doubles the previous one.
+ */
+enum TXW51_SPI_Frequency {
+    TXW51_SPI_FREQ_1M = 0,      /**< 1 MHz. */
+    TXW51_SPI_FREQ_2M,          /**< 2 MHz. */
+    TXW51_SPI_FREQ_4M,          /**< 4 MHz. */
+    TXW51_SPI_FREQ_8M,          /**< 8 MHz, the fastest clock of the nRF51. */
+    TXW51_SPI_NUM_OF_FREQUENCIES
 };
 
 /*----- Function prototypes --------------------------------------------------*/
@@ -38,11 +54,37 @@ enum TXW51_SPI_Instance {
  * At the moment only SPI0 works.
  *
  * @param[in] spiInstance Which SPI to use.
+ * @param[in] frequency   The clock of the interface.
  *
  * @return ERR_NONE if no error occurred.
  *         ERR_SPI_INIT_FAILED if initialization failed.
  ******************************************************************************/
-extern uint32_t TXW51_SPI_Init(enum TXW51_SPI_Instance spiInstance);
+extern uint32_t TXW51_SPI_Init(enum TXW51_SPI_Instance spiInstance,
+                               enum TXW51_SPI_Frequency frequency);
+
+/***************************************************************************//**
+ * @brief Changes the clock of an initialized SPI interface.
+ *
+ * The interface is opened again with the new clock, so no transfer may be
+ * running.
+ *
+ * @param[in] spiInstance Which SPI to use.
+ * @param[in] frequency   The new clock of the interface.
+ *
+ * @return ERR_NONE if no error occurred.
+ *         ERR_SPI_INIT_FAILED if the interface could not be opened again.
+ ******************************************************************************/
+extern uint32_t TXW51_SPI_SetFrequency(enum TXW51_SPI_Instance spiInstance,
+                                       enum TXW51_SPI_Frequency frequency);
+
+/***************************************************************************//**
+ * @brief Returns the clock of an SPI interface.
+ *
+ * @param[in] spiInstance Which SPI to use.
+ *
+ * @return The clock set with the last initialization.
+ ******************************************************************************/
+extern enum TXW51_SPI_Frequency TXW51_SPI_GetFrequency(enum TXW51_SPI_Instance spiInstance);
 
 /***************************************************************************//**
  * @brief Deinitializes the SPI interface.
@@ -74,6 +116,26 @@ extern uint32_t TXW51_SPI_Read(enum TXW51_SPI_Instance spiInstance,
                                uint8_t *values,
                                uint32_t n);
 
+/***************************************************************************//**
+ * @brief Reads from the SPI interface straight into the destination.
+ *
+ * Works like TXW51_SPI_Read(), but without a receive buffer on the stack.
+ * The byte that is clocked in with the address lands in front of values,
+ * so values[-1] has to be valid memory. It gets restored afterwards.
+ *
+ * @param[in]     spiInstance Which SPI to use.
+ * @param[in]     addr        Address of the register.
+ * @param[in,out] values      Buffer to save the values, preceded by one byte.
+ * @param[in]     n           How many bytes to read.
+ *
+ * @return ERR_NONE if no error occurred.
+ *         ERR_SPI_READ_FAILED if the values could not be read.
+ ******************************************************************************/
+extern uint32_t TXW51_SPI_ReadInPlace(enum TXW51_SPI_Instance spiInstance,
+                                      uint8_t addr,
+                                      uint8_t *values,
+                                      uint32_t n);
+
 /***************************************************************************//**
  * @brief Writes to the SPI interface.
  *
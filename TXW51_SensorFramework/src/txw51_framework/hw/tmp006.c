@@ -20,40 +20,187 @@
 #include "txw51_framework/utils/log.h"
 #include "txw51_framework/utils/txw51_errors.h"
 
+/*----- Macros ---------------------------------------------------------------*/
+
+/*----- Data types -----------------------------------------------------------*/
+/**
+ * @brief State of the sample that is currently read.
+ */
+struct TMP006_Sample {
+    int16_t  RawVoltage;                        /**< Content of the VOBJ register. */
+    uint32_t Err;                               /**< First error of the two reads. */
+    TXW51_TMP006_SampleCallback_t Callback;     /**< Callback of the caller. */
+    void     *Context;                          /**< Context of the caller. */
+    bool     IsPending;                         /**< A sample is being read. */
+};
+
+/*----- Function prototypes --------------------------------------------------*/
+static uint32_t TMP006_WriteConfig(uint16_t config);
+static void TMP006_VoltageRead(uint32_t err,
+                               uint8_t *data,
+                               uint8_t length,
+                               void *context);
+static void TMP006_DieTempRead(uint32_t err,
+                               uint8_t *data,
+                               uint8_t length,
+                               void *context);
+
+/*----- Data -----------------------------------------------------------------*/
+static struct TMP006_Sample sample;
+
+/*----- Implementation -------------------------------------------------------*/
+
+uint32_t TXW51_TMP006_Init(void)
+{
+    sample.IsPending = false;
+
+    TXW51_GPIO_ConfigGpioAsInput(TXW51_TMP006_GPIO_DRDY,
+                                 TXW51_TMP006_GPIO_DRDY_PULL_CONF);
+    TXW51_GPIOTE_SetInterrupt(TXW51_TMP006_GPIO_DRDY_CHANNEL,
+                              TXW51_TMP006_GPIO_DRDY,
+                              TXW51_TMP006_GPIO_DRDY_POL_CONF);
+
+    return TXW51_TMP006_Stop();
+}
+
+
+uint32_t TXW51_TMP006_Start(uint16_t sampleRate)
+{
+    TXW51_LOG_DEBUG("[TMP006] Start conversions.");
+
+    return TMP006_WriteConfig(TMP006_CFG_MODEON | TMP006_CFG_DRDYEN | sampleRate);
+}
+
+
+uint32_t TXW51_TMP006_Stop(void)
+{
+    TXW51_LOG_DEBUG("[TMP006] Power down.");
+
+    return TMP006_WriteConfig(0);
+}
 
 
-uint32_t TXW51_TMP006_GetTemperature(uint8_t *value)
+uint32_t TXW51_TMP006_ReadSample(TXW51_TMP006_SampleCallback_t callback,
+                                 void *context)
 {
+    uint32_t err;
+
+    if (sample.IsPending) {
+        return ERR_TMP006_BUSY;
+    }
+
+    err = TXW51_I2C_ReadAsync(TMP006_I2CADDR, TMP006_VOBJ, 2, TMP006_VoltageRead, NULL);
+    if (err != ERR_NONE) {
+        TXW51_LOG_WARNING("[TMP006] Could not read sensor voltage.");
+        return err;
+    }
+
+    /* The transactions are executed in order, so the die temperature read
+     * finishes the sample. If it can't be queued, the voltage read still
+     * finishes and is discarded. */
+    err = TXW51_I2C_ReadAsync(TMP006_I2CADDR, TMP006_TAMB, 2, TMP006_DieTempRead, NULL);
+    if (err != ERR_NONE) {
+        TXW51_LOG_WARNING("[TMP006] Could not read die temperature.");
+        return err;
+    }
+
+    sample.Err = ERR_NONE;
+    sample.Callback = callback;
+    sample.Context = context;
+    sample.IsPending = true;
+
+    return ERR_NONE;
+}
 
-    TXW51_LOG_DEBUG("TXW51_TMP006_GetTemperature: Start");
 
-    //uint32_t err;
-    uint8_t address = TMP006_I2CADDR;
-    uint8_t len = 1;
-    uint8_t reg = 0x00; //Voltage Value
+/***************************************************************************//**
+ * @brief Writes the configuration register.
+ *
+ * @param[in] config The new content of the configuration register.
+ *
+ * @return ERR_NONE if the write has been queued.
+ *         ERR_I2C_QUEUE_FULL if the I2C queue is full.
+ ******************************************************************************/
+static uint32_t TMP006_WriteConfig(uint16_t config)
+{
+    uint8_t value[2];
 
-    *value = 0;
+    /* The registers are big endian. */
+    value[0] = (uint8_t)(config >> 8);
+    value[1] = (uint8_t)(config & 0xFF);
 
-    twi_master_init();
+    return TXW51_I2C_WriteAsync(TMP006_I2CADDR, TMP006_CONFIG, value, sizeof(value), NULL, NULL);
+}
 
-	// Write: register address we want to start reading from
-	if (twi_master_transfer((address << 1), &reg, 1, TWI_DONT_ISSUE_STOP))
-	{
 
-		// Read: the number of bytes requested.
-		if (twi_master_transfer((address << 1) | TWI_READ_BIT, value, len, TWI_DONT_ISSUE_STOP))
-		{
-		  // Read succeeded.
+/***************************************************************************//**
+ * @brief Stores the sensor voltage of the current sample.
+ *
+ * @param[in] err     Result of the I2C transaction.
+ * @param[in] data    Content of the VOBJ register.
+ * @param[in] length  Number of read bytes.
+ * @param[in] context Not used.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void TMP006_VoltageRead(uint32_t err,
+                               uint8_t *data,
+                               uint8_t length,
+                               void *context)
+{
+    if (!sample.IsPending) {
+        return;
+    }
 
-				TXW51_LOG_DEBUG("TXW51_TMP006_GetTemperature: Success");
-				return ERR_NONE;
-		}
-	}
+    if (err != ERR_NONE) {
+        sample.Err = err;
+        return;
+    }
 
-	// read or write failed.
+    sample.RawVoltage = (int16_t)(((uint16_t)data[0] << 8) | data[1]);
+}
 
-	TXW51_LOG_WARNING("[TMP006] Could not read temperature.");
-	return false;
 
-    //return ERR_NONE;
+/***************************************************************************//**
+ * @brief Converts the sample and calls the callback of the caller.
+ *
+ * @param[in] err     Result of the I2C transaction.
+ * @param[in] data    Content of the TAMB register.
+ * @param[in] length  Number of read bytes.
+ * @param[in] context Not used.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void TMP006_DieTempRead(uint32_t err,
+                               uint8_t *data,
+                               uint8_t length,
+                               void *context)
+{
+    int16_t objectTemp = 0;
+    int16_t dieTemp = 0;
+
+    if (!sample.IsPending) {
+        return;
+    }
+    sample.IsPending = false;
+
+    if ((sample.Err == ERR_NONE) && (err != ERR_NONE)) {
+        sample.Err = err;
+    }
+
+    if (sample.Err == ERR_NONE) {
+        int16_t rawDieTemp = (int16_t)(((uint16_t)data[0] << 8) | data[1]);
+
+        dieTemp = TXW51_TMP006_CalcDieTemp(rawDieTemp);
+        objectTemp = TXW51_TMP006_CalcObjectTemp(sample.RawVoltage, rawDieTemp);
+        if (objectTemp == TXW51_TMP006_INVALID_TEMP) {
+            sample.Err = ERR_TMP006_INVALID_SAMPLE;
+        }
+    } else {
+        TXW51_LOG_WARNING("[TMP006] Could not read sample.");
+    }
+
+    if (sample.Callback != NULL) {
+        sample.Callback(sample.Err, objectTemp, dieTemp, sample.Context);
+    }
 }
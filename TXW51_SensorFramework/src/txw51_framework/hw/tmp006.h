@@ -1,6 +1,10 @@
 /***************************************************************************//**
  * @brief   Module to initialize and use the TMP006 via I2C interface on the TXW51.
  *
+ * The sensor signals finished conversions over its DRDY pin. A sample reads
+ * the sensor voltage and the die temperature and converts them to the object
+ * temperature on the device (see tmp006_calc.h).
+ *
  * @file    tmp006.h
  * @version 1.0
  * @date    22.04.2015
@@ -17,20 +21,92 @@
 #define TMP006_MANID 0xFE
 #define TMP006_DEVID 0xFF
 
-#include "twi_master.h"
+#define TMP006_VOBJ 0x00
+#define TMP006_TAMB 0x01
+#define TMP006_CONFIG 0x02
+
+#define TMP006_CFG_RESET     0x8000
+#define TMP006_CFG_MODEON    0x7000
+#define TMP006_CFG_1SAMPLE   0x0000
+#define TMP006_CFG_2SAMPLE   0x0200
+#define TMP006_CFG_4SAMPLE   0x0400
+#define TMP006_CFG_8SAMPLE   0x0600
+#define TMP006_CFG_16SAMPLE  0x0800
+#define TMP006_CFG_DRDYEN    0x0100
+#define TMP006_CFG_DRDY      0x0080
+
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "txw51_framework/hw/gpio.h"
+#include "txw51_framework/hw/i2c.h"
+#include "txw51_framework/hw/tmp006_calc.h"
+
+#define TXW51_TMP006_GPIO_DRDY              ( TXW51_GPIO_PIN_GPIO1 )        /**< GPIO pin for DRDY. */
+#define TXW51_TMP006_GPIO_DRDY_PULL_CONF    ( NRF_GPIO_PIN_PULLUP )         /**< Pull configuration for DRDY (open drain). */
+#define TXW51_TMP006_GPIO_DRDY_POL_CONF     ( NRF_GPIOTE_POLARITY_HITOLO )  /**< GPIOTE interrupt polarity for DRDY (active low). */
+#define TXW51_TMP006_GPIO_DRDY_CHANNEL      ( 1 )                           /**< GPIOTE interrupt channel for DRDY (INT2_A uses the sense interrupt). */
+
+/**
+ * @brief Callback that gets called when a sample has been read.
+ *
+ * @param[in] err        ERR_NONE if the sample is valid.
+ * @param[in] objectTemp The object temperature in 0.01 degC.
+ * @param[in] dieTemp    The die temperature in 0.01 degC.
+ * @param[in] context    The context that was given to TXW51_TMP006_ReadSample().
+ */
+typedef void (*TXW51_TMP006_SampleCallback_t) (uint32_t err,
+                                               int16_t objectTemp,
+                                               int16_t dieTemp,
+                                               void *context);
+
 /***************************************************************************//**
- * @brief Reads the temperature value.
- * *
- * @param[out] value Buffer to save the temperature.
+ * @brief Initializes the TMP006 sensor.
+ *
+ * Configures the DRDY interrupt and puts the sensor into power-down mode.
+ * TXW51_I2C_Init() has to be called before.
  *
  * @return ERR_NONE if no error occurred.
- *         ERR_TMP006_READ_FAILED if reading from the sensor failed.
+ *         ERR_I2C_QUEUE_FULL if the I2C queue is full.
  ******************************************************************************/
-extern uint32_t TXW51_TMP006_GetTemperature(uint8_t *value);
+extern uint32_t TXW51_TMP006_Init(void);
 
+/***************************************************************************//**
+ * @brief Starts continuous conversions.
+ *
+ * The DRDY pin signals every finished conversion.
+ *
+ * @param[in] sampleRate Number of averaged samples (TMP006_CFG_xSAMPLE).
+ *
+ * @return ERR_NONE if no error occurred.
+ *         ERR_I2C_QUEUE_FULL if the I2C queue is full.
+ ******************************************************************************/
+extern uint32_t TXW51_TMP006_Start(uint16_t sampleRate);
 
-#endif /* TMP006_H_ */
+/***************************************************************************//**
+ * @brief Puts the sensor into power-down mode.
+ *
+ * @return ERR_NONE if no error occurred.
+ *         ERR_I2C_QUEUE_FULL if the I2C queue is full.
+ ******************************************************************************/
+extern uint32_t TXW51_TMP006_Stop(void);
 
+/***************************************************************************//**
+ * @brief Reads the sensor voltage and the die temperature.
+ *
+ * Both registers are read without blocking. The callback receives the
+ * converted temperatures when both transactions have finished. Reading the
+ * result registers clears the DRDY pin.
+ *
+ * @param[in] callback Gets called with the temperatures.
+ * @param[in] context  Passed to the callback.
+ *
+ * @return ERR_NONE if the sample has been queued.
+ *         ERR_TMP006_BUSY if the previous sample has not finished yet.
+ *         ERR_I2C_QUEUE_FULL if the I2C queue is full.
+ ******************************************************************************/
+extern uint32_t TXW51_TMP006_ReadSample(TXW51_TMP006_SampleCallback_t callback,
+                                        void *context);
+
+
+#endif /* TMP006_H_ */
@@ -0,0 +1,167 @@
+/***************************************************************************//**
+ * @brief   Fixed point conversion of the TMP006 raw values.
+ *
+ * All calculations use integers. Voltages are in pV, the die temperature
+ * difference to the reference temperature is in 1/128 K (the resolution of
+ * the TAMB register) and the fourth powers of the temperatures are in
+ * (0.01 K)^4, which still fits into 64 bit for all reachable temperatures.
+ *
+ * @file    tmp006_calc.c
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+/*----- Header-Files ---------------------------------------------------------*/
+#include "tmp006_calc.h"
+
+/*----- Macros ---------------------------------------------------------------*/
+#define TMP006_CALC_KELVIN_OFFSET   ( 27315 )           /**< 0 degC in 0.01 K. */
+#define TMP006_CALC_TREF_RAW        ( 3200 )            /**< Reference temperature (25 degC) in 1/128 K. */
+#define TMP006_CALC_RAW_PER_K       ( 128 )             /**< Raw die temperature steps per K. */
+
+#define TMP006_CALC_VOBJ_LSB_PV     ( 156250LL )        /**< Sensor voltage LSB in pV. */
+
+#define TMP006_CALC_S_SCALE         ( 100000000LL )     /**< Scale of the sensitivity factor (S / S0). */
+#define TMP006_CALC_A1              ( 175000LL )        /**< A1 = 1.75e-3 scaled by TMP006_CALC_S_SCALE. */
+#define TMP006_CALC_A2              ( -1678LL )         /**< A2 = -1.678e-5 scaled by TMP006_CALC_S_SCALE. */
+
+#define TMP006_CALC_B0              ( -29400000LL )     /**< B0 = -2.94e-5 V in pV. */
+#define TMP006_CALC_B1              ( -570000LL )       /**< B1 = -5.7e-7 V/K in pV/K. */
+#define TMP006_CALC_B2              ( 4630LL )          /**< B2 = 4.63e-9 V/K^2 in pV/K^2. */
+
+#define TMP006_CALC_C2              ( 134LL )           /**< C2 = 13.4 scaled by 10. */
+#define TMP006_CALC_C2_DIVISOR      ( 10000000LL )      /**< Converts C2 * (nV)^2 to pV. */
+
+#define TMP006_CALC_S0_FACTOR       ( 15625ULL )        /**< 1 / S0 = 1.5625e13, split into this factor ... */
+#define TMP006_CALC_S0_DIVIDEND     ( 10000000000000ULL )   /**< ... and this dividend that is divided by the sensitivity factor. */
+
+/*----- Data types -----------------------------------------------------------*/
+
+/*----- Function prototypes --------------------------------------------------*/
+static int64_t TMP006_CALC_DivRound(int64_t dividend, int64_t divisor);
+static uint32_t TMP006_CALC_Sqrt(uint64_t value);
+
+/*----- Data -----------------------------------------------------------------*/
+
+/*----- Implementation -------------------------------------------------------*/
+
+int16_t TXW51_TMP006_CalcDieTemp(int16_t rawDieTemp)
+{
+    return (int16_t)TMP006_CALC_DivRound((int64_t)rawDieTemp * 100,
+                                         TMP006_CALC_RAW_PER_K);
+}
+
+
+int16_t TXW51_TMP006_CalcObjectTemp(int16_t rawVoltage, int16_t rawDieTemp)
+{
+    int64_t dT = (int64_t)rawDieTemp - TMP006_CALC_TREF_RAW;
+    int64_t dT2 = dT * dT;
+    const int64_t rawPerK2 = TMP006_CALC_RAW_PER_K * TMP006_CALC_RAW_PER_K;
+
+    /* S = S0 * (1 + A1 * dT + A2 * dT^2) */
+    int64_t sensitivity = TMP006_CALC_S_SCALE +
+                          TMP006_CALC_DivRound(TMP006_CALC_A1 * dT, TMP006_CALC_RAW_PER_K) +
+                          TMP006_CALC_DivRound(TMP006_CALC_A2 * dT2, rawPerK2);
+    if (sensitivity <= 0) {
+        return TXW51_TMP006_INVALID_TEMP;
+    }
+
+    /* Vos = B0 + B1 * dT + B2 * dT^2 */
+    int64_t offset = TMP006_CALC_B0 +
+                     TMP006_CALC_DivRound(TMP006_CALC_B1 * dT, TMP006_CALC_RAW_PER_K) +
+                     TMP006_CALC_DivRound(TMP006_CALC_B2 * dT2, rawPerK2);
+
+    /* f(Vobj) = (Vobj - Vos) + C2 * (Vobj - Vos)^2 */
+    int64_t diff = (int64_t)rawVoltage * TMP006_CALC_VOBJ_LSB_PV - offset;
+    int64_t diffNano = TMP006_CALC_DivRound(diff, 1000);
+    int64_t f = diff + TMP006_CALC_DivRound(TMP006_CALC_C2 * diffNano * diffNano,
+                                            TMP006_CALC_C2_DIVISOR);
+
+    /* f(Vobj) / S in (0.01 K)^4. */
+    uint64_t factor = (TMP006_CALC_S0_DIVIDEND + (uint64_t)sensitivity / 2) / (uint64_t)sensitivity;
+    uint64_t magnitude = ((f < 0) ? (uint64_t)-f : (uint64_t)f) * TMP006_CALC_S0_FACTOR;
+    uint64_t radiation;
+    if (magnitude > UINT64_MAX / factor) {
+        radiation = UINT64_MAX;
+    } else {
+        radiation = magnitude * factor;
+    }
+
+    /* Tobj = (Tdie^4 + f(Vobj) / S)^(1/4) */
+    uint64_t tDie = (uint64_t)(TMP006_CALC_KELVIN_OFFSET + TXW51_TMP006_CalcDieTemp(rawDieTemp));
+    uint64_t tDie4 = tDie * tDie * tDie * tDie;
+    uint64_t tObj4;
+    if (f >= 0) {
+        tObj4 = (radiation > UINT64_MAX - tDie4) ? UINT64_MAX : (tDie4 + radiation);
+    } else {
+        tObj4 = (radiation > tDie4) ? 0 : (tDie4 - radiation);
+    }
+
+    uint32_t tObj2 = TMP006_CALC_Sqrt(tObj4);
+    uint32_t tObj = TMP006_CALC_Sqrt(tObj2);
+    if ((tObj2 - tObj * tObj) > tObj) {
+        /* Round to nearest instead of truncating. */
+        tObj++;
+    }
+
+    int32_t result = (int32_t)tObj - TMP006_CALC_KELVIN_OFFSET;
+    if (result > INT16_MAX) {
+        result = INT16_MAX;
+    } else if (result <= INT16_MIN) {
+        result = INT16_MIN + 1;
+    }
+
+    return (int16_t)result;
+}
+
+
+/***************************************************************************//**
+ * @brief Divides and rounds to the nearest integer.
+ *
+ * @param[in] dividend The dividend.
+ * @param[in] divisor  The divisor, has to be positive.
+ *
+ * @return The rounded quotient.
+ ******************************************************************************/
+static int64_t TMP006_CALC_DivRound(int64_t dividend, int64_t divisor)
+{
+    if (dividend < 0) {
+        return (dividend - divisor / 2) / divisor;
+    }
+
+    return (dividend + divisor / 2) / divisor;
+}
+
+
+/***************************************************************************//**
+ * @brief Calculates the integer square root (rounded down).
+ *
+ * @param[in] value The radicand.
+ *
+ * @return The square root of the value.
+ ******************************************************************************/
+static uint32_t TMP006_CALC_Sqrt(uint64_t value)
+{
+    uint64_t result = 0;
+    uint64_t bit = 1ULL << 62;
+
+    while (bit > value) {
+        bit >>= 2;
+    }
+
+    while (bit != 0) {
+        if (value >= result + bit) {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return (uint32_t)result;
+}
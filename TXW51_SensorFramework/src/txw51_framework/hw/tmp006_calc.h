@@ -0,0 +1,53 @@
+/***************************************************************************//**
+ * @brief   Fixed point conversion of the TMP006 raw values.
+ *
+ * Implements the object temperature model of the TMP006 user guide with the
+ * S0, A1, A2, B0, B1, B2 and C2 coefficients without floating point. The
+ * module has no hardware dependencies, so it can be tested on the host.
+ *
+ * @file    tmp006_calc.h
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+#ifndef TXW51_FRAMEWORK_HW_TMP006_CALC_H_
+#define TXW51_FRAMEWORK_HW_TMP006_CALC_H_
+
+/*----- Header-Files ---------------------------------------------------------*/
+#include <stdint.h>
+
+/*----- Macros ---------------------------------------------------------------*/
+#define TXW51_TMP006_INVALID_TEMP   ( INT16_MIN )   /**< Returned if the raw values are outside of the model. */
+
+/*----- Data types -----------------------------------------------------------*/
+
+/*----- Function prototypes --------------------------------------------------*/
+
+/***************************************************************************//**
+ * @brief Converts the raw die temperature.
+ *
+ * @param[in] rawDieTemp Content of the TAMB register (1/128 degC per LSB).
+ *
+ * @return The die temperature in 0.01 degC.
+ ******************************************************************************/
+extern int16_t TXW51_TMP006_CalcDieTemp(int16_t rawDieTemp);
+
+/***************************************************************************//**
+ * @brief Calculates the object temperature from the raw register values.
+ *
+ * @param[in] rawVoltage Content of the VOBJ register (156.25 nV per LSB).
+ * @param[in] rawDieTemp Content of the TAMB register (1/128 degC per LSB).
+ *
+ * @return The object temperature in 0.01 degC.
+ *         TXW51_TMP006_INVALID_TEMP if the die temperature is outside of the
+ *         range of the model.
+ ******************************************************************************/
+extern int16_t TXW51_TMP006_CalcObjectTemp(int16_t rawVoltage, int16_t rawDieTemp);
+
+/*----- Data -----------------------------------------------------------------*/
+
+#endif /* TXW51_FRAMEWORK_HW_TMP006_CALC_H_ */
@@ -0,0 +1,238 @@
+/***************************************************************************//**
+ * @brief   Applies a binary delta to a firmware image.
+ *
+ * @file    delta.c
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+/*----- Header-Files ---------------------------------------------------------*/
+#include "delta.h"
+
+#include <string.h>
+
+#include "nrf/app_common/crc16.h"
+
+#include "txw51_framework/utils/txw51_errors.h"
+
+/*----- Macros ---------------------------------------------------------------*/
+#define DELTA_MAX_NUMBER_LENGTH     ( 5 )   /**< Maximum length of an LEB128 number with 32 bits. */
+
+/*----- Data types -----------------------------------------------------------*/
+
+/*----- Function prototypes --------------------------------------------------*/
+static uint32_t DELTA_GetUint32(const uint8_t *buffer);
+static bool DELTA_ReadNumber(struct TXW51_DELTA_Patch *patch, uint32_t *value);
+static uint32_t DELTA_ReadCommand(struct TXW51_DELTA_Patch *patch);
+
+/*----- Data -----------------------------------------------------------------*/
+
+/*----- Implementation -------------------------------------------------------*/
+
+uint32_t TXW51_DELTA_ReadHeader(const uint8_t *delta,
+                                uint32_t deltaSize,
+                                struct TXW51_DELTA_Header *header)
+{
+    if ((deltaSize < TXW51_DELTA_HEADER_LENGTH) ||
+        (DELTA_GetUint32(&delta[0]) != TXW51_DELTA_MAGIC)) {
+        return ERR_DELTA_INVALID_HEADER;
+    }
+
+    header->SourceSize = DELTA_GetUint32(&delta[4]);
+    header->TargetSize = DELTA_GetUint32(&delta[8]);
+    header->SourceCrc  = delta[12] | (delta[13] << 8);
+    header->TargetCrc  = delta[14] | (delta[15] << 8);
+    return ERR_NONE;
+}
+
+
+uint32_t TXW51_DELTA_Init(struct TXW51_DELTA_Patch *patch,
+                          const uint8_t *source,
+                          uint32_t sourceSize,
+                          const uint8_t *delta,
+                          uint32_t deltaSize)
+{
+    uint32_t err;
+
+    memset(patch, 0, sizeof(*patch));
+
+    err = TXW51_DELTA_ReadHeader(delta, deltaSize, &patch->Header);
+    if (err != ERR_NONE) {
+        return err;
+    }
+
+    if ((patch->Header.SourceSize > sourceSize) ||
+        (crc16_compute(source, patch->Header.SourceSize, NULL) != patch->Header.SourceCrc)) {
+        return ERR_DELTA_WRONG_SOURCE;
+    }
+
+    patch->Source    = source;
+    patch->Delta     = delta;
+    patch->DeltaSize = deltaSize;
+    patch->DeltaPos  = TXW51_DELTA_HEADER_LENGTH;
+    patch->Crc       = 0xFFFF;
+    return ERR_NONE;
+}
+
+
+uint32_t TXW51_DELTA_Apply(struct TXW51_DELTA_Patch *patch,
+                           uint8_t *block,
+                           uint32_t maxLength,
+                           uint32_t *length)
+{
+    uint32_t err;
+    uint32_t produced = 0;
+
+    while ((produced < maxLength) && !TXW51_DELTA_IsComplete(patch)) {
+        if (patch->Remaining == 0) {
+            err = DELTA_ReadCommand(patch);
+            if (err != ERR_NONE) {
+                *length = 0;
+                return err;
+            }
+        }
+
+        uint32_t count = maxLength - produced;
+        if (count > patch->Remaining) {
+            count = patch->Remaining;
+        }
+
+        if (patch->Command == TXW51_DELTA_CMD_COPY) {
+            memcpy(&block[produced], &patch->Source[patch->SourcePos], count);
+            patch->SourcePos += count;
+        } else {
+            memcpy(&block[produced], &patch->Delta[patch->DeltaPos], count);
+            patch->DeltaPos += count;
+        }
+
+        patch->Remaining -= count;
+        patch->TargetPos += count;
+        produced += count;
+    }
+
+    patch->Crc = crc16_compute(block, produced, &patch->Crc);
+    *length = produced;
+
+    if (TXW51_DELTA_IsComplete(patch) && (patch->Crc != patch->Header.TargetCrc)) {
+        return ERR_DELTA_TARGET_CRC;
+    }
+    return ERR_NONE;
+}
+
+
+bool TXW51_DELTA_IsComplete(const struct TXW51_DELTA_Patch *patch)
+{
+    return (patch->TargetPos >= patch->Header.TargetSize);
+}
+
+
+/***************************************************************************//**
+ * @brief Reads a little-endian 32-bit value.
+ *
+ * @param[in] buffer Where to read the value.
+ *
+ * @return The value.
+ ******************************************************************************/
+static uint32_t DELTA_GetUint32(const uint8_t *buffer)
+{
+    return (uint32_t)buffer[0] |
+           ((uint32_t)buffer[1] << 8) |
+           ((uint32_t)buffer[2] << 16) |
+           ((uint32_t)buffer[3] << 24);
+}
+
+
+/***************************************************************************//**
+ * @brief Reads an unsigned LEB128 number from the delta.
+ *
+ * @param[in,out] patch State of the delta.
+ * @param[out]    value The number.
+ *
+ * @return False if the number is too long or reaches beyond the delta.
+ ******************************************************************************/
+static bool DELTA_ReadNumber(struct TXW51_DELTA_Patch *patch, uint32_t *value)
+{
+    *value = 0;
+
+    for (uint32_t i = 0; i < DELTA_MAX_NUMBER_LENGTH; i++) {
+        if (patch->DeltaPos >= patch->DeltaSize) {
+            return false;
+        }
+
+        uint8_t byte = patch->Delta[patch->DeltaPos++];
+        *value |= (uint32_t)(byte & 0x7F) << (7 * i);
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/***************************************************************************//**
+ * @brief Reads the next command and checks that it stays within the images.
+ *
+ * @param[in,out] patch State of the delta.
+ *
+ * @return ERR_NONE if no error occurred.
+ *         ERR_DELTA_CORRUPT if the command is invalid.
+ ******************************************************************************/
+static uint32_t DELTA_ReadCommand(struct TXW51_DELTA_Patch *patch)
+{
+    uint32_t offset;
+    uint32_t count;
+
+    if (patch->DeltaPos >= patch->DeltaSize) {
+        return ERR_DELTA_CORRUPT;
+    }
+
+    patch->Command = patch->Delta[patch->DeltaPos++];
+
+    switch (patch->Command) {
+        case TXW51_DELTA_CMD_COPY:
+            if (!DELTA_ReadNumber(patch, &offset) || !DELTA_ReadNumber(patch, &count)) {
+                return ERR_DELTA_CORRUPT;
+            }
+
+            /* Zigzag: even values are positive, odd values negative offsets. */
+            if (offset & 1) {
+                offset = (offset >> 1) + 1;
+                if (offset > patch->SourcePos) {
+                    return ERR_DELTA_CORRUPT;
+                }
+                patch->SourcePos -= offset;
+            } else {
+                offset >>= 1;
+                if (offset > patch->Header.SourceSize - patch->SourcePos) {
+                    return ERR_DELTA_CORRUPT;
+                }
+                patch->SourcePos += offset;
+            }
+
+            if (count > patch->Header.SourceSize - patch->SourcePos) {
+                return ERR_DELTA_CORRUPT;
+            }
+            break;
+
+        case TXW51_DELTA_CMD_INSERT:
+            if (!DELTA_ReadNumber(patch, &count) ||
+                (count > patch->DeltaSize - patch->DeltaPos)) {
+                return ERR_DELTA_CORRUPT;
+            }
+            break;
+
+        default:
+            return ERR_DELTA_CORRUPT;
+    }
+
+    if ((count == 0) || (count > patch->Header.TargetSize - patch->TargetPos)) {
+        return ERR_DELTA_CORRUPT;
+    }
+
+    patch->Remaining = count;
+    return ERR_NONE;
+}
@@ -0,0 +1,161 @@
+/***************************************************************************//**
+ * @brief   Applies a binary delta to a firmware image.
+ *
+ * A delta describes the new image with pieces of the running image, so only
+ * the changed bytes have to be transferred for an update. It starts with a
+ * header (all values little-endian):
+ *
+ *  - uint32 TXW51_DELTA_MAGIC
+ *  - uint32 size of the source image (the running image)
+ *  - uint32 size of the target image (the new image)
+ *  - uint16 CRC16 of the source image
+ *  - uint16 CRC16 of the target image
+ *
+ * followed by commands until the target is complete. Every command is one
+ * byte followed by unsigned LEB128 numbers:
+ *
+ *  - TXW51_DELTA_CMD_COPY:   offset, length. Copies length bytes from the
+ *                            source. The offset is zigzag encoded and
+ *                            relative to the end of the previous copy.
+ *  - TXW51_DELTA_CMD_INSERT: length. The length bytes that follow the
+ *                            command are the next bytes of the target.
+ *
+ * Bytes after the last command are padding and ignored. The CRC16 is the
+ * one of crc16.c (CCITT, initial value 0xFFFF).
+ *
+ * The delta and the source are read in place (memory-mapped flash), the
+ * target is produced in blocks of any size, so the caller decides how much
+ * RAM it spends for the output. The source CRC is checked before anything is
+ * produced and the target CRC after the last block. Deltas are created by
+ * tools/delta on the host.
+ *
+ * The module is part of the bootloader and the host tools, it is not built
+ * into the application.
+ *
+ * @file    delta.h
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+#ifndef TXW51_FRAMEWORK_UTILS_DELTA_H_
+#define TXW51_FRAMEWORK_UTILS_DELTA_H_
+
+/*----- Header-Files ---------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+
+/*----- Macros ---------------------------------------------------------------*/
+#define TXW51_DELTA_MAGIC           ( 0x44575854UL )    /**< "TXWD" at the start of a delta. */
+#define TXW51_DELTA_HEADER_LENGTH   ( 16 )              /**< Length of the header in bytes. */
+
+/*----- Data types -----------------------------------------------------------*/
+/**
+ * @brief The commands of a delta.
+ */
+enum TXW51_DELTA_Command {
+    TXW51_DELTA_CMD_COPY   = 0x01,  /**< Copy bytes from the source. */
+    TXW51_DELTA_CMD_INSERT = 0x02   /**< Insert bytes from the delta. */
+};
+
+/**
+ * @brief The header of a delta.
+ */
+struct TXW51_DELTA_Header {
+    uint32_t SourceSize;    /**< Size of the source image in bytes. */
+    uint32_t TargetSize;    /**< Size of the target image in bytes. */
+    uint16_t SourceCrc;     /**< CRC16 of the source image. */
+    uint16_t TargetCrc;     /**< CRC16 of the target image. */
+};
+
+/**
+ * @brief State of a delta that is being applied.
+ */
+struct TXW51_DELTA_Patch {
+    struct TXW51_DELTA_Header Header;   /**< Header of the delta. */
+    const uint8_t *Source;              /**< The source image. */
+    const uint8_t *Delta;               /**< The delta. */
+    uint32_t DeltaSize;                 /**< Size of the delta in bytes. */
+    uint32_t DeltaPos;                  /**< Read position in the delta. */
+    uint32_t SourcePos;                 /**< Read position in the source. */
+    uint32_t TargetPos;                 /**< Number of target bytes produced. */
+    uint32_t Remaining;                 /**< Bytes left of the current command. */
+    uint8_t  Command;                   /**< The current command (enum TXW51_DELTA_Command). */
+    uint16_t Crc;                       /**< CRC16 of the target bytes produced. */
+};
+
+/*----- Function prototypes --------------------------------------------------*/
+
+/***************************************************************************//**
+ * @brief Reads the header of a delta.
+ *
+ * Can be used to detect a delta among full images.
+ *
+ * @param[in]  delta     The delta.
+ * @param[in]  deltaSize Size of the delta in bytes.
+ * @param[out] header    The header.
+ *
+ * @return ERR_NONE if no error occurred.
+ *         ERR_DELTA_INVALID_HEADER if the data is not a delta.
+ ******************************************************************************/
+extern uint32_t TXW51_DELTA_ReadHeader(const uint8_t *delta,
+                                       uint32_t deltaSize,
+                                       struct TXW51_DELTA_Header *header);
+
+/***************************************************************************//**
+ * @brief Starts to apply a delta.
+ *
+ * @param[out] patch      State of the delta.
+ * @param[in]  source     The source image, has to stay valid until the
+ *                        target is complete.
+ * @param[in]  sourceSize Size of the source image in bytes.
+ * @param[in]  delta      The delta, has to stay valid until the target is
+ *                        complete.
+ * @param[in]  deltaSize  Size of the delta in bytes.
+ *
+ * @return ERR_NONE if no error occurred.
+ *         ERR_DELTA_INVALID_HEADER if the data is not a delta.
+ *         ERR_DELTA_WRONG_SOURCE if the delta has been made for another
+ *                                source image.
+ ******************************************************************************/
+extern uint32_t TXW51_DELTA_Init(struct TXW51_DELTA_Patch *patch,
+                                 const uint8_t *source,
+                                 uint32_t sourceSize,
+                                 const uint8_t *delta,
+                                 uint32_t deltaSize);
+
+/***************************************************************************//**
+ * @brief Produces the next block of the target image.
+ *
+ * @param[in,out] patch     State of the delta.
+ * @param[out]    block     Buffer for the block.
+ * @param[in]     maxLength Size of the buffer in bytes.
+ * @param[out]    length    Number of bytes written to the buffer. Smaller
+ *                          than maxLength only for the last block.
+ *
+ * @return ERR_NONE if no error occurred.
+ *         ERR_DELTA_CORRUPT if a command is invalid or reaches beyond the
+ *                           source, the delta or the target.
+ *         ERR_DELTA_TARGET_CRC if the completed target does not match the
+ *                              CRC of the header.
+ ******************************************************************************/
+extern uint32_t TXW51_DELTA_Apply(struct TXW51_DELTA_Patch *patch,
+                                  uint8_t *block,
+                                  uint32_t maxLength,
+                                  uint32_t *length);
+
+/***************************************************************************//**
+ * @brief Checks if the target image is complete.
+ *
+ * @param[in] patch State of the delta.
+ *
+ * @return True if all bytes of the target have been produced.
+ ******************************************************************************/
+extern bool TXW51_DELTA_IsComplete(const struct TXW51_DELTA_Patch *patch);
+
+/*----- Data -----------------------------------------------------------------*/
+
+#endif /* TXW51_FRAMEWORK_UTILS_DELTA_H_ */
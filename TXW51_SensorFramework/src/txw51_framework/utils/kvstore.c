@@ -0,0 +1,562 @@
+/***************************************************************************//**
+ * @brief   Log-structured key-value store on two flash pages.
+ *
+ * @file    kvstore.c
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+/*----- Header-Files ---------------------------------------------------------*/
+#include "kvstore.h"
+
+#include <string.h>
+
+#include "nrf/app_common/crc16.h"
+
+#include "txw51_framework/config/config.h"
+#include "txw51_framework/hw/flash.h"
+#include "txw51_framework/utils/log.h"
+#include "txw51_framework/utils/txw51_errors.h"
+
+/*----- Macros ---------------------------------------------------------------*/
+#define KVSTORE_MAGIC               ( 0x4B565331UL )    /**< Marks a valid page ("KVS1"). */
+#define KVSTORE_ERASED_WORD         ( 0xFFFFFFFFUL )    /**< Content of an erased flash word. */
+
+/**
+ * @brief Words of the page header: Magic, generation and inverted generation.
+ *
+ * The inverted generation detects a header that has only partially been
+ * written or erased.
+ */
+#define KVSTORE_HEADER_WORDS        ( 3 )
+
+#define KVSTORE_RECORD_WORDS(len)   ( 1 + (((len) + 3) / 4) )   /**< Words of a record with a value of the given length. */
+#define KVSTORE_RECORD_MAX_WORDS    KVSTORE_RECORD_WORDS(CONFIG_KVSTORE_MAX_VALUE_LENGTH)   /**< Words of the longest record. */
+
+#define KVSTORE_HEADER_KEY(h)       ( (uint8_t)((h) & 0xFF) )           /**< Key of a record header. */
+#define KVSTORE_HEADER_LENGTH(h)    ( (uint8_t)(((h) >> 8) & 0xFF) )    /**< Value length of a record header. */
+#define KVSTORE_HEADER_CRC(h)       ( (uint16_t)((h) >> 16) )           /**< CRC of a record header. */
+
+/*----- Data types -----------------------------------------------------------*/
+/**
+ * @brief The flash operation that is currently executed.
+ */
+enum KVSTORE_State {
+    KVSTORE_STATE_IDLE,         /**< No operation is pending. */
+    KVSTORE_STATE_APPEND,       /**< A record of the queue is appended to the active page. */
+    KVSTORE_STATE_ERASE,        /**< The other page is erased for compaction. */
+    KVSTORE_STATE_COPY,         /**< A record is copied to the other page. */
+    KVSTORE_STATE_HEADER        /**< The header of the other page is written. */
+};
+
+/**
+ * @brief A record that is waiting to be written.
+ */
+struct KVSTORE_Record {
+    uint32_t Words[KVSTORE_RECORD_MAX_WORDS];   /**< Header and padded value as written to flash. */
+};
+
+/*----- Function prototypes --------------------------------------------------*/
+static bool KVSTORE_IsPageValid(uint32_t *page, uint32_t *generation);
+static void KVSTORE_ScanPage(void);
+static bool KVSTORE_IsRecordValid(const uint32_t *page, uint32_t offset);
+static uint16_t KVSTORE_CalcCrc(uint8_t key, uint8_t length, const uint8_t *value);
+static bool KVSTORE_FindNewest(uint8_t key, const uint8_t **value, uint8_t *length);
+static void KVSTORE_Enqueue(uint8_t key, const uint8_t *value, uint8_t length);
+static void KVSTORE_Process(void);
+static void KVSTORE_CopyNext(void);
+static void KVSTORE_HandleFailure(void);
+static void KVSTORE_FlashCallback(uint32_t err);
+
+/*----- Data -----------------------------------------------------------------*/
+static uint32_t *pages[2];                  /**< Start of the two flash pages. */
+static uint32_t pageWords;                  /**< Size of a page in words. */
+static uint8_t  activePage;                 /**< Page the records are appended to. */
+static uint32_t generation;                 /**< Generation number of the active page. */
+static uint32_t writeOffset;                /**< Word offset of the next record on the active page. */
+static bool     needsCompaction;            /**< The active page is full or damaged. */
+static enum KVSTORE_State state;            /**< The operation that is currently executed. */
+static uint32_t retries;                    /**< Failed attempts of the current operation. */
+
+/**
+ * @brief Word offset of the newest record of every key, 0 if there is none.
+ */
+static uint16_t recordOffsets[CONFIG_KVSTORE_MAX_KEYS];
+
+static struct KVSTORE_Record queue[CONFIG_KVSTORE_QUEUE_SIZE];  /**< Records waiting to be written. */
+static uint8_t queueHead;                   /**< Index of the oldest record in the queue. */
+static uint8_t queueCount;                  /**< Number of records in the queue. */
+
+static uint16_t copyOffsets[CONFIG_KVSTORE_MAX_KEYS];   /**< Offsets of the records on the new page. */
+static uint8_t  copyKey;                    /**< The key that is copied. */
+static uint32_t copyOffset;                 /**< Word offset of the next record on the new page. */
+static uint32_t copyBuffer[KVSTORE_RECORD_MAX_WORDS];   /**< The record that is copied. */
+static uint32_t pageHeader[KVSTORE_HEADER_WORDS];       /**< Header of the new page. */
+
+/*----- Implementation -------------------------------------------------------*/
+
+uint32_t TXW51_KVSTORE_Init(uint32_t *firstPage, uint32_t pageSize)
+{
+    uint32_t generations[2];
+    bool isValid[2];
+
+    pageWords = pageSize / sizeof(uint32_t);
+    pages[0] = firstPage;
+    pages[1] = firstPage + pageWords;
+
+    /* After a compaction every key and the next record have to fit. */
+    if (KVSTORE_HEADER_WORDS + (CONFIG_KVSTORE_MAX_KEYS + 1) * KVSTORE_RECORD_MAX_WORDS > pageWords) {
+        TXW51_LOG_ERROR("[KVStore] Pages are too small.");
+        return ERR_KVSTORE_INVALID_PAGE;
+    }
+
+    state = KVSTORE_STATE_IDLE;
+    retries = 0;
+    queueHead = 0;
+    queueCount = 0;
+    memset(recordOffsets, 0, sizeof(recordOffsets));
+    TXW51_FLASH_Init(KVSTORE_FlashCallback);
+
+    isValid[0] = KVSTORE_IsPageValid(pages[0], &generations[0]);
+    isValid[1] = KVSTORE_IsPageValid(pages[1], &generations[1]);
+
+    if (!isValid[0] && !isValid[1]) {
+        /* Format the store with the first write: Compacting the empty
+         * index into page 0 creates the first generation. */
+        activePage = 1;
+        generation = 0;
+        writeOffset = pageWords;
+        needsCompaction = true;
+        TXW51_LOG_INFO("[KVStore] Store is empty.");
+        return ERR_NONE;
+    }
+
+    if (isValid[0] && isValid[1]) {
+        activePage = (generations[1] > generations[0]) ? 1 : 0;
+    } else {
+        activePage = isValid[1] ? 1 : 0;
+    }
+    generation = generations[activePage];
+
+    KVSTORE_ScanPage();
+
+    TXW51_LOG_DEBUG("[KVStore] Initialization successful.");
+    return ERR_NONE;
+}
+
+
+uint32_t TXW51_KVSTORE_Get(uint8_t key, uint8_t *value, uint8_t *length)
+{
+    const uint8_t *storedValue;
+    uint8_t storedLength;
+
+    if (key >= CONFIG_KVSTORE_MAX_KEYS) {
+        return ERR_KVSTORE_INVALID_KEY;
+    }
+
+    if (!KVSTORE_FindNewest(key, &storedValue, &storedLength)) {
+        return ERR_KVSTORE_NOT_FOUND;
+    }
+
+    if (storedLength > *length) {
+        return ERR_KVSTORE_INVALID_LENGTH;
+    }
+
+    memcpy(value, storedValue, storedLength);
+    *length = storedLength;
+
+    return ERR_NONE;
+}
+
+
+uint32_t TXW51_KVSTORE_Set(uint8_t key, const uint8_t *value, uint8_t length)
+{
+    const uint8_t *storedValue;
+    uint8_t storedLength;
+
+    if (key >= CONFIG_KVSTORE_MAX_KEYS) {
+        return ERR_KVSTORE_INVALID_KEY;
+    }
+
+    if ((length == 0) || (length > CONFIG_KVSTORE_MAX_VALUE_LENGTH)) {
+        return ERR_KVSTORE_INVALID_LENGTH;
+    }
+
+    if (KVSTORE_FindNewest(key, &storedValue, &storedLength) &&
+        (storedLength == length) &&
+        (memcmp(storedValue, value, length) == 0)) {
+        /* Value is already stored. */
+        return ERR_NONE;
+    }
+
+    if (queueCount >= CONFIG_KVSTORE_QUEUE_SIZE) {
+        return ERR_KVSTORE_QUEUE_FULL;
+    }
+
+    KVSTORE_Enqueue(key, value, length);
+    KVSTORE_Process();
+
+    return ERR_NONE;
+}
+
+
+uint32_t TXW51_KVSTORE_Delete(uint8_t key)
+{
+    const uint8_t *storedValue;
+    uint8_t storedLength;
+
+    if (key >= CONFIG_KVSTORE_MAX_KEYS) {
+        return ERR_KVSTORE_INVALID_KEY;
+    }
+
+    if (!KVSTORE_FindNewest(key, &storedValue, &storedLength)) {
+        return ERR_NONE;
+    }
+
+    if (queueCount >= CONFIG_KVSTORE_QUEUE_SIZE) {
+        return ERR_KVSTORE_QUEUE_FULL;
+    }
+
+    KVSTORE_Enqueue(key, NULL, 0);
+    KVSTORE_Process();
+
+    return ERR_NONE;
+}
+
+
+bool TXW51_KVSTORE_IsBusy(void)
+{
+    return (queueCount > 0) || (state != KVSTORE_STATE_IDLE);
+}
+
+
+/***************************************************************************//**
+ * @brief Checks the header of a page.
+ *
+ * @param[in]  page       The page to check.
+ * @param[out] generation The generation number of the page.
+ *
+ * @return True if the page has a complete header.
+ ******************************************************************************/
+static bool KVSTORE_IsPageValid(uint32_t *page, uint32_t *generation)
+{
+    *generation = page[1];
+
+    return (page[0] == KVSTORE_MAGIC) &&
+           (page[1] != KVSTORE_ERASED_WORD) &&
+           (page[2] == ~page[1]);
+}
+
+
+/***************************************************************************//**
+ * @brief Builds the index from the records of the active page.
+ *
+ * The scan stops at the first erased or damaged record. If a write has been
+ * interrupted, the page is compacted before the next record is appended.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void KVSTORE_ScanPage(void)
+{
+    const uint32_t *page = pages[activePage];
+    uint32_t offset = KVSTORE_HEADER_WORDS;
+
+    needsCompaction = false;
+
+    while ((offset < pageWords) && (page[offset] != KVSTORE_ERASED_WORD)) {
+        if (!KVSTORE_IsRecordValid(page, offset)) {
+            TXW51_LOG_WARNING("[KVStore] Damaged record found.");
+            needsCompaction = true;
+            break;
+        }
+
+        uint8_t key = KVSTORE_HEADER_KEY(page[offset]);
+        uint8_t length = KVSTORE_HEADER_LENGTH(page[offset]);
+
+        recordOffsets[key] = (length > 0) ? offset : 0;
+        offset += KVSTORE_RECORD_WORDS(length);
+    }
+    writeOffset = offset;
+
+    /* The free space has to be erased, otherwise appending is not possible. */
+    for (uint32_t i = offset; (i < pageWords) && !needsCompaction; i++) {
+        if (page[i] != KVSTORE_ERASED_WORD) {
+            TXW51_LOG_WARNING("[KVStore] Incomplete record found.");
+            needsCompaction = true;
+        }
+    }
+}
+
+
+/***************************************************************************//**
+ * @brief Checks a record on the flash.
+ *
+ * @param[in] page   The page of the record.
+ * @param[in] offset Word offset of the record header.
+ *
+ * @return True if the record is complete.
+ ******************************************************************************/
+static bool KVSTORE_IsRecordValid(const uint32_t *page, uint32_t offset)
+{
+    uint32_t header = page[offset];
+    uint8_t key = KVSTORE_HEADER_KEY(header);
+    uint8_t length = KVSTORE_HEADER_LENGTH(header);
+
+    if ((key >= CONFIG_KVSTORE_MAX_KEYS) ||
+        (length > CONFIG_KVSTORE_MAX_VALUE_LENGTH) ||
+        (offset + KVSTORE_RECORD_WORDS(length) > pageWords)) {
+        return false;
+    }
+
+    return KVSTORE_HEADER_CRC(header) ==
+           KVSTORE_CalcCrc(key, length, (const uint8_t *)&page[offset + 1]);
+}
+
+
+/***************************************************************************//**
+ * @brief Calculates the CRC of a record.
+ *
+ * @param[in] key    The key of the record.
+ * @param[in] length The length of the value.
+ * @param[in] value  The value.
+ *
+ * @return The CRC over key, length and value.
+ ******************************************************************************/
+static uint16_t KVSTORE_CalcCrc(uint8_t key, uint8_t length, const uint8_t *value)
+{
+    uint8_t header[2] = { key, length };
+    uint16_t crc;
+
+    crc = crc16_compute(header, sizeof(header), NULL);
+    if (length > 0) {
+        crc = crc16_compute(value, length, &crc);
+    }
+
+    return crc;
+}
+
+
+/***************************************************************************//**
+ * @brief Finds the newest value of a key.
+ *
+ * Pending writes are newer than the records on the flash.
+ *
+ * @param[in]  key    The key to find.
+ * @param[out] value  Points to the value.
+ * @param[out] length The length of the value.
+ *
+ * @return True if the key has a value.
+ ******************************************************************************/
+static bool KVSTORE_FindNewest(uint8_t key, const uint8_t **value, uint8_t *length)
+{
+    for (int32_t i = queueCount - 1; i >= 0; i--) {
+        struct KVSTORE_Record *record = &queue[(queueHead + i) % CONFIG_KVSTORE_QUEUE_SIZE];
+
+        if (KVSTORE_HEADER_KEY(record->Words[0]) == key) {
+            *value = (const uint8_t *)&record->Words[1];
+            *length = KVSTORE_HEADER_LENGTH(record->Words[0]);
+            return (*length > 0);
+        }
+    }
+
+    if (recordOffsets[key] == 0) {
+        return false;
+    }
+
+    const uint32_t *record = &pages[activePage][recordOffsets[key]];
+    *value = (const uint8_t *)&record[1];
+    *length = KVSTORE_HEADER_LENGTH(record[0]);
+
+    return true;
+}
+
+
+/***************************************************************************//**
+ * @brief Puts a record into the queue.
+ *
+ * @param[in] key    The key of the record.
+ * @param[in] value  The value, unused if the length is 0.
+ * @param[in] length The length of the value, 0 to delete the key.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void KVSTORE_Enqueue(uint8_t key, const uint8_t *value, uint8_t length)
+{
+    struct KVSTORE_Record *record =
+            &queue[(queueHead + queueCount) % CONFIG_KVSTORE_QUEUE_SIZE];
+
+    memset(record->Words, 0xFF, sizeof(record->Words));
+    if (length > 0) {
+        memcpy(&record->Words[1], value, length);
+    }
+    record->Words[0] = ((uint32_t)KVSTORE_CalcCrc(key, length, value) << 16) |
+                       ((uint32_t)length << 8) |
+                       key;
+
+    queueCount++;
+}
+
+
+/***************************************************************************//**
+ * @brief Starts the next flash operation.
+ *
+ * Compaction is started only if records are waiting, so a damaged page is
+ * rewritten with the next write.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void KVSTORE_Process(void)
+{
+    while ((state == KVSTORE_STATE_IDLE) && (queueCount > 0)) {
+        uint32_t err;
+
+        if (needsCompaction) {
+            state = KVSTORE_STATE_ERASE;
+            err = TXW51_FLASH_ErasePage(pages[activePage ^ 1]);
+        } else {
+            uint32_t *record = queue[queueHead].Words;
+            uint32_t words = KVSTORE_RECORD_WORDS(KVSTORE_HEADER_LENGTH(record[0]));
+
+            if (writeOffset + words > pageWords) {
+                needsCompaction = true;
+                continue;
+            }
+
+            state = KVSTORE_STATE_APPEND;
+            err = TXW51_FLASH_Write(&pages[activePage][writeOffset], record, words);
+        }
+
+        if (err != ERR_NONE) {
+            KVSTORE_HandleFailure();
+        }
+    }
+}
+
+
+/***************************************************************************//**
+ * @brief Copies the next key to the new page or finishes the compaction.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void KVSTORE_CopyNext(void)
+{
+    uint32_t err;
+
+    while ((copyKey < CONFIG_KVSTORE_MAX_KEYS) && (recordOffsets[copyKey] == 0)) {
+        copyKey++;
+    }
+
+    if (copyKey < CONFIG_KVSTORE_MAX_KEYS) {
+        const uint32_t *record = &pages[activePage][recordOffsets[copyKey]];
+        uint32_t words = KVSTORE_RECORD_WORDS(KVSTORE_HEADER_LENGTH(record[0]));
+
+        memcpy(copyBuffer, record, words * sizeof(uint32_t));
+        state = KVSTORE_STATE_COPY;
+        err = TXW51_FLASH_Write(&pages[activePage ^ 1][copyOffset], copyBuffer, words);
+    } else {
+        /* The header is written last, it makes the new page valid. */
+        pageHeader[0] = KVSTORE_MAGIC;
+        pageHeader[1] = generation + 1;
+        pageHeader[2] = ~(generation + 1);
+        state = KVSTORE_STATE_HEADER;
+        err = TXW51_FLASH_Write(pages[activePage ^ 1], pageHeader, KVSTORE_HEADER_WORDS);
+    }
+
+    if (err != ERR_NONE) {
+        KVSTORE_HandleFailure();
+    }
+}
+
+
+/***************************************************************************//**
+ * @brief Handles a failed flash operation.
+ *
+ * A failed append leaves a damaged record, so the page gets compacted. A
+ * failed compaction starts over. After too many failures the oldest record
+ * of the queue is dropped.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void KVSTORE_HandleFailure(void)
+{
+    if (state == KVSTORE_STATE_APPEND) {
+        needsCompaction = true;
+    }
+    state = KVSTORE_STATE_IDLE;
+
+    retries++;
+    if (retries > CONFIG_KVSTORE_RETRIES) {
+        TXW51_LOG_ERROR("[KVStore] Flash operation failed, value discarded.");
+        retries = 0;
+        if (queueCount > 0) {
+            queueHead = (queueHead + 1) % CONFIG_KVSTORE_QUEUE_SIZE;
+            queueCount--;
+        }
+    }
+}
+
+
+/***************************************************************************//**
+ * @brief Handles the completion of a flash operation.
+ *
+ * @param[in] err Result of the flash operation.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void KVSTORE_FlashCallback(uint32_t err)
+{
+    if (err != ERR_NONE) {
+        KVSTORE_HandleFailure();
+        KVSTORE_Process();
+        return;
+    }
+
+    switch (state) {
+        case KVSTORE_STATE_APPEND: {
+            uint32_t header = queue[queueHead].Words[0];
+            uint8_t length = KVSTORE_HEADER_LENGTH(header);
+
+            recordOffsets[KVSTORE_HEADER_KEY(header)] = (length > 0) ? writeOffset : 0;
+            writeOffset += KVSTORE_RECORD_WORDS(length);
+            queueHead = (queueHead + 1) % CONFIG_KVSTORE_QUEUE_SIZE;
+            queueCount--;
+            retries = 0;
+            state = KVSTORE_STATE_IDLE;
+            break;
+        }
+
+        case KVSTORE_STATE_ERASE:
+            memset(copyOffsets, 0, sizeof(copyOffsets));
+            copyKey = 0;
+            copyOffset = KVSTORE_HEADER_WORDS;
+            KVSTORE_CopyNext();
+            break;
+
+        case KVSTORE_STATE_COPY:
+            copyOffsets[copyKey] = copyOffset;
+            copyOffset += KVSTORE_RECORD_WORDS(KVSTORE_HEADER_LENGTH(copyBuffer[0]));
+            copyKey++;
+            KVSTORE_CopyNext();
+            break;
+
+        case KVSTORE_STATE_HEADER:
+            activePage ^= 1;
+            generation++;
+            memcpy(recordOffsets, copyOffsets, sizeof(recordOffsets));
+            writeOffset = copyOffset;
+            needsCompaction = false;
+            retries = 0;
+            state = KVSTORE_STATE_IDLE;
+            TXW51_LOG_DEBUG("[KVStore] Compaction finished.");
+            break;
+
+        default:
+            break;
+    }
+
+    KVSTORE_Process();
+}
@@ -0,0 +1,108 @@
+/***************************************************************************//**
+ * @brief   Log-structured key-value store on two flash pages.
+ *
+ * Values are appended as records to the active page. A record consists of a
+ * header word (key, length and a CRC16 over key, length and value) followed
+ * by the value padded to whole words. Writing a value with length zero deletes
+ * the key. When the active page is full, the newest record of every key is
+ * copied to the other page (compaction). The new page becomes valid as soon as
+ * its header with the next generation number has been written, so a power
+ * failure at any time leaves either the old or the new value of a key.
+ *
+ * On startup the active page is scanned once and an index with the newest
+ * record of every key is built in RAM. Reads are done directly from flash.
+ * Writes are queued and executed in the background, the queue is checked by
+ * TXW51_KVSTORE_Get() so the newest value is always returned. Writing a value
+ * that is already stored does not touch the flash.
+ *
+ * @file    kvstore.h
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+#ifndef TXW51_FRAMEWORK_UTILS_KVSTORE_H_
+#define TXW51_FRAMEWORK_UTILS_KVSTORE_H_
+
+/*----- Header-Files ---------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+
+/*----- Macros ---------------------------------------------------------------*/
+
+/*----- Data types -----------------------------------------------------------*/
+
+/*----- Function prototypes --------------------------------------------------*/
+
+/***************************************************************************//**
+ * @brief Initializes the key-value store and builds the index.
+ *
+ * The flash module is initialized as well. An empty or damaged store is
+ * formatted with the first write.
+ *
+ * @param[in] firstPage Address of the first of two consecutive flash pages.
+ * @param[in] pageSize  Size of one flash page in bytes.
+ *
+ * @return ERR_NONE if no error occurred.
+ *         ERR_KVSTORE_INVALID_PAGE if the pages are too small for the
+ *                                  configured keys and values.
+ ******************************************************************************/
+extern uint32_t TXW51_KVSTORE_Init(uint32_t *firstPage, uint32_t pageSize);
+
+/***************************************************************************//**
+ * @brief Reads the value of a key.
+ *
+ * @param[in]     key    The key to read.
+ * @param[out]    value  Buffer for the value.
+ * @param[in,out] length In: Size of the buffer. Out: Length of the value.
+ *
+ * @return ERR_NONE if no error occurred.
+ *         ERR_KVSTORE_INVALID_KEY if the key is out of range.
+ *         ERR_KVSTORE_NOT_FOUND if the key has no value.
+ *         ERR_KVSTORE_INVALID_LENGTH if the buffer is too small.
+ ******************************************************************************/
+extern uint32_t TXW51_KVSTORE_Get(uint8_t key, uint8_t *value, uint8_t *length);
+
+/***************************************************************************//**
+ * @brief Writes the value of a key.
+ *
+ * The value is copied, so the buffer can be reused immediately.
+ *
+ * @param[in] key    The key to write.
+ * @param[in] value  The new value.
+ * @param[in] length Length of the value.
+ *
+ * @return ERR_NONE if no error occurred.
+ *         ERR_KVSTORE_INVALID_KEY if the key is out of range.
+ *         ERR_KVSTORE_INVALID_LENGTH if the value is empty or too long.
+ *         ERR_KVSTORE_QUEUE_FULL if too many writes are pending.
+ ******************************************************************************/
+extern uint32_t TXW51_KVSTORE_Set(uint8_t key, const uint8_t *value, uint8_t length);
+
+/***************************************************************************//**
+ * @brief Deletes a key.
+ *
+ * @param[in] key The key to delete.
+ *
+ * @return ERR_NONE if no error occurred.
+ *         ERR_KVSTORE_INVALID_KEY if the key is out of range.
+ *         ERR_KVSTORE_QUEUE_FULL if too many writes are pending.
+ ******************************************************************************/
+extern uint32_t TXW51_KVSTORE_Delete(uint8_t key);
+
+/***************************************************************************//**
+ * @brief Checks if writes are pending.
+ *
+ * The writes are finished by the flash events, which are processed by the
+ * scheduler.
+ *
+ * @return True if writes are pending.
+ ******************************************************************************/
+extern bool TXW51_KVSTORE_IsBusy(void);
+
+/*----- Data -----------------------------------------------------------------*/
+
+#endif /* TXW51_FRAMEWORK_UTILS_KVSTORE_H_ */
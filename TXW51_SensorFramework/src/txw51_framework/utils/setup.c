@@ -40,9 +40,14 @@ void TXW51_SETUP_InitHfClock(void)
 {
     uint32_t isClockRunning = 0;
 
-    sd_clock_hfclk_request();
+    TXW51_SETUP_RequestHfClock();
     while (!isClockRunning) {
         sd_clock_hfclk_is_running(&isClockRunning);
     }
 }
 
+
+void TXW51_SETUP_RequestHfClock(void)
+{
+    sd_clock_hfclk_request();
+}
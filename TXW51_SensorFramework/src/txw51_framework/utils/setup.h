@@ -45,6 +45,17 @@ extern void TXW51_SETUP_InitScheduler(void);
  ******************************************************************************/
 extern void TXW51_SETUP_InitHfClock(void);
 
+/***************************************************************************//**
+ * @brief Requests the external HFCLK crystal without waiting for it.
+ *
+ * The crystal needs up to a few milliseconds to start. Until then the device
+ * runs from the internal RC oscillator, the SoftDevice waits for the crystal
+ * by itself before it uses the radio.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+extern void TXW51_SETUP_RequestHfClock(void);
+
 /*----- Data -----------------------------------------------------------------*/
 
 #endif /* TXW51_FRAMEWORK_UTILS_SETUP_H_ */
@@ -0,0 +1,56 @@
+/***************************************************************************//**
+ * @brief   Measures the peak usage of the stack.
+ *
+ * @file    stack.c
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+/*----- Header-Files ---------------------------------------------------------*/
+#include "stack.h"
+
+#include "nrf/nrf.h"
+
+/*----- Macros ---------------------------------------------------------------*/
+
+/*----- Data types -----------------------------------------------------------*/
+
+/*----- Function prototypes --------------------------------------------------*/
+
+/*----- Data -----------------------------------------------------------------*/
+extern uint32_t __StackLimit;   /**< Lowest address of the stack, defined by the linker script. */
+extern uint32_t __StackTop;     /**< Address above the stack, defined by the linker script. */
+
+/*----- Implementation -------------------------------------------------------*/
+
+void TXW51_STACK_Paint(void)
+{
+    /* The margin keeps the frame of this function and the words an interrupt
+     * pushes meanwhile out of the way. */
+    uint32_t *end = (uint32_t *)(uintptr_t)(__get_MSP() - TXW51_STACK_PAINT_MARGIN);
+
+    for (uint32_t *word = &__StackLimit; word < end; word++) {
+        *word = TXW51_STACK_PAINT_PATTERN;
+    }
+}
+
+
+uint32_t TXW51_STACK_GetSize(void)
+{
+    return (&__StackTop - &__StackLimit) * sizeof(uint32_t);
+}
+
+
+uint32_t TXW51_STACK_GetMaxUsage(void)
+{
+    const uint32_t *word = &__StackLimit;
+
+    while ((word < &__StackTop) && (*word == TXW51_STACK_PAINT_PATTERN)) {
+        word++;
+    }
+    return (&__StackTop - word) * sizeof(uint32_t);
+}
@@ -0,0 +1,66 @@
+/***************************************************************************//**
+ * @brief   Measures the peak usage of the stack.
+ *
+ * The application shares the 8KB of RAM between the static buffers, the
+ * heap and the stack. The stack region reserved by gcc_startup_nrf51.s is
+ * filled with a known pattern at boot. The deepest word that has been
+ * overwritten since then is the high-water mark of the stack, including the
+ * interrupt handlers of the application and the SoftDevice, which run on the
+ * same stack.
+ *
+ * If the stack grows beyond its region, the whole region is overwritten and
+ * TXW51_STACK_GetMaxUsage() returns the size of the region.
+ *
+ * @file    stack.h
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+#ifndef TXW51_FRAMEWORK_UTILS_STACK_H_
+#define TXW51_FRAMEWORK_UTILS_STACK_H_
+
+/*----- Header-Files ---------------------------------------------------------*/
+#include <stdint.h>
+
+/*----- Macros ---------------------------------------------------------------*/
+#define TXW51_STACK_PAINT_PATTERN   ( 0xA5A5A5A5UL )    /**< Value of the unused stack words. */
+#define TXW51_STACK_PAINT_MARGIN    ( 32 )              /**< Bytes below the stack pointer that are left as they are. */
+
+/*----- Data types -----------------------------------------------------------*/
+
+/*----- Function prototypes --------------------------------------------------*/
+
+/***************************************************************************//**
+ * @brief Fills the unused part of the stack with TXW51_STACK_PAINT_PATTERN.
+ *
+ * Has to be called as early as possible, the words that are in use at that
+ * time are counted as used.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+extern void TXW51_STACK_Paint(void);
+
+/***************************************************************************//**
+ * @brief Returns the size of the stack region.
+ *
+ * @return The size of the stack in bytes.
+ ******************************************************************************/
+extern uint32_t TXW51_STACK_GetSize(void);
+
+/***************************************************************************//**
+ * @brief Returns the high-water mark of the stack since it has been painted.
+ *
+ * Scans the stack from its limit up to the first overwritten word, so it
+ * takes a few hundred cycles. Do not call it from an interrupt.
+ *
+ * @return The maximum number of bytes that have been used on the stack.
+ ******************************************************************************/
+extern uint32_t TXW51_STACK_GetMaxUsage(void);
+
+/*----- Data -----------------------------------------------------------------*/
+
+#endif /* TXW51_FRAMEWORK_UTILS_STACK_H_ */
@@ -47,6 +47,34 @@ enum txw51_errors {
     ERR_I2C_INIT_FAILED,					/**< Could not initialize the I2C interface. */
     ERR_I2C_READ_FAILED,					/**< Could not read from the I2C interface. */
     ERR_I2C_WRITE_FAILED,					/**< Could not write to the I2C interface. */
+
+    ERR_SERVICE_I2C_HVX_COULD_NOT_SEND,     /**< Could not send an I2C result notification. */
+    ERR_SERVICE_I2C_CCCD_NOT_ENABLED,       /**< Could not send an I2C result because CCCD was not set by the peer device. */
+
+    ERR_I2C_QUEUE_FULL,                     /**< The I2C transaction queue is full. */
+    ERR_I2C_INVALID_LENGTH,                 /**< The length of an I2C transaction is not supported. */
+    ERR_I2C_TIMEOUT,                        /**< An I2C transaction has been aborted by the bus watchdog. */
+
+    ERR_TMP006_BUSY,                        /**< The previous TMP006 sample has not been read yet. */
+    ERR_TMP006_INVALID_SAMPLE,              /**< The TMP006 sample is outside of the temperature model. */
+    ERR_SERVICE_TEMP_CONTACTLESS_HVX_COULD_NOT_SEND,    /**< Could not send a temperature sample notification. */
+
+    ERR_FLASH_BUSY,                         /**< Another flash operation is pending. */
+    ERR_FLASH_OPERATION_FAILED,             /**< A flash operation has failed. */
+
+    ERR_KVSTORE_INVALID_PAGE,               /**< The flash pages of the key-value store are too small. */
+    ERR_KVSTORE_INVALID_KEY,                /**< The key is out of range. */
+    ERR_KVSTORE_INVALID_LENGTH,             /**< The length of the value is not supported. */
+    ERR_KVSTORE_NOT_FOUND,                  /**< The key has no value. */
+    ERR_KVSTORE_QUEUE_FULL,                 /**< Too many writes to the key-value store are pending. */
+
+    ERR_BLE_ADV_DATA_INVALID,               /**< The advertising data does not fit into the packet. */
+    ERR_BLE_SERVICE_READ_REPLY,             /**< Could not answer an authorized read. */
+
+    ERR_DELTA_INVALID_HEADER,               /**< The data is not a delta image. */
+    ERR_DELTA_WRONG_SOURCE,                 /**< The delta has been made for another source image. */
+    ERR_DELTA_CORRUPT,                      /**< A command of the delta is invalid. */
+    ERR_DELTA_TARGET_CRC,                   /**< The image built from the delta has the wrong CRC. */
 };
 
 /*----- Function prototypes --------------------------------------------------*/
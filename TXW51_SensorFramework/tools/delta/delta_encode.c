@@ -0,0 +1,309 @@
+/***************************************************************************//**
+ * @brief   Creates a binary delta between two firmware images on the host.
+ *
+ * @file    delta_encode.c
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+/*----- Header-Files ---------------------------------------------------------*/
+#include "delta_encode.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "nrf/app_common/crc16.h"
+
+#include "txw51_framework/utils/delta.h"
+
+/*----- Macros ---------------------------------------------------------------*/
+#define ENC_HASH_BITS       ( 16 )                      /**< Size of the hash table as power of 2. */
+#define ENC_HASH_SIZE       ( 1UL << ENC_HASH_BITS )    /**< Number of hash buckets. */
+#define ENC_MAX_CHAIN       ( 256 )                     /**< Candidates checked per position. */
+#define ENC_NONE            ( -1 )                      /**< End of a hash chain. */
+
+/*----- Data types -----------------------------------------------------------*/
+/**
+ * @brief A growing output buffer.
+ */
+struct ENC_Buffer {
+    uint8_t *Data;      /**< The bytes. */
+    uint32_t Length;    /**< Number of bytes used. */
+    uint32_t Capacity;  /**< Number of bytes allocated. */
+    bool     IsFailed;  /**< An allocation has failed. */
+};
+
+/*----- Function prototypes --------------------------------------------------*/
+static void ENC_PutByte(struct ENC_Buffer *buffer, uint8_t value);
+static void ENC_PutBytes(struct ENC_Buffer *buffer, const uint8_t *values, uint32_t length);
+static void ENC_PutUint16(struct ENC_Buffer *buffer, uint16_t value);
+static void ENC_PutUint32(struct ENC_Buffer *buffer, uint32_t value);
+static void ENC_PutNumber(struct ENC_Buffer *buffer, uint32_t value);
+static uint32_t ENC_Hash(const uint8_t *data);
+static uint32_t ENC_MatchLength(const uint8_t *a, const uint8_t *b, uint32_t maxLength);
+static void ENC_PutInsert(struct ENC_Buffer *buffer, const uint8_t *values, uint32_t length);
+
+/*----- Data -----------------------------------------------------------------*/
+
+/*----- Implementation -------------------------------------------------------*/
+
+uint8_t *TXW51_DELTA_ENC_Create(const uint8_t *source,
+                                uint32_t sourceSize,
+                                const uint8_t *target,
+                                uint32_t targetSize,
+                                uint32_t *deltaSize)
+{
+    struct ENC_Buffer buffer = { NULL, 0, 0, false };
+    int32_t *heads = malloc(ENC_HASH_SIZE * sizeof(int32_t));
+    int32_t *chains = malloc((sourceSize + 1) * sizeof(int32_t));
+
+    if ((heads == NULL) || (chains == NULL)) {
+        free(heads);
+        free(chains);
+        return NULL;
+    }
+
+    /* Index every position of the source, the newest position of a hash
+     * comes first. */
+    for (uint32_t i = 0; i < ENC_HASH_SIZE; i++) {
+        heads[i] = ENC_NONE;
+    }
+    for (uint32_t i = 0; i + TXW51_DELTA_ENC_MIN_MATCH <= sourceSize; i++) {
+        uint32_t hash = ENC_Hash(&source[i]);
+        chains[i] = heads[hash];
+        heads[hash] = i;
+    }
+
+    ENC_PutUint32(&buffer, TXW51_DELTA_MAGIC);
+    ENC_PutUint32(&buffer, sourceSize);
+    ENC_PutUint32(&buffer, targetSize);
+    ENC_PutUint16(&buffer, crc16_compute(source, sourceSize, NULL));
+    ENC_PutUint16(&buffer, crc16_compute(target, targetSize, NULL));
+
+    uint32_t position = 0;          /* Next byte of the target. */
+    uint32_t literalStart = 0;      /* First byte of the target not covered yet. */
+    uint32_t sourcePosition = 0;    /* End of the previous copy, like the decoder. */
+
+    while (position < targetSize) {
+        uint32_t remaining = targetSize - position;
+        uint32_t expected = sourcePosition + (position - literalStart);
+        uint32_t bestLength = 0;
+        uint32_t bestSource = 0;
+
+        /* The inserted bytes usually replace as many bytes of the source. */
+        if (expected < sourceSize) {
+            uint32_t maxLength = sourceSize - expected;
+            bestLength = ENC_MatchLength(&source[expected], &target[position],
+                                         (remaining < maxLength) ? remaining : maxLength);
+            bestSource = expected;
+            if (bestLength < TXW51_DELTA_ENC_MIN_CONTINUE) {
+                bestLength = 0;
+            }
+        }
+
+        if (remaining >= TXW51_DELTA_ENC_MIN_MATCH) {
+            int32_t candidate = heads[ENC_Hash(&target[position])];
+            for (uint32_t i = 0; (i < ENC_MAX_CHAIN) && (candidate != ENC_NONE); i++) {
+                uint32_t maxLength = sourceSize - candidate;
+                uint32_t length = ENC_MatchLength(&source[candidate], &target[position],
+                                                  (remaining < maxLength) ? remaining : maxLength);
+                if ((length >= TXW51_DELTA_ENC_MIN_MATCH) && (length > bestLength)) {
+                    bestLength = length;
+                    bestSource = candidate;
+                }
+                candidate = chains[candidate];
+            }
+        }
+
+        if (bestLength == 0) {
+            position++;
+            continue;
+        }
+
+        ENC_PutInsert(&buffer, &target[literalStart], position - literalStart);
+
+        int32_t offset = (int32_t)(bestSource - sourcePosition);
+        ENC_PutByte(&buffer, TXW51_DELTA_CMD_COPY);
+        ENC_PutNumber(&buffer, (offset >= 0) ? ((uint32_t)offset << 1) :
+                                               (((uint32_t)(-offset - 1) << 1) | 1));
+        ENC_PutNumber(&buffer, bestLength);
+
+        position += bestLength;
+        literalStart = position;
+        sourcePosition = bestSource + bestLength;
+    }
+
+    ENC_PutInsert(&buffer, &target[literalStart], position - literalStart);
+
+    free(heads);
+    free(chains);
+
+    if (buffer.IsFailed) {
+        free(buffer.Data);
+        return NULL;
+    }
+
+    *deltaSize = buffer.Length;
+    return buffer.Data;
+}
+
+
+/***************************************************************************//**
+ * @brief Appends a byte to the buffer.
+ *
+ * @param[in,out] buffer The buffer.
+ * @param[in]     value  The byte.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void ENC_PutByte(struct ENC_Buffer *buffer, uint8_t value)
+{
+    ENC_PutBytes(buffer, &value, 1);
+}
+
+
+/***************************************************************************//**
+ * @brief Appends bytes to the buffer.
+ *
+ * @param[in,out] buffer The buffer.
+ * @param[in]     values The bytes.
+ * @param[in]     length Number of bytes.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void ENC_PutBytes(struct ENC_Buffer *buffer, const uint8_t *values, uint32_t length)
+{
+    if (buffer->IsFailed) {
+        return;
+    }
+
+    if (buffer->Length + length > buffer->Capacity) {
+        uint32_t capacity = (buffer->Capacity > 0) ? buffer->Capacity : 1024;
+        while (buffer->Length + length > capacity) {
+            capacity *= 2;
+        }
+
+        uint8_t *data = realloc(buffer->Data, capacity);
+        if (data == NULL) {
+            buffer->IsFailed = true;
+            return;
+        }
+        buffer->Data = data;
+        buffer->Capacity = capacity;
+    }
+
+    memcpy(&buffer->Data[buffer->Length], values, length);
+    buffer->Length += length;
+}
+
+
+/***************************************************************************//**
+ * @brief Appends a little-endian 16-bit value to the buffer.
+ *
+ * @param[in,out] buffer The buffer.
+ * @param[in]     value  The value.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void ENC_PutUint16(struct ENC_Buffer *buffer, uint16_t value)
+{
+    ENC_PutByte(buffer, value & 0xFF);
+    ENC_PutByte(buffer, value >> 8);
+}
+
+
+/***************************************************************************//**
+ * @brief Appends a little-endian 32-bit value to the buffer.
+ *
+ * @param[in,out] buffer The buffer.
+ * @param[in]     value  The value.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void ENC_PutUint32(struct ENC_Buffer *buffer, uint32_t value)
+{
+    ENC_PutUint16(buffer, value & 0xFFFF);
+    ENC_PutUint16(buffer, value >> 16);
+}
+
+
+/***************************************************************************//**
+ * @brief Appends an unsigned LEB128 number to the buffer.
+ *
+ * @param[in,out] buffer The buffer.
+ * @param[in]     value  The number.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void ENC_PutNumber(struct ENC_Buffer *buffer, uint32_t value)
+{
+    while (value >= 0x80) {
+        ENC_PutByte(buffer, (value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    ENC_PutByte(buffer, value);
+}
+
+
+/***************************************************************************//**
+ * @brief Appends an insert command, if there are bytes to insert.
+ *
+ * @param[in,out] buffer The buffer.
+ * @param[in]     values The bytes to insert.
+ * @param[in]     length Number of bytes.
+ *
+ * @return Nothing.
+ ******************************************************************************/
+static void ENC_PutInsert(struct ENC_Buffer *buffer, const uint8_t *values, uint32_t length)
+{
+    if (length == 0) {
+        return;
+    }
+
+    ENC_PutByte(buffer, TXW51_DELTA_CMD_INSERT);
+    ENC_PutNumber(buffer, length);
+    ENC_PutBytes(buffer, values, length);
+}
+
+
+/***************************************************************************//**
+ * @brief Hashes TXW51_DELTA_ENC_MIN_MATCH bytes.
+ *
+ * @param[in] data The bytes.
+ *
+ * @return The index of the hash bucket.
+ ******************************************************************************/
+static uint32_t ENC_Hash(const uint8_t *data)
+{
+    uint32_t hash = 2166136261UL;
+
+    for (uint32_t i = 0; i < TXW51_DELTA_ENC_MIN_MATCH; i++) {
+        hash = (hash ^ data[i]) * 16777619UL;
+    }
+    return (hash ^ (hash >> ENC_HASH_BITS)) & (ENC_HASH_SIZE - 1);
+}
+
+
+/***************************************************************************//**
+ * @brief Counts the equal bytes at the start of two buffers.
+ *
+ * @param[in] a         First buffer.
+ * @param[in] b         Second buffer.
+ * @param[in] maxLength Number of bytes to compare at most.
+ *
+ * @return The number of equal bytes.
+ ******************************************************************************/
+static uint32_t ENC_MatchLength(const uint8_t *a, const uint8_t *b, uint32_t maxLength)
+{
+    uint32_t length = 0;
+
+    while ((length < maxLength) && (a[length] == b[length])) {
+        length++;
+    }
+    return length;
+}
@@ -0,0 +1,53 @@
+/***************************************************************************//**
+ * @brief   Creates a binary delta between two firmware images on the host.
+ *
+ * The format is described in txw51_framework/utils/delta.h. The new image is
+ * scanned from the start. Where it continues the running image at the
+ * expected position (the bytes in between have been replaced), a short match
+ * is enough for a copy; elsewhere a hash of TXW51_DELTA_ENC_MIN_MATCH bytes
+ * looks for the longest match anywhere in the running image. The bytes that
+ * are not found become inserts.
+ *
+ * @file    delta_encode.h
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+#ifndef TXW51_TOOLS_DELTA_ENCODE_H_
+#define TXW51_TOOLS_DELTA_ENCODE_H_
+
+/*----- Header-Files ---------------------------------------------------------*/
+#include <stdint.h>
+
+/*----- Macros ---------------------------------------------------------------*/
+#define TXW51_DELTA_ENC_MIN_MATCH       ( 8 )   /**< Shortest copy from an arbitrary position of the source. */
+#define TXW51_DELTA_ENC_MIN_CONTINUE    ( 4 )   /**< Shortest copy that continues at the expected position. */
+
+/*----- Data types -----------------------------------------------------------*/
+
+/*----- Function prototypes --------------------------------------------------*/
+
+/***************************************************************************//**
+ * @brief Creates the delta from the source to the target image.
+ *
+ * @param[in]  source     The running image.
+ * @param[in]  sourceSize Size of the running image in bytes.
+ * @param[in]  target     The new image.
+ * @param[in]  targetSize Size of the new image in bytes.
+ * @param[out] deltaSize  Size of the delta in bytes.
+ *
+ * @return The delta (to be released with free()), NULL if out of memory.
+ ******************************************************************************/
+extern uint8_t *TXW51_DELTA_ENC_Create(const uint8_t *source,
+                                       uint32_t sourceSize,
+                                       const uint8_t *target,
+                                       uint32_t targetSize,
+                                       uint32_t *deltaSize);
+
+/*----- Data -----------------------------------------------------------------*/
+
+#endif /* TXW51_TOOLS_DELTA_ENCODE_H_ */
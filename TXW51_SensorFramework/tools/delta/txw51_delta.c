@@ -0,0 +1,282 @@
+/***************************************************************************//**
+ * @brief   Host tool for delta firmware updates.
+ *
+ * Creates the delta from the image that runs on the devices to a new image,
+ * which is then transferred with the DFU instead of the new image. The
+ * bootloader builds the new image in bank 1 from the delta and the image in
+ * bank 0. Both images are padded with 0xFF to whole words, like the DFU
+ * requires for the image sizes, and the delta is verified by applying it
+ * before it is written.
+ *
+ * Usage: txw51_delta diff  <old.bin> <new.bin> <delta.bin>
+ *        txw51_delta apply <old.bin> <delta.bin> <new.bin>
+ *
+ * @file    txw51_delta.c
+ * @version 1.0
+ * @date    19.10.2026
+ * @author  agent
+ *
+ * @remark  Last Modifications:
+ *          19.10.2026 agent created
+ ******************************************************************************/
+
+/*----- Header-Files ---------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "delta_encode.h"
+
+#include "txw51_framework/utils/delta.h"
+#include "txw51_framework/utils/txw51_errors.h"
+
+/*----- Macros ---------------------------------------------------------------*/
+#define MAIN_BLOCK_SIZE     ( 256 )     /**< Size of the blocks the target is built in, like in the bootloader. */
+#define MAIN_WORD_SIZE      ( 4 )       /**< Images are padded to whole words. */
+
+/*----- Data types -----------------------------------------------------------*/
+
+/*----- Function prototypes --------------------------------------------------*/
+static uint8_t *MAIN_ReadFile(const char *name, uint32_t *size);
+static int MAIN_WriteFile(const char *name, const uint8_t *data, uint32_t size);
+static uint8_t *MAIN_Apply(const uint8_t *source, uint32_t sourceSize,
+                           const uint8_t *delta, uint32_t deltaSize,
+                           uint32_t *targetSize);
+static int MAIN_Diff(const char *oldName, const char *newName, const char *deltaName);
+static int MAIN_ApplyFiles(const char *oldName, const char *deltaName, const char *newName);
+
+/*----- Data -----------------------------------------------------------------*/
+
+/*----- Implementation -------------------------------------------------------*/
+
+/***************************************************************************//**
+ * @brief Reads a file and pads it with 0xFF to whole words.
+ *
+ * @param[in]  name Name of the file.
+ * @param[out] size Size of the padded content in bytes.
+ *
+ * @return The content (to be released with free()), NULL on error.
+ ******************************************************************************/
+static uint8_t *MAIN_ReadFile(const char *name, uint32_t *size)
+{
+    FILE *file = fopen(name, "rb");
+    if (file == NULL) {
+        perror(name);
+        return NULL;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    uint32_t padded = (length + MAIN_WORD_SIZE - 1) & ~(MAIN_WORD_SIZE - 1);
+    uint8_t *data = malloc(padded + 1);
+    if ((data == NULL) || (fread(data, 1, length, file) != (size_t)length)) {
+        fprintf(stderr, "%s: could not read the file\n", name);
+        fclose(file);
+        free(data);
+        return NULL;
+    }
+    fclose(file);
+
+    memset(&data[length], 0xFF, padded - length);
+    *size = padded;
+    return data;
+}
+
+
+/***************************************************************************//**
+ * @brief Writes a file.
+ *
+ * @param[in] name Name of the file.
+ * @param[in] data The content.
+ * @param[in] size Size of the content in bytes.
+ *
+ * @return 0 on success, 1 on error.
+ ******************************************************************************/
+static int MAIN_WriteFile(const char *name, const uint8_t *data, uint32_t size)
+{
+    FILE *file = fopen(name, "wb");
+    if (file == NULL) {
+        perror(name);
+        return 1;
+    }
+
+    if (fwrite(data, 1, size, file) != size) {
+        fprintf(stderr, "%s: could not write the file\n", name);
+        fclose(file);
+        return 1;
+    }
+    fclose(file);
+    return 0;
+}
+
+
+/***************************************************************************//**
+ * @brief Builds the target image from a delta like the bootloader.
+ *
+ * @param[in]  source     The running image.
+ * @param[in]  sourceSize Size of the running image in bytes.
+ * @param[in]  delta      The delta.
+ * @param[in]  deltaSize  Size of the delta in bytes.
+ * @param[out] targetSize Size of the new image in bytes.
+ *
+ * @return The new image (to be released with free()), NULL on error.
+ ******************************************************************************/
+static uint8_t *MAIN_Apply(const uint8_t *source, uint32_t sourceSize,
+                           const uint8_t *delta, uint32_t deltaSize,
+                           uint32_t *targetSize)
+{
+    struct TXW51_DELTA_Patch patch;
+    uint32_t err;
+
+    err = TXW51_DELTA_Init(&patch, source, sourceSize, delta, deltaSize);
+    if (err != ERR_NONE) {
+        fprintf(stderr, "Delta rejected: %s\n",
+                (err == ERR_DELTA_WRONG_SOURCE) ? "made for another image" : "no delta");
+        return NULL;
+    }
+
+    uint8_t *target = malloc(patch.Header.TargetSize + MAIN_BLOCK_SIZE);
+    if (target == NULL) {
+        return NULL;
+    }
+
+    uint32_t length = 0;
+    while (!TXW51_DELTA_IsComplete(&patch)) {
+        uint32_t blockLength;
+        err = TXW51_DELTA_Apply(&patch, &target[length], MAIN_BLOCK_SIZE, &blockLength);
+        if (err != ERR_NONE) {
+            fprintf(stderr, "Delta failed at byte %lu: %s\n", (unsigned long)length,
+                    (err == ERR_DELTA_TARGET_CRC) ? "wrong CRC" : "corrupt command");
+            free(target);
+            return NULL;
+        }
+        length += blockLength;
+    }
+
+    *targetSize = length;
+    return target;
+}
+
+
+/***************************************************************************//**
+ * @brief Creates a delta and checks it.
+ *
+ * @param[in] oldName   The image on the devices.
+ * @param[in] newName   The new image.
+ * @param[in] deltaName The delta to write.
+ *
+ * @return The exit status.
+ ******************************************************************************/
+static int MAIN_Diff(const char *oldName, const char *newName, const char *deltaName)
+{
+    uint32_t oldSize;
+    uint32_t newSize;
+    uint32_t deltaSize;
+    uint32_t checkSize;
+    int status = 1;
+
+    uint8_t *oldImage = MAIN_ReadFile(oldName, &oldSize);
+    uint8_t *newImage = MAIN_ReadFile(newName, &newSize);
+    uint8_t *delta = NULL;
+    uint8_t *check = NULL;
+
+    if ((oldImage == NULL) || (newImage == NULL)) {
+        goto cleanup;
+    }
+
+    delta = TXW51_DELTA_ENC_Create(oldImage, oldSize, newImage, newSize, &deltaSize);
+    if (delta == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        goto cleanup;
+    }
+
+    /* The DFU transfers whole words, the decoder ignores the padding. */
+    uint32_t padded = (deltaSize + MAIN_WORD_SIZE - 1) & ~(MAIN_WORD_SIZE - 1);
+    uint8_t *paddedDelta = realloc(delta, padded);
+    if (paddedDelta == NULL) {
+        goto cleanup;
+    }
+    delta = paddedDelta;
+    memset(&delta[deltaSize], 0xFF, padded - deltaSize);
+    deltaSize = padded;
+
+    check = MAIN_Apply(oldImage, oldSize, delta, deltaSize, &checkSize);
+    if ((check == NULL) || (checkSize != newSize) || (memcmp(check, newImage, newSize) != 0)) {
+        fprintf(stderr, "The delta does not reproduce %s\n", newName);
+        goto cleanup;
+    }
+
+    status = MAIN_WriteFile(deltaName, delta, deltaSize);
+    if (status == 0) {
+        printf("%s: %lu bytes (%.1f%% of %lu bytes)\n", deltaName, (unsigned long)deltaSize,
+               100.0 * deltaSize / newSize, (unsigned long)newSize);
+    }
+
+cleanup:
+    free(oldImage);
+    free(newImage);
+    free(delta);
+    free(check);
+    return status;
+}
+
+
+/***************************************************************************//**
+ * @brief Builds the new image from a delta.
+ *
+ * @param[in] oldName   The image on the devices.
+ * @param[in] deltaName The delta.
+ * @param[in] newName   The new image to write.
+ *
+ * @return The exit status.
+ ******************************************************************************/
+static int MAIN_ApplyFiles(const char *oldName, const char *deltaName, const char *newName)
+{
+    uint32_t oldSize;
+    uint32_t deltaSize;
+    uint32_t newSize;
+    int status = 1;
+
+    uint8_t *oldImage = MAIN_ReadFile(oldName, &oldSize);
+    uint8_t *delta = MAIN_ReadFile(deltaName, &deltaSize);
+    uint8_t *newImage = NULL;
+
+    if ((oldImage != NULL) && (delta != NULL)) {
+        newImage = MAIN_Apply(oldImage, oldSize, delta, deltaSize, &newSize);
+    }
+    if (newImage != NULL) {
+        status = MAIN_WriteFile(newName, newImage, newSize);
+    }
+
+    free(oldImage);
+    free(delta);
+    free(newImage);
+    return status;
+}
+
+
+/***************************************************************************//**
+ * @brief The starting point of the tool.
+ *
+ * @param[in] argc Number of arguments.
+ * @param[in] argv The arguments.
+ *
+ * @return The exit status.
+ ******************************************************************************/
+int main(int argc, char **argv)
+{
+    if ((argc == 5) && (strcmp(argv[1], "diff") == 0)) {
+        return MAIN_Diff(argv[2], argv[3], argv[4]);
+    }
+    if ((argc == 5) && (strcmp(argv[1], "apply") == 0)) {
+        return MAIN_ApplyFiles(argv[2], argv[3], argv[4]);
+    }
+
+    fprintf(stderr,
+            "Usage: %s diff  <old.bin> <new.bin> <delta.bin>\n"
+            "       %s apply <old.bin> <delta.bin> <new.bin>\n",
+            argv[0], argv[0]);
+    return 2;
+}